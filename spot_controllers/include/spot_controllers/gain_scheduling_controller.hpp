@@ -0,0 +1,89 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "controller_interface/chainable_controller_interface.hpp"
+#include "gain_scheduling_controller_parameters.hpp"  // NOLINT(build/include_subdir)
+#include "hardware_interface/handle.hpp"
+#include "rclcpp/time.hpp"
+#include "rclcpp_lifecycle/state.hpp"
+#include "spot_controllers/visibility_control.h"
+
+namespace spot_controllers {
+/**
+ * \brief Chainable controller which computes the k_q_p and k_qd_p gains of every joint on every update from a
+ * schedule, so that gains do not have to be streamed over DDS.
+ *
+ * Every joint blends between its swing and stance gains by its phase, which is 0 in swing and 1 in stance. The phase
+ * follows the foot contact state interface of the joint, and moves to a new contact state within blend_time so that
+ * the gains never jump. Joints without a contact stay in stance. The position gain is then increased with the
+ * measured effort of the joint, by load_scale per Nm up to max_load_scale times, and the velocity gain by the square
+ * root of that factor, which keeps the damping ratio of the joint.
+ *
+ * In chained mode, a preceding controller such as a gait controller can set the phase of every joint through the
+ * reference interfaces <controller name>/<joint>/phase. A NaN phase, which is the value outside of chained mode,
+ * falls back to the contacts.
+ *
+ * This controller only claims the gain interfaces, so it runs next to a controller of the position, velocity and
+ * effort interfaces such as the SplineTrajectoryController.
+ *
+ * \param joints Names of the joints whose gains are scheduled.
+ * \param stance_k_q_p, stance_k_qd_p Gains of every joint in stance.
+ * \param swing_k_q_p, swing_k_qd_p Gains of every joint in swing, or empty to use the stance gains.
+ * \param contacts Foot contact state interface of every joint, or an empty string for joints which stay in stance.
+ * \param load_scale Increase of the position gain of every joint per Nm of effort, or empty to not schedule by load.
+ * \param max_load_scale Maximum factor by which the load increases the position gains.
+ * \param blend_time Time in seconds in which the gains move between swing and stance.
+ */
+class GainSchedulingController : public controller_interface::ChainableControllerInterface {
+ public:
+  SPOT_CONTROLLERS_PUBLIC
+  GainSchedulingController();
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::InterfaceConfiguration command_interface_configuration() const override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::InterfaceConfiguration state_interface_configuration() const override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::CallbackReturn on_init() override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::CallbackReturn on_configure(const rclcpp_lifecycle::State& previous_state) override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::CallbackReturn on_activate(const rclcpp_lifecycle::State& previous_state) override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::return_type update_reference_from_subscribers() override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::return_type update_and_write_commands(const rclcpp::Time& time,
+                                                              const rclcpp::Duration& period) override;
+
+ protected:
+  using Params = gain_scheduling_controller::Params;
+  using ParamListener = gain_scheduling_controller::ParamListener;
+
+  std::vector<hardware_interface::CommandInterface> on_export_reference_interfaces() override;
+
+  bool on_set_chained_mode(bool chained_mode) override;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+
+  // State interfaces claimed besides the efforts of the joints, without duplicates, and the index of the contact of
+  // every joint among them, or -1 if it has none.
+  std::vector<std::string> contact_interfaces_;
+  std::vector<int> contact_index_;
+  // Phase of every joint, which moves towards its scheduled phase. Only used by update_and_write_commands().
+  std::vector<double> phases_;
+};
+
+}  // namespace spot_controllers
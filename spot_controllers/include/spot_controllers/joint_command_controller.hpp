@@ -0,0 +1,73 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <memory>
+
+#include "controller_interface/controller_interface.hpp"
+#include "joint_command_controller_parameters.hpp"  // NOLINT(build/include_subdir)
+#include "rclcpp/subscription.hpp"
+#include "rclcpp/time.hpp"
+#include "rclcpp_lifecycle/state.hpp"
+#include "realtime_tools/realtime_buffer.h"
+#include "spot_controllers/visibility_control.h"
+#include "spot_msgs/msg/joint_command.hpp"
+
+namespace spot_controllers {
+/**
+ * \brief Controller which forwards typed joint commands to the position, velocity, effort and gain interfaces.
+ *
+ * Unlike the ForwardStateController, every command has a fixed layout with one array per interface, so the update
+ * only copies the arrays of the latest command into the command interfaces, and never parses or allocates. Commands
+ * are checked when they are received, and are passed to the update through a realtime buffer.
+ *
+ * \param joints Names of the joints to control, in the order of the arrays of the commands.
+ * \param command_timeout Time in seconds after the last command after which the joints hold their last position with
+ * zero velocity and effort, or 0 to keep the last command forever.
+ *
+ * Subscribes to:
+ * - \b ~/commands (spot_msgs::msg::JointCommand) : The commands to apply.
+ */
+class JointCommandController : public controller_interface::ControllerInterface {
+ public:
+  SPOT_CONTROLLERS_PUBLIC
+  JointCommandController();
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::InterfaceConfiguration command_interface_configuration() const override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::InterfaceConfiguration state_interface_configuration() const override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::CallbackReturn on_init() override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::CallbackReturn on_configure(const rclcpp_lifecycle::State& previous_state) override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::CallbackReturn on_activate(const rclcpp_lifecycle::State& previous_state) override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::CallbackReturn on_deactivate(const rclcpp_lifecycle::State& previous_state) override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::return_type update(const rclcpp::Time& time, const rclcpp::Duration& period) override;
+
+ protected:
+  using Params = joint_command_controller::Params;
+  using ParamListener = joint_command_controller::ParamListener;
+  using JointCommand = spot_msgs::msg::JointCommand;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+
+  rclcpp::Subscription<JointCommand>::SharedPtr command_subscriber_;
+  realtime_tools::RealtimeBuffer<std::shared_ptr<JointCommand>> command_buffer_;
+  // Last command which was applied, and the time at which it was applied. Only used by update().
+  std::shared_ptr<JointCommand> last_command_;
+  rclcpp::Time last_command_time_;
+  bool timed_out_ = false;
+};
+
+}  // namespace spot_controllers
@@ -0,0 +1,68 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <memory>
+
+#include "controller_interface/controller_interface.hpp"
+#include "nav_msgs/msg/odometry.hpp"
+#include "odometry_broadcaster_parameters.hpp"  // NOLINT(build/include_subdir)
+#include "rclcpp/publisher.hpp"
+#include "rclcpp_lifecycle/state.hpp"
+#include "realtime_tools/realtime_publisher.h"
+#include "spot_controllers/visibility_control.h"
+#include "tf2_msgs/msg/tf_message.hpp"
+
+namespace spot_controllers {
+/**
+ * \brief Broadcaster of the odometry of the body, which is read from the state interfaces of the hardware interface.
+ *
+ * The hardware interface streams the pose and velocity of the body much faster than the robot state publisher of the
+ * driver requests them, so this broadcaster publishes odometry at the update rate of the controller manager.
+ *
+ * \param state_interface_prefix Prefix of the state interfaces holding the pose and velocity of the body.
+ * \param odom_frame_id Frame ID of the odometry messages.
+ * \param base_frame_id Child frame ID of the odometry messages.
+ * \param publish_tf Whether to also broadcast the transform from the odom frame to the body frame.
+ *
+ * Publishes to:
+ * - \b ~/odometry (nav_msgs::msg::Odometry) : Pose of the body in the odom frame, and velocity of the body in the
+ *   odom frame expressed in the odom frame, like the odometry topic of the driver.
+ * - \b /tf (tf2_msgs::msg::TFMessage) : Transform from the odom frame to the body frame, if publish_tf is set.
+ */
+class OdometryBroadcaster : public controller_interface::ControllerInterface {
+ public:
+  SPOT_CONTROLLERS_PUBLIC
+  OdometryBroadcaster();
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::InterfaceConfiguration command_interface_configuration() const override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::InterfaceConfiguration state_interface_configuration() const override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::CallbackReturn on_init() override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::CallbackReturn on_configure(const rclcpp_lifecycle::State& previous_state) override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::return_type update(const rclcpp::Time& time, const rclcpp::Duration& period) override;
+
+ protected:
+  using Params = odometry_broadcaster::Params;
+  using ParamListener = odometry_broadcaster::ParamListener;
+  using OdometryPublisher = realtime_tools::RealtimePublisher<nav_msgs::msg::Odometry>;
+  using TfPublisher = realtime_tools::RealtimePublisher<tf2_msgs::msg::TFMessage>;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+
+  rclcpp::Publisher<nav_msgs::msg::Odometry>::SharedPtr odometry_publisher_;
+  std::unique_ptr<OdometryPublisher> realtime_odometry_publisher_;
+  rclcpp::Publisher<tf2_msgs::msg::TFMessage>::SharedPtr tf_publisher_;
+  std::unique_ptr<TfPublisher> realtime_tf_publisher_;
+};
+
+}  // namespace spot_controllers
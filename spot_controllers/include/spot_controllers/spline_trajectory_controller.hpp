@@ -0,0 +1,92 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "controller_interface/controller_interface.hpp"
+#include "rclcpp/subscription.hpp"
+#include "rclcpp/time.hpp"
+#include "rclcpp_lifecycle/state.hpp"
+#include "realtime_tools/realtime_buffer.h"
+#include "spline_trajectory_controller_parameters.hpp"  // NOLINT(build/include_subdir)
+#include "spot_controllers/visibility_control.h"
+#include "trajectory_msgs/msg/joint_trajectory.hpp"
+
+namespace spot_controllers {
+/**
+ * \brief Controller which interpolates sparse joint trajectories at the update rate of the controller manager.
+ *
+ * The positions and velocities between two points of a trajectory are interpolated with a cubic Hermite spline, so a
+ * planner only needs to send a few points per second instead of streaming every setpoint. The trajectory starts at
+ * the positions which were commanded when it was received, and after its last point, the joints hold the last
+ * position with zero velocity. A new trajectory replaces the current one.
+ *
+ * \param joints Names of the joints to control.
+ *
+ * Subscribes to:
+ * - \b ~/joint_trajectory (trajectory_msgs::msg::JointTrajectory) : The trajectories to follow. The joints may be in
+ *   any order, but must include every controlled joint. If the stamp of the header is zero, the trajectory starts when
+ *   it is received.
+ */
+class SplineTrajectoryController : public controller_interface::ControllerInterface {
+ public:
+  SPOT_CONTROLLERS_PUBLIC
+  SplineTrajectoryController();
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::InterfaceConfiguration command_interface_configuration() const override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::InterfaceConfiguration state_interface_configuration() const override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::CallbackReturn on_init() override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::CallbackReturn on_configure(const rclcpp_lifecycle::State& previous_state) override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::CallbackReturn on_activate(const rclcpp_lifecycle::State& previous_state) override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::CallbackReturn on_deactivate(const rclcpp_lifecycle::State& previous_state) override;
+
+  SPOT_CONTROLLERS_PUBLIC
+  controller_interface::return_type update(const rclcpp::Time& time, const rclcpp::Duration& period) override;
+
+ protected:
+  using Params = spline_trajectory_controller::Params;
+  using ParamListener = spline_trajectory_controller::ParamListener;
+
+  /** \brief Trajectory with its points in the order of the controlled joints, prepared outside of the control loop. */
+  struct Trajectory {
+    rclcpp::Time start;
+    /** \brief Time of every point in seconds after the start, in increasing order. */
+    std::vector<double> times;
+    /** \brief Positions and velocities of every point, with one entry per controlled joint. */
+    std::vector<double> positions;
+    std::vector<double> velocities;
+  };
+
+  /**
+   * \brief Convert a trajectory message into the order of the controlled joints.
+   * \return The trajectory, or nullptr if the message is invalid.
+   */
+  std::shared_ptr<const Trajectory> make_trajectory(const trajectory_msgs::msg::JointTrajectory& msg) const;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+
+  rclcpp::Subscription<trajectory_msgs::msg::JointTrajectory>::SharedPtr trajectory_subscriber_;
+  realtime_tools::RealtimeBuffer<std::shared_ptr<const Trajectory>> trajectory_buffer_;
+  // Trajectory which is followed, the point which is approached next, and the commanded positions when it was
+  // received. Only used by update().
+  std::shared_ptr<const Trajectory> active_trajectory_;
+  std::size_t next_point_ = 0;
+  std::vector<double> start_positions_;
+};
+
+}  // namespace spot_controllers
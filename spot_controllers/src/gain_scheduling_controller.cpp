@@ -0,0 +1,189 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include "spot_controllers/gain_scheduling_controller.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rclcpp/logging.hpp"
+
+namespace {
+// Command interfaces of every joint, in the order in which they are claimed.
+constexpr std::array<const char*, 2> kJointInterfaces{"k_q_p", "k_qd_p"};
+constexpr std::size_t kKQP = 0;
+constexpr std::size_t kKQDP = 1;
+
+constexpr auto kPhaseInterface = "phase";
+
+// Phase of a joint in contact. A contact state is 1 in contact, 0 out of contact and NaN if unknown.
+double phase_from_contact(const double contact, const double current_phase) {
+  return std::isnan(contact) ? current_phase : (contact > 0.5 ? 1.0 : 0.0);
+}
+}  // namespace
+
+namespace spot_controllers {
+GainSchedulingController::GainSchedulingController() : controller_interface::ChainableControllerInterface() {}
+
+controller_interface::InterfaceConfiguration GainSchedulingController::command_interface_configuration() const {
+  controller_interface::InterfaceConfiguration config{controller_interface::interface_configuration_type::INDIVIDUAL};
+  for (const auto& joint : params_.joints) {
+    for (const auto* interface_name : kJointInterfaces) {
+      config.names.push_back(joint + "/" + interface_name);
+    }
+  }
+  return config;
+}
+
+controller_interface::InterfaceConfiguration GainSchedulingController::state_interface_configuration() const {
+  // The efforts of the joints come first if the gains are scheduled by load, followed by the contacts.
+  controller_interface::InterfaceConfiguration config{controller_interface::interface_configuration_type::INDIVIDUAL};
+  if (!params_.load_scale.empty()) {
+    for (const auto& joint : params_.joints) {
+      config.names.push_back(joint + "/effort");
+    }
+  }
+  config.names.insert(config.names.end(), contact_interfaces_.begin(), contact_interfaces_.end());
+  return config;
+}
+
+controller_interface::CallbackReturn GainSchedulingController::on_init() {
+  try {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+  } catch (const std::exception& e) {
+    RCLCPP_ERROR(get_node()->get_logger(), "Exception thrown during init stage with message: %s", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn GainSchedulingController::on_configure(
+    const rclcpp_lifecycle::State& /*previous_state*/) {
+  params_ = param_listener_->get_params();
+  const auto njoints = params_.joints.size();
+  if (njoints == 0) {
+    RCLCPP_ERROR(get_node()->get_logger(), "'joints' parameter was empty");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  if (params_.stance_k_q_p.size() != njoints || params_.stance_k_qd_p.size() != njoints) {
+    RCLCPP_ERROR(get_node()->get_logger(), "'stance_k_q_p' and 'stance_k_qd_p' must have one entry for each joint");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  // Without swing gains, joints keep their stance gains in every phase.
+  if (params_.swing_k_q_p.empty()) {
+    params_.swing_k_q_p = params_.stance_k_q_p;
+  }
+  if (params_.swing_k_qd_p.empty()) {
+    params_.swing_k_qd_p = params_.stance_k_qd_p;
+  }
+  if (params_.swing_k_q_p.size() != njoints || params_.swing_k_qd_p.size() != njoints ||
+      (!params_.load_scale.empty() && params_.load_scale.size() != njoints)) {
+    RCLCPP_ERROR(get_node()->get_logger(),
+                 "'swing_k_q_p', 'swing_k_qd_p' and 'load_scale' must be empty or have one entry for each joint");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  if (!params_.contacts.empty() && params_.contacts.size() != njoints) {
+    RCLCPP_ERROR(get_node()->get_logger(), "'contacts' must be empty or have one entry for each joint");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  // Joints of one leg share the contact of its foot, which is claimed once.
+  contact_interfaces_.clear();
+  contact_index_.assign(njoints, -1);
+  for (std::size_t i = 0; i < params_.contacts.size(); ++i) {
+    const auto& contact = params_.contacts[i];
+    if (contact.empty()) {
+      continue;
+    }
+    auto it = std::find(contact_interfaces_.begin(), contact_interfaces_.end(), contact);
+    if (it == contact_interfaces_.end()) {
+      it = contact_interfaces_.insert(contact_interfaces_.end(), contact);
+    }
+    contact_index_[i] = static_cast<int>(it - contact_interfaces_.begin());
+  }
+  phases_.assign(njoints, 1.0);
+  reference_interfaces_.assign(njoints, std::numeric_limits<double>::quiet_NaN());
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn GainSchedulingController::on_activate(
+    const rclcpp_lifecycle::State& /*previous_state*/) {
+  // The joints start in the phase of their current contact, and in stance if it is unknown, which has the stiffer
+  // gains.
+  const auto contact_offset = params_.load_scale.empty() ? 0 : params_.joints.size();
+  for (std::size_t i = 0; i < params_.joints.size(); ++i) {
+    phases_[i] = 1.0;
+    if (contact_index_[i] >= 0) {
+      const auto contact = state_interfaces_[contact_offset + static_cast<std::size_t>(contact_index_[i])].get_value();
+      phases_[i] = phase_from_contact(contact, phases_[i]);
+    }
+  }
+  std::fill(reference_interfaces_.begin(), reference_interfaces_.end(), std::numeric_limits<double>::quiet_NaN());
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+std::vector<hardware_interface::CommandInterface> GainSchedulingController::on_export_reference_interfaces() {
+  std::vector<hardware_interface::CommandInterface> reference_interfaces;
+  reference_interfaces.reserve(params_.joints.size());
+  for (std::size_t i = 0; i < params_.joints.size(); ++i) {
+    reference_interfaces.emplace_back(get_node()->get_name(), params_.joints[i] + "/" + kPhaseInterface,
+                                      &reference_interfaces_[i]);
+  }
+  return reference_interfaces;
+}
+
+bool GainSchedulingController::on_set_chained_mode(bool /*chained_mode*/) {
+  // Outside of chained mode the phases are cleared on every update, so switching needs no preparation.
+  return true;
+}
+
+controller_interface::return_type GainSchedulingController::update_reference_from_subscribers() {
+  // Without a preceding controller, the phases follow the contacts.
+  std::fill(reference_interfaces_.begin(), reference_interfaces_.end(), std::numeric_limits<double>::quiet_NaN());
+  return controller_interface::return_type::OK;
+}
+
+controller_interface::return_type GainSchedulingController::update_and_write_commands(
+    const rclcpp::Time& /*time*/, const rclcpp::Duration& period) {
+  const auto njoints = params_.joints.size();
+  const bool load_scheduled = !params_.load_scale.empty();
+  const auto contact_offset = load_scheduled ? njoints : 0;
+  const double max_step = params_.blend_time > 0.0 ? period.seconds() / params_.blend_time : 1.0;
+  for (std::size_t i = 0; i < njoints; ++i) {
+    // The phase set by a preceding controller takes precedence over the contact.
+    double target = 1.0;
+    if (std::isfinite(reference_interfaces_[i])) {
+      target = std::clamp(reference_interfaces_[i], 0.0, 1.0);
+    } else if (contact_index_[i] >= 0) {
+      const auto contact = state_interfaces_[contact_offset + static_cast<std::size_t>(contact_index_[i])].get_value();
+      target = phase_from_contact(contact, phases_[i]);
+    }
+    phases_[i] += std::clamp(target - phases_[i], -max_step, max_step);
+
+    double k_q_p = params_.swing_k_q_p[i] + phases_[i] * (params_.stance_k_q_p[i] - params_.swing_k_q_p[i]);
+    double k_qd_p = params_.swing_k_qd_p[i] + phases_[i] * (params_.stance_k_qd_p[i] - params_.swing_k_qd_p[i]);
+    if (load_scheduled) {
+      const double effort = state_interfaces_[i].get_value();
+      if (std::isfinite(effort)) {
+        const double scale = std::min(1.0 + params_.load_scale[i] * std::abs(effort), params_.max_load_scale);
+        k_q_p *= scale;
+        k_qd_p *= std::sqrt(scale);
+      }
+    }
+    command_interfaces_[i * kJointInterfaces.size() + kKQP].set_value(k_q_p);
+    command_interfaces_[i * kJointInterfaces.size() + kKQDP].set_value(k_qd_p);
+  }
+  return controller_interface::return_type::OK;
+}
+
+}  // namespace spot_controllers
+
+#include "pluginlib/class_list_macros.hpp"
+
+PLUGINLIB_EXPORT_CLASS(spot_controllers::GainSchedulingController, controller_interface::ChainableControllerInterface)
@@ -0,0 +1,138 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include "spot_controllers/joint_command_controller.hpp"
+
+#include <array>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rclcpp/logging.hpp"
+#include "rclcpp/qos.hpp"
+
+namespace {
+// Command interfaces of every joint, in the order in which they are claimed.
+constexpr std::array<const char*, 5> kJointInterfaces{"position", "velocity", "effort", "k_q_p", "k_qd_p"};
+constexpr std::size_t kPosition = 0;
+constexpr std::size_t kVelocity = 1;
+constexpr std::size_t kEffort = 2;
+constexpr std::size_t kKQP = 3;
+constexpr std::size_t kKQDP = 4;
+
+constexpr auto kCommandTopic = "~/commands";
+}  // namespace
+
+namespace spot_controllers {
+JointCommandController::JointCommandController() : controller_interface::ControllerInterface() {}
+
+controller_interface::InterfaceConfiguration JointCommandController::command_interface_configuration() const {
+  // Example: for joints [1, 2], the interfaces are [1/position, 1/velocity, ..., 1/k_qd_p, 2/position, ...]
+  controller_interface::InterfaceConfiguration config{controller_interface::interface_configuration_type::INDIVIDUAL};
+  for (const auto& joint : params_.joints) {
+    for (const auto* interface_name : kJointInterfaces) {
+      config.names.push_back(joint + "/" + interface_name);
+    }
+  }
+  return config;
+}
+
+controller_interface::InterfaceConfiguration JointCommandController::state_interface_configuration() const {
+  return controller_interface::InterfaceConfiguration{controller_interface::interface_configuration_type::NONE};
+}
+
+controller_interface::CallbackReturn JointCommandController::on_init() {
+  try {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+  } catch (const std::exception& e) {
+    RCLCPP_ERROR(get_node()->get_logger(), "Exception thrown during init stage with message: %s", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn JointCommandController::on_configure(
+    const rclcpp_lifecycle::State& /*previous_state*/) {
+  params_ = param_listener_->get_params();
+  if (params_.joints.empty()) {
+    RCLCPP_ERROR(get_node()->get_logger(), "'joints' parameter was empty");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  // Commands are checked here rather than in update(), so that update() can copy them without any checks.
+  command_subscriber_ = get_node()->create_subscription<JointCommand>(
+      kCommandTopic, rclcpp::SystemDefaultsQoS(), [this](const std::shared_ptr<JointCommand> msg) {
+        const auto njoints = params_.joints.size();
+        for (const auto* values : {&msg->position, &msg->velocity, &msg->effort, &msg->k_q_p, &msg->k_qd_p}) {
+          if (!values->empty() && values->size() != njoints) {
+            RCLCPP_ERROR_THROTTLE(get_node()->get_logger(), *get_node()->get_clock(), 1000,
+                                  "Command arrays must be empty or have one entry for each of the %zu joints, but one "
+                                  "has %zu. The command is ignored.",
+                                  njoints, values->size());
+            return;
+          }
+        }
+        command_buffer_.writeFromNonRT(msg);
+      });
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn JointCommandController::on_activate(
+    const rclcpp_lifecycle::State& /*previous_state*/) {
+  // Commands which arrived while inactive are dropped, so the joints keep their current commands until a new one.
+  command_buffer_.writeFromNonRT(nullptr);
+  last_command_.reset();
+  timed_out_ = false;
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn JointCommandController::on_deactivate(
+    const rclcpp_lifecycle::State& /*previous_state*/) {
+  command_buffer_.writeFromNonRT(nullptr);
+  last_command_.reset();
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type JointCommandController::update(const rclcpp::Time& time,
+                                                                 const rclcpp::Duration& /*period*/) {
+  const auto command = *command_buffer_.readFromRT();
+  if (!command) {
+    return controller_interface::return_type::OK;
+  }
+
+  const auto njoints = params_.joints.size();
+  const auto apply = [this, njoints](const std::vector<double>& values, const std::size_t interface_index) {
+    for (std::size_t i = 0; i < values.size() && i < njoints; ++i) {
+      command_interfaces_[i * kJointInterfaces.size() + interface_index].set_value(values[i]);
+    }
+  };
+
+  if (command != last_command_) {
+    apply(command->position, kPosition);
+    apply(command->velocity, kVelocity);
+    apply(command->effort, kEffort);
+    apply(command->k_q_p, kKQP);
+    apply(command->k_qd_p, kKQDP);
+    last_command_ = command;
+    last_command_time_ = time;
+    timed_out_ = false;
+  } else if (!timed_out_ && params_.command_timeout > 0.0 &&
+             (time - last_command_time_).seconds() > params_.command_timeout) {
+    // Without new commands, the joints hold their last position instead of continuing to push.
+    for (std::size_t i = 0; i < njoints; ++i) {
+      command_interfaces_[i * kJointInterfaces.size() + kVelocity].set_value(0.0);
+      command_interfaces_[i * kJointInterfaces.size() + kEffort].set_value(0.0);
+    }
+    timed_out_ = true;
+    RCLCPP_WARN(get_node()->get_logger(), "No command received for %.3f s, holding the last position.",
+                params_.command_timeout);
+  }
+  return controller_interface::return_type::OK;
+}
+
+}  // namespace spot_controllers
+
+#include "pluginlib/class_list_macros.hpp"
+
+PLUGINLIB_EXPORT_CLASS(spot_controllers::JointCommandController, controller_interface::ControllerInterface)
@@ -0,0 +1,125 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include "spot_controllers/odometry_broadcaster.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <string>
+
+#include "rclcpp/logging.hpp"
+#include "rclcpp/qos.hpp"
+
+namespace {
+// Names of the state interfaces of the body exported by the Spot hardware interface, in the order of their values.
+constexpr std::array<const char*, 13> kBodyStateInterfaces{
+    "position.x",        "position.y",        "position.z",        "orientation.x",    "orientation.y",
+    "orientation.z",     "orientation.w",     "linear_velocity.x", "linear_velocity.y", "linear_velocity.z",
+    "angular_velocity.x", "angular_velocity.y", "angular_velocity.z"};
+
+constexpr auto kOdometryTopic = "~/odometry";
+constexpr auto kTfTopic = "/tf";
+}  // namespace
+
+namespace spot_controllers {
+OdometryBroadcaster::OdometryBroadcaster() : controller_interface::ControllerInterface() {}
+
+controller_interface::InterfaceConfiguration OdometryBroadcaster::command_interface_configuration() const {
+  return controller_interface::InterfaceConfiguration{controller_interface::interface_configuration_type::NONE};
+}
+
+controller_interface::InterfaceConfiguration OdometryBroadcaster::state_interface_configuration() const {
+  controller_interface::InterfaceConfiguration config{controller_interface::interface_configuration_type::INDIVIDUAL};
+  for (const auto* interface_name : kBodyStateInterfaces) {
+    config.names.push_back(params_.state_interface_prefix + "/" + interface_name);
+  }
+  return config;
+}
+
+controller_interface::CallbackReturn OdometryBroadcaster::on_init() {
+  try {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+  } catch (const std::exception& e) {
+    RCLCPP_ERROR(get_node()->get_logger(), "Exception thrown during init stage with message: %s", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn OdometryBroadcaster::on_configure(
+    const rclcpp_lifecycle::State& /*previous_state*/) {
+  params_ = param_listener_->get_params();
+
+  odometry_publisher_ =
+      get_node()->create_publisher<nav_msgs::msg::Odometry>(kOdometryTopic, rclcpp::SystemDefaultsQoS());
+  realtime_odometry_publisher_ = std::make_unique<OdometryPublisher>(odometry_publisher_);
+  // The frames never change, so they are filled in once rather than on every update.
+  realtime_odometry_publisher_->msg_.header.frame_id = params_.odom_frame_id;
+  realtime_odometry_publisher_->msg_.child_frame_id = params_.base_frame_id;
+
+  if (params_.publish_tf) {
+    tf_publisher_ = get_node()->create_publisher<tf2_msgs::msg::TFMessage>(kTfTopic, rclcpp::SystemDefaultsQoS());
+    realtime_tf_publisher_ = std::make_unique<TfPublisher>(tf_publisher_);
+    auto& transforms = realtime_tf_publisher_->msg_.transforms;
+    transforms.resize(1);
+    transforms.front().header.frame_id = params_.odom_frame_id;
+    transforms.front().child_frame_id = params_.base_frame_id;
+  } else {
+    tf_publisher_.reset();
+    realtime_tf_publisher_.reset();
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type OdometryBroadcaster::update(const rclcpp::Time& time,
+                                                              const rclcpp::Duration& /*period*/) {
+  std::array<double, kBodyStateInterfaces.size()> values;
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = state_interfaces_[i].get_value();
+  }
+  // The hardware interface reports NaN until the first body state is streamed
+  if (std::isnan(values[0])) {
+    return controller_interface::return_type::OK;
+  }
+
+  if (realtime_odometry_publisher_ && realtime_odometry_publisher_->trylock()) {
+    auto& odometry = realtime_odometry_publisher_->msg_;
+    odometry.header.stamp = time;
+    odometry.pose.pose.position.x = values[0];
+    odometry.pose.pose.position.y = values[1];
+    odometry.pose.pose.position.z = values[2];
+    odometry.pose.pose.orientation.x = values[3];
+    odometry.pose.pose.orientation.y = values[4];
+    odometry.pose.pose.orientation.z = values[5];
+    odometry.pose.pose.orientation.w = values[6];
+    odometry.twist.twist.linear.x = values[7];
+    odometry.twist.twist.linear.y = values[8];
+    odometry.twist.twist.linear.z = values[9];
+    odometry.twist.twist.angular.x = values[10];
+    odometry.twist.twist.angular.y = values[11];
+    odometry.twist.twist.angular.z = values[12];
+    realtime_odometry_publisher_->unlockAndPublish();
+  }
+
+  if (realtime_tf_publisher_ && realtime_tf_publisher_->trylock()) {
+    auto& transform = realtime_tf_publisher_->msg_.transforms.front();
+    transform.header.stamp = time;
+    transform.transform.translation.x = values[0];
+    transform.transform.translation.y = values[1];
+    transform.transform.translation.z = values[2];
+    transform.transform.rotation.x = values[3];
+    transform.transform.rotation.y = values[4];
+    transform.transform.rotation.z = values[5];
+    transform.transform.rotation.w = values[6];
+    realtime_tf_publisher_->unlockAndPublish();
+  }
+  return controller_interface::return_type::OK;
+}
+
+}  // namespace spot_controllers
+
+#include "pluginlib/class_list_macros.hpp"
+
+PLUGINLIB_EXPORT_CLASS(spot_controllers::OdometryBroadcaster, controller_interface::ControllerInterface)
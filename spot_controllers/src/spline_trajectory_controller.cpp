@@ -0,0 +1,204 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include "spot_controllers/spline_trajectory_controller.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rclcpp/logging.hpp"
+#include "rclcpp/qos.hpp"
+
+namespace {
+// Command interfaces of every joint, in the order in which they are claimed.
+constexpr std::array<const char*, 2> kJointInterfaces{"position", "velocity"};
+constexpr std::size_t kPosition = 0;
+constexpr std::size_t kVelocity = 1;
+
+constexpr auto kTrajectoryTopic = "~/joint_trajectory";
+}  // namespace
+
+namespace spot_controllers {
+SplineTrajectoryController::SplineTrajectoryController() : controller_interface::ControllerInterface() {}
+
+controller_interface::InterfaceConfiguration SplineTrajectoryController::command_interface_configuration() const {
+  controller_interface::InterfaceConfiguration config{controller_interface::interface_configuration_type::INDIVIDUAL};
+  for (const auto& joint : params_.joints) {
+    for (const auto* interface_name : kJointInterfaces) {
+      config.names.push_back(joint + "/" + interface_name);
+    }
+  }
+  return config;
+}
+
+controller_interface::InterfaceConfiguration SplineTrajectoryController::state_interface_configuration() const {
+  return controller_interface::InterfaceConfiguration{controller_interface::interface_configuration_type::NONE};
+}
+
+controller_interface::CallbackReturn SplineTrajectoryController::on_init() {
+  try {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+  } catch (const std::exception& e) {
+    RCLCPP_ERROR(get_node()->get_logger(), "Exception thrown during init stage with message: %s", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn SplineTrajectoryController::on_configure(
+    const rclcpp_lifecycle::State& /*previous_state*/) {
+  params_ = param_listener_->get_params();
+  if (params_.joints.empty()) {
+    RCLCPP_ERROR(get_node()->get_logger(), "'joints' parameter was empty");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  start_positions_.assign(params_.joints.size(), 0.0);
+
+  trajectory_subscriber_ = get_node()->create_subscription<trajectory_msgs::msg::JointTrajectory>(
+      kTrajectoryTopic, rclcpp::SystemDefaultsQoS(),
+      [this](const std::shared_ptr<trajectory_msgs::msg::JointTrajectory> msg) {
+        if (auto trajectory = make_trajectory(*msg)) {
+          trajectory_buffer_.writeFromNonRT(trajectory);
+        }
+      });
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn SplineTrajectoryController::on_activate(
+    const rclcpp_lifecycle::State& /*previous_state*/) {
+  // Trajectories which arrived while inactive are dropped, so the joints keep their current commands.
+  trajectory_buffer_.writeFromNonRT(nullptr);
+  active_trajectory_.reset();
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn SplineTrajectoryController::on_deactivate(
+    const rclcpp_lifecycle::State& /*previous_state*/) {
+  trajectory_buffer_.writeFromNonRT(nullptr);
+  active_trajectory_.reset();
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+std::shared_ptr<const SplineTrajectoryController::Trajectory> SplineTrajectoryController::make_trajectory(
+    const trajectory_msgs::msg::JointTrajectory& msg) const {
+  const auto njoints = params_.joints.size();
+  // Index of every controlled joint in the message
+  std::vector<std::size_t> msg_index(njoints);
+  for (std::size_t i = 0; i < njoints; ++i) {
+    const auto it = std::find(msg.joint_names.begin(), msg.joint_names.end(), params_.joints[i]);
+    if (it == msg.joint_names.end()) {
+      RCLCPP_ERROR(get_node()->get_logger(), "Trajectory does not contain joint '%s'. It is ignored.",
+                   params_.joints[i].c_str());
+      return nullptr;
+    }
+    msg_index[i] = static_cast<std::size_t>(std::distance(msg.joint_names.begin(), it));
+  }
+  if (msg.points.empty()) {
+    RCLCPP_ERROR(get_node()->get_logger(), "Trajectory has no points. It is ignored.");
+    return nullptr;
+  }
+
+  auto trajectory = std::make_shared<Trajectory>();
+  trajectory->start = rclcpp::Time(msg.header.stamp, get_node()->get_clock()->get_clock_type());
+  if (trajectory->start.nanoseconds() == 0) {
+    trajectory->start = get_node()->now();
+  }
+  trajectory->times.reserve(msg.points.size());
+  trajectory->positions.reserve(msg.points.size() * njoints);
+  trajectory->velocities.reserve(msg.points.size() * njoints);
+  for (const auto& point : msg.points) {
+    const double time = rclcpp::Duration(point.time_from_start).seconds();
+    if (point.positions.size() != msg.joint_names.size() ||
+        (!point.velocities.empty() && point.velocities.size() != msg.joint_names.size()) ||
+        (!trajectory->times.empty() && time <= trajectory->times.back()) || time < 0.0) {
+      RCLCPP_ERROR(get_node()->get_logger(),
+                   "Trajectory points must have a position (and optionally a velocity) for every joint, and increasing "
+                   "times from start. It is ignored.");
+      return nullptr;
+    }
+    trajectory->times.push_back(time);
+    for (const auto index : msg_index) {
+      trajectory->positions.push_back(point.positions[index]);
+      trajectory->velocities.push_back(point.velocities.empty() ? 0.0 : point.velocities[index]);
+    }
+  }
+  return trajectory;
+}
+
+controller_interface::return_type SplineTrajectoryController::update(const rclcpp::Time& time,
+                                                                     const rclcpp::Duration& /*period*/) {
+  const auto njoints = params_.joints.size();
+  const auto trajectory = *trajectory_buffer_.readFromRT();
+  if (trajectory != active_trajectory_) {
+    // A new trajectory starts from the positions which are commanded now.
+    active_trajectory_ = trajectory;
+    next_point_ = 0;
+    for (std::size_t i = 0; i < njoints; ++i) {
+      start_positions_[i] = command_interfaces_[i * kJointInterfaces.size() + kPosition].get_value();
+    }
+  }
+  if (!active_trajectory_) {
+    return controller_interface::return_type::OK;
+  }
+
+  const double t = (time - active_trajectory_->start).seconds();
+  if (t < 0.0) {
+    return controller_interface::return_type::OK;
+  }
+  const auto& times = active_trajectory_->times;
+  while (next_point_ < times.size() && times[next_point_] <= t) {
+    ++next_point_;
+  }
+
+  const auto set_command = [this](const std::size_t joint, const double position, const double velocity) {
+    command_interfaces_[joint * kJointInterfaces.size() + kPosition].set_value(position);
+    command_interfaces_[joint * kJointInterfaces.size() + kVelocity].set_value(velocity);
+  };
+
+  // After the last point, the joints hold its position
+  if (next_point_ == times.size()) {
+    const auto* last = &active_trajectory_->positions[(times.size() - 1) * njoints];
+    for (std::size_t i = 0; i < njoints; ++i) {
+      set_command(i, last[i], 0.0);
+    }
+    return controller_interface::return_type::OK;
+  }
+
+  // Cubic Hermite spline from the previous point, or from the start positions at rest, to the next point
+  const double t0 = next_point_ == 0 ? 0.0 : times[next_point_ - 1];
+  const double dt = times[next_point_] - t0;
+  const double s = (t - t0) / dt;
+  const double s2 = s * s;
+  const double s3 = s2 * s;
+  const double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+  const double h10 = s3 - 2.0 * s2 + s;
+  const double h01 = -2.0 * s3 + 3.0 * s2;
+  const double h11 = s3 - s2;
+  const double dh00 = 6.0 * s2 - 6.0 * s;
+  const double dh10 = 3.0 * s2 - 4.0 * s + 1.0;
+  const double dh01 = -6.0 * s2 + 6.0 * s;
+  const double dh11 = 3.0 * s2 - 2.0 * s;
+  const bool from_start = next_point_ == 0;
+  const auto* p0 = from_start ? start_positions_.data() : &active_trajectory_->positions[(next_point_ - 1) * njoints];
+  const auto* v0 = from_start ? nullptr : &active_trajectory_->velocities[(next_point_ - 1) * njoints];
+  const auto* p1 = &active_trajectory_->positions[next_point_ * njoints];
+  const auto* v1 = &active_trajectory_->velocities[next_point_ * njoints];
+  for (std::size_t i = 0; i < njoints; ++i) {
+    const double v0_i = from_start ? 0.0 : v0[i];
+    const double position = h00 * p0[i] + h10 * dt * v0_i + h01 * p1[i] + h11 * dt * v1[i];
+    const double velocity = (dh00 * p0[i] + dh10 * dt * v0_i + dh01 * p1[i] + dh11 * dt * v1[i]) / dt;
+    set_command(i, position, velocity);
+  }
+  return controller_interface::return_type::OK;
+}
+
+}  // namespace spot_controllers
+
+#include "pluginlib/class_list_macros.hpp"
+
+PLUGINLIB_EXPORT_CLASS(spot_controllers::SplineTrajectoryController, controller_interface::ControllerInterface)
@@ -0,0 +1,59 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Model of the clock skew between Spot and the local system, as an offset which drifts at a constant rate.
+ * @details The time sync endpoint only updates its estimate of the clock skew when it resyncs, and every new estimate
+ * makes the converted timestamps jump. This filter smooths the estimates with an alpha-beta filter instead, and
+ * predicts the clock skew at any local time from the filtered offset and drift rate, so converted timestamps change
+ * smoothly between resyncs. A measurement which is far from the prediction, for example after Spot's clock was
+ * set, resets the model. This class is thread-safe.
+ */
+class ClockSkewFilter {
+ public:
+  /** @brief Weight of the residual of a measurement in the filtered offset. */
+  static constexpr double kOffsetGain = 0.3;
+  /** @brief Weight of the residual of a measurement, divided by the time since the previous one, in the drift rate. */
+  static constexpr double kDriftGain = 0.05;
+  /** @brief Maximum drift rate between the two clocks, which bounds the effect of noisy measurements. */
+  static constexpr double kMaxDriftRate = 1e-4;
+  /** @brief Residual in nanoseconds above which a measurement resets the model. */
+  static constexpr std::int64_t kMaxResidual = 100'000'000;
+
+  /**
+   * @brief Update the model with a clock skew measured by the time sync endpoint.
+   * @details Measurements equal to the previous one are ignored, since the endpoint only changes its estimate when it
+   * resyncs.
+   * @param local_time Local system time of the measurement, in nanoseconds.
+   * @param clock_skew Measured clock skew, in nanoseconds.
+   */
+  void update(std::int64_t local_time, std::int64_t clock_skew);
+
+  /**
+   * @brief Predict the clock skew at a local system time.
+   * @param local_time Local system time, in nanoseconds.
+   * @return The predicted clock skew in nanoseconds, or nullopt if no clock skew was measured yet.
+   */
+  [[nodiscard]] std::optional<std::int64_t> predict(std::int64_t local_time) const;
+
+ private:
+  /** @brief Return the clock skew at a local time predicted by the current model. Requires mutex_ to be held. */
+  [[nodiscard]] std::int64_t predictLocked(std::int64_t local_time) const;
+
+  mutable std::mutex mutex_;
+  bool initialized_ = false;
+  // Last measured clock skew, and the filtered clock skew at the local time at which it was measured.
+  std::int64_t last_measurement_ = 0;
+  std::int64_t reference_time_ = 0;
+  std::int64_t offset_ = 0;
+  // Change of the clock skew per nanosecond of local time.
+  double drift_rate_ = 0.0;
+};
+}  // namespace spot_ros2
@@ -4,12 +4,28 @@
 
 #include <bosdyn/client/image/image_client.h>
 #include <bosdyn/client/sdk/client_sdk.h>
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <google/protobuf/duration.pb.h>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <spot_driver/api/link_monitor.hpp>
 #include <spot_driver/api/spot_image_sources.hpp>
 #include <spot_driver/api/time_sync_api.hpp>
+#include <spot_driver/conversions/depth_ray_table.hpp>
 #include <spot_driver/interfaces/image_client_interface.hpp>
+#include <spot_driver/interfaces/thread_pool_interface_base.hpp>
 
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <string>
+#include <vector>
 
 namespace spot_ros2 {
 /**
@@ -17,16 +33,121 @@ namespace spot_ros2 {
  */
 class DefaultImageClient : public ImageClientInterface {
  public:
+  /**
+   * @brief The constructor for DefaultImageClient.
+   * @param image_client Image client of the robot session.
+   * @param time_sync_api Time sync of the robot session, used to correct the stamps of the images.
+   * @param robot_name Name of the robot, which prefixes the frames of the images.
+   * @param thread_pool Thread pool which converts the image responses concurrently.
+   * @param link_monitor Records the outcome of every request, or nullptr.
+   */
   DefaultImageClient(::bosdyn::client::ImageClient* image_client, std::shared_ptr<TimeSyncApi> time_sync_api,
-                     const std::string& robot_name);
+                     const std::string& robot_name, std::shared_ptr<ThreadPoolInterfaceBase> thread_pool,
+                     std::shared_ptr<LinkMonitor> link_monitor = nullptr);
 
   [[nodiscard]] tl::expected<GetImagesResult, std::string> getImages(::bosdyn::api::GetImageRequest request,
                                                                      bool uncompress_images,
-                                                                     bool publish_compressed_images) override;
+                                                                     bool publish_compressed_images,
+                                                                     const GetImagesOptions& options) override;
 
  private:
+  /** @brief Image requests that were sent to Spot ahead of time for one GetImageRequest. */
+  struct RequestPipeline {
+    std::deque<std::shared_future<::bosdyn::client::GetImageResultType>> in_flight;
+    std::size_t last_used{0};
+  };
+
+  /**
+   * @brief Send the image request to Spot and wait for its response. If more than one request may be in flight, the
+   * response comes from a request that was sent by an earlier call, and new requests are sent so that the next calls
+   * do not have to wait for a full round trip.
+   *
+   * @param request Image request to send to Spot.
+   * @param max_requests_in_flight Maximum number of identical requests kept outstanding with Spot.
+   * @param timeout Time after which each request is cancelled.
+   * @return The future of the oldest outstanding request. The response is read in place from the future, since
+   * copying it would copy the data of every image.
+   */
+  std::shared_future<::bosdyn::client::GetImageResultType> fetchImages(const ::bosdyn::api::GetImageRequest& request,
+                                                                       const std::size_t max_requests_in_flight,
+                                                                       const std::chrono::duration<double> timeout);
+
+  /** @brief CameraInfo message of an image source, and the sensor frame of the image response it was built from. */
+  struct CachedCameraInfo {
+    std::shared_ptr<const sensor_msgs::msg::CameraInfo> info;
+    std::string frame_name_image_sensor;
+  };
+
+  /**
+   * @brief Get the CameraInfo message for an image response.
+   * @details The message is only rebuilt when the resolution, intrinsics or sensor frame of the image source change.
+   * Otherwise the cached message is shared as it is. Its stamp is the one of the image it was built for, so callers
+   * stamp their own copies with the acquisition time of the image response.
+   *
+   * @param image_response Image response received from Spot.
+   * @param source Image source of the response, or nullopt if it is not a known source, whose message is not cached.
+   * @param clock_skew Clock skew between the robot and the local system.
+   * @return The CameraInfo message, or an error message if it could not be built.
+   */
+  tl::expected<std::shared_ptr<const sensor_msgs::msg::CameraInfo>, std::string> getCameraInfo(
+      const ::bosdyn::api::ImageResponse& image_response, const std::optional<ImageSource>& source,
+      const google::protobuf::Duration& clock_skew);
+
+  /**
+   * @brief Get the ray table of an image source for reprojecting its depth images.
+   * @details The table is only rebuilt when the resolution or intrinsics of the image source change. A rebuilt table
+   * replaces the cached one instead of modifying it, so tables that were handed out earlier stay valid.
+   *
+   * @param source Image source.
+   * @param info CameraInfo message of the image source.
+   * @return The ray table.
+   */
+  std::shared_ptr<const DepthRayTable> getRayTable(const ImageSource& source, const sensor_msgs::msg::CameraInfo& info);
+
+  /**
+   * @brief Get the child frames whose static transforms were already returned. If the refresh period has passed since
+   * the set was last cleared, clear it first.
+   *
+   * @param refresh_period Period after which the static transforms are returned again. Zero or less never clears them.
+   * @return The child frames, without the robot name prefix.
+   */
+  std::shared_ptr<const std::set<std::string>> getEmittedStaticFrames(
+      const std::chrono::duration<double> refresh_period);
+
+  /**
+   * @brief Remember the child frames of static transforms that are being returned.
+   *
+   * @param previous_frames Set of child frames which was used to convert the image responses.
+   * @param transforms Static transforms which are being returned.
+   */
+  void addEmittedStaticFrames(const std::set<std::string>& previous_frames,
+                              const std::vector<geometry_msgs::msg::TransformStamped>& transforms);
+
   ::bosdyn::client::ImageClient* image_client_;
   std::shared_ptr<TimeSyncApi> time_sync_api_;
   std::string robot_name_;
+  std::shared_ptr<ThreadPoolInterfaceBase> thread_pool_;
+  std::shared_ptr<LinkMonitor> link_monitor_;
+
+  /** @brief Outstanding requests, keyed by the serialized GetImageRequest they were sent for. */
+  std::map<std::string, RequestPipeline> pipelines_;
+  std::size_t pipeline_calls_{0};
+  std::mutex pipelines_mutex_;
+
+  /** @brief CameraInfo messages, indexed by toImageSourceIndex. */
+  std::array<std::optional<CachedCameraInfo>, kNumImageSources> camera_info_cache_;
+  std::mutex camera_info_cache_mutex_;
+
+  /** @brief Ray tables for reprojecting depth images, indexed by toImageSourceIndex. */
+  std::array<std::shared_ptr<const DepthRayTable>, kNumImageSources> ray_tables_;
+  std::mutex ray_tables_mutex_;
+
+  /**
+   * @brief Child frames whose static transforms were already returned. The set is replaced rather than modified, so
+   * that it can be read by the decode workers without holding the lock.
+   */
+  std::shared_ptr<const std::set<std::string>> emitted_static_frames_{std::make_shared<const std::set<std::string>>()};
+  std::chrono::steady_clock::time_point emitted_static_frames_reset_time_{std::chrono::steady_clock::now()};
+  std::mutex emitted_static_frames_mutex_;
 };
 }  // namespace spot_ros2
@@ -3,24 +3,43 @@
 #pragma once
 
 #include <spot_driver/api/kinematic_api.hpp>
+#include <spot_driver/api/link_monitor.hpp>
 
 #include <tl_expected/expected.hpp>
 
+#include <chrono>
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace spot_ros2 {
 
 class DefaultKinematicApi : public KinematicApi {
  public:
-  explicit DefaultKinematicApi(bosdyn::client::InverseKinematicsClient* kinematic_client);
+  /**
+   * @param kinematic_client Inverse kinematics client of the robot session, which is not owned.
+   * @param link_monitor Records the outcome of every request, or nullptr.
+   */
+  explicit DefaultKinematicApi(bosdyn::client::InverseKinematicsClient* kinematic_client,
+                               std::shared_ptr<LinkMonitor> link_monitor = nullptr);
 
   /**
    * @brief Return a solution to the given request.
    */
   [[nodiscard]] tl::expected<InverseKinematicsResponse, std::string> getSolutions(
-      InverseKinematicsRequest& request) override;
+      InverseKinematicsRequest& request, std::chrono::duration<double> timeout) override;
+
+  /**
+   * @brief Return a solution to each of the given requests, with up to max_requests_in_flight of them sent to Spot
+   * concurrently. Requests which are still outstanding past the timeout are abandoned.
+   */
+  [[nodiscard]] std::vector<tl::expected<InverseKinematicsResponse, std::string>> getBatchSolutions(
+      std::vector<InverseKinematicsRequest>& requests, const std::size_t max_requests_in_flight,
+      std::chrono::duration<double> timeout) override;
 
  private:
   bosdyn::client::InverseKinematicsClient* kinematic_client_;
+  std::shared_ptr<LinkMonitor> link_monitor_;
 };
 }  // namespace spot_ros2
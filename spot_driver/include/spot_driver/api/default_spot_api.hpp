@@ -12,12 +12,27 @@
 #include <spot_driver/api/world_object_client_interface.hpp>
 
 #include <chrono>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <tuple>
+#include <utility>
 
 namespace spot_ros2 {
 
+/**
+ * @brief Implementation of SpotApi which uses the Spot C++ SDK.
+ * @details Every DefaultSpotApi in a process which connects to the same robot shares one robot session, so that nodes
+ * which are composed into a single process only create the robot interface, authenticate, start time synchronization
+ * and query the arm once. The service clients are created when they are first accessed after the authentication, and
+ * the accessors return nullptr if a client cannot be created. The session is closed when the last DefaultSpotApi that
+ * uses it is destroyed.
+ *
+ * The sessions to different robots share one SDK per certificate, and the SDK is only created when the first session
+ * which needs it is opened, so it is named after the client of that session.
+ */
 class DefaultSpotApi : public SpotApi {
  public:
   explicit DefaultSpotApi(const std::string& sdk_client_name, const std::chrono::seconds timesync_timeout,
@@ -36,13 +51,47 @@ class DefaultSpotApi : public SpotApi {
   [[nodiscard]] std::shared_ptr<WorldObjectClientInterface> worldObjectClientInterface() const override;
 
  private:
-  std::unique_ptr<::bosdyn::client::ClientSdk> client_sdk_;
-  std::unique_ptr<::bosdyn::client::Robot> robot_;
-  std::shared_ptr<KinematicApi> kinematic_interface_;
-  std::shared_ptr<ImageClientInterface> image_client_interface_;
-  std::shared_ptr<StateClientInterface> state_client_interface_;
-  std::shared_ptr<TimeSyncApi> time_sync_api_;
-  std::shared_ptr<WorldObjectClientInterface> world_object_client_interface_;
+  /** @brief Connection to one robot and the Spot API clients created for it. */
+  struct Session {
+    /**
+     * @brief Serializes the authentication, arm check and client creation of the DefaultSpotApis that share the
+     * session.
+     */
+    std::mutex mutex;
+    std::shared_ptr<::bosdyn::client::ClientSdk> client_sdk;
+    std::unique_ptr<::bosdyn::client::Robot> robot;
+    /** @brief Username and password of the last successful authentication, if any. */
+    std::optional<std::pair<std::string, std::string>> credentials;
+    std::optional<bool> has_arm;
+    std::shared_ptr<KinematicApi> kinematic_interface;
+    std::shared_ptr<ImageClientInterface> image_client_interface;
+    std::shared_ptr<StateClientInterface> state_client_interface;
+    std::shared_ptr<TimeSyncApi> time_sync_api;
+    std::shared_ptr<WorldObjectClientInterface> world_object_client_interface;
+  };
+
+  /** @brief Robot name, IP address and port which identify a session. */
+  using SessionKey = std::tuple<std::string, std::string, std::optional<int>>;
+
+  /** @brief Sessions which are open in this process. Sessions are removed once they are no longer used. */
+  static std::map<SessionKey, std::weak_ptr<Session>> sessions_;
+  static std::mutex sessions_mutex_;
+
+  /**
+   * @brief SDKs which are used by the sessions of this process, by certificate. They are removed once no session uses
+   * them. Guarded by sessions_mutex_.
+   */
+  static std::map<std::optional<std::string>, std::weak_ptr<::bosdyn::client::ClientSdk>> client_sdks_;
+
+  /**
+   * @brief Return the SDK which is shared by the sessions which use the certificate of this instance, creating it if
+   * there is none. sessions_mutex_ must be held.
+   */
+  [[nodiscard]] tl::expected<std::shared_ptr<::bosdyn::client::ClientSdk>, std::string> getClientSdk() const;
+
+  std::string sdk_client_name_;
+  std::optional<std::string> certificate_;
+  std::shared_ptr<Session> session_;
   std::string robot_name_;
   const std::chrono::seconds timesync_timeout_;
 };
@@ -3,7 +3,10 @@
 #pragma once
 
 #include <bosdyn/client/robot_state/robot_state_client.h>
+#include <spot_driver/api/link_monitor.hpp>
 #include <spot_driver/api/state_client_interface.hpp>
+#include <chrono>
+#include <memory>
 #include <string>
 #include <tl_expected/expected.hpp>
 
@@ -16,19 +19,24 @@ class DefaultStateClient final : public StateClientInterface {
    *
    * @param client A pointer to Spot's RobotStateClient. A DefaultStateClient SHOULD NOT delete this pointer since it
    * does not take ownership.
+   * @param link_monitor Records the outcome of every request, or nullptr.
    */
-  explicit DefaultStateClient(::bosdyn::client::RobotStateClient* client);
+  explicit DefaultStateClient(::bosdyn::client::RobotStateClient* client,
+                              std::shared_ptr<LinkMonitor> link_monitor = nullptr);
 
   /**
    * @brief Retrieve Spot's most recent robot state data.
+   * @param timeout Time after which the request is cancelled. A value of zero or less keeps the SDK's timeout.
    * @return Returns an expected which contains a RobotState message if the request was completed successfully or an
-   * error message if the request could not be completed.
+   * error message if the request could not be completed in time.
    */
-  [[nodiscard]] tl::expected<bosdyn::api::RobotState, std::string> getRobotState() override;
+  [[nodiscard]] tl::expected<bosdyn::api::RobotState, std::string> getRobotState(
+      std::chrono::duration<double> timeout) override;
 
  private:
   /** @brief A pointer to a RobotStateClient provided to this class during construction. */
   ::bosdyn::client::RobotStateClient* client_;
+  std::shared_ptr<LinkMonitor> link_monitor_;
 };
 
 }  // namespace spot_ros2
@@ -6,10 +6,13 @@
 #include <google/protobuf/duration.pb.h>
 #include <google/protobuf/timestamp.pb.h>
 #include <builtin_interfaces/msg/time.hpp>
+#include <spot_driver/api/clock_skew_filter.hpp>
 #include <spot_driver/api/time_sync_api.hpp>
 #include <tl_expected/expected.hpp>
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -29,6 +32,11 @@ class DefaultTimeSyncApi : public TimeSyncApi {
   * The Spot SDK documentation provides a more detailed explanation of how Spot's time sync works here:
   * https://dev.bostondynamics.com/docs/concepts/base_services#time-sync
   *
+  * The clock skew measured by the time sync endpoint only changes when the time sync thread resyncs. It is filtered
+  * by a ClockSkewFilter, and the returned clock skew is predicted by the filter at the current system time, so it does
+  * not jump when the endpoint updates its estimate. The filter is updated from the time sync endpoint, which can block
+  * until time sync is established, at most once per kClockSkewRefreshPeriod.
+  *
   * @return If the clock skew was successfully calculated, return a Duration containing the difference between Spot's
   * internal clock and the host's system clock.
   * @return If the Spot SDK's time sync thread was not initialized, return an error message.
@@ -36,7 +44,17 @@ class DefaultTimeSyncApi : public TimeSyncApi {
   */
   [[nodiscard]] tl::expected<google::protobuf::Duration, std::string> getClockSkew() override;
 
+  /** @brief Maximum age of the cached clock skew before it is refreshed from the time sync endpoint. */
+  static constexpr std::chrono::milliseconds kClockSkewRefreshPeriod{1000};
+
  private:
+  /** @brief Request the clock skew from the time sync endpoint, and update the filter with it if it succeeds. */
+  tl::expected<void, std::string> refreshClockSkew();
+
+  ClockSkewFilter clock_skew_filter_;
+  /** @brief Steady clock time in nanoseconds at which the filter was last updated, or zero if it was never updated. */
+  std::atomic<std::int64_t> clock_skew_refreshed_ns_{0};
+
   std::shared_ptr<::bosdyn::client::TimeSyncThread> time_sync_thread_;
   const std::chrono::seconds timesync_timeout_;
 };
@@ -2,12 +2,16 @@
 
 #pragma once
 
+#include <spot_driver/api/link_monitor.hpp>
 #include <spot_driver/api/world_object_client_interface.hpp>
 
 #include <bosdyn/client/world_objects/world_object_client.h>
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <tl_expected/expected.hpp>
+#include <vector>
 
 namespace spot_ros2 {
 /** @brief Implements WorldObjectClientInterface for the Spot API. */
@@ -16,12 +20,17 @@ class DefaultWorldObjectClient : public WorldObjectClientInterface {
   /**
    * @brief Constructor for DefaultWorldObjectClient.
    * @param client Pointer to a WorldObjectClient created by the Spot API.
+   * @param link_monitor Records the outcome of every request, or nullptr.
    */
-  explicit DefaultWorldObjectClient(bosdyn::client::WorldObjectClient* client);
+  explicit DefaultWorldObjectClient(bosdyn::client::WorldObjectClient* client,
+                                    std::shared_ptr<LinkMonitor> link_monitor = nullptr);
   tl::expected<::bosdyn::api::ListWorldObjectResponse, std::string> listWorldObjects(
-      ::bosdyn::api::ListWorldObjectRequest& request) const override;
+      ::bosdyn::api::ListWorldObjectRequest& request, std::chrono::duration<double> timeout) const override;
   tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string> mutateWorldObject(
-      ::bosdyn::api::MutateWorldObjectRequest& request) const override;
+      ::bosdyn::api::MutateWorldObjectRequest& request, std::chrono::duration<double> timeout) const override;
+  std::vector<tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>> mutateWorldObjects(
+      std::vector<::bosdyn::api::MutateWorldObjectRequest>& requests, const std::size_t max_requests_in_flight,
+      std::chrono::duration<double> timeout) const override;
 
  private:
   /**
@@ -29,5 +38,6 @@ class DefaultWorldObjectClient : public WorldObjectClientInterface {
    * DefaultWorldObjectClient must not delete this pointer, since it does not take ownership.
    */
   bosdyn::client::WorldObjectClient* client_;
+  std::shared_ptr<LinkMonitor> link_monitor_;
 };
 }  // namespace spot_ros2
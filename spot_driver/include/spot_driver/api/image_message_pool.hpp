@@ -0,0 +1,64 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <sensor_msgs/msg/compressed_image.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/api/spot_image_sources.hpp>
+#include <spot_driver/types.hpp>
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Keeps image messages of each image source after they were published, so that their data buffers can be reused
+ * for the next images of the same source instead of being freed and allocated again.
+ * @details Images of a source usually have the same size from one cycle to the next, so a recycled message already has
+ * a data buffer of the right capacity. Messages whose buffers were moved into the middleware have no capacity left and
+ * are not kept. All methods are safe to call concurrently.
+ */
+class ImageMessagePool {
+ public:
+  /**
+   * @brief Take an image message for an image source out of the pool.
+   *
+   * @param image_source Image source the message will be used for.
+   * @return A recycled message with preallocated data, or a new message if the pool has none for this source.
+   */
+  sensor_msgs::msg::Image acquireImage(const ImageSource& image_source);
+
+  /**
+   * @brief Take a compressed image message for an image source out of the pool.
+   *
+   * @param image_source Image source the message will be used for.
+   * @return A recycled message with preallocated data, or a new message if the pool has none for this source.
+   */
+  sensor_msgs::msg::CompressedImage acquireCompressedImage(const ImageSource& image_source);
+
+  /**
+   * @brief Return an image message of an image source to the pool once it is no longer needed.
+   *
+   * @param image_source Image source the message was used for.
+   * @param image Message to keep for reuse.
+   */
+  void releaseImage(const ImageSource& image_source, sensor_msgs::msg::Image&& image);
+
+  /**
+   * @brief Return a compressed image message of an image source to the pool once it is no longer needed.
+   *
+   * @param image_source Image source the message was used for.
+   * @param compressed_image Message to keep for reuse.
+   */
+  void releaseCompressedImage(const ImageSource& image_source, sensor_msgs::msg::CompressedImage&& compressed_image);
+
+ private:
+  std::array<std::vector<sensor_msgs::msg::Image>, kNumImageSources> images_;
+  std::array<std::vector<sensor_msgs::msg::CompressedImage>, kNumImageSources> compressed_images_;
+  std::mutex mutex_;
+};
+
+}  // namespace spot_ros2
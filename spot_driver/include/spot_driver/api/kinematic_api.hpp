@@ -7,7 +7,10 @@
 
 #include <tl_expected/expected.hpp>
 
+#include <chrono>
+#include <cstddef>
 #include <string>
+#include <vector>
 
 namespace spot_ros2 {
 
@@ -28,7 +31,29 @@ class KinematicApi {
 
   /**
    * Return a solution to the given request.
+   * @param request The request to solve.
+   * @param timeout Time after which the request is cancelled and an error is returned. A value of zero or less waits
+   * for as long as the Spot SDK does.
    */
-  virtual tl::expected<InverseKinematicsResponse, std::string> getSolutions(InverseKinematicsRequest& request) = 0;
+  virtual tl::expected<InverseKinematicsResponse, std::string> getSolutions(InverseKinematicsRequest& request,
+                                                                            std::chrono::duration<double> timeout) = 0;
+
+  /**
+   * Return a solution to each of the given requests.
+   * @param requests The requests to solve.
+   * @param max_requests_in_flight Maximum number of requests which are outstanding with Spot at the same time.
+   * @param timeout Time after which each request is cancelled. A value of zero or less keeps the SDK's timeout.
+   * @return The result of every request, in the order of the requests.
+   */
+  virtual std::vector<tl::expected<InverseKinematicsResponse, std::string>> getBatchSolutions(
+      std::vector<InverseKinematicsRequest>& requests, [[maybe_unused]] const std::size_t max_requests_in_flight,
+      const std::chrono::duration<double> timeout) {
+    std::vector<tl::expected<InverseKinematicsResponse, std::string>> responses;
+    responses.reserve(requests.size());
+    for (auto& request : requests) {
+      responses.push_back(getSolutions(request, timeout));
+    }
+    return responses;
+  }
 };
 }  // namespace spot_ros2
@@ -0,0 +1,134 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <spot_driver/interfaces/parameter_interface_base.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace spot_ros2 {
+
+/** @brief Quality of the link to Spot, as seen from the requests of the driver. */
+enum class LinkQuality {
+  /** @brief Requests succeed in time. */
+  kGood,
+  /** @brief Too many requests fail or take too long, so the nodes of the driver reduce their load on the link. */
+  kDegraded,
+};
+
+/** @brief Thresholds at which a LinkMonitor considers the link degraded. */
+struct LinkMonitorOptions {
+  /** @brief Requests older than this are forgotten. */
+  std::chrono::steady_clock::duration window{std::chrono::seconds{5}};
+  /** @brief The link is not judged on fewer requests than this, so that a single slow request does not degrade it. */
+  std::size_t min_requests{5};
+  /** @brief The link is degraded if the successful requests take this long on average. Zero or less is ignored. */
+  std::chrono::duration<double> degraded_latency{0.3};
+  /** @brief The link is degraded if this fraction of the requests fails. */
+  double degraded_failure_rate{0.2};
+  /** @brief A degraded link is only restored once it has looked good for this long, so that it does not flap. */
+  std::chrono::steady_clock::duration recovery_period{std::chrono::seconds{5}};
+};
+
+/**
+ * @brief Collects the latency and the outcome of the requests to one robot, and judges the quality of the link from
+ * them.
+ * @details The Spot API clients of a robot record every request they send, and the publishers of the robot read the
+ * quality to lower their rates while the link is degraded. Since all nodes of a robot in a process share its monitor,
+ * they degrade and recover together, instead of each of them hammering a link that is already struggling. The link
+ * becomes degraded as soon as the recent requests cross a threshold, and is only restored after it looked good for
+ * LinkMonitorOptions::recovery_period. Any thread can record requests and read the quality.
+ */
+class LinkMonitor {
+ public:
+  /** @brief Statistics of the requests within the window. */
+  struct Statistics {
+    std::size_t requests{0};
+    std::size_t failures{0};
+    /** @brief Mean latency of the successful requests. */
+    std::chrono::duration<double> mean_latency{0.0};
+
+    [[nodiscard]] double failureRate() const {
+      return requests > 0 ? static_cast<double>(failures) / static_cast<double>(requests) : 0.0;
+    }
+  };
+
+  LinkMonitor() = default;
+  virtual ~LinkMonitor() = default;
+
+  /**
+   * @brief Get the monitor of a robot, which is shared by every client and publisher of that robot in this process.
+   *
+   * @param robot_name Name of the robot. Unnamed robots share one monitor.
+   * @return The monitor of the robot, which is created by the first call for that robot.
+   */
+  static std::shared_ptr<LinkMonitor> getForRobot(const std::string& robot_name);
+
+  /**
+   * @brief Set the thresholds of the monitor. The nodes of a robot read them from the same parameters, so the last
+   * node to call this wins without changing anything.
+   */
+  void configure(const LinkMonitorOptions& options);
+
+  /**
+   * @brief Record a request to Spot.
+   *
+   * @param latency Time from sending the request until its response or failure.
+   * @param success False if the request failed or timed out.
+   */
+  void record(std::chrono::steady_clock::duration latency, bool success);
+
+  /** @brief Get the statistics of the requests within the window. */
+  [[nodiscard]] Statistics statistics() const;
+
+  /** @brief Get the current quality of the link. */
+  [[nodiscard]] LinkQuality quality() const;
+
+ protected:
+  /** @brief Get the current time. Tests override this to control the window. */
+  virtual std::chrono::steady_clock::time_point now() const;
+
+ private:
+  struct Request {
+    std::chrono::steady_clock::time_point time;
+    std::chrono::steady_clock::duration latency;
+    bool success;
+  };
+
+  /** @brief Forget the requests which left the window, and update quality_. mutex_ must be held. */
+  void update(std::chrono::steady_clock::time_point now) const;
+
+  /** @brief Compute the statistics of requests_. mutex_ must be held. */
+  [[nodiscard]] Statistics computeStatistics() const;
+
+  mutable std::mutex mutex_;
+  LinkMonitorOptions options_;
+  mutable std::deque<Request> requests_;
+  mutable LinkQuality quality_{LinkQuality::kGood};
+  /** @brief Time since which a degraded link has looked good, if it has. */
+  mutable std::chrono::steady_clock::time_point good_since_;
+  mutable bool looks_good_{false};
+};
+
+/** @brief Read the thresholds of the link monitor from the parameters of a node. */
+[[nodiscard]] LinkMonitorOptions makeLinkMonitorOptions(const ParameterInterfaceBase& parameters);
+
+/**
+ * @brief Record a request in a monitor, if there is one.
+ *
+ * @param monitor Monitor of the robot, or nullptr.
+ * @param start Time at which the request was sent.
+ * @param success False if the request failed or timed out.
+ */
+inline void recordRequest(const std::shared_ptr<LinkMonitor>& monitor,
+                          const std::chrono::steady_clock::time_point start, const bool success) {
+  if (monitor) {
+    monitor->record(std::chrono::steady_clock::now() - start, success);
+  }
+}
+}  // namespace spot_ros2
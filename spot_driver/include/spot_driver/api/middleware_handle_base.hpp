@@ -2,7 +2,14 @@
 
 #pragma once
 
+#include <rclcpp/node.hpp>
 #include <rclcpp/qos.hpp>
+#include <spot_driver/interfaces/logger_interface_base.hpp>
+#include <spot_driver/interfaces/parameter_interface_base.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
 
 namespace spot_ros2 {
 
@@ -11,12 +18,34 @@ namespace spot_ros2 {
  */
 class MiddlewareHandleBase {
  public:
-  rclcpp::QoS makePublisherQoS(size_t const publisherHistoryDepth) const {
+  static rclcpp::QoS makePublisherQoS(size_t const publisherHistoryDepth) {
     // most compatible publisher durability: transient local
     // most compatible publisher reliabilty: reliable
     // see also
     // https://docs.ros.org/en/iron/Concepts/Intermediate/About-Quality-of-Service-Settings.html#qos-compatibilities
     return rclcpp::QoS(publisherHistoryDepth).transient_local().reliable();
   }
+
+  /**
+   * @brief Create the QoS profile for a publisher from user-configured QoS settings.
+   *
+   * @param publisherHistoryDepth History depth to use if the settings do not override it.
+   * @param parameters QoS settings for the category of topics the publisher belongs to.
+   * @return The QoS profile.
+   */
+  static rclcpp::QoS makePublisherQoS(size_t const publisherHistoryDepth, const PublisherQoSParameters& parameters);
+
+  /**
+   * @brief Create the QoS profile for a publisher from the `qos.<category>.*` parameters. If the parameters are
+   * invalid, log a warning and fall back to the default profile.
+   *
+   * @param parameters Parameter interface to read the QoS settings from.
+   * @param logger Logger for the warning about invalid settings.
+   * @param category Category of topics the publisher belongs to, e.g. "image" or "state".
+   * @param publisherHistoryDepth History depth to use if the parameters do not override it.
+   * @return The QoS profile.
+   */
+  static rclcpp::QoS makePublisherQoS(const ParameterInterfaceBase& parameters, const LoggerInterfaceBase& logger,
+                                      const std::string& category, size_t const publisherHistoryDepth);
 };
 }  // namespace spot_ros2
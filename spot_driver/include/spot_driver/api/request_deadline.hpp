@@ -0,0 +1,57 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <bosdyn/client/service_client/rpc_parameters.h>
+
+#include <chrono>
+#include <future>
+#include <string>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Time which a client waits for a request past its deadline. Spot's gRPC channel cancels the request at the
+ * deadline and resolves its future with an error, so the client only gives up on the future itself if that never
+ * happens, e.g. because the SDK thread which would resolve it is stuck.
+ */
+inline constexpr std::chrono::milliseconds kRequestDeadlineGrace{200};
+
+/**
+ * @brief Create the RPC parameters of a request with a deadline.
+ *
+ * @param timeout Time after which the request is cancelled. A value of zero or less keeps the default timeout of the
+ * Spot SDK.
+ * @return RPC parameters to pass to the request.
+ */
+inline ::bosdyn::client::RPCParameters makeRpcParameters(const std::chrono::duration<double> timeout) {
+  ::bosdyn::client::RPCParameters parameters;
+  if (timeout.count() > 0.0) {
+    parameters.timeout = std::chrono::duration_cast<::bosdyn::common::Duration>(timeout);
+  }
+  return parameters;
+}
+
+/**
+ * @brief Wait for the result of a request until its deadline has passed.
+ *
+ * @param future Future of the request.
+ * @param timeout Deadline of the request. A value of zero or less waits until the request finishes.
+ * @return True if the result is ready, or false if the request did not finish in time.
+ */
+template <typename Result>
+[[nodiscard]] bool waitForRequest(const std::shared_future<Result>& future,
+                                  const std::chrono::duration<double> timeout) {
+  if (timeout.count() <= 0.0) {
+    future.wait();
+    return true;
+  }
+  return future.wait_for(timeout + kRequestDeadlineGrace) == std::future_status::ready;
+}
+
+/** @brief Error message of a request which did not finish before its deadline. */
+inline std::string makeTimedOutMessage(const std::string& service, const std::chrono::duration<double> timeout) {
+  return "The " + service + " request timed out after " + std::to_string(timeout.count()) + " s.";
+}
+
+}  // namespace spot_ros2
@@ -6,25 +6,126 @@
 #include <spot_driver/types.hpp>
 #include <tl_expected/expected.hpp>
 
+#include <array>
+#include <cstddef>
+#include <optional>
 #include <set>
 #include <string>
+#include <string_view>
 
 namespace spot_ros2 {
+/** @brief Number of values of SpotCamera. */
+constexpr std::size_t kNumSpotCameras = 6;
+
+/** @brief Number of values of SpotImageType. */
+constexpr std::size_t kNumSpotImageTypes = 3;
+
+/** @brief Number of distinct ImageSources. */
+constexpr std::size_t kNumImageSources = kNumSpotCameras * kNumSpotImageTypes;
+
+/**
+ * @brief Get the dense index of an ImageSource, which is unique for each ImageSource and less than kNumImageSources.
+ * @details This allows keeping per-source data in a flat array instead of a map keyed by ImageSource or topic name.
+ *
+ * @param image_source Input image source.
+ * @return Dense index of the input image source.
+ */
+[[nodiscard]] constexpr std::size_t toImageSourceIndex(const ImageSource& image_source) {
+  return static_cast<std::size_t>(image_source.camera) * kNumSpotImageTypes +
+         static_cast<std::size_t>(image_source.type);
+}
+
+/** @brief Names of an ImageSource in the Spot API and in ROS. */
+struct ImageSourceInfo {
+  ImageSource source;
+  /** @brief Name of the image source in the Spot API. */
+  std::string_view api_name;
+  /** @brief ROS topic name of the image source, without the robot namespace. */
+  std::string_view topic;
+};
+
+/**
+ * @brief Every ImageSource with its names, in the order of toImageSourceIndex.
+ * @details The names are fixed, so they are looked up by index instead of being composed for every image. Note that
+ * the Spot API uses a different naming convention for the hand images than for the body images.
+ */
+inline constexpr std::array<ImageSourceInfo, kNumImageSources> kImageSourceRegistry{{
+    {{SpotCamera::BACK, SpotImageType::RGB}, "back_fisheye_image", "camera/back"},
+    {{SpotCamera::BACK, SpotImageType::DEPTH}, "back_depth", "depth/back"},
+    {{SpotCamera::BACK, SpotImageType::DEPTH_REGISTERED}, "back_depth_in_visual_frame", "depth_registered/back"},
+    {{SpotCamera::FRONTLEFT, SpotImageType::RGB}, "frontleft_fisheye_image", "camera/frontleft"},
+    {{SpotCamera::FRONTLEFT, SpotImageType::DEPTH}, "frontleft_depth", "depth/frontleft"},
+    {{SpotCamera::FRONTLEFT, SpotImageType::DEPTH_REGISTERED}, "frontleft_depth_in_visual_frame",
+     "depth_registered/frontleft"},
+    {{SpotCamera::FRONTRIGHT, SpotImageType::RGB}, "frontright_fisheye_image", "camera/frontright"},
+    {{SpotCamera::FRONTRIGHT, SpotImageType::DEPTH}, "frontright_depth", "depth/frontright"},
+    {{SpotCamera::FRONTRIGHT, SpotImageType::DEPTH_REGISTERED}, "frontright_depth_in_visual_frame",
+     "depth_registered/frontright"},
+    {{SpotCamera::LEFT, SpotImageType::RGB}, "left_fisheye_image", "camera/left"},
+    {{SpotCamera::LEFT, SpotImageType::DEPTH}, "left_depth", "depth/left"},
+    {{SpotCamera::LEFT, SpotImageType::DEPTH_REGISTERED}, "left_depth_in_visual_frame", "depth_registered/left"},
+    {{SpotCamera::RIGHT, SpotImageType::RGB}, "right_fisheye_image", "camera/right"},
+    {{SpotCamera::RIGHT, SpotImageType::DEPTH}, "right_depth", "depth/right"},
+    {{SpotCamera::RIGHT, SpotImageType::DEPTH_REGISTERED}, "right_depth_in_visual_frame", "depth_registered/right"},
+    {{SpotCamera::HAND, SpotImageType::RGB}, "hand_color_image", "camera/hand"},
+    {{SpotCamera::HAND, SpotImageType::DEPTH}, "hand_depth", "depth/hand"},
+    {{SpotCamera::HAND, SpotImageType::DEPTH_REGISTERED}, "hand_depth_in_hand_color_frame", "depth_registered/hand"},
+}};
+
+namespace detail {
+/** @brief Check that every entry of kImageSourceRegistry is stored at the index of its ImageSource. */
+constexpr bool isImageSourceRegistryIndexed() {
+  for (std::size_t index = 0; index < kImageSourceRegistry.size(); ++index) {
+    if (toImageSourceIndex(kImageSourceRegistry[index].source) != index) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace detail
+
+static_assert(detail::isImageSourceRegistryIndexed(), "kImageSourceRegistry must be ordered by toImageSourceIndex.");
+
+/**
+ * @brief Get the names of an ImageSource.
+ *
+ * @param image_source Input image source.
+ * @return Entry of the image source in kImageSourceRegistry.
+ */
+[[nodiscard]] constexpr const ImageSourceInfo& getImageSourceInfo(const ImageSource& image_source) {
+  return kImageSourceRegistry[toImageSourceIndex(image_source)];
+}
+
+/**
+ * @brief Find the ImageSource of a Spot SDK source name.
+ *
+ * @param source_name Input source name.
+ * @return The image source, or nullopt if the name does not match any known Spot SDK source.
+ */
+[[nodiscard]] constexpr std::optional<ImageSource> findImageSource(const std::string_view source_name) {
+  for (const auto& info : kImageSourceRegistry) {
+    if (info.api_name == source_name) {
+      return info.source;
+    }
+  }
+  return std::nullopt;
+}
+
 /**
- * @brief Create the ROS topic name corresponding to an ImageSource.
+ * @brief Get the ROS topic name corresponding to an ImageSource.
  *
  * @param image_source Input image source.
- * @return ROS topic name for the input image source.
+ * @return ROS topic name for the input image source. The string lives as long as the program.
  */
-[[nodiscard]] std::string toRosTopic(const ImageSource& image_source);
+[[nodiscard]] const std::string& toRosTopic(const ImageSource& image_source);
 
 /**
- * @brief Create the Spot SDK source name corresponding to an ImageSource.
+ * @brief Get the Spot SDK source name corresponding to an ImageSource.
  *
  * @param image_source Input image source.
- * @return Spot SDK source name for the input image source.
+ * @return Spot SDK source name for the input image source. The string lives as long as the program.
  */
-[[nodiscard]] std::string toSpotImageSourceName(const ImageSource& image_source);
+[[nodiscard]] const std::string& toSpotImageSourceName(const ImageSource& image_source);
 
 /**
  * @brief Create an ImageSource corresponding to a Spot SDK source name.
@@ -33,7 +134,7 @@ namespace spot_ros2 {
  * @return If the input source name was successfully parsed, return an ImageSource.
  * @return If the input source name does not match the expected name of any known Spot SDK source, return an error.
  */
-[[nodiscard]] tl::expected<ImageSource, std::string> fromSpotImageSourceName(const std::string& source_name);
+[[nodiscard]] tl::expected<ImageSource, std::string> fromSpotImageSourceName(std::string_view source_name);
 
 /**
  * @brief Create a set of image sources corresponding to the specified image types.
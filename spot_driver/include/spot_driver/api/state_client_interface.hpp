@@ -5,6 +5,7 @@
 #include <bosdyn/api/robot_state.pb.h>
 #include <tl_expected/expected.hpp>
 
+#include <chrono>
 #include <string>
 
 namespace spot_ros2 {
@@ -25,10 +26,12 @@ class StateClientInterface {
 
   /**
    * @brief Retrieve Spot's most recent robot state data.
+   * @param timeout Time after which the request is cancelled and an error is returned. A value of zero or less waits
+   * for as long as the Spot SDK does.
    * @return Returns an expected which contains a RobotState message if the request was completed successfully. If the
-   * request could not be completed, or if the response does not contain a RobotState message, return an error message
-   * describing the failure.
+   * request could not be completed in time, or if the response does not contain a RobotState message, return an error
+   * message describing the failure.
    */
-  virtual tl::expected<bosdyn::api::RobotState, std::string> getRobotState() = 0;
+  virtual tl::expected<bosdyn::api::RobotState, std::string> getRobotState(std::chrono::duration<double> timeout) = 0;
 };
 }  // namespace spot_ros2
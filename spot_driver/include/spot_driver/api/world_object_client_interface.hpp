@@ -4,8 +4,11 @@
 
 #include <bosdyn/api/world_object.pb.h>
 #include <bosdyn/client/world_objects/world_object_client.h>
+#include <chrono>
+#include <cstddef>
 #include <string>
 #include <tl_expected/expected.hpp>
+#include <vector>
 
 namespace spot_ros2 {
 
@@ -21,10 +24,43 @@ class WorldObjectClientInterface {
 
   virtual ~WorldObjectClientInterface() = default;
 
+  /**
+   * @brief List the world objects which match a request.
+   * @param request List request to send.
+   * @param timeout Time after which the request is cancelled and an error is returned. A value of zero or less waits
+   * for as long as the Spot SDK does.
+   * @return The response, or an error message if the request failed or did not finish in time.
+   */
   virtual tl::expected<::bosdyn::api::ListWorldObjectResponse, std::string> listWorldObjects(
-      ::bosdyn::api::ListWorldObjectRequest& request) const = 0;
+      ::bosdyn::api::ListWorldObjectRequest& request, std::chrono::duration<double> timeout) const = 0;
 
+  /**
+   * @brief Add, change or delete a world object.
+   * @param request Mutation request to send.
+   * @param timeout Time after which the request is cancelled and an error is returned. A value of zero or less waits
+   * for as long as the Spot SDK does.
+   * @return The response, or an error message if the request failed or did not finish in time.
+   */
   virtual tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string> mutateWorldObject(
-      ::bosdyn::api::MutateWorldObjectRequest& request) const = 0;
+      ::bosdyn::api::MutateWorldObjectRequest& request, std::chrono::duration<double> timeout) const = 0;
+
+  /**
+   * @brief Send several mutation requests, keeping up to max_requests_in_flight of them outstanding at once.
+   * @details The default implementation sends the requests one after the other through mutateWorldObject().
+   * @param requests Mutation requests to send.
+   * @param max_requests_in_flight Maximum number of requests which are outstanding with Spot at the same time.
+   * @param timeout Time after which each request is cancelled. A value of zero or less keeps the SDK's timeout.
+   * @return The result of every request, in the order of the requests.
+   */
+  virtual std::vector<tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>> mutateWorldObjects(
+      std::vector<::bosdyn::api::MutateWorldObjectRequest>& requests,
+      [[maybe_unused]] const std::size_t max_requests_in_flight, const std::chrono::duration<double> timeout) const {
+    std::vector<tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>> responses;
+    responses.reserve(requests.size());
+    for (auto& request : requests) {
+      responses.push_back(mutateWorldObject(request, timeout));
+    }
+    return responses;
+  }
 };
 }  // namespace spot_ros2
@@ -0,0 +1,44 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <sensor_msgs/msg/compressed_image.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <string>
+
+namespace spot_ros2 {
+
+/** @brief Lossless codecs which depth images can be compressed with, which compressed_depth_image_transport decodes. */
+enum class CompressedDepthFormat {
+  /** @brief PNG, which compresses best. */
+  PNG,
+  /** @brief Run-length and variable-length encoding, which is several times faster than PNG to encode. */
+  RVL,
+};
+
+/**
+ * @brief Convert the name of a compressed depth format to a CompressedDepthFormat.
+ *
+ * @param name Name of the format. Either "png" or "rvl".
+ * @return The matching CompressedDepthFormat, or an error message if the name is not recognized.
+ */
+tl::expected<CompressedDepthFormat, std::string> toCompressedDepthFormat(const std::string& name);
+
+/**
+ * @brief Compress a depth image into the format of compressed_depth_image_transport, so that it can be subscribed to
+ * through image_transport as `compressedDepth`.
+ * @details The data of the message starts with the configuration header of compressed_depth_image_transport, which is
+ * followed by the PNG or RVL payload. The depth values are compressed as they are, so no precision is lost.
+ *
+ * @param image Depth image with the encoding 16UC1 or mono16.
+ * @param format Codec to compress the depth image with.
+ * @param compressed Message to write the compressed image into. Its data buffer is reused.
+ * @return Nothing if the image was compressed, or an error message if its encoding is not supported or it could not be
+ * encoded.
+ */
+tl::expected<void, std::string> compressDepthImage(const sensor_msgs::msg::Image& image, CompressedDepthFormat format,
+                                                   sensor_msgs::msg::CompressedImage& compressed);
+
+}  // namespace spot_ros2
@@ -7,17 +7,83 @@
 #include <google/protobuf/duration.pb.h>
 #include <sensor_msgs/msg/image.hpp>
 #include <spot_driver/api/spot_image_sources.hpp>
+#include <spot_driver/conversions/jpeg_decoder.hpp>
 #include <std_msgs/msg/header.hpp>
 #include <string>
 #include <tl_expected/expected.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 namespace spot_ros2 {
 
 tl::expected<int, std::string> getCvPixelFormat(const bosdyn::api::Image_PixelFormat& format);
+
+/**
+ * @brief Decode run-length encoded image data into a preallocated buffer.
+ * @details Spot encodes FORMAT_RLE images as a sequence of runs, each made of a 1 byte run length followed by the value
+ * of the pixel that is repeated.
+ *
+ * @param data Run-length encoded image data.
+ * @param bytes_per_pixel Number of bytes used to store the value of each pixel.
+ * @param output Buffer to decode the image into. It must already be sized to hold the complete decoded image.
+ * @return Nothing if decoding succeeded, or an error message if the data does not match the size of the output buffer.
+ */
+tl::expected<void, std::string> decodeRunLengthEncoding(const std::string& data, const std::size_t bytes_per_pixel,
+                                                        std::vector<uint8_t>& output);
+
 std_msgs::msg::Header createImageHeader(const bosdyn::api::ImageCapture& image_capture, const std::string& robot_name,
                                         const google::protobuf::Duration& clock_skew);
+
+/**
+ * @brief Convert an image captured by Spot into an uncompressed ROS Image message.
+ *
+ * @param image_capture Image capture received from Spot.
+ * @param robot_name Name of the robot, used to prefix the frame ID.
+ * @param clock_skew Clock skew between the robot and the local system.
+ * @return The converted Image message, or an error message if the conversion failed.
+ */
 tl::expected<sensor_msgs::msg::Image, std::string> getDecompressImageMsg(const bosdyn::api::ImageCapture& image_capture,
                                                                          const std::string& robot_name,
                                                                          const google::protobuf::Duration& clock_skew);
 
+/**
+ * @brief Convert an image captured by Spot into a caller-supplied ROS Image message.
+ * @details Raw images are copied once from the protobuf buffer into the message, and JPEG images are decoded directly
+ * into the message's data buffer. If the message already holds a buffer of the right size, for example because it is
+ * reused between calls, no allocation is needed.
+ *
+ * @param image_capture Image capture received from Spot.
+ * @param robot_name Name of the robot, used to prefix the frame ID.
+ * @param clock_skew Clock skew between the robot and the local system.
+ * @param image_msg Image message to write the converted image into.
+ * @param jpeg_decoder Library to use to decode JPEG-compressed images.
+ * @param color_encoding Encoding to decode JPEG-compressed color images into. Greyscale images are always decoded into
+ * mono8.
+ * @return Nothing if the conversion succeeded, or an error message if it failed.
+ */
+tl::expected<void, std::string> getDecompressImageMsg(
+    const bosdyn::api::ImageCapture& image_capture, const std::string& robot_name,
+    const google::protobuf::Duration& clock_skew, sensor_msgs::msg::Image& image_msg,
+    const JpegDecoderBackend jpeg_decoder = JpegDecoderBackend::OPENCV,
+    const JpegOutputEncoding color_encoding = JpegOutputEncoding::BGR8);
+
+/**
+ * @brief Convert an image captured by Spot into a caller-supplied ROS Image message with a header that was already
+ * created for the image, such as the header of its CameraInfo.
+ *
+ * @param image_capture Image capture received from Spot.
+ * @param header Header of the image message.
+ * @param image_msg Image message to write the converted image into.
+ * @param jpeg_decoder Library to use to decode JPEG-compressed images.
+ * @param color_encoding Encoding to decode JPEG-compressed color images into. Greyscale images are always decoded into
+ * mono8.
+ * @return Nothing if the conversion succeeded, or an error message if it failed.
+ */
+tl::expected<void, std::string> getDecompressImageMsg(
+    const bosdyn::api::ImageCapture& image_capture, const std_msgs::msg::Header& header,
+    sensor_msgs::msg::Image& image_msg, const JpegDecoderBackend jpeg_decoder,
+    const JpegOutputEncoding color_encoding = JpegOutputEncoding::BGR8);
+
 }  // namespace spot_ros2
@@ -0,0 +1,59 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace spot_ros2 {
+
+/** @brief Options of the filter stage which derives a smaller, cleaned up depth image from a depth image. */
+struct DepthFilterOptions {
+  /**
+   * @brief Both sides of the depth image are divided by this factor. Every pixel of the filtered image keeps the
+   * nearest valid depth of its block, so that thin obstacles are not lost. A value of 1 keeps the resolution.
+   */
+  std::uint32_t decimation{2};
+
+  /** @brief If true, invalid pixels of the filtered image are filled with the median of the valid pixels nearby. */
+  bool fill_holes{true};
+
+  /** @brief Depths closer than this, in meters, are invalidated before the image is decimated. */
+  double min_range{0.0};
+
+  /**
+   * @brief Depths farther than this, in meters, are invalidated before the image is decimated. A value of zero or less
+   * keeps every depth.
+   */
+  double max_range{0.0};
+};
+
+/**
+ * @brief Filter a depth image into a smaller depth image for consumers such as obstacle detection.
+ * @details Depths outside of the range are invalidated first. The image is then decimated by keeping the nearest valid
+ * depth of every block of pixels, and the remaining invalid pixels are filled with the median of the valid pixels of
+ * their 3x3 neighborhood. Pixels at the right and bottom which do not fill a whole block are left out. The loops over
+ * the pixels are branchless, so that the compiler vectorizes them. The intrinsics in the filtered CameraInfo are
+ * adjusted to match the filtered image.
+ *
+ * @param depth_image Depth image with the encoding 16UC1 or mono16, in which a depth of 0 is invalid.
+ * @param info CameraInfo of the depth image.
+ * @param depth_scale Number of depth image units per meter.
+ * @param options Options of the filter.
+ * @param filtered_image Image message to write the filtered depth image into, with the encoding of the depth image.
+ * Its data buffer is reused.
+ * @param filtered_info CameraInfo message to write the intrinsics of the filtered depth image into.
+ * @return Nothing if the depth image was filtered, or an error message if its encoding is not supported or it is
+ * smaller than a block.
+ */
+tl::expected<void, std::string> filterDepthImage(const sensor_msgs::msg::Image& depth_image,
+                                                 const sensor_msgs::msg::CameraInfo& info, double depth_scale,
+                                                 const DepthFilterOptions& options,
+                                                 sensor_msgs::msg::Image& filtered_image,
+                                                 sensor_msgs::msg::CameraInfo& filtered_info);
+
+}  // namespace spot_ros2
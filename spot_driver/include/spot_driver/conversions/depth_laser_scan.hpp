@@ -0,0 +1,72 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <builtin_interfaces/msg/time.hpp>
+#include <geometry_msgs/msg/transform.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <sensor_msgs/msg/laser_scan.hpp>
+#include <spot_driver/conversions/depth_ray_table.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <string>
+
+namespace spot_ros2 {
+
+/** @brief Options that define the planar scan which is created from the depth images. */
+struct LaserScanOptions {
+  /** @brief Lowest height in meters above the body frame of the points which are part of the scan. */
+  double min_height{-0.3};
+  /** @brief Highest height in meters above the body frame of the points which are part of the scan. */
+  double max_height{0.3};
+  /** @brief Angle between the beams of the scan, in radians. The scan spans a full circle around the body frame. */
+  double angle_increment{0.00872665};
+  /** @brief Points closer to the body frame than this, in meters, are ignored, e.g. parts of the robot itself. */
+  double range_min{0.1};
+  /** @brief Points farther from the body frame than this, in meters, are ignored. */
+  double range_max{4.0};
+};
+
+/**
+ * @brief Reset a laser scan to a full circle of beams around a frame which have not seen anything yet.
+ * @details Every range is set to +inf, which means that no obstacle was seen along the beam.
+ *
+ * @param options Resolution and limits of the scan.
+ * @param frame_id Frame of the scan, e.g. the body frame of the robot.
+ * @param stamp Stamp of the scan.
+ * @param scan Laser scan to reset. Its ranges buffer is reused.
+ */
+void resetLaserScan(const LaserScanOptions& options, const std::string& frame_id,
+                    const builtin_interfaces::msg::Time& stamp, sensor_msgs::msg::LaserScan& scan);
+
+/**
+ * @brief Add the points of a depth image which lie in the height band of the scan to its beams.
+ * @details Every valid pixel is reprojected along its ray and transformed into the frame of the scan. If the point lies
+ * in the height band, the beam in its direction keeps the shorter of its range and the distance to the point, so the
+ * depth images of several cameras can be added to one scan.
+ *
+ * @param depth_image Depth image with the 16UC1 or mono16 encoding.
+ * @param rays Ray table of the camera, which must have the resolution of the depth image.
+ * @param depth_scale Number of depth image units per meter, such as 1000 for depth images in millimeters.
+ * @param scan_tform_camera Transform from the optical frame of the camera to the frame of the scan.
+ * @param options Height band and range limits of the scan.
+ * @param scan Laser scan which was reset by resetLaserScan() with the same options.
+ * @return Nothing if the depth image was added, or an error message if the depth image or ray table are invalid.
+ */
+tl::expected<void, std::string> addDepthImageToLaserScan(const sensor_msgs::msg::Image& depth_image,
+                                                         const DepthRayTable& rays, double depth_scale,
+                                                         const geometry_msgs::msg::Transform& scan_tform_camera,
+                                                         const LaserScanOptions& options,
+                                                         sensor_msgs::msg::LaserScan& scan);
+
+/**
+ * @brief Merge the beams of a laser scan into another one which has the same resolution, keeping the shorter ranges.
+ *
+ * @param scan Laser scan to merge.
+ * @param merged Laser scan to merge into.
+ * @return Nothing if the scans were merged, or an error message if they do not have the same number of beams.
+ */
+tl::expected<void, std::string> mergeLaserScans(const sensor_msgs::msg::LaserScan& scan,
+                                                sensor_msgs::msg::LaserScan& merged);
+
+}  // namespace spot_ros2
@@ -0,0 +1,88 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <spot_driver/conversions/depth_ray_table.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <string>
+
+namespace spot_ros2 {
+
+/** @brief Options that define how a point cloud is created from a depth image. */
+struct PointCloudOptions {
+  /**
+   * @brief Edge length of the voxels used to decimate the point cloud, in meters. Only the first point in each voxel is
+   * kept. A value of 0 keeps every valid point.
+   */
+  double voxel_size{0.0};
+
+  /**
+   * @brief If true, the point clouds of registered depth images are colored with the RGB image of the same camera,
+   * when that image is decoded from the same request. Registered depth images are aligned to the RGB camera on the
+   * robot, so each depth pixel directly maps to the color pixel at the same position.
+   */
+  bool colorize_registered{false};
+};
+
+/**
+ * @brief Create a point cloud by reprojecting every valid pixel of a depth image through its pinhole intrinsics.
+ * @details Pixels with a depth of zero are invalid and are skipped, so the point cloud is dense and unorganized. The
+ * point cloud has float32 x, y and z fields and is stamped in the optical frame of the depth image.
+ *
+ * @param depth_image Depth image with the 16UC1 or mono16 encoding.
+ * @param info CameraInfo of the depth image, which provides the intrinsics.
+ * @param depth_scale Number of depth image units per meter, such as 1000 for depth images in millimeters.
+ * @param options Decimation of the point cloud.
+ * @param cloud PointCloud2 message to write the points into.
+ * @return Nothing if the point cloud was created, or an error message if the depth image or intrinsics are invalid.
+ */
+tl::expected<void, std::string> createPointCloud(const sensor_msgs::msg::Image& depth_image,
+                                                 const sensor_msgs::msg::CameraInfo& info, double depth_scale,
+                                                 const PointCloudOptions& options,
+                                                 sensor_msgs::msg::PointCloud2& cloud);
+
+/**
+ * @brief Create a point cloud by reprojecting every valid pixel of a depth image along the rays of a precomputed table.
+ * @details This is the same as the overload that takes the intrinsics from the CameraInfo, but reuses a table that is
+ * kept for the camera, so that each frame only has to be reprojected.
+ *
+ * @param depth_image Depth image with the 16UC1 or mono16 encoding.
+ * @param info CameraInfo of the depth image, which provides the header of the point cloud.
+ * @param rays Ray table of the camera, which must have the resolution of the depth image.
+ * @param depth_scale Number of depth image units per meter, such as 1000 for depth images in millimeters.
+ * @param options Decimation of the point cloud.
+ * @param cloud PointCloud2 message to write the points into.
+ * @return Nothing if the point cloud was created, or an error message if the depth image or ray table are invalid.
+ */
+tl::expected<void, std::string> createPointCloud(const sensor_msgs::msg::Image& depth_image,
+                                                 const sensor_msgs::msg::CameraInfo& info, const DepthRayTable& rays,
+                                                 double depth_scale, const PointCloudOptions& options,
+                                                 sensor_msgs::msg::PointCloud2& cloud);
+
+/**
+ * @brief Create a point cloud with colors by reprojecting every valid pixel of a depth image which is registered to a
+ * color image, such as the DEPTH_REGISTERED images of Spot's cameras.
+ * @details The point cloud has float32 x, y and z fields and a float32 rgb field holding the packed 0x00RRGGBB color,
+ * which is the layout that PCL and RViz expect.
+ *
+ * @param depth_image Depth image with the 16UC1 or mono16 encoding.
+ * @param color_image Color image with the bgr8, rgb8 or mono8 encoding and the resolution of the depth image.
+ * @param info CameraInfo of the depth image, which provides the header of the point cloud.
+ * @param rays Ray table of the camera, which must have the resolution of the depth image.
+ * @param depth_scale Number of depth image units per meter, such as 1000 for depth images in millimeters.
+ * @param options Decimation of the point cloud.
+ * @param cloud PointCloud2 message to write the points into.
+ * @return Nothing if the point cloud was created, or an error message if the images or ray table are invalid.
+ */
+tl::expected<void, std::string> createColoredPointCloud(const sensor_msgs::msg::Image& depth_image,
+                                                        const sensor_msgs::msg::Image& color_image,
+                                                        const sensor_msgs::msg::CameraInfo& info,
+                                                        const DepthRayTable& rays, double depth_scale,
+                                                        const PointCloudOptions& options,
+                                                        sensor_msgs::msg::PointCloud2& cloud);
+
+}  // namespace spot_ros2
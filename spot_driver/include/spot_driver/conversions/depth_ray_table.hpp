@@ -0,0 +1,67 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <sensor_msgs/msg/camera_info.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Lookup table of the ray through every pixel of a pinhole camera.
+ * @details Each ray is scaled so that its z component is 1, so multiplying a ray by the depth of its pixel along the
+ * optical axis gives the 3D point of the pixel in the optical frame of the camera. The rays are stored as separate
+ * contiguous x and y arrays in row-major pixel order. Building the table is expensive compared to using it, so a table
+ * should be kept for each camera and only rebuilt when the resolution or intrinsics of the camera change.
+ */
+class DepthRayTable {
+ public:
+  /** @brief Create an empty table, which does not match any camera. */
+  DepthRayTable() = default;
+
+  /**
+   * @brief Create the table for a camera.
+   *
+   * @param info CameraInfo which provides the resolution and the intrinsics of the camera.
+   */
+  explicit DepthRayTable(const sensor_msgs::msg::CameraInfo& info);
+
+  /**
+   * @brief Check whether the table was built for the resolution and intrinsics in a CameraInfo message.
+   *
+   * @param info CameraInfo message to compare with.
+   * @return True if the table can be used for images described by the CameraInfo.
+   */
+  [[nodiscard]] bool matches(const sensor_msgs::msg::CameraInfo& info) const;
+
+  /**
+   * @brief Rebuild the table if it does not match a CameraInfo message.
+   *
+   * @param info CameraInfo which provides the resolution and the intrinsics of the camera.
+   * @return True if the table was rebuilt, or false if it already matched.
+   */
+  bool update(const sensor_msgs::msg::CameraInfo& info);
+
+  [[nodiscard]] std::uint32_t width() const { return width_; }
+  [[nodiscard]] std::uint32_t height() const { return height_; }
+
+  /** @brief X components of the rays, with width() * height() entries. */
+  [[nodiscard]] const std::vector<float>& x() const { return x_; }
+
+  /** @brief Y components of the rays, with width() * height() entries. */
+  [[nodiscard]] const std::vector<float>& y() const { return y_; }
+
+ private:
+  std::uint32_t width_{0};
+  std::uint32_t height_{0};
+  double fx_{0.0};
+  double fy_{0.0};
+  double cx_{0.0};
+  double cy_{0.0};
+  std::vector<float> x_;
+  std::vector<float> y_;
+};
+
+}  // namespace spot_ros2
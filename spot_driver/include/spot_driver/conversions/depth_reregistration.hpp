@@ -0,0 +1,94 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <sensor_msgs/msg/image.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Calibration of a depth camera and an RGB camera, in the layout of the calibration files which are written by
+ * the calibration tools of spot_wrapper.
+ */
+struct DepthReregistrationCalibration {
+  /** @brief Row-major 3x3 camera matrix of the depth camera. */
+  std::array<double, 9> camera_matrix_depth{};
+  /** @brief OpenCV distortion coefficients of the depth camera. They are only used if undistort is set. */
+  std::vector<double> dist_coeffs_depth;
+  /** @brief Row-major 3x3 camera matrix of the RGB camera. */
+  std::array<double, 9> camera_matrix_rgb{};
+  /** @brief Row-major rotation which takes points from the depth camera into the RGB camera. */
+  std::array<double, 9> depth_t_rgb_R{};
+  /** @brief Translation in meters which takes points from the depth camera into the RGB camera. */
+  std::array<double, 3> depth_t_rgb_T{};
+  /** @brief Resolution of the depth images, as height and width. */
+  std::array<std::uint32_t, 2> depth_image_dim{};
+  /** @brief Resolution of the RGB images, as height and width, which is also the resolution of the output. */
+  std::array<std::uint32_t, 2> rgb_image_dim{};
+  /** @brief If true, the lens distortion of the depth camera is removed from its rays. */
+  bool undistort{false};
+};
+
+/**
+ * @brief Re-registers depth images of one camera into the image plane of another one, such as the depth camera of the
+ * hand into its RGB camera.
+ * @details The mapping from the calibration is computed once: the ray through every depth pixel, undistorted if
+ * requested and rotated into the RGB camera. Re-registering an image then only scales each ray by the depth of its
+ * pixel, adds the translation and projects the point into the RGB image, where every pixel keeps the nearest point.
+ */
+class DepthReregistration {
+ public:
+  /**
+   * @brief Compute the mapping of a calibration.
+   *
+   * @param calibration Intrinsics, extrinsics and resolutions of the depth and RGB cameras.
+   * @param depth_scale Number of depth image units per meter, such as 1000 for depth images in millimeters.
+   * @return The re-registration, or an error message if the calibration is not valid.
+   */
+  static tl::expected<DepthReregistration, std::string> create(const DepthReregistrationCalibration& calibration,
+                                                               double depth_scale = 1000.0);
+
+  /**
+   * @brief Re-register a depth image into the RGB camera.
+   *
+   * @param depth_image Depth image with the 16UC1 or mono16 encoding and the resolution of the calibration.
+   * @param registered Depth image in the resolution of the RGB camera, in the units of the input. Pixels which no point
+   * projects into are zero. Its header is copied from the input, and its data buffer is reused.
+   * @return Nothing if the image was re-registered, or an error message if it does not match the calibration.
+   */
+  tl::expected<void, std::string> reregister(const sensor_msgs::msg::Image& depth_image,
+                                             sensor_msgs::msg::Image& registered) const;
+
+  [[nodiscard]] std::uint32_t depthWidth() const { return depth_width_; }
+  [[nodiscard]] std::uint32_t depthHeight() const { return depth_height_; }
+  [[nodiscard]] std::uint32_t rgbWidth() const { return rgb_width_; }
+  [[nodiscard]] std::uint32_t rgbHeight() const { return rgb_height_; }
+
+ private:
+  DepthReregistration() = default;
+
+  std::uint32_t depth_width_{0};
+  std::uint32_t depth_height_{0};
+  std::uint32_t rgb_width_{0};
+  std::uint32_t rgb_height_{0};
+  float fx_{0.0F};
+  float fy_{0.0F};
+  float cx_{0.0F};
+  float cy_{0.0F};
+  /** @brief Translation into the RGB camera, in depth image units. */
+  std::array<float, 3> translation_{};
+  /** @brief Largest depth in depth image units which is re-registered. */
+  float max_depth_{0.0F};
+  /** @brief Components of the rotated ray through every depth pixel, in row-major pixel order. */
+  std::vector<float> ray_x_;
+  std::vector<float> ray_y_;
+  std::vector<float> ray_z_;
+};
+
+}  // namespace spot_ros2
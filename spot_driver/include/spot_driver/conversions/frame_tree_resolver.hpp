@@ -0,0 +1,71 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <bosdyn/api/geometry.pb.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Resolves the transforms from one root frame to every frame of a FrameTreeSnapshot.
+ *
+ * Looking up a composed transform such as body_tform_hand in a snapshot walks the edges from both frames to the root of
+ * the tree, and every lookup repeats this walk. This class instead sorts the frames of a snapshot so that every parent
+ * comes before its children, and composes the transforms from the chosen root frame to every frame in one linear pass.
+ * Every lookup after compile() is then a single hash map access. The buffers are kept between calls to compile(), so
+ * resolving snapshots of the same frame tree reuses their memory.
+ */
+class FrameTreeResolver {
+ public:
+  /**
+   * @brief Compose the transforms from a root frame to every frame of a snapshot.
+   *
+   * @param snapshot Frame tree snapshot from Spot.
+   * @param root_frame Name of the frame from which the transforms are expressed, e.g. "body".
+   * @return False if the root frame is not in the snapshot or the snapshot contains a cycle, in which case no frame
+   * is resolved.
+   */
+  bool compile(const ::bosdyn::api::FrameTreeSnapshot& snapshot, std::string_view root_frame);
+
+  /**
+   * @brief Get the transform from the root frame to a frame, e.g. body_tform_hand for the root frame "body".
+   * @return The transform, or nullopt if the frame is not in the snapshot or not connected to the root frame.
+   */
+  [[nodiscard]] std::optional<::bosdyn::api::SE3Pose> rootTformFrame(std::string_view frame) const;
+
+  /** @brief Get the names of the frames of the last compiled snapshot, with every parent before its children. */
+  [[nodiscard]] std::vector<std::string_view> sortedFrames() const;
+
+ private:
+  /** @brief Get the index of a frame, adding it if it is not known yet. */
+  std::int32_t addFrame(const std::string& frame);
+
+  // Names of the frames of the snapshot, including parent frames which have no edge, and the index of every name.
+  // The vector is reserved before the names are added, so the keys of the map stay valid.
+  std::size_t frame_count_ = 0;
+  std::vector<std::string> frame_names_;
+  std::unordered_map<std::string_view, std::int32_t> index_of_frame_;
+  // Parent index of every frame or -1, and the transform from the parent, which is only valid during compile().
+  std::vector<std::int32_t> parents_;
+  std::vector<const ::bosdyn::api::SE3Pose*> parent_tform_frames_;
+
+  // Frames in topological order, and for every frame the root of its tree and the transform from that root.
+  std::vector<std::int32_t> order_;
+  std::vector<std::uint8_t> visit_states_;
+  std::vector<std::int32_t> path_;
+  std::vector<std::int32_t> tree_roots_;
+  std::vector<::bosdyn::api::SE3Pose> tree_root_tform_frames_;
+
+  // Transforms from the root frame, and whether every frame is connected to the root frame.
+  std::vector<::bosdyn::api::SE3Pose> root_tform_frames_;
+  std::vector<bool> resolved_;
+};
+}  // namespace spot_ros2
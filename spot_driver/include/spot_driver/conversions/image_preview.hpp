@@ -0,0 +1,47 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace spot_ros2 {
+
+/** @brief Options that define how a reduced preview image is derived from a full-resolution image. */
+struct ImagePreviewOptions {
+  /** @brief Both sides of the region of interest are divided by this factor. A value of 1 keeps the resolution. */
+  std::uint32_t scale_divisor{1};
+
+  /** @brief Region of interest of the full-resolution image, in pixels. A width or height of 0 keeps the whole image. */
+  std::uint32_t roi_x{0};
+  std::uint32_t roi_y{0};
+  std::uint32_t roi_width{0};
+  std::uint32_t roi_height{0};
+};
+
+/**
+ * @brief Create a preview image by cropping a full-resolution image to a region of interest and downscaling it.
+ * @details Color and greyscale images are downscaled by averaging pixel areas. Depth images are downscaled by picking
+ * the nearest pixel, so that invalid (zero) depth values are not averaged with valid ones. The intrinsics in the
+ * preview CameraInfo are adjusted to match the preview image.
+ *
+ * @param image Full-resolution image. Supported encodings are mono8, bgr8, rgb8, mono16, 16UC1 and nv12, of which only
+ * the luma plane is previewed in mono8.
+ * @param info CameraInfo of the full-resolution image.
+ * @param options Region of interest and scale of the preview.
+ * @param preview Image message to write the preview into.
+ * @param preview_info CameraInfo message to write the intrinsics of the preview into.
+ * @return Nothing if the preview was created, or an error message if the encoding is not supported or the region of
+ * interest does not fit inside the image.
+ */
+tl::expected<void, std::string> createImagePreview(const sensor_msgs::msg::Image& image,
+                                                   const sensor_msgs::msg::CameraInfo& info,
+                                                   const ImagePreviewOptions& options,
+                                                   sensor_msgs::msg::Image& preview,
+                                                   sensor_msgs::msg::CameraInfo& preview_info);
+
+}  // namespace spot_ros2
@@ -0,0 +1,126 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <sensor_msgs/msg/image.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <string>
+#include <string_view>
+
+namespace spot_ros2 {
+
+/** @brief Libraries which can be used to decode JPEG-compressed images. */
+enum class JpegDecoderBackend {
+  /** @brief Decode using cv::imdecode. Always available. */
+  OPENCV,
+  /** @brief Decode using the TurboJPEG API of libjpeg-turbo. Only available if it was found at build time. */
+  TURBOJPEG,
+};
+
+/** @brief Pixel layouts which JPEG images can be decoded into. */
+enum class JpegOutputEncoding {
+  /** @brief Three channels in blue, green, red order, which is the layout OpenCV works with. */
+  BGR8,
+  /** @brief Three channels in red, green, blue order, which is the layout most learning frameworks expect. */
+  RGB8,
+  /** @brief A single luma channel. Color images are decoded without any color conversion. */
+  MONO8,
+  /**
+   * @brief A luma plane followed by a plane of interleaved U and V samples at half the resolution, which is the input
+   * of most hardware video encoders. The image must have an even width and height.
+   */
+  NV12,
+};
+
+/**
+ * @brief Convert the name of a ROS image encoding to a JpegOutputEncoding.
+ *
+ * @param name Name of the encoding. Either "bgr8", "rgb8", "mono8" or "nv12".
+ * @return The matching JpegOutputEncoding, or an error message if JPEG images cannot be decoded into the encoding.
+ */
+tl::expected<JpegOutputEncoding, std::string> toJpegOutputEncoding(const std::string& name);
+
+/**
+ * @brief Get the name of the ROS image encoding of a JpegOutputEncoding.
+ *
+ * @param encoding Encoding to get the name of.
+ * @return The name of the encoding, as set in the encoding field of decoded Image messages.
+ */
+std::string toImageEncodingName(const JpegOutputEncoding encoding);
+
+/**
+ * @brief Convert the name of a JPEG decoder backend to a JpegDecoderBackend.
+ *
+ * @param name Name of the backend. Either "opencv" or "turbojpeg".
+ * @return The matching JpegDecoderBackend, or an error message if the name is not recognized.
+ */
+tl::expected<JpegDecoderBackend, std::string> toJpegDecoderBackend(const std::string& name);
+
+/**
+ * @brief Check if a JPEG decoder backend was compiled into the driver.
+ *
+ * @param backend Backend to check.
+ * @return True if the backend can be used, false if decoding will fall back to OpenCV.
+ */
+bool isJpegDecoderBackendAvailable(const JpegDecoderBackend backend);
+
+/**
+ * @brief Decode a JPEG-compressed image into a caller-supplied ROS Image message.
+ * @details The image is decoded directly into the message's data buffer, and the height, width, step, and encoding of
+ * the message are set to match the decoded image. The header of the message is left unchanged. If the requested
+ * backend is not available, OpenCV is used instead.
+ *
+ * @param data JPEG-compressed image data.
+ * @param greyscale If true, decode into a mono8 image. If false, decode into a bgr8 image.
+ * @param backend Library to use to decode the image.
+ * @param image_msg Image message to write the decoded image into.
+ * @return Nothing if decoding succeeded, or an error message if it failed.
+ */
+tl::expected<void, std::string> decodeJpeg(const std::string& data, const bool greyscale,
+                                           const JpegDecoderBackend backend, sensor_msgs::msg::Image& image_msg);
+
+/**
+ * @brief Decode a JPEG-compressed image at a reduced resolution into a caller-supplied ROS Image message.
+ * @details Both backends scale the image in the DCT domain while decoding, which is much cheaper than decoding the full
+ * image and resizing it. The decoded image has the dimensions of the original image divided by the scale denominator
+ * and rounded up.
+ *
+ * @param data JPEG-compressed image data.
+ * @param greyscale If true, decode into a mono8 image. If false, decode into a bgr8 image.
+ * @param scale_denominator Factor to divide the resolution of the image by. Must be 1, 2, 4 or 8.
+ * @param backend Library to use to decode the image.
+ * @param image_msg Image message to write the decoded image into.
+ * @return Nothing if decoding succeeded, or an error message if it failed.
+ */
+tl::expected<void, std::string> decodeJpeg(const std::string_view data, const bool greyscale,
+                                           const int scale_denominator, const JpegDecoderBackend backend,
+                                           sensor_msgs::msg::Image& image_msg);
+
+/**
+ * @brief Decode a JPEG-compressed image into a caller-supplied ROS Image message with the given encoding.
+ * @details The backend decodes into the encoding itself wherever it can, so that consumers of the image do not need a
+ * color conversion pass of their own. TurboJPEG decodes into every encoding directly, and into NV12 from the YUV planes
+ * of the JPEG without any color conversion if its chroma is subsampled by 2 in both directions. OpenCV decodes into
+ * bgr8 and converts to rgb8 or NV12 afterwards.
+ *
+ * @param data JPEG-compressed image data.
+ * @param output_encoding Encoding to decode the image into.
+ * @param scale_denominator Factor to divide the resolution of the image by. Must be 1, 2, 4 or 8.
+ * @param backend Library to use to decode the image.
+ * @param image_msg Image message to write the decoded image into.
+ * @return Nothing if decoding succeeded, or an error message if it failed.
+ */
+tl::expected<void, std::string> decodeJpeg(const std::string_view data, const JpegOutputEncoding output_encoding,
+                                           const int scale_denominator, const JpegDecoderBackend backend,
+                                           sensor_msgs::msg::Image& image_msg);
+
+/**
+ * @brief Check if a JPEG-compressed image has a single color component.
+ *
+ * @param data JPEG-compressed image data.
+ * @return True if the image is greyscale, false if it has color, or an error message if the header cannot be read.
+ */
+tl::expected<bool, std::string> isGreyscaleJpeg(const std::string_view data);
+
+}  // namespace spot_ros2
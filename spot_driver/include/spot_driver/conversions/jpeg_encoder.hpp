@@ -0,0 +1,42 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <sensor_msgs/msg/compressed_image.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/conversions/jpeg_decoder.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <string>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Get the format of a JPEG CompressedImage message in the form used by compressed_image_transport, e.g.
+ * "mono8; jpeg compressed mono8".
+ * @details The format names the encoding of the image before it was compressed and the color format of the JPEG data,
+ * which lets decoders of greyscale images take the single channel path instead of decoding to bgr8.
+ *
+ * @param encoding Encoding of the image before it was compressed. Must be mono8, bgr8 or rgb8.
+ * @return The format, or "jpeg" for other encodings.
+ */
+std::string getJpegCompressedFormat(const std::string& encoding);
+
+/**
+ * @brief Encode a mono8, bgr8 or rgb8 ROS Image message into a caller-supplied JPEG CompressedImage message.
+ * @details The data buffer of the compressed message is reused, so encoding images of the same size into the same
+ * message does not allocate once the buffer has grown to fit them. The header of the compressed message is copied from
+ * the image, and its format is set by getJpegCompressedFormat(). If the requested backend is not available, OpenCV is
+ * used instead.
+ *
+ * @param image Image to encode.
+ * @param quality JPEG quality from 1 to 100.
+ * @param backend Library to use to encode the image, which are the same as those to decode images with.
+ * @param compressed_msg CompressedImage message to write the JPEG data into.
+ * @return Nothing if encoding succeeded, or an error message if it failed.
+ */
+tl::expected<void, std::string> encodeJpeg(const sensor_msgs::msg::Image& image, const int quality,
+                                           const JpegDecoderBackend backend,
+                                           sensor_msgs::msg::CompressedImage& compressed_msg);
+
+}  // namespace spot_ros2
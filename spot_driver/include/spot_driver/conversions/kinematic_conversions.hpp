@@ -7,6 +7,9 @@
 #include <bosdyn_spot_api_msgs/msg/inverse_kinematics_request.hpp>
 #include <bosdyn_spot_api_msgs/msg/inverse_kinematics_response.hpp>
 
+#include <cstdint>
+#include <vector>
+
 namespace spot_ros2 {
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -52,6 +55,16 @@ void convertToRos(const bosdyn::api::FrameTreeSnapshot::ParentEdge& proto,
 
 void convertToRos(const bosdyn::api::FrameTreeSnapshot& proto, bosdyn_api_msgs::msg::FrameTreeSnapshot& ros_msg);
 
+/**
+ * Convert a frame tree snapshot like the overload above, and also compute the parent of every edge as an index.
+ *
+ * parent_indices[i] is the index in ros_msg.child_to_parent_edge_map of the edge whose child is the parent frame of
+ * edge i, or -1 if that frame is a root frame or is not in the snapshot. Consumers which walk the tree often can follow
+ * these indices instead of looking up frame names.
+ */
+void convertToRos(const bosdyn::api::FrameTreeSnapshot& proto, bosdyn_api_msgs::msg::FrameTreeSnapshot& ros_msg,
+                  std::vector<std::int32_t>& parent_indices);
+
 void convertToRos(const bosdyn::api::KinematicState& proto, bosdyn_api_msgs::msg::KinematicState& ros_msg);
 
 void convertToRos(const bosdyn::api::spot::InverseKinematicsResponse& proto,
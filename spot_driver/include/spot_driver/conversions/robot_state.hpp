@@ -23,6 +23,9 @@
 #include <spot_msgs/msg/wi_fi_state.hpp>
 #include <string>
 #include <tf2_msgs/msg/tf_message.hpp>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace spot_ros2 {
 
@@ -91,6 +94,41 @@ std::optional<sensor_msgs::msg::JointState> getJointStates(const ::bosdyn::api::
                                                            const google::protobuf::Duration& clock_skew,
                                                            const std::string& prefix);
 
+/**
+ * @brief Converts the joint states of robot states to a JointState like getJointStates, but builds the prefixed joint
+ * names once and then only overwrites the values, so that converting robot states with the same joints does not
+ * allocate.
+ */
+class JointStateConverter {
+ public:
+  /**
+   * @brief Constructor for JointStateConverter.
+   *
+   * @param prefix The prefix to apply to all robot joint names. This corresponds to the name of the robot. It is
+   * expected to terminate with `/`.
+   */
+  explicit JointStateConverter(std::string prefix);
+
+  /**
+   * @brief Write the joint states of a robot state into a JointState message.
+   *
+   * @param robot_state Robot state message from Spot.
+   * @param clock_skew The clock skew reported by Spot at the timepoint when the robot state was created.
+   * @param joint_states Message to write to. Its names are only assigned if they differ from the joints of the robot
+   * state, so that passing the same message on every call reuses all of its buffers.
+   * @return False if the robot state message contains no kinematic state, in which case the message is left unchanged.
+   */
+  bool convert(const ::bosdyn::api::RobotState& robot_state, const google::protobuf::Duration& clock_skew,
+               sensor_msgs::msg::JointState& joint_states);
+
+ private:
+  std::string prefix_;
+  /** @brief Joint names of the last robot state in the Spot API, which invalidate names_ if they change. */
+  std::vector<std::string> api_names_;
+  /** @brief Prefixed joint names of the last robot state in the driver and URDF. */
+  std::vector<std::string> names_;
+};
+
 /**
  * @brief Create a ROS TFMessage by parsing a RobotState message.
  *
@@ -125,6 +163,64 @@ std::optional<tf2_msgs::msg::TFMessage> getTf(const ::bosdyn::api::FrameTreeSnap
                                               const google::protobuf::Duration& clock_skew, const std::string& prefix,
                                               const std::string& preferred_base_frame_id,
                                               const std::set<std::string, std::less<>>& frames_to_ignore = {});
+
+/**
+ * @brief Converts FrameTreeSnapshots to a TFMessage like getTf, but keeps the prefixed frame names and the output
+ * message between calls, so that converting snapshots of the same frame tree does not allocate.
+ */
+class FrameTreeConverter {
+ public:
+  /**
+   * @brief Constructor for FrameTreeConverter.
+   *
+   * @param prefix The prefix to apply to all robot frame IDs. This corresponds to the name of the robot. It is expected
+   * to terminate with `/`.
+   * @param preferred_base_frame_id Frame ID to use as the base frame of the TF tree.
+   * @param frames_to_ignore Set of frames to not include in the TF tree, defaults to an empty set.
+   */
+  FrameTreeConverter(std::string prefix, std::string preferred_base_frame_id,
+                     std::set<std::string, std::less<>> frames_to_ignore = {});
+
+  /**
+   * @brief Convert a frame tree snapshot, overwriting the transforms of the previous call in place.
+   *
+   * @param frame_tree_snapshot Frame tree snapshot from Spot.
+   * @param timestamp_robot The robot-relative timestamp to use when assigning timestamps to the headers of the output
+   * transform messages.
+   * @param clock_skew The clock skew reported by Spot at the timepoint when the robot state was created.
+   * @return False if the frame tree snapshot has no entries, in which case the message is left unchanged.
+   */
+  bool convert(const ::bosdyn::api::FrameTreeSnapshot& frame_tree_snapshot,
+               const google::protobuf::Timestamp& timestamp_robot, const google::protobuf::Duration& clock_skew);
+
+  /** @brief Get the message of the last successful call to convert(). */
+  [[nodiscard]] const tf2_msgs::msg::TFMessage& message() const { return tf_msg_; }
+
+  /** @brief Take the message of the last successful call to convert(), after which its buffers are no longer reused. */
+  [[nodiscard]] tf2_msgs::msg::TFMessage takeMessage() { return std::move(tf_msg_); }
+
+ private:
+  /** @brief ROS frame names of one edge of the frame tree, which are computed the first time the edge is seen. */
+  struct Edge {
+    /** @brief Parent frame name in the snapshot, which invalidates the entry if it changes. */
+    std::string snapshot_parent_frame_name;
+    std::string parent_frame_name;
+    std::string frame_name;
+    /** @brief True if the edge is not published, e.g. because its frame is ignored or is a root frame. */
+    bool skip;
+    /** @brief True if the child frame is the preferred base frame, so that the edge is published inverted. */
+    bool is_base_frame;
+  };
+
+  /** @brief Get the edge of a frame, creating or updating it if its parent frame changed. */
+  const Edge& getEdge(const std::string& frame_id, const std::string& snapshot_parent_frame_name);
+
+  std::string prefix_;
+  std::string preferred_base_frame_id_;
+  std::set<std::string, std::less<>> frames_to_ignore_;
+  std::unordered_map<std::string, Edge> edges_;
+  tf2_msgs::msg::TFMessage tf_msg_;
+};
 /**
  * @brief Create an TwistWithCovarianceStamped ROS message representing Spot's body velocity by parsing a RobotState
  * message.
@@ -6,7 +6,77 @@
 #include <google/protobuf/timestamp.pb.h>
 #include <builtin_interfaces/msg/time.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
 namespace spot_ros2 {
+/** @brief Return a protobuf timestamp as nanoseconds since the epoch. */
+std::int64_t toNanoseconds(const google::protobuf::Timestamp& timestamp);
+
+/** @brief Return a protobuf duration as nanoseconds. */
+std::int64_t toNanoseconds(const google::protobuf::Duration& duration);
+
+/** @brief Return a ROS time as nanoseconds since the epoch. */
+std::int64_t toNanoseconds(const builtin_interfaces::msg::Time& time);
+
+/** @brief Return a ROS time from nanoseconds since the epoch, which must not be negative. */
+builtin_interfaces::msg::Time toRosTime(std::int64_t nanoseconds);
+
+/** @brief Return a protobuf timestamp from nanoseconds since the epoch, which must not be negative. */
+google::protobuf::Timestamp toProtoTimestamp(std::int64_t nanoseconds);
+
+/**
+ * @brief Convert a timestamp in nanoseconds relative to Spot's onboard clock into nanoseconds relative to the host's
+ * clock, without splitting it into seconds and nanoseconds.
+ *
+ * @param timestamp_robot Timestamp relative to Spot's clock, in nanoseconds since the epoch.
+ * @param clock_skew The difference as measured by Spot between the host's clock and Spot's onboard clock, in
+ * nanoseconds.
+ * @return Timestamp relative to the host's clock, or 0 if it would be earlier than the epoch.
+ */
+inline std::int64_t robotTimeToLocalTime(const std::int64_t timestamp_robot, const std::int64_t clock_skew) {
+  return std::max<std::int64_t>(timestamp_robot - clock_skew, 0);
+}
+
+/**
+ * @brief Convert a timestamp in nanoseconds relative to the host's clock into nanoseconds relative to Spot's onboard
+ * clock, without splitting it into seconds and nanoseconds.
+ *
+ * @param timestamp_local Timestamp relative to the host's clock, in nanoseconds since the epoch.
+ * @param clock_skew The difference as measured by Spot between the host's clock and Spot's onboard clock, in
+ * nanoseconds.
+ * @return Timestamp relative to Spot's clock, or 0 if it would be earlier than the epoch.
+ */
+inline std::int64_t localTimeToRobotTime(const std::int64_t timestamp_local, const std::int64_t clock_skew) {
+  return std::max<std::int64_t>(timestamp_local + clock_skew, 0);
+}
+
+/**
+ * @brief Convert contiguous timestamps in nanoseconds relative to Spot's onboard clock into nanoseconds relative to the
+ * host's clock. The loop has no branches, so the compiler can vectorize it.
+ *
+ * @param timestamps_robot Timestamps relative to Spot's clock.
+ * @param count Number of timestamps.
+ * @param clock_skew The difference as measured by Spot between the host's clock and Spot's onboard clock, in
+ * nanoseconds.
+ * @param timestamps_local Output array of count timestamps relative to the host's clock. It may be timestamps_robot.
+ */
+void robotTimesToLocalTimes(const std::int64_t* timestamps_robot, std::size_t count, std::int64_t clock_skew,
+                            std::int64_t* timestamps_local);
+
+/**
+ * @brief Convert contiguous timestamps in nanoseconds relative to the host's clock into nanoseconds relative to Spot's
+ * onboard clock. The loop has no branches, so the compiler can vectorize it.
+ *
+ * @param timestamps_local Timestamps relative to the host's clock.
+ * @param count Number of timestamps.
+ * @param clock_skew The difference as measured by Spot between the host's clock and Spot's onboard clock, in
+ * nanoseconds.
+ * @param timestamps_robot Output array of count timestamps relative to Spot's clock. It may be timestamps_local.
+ */
+void localTimesToRobotTimes(const std::int64_t* timestamps_local, std::size_t count, std::int64_t clock_skew,
+                            std::int64_t* timestamps_robot);
 /**
  * @brief Convert a timestamp that was reported relative to Spot's onboard clock into a timestamp relative to the host's
  * clock.
@@ -0,0 +1,116 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_msgs/msg/compressed_video.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spot_ros2 {
+
+/** @brief Codecs which images can be encoded into. */
+enum class VideoCodec {
+  H264,
+  H265,
+};
+
+/** @brief Encoders which can be used to encode video. */
+enum class VideoEncoderBackend {
+  /** @brief Use the first available of NVENC, VAAPI and the software encoder. */
+  AUTO,
+  /** @brief Encode on an NVIDIA GPU, e.g. the one of a Jetson. */
+  NVENC,
+  /** @brief Encode on a GPU which supports VA-API, e.g. an Intel or AMD GPU. */
+  VAAPI,
+  /** @brief Encode on the CPU with x264 or x265. */
+  SOFTWARE,
+};
+
+/**
+ * @brief Convert the name of a codec to a VideoCodec.
+ *
+ * @param name Name of the codec. Either "h264" or "h265".
+ * @return The matching VideoCodec, or an error message if the name is not recognized.
+ */
+tl::expected<VideoCodec, std::string> toVideoCodec(const std::string& name);
+
+/**
+ * @brief Convert the name of a video encoder backend to a VideoEncoderBackend.
+ *
+ * @param name Name of the backend. One of "auto", "nvenc", "vaapi" or "software".
+ * @return The matching VideoEncoderBackend, or an error message if the name is not recognized.
+ */
+tl::expected<VideoEncoderBackend, std::string> toVideoEncoderBackend(const std::string& name);
+
+/** @brief Check if FFmpeg was found at build time, without which no video can be encoded. */
+bool isVideoEncodingAvailable();
+
+/** @brief Options of a VideoEncoder. */
+struct VideoEncoderOptions {
+  VideoCodec codec{VideoCodec::H264};
+  VideoEncoderBackend backend{VideoEncoderBackend::AUTO};
+  /** @brief Target bit rate of the stream in bits per second. */
+  std::int64_t bit_rate{1000000};
+  /** @brief Nominal frame rate of the stream, which the rate control of the encoder is based on. */
+  int frame_rate{15};
+  /** @brief Number of frames from one keyframe to the next. Longer intervals need less bandwidth. */
+  int keyframe_interval{30};
+};
+
+/**
+ * @brief Encodes images of one camera into a video stream with FFmpeg.
+ * @details The encoder is configured for low latency: it does not use B-frames, so every image yields its encoded frame
+ * right away. Images are converted to YUV 4:2:0 before they are encoded, and must all have the size that the encoder
+ * was created for.
+ */
+class VideoEncoder {
+ public:
+  /** @brief State of the FFmpeg encoder. It is opaque, so that this header does not depend on FFmpeg. */
+  struct Impl;
+
+  /**
+   * @brief Open an encoder for images of the given size.
+   *
+   * @param options Codec, backend and rate control of the stream.
+   * @param width Width of the images in pixels.
+   * @param height Height of the images in pixels.
+   * @return The encoder, or an error message if none of the requested backends could be opened.
+   */
+  static tl::expected<std::unique_ptr<VideoEncoder>, std::string> create(const VideoEncoderOptions& options, int width,
+                                                                         int height);
+
+  ~VideoEncoder();
+
+  VideoEncoder(const VideoEncoder&) = delete;
+  VideoEncoder& operator=(const VideoEncoder&) = delete;
+
+  /**
+   * @brief Encode an image.
+   *
+   * @param image Image to encode, with the encoding mono8, bgr8, rgb8, bgra8 or rgba8.
+   * @return The frames which the encoder produced, stamped with the headers of their images, or an error message if the
+   * image could not be encoded.
+   */
+  tl::expected<std::vector<spot_msgs::msg::CompressedVideo>, std::string> encode(const sensor_msgs::msg::Image& image);
+
+  /** @brief Make the next encoded frame a keyframe, e.g. so that a new subscriber can start decoding right away. */
+  void requestKeyframe();
+
+  /** @brief Get the name of the FFmpeg encoder which is used, e.g. `h264_nvenc`. */
+  [[nodiscard]] const std::string& encoderName() const;
+
+  [[nodiscard]] int width() const;
+  [[nodiscard]] int height() const;
+
+ private:
+  explicit VideoEncoder(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace spot_ros2
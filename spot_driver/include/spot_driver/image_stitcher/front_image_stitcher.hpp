@@ -0,0 +1,94 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <geometry_msgs/msg/transform.hpp>
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <opencv2/core/matx.hpp>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/image_stitcher/image_stitcher.hpp>
+#include <spot_driver/types.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace spot_ros2 {
+
+/** @brief Virtual camera and blending options of a FrontImageStitcher, which match the parameters of ImageStitcher. */
+struct FrontImageStitcherOptions {
+  /** @brief Frame of the body, which is the parent frame of the virtual camera. */
+  std::string body_frame;
+  /** @brief Frame of the virtual camera, which the stitched images are published in. */
+  std::string camera_frame;
+  cv::Matx33d intrinsics{cv::Matx33d::eye()};
+  /** @brief Normal of the plane which the images are projected onto, in the frame of the virtual camera. */
+  cv::Vec3d plane_normal{0.0, 0.0, 1.0};
+  /** @brief Distance from the virtual camera to the projection plane, in meters. */
+  double plane_distance{1.0};
+  /** @brief Number of rows which the stitched image has in addition to the rows of the left image. */
+  int row_padding{0};
+  int seam_update_period{1};
+  StitchBlendMode blend_mode{StitchBlendMode::kMultiBand};
+  int blend_width{50};
+  bool use_gpu{true};
+};
+
+/**
+ * @brief Stitches the decoded frontleft and frontright images of one image response into the image of a virtual camera
+ * between them, with the same pipeline as ImageStitcher.
+ * @details Unlike ImageStitcher, this is fed with the images of both cameras straight from the response that they were
+ * requested in, so the images neither have to be published and subscribed to nor be paired up again by their stamps.
+ * The transforms from the body frame to both cameras are taken from the response as well, instead of from TF.
+ */
+class FrontImageStitcher {
+ public:
+  explicit FrontImageStitcher(const FrontImageStitcherOptions& options);
+  ~FrontImageStitcher();
+
+  /**
+   * @brief Set the transforms from the body frame to the left and right cameras, which are needed before the first
+   * images can be stitched. The cameras are rigidly mounted, so the transforms are only used when the camera is built.
+   */
+  void setCameraTransforms(const geometry_msgs::msg::Transform& body_tform_left,
+                           const geometry_msgs::msg::Transform& body_tform_right);
+
+  /** @brief Check if the camera transforms were set. */
+  [[nodiscard]] bool hasCameraTransforms() const;
+
+  /**
+   * @brief Stitch the left and right images of one response.
+   * @details The stitching camera is built on the first call, and rebuilt if the resolution or the intrinsics of either
+   * image change. The stitched image and its CameraInfo are reused between calls, so they are only valid until the
+   * next call.
+   *
+   * @param left Decoded image and CameraInfo of the left camera, which is frontleft.
+   * @param right Decoded image and CameraInfo of the right camera, which is frontright.
+   * @return Nothing if the images were stitched, or an error message if the camera transforms were not set yet.
+   */
+  tl::expected<void, std::string> stitch(const ImageWithCameraInfo& left, const ImageWithCameraInfo& right);
+
+  /** @brief Last stitched image. Only valid after stitch() succeeded. */
+  [[nodiscard]] const sensor_msgs::msg::Image& image() const { return *image_; }
+
+  /** @brief CameraInfo of the last stitched image. Only valid after stitch() succeeded. */
+  [[nodiscard]] const sensor_msgs::msg::CameraInfo& info() const { return info_; }
+
+  /** @brief Transform from the body frame to the virtual camera, once the first images were stitched. */
+  [[nodiscard]] std::optional<geometry_msgs::msg::TransformStamped> getVirtualCameraTransform() const;
+
+ private:
+  FrontImageStitcherOptions options_;
+  std::optional<geometry_msgs::msg::Transform> body_tform_left_;
+  std::optional<geometry_msgs::msg::Transform> body_tform_right_;
+  std::unique_ptr<MiddleCamera> camera_;
+  /** @brief CameraInfos which camera_ was built for, to rebuild it when they change. */
+  sensor_msgs::msg::CameraInfo camera_info_left_;
+  sensor_msgs::msg::CameraInfo camera_info_right_;
+  sensor_msgs::msg::Image* image_{nullptr};
+  sensor_msgs::msg::CameraInfo info_;
+};
+
+}  // namespace spot_ros2
@@ -5,8 +5,14 @@
 #include <message_filters/subscriber.h>
 #include <message_filters/sync_policies/approximate_time.h>
 #include <message_filters/synchronizer.h>
+#include <chrono>
+#include <cstddef>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <diagnostic_msgs/msg/diagnostic_status.hpp>
+#include <atomic>
 #include <eigen3/Eigen/Dense>
 #include <functional>
+#include <future>
 #include <image_transport/camera_publisher.hpp>
 #include <image_transport/image_transport.hpp>
 #include <image_transport/subscriber.hpp>
@@ -19,14 +25,23 @@
 #include <opencv2/stitching/detail/exposure_compensate.hpp>
 #include <opencv2/stitching/detail/seam_finders.hpp>
 #include <optional>
+#include <rclcpp/clock.hpp>
 #include <rclcpp/node_interfaces/node_base_interface.hpp>
 #include <rclcpp/node_options.hpp>
+#include <rclcpp/parameter.hpp>
+#include <rclcpp/parameter_event_handler.hpp>
+#include <rclcpp/publisher.hpp>
 #include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/compressed_image.hpp>
 #include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/conversions/jpeg_decoder.hpp>
+#include <spot_driver/images/image_latency_statistics.hpp>
 #include <spot_driver/interfaces/logger_interface_base.hpp>
 #include <spot_driver/interfaces/rclcpp_tf_broadcaster_interface.hpp>
+#include <spot_driver/interfaces/thread_pool_interface_base.hpp>
 #include <spot_driver/interfaces/tf_listener_interface_base.hpp>
 #include <string>
+#include <tl_expected/expected.hpp>
 #include <utility>
 #include <vector>
 
@@ -44,6 +59,7 @@ virtual camera intrinsics
     -p virtual_camera_projection_plane:="[-0.15916, 0., 0.987253]" \
     -p virtual_camera_plane_distance:=0.5 \
     -p stitched_image_row_padding:=1182 \
+    -p stitched_image_seam_update_period:=30 \
     --remap virtual_camera/image:=/Lionel/camera/frontmiddle_virtual/image \
     --remap left/image:=/Lionel/camera/frontleft/image \
     --remap left/camera_info:=/Lionel/camera/frontleft/camera_info \
@@ -52,37 +68,116 @@ virtual camera intrinsics
  */
 namespace spot_ros2 {
 using Image = sensor_msgs::msg::Image;
+using CompressedImage = sensor_msgs::msg::CompressedImage;
 using CameraInfo = sensor_msgs::msg::CameraInfo;
 using Transform = geometry_msgs::msg::Transform;
 using Time = builtin_interfaces::msg::Time;
 using DualImageCallbackFn =
     std::function<void(const std::shared_ptr<const Image>&, const std::shared_ptr<const CameraInfo>&,
                        const std::shared_ptr<const Image>&, const std::shared_ptr<const CameraInfo>&)>;
+using DualCompressedImageCallbackFn =
+    std::function<void(const std::shared_ptr<const CompressedImage>&, const std::shared_ptr<const CameraInfo>&,
+                       const std::shared_ptr<const CompressedImage>&, const std::shared_ptr<const CameraInfo>&)>;
+
+/** @brief Method used to blend the two warped images along their seam. */
+enum class StitchBlendMode {
+  /** @brief Blend with Laplacian pyramids, which gives the smoothest transition at the highest cost. */
+  kMultiBand,
+  /** @brief Blend with a linear alpha ramp across the seam, which is computed with the seam masks and reused. */
+  kFeather,
+};
+
+/**
+ * @brief Convert the name of a blend mode to a StitchBlendMode.
+ *
+ * @param name Name of the blend mode. Either "multiband" or "feather".
+ * @return The matching StitchBlendMode.
+ * @throws std::domain_error if the name is not recognized.
+ */
+StitchBlendMode toStitchBlendMode(const std::string& name);
+
+/**
+ * @brief Create the CameraInfo of a stitched image, which is an undistorted pinhole camera.
+ *
+ * @param stamp Stamp of the stitched image.
+ * @param frame Frame of the virtual camera.
+ * @param width Width of the stitched image in pixels.
+ * @param height Height of the stitched image in pixels.
+ * @param K Intrinsics of the virtual camera.
+ * @return The CameraInfo of the stitched image.
+ */
+CameraInfo toCameraInfo(const Time& stamp, const std::string& frame, std::size_t width, std::size_t height,
+                        const cv::Matx33d& K);
+
+/** @brief Time spent in each stage of stitching one frame, in seconds. Stages that were skipped on the frame are 0. */
+struct StitchStageDurations {
+  double decode{0.0};
+  double warp{0.0};
+  double compensate{0.0};
+  double seam_convert{0.0};
+  double seam{0.0};
+  double blend_convert{0.0};
+  double blend{0.0};
+  double output{0.0};
+};
+
+/** @brief Collects histograms of the stage durations of stitched frames, and reports them as a diagnostic status. */
+class StitchTimingStatistics {
+ public:
+  void add(const StitchStageDurations& durations);
+  diagnostic_msgs::msg::DiagnosticStatus toDiagnosticStatus(const std::string& name) const;
+  void clear();
+
+ private:
+  images::LatencyHistogram decode_;
+  images::LatencyHistogram warp_;
+  images::LatencyHistogram compensate_;
+  images::LatencyHistogram seam_convert_;
+  images::LatencyHistogram seam_;
+  images::LatencyHistogram blend_convert_;
+  images::LatencyHistogram blend_;
+  images::LatencyHistogram output_;
+  images::LatencyHistogram total_;
+};
 
 class CameraSynchronizerBase {
  public:
   virtual ~CameraSynchronizerBase() = default;
   virtual void registerCallback(const DualImageCallbackFn& fn) = 0;
+  virtual void registerCompressedCallback(const DualCompressedImageCallbackFn& fn) = 0;
 };
 
+/**
+ * Synchronizes the left and right cameras, either from their raw images or from their JPEG-compressed images if the
+ * stitched_image_use_compressed parameter is set. Only the callback of the subscribed kind of image is called.
+ */
 class RclcppCameraSynchronizer : public CameraSynchronizerBase {
  public:
   explicit RclcppCameraSynchronizer(const std::shared_ptr<rclcpp::Node>& node);
 
   void registerCallback(const DualImageCallbackFn& fn) override;
+  void registerCompressedCallback(const DualCompressedImageCallbackFn& fn) override;
 
  private:
   using ApproximateTimePolicy = message_filters::sync_policies::ApproximateTime<Image, CameraInfo, Image, CameraInfo>;
   using Synchronizer = message_filters::Synchronizer<ApproximateTimePolicy>;
+  using CompressedApproximateTimePolicy =
+      message_filters::sync_policies::ApproximateTime<CompressedImage, CameraInfo, CompressedImage, CameraInfo>;
+  using CompressedSynchronizer = message_filters::Synchronizer<CompressedApproximateTimePolicy>;
 
   std::unique_ptr<Synchronizer> sync_;
+  std::unique_ptr<CompressedSynchronizer> compressed_sync_;
 
   image_transport::SubscriberFilter subscriber_image1_;
   message_filters::Subscriber<CameraInfo> subscriber_info1_;
   image_transport::SubscriberFilter subscriber_image2_;
   message_filters::Subscriber<CameraInfo> subscriber_info2_;
+  message_filters::Subscriber<CompressedImage> subscriber_compressed1_;
+  message_filters::Subscriber<CompressedImage> subscriber_compressed2_;
 };
 
+using ParameterCallbackFn = std::function<void()>;
+
 /**
  * Handles side effects and parameters for virtual camera
  */
@@ -97,6 +192,20 @@ class CameraHandleBase {
   virtual cv::Vec3d getPlaneNormal() const = 0;
   virtual double getPlaneDistance() const = 0;
   virtual int getRowPadding() const = 0;
+  virtual int getSeamUpdatePeriod() const = 0;
+  virtual StitchBlendMode getBlendMode() const = 0;
+  virtual int getBlendWidth() const = 0;
+  virtual bool getUseGpu() const = 0;
+  virtual JpegDecoderBackend getJpegDecoder() const = 0;
+  virtual bool getPublishTimingDiagnostics() const = 0;
+  virtual void publishDiagnostics(const diagnostic_msgs::msg::DiagnosticArray& diagnostics) = 0;
+  /* Whether the stitched image is also published as a JPEG CompressedImage, and with which quality */
+  virtual bool getPublishCompressed() const = 0;
+  virtual int getJpegQuality() const = 0;
+  /* Publish the JPEG-compressed stitched image, which may be called from another thread than the stitching */
+  virtual void publishCompressed(const CompressedImage& image) const = 0;
+  /* Call fn after the virtual camera or blending parameters were changed at runtime and the getters were updated */
+  virtual void registerParameterCallback(const ParameterCallbackFn& fn) = 0;
 };
 
 class RclcppCameraHandle : public CameraHandleBase {
@@ -111,8 +220,22 @@ class RclcppCameraHandle : public CameraHandleBase {
   cv::Vec3d getPlaneNormal() const override;
   double getPlaneDistance() const override;
   int getRowPadding() const override;
+  int getSeamUpdatePeriod() const override;
+  StitchBlendMode getBlendMode() const override;
+  int getBlendWidth() const override;
+  bool getUseGpu() const override;
+  JpegDecoderBackend getJpegDecoder() const override;
+  bool getPublishTimingDiagnostics() const override;
+  void publishDiagnostics(const diagnostic_msgs::msg::DiagnosticArray& diagnostics) override;
+  bool getPublishCompressed() const override;
+  int getJpegQuality() const override;
+  void publishCompressed(const CompressedImage& image) const override;
+  void registerParameterCallback(const ParameterCallbackFn& fn) override;
 
  private:
+  /* Update the getter of a parameter that can be changed at runtime, and return false if the value is invalid */
+  bool updateParameter(const rclcpp::Parameter& parameter);
+
   image_transport::ImageTransport image_transport_;
   image_transport::CameraPublisher camera_publisher_;
   RclcppTfBroadcasterInterface tf_broadcaster_;
@@ -122,21 +245,76 @@ class RclcppCameraHandle : public CameraHandleBase {
   cv::Vec3d plane_normal_;
   double plane_distance_;
   int row_padding_;
+  int seam_update_period_;
+  StitchBlendMode blend_mode_;
+  int blend_width_;
+  bool use_gpu_;
+  JpegDecoderBackend jpeg_decoder_;
+  bool publish_timing_diagnostics_;
+  rclcpp::Clock::SharedPtr clock_;
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr diagnostics_publisher_;
+  bool publish_compressed_;
+  int jpeg_quality_;
+  rclcpp::Publisher<CompressedImage>::SharedPtr compressed_publisher_;
+  rclcpp::Logger logger_;
+  std::shared_ptr<rclcpp::ParameterEventHandler> parameter_handler_;
+  std::vector<std::shared_ptr<rclcpp::ParameterCallbackHandle>> parameter_callbacks_;
 };
 
 struct MiddleCamera {
   MiddleCamera(const cv::Matx33d& virtual_intrinsics, const cv::Vec3d& plane_normal, double plane_distance,
-               int row_padding, const Transform& body_tform_left, const Transform& body_tform_right,
-               const CameraInfo& info_left, const CameraInfo& info_right);
-  Image::SharedPtr stitch(const std::shared_ptr<const Image>& left, const std::shared_ptr<const Image>& right);
+               int row_padding, int seam_update_period, StitchBlendMode blend_mode, int blend_width, bool use_gpu,
+               JpegDecoderBackend jpeg_decoder, bool measure_stages, const Transform& body_tform_left,
+               const Transform& body_tform_right, const CameraInfo& info_left, const CameraInfo& info_right);
+  /**
+   * Stitch raw images. The stitched image is written into a message that is owned by the camera and reused for every
+   * frame, so it is only valid until the next call to stitch.
+   */
+  Image& stitch(const std::shared_ptr<const Image>& left, const std::shared_ptr<const Image>& right);
+  /**
+   * Stitch images that were already converted to BGR8, or to MONO8 if mono is set, so that callers which feed the same
+   * camera image into several virtual cameras only convert it once. The stitched image is reused like that of raw
+   * images.
+   */
+  Image& stitch(const cv::Mat& left, const cv::Mat& right, bool mono);
+  /**
+   * Stitch JPEG-compressed images, which are decoded with DCT scaling at the lowest resolution that still has at least
+   * one input pixel per pixel of the stitched image. The stitched image is reused like that of raw images.
+   */
+  tl::expected<std::reference_wrapper<Image>, std::string> stitch(const std::shared_ptr<const CompressedImage>& left,
+                                                                  const std::shared_ptr<const CompressedImage>& right);
   Transform getTransform();
+  /* Durations of the stages of the last stitched frame, which are only measured if measure_stages is set */
+  const StitchStageDurations& getStageDurations() const;
+  /* Change how the images are blended. The gains and seams are recomputed on the next frame. */
+  void setBlendOptions(StitchBlendMode blend_mode, int blend_width, int seam_update_period);
 
  private:
+  /* Get the time since the start of the current stage and start the next one, waiting for queued OpenCL work first.
+   * The end of the stage is also traced, which does not wait for OpenCL unless the stages are measured. */
+  double finishStage(const char* stage);
+  Image& stitchScenes(const cv::Mat& scene_left, const cv::Mat& scene_right, bool mono);
+  /* Build the remap maps for input images that were decoded at 1 / decode_scale of their resolution */
+  void buildMaps(int decode_scale);
+
   /* Transforms used to compute the homographies */
   cv::Matx44d body_tform_left_;
   cv::Matx44d body_tform_right_;
   cv::Matx44d body_tform_virtual_;
   std::vector<cv::Matx33d> homography_;
+  // Precomputed cv::remap maps of each homography, in the fixed-point CV_16SC2 and CV_16UC1 encodings
+  std::vector<cv::UMat> maps_xy_;
+  std::vector<cv::UMat> maps_interpolation_;
+  // Input resolution divided by the resolution that the current maps were built for
+  int maps_scale_{0};
+  // Largest input resolution divisor that still samples the input at least once per stitched pixel
+  int decode_scale_;
+  JpegDecoderBackend jpeg_decoder_;
+  // Buffers that compressed images are decoded into, which are reused between frames
+  std::vector<Image> decoded_images_;
+  bool measure_stages_;
+  StitchStageDurations stage_durations_;
+  std::chrono::steady_clock::time_point stage_start_;
   // Top left corners of each image
   std::vector<cv::Point> corners_;
   // These are where the warped images/masks go. They are in vector form because later
@@ -145,19 +323,39 @@ struct MiddleCamera {
   // Warped images encoded in CV_16S and CV_32F, respectively.
   std::vector<cv::UMat> warped_images_f_;
   std::vector<cv::UMat> warped_images_s_;
+  // BGR copies of greyscale warped images, for the parts of the pipeline that only take three channels
+  std::vector<cv::UMat> color_images_;
+  // Gain maps of the compensator at the size of the stitched image in CV_32F, which are applied to greyscale images
+  std::vector<cv::UMat> gain_maps_;
 
   std::vector<cv::UMat> warped_masks_;
   std::vector<std::pair<cv::UMat, uchar>> level_masks_;
+  // Warped masks cut along the seam line, which are cached between seam updates
+  std::vector<cv::UMat> seam_masks_;
+  // Number of frames between updates of the gain compensation and seam masks. 0 only computes them for the first frame.
+  int seam_update_period_;
+  // Number of frames stitched so far, used to schedule the seam updates
+  std::size_t frame_count_{0};
+  StitchBlendMode blend_mode_;
+  // Width in pixels of the alpha ramp across the seam in the feather blend mode
+  int blend_width_;
+  // Alpha ramps of the feather blend mode in CV_32F, which are rebuilt with the seam masks
+  std::vector<cv::UMat> blend_weights_;
   cv::UMat blend_mask_;
   cv::UMat result_;
+  // 8-bit BGR result of the multi-band blender, before it is converted to greyscale
+  cv::UMat result_color_;
   cv::Size result_size_;
+  // Message that the stitched image is written into, which keeps its buffer between frames
+  Image result_message_;
   /* Parts of the stitching pipeline that make the images look good */
   // Color corrects the images between each other
   cv::detail::BlocksGainCompensator compensator_;
   // In the default opencv stitching pipeline they use GraphCut for seam finding
   // which is slower than Dp. In testing, Dp seemed to work well for this use case.
   cv::detail::DpSeamFinder seamer_;
-  // Final blending of the two images along the seam line
+  // Final blending of the two images along the seam line in the multi-band blend mode, which builds its pyramids
+  // on the GPU if OpenCV was built with CUDA and the GPU is enabled
   cv::detail::MultiBandBlender blender_;
 };
 
@@ -165,17 +363,72 @@ class ImageStitcher {
  public:
   ImageStitcher(std::unique_ptr<CameraSynchronizerBase> synchronizer,
                 std::unique_ptr<TfListenerInterfaceBase> tf_listener, std::unique_ptr<CameraHandleBase> camera_handle,
-                std::unique_ptr<LoggerInterfaceBase> logger);
+                std::unique_ptr<LoggerInterfaceBase> logger, std::shared_ptr<ThreadPoolInterfaceBase> thread_pool);
+  /** Wait for the camera rebuild and the encoding which are running on the thread pool, since they use the members. */
+  ~ImageStitcher();
 
  private:
   void callback(const std::shared_ptr<const Image>&, const std::shared_ptr<const CameraInfo>&,
                 const std::shared_ptr<const Image>&, const std::shared_ptr<const CameraInfo>&);
+  void compressedCallback(const std::shared_ptr<const CompressedImage>&, const std::shared_ptr<const CameraInfo>&,
+                          const std::shared_ptr<const CompressedImage>&, const std::shared_ptr<const CameraInfo>&);
+  /** @brief Everything that a stitching camera is built from, which is copied so it can be built on another thread. */
+  struct CameraConfig {
+    std::string body_frame;
+    cv::Matx33d intrinsics;
+    cv::Vec3d plane_normal;
+    double plane_distance;
+    int row_padding;
+    int seam_update_period;
+    StitchBlendMode blend_mode;
+    int blend_width;
+    bool use_gpu;
+    JpegDecoderBackend jpeg_decoder;
+    bool measure_stages;
+    CameraInfo info_left;
+    CameraInfo info_right;
+  };
+
+  /**
+   * Build the stitching camera on the first frame, and return false if it cannot be built yet. Once it is built, swap
+   * in a camera that finished rebuilding, apply changed blending parameters, and start rebuilding the camera in the
+   * background if the virtual camera parameters or the intrinsics of the input cameras changed.
+   */
+  bool initializeCamera(const CameraInfo& info_left, const CameraInfo& info_right);
+  CameraConfig getCameraConfig(const CameraInfo& info_left, const CameraInfo& info_right) const;
+  /* Look up the camera transforms and build a stitching camera, or return nullptr if the transforms are unavailable */
+  std::unique_ptr<MiddleCamera> buildCamera(const CameraConfig& config) const;
+  void publishStitched(Image& image_stitched, const Time& stamp);
+  /**
+   * Encode the stitched image to JPEG and publish it on the thread pool, so that encoding one frame overlaps with
+   * stitching the next. Waits for the encoding of the previous frame first, since it reuses its buffers.
+   */
+  void encodeStitched(const Image& image_stitched);
+  /* Record the stage durations of the last frame, and publish them as diagnostics once per report period */
+  void recordTimings();
 
   std::unique_ptr<CameraSynchronizerBase> synchronizer_;
   std::unique_ptr<TfListenerInterfaceBase> tf_listener_;
   std::unique_ptr<CameraHandleBase> camera_handle_;
   std::unique_ptr<LoggerInterfaceBase> logger_;
+  // Pool which rebuilds the camera and encodes the stitched images
+  std::shared_ptr<ThreadPoolInterfaceBase> thread_pool_;
 
-  std::optional<MiddleCamera> camera_;
+  std::unique_ptr<MiddleCamera> camera_;
+  // Configuration of the camera that is used or being rebuilt, to detect when it has to be rebuilt
+  std::optional<CameraConfig> camera_config_;
+  // Camera that is being rebuilt on the thread pool, which replaces camera_ between two frames once it is ready
+  std::future<std::unique_ptr<MiddleCamera>> pending_camera_;
+  // Set by the parameter callback, which may run on another thread than the stitching
+  std::atomic<bool> parameters_changed_{false};
+  // Camera info of the stitched image, which only changes with the size of the image and is restamped every frame
+  CameraInfo info_stitched_;
+  StitchTimingStatistics timing_statistics_;
+  std::chrono::steady_clock::time_point last_timing_report_;
+  // Copy of the last stitched image, which the next frame cannot overwrite while it is encoded, and its JPEG data
+  Image encode_input_;
+  CompressedImage encode_output_;
+  // Encoding of the last stitched image, which becomes ready once the encoded image was published
+  std::future<void> pending_encode_;
 };
 }  // namespace spot_ros2
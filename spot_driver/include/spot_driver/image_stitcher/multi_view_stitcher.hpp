@@ -0,0 +1,135 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <image_transport/camera_publisher.hpp>
+#include <image_transport/image_transport.hpp>
+#include <memory>
+#include <rclcpp/node.hpp>
+#include <spot_driver/image_stitcher/front_image_stitcher.hpp>
+#include <spot_driver/image_stitcher/image_stitcher.hpp>
+#include <spot_driver/image_stitcher/surround_stitcher.hpp>
+#include <spot_driver/interfaces/logger_interface_base.hpp>
+#include <spot_driver/interfaces/rclcpp_tf_broadcaster_interface.hpp>
+#include <spot_driver/interfaces/tf_listener_interface_base.hpp>
+#include <spot_driver/interfaces/thread_pool_interface_base.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * Stitcher for several virtual cameras, which each sit between two body cameras like the virtual camera of the
+ * image_stitcher_node. Every body camera is only subscribed to and converted once per frame, even if it is used by
+ * several views, and the views are warped and blended in parallel. An additional view therefore only costs its own
+ * warp and blend, instead of a second stitcher node with its own subscriptions and buffers.
+
+  ros2 run spot_driver multi_view_stitcher_node --ros-args -r __ns:=/Lionel \
+    -p spot_name:=Lionel \
+    -p virtual_views:="[frontmiddle_virtual, rightrear_virtual]" \
+    -p frontmiddle_virtual.left_camera:=frontleft \
+    -p frontmiddle_virtual.right_camera:=frontright \
+    -p rightrear_virtual.left_camera:=right \
+    -p rightrear_virtual.right_camera:=back
+
+  The body cameras are subscribed under camera/<name>/image and camera/<name>/camera_info, and every view is published
+  under camera/<view>/image and camera/<view>/camera_info, all in the namespace of the node.
+ */
+namespace spot_ros2 {
+
+/** @brief Configuration of one virtual camera of a MultiViewStitcher. */
+struct VirtualViewOptions {
+  /** @brief Name of the view, which is also the name of its topics. */
+  std::string name;
+  /** @brief Name of the body camera on the left of the virtual camera, which sees the right side of the scene. */
+  std::string left_camera;
+  /** @brief Name of the body camera on the right of the virtual camera. */
+  std::string right_camera;
+  /** @brief Virtual camera and blending options, which match those of a single ImageStitcher. */
+  FrontImageStitcherOptions camera;
+};
+
+/**
+ * @brief Get the distinct body cameras that a set of views stitches, in the order in which they are first used.
+ *
+ * @param views Views to stitch.
+ * @return Names of the cameras, which every view refers to by their index.
+ */
+std::vector<std::string> getInputCameras(const std::vector<VirtualViewOptions>& views);
+
+/**
+ * Handles side effects and parameters for the virtual cameras of a MultiViewStitcher
+ */
+class MultiViewCameraHandleBase {
+ public:
+  virtual ~MultiViewCameraHandleBase() = default;
+  virtual std::vector<VirtualViewOptions> getViews() const = 0;
+  /** @brief Maximum number of views that are stitched at the same time. */
+  virtual std::size_t getMaxStitchThreads() const = 0;
+  virtual bool getUseGpu() const = 0;
+  virtual void publish(std::size_t view, const Image& image, const CameraInfo& info) = 0;
+  virtual void broadcast(const std::vector<geometry_msgs::msg::TransformStamped>& transforms) = 0;
+};
+
+/**
+ * Reads the views from the virtual_views parameter, which lists their names. Every view has the parameters
+ * <view>.left_camera and <view>.right_camera, and the virtual camera and blending parameters of the
+ * image_stitcher_node under the same names, such as <view>.virtual_camera_intrinsics.
+ */
+class RclcppMultiViewCameraHandle : public MultiViewCameraHandleBase {
+ public:
+  explicit RclcppMultiViewCameraHandle(const std::shared_ptr<rclcpp::Node>& node);
+
+  std::vector<VirtualViewOptions> getViews() const override;
+  std::size_t getMaxStitchThreads() const override;
+  bool getUseGpu() const override;
+  void publish(std::size_t view, const Image& image, const CameraInfo& info) override;
+  void broadcast(const std::vector<geometry_msgs::msg::TransformStamped>& transforms) override;
+
+ private:
+  image_transport::ImageTransport image_transport_;
+  std::vector<image_transport::CameraPublisher> camera_publishers_;
+  RclcppTfBroadcasterInterface tf_broadcaster_;
+  std::vector<VirtualViewOptions> views_;
+  std::size_t max_stitch_threads_;
+  bool use_gpu_;
+};
+
+class MultiViewStitcher {
+ public:
+  MultiViewStitcher(std::unique_ptr<MultiCameraSynchronizerBase> synchronizer,
+                    std::unique_ptr<TfListenerInterfaceBase> tf_listener,
+                    std::unique_ptr<MultiViewCameraHandleBase> camera_handle,
+                    std::unique_ptr<LoggerInterfaceBase> logger, std::shared_ptr<ThreadPoolInterfaceBase> thread_pool);
+  ~MultiViewStitcher();
+
+ private:
+  /** @brief One virtual camera, with the indices of its input cameras in the synchronized images. */
+  struct View {
+    VirtualViewOptions options;
+    std::size_t left;
+    std::size_t right;
+    std::unique_ptr<MiddleCamera> camera;
+    /** @brief Last stitched image, which is owned by the camera, and its CameraInfo. */
+    Image* image;
+    CameraInfo info;
+  };
+
+  void callback(const std::vector<std::shared_ptr<const Image>>& images,
+                const std::vector<std::shared_ptr<const CameraInfo>>& infos);
+  /** @brief Build the camera of every view, which needs the transforms from the body frame to every input camera. */
+  bool initializeCameras(const std::vector<std::shared_ptr<const CameraInfo>>& infos);
+  void stitchView(View& view, const std::vector<cv::Mat>& scenes, bool mono, const Time& stamp);
+
+  std::unique_ptr<MultiCameraSynchronizerBase> synchronizer_;
+  std::unique_ptr<TfListenerInterfaceBase> tf_listener_;
+  std::unique_ptr<MultiViewCameraHandleBase> camera_handle_;
+  std::unique_ptr<LoggerInterfaceBase> logger_;
+  std::shared_ptr<ThreadPoolInterfaceBase> thread_pool_;
+
+  std::vector<View> views_;
+  bool cameras_initialized_{false};
+  std::size_t max_stitch_threads_;
+  bool use_gpu_;
+};
+}  // namespace spot_ros2
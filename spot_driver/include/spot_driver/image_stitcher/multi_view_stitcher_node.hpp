@@ -0,0 +1,21 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <memory>
+#include <rclcpp/node.hpp>
+#include <rclcpp/node_interfaces/node_base_interface.hpp>
+#include <spot_driver/image_stitcher/multi_view_stitcher.hpp>
+
+namespace spot_ros2 {
+class MultiViewStitcherNode {
+ public:
+  explicit MultiViewStitcherNode(const rclcpp::NodeOptions& options);
+
+  std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> get_node_base_interface();
+
+ private:
+  std::shared_ptr<rclcpp::Node> node_;
+  std::unique_ptr<MultiViewStitcher> stitcher_;
+};
+}  // namespace spot_ros2
@@ -0,0 +1,173 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <message_filters/subscriber.h>
+#include <message_filters/time_synchronizer.h>
+#include <functional>
+#include <image_transport/image_transport.hpp>
+#include <image_transport/publisher.hpp>
+#include <image_transport/subscriber_filter.hpp>
+#include <memory>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <optional>
+#include <rclcpp/duration.hpp>
+#include <rclcpp/node.hpp>
+#include <spot_driver/image_stitcher/image_stitcher.hpp>
+#include <spot_driver/interfaces/logger_interface_base.hpp>
+#include <spot_driver/interfaces/tf_listener_interface_base.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * Surround view stitcher, which projects any number of body cameras onto a cylinder around the body frame and
+ * publishes the unrolled cylinder as one panorama. The columns of the panorama span 360 degrees of azimuth with the
+ * front of the robot in the center, and the rows are spaced so that the pixels are square.
+
+  ros2 run spot_driver surround_stitcher_node --ros-args \
+    -p body_frame:=Lionel/body \
+    -p surround_cameras:="[frontleft, frontright, right, back, left]" \
+    -p surround_image_width:=2048 \
+    -p surround_image_height:=512 \
+    -p surround_cylinder_radius:=2.0 \
+    --remap surround_camera/image:=/Lionel/camera/surround_virtual/image
+ */
+namespace spot_ros2 {
+using MultiImageCallbackFn = std::function<void(const std::vector<std::shared_ptr<const Image>>&,
+                                                const std::vector<std::shared_ptr<const CameraInfo>>&)>;
+
+class MultiCameraSynchronizerBase {
+ public:
+  virtual ~MultiCameraSynchronizerBase() = default;
+  virtual void registerCallback(const MultiImageCallbackFn& fn) = 0;
+};
+
+/**
+ * Subscribes to the image and camera info of every camera in the surround_cameras parameter, and calls back with one
+ * image of each camera once they were all captured within surround_max_time_difference seconds of each other.
+ */
+class RclcppMultiCameraSynchronizer : public MultiCameraSynchronizerBase {
+ public:
+  explicit RclcppMultiCameraSynchronizer(const std::shared_ptr<rclcpp::Node>& node);
+  /**
+   * Subscribes to the given cameras instead of those in the surround_cameras parameter, and calls back once their
+   * images were captured within max_time_difference of each other.
+   */
+  RclcppMultiCameraSynchronizer(const std::shared_ptr<rclcpp::Node>& node, const std::vector<std::string>& camera_names,
+                                const rclcpp::Duration& max_time_difference);
+
+  void registerCallback(const MultiImageCallbackFn& fn) override;
+
+ private:
+  using CameraSynchronizer = message_filters::TimeSynchronizer<Image, CameraInfo>;
+
+  /** @brief Subscribers of one camera, which pair each image with the camera info of the same stamp. */
+  struct CameraSubscription {
+    image_transport::SubscriberFilter image;
+    message_filters::Subscriber<CameraInfo> info;
+    std::unique_ptr<CameraSynchronizer> sync;
+  };
+
+  void onCamera(std::size_t ndx, const std::shared_ptr<const Image>& image,
+                const std::shared_ptr<const CameraInfo>& info);
+
+  // The message filters cannot be moved, so every subscription is kept at a fixed address
+  std::vector<std::unique_ptr<CameraSubscription>> cameras_;
+  // Latest image and camera info of each camera, which are cleared once they were passed to the callback
+  std::vector<std::shared_ptr<const Image>> images_;
+  std::vector<std::shared_ptr<const CameraInfo>> infos_;
+  rclcpp::Duration max_time_difference_;
+  MultiImageCallbackFn callback_;
+};
+
+/**
+ * Handles side effects and parameters for the surround camera
+ */
+class SurroundCameraHandleBase {
+ public:
+  virtual ~SurroundCameraHandleBase() = default;
+  virtual void publish(const Image& image) const = 0;
+  virtual std::string getBodyFrame() const = 0;
+  virtual cv::Size getImageSize() const = 0;
+  virtual double getCylinderRadius() const = 0;
+  virtual int getBlendWidth() const = 0;
+};
+
+class RclcppSurroundCameraHandle : public SurroundCameraHandleBase {
+ public:
+  explicit RclcppSurroundCameraHandle(const std::shared_ptr<rclcpp::Node>& node);
+
+  void publish(const Image& image) const override;
+  std::string getBodyFrame() const override;
+  cv::Size getImageSize() const override;
+  double getCylinderRadius() const override;
+  int getBlendWidth() const override;
+
+ private:
+  image_transport::ImageTransport image_transport_;
+  image_transport::Publisher publisher_;
+  std::string body_frame_;
+  cv::Size image_size_;
+  double cylinder_radius_;
+  int blend_width_;
+};
+
+struct SurroundCamera {
+  SurroundCamera(const cv::Size& image_size, double cylinder_radius, int blend_width,
+                 const std::vector<Transform>& body_tform_cameras, const std::vector<CameraInfo>& infos);
+  Image::SharedPtr stitch(const std::vector<std::shared_ptr<const Image>>& images);
+
+ private:
+  /**
+   * Part of the panorama that is covered by one camera. A camera that is seen across the edges of the panorama, such
+   * as the back camera, covers one tile on each side.
+   */
+  struct Tile {
+    std::size_t camera;
+    // Bounding box of the tile in the panorama
+    cv::Rect roi;
+    // Precomputed cv::remap maps from the tile into the camera image, in fixed-point CV_16SC2 and CV_16UC1
+    cv::UMat map_xy;
+    cv::UMat map_interpolation;
+    // Pixels of the tile that no other camera sees, which are copied without blending
+    cv::UMat exclusive_mask;
+    // Bounding box of the pixels that overlap with other cameras in the panorama, which is empty without overlap
+    cv::Rect blend_roi;
+    // Pixels in the blend box that overlap with other cameras, and their normalized feather weights in CV_32F for
+    // greyscale images and in CV_32FC3 for color images
+    cv::UMat blend_mask;
+    cv::UMat blend_weights;
+    cv::UMat blend_weights_color;
+    // Camera image warped into the tile
+    cv::UMat warped;
+  };
+
+  cv::Size image_size_;
+  std::vector<Tile> tiles_;
+  // Weighted sum of the overlapping cameras in CV_32F or CV_32FC3, which is only written inside the blend boxes
+  cv::UMat accumulator_;
+  cv::UMat weighted_;
+  cv::UMat blended_;
+  cv::UMat result_;
+};
+
+class SurroundStitcher {
+ public:
+  SurroundStitcher(std::unique_ptr<MultiCameraSynchronizerBase> synchronizer,
+                   std::unique_ptr<TfListenerInterfaceBase> tf_listener,
+                   std::unique_ptr<SurroundCameraHandleBase> camera_handle,
+                   std::unique_ptr<LoggerInterfaceBase> logger);
+
+ private:
+  void callback(const std::vector<std::shared_ptr<const Image>>& images,
+                const std::vector<std::shared_ptr<const CameraInfo>>& infos);
+
+  std::unique_ptr<MultiCameraSynchronizerBase> synchronizer_;
+  std::unique_ptr<TfListenerInterfaceBase> tf_listener_;
+  std::unique_ptr<SurroundCameraHandleBase> camera_handle_;
+  std::unique_ptr<LoggerInterfaceBase> logger_;
+
+  std::optional<SurroundCamera> camera_;
+};
+}  // namespace spot_ros2
@@ -0,0 +1,107 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <spot_driver/api/spot_image_sources.hpp>
+#include <spot_driver/types.hpp>
+
+#include <array>
+#include <cstddef>
+
+namespace spot_ros2::images {
+
+/**
+ * @brief Shares a bandwidth budget between the image sources of all image requests, by the priority of each source.
+ * @details The budget estimates the bytes per second of every source from the sizes of its past responses and the
+ * rate it is requested at. Sources are then admitted from the highest to the lowest priority: a source which fits
+ * into the remaining budget at the highest quality is requested at that quality, an RGB source which only fits at a
+ * lower JPEG quality is requested at the quality that fits, and any other source is left out of the requests until
+ * the budget frees up. Sources which have not been observed yet are always admitted, so that their size is learned.
+ *
+ * The size of an RGB image is estimated to scale linearly with its JPEG quality. This is only a rough model of JPEG,
+ * but the estimate is corrected by every response at the quality the source was actually requested at.
+ */
+class BandwidthBudget {
+ public:
+  /**
+   * @brief Constructor for BandwidthBudget.
+   *
+   * @param bytes_per_second Budget which is shared by all image sources.
+   * @param min_quality Lowest JPEG quality at which an RGB source is admitted, from 0 to 100.
+   * @param max_quality JPEG quality at which the sources are requested if the budget allows it, from 0 to 100.
+   */
+  BandwidthBudget(double bytes_per_second, double min_quality, double max_quality);
+
+  /**
+   * @brief Add an image source to the budget. Sources which are not added are never admitted.
+   *
+   * @param image_source Image source to add.
+   * @param rate Rate at which the source is requested, in Hz.
+   * @param priority Priority of the source. Sources with a higher priority are admitted first, and sources with the
+   * same priority are admitted in the order of their image sources.
+   */
+  void addSource(const ImageSource& image_source, double rate, int priority);
+
+  /**
+   * @brief Set whether an image source is wanted at all, e.g. because it has subscribers. Sources which are not
+   * wanted do not take up any of the budget. Sources are wanted when they are added.
+   *
+   * @param image_source Image source to set.
+   * @param wanted True if the source should be requested.
+   */
+  void setWanted(const ImageSource& image_source, bool wanted);
+
+  /**
+   * @brief Update the size estimate of an image source from a response.
+   *
+   * @param image_source Image source of the image.
+   * @param size Size of the image data in the response, in bytes.
+   * @param quality JPEG quality the image was requested at. Ignored for sources which are not RGB.
+   */
+  void update(const ImageSource& image_source, std::size_t size, double quality);
+
+  /** @brief Decide which sources are admitted, and at which quality, from the current size estimates. */
+  void allocate();
+
+  /**
+   * @brief Check whether an image source was admitted by the last call to allocate().
+   *
+   * @param image_source Image source to check.
+   * @return True if the source should be requested.
+   */
+  [[nodiscard]] bool isAdmitted(const ImageSource& image_source) const;
+
+  /**
+   * @brief Get the JPEG quality at which an image source was admitted by the last call to allocate().
+   *
+   * @param image_source Image source to get the quality of.
+   * @return The quality, between the minimum and maximum quality, or the maximum quality if the source is not RGB.
+   */
+  [[nodiscard]] double quality(const ImageSource& image_source) const;
+
+ private:
+  /** @brief State of one image source. */
+  struct Source {
+    bool added{false};
+    /** @brief Whether the quality of the source can be lowered to fit it into the budget. */
+    bool rgb{false};
+    bool wanted{false};
+    double rate{0.0};
+    int priority{0};
+    /** @brief Whether bytes_per_image holds an estimate yet. */
+    bool observed{false};
+    /** @brief Estimated size of one image, scaled to max_quality_ for RGB sources. */
+    double bytes_per_image{0.0};
+    bool admitted{false};
+    double quality{0.0};
+  };
+
+  double bytes_per_second_;
+  double min_quality_;
+  double max_quality_;
+
+  /** @brief State of every image source, indexed by toImageSourceIndex(). */
+  std::array<Source, kNumImageSources> sources_;
+};
+
+}  // namespace spot_ros2::images
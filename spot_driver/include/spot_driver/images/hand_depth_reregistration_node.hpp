@@ -0,0 +1,49 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <rclcpp/node.hpp>
+#include <rclcpp/node_interfaces/node_base_interface.hpp>
+#include <rclcpp/publisher.hpp>
+#include <rclcpp/subscription.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/conversions/depth_reregistration.hpp>
+
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace spot_ros2::images {
+/**
+ * @brief Re-registers the depth images of the hand camera into its RGB camera with a custom calibration, since the
+ * calibration which the robot uses for `depth_registered/hand/image` cannot be changed through the API.
+ * @details This replaces `calibrated_reregistered_hand_camera_depth_publisher.py`, and reads the same parameters, so a
+ * calibration which was exported for the Python publisher can be passed as a parameter file. The mapping from the
+ * calibration is computed once when the node starts. When the node is composed into the driver container with
+ * intra-process communication, it receives the depth images and hands out the re-registered images without copying
+ * them.
+ *
+ * The node reads the parameters:
+ * - `camera_matrix_depth`, `dist_coeffs_depth`, `camera_matrix_rgb`, `depth_t_rgb_R`, `depth_t_rgb_T`,
+ *   `depth_image_dim` and `rgb_image_dim`: The calibration, see DepthReregistrationCalibration.
+ * - `undistort`: If true, remove the lens distortion of the depth camera before re-registering its images.
+ * - `robot_name`: Name of the robot, which prefixes the frame of the re-registered images.
+ * - `raw_depth_topic`: Depth image topic of the hand camera, relative to the namespace of the node.
+ * - `topic_name`: Topic to publish the re-registered images to, relative to the namespace of the node.
+ */
+class HandDepthReregistrationNode {
+ public:
+  explicit HandDepthReregistrationNode(const rclcpp::NodeOptions& options = rclcpp::NodeOptions{});
+
+  std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> get_node_base_interface();
+
+ private:
+  void onDepthImage(const sensor_msgs::msg::Image& depth_image);
+
+  std::shared_ptr<rclcpp::Node> node_;
+  std::optional<DepthReregistration> reregistration_;
+  std::string frame_id_;
+  rclcpp::Publisher<sensor_msgs::msg::Image>::SharedPtr publisher_;
+  rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr subscription_;
+};
+}  // namespace spot_ros2::images
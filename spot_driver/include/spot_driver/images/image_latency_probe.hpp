@@ -0,0 +1,83 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <builtin_interfaces/msg/time.hpp>
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace spot_ros2::images {
+
+/**
+ * @brief Get the age of a frame when it was received, which is the time between its header stamp and the receive time.
+ * @details The image publisher stamps images with their acquisition time converted to the clock of the host, so the age
+ * covers the exposure, the transfer from the robot, decoding, publishing and the transport to the subscriber.
+ *
+ * @param stamp Header stamp of the frame.
+ * @param receive_time Time at which the frame was received, from the same clock as the stamp.
+ * @return The age in seconds. Negative if the stamp is in the future, e.g. because of an error in the clock skew.
+ */
+[[nodiscard]] double frameAge(const builtin_interfaces::msg::Time& stamp,
+                              const builtin_interfaces::msg::Time& receive_time);
+
+/**
+ * @brief Collects the ages of the frames received on a set of topics and reports exact percentiles of them.
+ * @details Unlike LatencyHistogram, every age is kept, since the probe is meant to compare transports and settings over
+ * runs of minutes rather than to run alongside the driver indefinitely.
+ */
+class FrameAgeStatistics {
+ public:
+  /** @brief Statistics of the frame ages of one topic, in seconds. */
+  struct Summary {
+    std::string topic;
+    std::size_t count{0};
+    double mean{0.0};
+    double p50{0.0};
+    double p90{0.0};
+    double p99{0.0};
+    double max{0.0};
+  };
+
+  /**
+   * @brief Add the age of one frame.
+   *
+   * @param topic Topic on which the frame was received.
+   * @param age Age of the frame in seconds.
+   */
+  void add(const std::string& topic, double age);
+
+  /**
+   * @brief Summarize the ages of every topic with at least one frame.
+   *
+   * @return One summary per topic, ordered by topic. Percentiles use the nearest rank.
+   */
+  [[nodiscard]] std::vector<Summary> summarize() const;
+
+  /** @brief Remove all ages, so that the next summary only covers new frames. */
+  void clear();
+
+ private:
+  std::map<std::string, std::vector<double>> ages_;
+};
+
+/**
+ * @brief Write summaries as CSV with a header row, with all durations in milliseconds.
+ *
+ * @param summaries Summaries to write.
+ * @param out Stream to write to.
+ */
+void writeSummaryCsv(const std::vector<FrameAgeStatistics::Summary>& summaries, std::ostream& out);
+
+/**
+ * @brief Format summaries as a table with one line per topic and all durations in milliseconds, for logging.
+ *
+ * @param summaries Summaries to format.
+ * @return The table, including a header line.
+ */
+[[nodiscard]] std::string formatSummaryTable(const std::vector<FrameAgeStatistics::Summary>& summaries);
+
+}  // namespace spot_ros2::images
@@ -0,0 +1,47 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <rclcpp/node.hpp>
+#include <rclcpp/node_interfaces/node_base_interface.hpp>
+#include <rclcpp/subscription.hpp>
+#include <rclcpp/timer.hpp>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/images/image_latency_probe.hpp>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spot_ros2::images {
+/**
+ * @brief Subscribes to the image and camera info topics of the image publisher in the namespace of the node, and
+ * reports the age of their frames versus their header stamps.
+ * @details The node logs a table of percentiles per topic every `latency_probe_report_period` seconds. If
+ * `latency_probe_csv_file` is set, every frame is appended to it as it arrives, and if `latency_probe_summary_file` is
+ * set, the summary of the whole run is written to it when the node is destroyed.
+ */
+class ImageLatencyProbeNode {
+ public:
+  explicit ImageLatencyProbeNode(const rclcpp::NodeOptions& options = rclcpp::NodeOptions{});
+
+  ~ImageLatencyProbeNode();
+
+  std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> get_node_base_interface();
+
+ private:
+  void onFrame(const std::string& topic, const builtin_interfaces::msg::Time& stamp);
+
+  void report();
+
+  std::shared_ptr<rclcpp::Node> node_;
+  FrameAgeStatistics statistics_;
+  std::ofstream csv_file_;
+  std::string summary_file_;
+  std::vector<rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr> image_subscriptions_;
+  std::vector<rclcpp::Subscription<sensor_msgs::msg::CameraInfo>::SharedPtr> info_subscriptions_;
+  rclcpp::TimerBase::SharedPtr report_timer_;
+};
+}  // namespace spot_ros2::images
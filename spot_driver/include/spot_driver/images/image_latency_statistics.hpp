@@ -0,0 +1,103 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <diagnostic_msgs/msg/diagnostic_status.hpp>
+#include <spot_driver/api/spot_image_sources.hpp>
+#include <spot_driver/interfaces/image_client_interface.hpp>
+#include <spot_driver/types.hpp>
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace spot_ros2::images {
+
+/** @brief Histogram of latencies with fixed, roughly logarithmic bucket edges from 1 ms to 1 s. */
+class LatencyHistogram {
+ public:
+  /** @brief Upper edges of the buckets, in seconds. Latencies above the last edge are counted in an overflow bucket. */
+  static constexpr std::array<double, 10> kBucketEdges{0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0};
+
+  /**
+   * @brief Add a latency to the histogram.
+   *
+   * @param seconds Latency in seconds.
+   */
+  void add(double seconds);
+
+  /**
+   * @brief Get an upper bound of a percentile of the latencies added so far.
+   *
+   * @param fraction Percentile as a fraction between 0 and 1, e.g. 0.95 for the 95th percentile.
+   * @return The upper edge of the bucket that contains the percentile, or the maximum latency if it is in the overflow
+   * bucket. Zero if no latencies were added.
+   */
+  [[nodiscard]] double percentile(double fraction) const;
+
+  [[nodiscard]] std::size_t count() const { return count_; }
+  [[nodiscard]] double mean() const { return count_ > 0 ? sum_ / static_cast<double>(count_) : 0.0; }
+  [[nodiscard]] double max() const { return max_; }
+
+ private:
+  std::array<std::size_t, kBucketEdges.size() + 1> buckets_{};
+  std::size_t count_{0};
+  double sum_{0.0};
+  double max_{0.0};
+};
+
+/**
+ * @brief Add the mean, 50th and 95th percentile and maximum of one stage in milliseconds to a diagnostic status.
+ *
+ * @param stage Name of the stage, which prefixes the keys.
+ * @param histogram Latencies of the stage.
+ * @param status Diagnostic status to add the key-value pairs to.
+ */
+void addStageValues(const std::string& stage, const LatencyHistogram& histogram,
+                    diagnostic_msgs::msg::DiagnosticStatus& status);
+
+/**
+ * @brief Collects per-source latency histograms for each stage that an image goes through before it is published, and
+ * reports them as diagnostics.
+ */
+class ImageLatencyStatistics {
+ public:
+  /**
+   * @brief Add the latencies of one image.
+   *
+   * @param image_source Image source of the image.
+   * @param latency Latencies of the image. The total latency is measured until this call, so it should be made right
+   * after the image was published.
+   */
+  void add(const ImageSource& image_source, const ImageLatency& latency);
+
+  /**
+   * @brief Create one diagnostic status for every image source with latencies, which reports the sample count, mean,
+   * 50th and 95th percentile and maximum of each stage in milliseconds.
+   *
+   * @param name_prefix Prefix of the names of the diagnostic statuses, which are followed by the topic of the source.
+   * @return The diagnostic statuses, ordered by image source.
+   */
+  [[nodiscard]] std::vector<diagnostic_msgs::msg::DiagnosticStatus> toDiagnosticStatus(
+      const std::string& name_prefix) const;
+
+  /** @brief Remove all latencies, so that the next report only covers new images. */
+  void clear();
+
+ private:
+  /** @brief Histograms of a single image source. */
+  struct SourceHistograms {
+    std::optional<ImageSource> source;
+    LatencyHistogram robot_to_host;
+    LatencyHistogram decode;
+    LatencyHistogram publish;
+    LatencyHistogram total;
+  };
+
+  /** @brief Histograms of every image source, indexed by toImageSourceIndex(). */
+  std::array<SourceHistograms, kNumImageSources> histograms_;
+};
+
+}  // namespace spot_ros2::images
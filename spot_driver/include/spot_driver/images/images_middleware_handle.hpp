@@ -2,7 +2,9 @@
 
 #pragma once
 
-#include <map>
+#include <array>
+#include <cstdint>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
 #include <memory>
 #include <rclcpp/node.hpp>
 #include <set>
@@ -11,9 +13,12 @@
 #include <spot_driver/interfaces/rclcpp_parameter_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_tf_broadcaster_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_wall_timer_interface.hpp>
+#include <spot_driver/recording/recording_tap.hpp>
+#include <spot_msgs/msg/serialized_proto.hpp>
 #include <string>
 #include <tl_expected/expected.hpp>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace spot_ros2::images {
 /**
@@ -21,13 +26,39 @@ namespace spot_ros2::images {
  */
 class ImagesMiddlewareHandle : public SpotImagePublisher::MiddlewareHandle {
  public:
+  /** @brief QoS profiles of the image publishers, one for each category of the `qos.<category>.*` parameters. */
+  struct PublisherQoS {
+    rclcpp::QoS image;
+    rclcpp::QoS compressed_image;
+    rclcpp::QoS camera_info;
+    rclcpp::QoS point_cloud;
+  };
+
   /**
-   * @brief Constructor for ImagesMiddlewareHandle
+   * @brief Read the QoS profiles of the image publishers from the `qos.<category>.*` parameters. A category whose
+   * parameters are invalid falls back to the default profile, with a warning.
+   *
+   * @param parameters Parameter interface to read the QoS settings from.
+   * @param logger Logger for the warnings about invalid settings.
+   * @return The QoS profiles.
+   */
+  static PublisherQoS loadPublisherQoS(const ParameterInterfaceBase& parameters, const LoggerInterfaceBase& logger);
+
+  /**
+   * @brief Constructor for ImagesMiddlewareHandle, whose publishers use the default QoS profile.
    *
    * @param node  A shared_ptr to an instance of a rclcpp::Node
    */
   explicit ImagesMiddlewareHandle(const std::shared_ptr<rclcpp::Node>& node);
 
+  /**
+   * @brief Constructor for ImagesMiddlewareHandle
+   *
+   * @param node  A shared_ptr to an instance of a rclcpp::Node
+   * @param qos QoS profiles of the publishers, usually from loadPublisherQoS().
+   */
+  ImagesMiddlewareHandle(const std::shared_ptr<rclcpp::Node>& node, const PublisherQoS& qos);
+
   /**
    * @brief Constructor for ImagesMiddlewareHandle which creates an instance of an rclcpp::node
    *
@@ -36,34 +67,186 @@ class ImagesMiddlewareHandle : public SpotImagePublisher::MiddlewareHandle {
   explicit ImagesMiddlewareHandle(const rclcpp::NodeOptions& node_options = rclcpp::NodeOptions{});
 
   /**
-   * @brief Populates the image_publishgers_ and info_publishers_ members with image and camera info publishers.
+   * @brief Populates the publishers_ member with image and camera info publishers.
+   * @details When called again, the publishers which are still needed are kept, so that their topics are not
+   * interrupted, and only the publishers which are no longer needed are destroyed.
    * @param image_sources Set of ImageSources. A publisher will be created for each ImageSource.
+   * @param options Selects the publishers which are created besides the image and camera info publishers.
    */
-  void createPublishers(const std::set<ImageSource>& image_sources, bool uncompress_images,
-                        bool publish_compressed_images) override;
+  void createPublishers(const std::set<ImageSource>& image_sources, const PublisherOptions& options) override;
 
   /**
    * @brief Publishes (compressed) images and camera info messages to ROS 2 topics.
-   * @param images Map of image sources to image and camera info data.
-   * @param compressed_images Map of image sources to compressed image and camera info data.
+   * @details When intra-process communication is enabled, the messages are moved into the middleware, so that
+   * subscribers in the same process receive them without a copy. Otherwise they are serialized in place and left
+   * untouched, so that the caller can reuse their data buffers.
+   * @param images Image sources with their image and camera info data.
+   * @param compressed_images Image sources with their compressed image and camera info data.
    * @return If all images were published successfully, returns void. If there was an error, returns an error message.
    */
   tl::expected<void, std::string> publishImages(
-      const std::map<ImageSource, ImageWithCameraInfo>& images,
-      const std::map<ImageSource, CompressedImageWithCameraInfo>& compressed_images) override;
+      std::vector<std::pair<ImageSource, ImageWithCameraInfo>>& images,
+      std::vector<std::pair<ImageSource, CompressedImageWithCameraInfo>>& compressed_images) override;
+
+  /**
+   * @brief Publishes preview images and their camera info messages to the `image_preview` and `camera_info_preview`
+   * topics of each image source.
+   * @param preview_images Image sources with their preview image and camera info data.
+   * @return If all previews were published successfully, returns void. If there was an error, returns an error message.
+   */
+  tl::expected<void, std::string> publishPreviewImages(
+      std::vector<std::pair<ImageSource, ImageWithCameraInfo>> preview_images) override;
+
+  /**
+   * @brief Publishes the point clouds created from depth images to the `points` topic of each image source.
+   * @param point_clouds Image sources with their point clouds.
+   * @return If all point clouds were published successfully, returns void. If there was an error, returns an error
+   * message.
+   */
+  tl::expected<void, std::string> publishPointClouds(
+      std::vector<std::pair<ImageSource, sensor_msgs::msg::PointCloud2>> point_clouds) override;
+
+  /**
+   * @brief Publishes the losslessly compressed depth images to the `compressedDepth` topic of each image source.
+   * @param compressed_depth_images Image sources with their compressed depth images.
+   * @return If all compressed depth images were published successfully, returns void. If there was an error, returns
+   * an error message.
+   */
+  tl::expected<void, std::string> publishCompressedDepthImages(
+      std::vector<std::pair<ImageSource, sensor_msgs::msg::CompressedImage>> compressed_depth_images) override;
+
+  /**
+   * @brief Publishes the filtered depth images and their camera info messages to the `image_filtered` and
+   * `camera_info_filtered` topics of each image source.
+   * @param filtered_depth_images Image sources with their filtered depth image and camera info data.
+   * @return If all filtered depth images were published successfully, returns void. If there was an error, returns an
+   * error message.
+   */
+  tl::expected<void, std::string> publishFilteredDepthImages(
+      std::vector<std::pair<ImageSource, ImageWithCameraInfo>> filtered_depth_images) override;
+
+  /**
+   * @brief Publishes the scan merged from the depth images of the body cameras to the `scan` topic.
+   * @param scan Laser scan to publish.
+   * @return If the scan was published successfully, returns void. If there was an error, returns an error message.
+   */
+  tl::expected<void, std::string> publishLaserScan(sensor_msgs::msg::LaserScan scan) override;
+
+  /**
+   * @brief Publishes the image stitched from the front cameras and its camera info to the topics of the virtual camera.
+   * @details Both messages are published in place, since they are reused by the stitcher for the next images.
+   * @param image Stitched image.
+   * @param info Camera info of the virtual camera.
+   * @return If the image was published successfully, returns void. If there was an error, returns an error message.
+   */
+  tl::expected<void, std::string> publishStitchedImage(const sensor_msgs::msg::Image& image,
+                                                       const sensor_msgs::msg::CameraInfo& info) override;
+
+  /**
+   * @brief Publishes the images of one request together to the `image_bundle` topic.
+   * @param bundle Images, camera infos and camera transforms of the request.
+   * @return If the bundle was published successfully, returns void. If there was an error, returns an error message.
+   */
+  tl::expected<void, std::string> publishImageBundle(spot_msgs::msg::ImageBundle bundle) override;
+
+  /**
+   * @brief Publishes a serialized GetImageResponse to the `image_responses/raw` topic, stamped with the current time.
+   * @param data Serialized response, which is moved into the message.
+   * @return If the response was published successfully, returns void. If there was an error, returns an error message.
+   */
+  tl::expected<void, std::string> publishRawImageResponse(std::vector<std::uint8_t> data) override;
+
+  /**
+   * @brief Checks whether anything is subscribed to the image, compressed image, camera info, preview, point cloud, or
+   * compressed depth topics of an image source.
+   * @param image_source Image source to check.
+   * @return True if at least one of the topics of the image source has a subscriber.
+   */
+  bool hasSubscribers(const ImageSource& image_source) const override;
+
+  /**
+   * @brief Checks whether anything is subscribed to the `image_bundle` topic.
+   * @return True if the bundle publisher exists and has at least one subscriber.
+   */
+  bool hasImageBundleSubscribers() const override;
+
+  /**
+   * @brief Checks whether anything is subscribed to the `scan` topic.
+   * @return True if the scan publisher exists and has at least one subscriber.
+   */
+  bool hasLaserScanSubscribers() const override;
+
+  /**
+   * @brief Checks whether anything is subscribed to the image or camera info topic of the virtual camera.
+   * @return True if the stitched image publishers exist and one of them has at least one subscriber.
+   */
+  bool hasStitchedImageSubscribers() const override;
+
+  /**
+   * @brief Checks whether anything is subscribed to the `image_responses/raw` topic.
+   * @return True if the raw response publisher exists and has at least one subscriber.
+   */
+  bool hasRawImageResponseSubscribers() const override;
+
+  /**
+   * @brief Publishes image latency statistics to the `/diagnostics` topic, stamped with the current time.
+   * @details The publisher is created on the first call, so nothing is advertised unless latencies are measured.
+   * @param diagnostics Diagnostic statuses to publish.
+   */
+  void publishLatencyDiagnostics(const diagnostic_msgs::msg::DiagnosticArray& diagnostics) override;
 
  private:
   /** @brief Shared instance of an rclcpp node to create publishers */
   std::shared_ptr<rclcpp::Node> node_;
 
-  /** @brief Map between image topic names and image publishers. */
-  std::unordered_map<std::string, std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::Image>>> image_publishers_;
+  /** @brief QoS profiles of the publishers, which are only read from the parameters once. */
+  PublisherQoS qos_;
+
+  /** @brief Publishers of a single image source. Publishers which were not created are null. */
+  struct SourcePublishers {
+    std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::Image>> image;
+    std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::CompressedImage>> compressed_image;
+    std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::CameraInfo>> info;
+    std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::Image>> preview_image;
+    std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::CameraInfo>> preview_info;
+    std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::PointCloud2>> point_cloud;
+    std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::CompressedImage>> compressed_depth_image;
+    std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::Image>> filtered_depth_image;
+    std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::CameraInfo>> filtered_depth_info;
+  };
+
+  /**
+   * @brief Publishers of every image source, indexed by toImageSourceIndex().
+   * @details The set of image sources rarely changes after the publishers are created, so a flat array avoids building
+   * topic names and searching for the publishers of each image on every publish.
+   */
+  std::array<SourcePublishers, kNumImageSources> publishers_;
+
+  /** @brief Publisher of the laser scan, which is null unless it is published. */
+  std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::LaserScan>> laser_scan_publisher_;
+
+  /** @brief Publishers of the stitched front image and its camera info, which are null unless it is published. */
+  std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::Image>> stitched_image_publisher_;
+  std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::CameraInfo>> stitched_info_publisher_;
+  /** @brief Name of the virtual camera of the stitched image publishers. */
+  std::string stitched_camera_;
+
+  /** @brief Publisher of the image bundles, which is null unless they are published. */
+  std::shared_ptr<rclcpp::Publisher<spot_msgs::msg::ImageBundle>> image_bundle_publisher_;
 
-  /** @brief Map between image topic names and compressed image publishers. */
-  std::unordered_map<std::string, std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::CompressedImage>>>
-      compressed_image_publishers_;
+  /** @brief Publisher of the serialized image responses, which is null unless they are published. */
+  std::shared_ptr<rclcpp::Publisher<spot_msgs::msg::SerializedProto>> raw_response_publisher_;
 
-  /** @brief Map between camera info topic names and camera info publishers. */
-  std::unordered_map<std::string, std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::CameraInfo>>> info_publishers_;
+  /** @brief Publisher of the image latency diagnostics. Created by the first call to publishLatencyDiagnostics(). */
+  std::shared_ptr<rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>> diagnostics_publisher_;
+
+  /** @brief If true, messages are moved into the middleware as unique_ptrs for intra-process subscribers. */
+  bool move_messages_{false};
+
+  /**
+   * @brief Tap through which the images are also handed to a recorder in the same process. RGB images are only recorded
+   * as compressed images, so that the recording holds the JPEG images which Spot sent.
+   */
+  std::shared_ptr<recording::RecordingTap> recording_tap_{recording::RecordingTap::getDefault()};
 };
 }  // namespace spot_ros2::images
@@ -0,0 +1,61 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <spot_driver/api/spot_image_sources.hpp>
+#include <spot_driver/types.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace spot_ros2::images {
+
+/**
+ * @brief Adapts the JPEG quality of each image source of an image request, so that the request keeps up with the rate
+ * it is made at while the link throughput changes.
+ * @details The controller lowers the quality when a request takes longer than most of its period, and raises it again
+ * when requests finish well within their period. Sources which account for a larger share of the response bytes are
+ * lowered faster, since they take up more of the link.
+ */
+class JpegQualityController {
+ public:
+  /**
+   * @brief Constructor for JpegQualityController.
+   *
+   * @param min_quality Lowest JPEG quality the controller may request, from 0 to 100.
+   * @param max_quality Highest JPEG quality the controller may request, from 0 to 100. Every source starts at this
+   * quality.
+   * @param target_period Period at which the image request is made.
+   */
+  JpegQualityController(double min_quality, double max_quality, std::chrono::duration<double> target_period);
+
+  /**
+   * @brief Update the quality of the sources of a request from the response it got.
+   *
+   * @param response_sizes Size of the image data of each source in the response, in bytes.
+   * @param request_duration Time from sending the request until the response arrived.
+   */
+  void update(const std::vector<std::pair<ImageSource, std::size_t>>& response_sizes,
+              std::chrono::duration<double> request_duration);
+
+  /**
+   * @brief Get the JPEG quality to request for an image source.
+   *
+   * @param image_source Image source to get the quality of.
+   * @return The quality, between the minimum and maximum quality.
+   */
+  [[nodiscard]] double quality(const ImageSource& image_source) const;
+
+ private:
+  double min_quality_;
+  double max_quality_;
+  std::chrono::duration<double> target_period_;
+
+  /** @brief Quality of every image source, indexed by toImageSourceIndex(). */
+  std::array<double, kNumImageSources> qualities_;
+};
+
+}  // namespace spot_ros2::images
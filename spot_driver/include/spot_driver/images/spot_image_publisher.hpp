@@ -2,27 +2,57 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <builtin_interfaces/msg/time.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <future>
+#include <geometry_msgs/msg/transform_stamped.hpp>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <rclcpp/node.hpp>
 #include <sensor_msgs/msg/camera_info.hpp>
 #include <sensor_msgs/msg/image.hpp>
+#include <sensor_msgs/msg/laser_scan.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
 #include <set>
+#include <spot_driver/api/image_message_pool.hpp>
+#include <spot_driver/api/link_monitor.hpp>
 #include <spot_driver/api/middleware_handle_base.hpp>
 #include <spot_driver/api/spot_image_sources.hpp>
+#include <spot_driver/conversions/image_preview.hpp>
+#include <spot_driver/images/image_latency_statistics.hpp>
+#include <spot_driver/images/bandwidth_budget.hpp>
+#include <spot_driver/images/jpeg_quality_controller.hpp>
 #include <spot_driver/interfaces/image_client_interface.hpp>
 #include <spot_driver/interfaces/logger_interface_base.hpp>
 #include <spot_driver/interfaces/parameter_interface_base.hpp>
 #include <spot_driver/interfaces/tf_broadcaster_interface_base.hpp>
+#include <spot_driver/interfaces/thread_pool_interface_base.hpp>
 #include <spot_driver/interfaces/timer_interface_base.hpp>
+#include <spot_driver/interfaces/work_stealing_thread_pool.hpp>
+#include <spot_driver/metrics/metrics_registry.hpp>
 #include <spot_driver/types.hpp>
+#include <spot_msgs/msg/image_bundle.hpp>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace spot_ros2 {
+class FrontImageStitcher;
+}  // namespace spot_ros2
 
 namespace spot_ros2::images {
 /**
  * @brief Create a Spot API GetImageRequest message to request images from the specified sources using the specified
  * options.
- * @details Requests for depth images will always use FORMAT_RAW at quality 100.0.
+ * @details Requests for depth images will always use quality 100.0, and use either FORMAT_RAW or FORMAT_RLE.
  *
  * @param sources Set of image sources. Defines which cameras to request images from.
  * @param has_rgb_cameras Set this to true if Spot's 2D body cameras can capture RGB image data.
@@ -30,10 +60,52 @@ namespace spot_ros2::images {
  * requesting JPEG-compressed RGB image data.
  * @param get_raw_rgb_images If true, request raw images from Spot's 2D body cameras. If false, request JPEG-compressed
  * images.
+ * @param get_rle_depth_images If true, request run-length encoded depth images, which use less bandwidth. If false,
+ * request raw depth images.
+ * @param rgb_resize_ratio Ratio from 0.01 to 1.0 by which Spot scales down the RGB images before sending them. A value
+ * of 1.0 requests the images at the resolution of the camera.
  * @return A GetImageRequest message equivalent to the input parameters.
  */
 ::bosdyn::api::GetImageRequest createImageRequest(const std::set<ImageSource>& sources, const bool has_rgb_cameras,
-                                                  const double rgb_image_quality, const bool get_raw_rgb_images);
+                                                  const double rgb_image_quality, const bool get_raw_rgb_images,
+                                                  const bool get_rle_depth_images, const double rgb_resize_ratio = 1.0);
+
+/** @brief Selects the publishers which SpotImagePublisher::MiddlewareHandle::createPublishers() creates. */
+struct PublisherOptions {
+  /** @brief If true, create image publishers for the RGB sources. The other sources always have them. */
+  bool uncompress_images{false};
+  /** @brief If true, create compressed image publishers for the RGB sources. */
+  bool publish_compressed_images{false};
+  /** @brief If true, create publishers for the preview images and their camera info. */
+  bool publish_preview_images{false};
+  /** @brief If true, create point cloud publishers for the depth image sources. */
+  bool publish_point_clouds{false};
+  /** @brief If true, create the publisher of the `image_bundle` topic. */
+  bool publish_image_bundle{false};
+  /** @brief If true, create the publisher of the `image_responses/raw` topic. */
+  bool publish_raw_responses{false};
+  /** @brief If true, create compressed depth image publishers for the depth image sources. */
+  bool publish_compressed_depth_images{false};
+  /** @brief If true, create publishers for the filtered depth images of the depth sources and their camera info. */
+  bool publish_filtered_depth_images{false};
+  /** @brief If true, create the publisher of the `scan` topic. */
+  bool publish_laser_scan{false};
+  /**
+   * @brief If not empty, create the image and camera info publishers of the virtual camera with this name, such as
+   * `frontmiddle_virtual`, which the front images are stitched into.
+   */
+  std::string stitched_camera;
+
+  /** @brief Allows comparing one PublisherOptions instance with another. */
+  bool operator==(const PublisherOptions& e) const {
+    return e.uncompress_images == uncompress_images && e.publish_compressed_images == publish_compressed_images &&
+           e.publish_preview_images == publish_preview_images && e.publish_point_clouds == publish_point_clouds &&
+           e.publish_image_bundle == publish_image_bundle && e.publish_raw_responses == publish_raw_responses &&
+           e.publish_compressed_depth_images == publish_compressed_depth_images &&
+           e.publish_filtered_depth_images == publish_filtered_depth_images &&
+           e.publish_laser_scan == publish_laser_scan && e.stitched_camera == stitched_camera;
+  }
+};
 
 /**
  * @brief A class to connect to and authenticate with Spot, retrieve images from its cameras, and publish the images to
@@ -48,11 +120,29 @@ class SpotImagePublisher {
    public:
     virtual ~MiddlewareHandle() = default;
 
-    virtual void createPublishers(const std::set<ImageSource>& image_sources, bool uncompress_images,
-                                  bool publish_compressed_images) = 0;
+    virtual void createPublishers(const std::set<ImageSource>& image_sources, const PublisherOptions& options) = 0;
     virtual tl::expected<void, std::string> publishImages(
-        const std::map<ImageSource, ImageWithCameraInfo>& images,
-        const std::map<ImageSource, CompressedImageWithCameraInfo>& compressed_images) = 0;
+        std::vector<std::pair<ImageSource, ImageWithCameraInfo>>& images,
+        std::vector<std::pair<ImageSource, CompressedImageWithCameraInfo>>& compressed_images) = 0;
+    virtual tl::expected<void, std::string> publishPreviewImages(
+        std::vector<std::pair<ImageSource, ImageWithCameraInfo>> preview_images) = 0;
+    virtual tl::expected<void, std::string> publishPointClouds(
+        std::vector<std::pair<ImageSource, sensor_msgs::msg::PointCloud2>> point_clouds) = 0;
+    virtual tl::expected<void, std::string> publishCompressedDepthImages(
+        std::vector<std::pair<ImageSource, sensor_msgs::msg::CompressedImage>> compressed_depth_images) = 0;
+    virtual tl::expected<void, std::string> publishFilteredDepthImages(
+        std::vector<std::pair<ImageSource, ImageWithCameraInfo>> filtered_depth_images) = 0;
+    virtual tl::expected<void, std::string> publishLaserScan(sensor_msgs::msg::LaserScan scan) = 0;
+    virtual tl::expected<void, std::string> publishStitchedImage(const sensor_msgs::msg::Image& image,
+                                                                 const sensor_msgs::msg::CameraInfo& info) = 0;
+    virtual tl::expected<void, std::string> publishImageBundle(spot_msgs::msg::ImageBundle bundle) = 0;
+    virtual tl::expected<void, std::string> publishRawImageResponse(std::vector<std::uint8_t> data) = 0;
+    virtual bool hasSubscribers(const ImageSource& image_source) const = 0;
+    virtual bool hasImageBundleSubscribers() const = 0;
+    virtual bool hasLaserScanSubscribers() const = 0;
+    virtual bool hasStitchedImageSubscribers() const = 0;
+    virtual bool hasRawImageResponseSubscribers() const = 0;
+    virtual void publishLatencyDiagnostics(const diagnostic_msgs::msg::DiagnosticArray& diagnostics) = 0;
   };
 
   /**
@@ -65,12 +155,24 @@ class SpotImagePublisher {
    * SpotImagePublisher::MiddlewareHandle
    * @param has_arm A flag indicating if the Spot in use has an arm. Needed to generate image sources during
    * initialization.
+   * @param hand_camera_timer Timer of the dedicated hand camera stream. If null, the hand camera is always requested
+   * together with the body cameras.
+   * @param metrics_registry Records the failures, dropped images and stage durations of the image requests, in the
+   * `images` group.
+   * @param thread_pool Pool which runs the requests of the slower groups and of the hand camera stream.
    */
   SpotImagePublisher(const std::shared_ptr<ImageClientInterface>& image_client_interface,
                      std::unique_ptr<MiddlewareHandle> middleware_handle,
                      std::unique_ptr<ParameterInterfaceBase> parameters, std::unique_ptr<LoggerInterfaceBase> logger,
                      std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster,
-                     std::unique_ptr<TimerInterfaceBase> timer, bool has_arm = false);
+                     std::unique_ptr<TimerInterfaceBase> timer, bool has_arm = false,
+                     std::unique_ptr<TimerInterfaceBase> hand_camera_timer = nullptr,
+                     const std::shared_ptr<metrics::MetricsRegistry>& metrics_registry =
+                         metrics::MetricsRegistry::getDefault(),
+                     std::shared_ptr<ThreadPoolInterfaceBase> thread_pool = getSharedThreadPool());
+
+  /** @brief Clears the timers, stops the image stream, and waits for the requests in flight, if any. */
+  ~SpotImagePublisher();
 
   /**
    * @brief Connect to Spot and start publishing image data.
@@ -81,6 +183,33 @@ class SpotImagePublisher {
    */
   [[nodiscard]] bool initialize();
 
+  /**
+   * @brief Apply changes of the image sources, the RGB image quality and the camera rates without stopping the
+   * stream. Only valid after initialize() succeeded.
+   * @details The image request groups are created from the parameters again and swapped in between two requests: a
+   * request in flight finishes with the old groups, and the next one uses the new ones. Only the publishers of image
+   * sources which were added or removed are created or destroyed, so the topics of the other sources keep publishing
+   * without a gap. The timers are only set again if their rate changed.
+   *
+   * @param parameters Parameters to read the changes from. RclcppParameterInterface keeps the values it read first, so
+   * this has to be a new interface rather than the one this publisher was created with. It replaces that one if the
+   * changes are applied.
+   * @return True if the changes were applied. False if the changes decide whether the front images can be stitched,
+   * in which case this publisher is unchanged and a new one has to be initialized instead.
+   */
+  [[nodiscard]] bool updateImageSources(std::unique_ptr<ParameterInterfaceBase> parameters);
+
+  /**
+   * @brief Stop requesting images until resume() is called, and wait for the requests in flight. Only valid after
+   * initialize() succeeded.
+   * @details The timers keep running, but their ticks return without requesting images, and the stream thread waits.
+   * This lets a publisher which replaces this one start without both of them publishing at the same time.
+   */
+  void pause();
+
+  /** @brief Request images again after pause(). */
+  void resume();
+
  private:
   /**
    * @brief Callback function which is called through timer_interface_.
@@ -89,11 +218,323 @@ class SpotImagePublisher {
   void timerCallback(bool uncompress_images, bool publish_compressed_images);
 
   /**
-   * @brief Image request message which is set when SpotImagePublisher::initialize() is called.
-   * @details This is generated only once and then cached because the configuration of which cameras to request images
-   * from, what quality to use, etc., does not dynamically change while the driver is running.
+   * @brief Request and publish the images of every group which is due on the next tick. The caller holds
+   * request_groups_mutex_.
+   * @details The fastest group is requested on the calling thread. The slower groups are requested on thread_pool_, so
+   * that a slow request never delays the fastest group, and are skipped while their previous request is in flight.
+   *
+   * @return Number of image requests which were sent.
+   */
+  std::size_t requestDueGroups(bool uncompress_images, bool publish_compressed_images);
+
+  /**
+   * @brief Body of the stream thread, which requests the due groups back to back until the publisher is destroyed.
+   * @details Each frame is published as soon as Spot returns it instead of on the next timer tick. Combined with more
+   * than one image request in flight, Spot always has the next request queued when it finishes the previous one.
+   */
+  void streamImages(bool uncompress_images, bool publish_compressed_images);
+
+  /**
+   * @brief Remove the images, point clouds and latencies of every image source whose image is not newer than the last
+   * one that was published, and remember the stamps of the newer ones.
+   * @details Requests which are sent back to back can be faster than the cameras, in which case Spot returns the same
+   * frame again.
+   *
+   * @param result Images returned by Spot.
+   */
+  void dropRepeatedImages(GetImagesResult& result);
+
+  /** @brief Wait for the background requests of the slower groups. The caller holds request_groups_mutex_. */
+  void waitForGroupRequests();
+
+  /**
+   * @brief Request and publish the images of every group once, including the hand camera group, before the timers and
+   * the stream thread start.
+   * @details Every source is requested regardless of its subscribers, so that the decoders, the buffers of the message
+   * pool and the history of the publishers are all allocated by these first responses instead of by the first periodic
+   * frames. Failed requests are logged and do not stop the publisher from starting.
+   */
+  void warmUp(bool uncompress_images, bool publish_compressed_images);
+
+  /**
+   * @brief Callback function which is called through hand_camera_timer_.
+   * @details Posts a request for the hand camera images to thread_pool_, unless the previous one is still in flight, so
+   * that a slow high-resolution request never delays the body cameras or queues up behind itself.
+   */
+  void handCameraTimerCallback(bool uncompress_images, bool publish_compressed_images);
+
+  /**
+   * @brief Request images from Spot, and then publish the images and static camera transforms.
+   * @details This is safe to call from several threads at once for different groups. Only the publishing is
+   * serialized. If the group adapts its JPEG quality, its request is updated from the response for the next call, and
+   * the bandwidth budget, if any, updates the size estimates of the sources.
+   *
+   * @param group Image request group which the request belongs to.
+   * @param request Image request to send, which is the request of the group or a subset of it.
+   */
+  void requestAndPublishImages(ImageRequestGroup& group, const ::bosdyn::api::GetImageRequest& request,
+                               bool uncompress_images, bool publish_compressed_images);
+
+  /** @brief An image request for a group of image sources which are all polled at the same rate. */
+  struct ImageRequestGroup {
+    /** @brief Image request message covering every image source in the group. */
+    ::bosdyn::api::GetImageRequest request;
+    /** @brief Rate of the group divided by the rate of the timer, which is 1 for the fastest group. */
+    double requests_per_tick;
+    /** @brief Image source of each entry in request.image_requests(), in the same order. */
+    std::vector<ImageSource> sources;
+    /** @brief Which of the sources were requested the last time the group was filtered by subscriber count. */
+    std::vector<bool> subscribed;
+    /** @brief Image request message covering only the subscribed sources. */
+    ::bosdyn::api::GetImageRequest subscribed_request;
+    /** @brief If set, adapts the JPEG quality of the RGB sources in request to the link throughput. */
+    std::optional<JpegQualityController> quality_controller;
+    /** @brief Image request message covering only the sources which were admitted by the bandwidth budget. */
+    ::bosdyn::api::GetImageRequest budgeted_request;
+    /** @brief Image request message which is sent while the link is degraded. */
+    ::bosdyn::api::GetImageRequest degraded_request;
+    /**
+     * @brief Gains requests_per_tick on every tick, and the group is requested whenever it reaches one request. It
+     * starts at one, so that every group is requested on the first tick.
+     */
+    double request_credit{1.0};
+    /** @brief Becomes ready once the request of a slower group which was posted to the thread pool finished, if any. */
+    std::future<void> request_in_flight;
+  };
+
+  /** @brief Image sources and image request groups created from the parameters. */
+  struct ImageRequestPlan {
+    std::set<ImageSource> sources;
+    /** @brief Groups of the body cameras, ordered from the fastest to the slowest rate. */
+    std::vector<ImageRequestGroup> groups;
+    std::optional<ImageRequestGroup> hand_camera_group;
+    /** @brief Period of the body camera timer, which runs at the rate of the fastest group. */
+    std::chrono::duration<double> timer_period{0.0};
+    /** @brief Period of the hand camera timer, which is zero unless hand_camera_group is set. */
+    std::chrono::duration<double> hand_camera_period{0.0};
+    /** @brief Budget shared by the sources of all groups, which is only set if image_bandwidth_budget is positive. */
+    std::optional<BandwidthBudget> bandwidth_budget;
+  };
+
+  /**
+   * @brief Create the image sources and image request groups from the camera, image type, quality and rate
+   * parameters.
+   * @details Invalid parameters are logged and replaced by their defaults.
+   *
+   * @param parameters Parameters to read, which are parameters_ unless updateImageSources() reads new ones.
+   */
+  ImageRequestPlan createImageRequestPlan(const ParameterInterfaceBase& parameters);
+
+  /**
+   * @brief Create the publishers of the image sources with the publishing options of initialize(), keeping the
+   * existing publishers of sources which are still published.
+   */
+  void createPublishers(const std::set<ImageSource>& sources);
+
+  /**
+   * @brief Create a preview of each image and publish the previews.
+   * @details Images for which a preview could not be created are skipped and logged.
+   *
+   * @param images Full-resolution images to create the previews from.
+   */
+  void publishPreviewImages(const std::vector<std::pair<ImageSource, ImageWithCameraInfo>>& images);
+
+  /**
+   * @brief Publish the images of one request together as a single bundle, if the bundle has subscribers.
+   * @details The images are copied into the bundle, since they are also published on their own topics. The camera
+   * transforms of the bundle are kept from the last responses which carried them, so that every bundle has them.
+   *
+   * @param images Images and camera infos of the request.
+   * @param compressed_images Compressed images and camera infos of the request.
+   * @param transforms Camera transforms of the request, which are empty unless they were refreshed.
+   */
+  void publishImageBundle(const std::vector<std::pair<ImageSource, ImageWithCameraInfo>>& images,
+                          const std::vector<std::pair<ImageSource, CompressedImageWithCameraInfo>>& compressed_images,
+                          const std::vector<geometry_msgs::msg::TransformStamped>& transforms);
+
+  /**
+   * @brief Stitch the frontleft and frontright images of one request and publish the stitched image, if it has
+   * subscribers.
+   * @details The transforms from the body frame to both cameras are taken from the same response. The transform of
+   * the virtual camera is broadcast once, after the first images were stitched.
+   *
+   * @param result Images returned by Spot, which have not been published yet.
+   */
+  void publishStitchedImage(const GetImagesResult& result);
+
+  /**
+   * @brief Get the image request for a group which only covers the image sources that currently have subscribers.
+   * @details The filtered request is cached, and is only rebuilt when the set of subscribed sources changes.
+   *
+   * @param group Image request group to filter.
+   * @return The filtered image request, which may contain no image requests.
+   */
+  const ::bosdyn::api::GetImageRequest& getSubscribedRequest(ImageRequestGroup& group);
+
+  /**
+   * @brief Get the image request to send for a group, which only covers the subscribed sources if images are
+   * requested on demand, and only the sources admitted by the bandwidth budget if there is one.
+   * @details The sources which the group wants are passed on to the budget before it is allocated, so that sources
+   * without subscribers leave their share of the budget to the others. While the link is degraded, the request is
+   * passed through getDegradedRequest().
+   *
+   * @param group Image request group to get the request of.
+   * @return The image request, which may contain no image requests.
+   */
+  const ::bosdyn::api::GetImageRequest& getRequest(ImageRequestGroup& group);
+
+  /**
+   * @brief Get the image request to send for a group while the link is degraded, which leaves out the depth sources
+   * and lowers the quality of the JPEG images to degraded_rgb_image_quality_.
+   *
+   * @param group Image request group, whose degraded_request is rebuilt.
+   * @param request Image request which would be sent over a good link.
+   * @return The degraded image request, which may contain no image requests.
+   */
+  const ::bosdyn::api::GetImageRequest& getDegradedRequest(ImageRequestGroup& group,
+                                                           const ::bosdyn::api::GetImageRequest& request);
+
+  /**
+   * @brief Read the quality of the link from link_monitor_, and log when it changes.
+   *
+   * @return True if the link is degraded.
+   */
+  bool updateLinkDegraded();
+
+  /**
+   * @brief Record the latencies of a batch of published images, and publish the collected statistics as diagnostics
+   * once the report period has elapsed.
+   *
+   * @param latencies Latencies of the images in the batch, without the publish stage.
+   * @param publish_duration Time it took to publish the whole batch, which is attributed to each of its images.
+   */
+  void recordLatencies(std::vector<std::pair<ImageSource, ImageLatency>>& latencies,
+                       std::chrono::steady_clock::duration publish_duration);
+
+  /**
+   * @brief Image request messages which are set when SpotImagePublisher::initialize() is called, ordered from the
+   * fastest to the slowest rate.
+   * @details These are cached, and only created again when updateImageSources() is called. Guarded by
+   * request_groups_mutex_.
+   */
+  std::vector<ImageRequestGroup> image_request_groups_;
+
+  /**
+   * @brief Image request of the dedicated hand camera stream, which is set when SpotImagePublisher::initialize() is
+   * called and the stream is enabled. The hand camera sources are then not part of image_request_groups_. Guarded by
+   * hand_camera_mutex_, and only replaced while request_groups_mutex_ is held as well.
+   */
+  std::optional<ImageRequestGroup> hand_camera_group_;
+
+  /**
+   * @brief Budget which decides which sources of the body camera and hand camera requests are sent, and at which
+   * quality. Set from the parameters together with the groups. Guarded by bandwidth_budget_mutex_, since both
+   * requests use it.
+   */
+  std::optional<BandwidthBudget> bandwidth_budget_;
+
+  /** @brief Period of the body camera timer. Set when SpotImagePublisher::initialize() is called. */
+  std::chrono::duration<double> timer_period_{0.0};
+
+  /** @brief Period of the hand camera timer, which is zero unless hand_camera_group_ is set. */
+  std::chrono::duration<double> hand_camera_period_{0.0};
+
+  /**
+   * @brief If true, the previous timer callback took longer than the timer period, so the tick which became due while
+   * it was still running is skipped instead of immediately requesting images again.
    */
-  std::optional<::bosdyn::api::GetImageRequest> image_request_message_;
+  bool skip_next_tick_{false};
+
+  /** @brief If set, a reduced preview of every uncompressed image is also published. */
+  std::optional<ImagePreviewOptions> preview_options_;
+
+  /** @brief If true, only request images from sources that currently have subscribers. */
+  bool on_demand_images_{false};
+
+  /** @brief Monitor of the link to the robot, or nullptr if the publisher does not degrade on a poor link. */
+  std::shared_ptr<LinkMonitor> link_monitor_;
+  /** @brief Factor by which the image rates are lowered while the link is degraded. */
+  std::size_t degraded_rate_divisor_{1};
+  /** @brief Highest JPEG quality which is requested while the link is degraded. */
+  double degraded_rgb_image_quality_{100.0};
+  /** @brief True while the link is degraded. Read by the body camera and the hand camera requests. */
+  std::atomic<bool> link_degraded_{false};
+  /**
+   * @brief Number of hand camera timer ticks. While the link is degraded, only every degraded_rate_divisor_-th tick
+   * requests images. Guarded by hand_camera_mutex_.
+   */
+  std::size_t hand_camera_ticks_{0};
+
+  /** @brief If true, the body cameras are requested back to back on stream_thread_ instead of on timer_. */
+  bool stream_images_{false};
+
+  /** @brief Stamp of the last published image of every image source, indexed by toImageSourceIndex(). */
+  std::array<builtin_interfaces::msg::Time, kNumImageSources> last_image_stamps_{};
+
+  /** @brief Stamp of the last published laser scan. */
+  builtin_interfaces::msg::Time last_laser_scan_stamp_{};
+
+  /**
+   * @brief If set, the frontleft and frontright images of every request are stitched into the image of a virtual camera
+   * between them. Set when SpotImagePublisher::initialize() is called.
+   */
+  std::unique_ptr<FrontImageStitcher> front_stitcher_;
+
+  /** @brief If true, the transform of the virtual camera was broadcast. */
+  bool virtual_camera_transform_sent_{false};
+
+  /** @brief If true, the images of each request are also published together as one bundle. */
+  bool publish_image_bundle_{false};
+
+  /** @brief If true, the serialized GetImageResponse of every request is published on `image_responses/raw`. */
+  bool publish_raw_protobuf_{false};
+
+  /** @brief Latest transform of each camera, which is added to every image bundle. */
+  std::vector<geometry_msgs::msg::TransformStamped> image_bundle_transforms_;
+
+  /** @brief Options used to request and convert images. Set when SpotImagePublisher::initialize() is called. */
+  GetImagesOptions get_images_options_;
+
+  /** @brief Image messages which were published and whose data buffers are reused for the next images. */
+  std::shared_ptr<ImageMessagePool> message_pool_{std::make_shared<ImageMessagePool>()};
+
+  /** @brief Latencies of the images published since the last diagnostics report. */
+  ImageLatencyStatistics latency_statistics_;
+
+  /** @brief Serializes publishing between the body camera timer and the hand camera stream. */
+  std::mutex publish_mutex_;
+
+  /** @brief Held while the body camera groups are requested, and while updateImageSources() replaces them. */
+  std::mutex request_groups_mutex_;
+
+  /** @brief Held while a hand camera request is started, and while updateImageSources() replaces its group. */
+  std::mutex hand_camera_mutex_;
+
+  /** @brief Held while bandwidth_budget_ is used by either request, and while updateImageSources() replaces it. */
+  std::mutex bandwidth_budget_mutex_;
+
+  /**
+   * @brief Set while updateImageSources() waits for request_groups_mutex_ and swaps the groups, so that the stream
+   * thread, which requests the groups back to back, lets it in.
+   */
+  std::atomic<bool> update_pending_{false};
+
+  /** @brief Set by pause(), so that the ticks and the stream thread do not request images. */
+  std::atomic<bool> paused_{false};
+
+  /**
+   * @brief Notified by updateImageSources() once it swapped the groups, by resume() and by the destructor. The stream
+   * thread waits on it meanwhile.
+   */
+  std::condition_variable stream_resumed_;
+
+  /** @brief Publishing options which are set when SpotImagePublisher::initialize() is called. */
+  bool uncompress_images_{false};
+  bool publish_compressed_images_{false};
+  std::string stitched_camera_;
+
+  /** @brief Time of the last diagnostics report. The first report is published after the first batch of images. */
+  std::chrono::steady_clock::time_point last_latency_report_;
 
   // Interface classes to interact with Spot and the middleware.
   std::shared_ptr<ImageClientInterface> image_client_interface_;
@@ -103,7 +544,27 @@ class SpotImagePublisher {
   std::unique_ptr<LoggerInterfaceBase> logger_;
   std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_;
   std::unique_ptr<TimerInterfaceBase> timer_;
+  std::unique_ptr<TimerInterfaceBase> hand_camera_timer_;
+  std::shared_ptr<ThreadPoolInterfaceBase> thread_pool_;
 
   bool has_arm_;
+
+  /** @brief Registry which owns the metrics below. */
+  std::shared_ptr<metrics::MetricsRegistry> metrics_registry_;
+  metrics::Counter& rpc_failures_;
+  metrics::Counter& stale_images_dropped_;
+  metrics::Histogram& rpc_latency_;
+  /** @brief Time spent converting and decoding the responses of one request, i.e. getImages() without the RPC. */
+  metrics::Histogram& decode_time_;
+  metrics::Histogram& publish_time_;
+
+  /** @brief Becomes ready once the hand camera request which was posted to the thread pool finished, if any. */
+  std::future<void> hand_camera_request_;
+
+  /** @brief Set by the destructor to stop stream_thread_, and so that running ticks do not start new requests. */
+  std::atomic<bool> stopping_{false};
+
+  /** @brief Thread which requests the body cameras when images are streamed. Joined by the destructor. */
+  std::thread stream_thread_;
 };
 }  // namespace spot_ros2::images
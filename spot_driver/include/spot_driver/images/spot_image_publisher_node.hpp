@@ -2,9 +2,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <rclcpp/callback_group.hpp>
+#include <rclcpp/node.hpp>
 #include <rclcpp/node_interfaces/node_base_interface.hpp>
 #include <rclcpp/node_options.hpp>
+#include <rclcpp/parameter_event_handler.hpp>
+#include <shared_mutex>
 #include <spot_driver/api/spot_api.hpp>
 #include <spot_driver/images/spot_image_publisher.hpp>
 #include <spot_driver/interfaces/logger_interface_base.hpp>
@@ -12,10 +17,16 @@
 #include <spot_driver/interfaces/parameter_interface_base.hpp>
 #include <spot_driver/interfaces/tf_broadcaster_interface_base.hpp>
 #include <spot_driver/interfaces/timer_interface_base.hpp>
+#include <spot_driver/metrics/metrics_publisher.hpp>
 
 namespace spot_ros2::images {
 /**
  * @brief Wraps SpotImagePublisher to allow using it like a rclcpp::Node.
+ * @details When created with the rclcpp constructor, changes of the image sources, their quality and their rates are
+ * applied by SpotImagePublisher::updateImageSources() without interrupting the other sources. A change of any other
+ * parameter of the node replaces the SpotImagePublisher, which reads the parameters again and recreates the image
+ * requests, publishers and timers. The connection to Spot is kept, so this takes effect without creating,
+ * authenticating and time syncing the robot again.
  */
 class SpotImagePublisherNode {
  public:
@@ -42,10 +53,57 @@ class SpotImagePublisherNode {
   void initialize(std::unique_ptr<SpotApi> spot_api, std::unique_ptr<SpotImagePublisher::MiddlewareHandle> mw_handle,
                   std::unique_ptr<ParameterInterfaceBase> parameters, std::unique_ptr<LoggerInterfaceBase> logger,
                   std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster,
-                  std::unique_ptr<TimerInterfaceBase> timer);
+                  std::unique_ptr<TimerInterfaceBase> timer,
+                  std::unique_ptr<TimerInterfaceBase> hand_camera_timer = nullptr);
+
+  /**
+   * @brief Create and initialize a SpotImagePublisher with the connection of spot_api_.
+   * @return The initialized publisher.
+   * @throw std::runtime_error if the image client is not available or the publisher fails to initialize.
+   */
+  std::unique_ptr<SpotImagePublisher> createPublisher(std::unique_ptr<SpotImagePublisher::MiddlewareHandle> mw_handle,
+                                                      std::unique_ptr<ParameterInterfaceBase> parameters,
+                                                      std::unique_ptr<LoggerInterfaceBase> logger,
+                                                      std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster,
+                                                      std::unique_ptr<TimerInterfaceBase> timer,
+                                                      std::unique_ptr<TimerInterfaceBase> hand_camera_timer);
+
+  /**
+   * @brief Replace the SpotImagePublisher with one that uses the current parameters. Only used with node_.
+   * @details The current publisher is paused while the new one starts, and resumed if the new one fails to start.
+   */
+  void reconfigure();
+
+  /**
+   * @brief Create a timer of node_ whose callbacks are skipped once the SpotImagePublisher that set it is replaced.
+   * @param callback_group Callback group of the timer.
+   * @param enabled Flag of the SpotImagePublisher the timer is for, which is cleared before it is replaced.
+   */
+  std::unique_ptr<TimerInterfaceBase> createTimer(const rclcpp::CallbackGroup::SharedPtr& callback_group,
+                                                  const std::shared_ptr<std::atomic_bool>& enabled);
 
   std::unique_ptr<NodeInterfaceBase> node_base_interface_;
   std::unique_ptr<SpotApi> spot_api_;
+  bool has_arm_ = false;
+
+  /** @brief Node of the rclcpp constructor, and the members which are needed to reconfigure it. */
+  std::shared_ptr<rclcpp::Node> node_;
+  rclcpp::CallbackGroup::SharedPtr timer_group_;
+  rclcpp::CallbackGroup::SharedPtr hand_camera_timer_group_;
+  std::shared_ptr<rclcpp::ParameterEventHandler> parameter_event_handler_;
+  std::shared_ptr<rclcpp::ParameterEventCallbackHandle> parameter_event_callback_;
+  rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr set_parameters_callback_;
+  /**
+   * @brief Held shared by every timer callback while it runs, and exclusively while the publisher is replaced. The
+   * timers run in their own callback groups, so they may run on other threads than the parameter event callback.
+   */
+  std::shared_ptr<std::shared_mutex> timer_callback_mutex_ = std::make_shared<std::shared_mutex>();
+  /** @brief Whether the timers of the current publisher may call it, which is cleared before it is replaced. */
+  std::shared_ptr<std::atomic_bool> timers_enabled_ = std::make_shared<std::atomic_bool>(true);
+  /** @brief Registry of the robot of this node, which keeps its metrics apart from those of other robots. */
+  std::shared_ptr<metrics::MetricsRegistry> metrics_registry_ = metrics::MetricsRegistry::getDefault();
+  /** @brief Publishes the metrics of this node. Only created by the rclcpp constructor. */
+  std::unique_ptr<metrics::MetricsPublisher> metrics_publisher_;
   std::unique_ptr<SpotImagePublisher> internal_;
 };
 }  // namespace spot_ros2::images
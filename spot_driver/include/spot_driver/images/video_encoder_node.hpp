@@ -0,0 +1,60 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <rclcpp/node.hpp>
+#include <rclcpp/node_interfaces/node_base_interface.hpp>
+#include <rclcpp/publisher.hpp>
+#include <rclcpp/subscription.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/conversions/video_encoder.hpp>
+#include <spot_msgs/msg/compressed_video.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spot_ros2::images {
+/**
+ * @brief Encodes image topics into H.264 or H.265 video streams, which need a fraction of the bandwidth of per-frame
+ * JPEG images, e.g. to teleoperate Spot over a cellular link.
+ * @details Every topic of `video_sources`, e.g. `camera/frontleft/image` or the `virtual_camera/image` of the image
+ * stitcher, is encoded to a spot_msgs/CompressedVideo topic next to it, e.g. `camera/frontleft/video`. Images are only
+ * encoded while the video topic has subscribers, and a keyframe is encoded whenever a subscriber joins, so that it can
+ * start decoding right away. When the node is composed into the driver container with intra-process communication, the
+ * images are handed to it without being copied.
+ *
+ * The node reads the parameters:
+ * - `video_sources`: Image topics to encode, relative to the namespace of the node.
+ * - `video_codec`: Either "h264" or "h265".
+ * - `video_encoder_backend`: One of "auto", "nvenc", "vaapi" or "software". "auto" tries NVENC, then VA-API, then
+ *   x264 or x265.
+ * - `video_bit_rate`: Target bit rate of each stream in bits per second.
+ * - `video_frame_rate`: Nominal frame rate of the images, which the rate control is based on.
+ * - `video_keyframe_interval`: Number of frames from one keyframe to the next.
+ */
+class VideoEncoderNode {
+ public:
+  explicit VideoEncoderNode(const rclcpp::NodeOptions& options = rclcpp::NodeOptions{});
+
+  std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> get_node_base_interface();
+
+ private:
+  /** @brief Encoder and topics of one image topic. */
+  struct VideoStream {
+    std::string image_topic;
+    rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr subscription;
+    rclcpp::Publisher<spot_msgs::msg::CompressedVideo>::SharedPtr publisher;
+    /** @brief Encoder, which is opened by the first image, since the size of the images is not known before. */
+    std::unique_ptr<VideoEncoder> encoder;
+    std::size_t subscriber_count{0};
+  };
+
+  void onImage(VideoStream& stream, const sensor_msgs::msg::Image& image);
+
+  std::shared_ptr<rclcpp::Node> node_;
+  VideoEncoderOptions options_;
+  std::vector<std::unique_ptr<VideoStream>> streams_;
+};
+}  // namespace spot_ros2::images
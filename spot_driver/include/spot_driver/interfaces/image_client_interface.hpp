@@ -3,20 +3,159 @@
 #pragma once
 
 #include <builtin_interfaces/msg/time.hpp>
+#include <geometry_msgs/msg/transform.hpp>
 #include <geometry_msgs/msg/transform_stamped.hpp>
+#include <sensor_msgs/msg/laser_scan.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <spot_driver/api/image_message_pool.hpp>
 #include <spot_driver/api/spot_image_sources.hpp>
+#include <spot_driver/conversions/compressed_depth.hpp>
+#include <spot_driver/conversions/depth_filter.hpp>
+#include <spot_driver/conversions/depth_laser_scan.hpp>
+#include <spot_driver/conversions/depth_point_cloud.hpp>
+#include <spot_driver/conversions/jpeg_decoder.hpp>
 #include <spot_driver/types.hpp>
 #include <tl_expected/expected.hpp>
 
-#include <map>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace spot_ros2 {
 
+/** @brief Options that control how images are requested from Spot and converted into ROS messages. */
+struct GetImagesOptions {
+  /**
+   * @brief Maximum number of identical image requests kept outstanding with Spot. A value of 1 sends a request and
+   * waits for its response. Larger values send the following requests ahead of time, so that they are already being
+   * served while the current response is converted, at the cost of returning images that were captured earlier.
+   */
+  std::size_t max_requests_in_flight{1};
+
+  /**
+   * @brief Time after which an image request is cancelled, so that a lost response does not stall the image stream.
+   * A value of zero or less keeps the default timeout of the Spot SDK.
+   */
+  std::chrono::duration<double> timeout{0.0};
+
+  /**
+   * @brief Maximum number of threads, taken from the shared thread pool, used to convert the image responses
+   * concurrently. A value of 1 converts the responses sequentially on the calling thread.
+   */
+  std::size_t max_decode_threads{1};
+
+  /** @brief Library used to decode JPEG-compressed images. */
+  JpegDecoderBackend jpeg_decoder{JpegDecoderBackend::OPENCV};
+
+  /**
+   * @brief Encoding which the JPEG-compressed color images of every camera are decoded into, indexed by SpotCamera.
+   * Greyscale images are always decoded into mono8.
+   */
+  std::array<JpegOutputEncoding, kNumSpotCameras> color_image_encodings{};
+
+  /**
+   * @brief Static transforms to the image frames are only returned until they have been returned once. After this
+   * period has passed they are returned again. A period of zero or less never returns them again.
+   */
+  std::chrono::duration<double> static_transforms_refresh_period{0.0};
+
+  /** @brief If set, a point cloud is also created from every depth image, using these options. */
+  std::optional<PointCloudOptions> point_clouds;
+
+  /**
+   * @brief If set, every depth image is also compressed losslessly in this format. The depth images are compressed by
+   * the same workers which convert them, right after they are decoded.
+   */
+  std::optional<CompressedDepthFormat> compressed_depth;
+
+  /**
+   * @brief If set, every depth image is also filtered into a smaller depth image, using these options. Like the
+   * compressed depth images, they are filtered by the workers which convert them.
+   */
+  std::optional<DepthFilterOptions> depth_filter;
+
+  /**
+   * @brief If set, the depth images of the body cameras are also merged into one planar scan in the body frame, using
+   * these options. The hand camera is left out, since it moves with the arm.
+   */
+  std::optional<LaserScanOptions> laser_scan;
+
+  /**
+   * @brief The transform from the body frame to the camera of every image of these sources is also returned in
+   * GetImagesResult::body_transforms_. It is resolved from the transforms snapshot of the response.
+   */
+  std::set<ImageSource> body_transform_sources;
+
+  /** @brief If set, the image messages are taken from this pool, so that their data buffers are reused. */
+  std::shared_ptr<ImageMessagePool> message_pool;
+
+  /** @brief If true, measure the latency of every image and return it in GetImagesResult::latencies_. */
+  bool measure_latency{false};
+
+  /**
+   * @brief Images which were acquired longer than this ago when their response arrived are dropped without being
+   * converted. A value of zero or less keeps every image.
+   */
+  std::chrono::duration<double> max_image_age{0.0};
+  /** @brief If true, the response is also returned serialized in GetImagesResult::raw_response_. */
+  bool keep_raw_response{false};
+  /**
+   * @brief If false, the image responses are not converted into ROS messages at all, e.g. because only the raw response
+   * is published. Only the raw response, the response sizes and the request duration are returned then.
+   */
+  bool convert_images{true};
+};
+
+/** @brief Time an image spent in each stage before it was published. */
+struct ImageLatency {
+  /** @brief Seconds from the acquisition of the image on the robot until its response arrived, corrected for the clock
+   * skew. */
+  double robot_to_host{0.0};
+
+  /** @brief Seconds spent converting the response into ROS messages, including decoding the image. */
+  double decode{0.0};
+
+  /** @brief Seconds spent handing the messages to the middleware. This is set by the publisher. */
+  double publish{0.0};
+
+  /** @brief Local time at which the response arrived, which the publisher uses to compute the total latency. */
+  std::chrono::steady_clock::time_point response_time;
+};
+
+/**
+ * @brief Messages converted from a single GetImageRequest.
+ * @details The messages are stored in flat vectors in the order of the image responses, with at most one entry per
+ * image source, so that they can be handed to the publishers without building or searching a map.
+ */
 struct GetImagesResult {
-  std::map<ImageSource, ImageWithCameraInfo> images_;
-  std::map<ImageSource, CompressedImageWithCameraInfo> compressed_images_;
+  std::vector<std::pair<ImageSource, ImageWithCameraInfo>> images_;
+  std::vector<std::pair<ImageSource, CompressedImageWithCameraInfo>> compressed_images_;
+  std::vector<std::pair<ImageSource, sensor_msgs::msg::PointCloud2>> point_clouds_;
+  /** @brief Compressed depth images, if GetImagesOptions::compressed_depth is set. */
+  std::vector<std::pair<ImageSource, sensor_msgs::msg::CompressedImage>> compressed_depth_images_;
+  /** @brief Filtered depth images with their CameraInfo, if GetImagesOptions::depth_filter is set. */
+  std::vector<std::pair<ImageSource, ImageWithCameraInfo>> filtered_depth_images_;
+  /** @brief Scan merged from the depth images of the body cameras, if GetImagesOptions::laser_scan is set and the
+   * response had any. */
+  std::optional<sensor_msgs::msg::LaserScan> laser_scan_;
+  /** @brief body_tform_camera of the images whose sources are in GetImagesOptions::body_transform_sources. */
+  std::vector<std::pair<ImageSource, geometry_msgs::msg::Transform>> body_transforms_;
+  std::vector<std::pair<ImageSource, ImageLatency>> latencies_;
+  /** @brief Size of the image data of each response, in bytes, as it was sent by Spot. */
+  std::vector<std::pair<ImageSource, std::size_t>> response_sizes_;
+  /** @brief Time from sending the request until the response arrived. */
+  std::chrono::duration<double> request_duration_{0.0};
+  /** @brief Number of images which were dropped because they were older than GetImagesOptions::max_image_age. */
+  std::size_t stale_images_dropped_{0};
+  /** @brief Serialized GetImageResponse as Spot sent it, if GetImagesOptions::keep_raw_response is set. */
+  std::vector<std::uint8_t> raw_response_;
   std::vector<geometry_msgs::msg::TransformStamped> transforms_;
 };
 
@@ -32,8 +171,19 @@ class ImageClientInterface {
   ImageClientInterface& operator=(ImageClientInterface&& other) = default;
   ImageClientInterface& operator=(const ImageClientInterface&) = delete;
   virtual ~ImageClientInterface() = default;
+
+  /**
+   * @brief Request images from Spot and convert them into ROS messages.
+   *
+   * @param request Image request to send to Spot.
+   * @param uncompress_images If true, decode JPEG images into uncompressed ROS Image messages.
+   * @param publish_compressed_images If true, convert JPEG images into ROS CompressedImage messages.
+   * @param options Options that control how the images are requested and converted.
+   * @return The converted images and the static transforms to any image frames that were not returned recently, or an
+   * error message if the request or conversion failed.
+   */
   virtual tl::expected<GetImagesResult, std::string> getImages(::bosdyn::api::GetImageRequest request,
-                                                               bool uncompress_images,
-                                                               bool publish_compressed_images) = 0;
+                                                               bool uncompress_images, bool publish_compressed_images,
+                                                               const GetImagesOptions& options) = 0;
 };
 }  // namespace spot_ros2
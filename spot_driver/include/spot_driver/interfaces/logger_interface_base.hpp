@@ -2,11 +2,26 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 
 namespace spot_ros2 {
+/** @brief Severity levels of LoggerInterfaceBase. */
+enum class LogLevel { kDebug, kInfo, kWarn, kError, kFatal };
+
 /**
  * @brief Defines an interface for a class that logs messages at different severity levels.
+ * @details Besides the plain log methods, the interface offers throttled, once-only and deduplicated logging for
+ * messages from timer callbacks and stream loops, which would otherwise repeat the same failure every cycle, e.g. while
+ * the robot is out of WiFi range. These are implemented on top of the plain log methods, so they work with every
+ * logger. Each call site passes a key which identifies its messages, and messages which were held back are counted and
+ * reported with the next message of the same key.
  */
 class LoggerInterfaceBase {
  public:
@@ -24,5 +39,74 @@ class LoggerInterfaceBase {
   virtual void logWarn(const std::string& message) const = 0;
   virtual void logError(const std::string& message) const = 0;
   virtual void logFatal(const std::string& message) const = 0;
+
+  /**
+   * @brief Log a message at the given severity level.
+   *
+   * @param level Severity level of the message.
+   * @param message Message to log.
+   */
+  void log(LogLevel level, const std::string& message) const;
+
+  /**
+   * @brief Log a message at most once per period for each key. Messages within the period are dropped, and their
+   * number is appended to the next message of the key which is logged.
+   *
+   * @param level Severity level of the message.
+   * @param key Identifies the call site, so that unrelated messages are not throttled together.
+   * @param period Minimum time between two messages of the key.
+   * @param message Message to log.
+   */
+  void logThrottled(LogLevel level, std::string_view key, std::chrono::steady_clock::duration period,
+                    const std::string& message) const;
+
+  /**
+   * @brief Log a message only the first time this is called with the key. Later messages of the key are only counted,
+   * until the key is reset.
+   *
+   * @param level Severity level of the message.
+   * @param key Identifies the call site.
+   * @param message Message to log.
+   */
+  void logOnce(LogLevel level, std::string_view key, const std::string& message) const;
+
+  /**
+   * @brief Log a message unless it is the same as the last message logged with the key. Once a different message is
+   * logged with the key, it states how often the previous message was repeated.
+   *
+   * @param level Severity level of the message.
+   * @param key Identifies the call site.
+   * @param message Message to log.
+   */
+  void logDeduplicated(LogLevel level, std::string_view key, const std::string& message) const;
+
+  /**
+   * @brief Forget the messages of a key, so that its next message is logged right away. Call this once the condition
+   * which was logged has cleared. If messages of the key were held back, their number is logged at the info level.
+   *
+   * @param key Identifies the call site.
+   */
+  void resetLog(std::string_view key) const;
+
+ protected:
+  /** @brief Get the current time. Tests override this to control the time which throttled messages see. */
+  virtual std::chrono::steady_clock::time_point now() const;
+
+ private:
+  /** @brief What was logged for one key. */
+  struct KeyState {
+    std::chrono::steady_clock::time_point last_logged;
+    std::string last_message;
+    /** @brief Number of messages which were held back since the last message of the key was logged. */
+    std::size_t suppressed{0};
+  };
+
+  /** @brief State of all keys, which is kept behind a pointer so that loggers stay movable. */
+  struct SuppressionState {
+    std::mutex mutex;
+    std::map<std::string, KeyState, std::less<>> keys;
+  };
+
+  std::unique_ptr<SuppressionState> suppression_ = std::make_unique<SuppressionState>();
 };
 }  // namespace spot_ros2
@@ -3,14 +3,33 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <set>
 #include <string>
 #include <tl_expected/expected.hpp>
+#include <vector>
 
 #include <spot_driver/types.hpp>
 
 namespace spot_ros2 {
+/**
+ * @brief QoS settings for the publishers of one category of topics.
+ */
+struct PublisherQoSParameters {
+  /** @brief If true, publish with reliable delivery. If false, publish best-effort. */
+  bool reliable{true};
+  /** @brief If true, keep the last messages for late-joining subscribers. If false, use volatile durability. */
+  bool transient_local{true};
+  /** @brief History depth. If not set, each publisher uses its own default depth. */
+  std::optional<std::size_t> depth;
+  /** @brief Expected maximum period between messages. Zero means no deadline. */
+  std::chrono::duration<double> deadline{0.0};
+  /** @brief Maximum age of a message before it is no longer delivered. Zero means no limit. */
+  std::chrono::duration<double> lifespan{0.0};
+};
+
 /**
  * @brief Defines an interface for a class that retrieves the user-configured parameters needed to connect to Spot.
  */
@@ -40,14 +59,92 @@ class ParameterInterfaceBase {
   virtual bool getPublishCompressedImages() const = 0;
   virtual bool getPublishDepthImages() const = 0;
   virtual bool getPublishDepthRegisteredImages() const = 0;
+  virtual int getImageDecodeThreads() const = 0;
+  virtual std::string getJpegDecoder() const = 0;
+  virtual bool getRLEDepthImages() const = 0;
+  virtual double getCameraPublishRate(const spot_ros2::SpotCamera camera) const = 0;
+  virtual int getImageRequestsInFlight() const = 0;
+  virtual bool getOnDemandImages() const = 0;
+  virtual double getStaticTransformsRefreshPeriod() const = 0;
+  virtual int getImagePreviewScale() const = 0;
+  virtual std::vector<int64_t> getImagePreviewRegion() const = 0;
+  virtual bool getPublishDepthPointClouds() const = 0;
+  virtual double getPointCloudVoxelSize() const = 0;
+  virtual bool getPublishCompressedDepthImages() const = 0;
+  virtual std::string getCompressedDepthFormat() const = 0;
+  virtual bool getPublishFilteredDepthImages() const = 0;
+  virtual int getFilteredDepthDecimation() const = 0;
+  virtual bool getFilteredDepthFillHoles() const = 0;
+  virtual double getFilteredDepthMinRange() const = 0;
+  virtual double getFilteredDepthMaxRange() const = 0;
+  virtual bool getPublishLaserScan() const = 0;
+  virtual double getLaserScanMinHeight() const = 0;
+  virtual double getLaserScanMaxHeight() const = 0;
+  virtual double getLaserScanRangeMax() const = 0;
+  virtual double getLaserScanAngleIncrement() const = 0;
+  virtual bool getPublishStitchedFrontImage() const = 0;
+  virtual std::string getVirtualCameraFrame() const = 0;
+  virtual std::vector<double> getVirtualCameraIntrinsics() const = 0;
+  virtual std::vector<double> getVirtualCameraProjectionPlane() const = 0;
+  virtual double getVirtualCameraPlaneDistance() const = 0;
+  virtual int getStitchedImageRowPadding() const = 0;
+  virtual int getStitchedImageSeamUpdatePeriod() const = 0;
+  virtual std::string getStitchedImageBlendMode() const = 0;
+  virtual int getStitchedImageBlendWidth() const = 0;
+  virtual bool getStitchedImageUseGpu() const = 0;
+  virtual bool getPublishImageLatencyDiagnostics() const = 0;
+  virtual double getHandCameraStreamRate() const = 0;
+  virtual double getHandCameraStreamQuality() const = 0;
+  virtual double getHandCameraStreamResizeRatio() const = 0;
+  virtual bool getAdaptiveRGBImageQuality() const = 0;
+  virtual double getMinRGBImageQuality() const = 0;
+  virtual double getMaxImageAge() const = 0;
+  virtual double getImageBandwidthBudget() const = 0;
+  virtual int getCameraPriority(const spot_ros2::SpotCamera camera) const = 0;
+  virtual std::string getCameraImageEncoding(const spot_ros2::SpotCamera camera) const = 0;
+  virtual bool getColorizeRegisteredPointClouds() const = 0;
+  virtual bool getPublishImageBundle() const = 0;
+  virtual bool getStreamImages() const = 0;
+  virtual bool getWarmUpImages() const = 0;
+  virtual bool getStreamRobotState() const = 0;
+  virtual bool getLowLevelJointStates() const = 0;
+  virtual bool getPublishStatusOnChange() const = 0;
+  virtual double getStatusHeartbeatPeriod() const = 0;
+  virtual double getMetricsPublishPeriod() const = 0;
+  virtual std::string getMetricsTextfile() const = 0;
+  virtual bool getPublishRawProtobuf() const = 0;
+  virtual bool getRawProtobufOnly() const = 0;
+  virtual int getRobotStateHistorySize() const = 0;
+  virtual double getRobotStatePublishRate(const std::string& topic) const = 0;
   virtual std::string getPreferredOdomFrame() const = 0;
   virtual std::string getTFRoot() const = 0;
+  virtual double getObjectSyncTranslationThreshold() const = 0;
+  virtual double getObjectSyncRotationThreshold() const = 0;
+  virtual double getObjectSyncTfCacheDuration() const = 0;
+  virtual std::vector<std::string> getObjectSyncTfFrameAllowlist() const = 0;
+  virtual std::vector<std::string> getObjectSyncTfFrameDenylist() const = 0;
+  virtual double getObjectSyncWorldObjectTfRate() const = 0;
+  virtual std::string getThreadCpus(const std::string& thread_class) const = 0;
+  virtual int getIKCacheSize() const = 0;
+  virtual double getIKCachePositionTolerance() const = 0;
+  virtual double getIKCacheRotationTolerance() const = 0;
+  virtual std::string getRobotDescription() const = 0;
   virtual std::string getSpotName() const = 0;
   virtual bool getGripperless() const = 0;
   virtual std::set<spot_ros2::SpotCamera> getDefaultCamerasUsed(bool has_arm, bool gripperless) const = 0;
   virtual tl::expected<std::set<spot_ros2::SpotCamera>, std::string> getCamerasUsed(bool has_arm,
                                                                                     bool gripperless) const = 0;
   virtual std::chrono::seconds getTimeSyncTimeout() const = 0;
+  virtual double getImageRequestTimeout() const = 0;
+  virtual double getRobotStateRequestTimeout() const = 0;
+  virtual double getWorldObjectRequestTimeout() const = 0;
+  virtual double getKinematicRequestTimeout() const = 0;
+  virtual bool getDegradeOnPoorLink() const = 0;
+  virtual double getLinkDegradedLatency() const = 0;
+  virtual double getLinkDegradedFailureRate() const = 0;
+  virtual int getDegradedRateDivisor() const = 0;
+  virtual double getDegradedRGBImageQuality() const = 0;
+  virtual tl::expected<PublisherQoSParameters, std::string> getPublisherQoS(const std::string& category) const = 0;
 
  protected:
   // These are the definitions of the default values for optional parameters.
@@ -61,11 +158,87 @@ class ParameterInterfaceBase {
   static constexpr bool kDefaultPublishCompressedImages{false};
   static constexpr bool kDefaultPublishDepthImages{true};
   static constexpr bool kDefaultPublishDepthRegisteredImages{true};
+  static constexpr int kDefaultImageDecodeThreads{1};
+  static constexpr auto kDefaultJpegDecoder = "opencv";
+  static constexpr bool kDefaultRLEDepthImages{false};
+  static constexpr double kDefaultCameraPublishRate{15.0};
+  static constexpr int kDefaultImageRequestsInFlight{1};
+  static constexpr bool kDefaultOnDemandImages{false};
+  static constexpr double kDefaultStaticTransformsRefreshPeriod{0.0};
+  static constexpr int kDefaultImagePreviewScale{1};
+  static constexpr bool kDefaultPublishDepthPointClouds{false};
+  static constexpr double kDefaultPointCloudVoxelSize{0.0};
+  static constexpr bool kDefaultPublishCompressedDepthImages{false};
+  static constexpr auto kDefaultCompressedDepthFormat = "png";
+  static constexpr bool kDefaultPublishFilteredDepthImages{false};
+  static constexpr int kDefaultFilteredDepthDecimation{2};
+  static constexpr bool kDefaultFilteredDepthFillHoles{true};
+  static constexpr double kDefaultFilteredDepthMinRange{0.0};
+  static constexpr double kDefaultFilteredDepthMaxRange{0.0};
+  static constexpr bool kDefaultPublishLaserScan{false};
+  static constexpr double kDefaultLaserScanMinHeight{-0.3};
+  static constexpr double kDefaultLaserScanMaxHeight{0.3};
+  static constexpr double kDefaultLaserScanRangeMax{4.0};
+  static constexpr double kDefaultLaserScanAngleIncrement{0.00872665};
+  static constexpr bool kDefaultPublishStitchedFrontImage{false};
+  static constexpr auto kDefaultVirtualCameraFrame = "frontmiddle_virtual";
+  static constexpr double kDefaultVirtualCameraPlaneDistance{1.0};
+  static constexpr int kDefaultStitchedImageRowPadding{0};
+  static constexpr int kDefaultStitchedImageSeamUpdatePeriod{1};
+  static constexpr auto kDefaultStitchedImageBlendMode = "multiband";
+  static constexpr int kDefaultStitchedImageBlendWidth{50};
+  static constexpr bool kDefaultStitchedImageUseGpu{true};
+  static constexpr bool kDefaultPublishImageLatencyDiagnostics{false};
+  static constexpr double kDefaultHandCameraStreamRate{0.0};
+  static constexpr double kDefaultHandCameraStreamQuality{100.0};
+  static constexpr double kDefaultHandCameraStreamResizeRatio{1.0};
+  static constexpr bool kDefaultAdaptiveRGBImageQuality{false};
+  static constexpr double kDefaultMinRGBImageQuality{30.0};
+  static constexpr double kDefaultMaxImageAge{0.0};
+  static constexpr double kDefaultImageBandwidthBudget{0.0};
+  static constexpr int kDefaultCameraPriority{0};
+  static constexpr auto kDefaultCameraImageEncoding = "bgr8";
+  static constexpr bool kDefaultColorizeRegisteredPointClouds{false};
+  static constexpr bool kDefaultPublishImageBundle{false};
+  static constexpr bool kDefaultStreamImages{false};
+  static constexpr bool kDefaultWarmUpImages{false};
+  static constexpr bool kDefaultStreamRobotState{false};
+  static constexpr bool kDefaultLowLevelJointStates{false};
+  static constexpr bool kDefaultPublishStatusOnChange{false};
+  static constexpr double kDefaultRobotStatePublishRate{0.0};
+  static constexpr double kDefaultStatusHeartbeatPeriod{1.0};
+  static constexpr double kDefaultMetricsPublishPeriod{1.0};
+  static constexpr auto kDefaultMetricsTextfile = "";
+  static constexpr bool kDefaultPublishRawProtobuf{false};
+  static constexpr bool kDefaultRawProtobufOnly{false};
+  static constexpr int kDefaultRobotStateHistorySize{256};
   static constexpr auto kDefaultPreferredOdomFrame = "odom";
   static constexpr auto kDefaultTFRoot = "odom";
+  static constexpr double kDefaultObjectSyncTranslationThreshold{0.0};
+  static constexpr double kDefaultObjectSyncRotationThreshold{0.0};
+  static constexpr double kDefaultObjectSyncTfCacheDuration{10.0};
+  static constexpr double kDefaultObjectSyncWorldObjectTfRate{0.0};
+  static constexpr auto kDefaultThreadCpus = "";
+  static constexpr int kDefaultIKCacheSize{0};
+  static constexpr double kDefaultIKCachePositionTolerance{0.001};
+  static constexpr double kDefaultIKCacheRotationTolerance{0.001};
   static constexpr bool kDefaultGripperless{false};
   static constexpr auto kCamerasWithoutHand = {"frontleft", "frontright", "left", "right", "back"};
   static constexpr auto kCamerasWithHand = {"frontleft", "frontright", "left", "right", "back", "hand"};
   static constexpr std::chrono::seconds kDefaultTimeSyncTimeout{5};
+  static constexpr double kDefaultImageRequestTimeout{2.0};
+  static constexpr double kDefaultRobotStateRequestTimeout{1.0};
+  static constexpr double kDefaultWorldObjectRequestTimeout{5.0};
+  static constexpr double kDefaultKinematicRequestTimeout{5.0};
+  static constexpr bool kDefaultDegradeOnPoorLink{true};
+  static constexpr double kDefaultLinkDegradedLatency{0.3};
+  static constexpr double kDefaultLinkDegradedFailureRate{0.2};
+  static constexpr int kDefaultDegradedRateDivisor{4};
+  static constexpr double kDefaultDegradedRGBImageQuality{50.0};
+  static constexpr auto kDefaultQoSReliability = "reliable";
+  static constexpr auto kDefaultQoSDurability = "transient_local";
+  static constexpr int kDefaultQoSDepth{0};
+  static constexpr double kDefaultQoSDeadline{0.0};
+  static constexpr double kDefaultQoSLifespan{0.0};
 };
 }  // namespace spot_ros2
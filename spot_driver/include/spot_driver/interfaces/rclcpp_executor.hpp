@@ -0,0 +1,57 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <rclcpp/node_interfaces/node_base_interface.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace spot_ros2 {
+/** @brief Executors which can spin a driver node that runs as its own process. */
+enum class ExecutorType {
+  /** @brief Runs one callback at a time. */
+  SINGLE_THREADED,
+  /**
+   * @brief Runs the callbacks of different callback groups on a pool of threads, so that a callback which blocks on an
+   * RPC to Spot only delays the callbacks of its own group.
+   */
+  MULTI_THREADED,
+  /**
+   * @brief Runs one callback at a time, but waits for events instead of polling every entity of the node. Only
+   * available if rclcpp provides it at build time.
+   */
+  EVENTS,
+};
+
+/**
+ * @brief Convert the name of an executor to an ExecutorType.
+ *
+ * @param name Name of the executor. Either "single_threaded", "multi_threaded" or "events".
+ * @return The matching ExecutorType, or an error message if the name is not recognized.
+ */
+tl::expected<ExecutorType, std::string> toExecutorType(const std::string& name);
+
+/**
+ * @brief Check if an executor was compiled into the driver.
+ *
+ * @param type Type of the executor.
+ * @return True if the executor can be used.
+ */
+bool isExecutorAvailable(const ExecutorType type);
+
+/**
+ * @brief Spin a node with the executor selected by its `executor` and `executor_threads` parameters until the node is
+ * shut down.
+ * @details The parameters are read from the parameter overrides of the node, i.e. from the command line and parameter
+ * files, since the executor has to be created before the node is spun. An unknown or unavailable executor is logged
+ * and replaced by default_type. Nodes which are loaded into a component container are spun by its executor instead.
+ *
+ * @param node Node to spin.
+ * @param default_type Executor which is used if the `executor` parameter is not set. This is the executor which the
+ * callback groups of the node were designed for.
+ */
+void spinNode(const std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface>& node, const ExecutorType default_type);
+}  // namespace spot_ros2
@@ -5,16 +5,22 @@
 #include <rclcpp/node.hpp>
 #include <spot_driver/interfaces/parameter_interface_base.hpp>
 
+#include <any>
 #include <chrono>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace spot_ros2 {
 /**
  * @brief Implements ParameterInterfaceBase to declare and retrieve ROS 2 parameters.
+ * @details Every parameter is declared and resolved, including its environment variable, the first time it is
+ * requested, and later requests return the cached value. The values are not updated if the parameters are set after
+ * they were first requested, so they can be read from hot paths without locking the node's parameters.
  */
 class RclcppParameterInterface : public ParameterInterfaceBase {
  public:
@@ -23,6 +29,24 @@ class RclcppParameterInterface : public ParameterInterfaceBase {
    * @param node A shared_ptr to a rclcpp node. RclcppParameterInterface shares ownership of the shared_ptr.
    */
   explicit RclcppParameterInterface(const std::shared_ptr<rclcpp::Node>& node);
+
+  /**
+   * @brief Check a new parameter value against the constraints which the getters enforce, so that a node can reject an
+   * invalid value when it is set, instead of failing to rebuild its publisher from it.
+   * @param parameter Parameter with its new value. Parameters without constraints are always valid.
+   * @return Nothing if the value is valid, or the reason why it is not.
+   */
+  [[nodiscard]] static tl::expected<void, std::string> validateParameter(const rclcpp::Parameter& parameter);
+
+  /**
+   * @brief Callback for rclcpp::Node::add_on_set_parameters_callback which rejects the parameters unless
+   * validateParameter() accepts each of them.
+   * @param parameters Parameters with their new values.
+   * @return Whether the parameters are valid, and the reason if they are not.
+   */
+  [[nodiscard]] static rcl_interfaces::msg::SetParametersResult validateParameters(
+      const std::vector<rclcpp::Parameter>& parameters);
+
   [[nodiscard]] std::string getHostname() const override;
   [[nodiscard]] std::optional<int> getPort() const override;
   [[nodiscard]] std::optional<std::string> getCertificate() const override;
@@ -35,8 +59,76 @@ class RclcppParameterInterface : public ParameterInterfaceBase {
   [[nodiscard]] bool getPublishRGBImages() const override;
   [[nodiscard]] bool getPublishDepthImages() const override;
   [[nodiscard]] bool getPublishDepthRegisteredImages() const override;
+  [[nodiscard]] int getImageDecodeThreads() const override;
+  [[nodiscard]] std::string getJpegDecoder() const override;
+  [[nodiscard]] bool getRLEDepthImages() const override;
+  [[nodiscard]] double getCameraPublishRate(const spot_ros2::SpotCamera camera) const override;
+  [[nodiscard]] int getImageRequestsInFlight() const override;
+  [[nodiscard]] bool getOnDemandImages() const override;
+  [[nodiscard]] double getStaticTransformsRefreshPeriod() const override;
+  [[nodiscard]] int getImagePreviewScale() const override;
+  [[nodiscard]] std::vector<int64_t> getImagePreviewRegion() const override;
+  [[nodiscard]] bool getPublishDepthPointClouds() const override;
+  [[nodiscard]] double getPointCloudVoxelSize() const override;
+  [[nodiscard]] bool getPublishCompressedDepthImages() const override;
+  [[nodiscard]] std::string getCompressedDepthFormat() const override;
+  [[nodiscard]] bool getPublishFilteredDepthImages() const override;
+  [[nodiscard]] int getFilteredDepthDecimation() const override;
+  [[nodiscard]] bool getFilteredDepthFillHoles() const override;
+  [[nodiscard]] double getFilteredDepthMinRange() const override;
+  [[nodiscard]] double getFilteredDepthMaxRange() const override;
+  [[nodiscard]] bool getPublishLaserScan() const override;
+  [[nodiscard]] double getLaserScanMinHeight() const override;
+  [[nodiscard]] double getLaserScanMaxHeight() const override;
+  [[nodiscard]] double getLaserScanRangeMax() const override;
+  [[nodiscard]] double getLaserScanAngleIncrement() const override;
+  [[nodiscard]] bool getPublishStitchedFrontImage() const override;
+  [[nodiscard]] std::string getVirtualCameraFrame() const override;
+  [[nodiscard]] std::vector<double> getVirtualCameraIntrinsics() const override;
+  [[nodiscard]] std::vector<double> getVirtualCameraProjectionPlane() const override;
+  [[nodiscard]] double getVirtualCameraPlaneDistance() const override;
+  [[nodiscard]] int getStitchedImageRowPadding() const override;
+  [[nodiscard]] int getStitchedImageSeamUpdatePeriod() const override;
+  [[nodiscard]] std::string getStitchedImageBlendMode() const override;
+  [[nodiscard]] int getStitchedImageBlendWidth() const override;
+  [[nodiscard]] bool getStitchedImageUseGpu() const override;
+  [[nodiscard]] bool getPublishImageLatencyDiagnostics() const override;
+  [[nodiscard]] double getHandCameraStreamRate() const override;
+  [[nodiscard]] double getHandCameraStreamQuality() const override;
+  [[nodiscard]] double getHandCameraStreamResizeRatio() const override;
+  [[nodiscard]] bool getAdaptiveRGBImageQuality() const override;
+  [[nodiscard]] double getMinRGBImageQuality() const override;
+  [[nodiscard]] double getMaxImageAge() const override;
+  [[nodiscard]] double getImageBandwidthBudget() const override;
+  [[nodiscard]] int getCameraPriority(const spot_ros2::SpotCamera camera) const override;
+  [[nodiscard]] std::string getCameraImageEncoding(const spot_ros2::SpotCamera camera) const override;
+  [[nodiscard]] bool getColorizeRegisteredPointClouds() const override;
+  [[nodiscard]] bool getPublishImageBundle() const override;
+  [[nodiscard]] bool getStreamImages() const override;
+  [[nodiscard]] bool getWarmUpImages() const override;
+  [[nodiscard]] bool getStreamRobotState() const override;
+  [[nodiscard]] bool getLowLevelJointStates() const override;
+  [[nodiscard]] bool getPublishStatusOnChange() const override;
+  [[nodiscard]] double getStatusHeartbeatPeriod() const override;
+  [[nodiscard]] double getMetricsPublishPeriod() const override;
+  [[nodiscard]] std::string getMetricsTextfile() const override;
+  [[nodiscard]] bool getPublishRawProtobuf() const override;
+  [[nodiscard]] bool getRawProtobufOnly() const override;
+  [[nodiscard]] int getRobotStateHistorySize() const override;
+  [[nodiscard]] double getRobotStatePublishRate(const std::string& topic) const override;
   [[nodiscard]] std::string getPreferredOdomFrame() const override;
   [[nodiscard]] std::string getTFRoot() const override;
+  [[nodiscard]] double getObjectSyncTranslationThreshold() const override;
+  [[nodiscard]] double getObjectSyncRotationThreshold() const override;
+  [[nodiscard]] double getObjectSyncTfCacheDuration() const override;
+  [[nodiscard]] std::vector<std::string> getObjectSyncTfFrameAllowlist() const override;
+  [[nodiscard]] std::vector<std::string> getObjectSyncTfFrameDenylist() const override;
+  [[nodiscard]] double getObjectSyncWorldObjectTfRate() const override;
+  [[nodiscard]] std::string getThreadCpus(const std::string& thread_class) const override;
+  [[nodiscard]] int getIKCacheSize() const override;
+  [[nodiscard]] double getIKCachePositionTolerance() const override;
+  [[nodiscard]] double getIKCacheRotationTolerance() const override;
+  [[nodiscard]] std::string getRobotDescription() const override;
   [[nodiscard]] std::string getSpotName() const override;
   [[nodiscard]] bool getGripperless() const override;
   [[nodiscard]] std::set<spot_ros2::SpotCamera> getDefaultCamerasUsed(const bool has_arm,
@@ -44,8 +136,33 @@ class RclcppParameterInterface : public ParameterInterfaceBase {
   [[nodiscard]] tl::expected<std::set<spot_ros2::SpotCamera>, std::string> getCamerasUsed(
       const bool has_arm, const bool gripperless) const override;
   [[nodiscard]] std::chrono::seconds getTimeSyncTimeout() const override;
+  [[nodiscard]] double getImageRequestTimeout() const override;
+  [[nodiscard]] double getRobotStateRequestTimeout() const override;
+  [[nodiscard]] double getWorldObjectRequestTimeout() const override;
+  [[nodiscard]] double getKinematicRequestTimeout() const override;
+  [[nodiscard]] bool getDegradeOnPoorLink() const override;
+  [[nodiscard]] double getLinkDegradedLatency() const override;
+  [[nodiscard]] double getLinkDegradedFailureRate() const override;
+  [[nodiscard]] int getDegradedRateDivisor() const override;
+  [[nodiscard]] double getDegradedRGBImageQuality() const override;
+  [[nodiscard]] tl::expected<PublisherQoSParameters, std::string> getPublisherQoS(
+      const std::string& category) const override;
 
  private:
+  /**
+   * @brief Get the cached value of a key, or resolve and cache it if it was not requested before.
+   * @param key Name of the parameter which the value is resolved from.
+   * @param resolve Function which declares the parameter if needed and returns its value.
+   */
+  template <typename ValueT, typename ResolveT>
+  ValueT getCached(const std::string& key, const ResolveT& resolve) const;
+
+  /** @brief Cached version of declaring and getting a parameter with a default value. */
+  template <typename ParameterT>
+  ParameterT getParameter(const std::string& name, const ParameterT& default_value) const;
+
   std::shared_ptr<rclcpp::Node> node_;
+  mutable std::mutex cache_mutex_;
+  mutable std::unordered_map<std::string, std::any> cache_;
 };
 }  // namespace spot_ros2
@@ -6,10 +6,11 @@
 #include <tf2_ros/transform_broadcaster.h>
 #include <rclcpp/node.hpp>
 #include <spot_driver/interfaces/tf_broadcaster_interface_base.hpp>
+#include <spot_driver/recording/recording_tap.hpp>
 
 #include <memory>
-#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace spot_ros2 {
@@ -25,8 +26,9 @@ class RclcppTfBroadcasterInterface : public TfBroadcasterInterfaceBase {
   explicit RclcppTfBroadcasterInterface(const std::shared_ptr<rclcpp::Node>& node);
 
   /**
-   * @brief Add new transforms to the StaticTransformBroadcaster.
-   * @param transforms Transforms to publish as static transforms.
+   * @brief Add new and changed transforms to the StaticTransformBroadcaster.
+   * @param transforms Transforms to publish as static transforms. Transforms which were already published with the same
+   * parent frame and value are not published again.
    */
   void updateStaticTransforms(const std::vector<geometry_msgs::msg::TransformStamped>& transforms) override;
 
@@ -37,6 +39,8 @@ class RclcppTfBroadcasterInterface : public TfBroadcasterInterfaceBase {
   void sendDynamicTransforms(const std::vector<geometry_msgs::msg::TransformStamped>& transforms) override;
 
  private:
+  std::shared_ptr<rclcpp::Node> node_;
+
   /**
    * @brief Broadcaster for static transforms.
    * @details The rclcpp StaticTransformBroadcaster publishes onto a latched topic using the transient_local QoS
@@ -45,23 +49,30 @@ class RclcppTfBroadcasterInterface : public TfBroadcasterInterfaceBase {
    * a rate.
    *
    * The StaticTransformBroadcaster internally stores the transforms it has previously published. When sendTransform()
-   * is called with a transform that has a child frame that is not represented among the existing stored transforms,
-   * it adds this transforms to the stored transform. This means that calling sendTransform() with a set of transforms
-   * that all have child frames that are already represented in the stored transforms will not update the values of any
-   * of the stored transforms and will only republish the prior values of all stored transforms.
+   * is called, it adds the transforms to new child frames to the stored transforms, replaces the stored transforms to
+   * the other child frames, and republishes all stored transforms.
    *
-   * These characteristics mean that we should only call sendTransform() with never-before-published transforms, to
-   * minimize unnecessary calls to publish onto the /tf_static topic.
+   * These characteristics mean that we should only call sendTransform() with the transforms which are new or changed,
+   * to minimize unnecessary calls to publish onto the /tf_static topic.
    */
   tf2_ros::StaticTransformBroadcaster static_tf_broadcaster_;
 
   tf2_ros::TransformBroadcaster dynamic_tf_broadcaster_;
 
   /**
-   * @brief Tracks transforms which are currently being broadcast through the static transform broadcaster.
-   * @details This is used to check if any transforms passed into updateStaticTransforms() are being published for the
-   * very first time.
+   * @brief Tracks transforms which are currently being broadcast through the static transform broadcaster, by child
+   * frame.
+   * @details This is used to check if any transforms passed into updateStaticTransforms() are new or changed.
    */
-  std::set<std::string> current_static_child_frames_;
+  std::unordered_map<std::string, geometry_msgs::msg::TransformStamped> current_static_transforms_;
+
+  /** @brief Transforms which changed in the last call to updateStaticTransforms(), kept to reuse its storage. */
+  std::vector<geometry_msgs::msg::TransformStamped> changed_static_transforms_;
+
+  /** @brief Tap through which the transforms are also handed to a recorder in the same process. */
+  std::shared_ptr<recording::RecordingTap> recording_tap_{recording::RecordingTap::getDefault()};
+
+  /** @brief True once every static transform was recorded since the recorder was attached. */
+  bool static_transforms_recorded_{false};
 };
 }  // namespace spot_ros2
@@ -2,18 +2,39 @@
 
 #pragma once
 
+#include <tf2/buffer_core.h>
 #include <tf2_ros/buffer.h>
-#include <tf2_ros/transform_listener.h>
 #include <rclcpp/duration.hpp>
 #include <rclcpp/node.hpp>
+#include <rclcpp/subscription.hpp>
 #include <spot_driver/interfaces/tf_listener_interface_base.hpp>
+#include <tf2_msgs/msg/tf_message.hpp>
 
+#include <chrono>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace spot_ros2 {
+/** @brief Limits on which frames a RclcppTfListenerInterface keeps in its buffer, and for how long. */
+struct TfListenerOptions {
+  /** @brief How long the buffer keeps the dynamic transforms of every frame. */
+  tf2::Duration cache_duration{tf2::BUFFER_CORE_DEFAULT_CACHE_TIME};
+  /**
+   * @brief If not empty, only transforms whose child frame starts with one of these prefixes are added to the buffer.
+   * The frames that transforms are looked up relative to must be allowed as well.
+   */
+  std::vector<std::string> allowed_frame_prefixes;
+  /** @brief Transforms whose child frame starts with one of these prefixes are never added to the buffer. */
+  std::vector<std::string> denied_frame_prefixes;
+};
+
 /**
  * @brief Implements TfListenerInterfaceBase to use the rclcpp TF system.
  * @details The node passed to the constructor of this class MUST be spun by a MultiThreadedExecutor.
@@ -22,13 +43,15 @@ class RclcppTfListenerInterface : public TfListenerInterfaceBase {
  public:
   /**
    * @brief The constructor for RclcppTfListenerInterface.
-   * @details When creating the TF listener, we use the version of its constructor that takes an existing node, and we
-   * set that the listener should use an existing executor when monitoring TF data instead of creating its own. This
-   * makes the executor which the node is assigned to responsible for handling the TF subscriber callbacks and prevents
-   * the TF listener from creating its own internal node.
+   * @details Instead of a tf2_ros::TransformListener, this class subscribes to the TF topics with the given node, like
+   * a listener which uses an existing executor, so that it can also track which frames are updated. This makes the
+   * executor which the node is assigned to responsible for handling the TF subscriber callbacks.
    * @param node A shared_ptr to a rclcpp node. RclcppTfListenerInterface shares ownership of the shared_ptr.
+   * @param options Cache duration of the buffer and the frames that are added to it. Frames which are filtered out are
+   * dropped before they reach the buffer, so they cost neither memory nor the insertion into the buffer.
    */
-  explicit RclcppTfListenerInterface(const std::shared_ptr<rclcpp::Node>& node);
+  explicit RclcppTfListenerInterface(const std::shared_ptr<rclcpp::Node>& node,
+                                     const TfListenerOptions& options = TfListenerOptions{});
 
   /**
    * @brief Get the frame IDs of all frames known to the TF buffer.
@@ -37,12 +60,23 @@ class RclcppTfListenerInterface : public TfListenerInterfaceBase {
    */
   std::vector<std::string> getAllFrameNames() const override;
 
+  /**
+   * @brief Get the frame IDs of the frames whose dynamic transforms were received since a previous call.
+   * @details Static transforms are only received once, so they are reported by the first call.
+   * @param generation Generation which was returned by the previous call, or 0 to get every frame. It is set to the
+   * current generation.
+   * @return A vector of frame IDs.
+   */
+  std::vector<std::string> getUpdatedFrameNames(std::uint64_t& generation) const override;
+
   /**
    * @brief Look up a transform from a parent frame to a child frame at the specified timepoint.
    * @param parent Parent frame ID.
    * @param child Child frame ID.
    * @param timepoint Get a transform that is valid for this timestamp. Setting an all-zero timepoint is equivalent to
    * passing tf2::timePointZero().
+   * @details Unavailable transforms are reported without throwing exceptions. Transforms between frames which are only
+   * connected by static transforms are cached for a short time, and returned with the requested timepoint as stamp.
    * @return If successful, returns a transform following the convention parent_tform_child. If not successful, returns
    * an error message.
    */
@@ -50,7 +84,32 @@ class RclcppTfListenerInterface : public TfListenerInterfaceBase {
       const std::string& parent, const std::string& child, const rclcpp::Time& timepoint) const override;
 
  private:
+  /** @brief A transform between frames which are only connected by static transforms, and when it expires. */
+  struct CachedTransform {
+    geometry_msgs::msg::TransformStamped transform;
+    std::chrono::steady_clock::time_point expiry;
+  };
+
+  /** @brief Add the transforms of a TF message to the buffer and record the generation of their child frames. */
+  void onTransforms(const tf2_msgs::msg::TFMessage& msg, bool is_static);
+
+  /** @brief Check if a frame passes the allowed and denied frame prefixes. */
+  [[nodiscard]] bool isTracked(const std::string& frame) const;
+
+  rclcpp::Logger logger_;
+  std::vector<std::string> allowed_frame_prefixes_;
+  std::vector<std::string> denied_frame_prefixes_;
   tf2_ros::Buffer buffer_;
-  tf2_ros::TransformListener listener_;
+  rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr tf_subscription_;
+  rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr tf_static_subscription_;
+
+  // Generation of the last received TF message, and the generation in which every child frame was last updated.
+  mutable std::mutex generations_mutex_;
+  std::uint64_t generation_ = 0;
+  std::unordered_map<std::string, std::uint64_t> frame_generations_;
+
+  // Recent static transforms by parent and child frame.
+  mutable std::mutex static_transforms_mutex_;
+  mutable std::map<std::pair<std::string, std::string>, CachedTransform> static_transforms_;
 };
 }  // namespace spot_ros2
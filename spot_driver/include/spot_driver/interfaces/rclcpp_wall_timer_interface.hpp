@@ -18,8 +18,11 @@ class RclcppWallTimerInterface : public TimerInterfaceBase {
   /**
    * @brief The constructor for RclcppWallTimerInterface.
    * @param node A shared_ptr to a rclcpp node. RclcppWallTimerInterface shares ownership of the shared_ptr.
+   * @param callback_group Callback group of the timer. If null, the timer is added to the default callback group of
+   * the node.
    */
-  explicit RclcppWallTimerInterface(const std::shared_ptr<rclcpp::Node>& node);
+  explicit RclcppWallTimerInterface(const std::shared_ptr<rclcpp::Node>& node,
+                                    const rclcpp::CallbackGroup::SharedPtr& callback_group = nullptr);
 
   void setTimer(const std::chrono::duration<double>& period, const std::function<void()>& callback) override;
   void clearTimer() override;
@@ -27,5 +30,6 @@ class RclcppWallTimerInterface : public TimerInterfaceBase {
  private:
   std::shared_ptr<rclcpp::Node> node_;
   std::shared_ptr<rclcpp::TimerBase> timer_;
+  rclcpp::CallbackGroup::SharedPtr callback_group_;
 };
 }  // namespace spot_ros2
@@ -7,6 +7,7 @@
 #include <rclcpp/time.hpp>
 #include <tl_expected/expected.hpp>
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -31,6 +32,18 @@ class TfListenerInterfaceBase {
    */
   [[nodiscard]] virtual std::vector<std::string> getAllFrameNames() const = 0;
 
+  /**
+   * @brief Get the frame IDs of the frames whose transforms were received since a previous call.
+   * @details The default implementation returns all frame IDs known to the transform source.
+   * @param generation Generation of the transform source which was returned by the previous call, or 0 to get every
+   * frame. It is set to the current generation.
+   * @return A vector of the frame IDs whose transforms were received after the given generation.
+   */
+  [[nodiscard]] virtual std::vector<std::string> getUpdatedFrameNames(std::uint64_t& generation) const {
+    generation = 0;
+    return getAllFrameNames();
+  }
+
   /**
    * @brief Look up a transform from a parent frame to a child frame at the specified timepoint.
    * @param parent Parent frame ID.
@@ -0,0 +1,47 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace spot_ros2 {
+/**
+ * @brief Defines an interface for a pool of worker threads which is shared by the components of a driver process, so
+ * that they do not each start their own threads.
+ */
+class ThreadPoolInterfaceBase {
+ public:
+  // ThreadPoolInterfaceBase is move-only
+  ThreadPoolInterfaceBase() = default;
+  ThreadPoolInterfaceBase(ThreadPoolInterfaceBase&& other) = default;
+  ThreadPoolInterfaceBase(const ThreadPoolInterfaceBase&) = delete;
+  ThreadPoolInterfaceBase& operator=(ThreadPoolInterfaceBase&& other) = default;
+  ThreadPoolInterfaceBase& operator=(const ThreadPoolInterfaceBase&) = delete;
+
+  virtual ~ThreadPoolInterfaceBase() = default;
+
+  /**
+   * @brief Run a task on one of the worker threads, without waiting for it.
+   *
+   * @param task Task to run. It should not throw, since nothing waits for it to report an error.
+   */
+  virtual void post(std::function<void()> task) = 0;
+
+  /**
+   * @brief Call job once for every index in [0, num_jobs) and wait until all calls have returned.
+   * @details The calling thread runs jobs as well, so that a parallelFor() which is called from within a task of the
+   * pool always makes progress, even if every worker thread is busy. If a job throws, the remaining jobs still run and
+   * the first exception is rethrown afterwards.
+   *
+   * @param num_jobs Number of jobs.
+   * @param max_workers Maximum number of threads, including the calling thread, which run jobs at the same time.
+   * @param job Job to run, which is called with the index of the job.
+   */
+  virtual void parallelFor(const std::size_t num_jobs, const std::size_t max_workers,
+                           const std::function<void(std::size_t)>& job) = 0;
+
+  /** @brief Get the number of worker threads of the pool. */
+  virtual std::size_t getNumThreads() const = 0;
+};
+}  // namespace spot_ros2
@@ -0,0 +1,67 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <spot_driver/interfaces/parameter_interface_base.hpp>
+
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <tl_expected/expected.hpp>
+
+namespace spot_ros2 {
+/** @brief Name and CPU affinity of a thread of the driver. */
+struct ThreadSettings {
+  /** @brief Name of the thread shown by top and perf. Linux truncates it to 15 characters. */
+  std::string name;
+  /** @brief CPUs which the thread may run on. If empty, the thread runs on any CPU. */
+  std::vector<int> cpus;
+};
+
+/**
+ * @brief Parse a list of CPUs in the format of taskset and isolcpus, e.g. "2,3" or "4-7,10".
+ *
+ * @param cpu_list List of CPUs. An empty list lets a thread run on any CPU.
+ * @return The CPUs in the list, or an error message if the list is malformed or names a CPU out of range.
+ */
+tl::expected<std::vector<int>, std::string> parseCpuList(std::string_view cpu_list);
+
+/**
+ * @brief Read the settings of a class of threads from the parameter `thread_cpus.<thread_class>`.
+ *
+ * @param parameters Parameters of the node which starts the threads.
+ * @param thread_class Class of the threads, e.g. "image_stream".
+ * @param name Name of the threads.
+ * @return The settings, or an error message if the parameter is malformed.
+ */
+tl::expected<ThreadSettings, std::string> makeThreadSettings(const ParameterInterfaceBase& parameters,
+                                                             const std::string& thread_class, std::string name);
+
+/**
+ * @brief Name a running thread and pin it to its CPUs.
+ * @details The thread keeps running with its previous name and affinity if this fails, e.g. because the CPUs are not
+ * available to the process.
+ *
+ * @param thread Native handle of the thread.
+ * @param settings Settings to apply. An empty name keeps the name of the thread.
+ * @return Nothing, or an error message if the name or the affinity could not be set.
+ */
+tl::expected<void, std::string> applyThreadSettings(std::thread::native_handle_type thread,
+                                                    const ThreadSettings& settings);
+
+/**
+ * @brief Name a running thread and pin it to the CPUs of its class, which are read from the parameter
+ * `thread_cpus.<thread_class>`.
+ *
+ * @param thread Native handle of the thread.
+ * @param parameters Parameters of the node which started the thread.
+ * @param thread_class Class of the thread, e.g. "image_stream".
+ * @param name Name of the thread.
+ * @return Nothing, or an error message if the parameter is malformed or the thread could not be configured.
+ */
+tl::expected<void, std::string> configureThread(std::thread::native_handle_type thread,
+                                                const ParameterInterfaceBase& parameters,
+                                                const std::string& thread_class, std::string name);
+}  // namespace spot_ros2
@@ -0,0 +1,93 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <spot_driver/interfaces/logger_interface_base.hpp>
+#include <spot_driver/interfaces/thread_pool_interface_base.hpp>
+#include <spot_driver/interfaces/thread_settings.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <tl_expected/expected.hpp>
+
+namespace spot_ros2 {
+/**
+ * @brief Implements ThreadPoolInterfaceBase with a queue of tasks per worker thread.
+ * @details Tasks which are posted from a worker thread go to the queue of that thread, and other tasks are spread over
+ * the queues in turn. Every worker runs the newest task of its own queue first, and steals the oldest task of another
+ * queue once its own queue is empty. Tasks which are still queued when the pool is destroyed are run before its
+ * threads are joined. The pool is shared by every component of a process, so an exception which escapes a posted task
+ * is logged instead of terminating the process.
+ */
+class WorkStealingThreadPool : public ThreadPoolInterfaceBase {
+ public:
+  /**
+   * @brief The constructor for WorkStealingThreadPool.
+   * @param num_threads Number of worker threads. At least one thread is started.
+   * @param logger Logs the exceptions which escape posted tasks.
+   */
+  WorkStealingThreadPool(const std::size_t num_threads, std::unique_ptr<LoggerInterfaceBase> logger);
+  ~WorkStealingThreadPool() override;
+
+  void post(std::function<void()> task) override;
+  void parallelFor(const std::size_t num_jobs, const std::size_t max_workers,
+                   const std::function<void(std::size_t)>& job) override;
+  std::size_t getNumThreads() const override;
+
+  /**
+   * @brief Name the worker threads and pin them to CPUs.
+   *
+   * @param settings Settings of the workers. Each worker is named after the settings with its index appended.
+   * @return Nothing, or an error message if a worker could not be configured.
+   */
+  tl::expected<void, std::string> setThreadSettings(const ThreadSettings& settings);
+
+ private:
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void run(const std::size_t index);
+  /** @brief Take the newest task of the queue of a worker, or else the oldest task of any other queue. */
+  std::function<void()> takeTask(const std::size_t index);
+
+  std::unique_ptr<LoggerInterfaceBase> logger_;
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::atomic<std::size_t> next_queue_{0};
+
+  // Number of queued tasks which no worker has claimed yet. A worker claims a task before it takes one from a queue,
+  // so a claimed task is always in one of the queues.
+  std::mutex wake_mutex_;
+  std::condition_variable wake_;
+  std::size_t unclaimed_tasks_{0};
+  bool stopping_{false};
+
+  std::vector<std::thread> threads_;
+};
+
+/**
+ * @brief Get the thread pool which is shared by every driver component in this process.
+ * @details The pool is created on the first call, with one worker thread per core.
+ */
+std::shared_ptr<ThreadPoolInterfaceBase> getSharedThreadPool();
+
+/**
+ * @brief Name the worker threads of the shared thread pool and pin them to CPUs. Every node which uses the shared pool
+ * reads the same parameters, so the last node to call this wins without changing anything.
+ *
+ * @param settings Settings of the workers.
+ * @return Nothing, or an error message if a worker could not be configured.
+ */
+tl::expected<void, std::string> configureSharedThreadPool(const ThreadSettings& settings);
+}  // namespace spot_ros2
@@ -0,0 +1,58 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <spot_driver/kinematic/forward_kinematics.hpp>
+
+#include <spot_msgs/srv/get_forward_kinematic_solutions.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace spot_ros2::kinematic {
+
+using spot_msgs::srv::GetForwardKinematicSolutions;
+
+/**
+ * Service which solves batches of forward kinematics requests with the URDF of the robot. The requests are answered
+ * locally, so they are much cheaper than the inverse kinematics requests which are sent to Spot.
+ */
+class ForwardKinematicService {
+ public:
+  /**
+   * This middleware handle is used to register the service and assign to it a callback. In testing, it can be mocked
+   * to avoid using the ROS infrastructure.
+   */
+  class MiddlewareHandle {
+   public:
+    virtual void createService(std::string service_name,
+                               std::function<void(const std::shared_ptr<GetForwardKinematicSolutions::Request>,
+                                                  std::shared_ptr<GetForwardKinematicSolutions::Response>)>
+                                   callback) = 0;
+    virtual ~MiddlewareHandle() = default;
+  };
+
+  /**
+   * Create the logic for the GetForwardKinematicSolutions service.
+   * @param kinematics Forward kinematics of the robot.
+   * @param middleware_handle The service provider.
+   */
+  ForwardKinematicService(ForwardKinematics kinematics, std::unique_ptr<MiddlewareHandle> middleware_handle);
+
+  /** Initialize the service. */
+  void initialize();
+
+  /**
+   * Compute the poses, and optionally the Jacobians, of the requested links for every joint state of a request.
+   * @param request The ROS request.
+   * @param response A ROS response to be filled.
+   */
+  void getSolutions(const std::shared_ptr<GetForwardKinematicSolutions::Request> request,
+                    std::shared_ptr<GetForwardKinematicSolutions::Response> response) const;
+
+ private:
+  ForwardKinematics kinematics_;
+  std::unique_ptr<MiddlewareHandle> middleware_handle_;
+};
+}  // namespace spot_ros2::kinematic
@@ -0,0 +1,119 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <Eigen/Geometry>
+#include <sensor_msgs/msg/joint_state.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace spot_ros2::kinematic {
+
+/** Maximum number of movable joints of a model. Spot has 12 leg joints, and 7 more with the arm and gripper. */
+inline constexpr int kMaxJoints = 32;
+
+/** Positions of the movable joints of a model, in the order of ForwardKinematics::getJointNames(). */
+using JointPositions = Eigen::Matrix<double, Eigen::Dynamic, 1, 0, kMaxJoints, 1>;
+
+/**
+ * Geometric Jacobian of a link, with one column per movable joint. The first three rows are the linear velocity of the
+ * link origin and the last three its angular velocity, both in the root frame. Its storage is bounded by kMaxJoints, so
+ * it is never allocated on the heap.
+ */
+using Jacobian = Eigen::Matrix<double, 6, Eigen::Dynamic, 0, 6, kMaxJoints>;
+
+/**
+ * Forward kinematics of a robot described by a URDF, such as the one of spot_description, which computes the poses and
+ * Jacobians of links from joint positions without querying Spot.
+ *
+ * The URDF is only parsed on creation, into a flat list of links where every parent comes before its children, so that
+ * the poses of all links are computed in one pass over the list. This class is immutable after creation, so it can be
+ * used from several threads at the same time.
+ */
+class ForwardKinematics {
+ public:
+  /**
+   * Parse a URDF. Its joints can be fixed, revolute, continuous or prismatic.
+   * @param urdf Contents of the URDF.
+   * @return The kinematics of the URDF, or an error if it could not be parsed or has other joints or too many joints.
+   */
+  static tl::expected<ForwardKinematics, std::string> fromUrdf(const std::string& urdf);
+
+  /** Return the name of the root link, which all poses are relative to. */
+  [[nodiscard]] const std::string& getRootLink() const { return root_link_; }
+
+  /** Return the names of all links, with the root link first. */
+  [[nodiscard]] const std::vector<std::string>& getLinkNames() const { return link_names_; }
+
+  /** Return the names of the movable joints, in the order of the joint positions and Jacobian columns. */
+  [[nodiscard]] const std::vector<std::string>& getJointNames() const { return joint_names_; }
+
+  /** Return the lower limits of the movable joints, which are -infinity for continuous joints. */
+  [[nodiscard]] const JointPositions& getLowerLimits() const { return lower_limits_; }
+
+  /** Return the upper limits of the movable joints, which are infinity for continuous joints. */
+  [[nodiscard]] const JointPositions& getUpperLimits() const { return upper_limits_; }
+
+  /** Return the index of a link in getLinkNames(), if the model has it. */
+  [[nodiscard]] std::optional<std::size_t> getLinkIndex(const std::string& link) const;
+
+  /** Return the index of a movable joint in getJointNames(), if the model has it. */
+  [[nodiscard]] std::optional<std::size_t> getJointIndex(const std::string& joint) const;
+
+  /**
+   * Gather the positions of the movable joints from a joint state, which may list its joints in any order.
+   * @return The positions, or an error if a movable joint is missing from the joint state.
+   */
+  [[nodiscard]] tl::expected<JointPositions, std::string> toJointPositions(
+      const sensor_msgs::msg::JointState& joint_state) const;
+
+  /**
+   * Compute the poses of all links relative to the root link.
+   * @param positions Positions of the movable joints.
+   * @param root_tform_links Poses of the links in the order of getLinkNames(). It is resized to the number of links,
+   * so a vector which is reused between calls is not reallocated.
+   */
+  void computeLinkPoses(const JointPositions& positions, std::vector<Eigen::Isometry3d>& root_tform_links) const;
+
+  /**
+   * Compute the Jacobian of a link. Only the joints between the link and the root have non-zero columns.
+   * @param root_tform_links Poses of the links, computed by computeLinkPoses() for the same joint positions.
+   * @param link Index of the link.
+   * @param jacobian Jacobian of the link.
+   */
+  void computeJacobian(const std::vector<Eigen::Isometry3d>& root_tform_links, std::size_t link,
+                       Jacobian& jacobian) const;
+
+ private:
+  enum class JointType { kFixed, kRevolute, kPrismatic };
+
+  /** A link and the joint to its parent link. */
+  struct Link {
+    /** Index of the parent link, which is not used by the root link. */
+    std::size_t parent;
+    /** Pose of the joint frame in the parent link frame, which is the pose of the link at joint position zero. */
+    Eigen::Isometry3d parent_tform_joint;
+    JointType type;
+    /** Unit axis of the joint in the joint frame. */
+    Eigen::Vector3d axis;
+    /** Index of the joint in the joint positions, if it is movable. */
+    std::size_t joint;
+  };
+
+  ForwardKinematics() = default;
+
+  std::string root_link_;
+  std::vector<Link> links_;
+  std::vector<std::string> link_names_;
+  std::vector<std::string> joint_names_;
+  JointPositions lower_limits_;
+  JointPositions upper_limits_;
+  std::unordered_map<std::string, std::size_t> link_indices_;
+  std::unordered_map<std::string, std::size_t> joint_indices_;
+};
+}  // namespace spot_ros2::kinematic
@@ -0,0 +1,58 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <spot_driver/api/kinematic_api.hpp>
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace spot_ros2::kinematic {
+
+/**
+ * Least recently used cache of IK responses, which answers repeated requests without querying Spot.
+ *
+ * Requests are looked up by their values rounded to the given tolerances, so requests which differ less than the
+ * tolerances usually share a response. Quaternion components are rounded to the rotation tolerance, and every other
+ * floating point value, such as positions, to the position tolerance. A tolerance of zero only matches identical
+ * values. This class is thread-safe.
+ */
+class KinematicCache {
+ public:
+  /**
+   * @param capacity Maximum number of cached responses.
+   * @param position_tolerance Tolerance of positions, in meters.
+   * @param rotation_tolerance Tolerance of the components of quaternions.
+   */
+  KinematicCache(std::size_t capacity, double position_tolerance, double rotation_tolerance);
+
+  /** Return the cached response to a request similar to the given one, if any. */
+  [[nodiscard]] std::optional<InverseKinematicsResponse> find(const InverseKinematicsRequest& request);
+
+  /** Cache the response to a request, evicting the least recently used response if the cache is full. */
+  void insert(const InverseKinematicsRequest& request, const InverseKinematicsResponse& response);
+
+  /** Return the number of cached responses. */
+  [[nodiscard]] std::size_t size() const;
+
+ private:
+  using Entry = std::pair<std::string, InverseKinematicsResponse>;
+
+  /** Return the key of a request, made of its field numbers and rounded values. */
+  [[nodiscard]] std::string makeKey(const InverseKinematicsRequest& request) const;
+
+  std::size_t capacity_;
+  double position_tolerance_;
+  double rotation_tolerance_;
+
+  mutable std::mutex mutex_;
+  // Cached entries from the most to the least recently used, and the entry of every key.
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+}  // namespace spot_ros2::kinematic
@@ -1,5 +1,6 @@
 // Copyright (c) 2023 Boston Dynamics AI Institute LLC. All rights reserved.
 
+#include <spot_driver/kinematic/forward_kinematic_service.hpp>
 #include <spot_driver/kinematic/kinematic_service.hpp>
 
 #include <memory>
@@ -11,13 +12,31 @@ namespace spot_ros2::kinematic {
 class KinematicMiddlewareHandle : public KinematicService::MiddlewareHandle {
  public:
   explicit KinematicMiddlewareHandle(std::shared_ptr<rclcpp::Node> node);
+  void createService(
+      std::string service_name,
+      std::function<void(const std::shared_ptr<GetInverseKinematicSolutions::Request>, KinematicService::Responder)>
+          callback) override;
+  void createBatchService(std::string service_name,
+                          std::function<void(const std::shared_ptr<GetInverseKinematicSolutionsBatch::Request>,
+                                             KinematicService::BatchResponder)>
+                              callback) override;
+
+ private:
+  std::shared_ptr<rclcpp::Node> node_;
+  std::shared_ptr<rclcpp::Service<GetInverseKinematicSolutions>> service_;
+  std::shared_ptr<rclcpp::Service<GetInverseKinematicSolutionsBatch>> batch_service_;
+};
+
+class ForwardKinematicMiddlewareHandle : public ForwardKinematicService::MiddlewareHandle {
+ public:
+  explicit ForwardKinematicMiddlewareHandle(std::shared_ptr<rclcpp::Node> node);
   void createService(std::string service_name,
-                     std::function<void(const std::shared_ptr<GetInverseKinematicSolutions::Request>,
-                                        std::shared_ptr<GetInverseKinematicSolutions::Response>)>
+                     std::function<void(const std::shared_ptr<GetForwardKinematicSolutions::Request>,
+                                        std::shared_ptr<GetForwardKinematicSolutions::Response>)>
                          callback) override;
 
  private:
   std::shared_ptr<rclcpp::Node> node_;
-  std::shared_ptr<rclcpp::Service<GetInverseKinematicSolutions>> service_;
+  std::shared_ptr<rclcpp::Service<GetForwardKinematicSolutions>> service_;
 };
 }  // namespace spot_ros2::kinematic
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <spot_driver/kinematic/forward_kinematic_service.hpp>
 #include <spot_driver/kinematic/kinematic_service.hpp>
 
 #include <spot_driver/api/spot_api.hpp>
@@ -37,6 +38,7 @@ class KinematicNode {
   std::shared_ptr<rclcpp::Node> node_;
   std::unique_ptr<SpotApi> spot_api_;
   std::unique_ptr<KinematicService> internal_;
+  std::unique_ptr<ForwardKinematicService> forward_kinematics_;
 
   void initialize(std::shared_ptr<rclcpp::Node> node, std::unique_ptr<SpotApi> spot_api,
                   std::shared_ptr<ParameterInterfaceBase> parameter_interface,
@@ -5,29 +5,50 @@
 #include <spot_driver/api/kinematic_api.hpp>
 
 #include <spot_driver/interfaces/logger_interface_base.hpp>
+#include <spot_driver/interfaces/thread_pool_interface_base.hpp>
+#include <spot_driver/interfaces/work_stealing_thread_pool.hpp>
+#include <spot_driver/kinematic/kinematic_cache.hpp>
 
 #include <spot_msgs/srv/get_inverse_kinematic_solutions.hpp>
+#include <spot_msgs/srv/get_inverse_kinematic_solutions_batch.hpp>
+#include <tl_expected/expected.hpp>
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace spot_ros2::kinematic {
 
 using spot_msgs::srv::GetInverseKinematicSolutions;
+using spot_msgs::srv::GetInverseKinematicSolutionsBatch;
 
 class KinematicService {
  public:
+  /** Function which sends the response to a request, and may be called from any thread. */
+  using Responder = std::function<void(std::shared_ptr<GetInverseKinematicSolutions::Response>)>;
+  using BatchResponder = std::function<void(std::shared_ptr<GetInverseKinematicSolutionsBatch::Response>)>;
+
   /**
    * This middleware handle is used to register a service and assign to it a
    * callback. In testing, it can be mocked to avoid using the ROS
-   * infrastructure.
+   * infrastructure. The callbacks receive a responder instead of a response,
+   * so that they can return before the response is sent.
    */
   class MiddlewareHandle {
    public:
-    virtual void createService(std::string service_name,
-                               std::function<void(const std::shared_ptr<GetInverseKinematicSolutions::Request>,
-                                                  std::shared_ptr<GetInverseKinematicSolutions::Response>)>
-                                   callback) = 0;
+    virtual void createService(
+        std::string service_name,
+        std::function<void(const std::shared_ptr<GetInverseKinematicSolutions::Request>, Responder)> callback) = 0;
+    virtual void createBatchService(
+        std::string service_name,
+        std::function<void(const std::shared_ptr<GetInverseKinematicSolutionsBatch::Request>, BatchResponder)>
+            callback) = 0;
     virtual ~MiddlewareHandle() = default;
   };
 
@@ -36,11 +57,24 @@ class KinematicService {
    * @param node The ROS node.
    * @param kinematic_api The Api to interact with the Spot SDK.
    * @param logger Logging interface.
+   * @param cache Optional cache of the responses, which answers repeated requests without querying Spot.
+   * @param local_kinematic_api Optional local solver, which solves the requests that ask for it, and all requests if
+   * kinematic_api is nullptr.
+   * @param request_timeout Time after which a request to Spot is cancelled and answered as failed. A value of zero or
+   * less waits for as long as the Spot SDK does.
+   * @param thread_pool Pool which solves the service requests.
    */
   explicit KinematicService(std::shared_ptr<KinematicApi> kinematic_api, std::shared_ptr<LoggerInterfaceBase> logger,
-                            std::unique_ptr<MiddlewareHandle> middleware_Handle);
+                            std::unique_ptr<MiddlewareHandle> middleware_Handle,
+                            std::unique_ptr<KinematicCache> cache = nullptr,
+                            std::shared_ptr<KinematicApi> local_kinematic_api = nullptr,
+                            std::chrono::duration<double> request_timeout = std::chrono::duration<double>{0.0},
+                            std::shared_ptr<ThreadPoolInterfaceBase> thread_pool = getSharedThreadPool());
+
+  /** Wait for the requests which are still being solved. */
+  ~KinematicService();
 
-  /** Initialize the service. */
+  /** Initialize the services. Their requests are solved on the thread pool, so they do not block the executor. */
   void initialize();
 
   /**
@@ -51,6 +85,14 @@ class KinematicService {
   void getSolutions(const std::shared_ptr<GetInverseKinematicSolutions::Request> request,
                     std::shared_ptr<GetInverseKinematicSolutions::Response> response);
 
+  /**
+   * Invoke the Spot SDK to get the IK solutions of many requests, several of which are sent concurrently.
+   * @param request The ROS request.
+   * @param response A ROS response to be filled, with one response per request.
+   */
+  void getBatchSolutions(const std::shared_ptr<GetInverseKinematicSolutionsBatch::Request> request,
+                         std::shared_ptr<GetInverseKinematicSolutionsBatch::Response> response);
+
  private:
   // The API to interact with Spot SDK.
   std::shared_ptr<KinematicApi> kinematic_api_;
@@ -60,5 +102,38 @@ class KinematicService {
 
   // The service provider.
   std::unique_ptr<MiddlewareHandle> middleware_handle_;
+
+  // Cache of the responses of Spot, or nullptr if disabled.
+  std::unique_ptr<KinematicCache> cache_;
+
+  // The local solver, or nullptr if there is none.
+  std::shared_ptr<KinematicApi> local_kinematic_api_;
+  std::chrono::duration<double> request_timeout_;
+
+  // The pool which solves the service requests.
+  std::shared_ptr<ThreadPoolInterfaceBase> thread_pool_;
+
+  /** Return the API which solves requests with the given solver, or nullptr if it is not available. */
+  [[nodiscard]] KinematicApi* selectApi(std::uint8_t solver) const;
+
+  /**
+   * Send a request to Spot, or wait for the response of an identical request which is already being sent.
+   * @param request The converted request.
+   * @return The response of Spot, or an error message if the request failed.
+   */
+  tl::expected<InverseKinematicsResponse, std::string> getCoalescedSolutions(InverseKinematicsRequest& request);
+
+  /** Solve a request on the thread pool, waiting first for the oldest one if too many are being solved. */
+  void dispatch(std::function<void()> task);
+
+  // Requests which are being solved on the thread pool, from the oldest to the newest. Each future becomes ready once
+  // its request was answered.
+  std::mutex pending_mutex_;
+  std::list<std::future<void>> pending_;
+
+  // Requests which are being sent to Spot, keyed by their serialized proto, so that identical requests from other
+  // callers wait for the same response instead of being sent again.
+  std::mutex in_flight_mutex_;
+  std::unordered_map<std::string, std::shared_future<tl::expected<InverseKinematicsResponse, std::string>>> in_flight_;
 };
 }  // namespace spot_ros2::kinematic
@@ -0,0 +1,85 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <spot_driver/api/kinematic_api.hpp>
+#include <spot_driver/interfaces/thread_pool_interface_base.hpp>
+#include <spot_driver/kinematic/forward_kinematics.hpp>
+
+#include <tl_expected/expected.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace spot_ros2::kinematic {
+
+/** Number of joints of the arm of Spot, without the gripper. */
+inline constexpr std::size_t kNumArmJoints = 6;
+
+/**
+ * Inverse kinematics of the arm of Spot, solved numerically with the URDF of the robot instead of Spot's inverse
+ * kinematics service. It is used where Spot does not offer that service, or where many requests have to be solved
+ * quickly.
+ *
+ * Unlike Spot's solver, the body is not moved: it stays at scene_tform_body_nominal, or at the scene frame if that is
+ * not set, and only the arm joints are solved for. Only tool pose tasks with a wrist mounted tool are supported. Each
+ * request is warm started from nominal_arm_configuration_overrides if set, and otherwise from the last solution found,
+ * before it is retried from fixed arm configurations. This class is thread-safe.
+ */
+class LocalKinematicApi : public KinematicApi {
+ public:
+  /**
+   * Create the solver for a URDF of Spot with an arm.
+   * @param kinematics Forward kinematics of the URDF.
+   * @param frame_prefix Prefix of the joints and links of the URDF, such as "Spot/".
+   * @param thread_pool Thread pool which solves the requests of a batch concurrently.
+   * @return The solver, or an error if the URDF has no arm.
+   */
+  static tl::expected<std::unique_ptr<LocalKinematicApi>, std::string> create(
+      ForwardKinematics kinematics, const std::string& frame_prefix,
+      std::shared_ptr<ThreadPoolInterfaceBase> thread_pool);
+
+  /**
+   * Solve the request on the calling thread. The timeout is ignored, since no request is sent to Spot.
+   */
+  tl::expected<InverseKinematicsResponse, std::string> getSolutions(InverseKinematicsRequest& request,
+                                                                    std::chrono::duration<double> timeout) override;
+
+  /**
+   * Solve the requests on up to max_requests_in_flight threads of the thread pool. The timeout is ignored.
+   */
+  std::vector<tl::expected<InverseKinematicsResponse, std::string>> getBatchSolutions(
+      std::vector<InverseKinematicsRequest>& requests, const std::size_t max_requests_in_flight,
+      std::chrono::duration<double> timeout) override;
+
+ private:
+  using ArmPositions = Eigen::Matrix<double, kNumArmJoints, 1>;
+
+  LocalKinematicApi(ForwardKinematics kinematics, std::array<std::size_t, kNumArmJoints> arm_joints,
+                    std::size_t wrist_link, std::shared_ptr<ThreadPoolInterfaceBase> thread_pool);
+
+  /**
+   * Move the arm from a seed until the wrist reaches a pose.
+   * @return The arm joint positions, if the pose was reached within the joint limits.
+   */
+  std::optional<ArmPositions> solve(const Eigen::Isometry3d& body_tform_wrist, const ArmPositions& seed) const;
+
+  ForwardKinematics kinematics_;
+  // Index of every arm joint in the joint positions of the kinematics, and of the wrist link.
+  std::array<std::size_t, kNumArmJoints> arm_joints_;
+  std::size_t wrist_link_;
+  ArmPositions lower_limits_;
+  ArmPositions upper_limits_;
+  std::shared_ptr<ThreadPoolInterfaceBase> thread_pool_;
+
+  // Last solution found, which warm starts the next request.
+  std::mutex last_solution_mutex_;
+  std::optional<ArmPositions> last_solution_;
+};
+}  // namespace spot_ros2::kinematic
@@ -0,0 +1,35 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <rclcpp/node.hpp>
+#include <spot_driver/metrics/metrics_publisher.hpp>
+
+#include <memory>
+
+namespace spot_ros2::metrics {
+/**
+ * @brief Implementation of MetricsPublisher::MiddlewareHandle
+ */
+class MetricsMiddlewareHandle : public MetricsPublisher::MiddlewareHandle {
+ public:
+  /**
+   * @brief Constructor for MetricsMiddlewareHandle
+   *
+   * @param node  A shared_ptr to an instance of a rclcpp::Node
+   */
+  explicit MetricsMiddlewareHandle(const std::shared_ptr<rclcpp::Node>& node);
+
+  /**
+   * @brief Publishes the metrics to the `/diagnostics` topic, stamped with the current time.
+   *
+   * @param diagnostics Diagnostic statuses to publish.
+   */
+  void publishDiagnostics(const diagnostic_msgs::msg::DiagnosticArray& diagnostics) override;
+
+ private:
+  std::shared_ptr<rclcpp::Node> node_;
+  std::shared_ptr<rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>> diagnostics_publisher_;
+};
+}  // namespace spot_ros2::metrics
@@ -0,0 +1,87 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <spot_driver/interfaces/logger_interface_base.hpp>
+#include <spot_driver/interfaces/parameter_interface_base.hpp>
+#include <spot_driver/interfaces/timer_interface_base.hpp>
+#include <spot_driver/metrics/metrics_registry.hpp>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spot_ros2::metrics {
+
+/**
+ * @brief Periodically publishes groups of a MetricsRegistry as diagnostics, and optionally writes them to a file for
+ * the textfile collector of the Prometheus node exporter.
+ */
+class MetricsPublisher {
+ public:
+  /**
+   * @brief A handle that enables dependency injection of ROS and rclcpp::Node operations
+   */
+  class MiddlewareHandle {
+   public:
+    virtual ~MiddlewareHandle() = default;
+    /** @brief Publish the metrics to the `/diagnostics` topic. */
+    virtual void publishDiagnostics(const diagnostic_msgs::msg::DiagnosticArray& diagnostics) = 0;
+  };
+
+  /** @brief Settings of a MetricsPublisher, which are read from the metrics_* parameters. */
+  struct Options {
+    /** @brief Time between two reports. The metrics are not published if it is zero or less. */
+    std::chrono::duration<double> period{1.0};
+    /** @brief Path of the Prometheus textfile which is rewritten with every report, or empty to not write one. */
+    std::string textfile;
+    /** @brief Labels which are added to every Prometheus sample, e.g. the name of the robot. */
+    std::map<std::string, std::string> labels;
+  };
+
+  /**
+   * @brief Constructor for MetricsPublisher, which starts the periodic reports.
+   *
+   * @param registry Registry whose metrics are reported.
+   * @param groups Groups of the registry which are reported, i.e. the groups that the owning node records into, so
+   * that composed nodes sharing a registry do not report each other's metrics.
+   * @param name_prefix Prefix of the names of the diagnostic statuses, e.g. the name of the node.
+   * @param options Report period, textfile and labels.
+   * @param middleware_handle Publishes the diagnostics.
+   * @param logger_interface Logs an error if the textfile cannot be written.
+   * @param timer_interface Repeatedly triggers the reports.
+   */
+  MetricsPublisher(const std::shared_ptr<const MetricsRegistry>& registry, const std::vector<std::string>& groups,
+                   const std::string& name_prefix, const Options& options,
+                   std::unique_ptr<MiddlewareHandle> middleware_handle,
+                   std::unique_ptr<LoggerInterfaceBase> logger_interface,
+                   std::unique_ptr<TimerInterfaceBase> timer_interface);
+
+ private:
+  /** @brief Publish the diagnostics and write the textfile. */
+  void timerCallback();
+
+  /** @brief Write the textfile through a temporary file, so that the collector never reads a partial file. */
+  void writeTextfile();
+
+  std::shared_ptr<const MetricsRegistry> registry_;
+  std::vector<std::string> groups_;
+  std::string name_prefix_;
+  Options options_;
+  std::unique_ptr<MiddlewareHandle> middleware_handle_;
+  std::unique_ptr<LoggerInterfaceBase> logger_interface_;
+  std::unique_ptr<TimerInterfaceBase> timer_interface_;
+};
+
+/**
+ * @brief Read the options of a MetricsPublisher from the metrics_publish_period and metrics_textfile parameters. The
+ * name of the robot, if set, is added as the `robot` label.
+ *
+ * @param parameters Parameters of the node which publishes the metrics.
+ * @return The options.
+ */
+MetricsPublisher::Options makeMetricsPublisherOptions(const ParameterInterfaceBase& parameters);
+}  // namespace spot_ros2::metrics
@@ -0,0 +1,150 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <diagnostic_msgs/msg/diagnostic_status.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace spot_ros2::metrics {
+
+/** @brief Monotonic counter of events, such as failed RPCs or dropped images, which any thread can increment. */
+class Counter {
+ public:
+  /** @brief Add to the counter. This is a single relaxed atomic addition. */
+  void increment(std::uint64_t value = 1) { value_.fetch_add(value, std::memory_order_relaxed); }
+
+  [[nodiscard]] std::uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<std::uint64_t> value_{0};
+};
+
+/**
+ * @brief Histogram of durations with fixed, roughly logarithmic bucket edges from 1 ms to 1 s, which can be recorded
+ * by any thread.
+ * @details The buckets, sum and maximum are separate relaxed atomics, so a report which runs concurrently with record()
+ * may see a sample in one of them before the others. This is accepted to keep record() free of locks.
+ */
+class Histogram {
+ public:
+  /** @brief Upper edges of the buckets, in seconds. Durations above the last edge are counted in an overflow bucket. */
+  static constexpr std::array<double, 10> kBucketEdges{0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0};
+
+  /** @brief Consistent copy of a histogram, from which reports are computed. */
+  struct Snapshot {
+    std::array<std::uint64_t, kBucketEdges.size() + 1> buckets{};
+    std::uint64_t count{0};
+    double sum{0.0};
+    double max{0.0};
+
+    /**
+     * @brief Get an upper bound of a percentile of the recorded durations.
+     *
+     * @param fraction Percentile as a fraction between 0 and 1, e.g. 0.95 for the 95th percentile.
+     * @return The upper edge of the bucket that contains the percentile, or the maximum if it is in the overflow
+     * bucket. Zero if nothing was recorded.
+     */
+    [[nodiscard]] double percentile(double fraction) const;
+
+    [[nodiscard]] double mean() const { return count > 0 ? sum / static_cast<double>(count) : 0.0; }
+  };
+
+  /**
+   * @brief Record a duration.
+   *
+   * @param duration Duration to record. Negative durations are recorded as zero.
+   */
+  void record(std::chrono::steady_clock::duration duration);
+
+  /** @brief Record a duration in seconds. */
+  void record(double seconds);
+
+  [[nodiscard]] Snapshot snapshot() const;
+
+ private:
+  std::array<std::atomic<std::uint64_t>, kBucketEdges.size() + 1> buckets_{};
+  std::atomic<std::uint64_t> sum_ns_{0};
+  std::atomic<std::uint64_t> max_ns_{0};
+};
+
+/**
+ * @brief Registry of the counters and histograms of the driver, which are shared by every component of the process.
+ * @details Metric names are dot-separated, and the part before the first dot is the group of the metric, e.g.
+ * `images.rpc_failures` belongs to the `images` group. Components look up their metrics once, when they are
+ * constructed, and then update them without touching the registry again, so only registration takes its lock. The
+ * returned references stay valid for the lifetime of the registry.
+ */
+class MetricsRegistry {
+ public:
+  /**
+   * @brief Get the registry which is shared by the nodes of this process, so that composed nodes report into one place.
+   *
+   * @return The process-wide registry, which is created by the first call.
+   */
+  static std::shared_ptr<MetricsRegistry> getDefault();
+
+  /**
+   * @brief Get the registry which is shared by the nodes of one robot in this process, so that the metrics of robots
+   * whose nodes are composed into the same container are kept apart.
+   *
+   * @param robot_name Name of the robot. The nodes of an unnamed robot report into the default registry.
+   * @return The registry of the robot, which is created by the first call for that robot.
+   */
+  static std::shared_ptr<MetricsRegistry> getForRobot(const std::string& robot_name);
+
+  /**
+   * @brief Get a counter, and register it if it does not exist yet.
+   *
+   * @param name Dot-separated name of the counter, e.g. `images.rpc_failures`.
+   * @return The counter, which stays valid as long as the registry.
+   */
+  Counter& counter(const std::string& name);
+
+  /**
+   * @brief Get a histogram, and register it if it does not exist yet.
+   *
+   * @param name Dot-separated name of the histogram, e.g. `images.rpc_latency`.
+   * @return The histogram, which stays valid as long as the registry.
+   */
+  Histogram& histogram(const std::string& name);
+
+  /**
+   * @brief Create one diagnostic status per group, which reports the value of each counter and the count, mean, 50th
+   * and 95th percentile and maximum of each histogram in milliseconds.
+   *
+   * @param name_prefix Prefix of the names of the statuses, which are followed by the group.
+   * @param groups Groups to report. Every group is reported if this is empty.
+   * @return The diagnostic statuses, ordered by group.
+   */
+  [[nodiscard]] std::vector<diagnostic_msgs::msg::DiagnosticStatus> toDiagnosticStatus(
+      const std::string& name_prefix, const std::vector<std::string>& groups = {}) const;
+
+  /**
+   * @brief Format the metrics in the Prometheus text exposition format, e.g. to be collected by the textfile collector
+   * of the Prometheus node exporter.
+   * @details A metric `images.rpc_failures` is exported as `spot_driver_images_rpc_failures_total`, and a histogram
+   * `images.rpc_latency` as `spot_driver_images_rpc_latency_seconds` with cumulative buckets, sum and count.
+   *
+   * @param labels Labels which are added to every sample, e.g. `{"robot", "spot1"}`.
+   * @param groups Groups to export. Every group is exported if this is empty.
+   * @return The metrics in the text exposition format.
+   */
+  [[nodiscard]] std::string toPrometheusText(const std::map<std::string, std::string>& labels = {},
+                                             const std::vector<std::string>& groups = {}) const;
+
+ private:
+  mutable std::mutex mutex_;
+  // Node based maps, so that references to the metrics are stable when other metrics are registered.
+  std::map<std::string, std::unique_ptr<Counter>> counters_;
+  std::map<std::string, std::unique_ptr<Histogram>> histograms_;
+};
+}  // namespace spot_ros2::metrics
@@ -2,8 +2,17 @@
 
 #pragma once
 
+#include <google/protobuf/timestamp.pb.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <geometry_msgs/msg/transform.hpp>
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <map>
 #include <memory>
+#include <optional>
+#include <rclcpp/duration.hpp>
 #include <rclcpp/node.hpp>
 #include <set>
 #include <spot_driver/api/state_client_interface.hpp>
@@ -18,6 +27,7 @@
 #include <spot_driver/types.hpp>
 #include <string>
 #include <tl_expected/expected.hpp>
+#include <vector>
 
 namespace spot_ros2 {
 /**
@@ -40,6 +50,7 @@ class ObjectSynchronizer {
    * @param world_object_update_timer Allows repeatedly requesting the lists of known world objects and known TF frame
    * IDs.
    * @param tf_broadcaster_timer Regularly publishes TF frames for Spot world objects.
+   * The two timers may run their callbacks on different threads at the same time, which only share the managed frames.
    * @param clock_interface Gets the current timestamp when looking up transforms.
    */
   ObjectSynchronizer(const std::shared_ptr<WorldObjectClientInterface>& world_object_client_interface,
@@ -69,29 +80,139 @@ class ObjectSynchronizer {
    */
   void addManagedFrame(const std::string& frame_id);
 
- private:
+  /**
+   * @brief Get the current snapshot of managed_frames_. Locks managed_frames_mutex_ only to copy the pointer.
+   * @return The frame IDs of TF frames which have been added to Spot's world model by ObjectSynchronizer. The snapshot
+   * is never modified, since addManagedFrame() replaces it instead.
+   */
+  std::shared_ptr<const std::set<std::string, std::less<>>> getManagedFramesSnapshot() const;
+
   /**
    * @brief Timer callback function triggered by world_object_update_timer_.
    * @details All the work of retrieving TF and world object information and updating world objects as needed happens
-   * within this function.
+   * within this function. It is protected so that benchmarks can run a sync while its timer is disabled.
    */
   void syncWorldObjects();
 
+ private:
+
+  /**
+   * @brief Update the cached frames of the objects which ObjectSynchronizer must not modify, and the cached names and
+   * IDs of the objects which it may modify.
+   * @details Only the objects updated since the last call are listed, except when the caches are older than their
+   * lifetime, in which case all objects are listed and the caches are replaced.
+   *
+   * @param timepoint_now The current time, used to check the lifetime of the caches.
+   * @return True if the caches were updated, or false if listing the objects failed.
+   */
+  bool updateObjectCaches(const rclcpp::Time& timepoint_now);
+
   /**
    * @brief Timer callback function triggered by tf_broadcaster_timer_.
    * @details Lists world objects known to Spot and broadcasts TF data for all objects which were not added to Spot's
-   * world model by this class.
+   * world model by this class. Only the objects which were updated since the last listed object are requested, except
+   * for a periodic full list which also republishes the TF data of objects that did not change. If the world object TF
+   * rate is higher than the rate of the lists, the objects are only listed on some of the calls, and every call
+   * publishes the interpolated poses of all recently listed objects at the current time instead.
    */
   void broadcastWorldObjectTransforms();
 
+  /**
+   * @brief List the world objects which were updated since the last listed object, and store their TF data in
+   * object_transforms_.
+   *
+   * @return True if the objects were listed, or false if getting the clock skew or listing the objects failed.
+   */
+  bool listWorldObjectTransforms();
+
+  /**
+   * @brief Add the transforms in object_transforms_ to object_poses_, and forget the poses of objects which were not
+   * listed for a while.
+   *
+   * @param timepoint_now The current time, at which the poses start blending towards the new transforms.
+   */
+  void updateObjectPoses(const rclcpp::Time& timepoint_now);
+
+  /**
+   * @brief Publish the poses in object_poses_, interpolated at and stamped with the current time.
+   *
+   * @param timepoint_now The current time.
+   */
+  void publishObjectPoses(const rclcpp::Time& timepoint_now);
+
   std::string frame_prefix_;
   std::string preferred_base_frame_;
   std::string preferred_base_frame_with_prefix_;
+  /** @brief Distance in meters and angle in radians that a TF frame must move by before it is sent to Spot again. */
+  double translation_threshold_ = 0.0;
+  double rotation_threshold_ = 0.0;
 
-  /** @brief Protects access to managed_frames_, since it can be read and modified from multiple threads. */
+  /** @brief Time after which a world object request is cancelled, so that a hung request does not stall the sync. */
+  std::chrono::duration<double> request_timeout_{0.0};
+
+  /** @brief Protects access to managed_frames_, since it can be read and replaced from multiple threads. */
   mutable std::mutex managed_frames_mutex_;
-  /** @brief Stores the frame IDs of all TF frames which have been added to Spot's world model by this class. */
-  std::set<std::string, std::less<>> managed_frames_;
+  /**
+   * @brief Stores the frame IDs of all TF frames which have been added to Spot's world model by this class.
+   * @details Frames are rarely added but looked up on every broadcast, so readers share an immutable snapshot which is
+   * replaced by a modified copy when a frame is added.
+   */
+  std::shared_ptr<const std::set<std::string, std::less<>>> managed_frames_ =
+      std::make_shared<const std::set<std::string, std::less<>>>();
+
+  /** @brief Frames of the world objects which ObjectSynchronizer must not modify, excluding Spot's internal frames. */
+  std::set<std::string, std::less<>> non_mutable_frames_;
+  /** @brief Names and IDs of the world objects which ObjectSynchronizer may modify. */
+  std::map<std::string, int, std::less<>> mutable_object_ids_;
+  /** @brief Latest acquisition times of the cached objects, used to only list objects updated after them. */
+  std::optional<google::protobuf::Timestamp> non_mutable_objects_time_;
+  std::optional<google::protobuf::Timestamp> mutable_objects_time_;
+  /** @brief Transform of a TF frame which was last sent to Spot, and when it was sent. */
+  struct SentTransform {
+    geometry_msgs::msg::Transform transform;
+    rclcpp::Time time;
+  };
+  /** @brief Last sent transform of every TF frame which was added to or modified in Spot's world model. */
+  std::map<std::string, SentTransform, std::less<>> sent_transforms_;
+
+  /** @brief Generation of the TF listener at the last sync, used to only get the frames updated since then. */
+  std::uint64_t tf_generation_ = 0;
+  /** @brief TF frames which were updated recently, and the time of the sync at which they were last updated. */
+  std::map<std::string, rclcpp::Time, std::less<>> updated_frames_;
+
+  /** @brief Time at which the caches were last replaced by a full list of the world objects. */
+  std::optional<rclcpp::Time> object_caches_refresh_time_;
+
+  /** @brief Latest acquisition time of the listed world objects, used to only request objects updated after it. */
+  std::optional<google::protobuf::Timestamp> latest_object_time_;
+  /** @brief Number of incremental lists since the last full list of world objects. */
+  std::size_t incremental_lists_ = 0;
+  /** @brief Transforms of all world objects of the current broadcast, which are sent together. */
+  std::vector<geometry_msgs::msg::TransformStamped> object_transforms_;
+
+  /**
+   * @brief Number of calls of broadcastWorldObjectTransforms() per list of the world objects. A value of zero publishes
+   * the listed transforms with their acquisition time instead of interpolating them.
+   */
+  std::size_t broadcasts_per_list_ = 0;
+  /** @brief Number of calls of broadcastWorldObjectTransforms() so far, used to list the objects on some of them. */
+  std::size_t broadcasts_ = 0;
+  /** @brief Time over which the published pose of an object blends from its previous pose to a newly listed one. */
+  rclcpp::Duration blend_duration_{0, 0};
+  /** @brief Pose history of a world object frame, from which its published pose is interpolated. */
+  struct ObjectPose {
+    /** @brief Pose published when the latest transform was listed, which the published pose blends from. */
+    geometry_msgs::msg::TransformStamped from;
+    /** @brief Latest listed transform, which the published pose blends to. */
+    geometry_msgs::msg::TransformStamped to;
+    rclcpp::Time blend_start;
+    /** @brief Time at which the object was last listed, used to forget objects which disappeared. */
+    rclcpp::Time last_listed;
+  };
+  /** @brief Pose histories of the world object frames, by child frame ID. */
+  std::map<std::string, ObjectPose, std::less<>> object_poses_;
+  /** @brief Interpolated transforms of the current broadcast. The vector keeps its capacity between broadcasts. */
+  std::vector<geometry_msgs::msg::TransformStamped> interpolated_transforms_;
 
   // Interface classes to interact with Spot and the middleware.
   std::shared_ptr<WorldObjectClientInterface> world_object_client_interface_;
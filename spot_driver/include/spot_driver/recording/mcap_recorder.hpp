@@ -0,0 +1,70 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <rosbag2_cpp/writer.hpp>
+#include <spot_driver/interfaces/thread_settings.hpp>
+#include <spot_driver/metrics/metrics_registry.hpp>
+#include <spot_driver/recording/recording_tap.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace spot_ros2::recording {
+
+/**
+ * @brief Writes the messages handed to it by the RecordingTap into a bag on a background thread.
+ * @details The messages are queued by the publishing threads of the driver, and serialized and written by the thread
+ * of the recorder, so that neither serialization nor file I/O delays publishing. If the writer falls behind by more
+ * than the maximum queue size, new messages are dropped and counted in the `recording.dropped_messages` metric.
+ */
+class McapRecorder : public RecordingSink {
+ public:
+  /**
+   * @brief Start the thread of the recorder.
+   *
+   * @param writer Writer of an open bag. The node opens it with the MCAP storage plugin and a chunk compression preset.
+   * @param max_queue_size Maximum number of messages waiting to be written.
+   * @param metrics Registry to report the written and dropped messages and the write time to.
+   */
+  McapRecorder(std::unique_ptr<rosbag2_cpp::Writer> writer, std::size_t max_queue_size,
+               const std::shared_ptr<metrics::MetricsRegistry>& metrics);
+
+  /** @brief Write the messages which are still queued, and close the bag. */
+  ~McapRecorder() override;
+
+  void write(RecordedMessage message) override;
+
+  /**
+   * @brief Name the thread of the recorder and pin it to CPUs.
+   *
+   * @param settings Settings of the thread.
+   * @return Nothing, or an error message if the thread could not be configured.
+   */
+  tl::expected<void, std::string> setThreadSettings(const ThreadSettings& settings);
+
+ private:
+  void writeQueuedMessages();
+
+  std::unique_ptr<rosbag2_cpp::Writer> writer_;
+  std::size_t max_queue_size_;
+
+  std::mutex mutex_;
+  std::condition_variable queue_changed_;
+  std::deque<RecordedMessage> queue_;
+  bool stop_{false};
+
+  metrics::Counter& written_messages_;
+  metrics::Counter& dropped_messages_;
+  metrics::Counter& write_failures_;
+  metrics::Histogram& write_time_;
+
+  std::thread thread_;
+};
+}  // namespace spot_ros2::recording
@@ -0,0 +1,38 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <rclcpp/node.hpp>
+#include <rclcpp/node_interfaces/node_base_interface.hpp>
+#include <spot_driver/recording/mcap_recorder.hpp>
+#include <spot_driver/recording/recording_tap.hpp>
+
+#include <memory>
+
+namespace spot_ros2::recording {
+/**
+ * @brief Records the data of the driver nodes in the same process to an MCAP file, without subscribing to them.
+ * @details The node is meant to be composed into the driver container. The images are recorded as they are published,
+ * so RGB images are recorded from the compressed images which are copied from the JPEG payload that Spot sent, and
+ * require `publish_compressed_images`. The robot state, odometry and TF are recorded as well.
+ *
+ * The node reads the parameters:
+ * - `recording_uri`: Directory of the bag. Defaults to `spot_recording_<date>_<time>` in the working directory.
+ * - `recording_storage_preset`: Preset of the MCAP storage plugin, which selects the chunk compression. Defaults to
+ *   `zstd_fast`.
+ * - `recording_queue_size`: Maximum number of messages waiting to be written before new ones are dropped.
+ */
+class McapRecorderNode {
+ public:
+  explicit McapRecorderNode(const rclcpp::NodeOptions& options = rclcpp::NodeOptions{});
+
+  ~McapRecorderNode();
+
+  std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> get_node_base_interface();
+
+ private:
+  std::shared_ptr<rclcpp::Node> node_;
+  std::shared_ptr<RecordingTap> tap_;
+  std::shared_ptr<McapRecorder> recorder_;
+};
+}  // namespace spot_ros2::recording
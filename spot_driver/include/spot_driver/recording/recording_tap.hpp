@@ -0,0 +1,93 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <rclcpp/serialization.hpp>
+#include <rclcpp/serialized_message.hpp>
+#include <rclcpp/time.hpp>
+#include <rosidl_runtime_cpp/traits.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace spot_ros2::recording {
+
+/** @brief Message which the driver handed to a recorder. It is only serialized when the recorder writes it. */
+struct RecordedMessage {
+  /** @brief Fully qualified topic of the message, e.g. `/Opal/camera/frontleft/compressed`. */
+  std::string topic;
+  /** @brief ROS type of the message, e.g. `sensor_msgs/msg/CompressedImage`. */
+  std::string type_name;
+  /** @brief Time at which the driver published the message. */
+  rclcpp::Time log_time;
+  /** @brief Serialize the message to CDR. This is called once, by the thread which writes the message. */
+  std::function<void(rclcpp::SerializedMessage&)> serialize;
+};
+
+/** @brief Destination of the messages which the driver records within its own process, without going through DDS. */
+class RecordingSink {
+ public:
+  virtual ~RecordingSink() = default;
+
+  /**
+   * @brief Queue a message to be written.
+   * @details This is called by the threads which publish the data of the driver, so it must return quickly and leave
+   * the serialization to the thread which writes the message.
+   */
+  virtual void write(RecordedMessage message) = 0;
+};
+
+/**
+ * @brief Point at which the publishers of the driver hand their messages to a recorder in the same process.
+ * @details Publishers check isActive() before they copy a message for the recorder, so the tap costs a single relaxed
+ * atomic load while no recorder is attached. At most one sink is attached at a time.
+ */
+class RecordingTap {
+ public:
+  /**
+   * @brief Get the tap which is shared by the nodes of this process, so that a recorder composed into the driver
+   * container receives the messages of every driver node.
+   *
+   * @return The process-wide tap, which is created by the first call.
+   */
+  static std::shared_ptr<RecordingTap> getDefault();
+
+  /** @brief Attach a sink, which replaces the one that is attached, if any. */
+  void attach(std::shared_ptr<RecordingSink> sink);
+
+  /** @brief Detach a sink. Nothing happens if another sink was attached since. */
+  void detach(const RecordingSink* sink);
+
+  [[nodiscard]] bool isActive() const { return active_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Hand a message to the attached sink, if any.
+   *
+   * @param topic Fully qualified topic of the message.
+   * @param message Copy of the message, which is kept until the sink serializes it.
+   * @param log_time Time at which the message was published.
+   */
+  template <typename MessageT>
+  void record(std::string topic, MessageT message, const rclcpp::Time& log_time) {
+    const auto sink = currentSink();
+    if (!sink) {
+      return;
+    }
+    sink->write(RecordedMessage{std::move(topic), rosidl_generator_traits::name<MessageT>(), log_time,
+                                [message = std::move(message)](rclcpp::SerializedMessage& serialized) {
+                                  rclcpp::Serialization<MessageT>{}.serialize_message(&message, &serialized);
+                                }});
+  }
+
+ private:
+  [[nodiscard]] std::shared_ptr<RecordingSink> currentSink() const;
+
+  mutable std::mutex mutex_;
+  std::shared_ptr<RecordingSink> sink_;
+  std::atomic<bool> active_{false};
+};
+}  // namespace spot_ros2::recording
@@ -0,0 +1,107 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <bosdyn/api/robot_state.pb.h>
+#include <google/protobuf/duration.pb.h>
+#include <geometry_msgs/msg/pose.hpp>
+#include <geometry_msgs/msg/twist.hpp>
+
+namespace spot_ros2 {
+
+/** @brief Body pose, body velocity and joint states of one robot state, stamped in the clock of the host. */
+struct RobotStateSnapshot {
+  /** @brief Maximum number of joints, which covers the legs, the arm and the gripper. */
+  static constexpr std::size_t kMaxJoints = 19;
+
+  /** @brief Acquisition time of the robot state in nanoseconds, converted to the clock of the host. */
+  std::int64_t stamp_ns{0};
+  geometry_msgs::msg::Pose odom_tform_body;
+  geometry_msgs::msg::Pose vision_tform_body;
+  geometry_msgs::msg::Twist body_velocity_in_odom;
+
+  std::size_t joint_count{0};
+  /** @brief Friendly names of the joints, without the frame prefix. They point into kFriendlyJointNames. */
+  std::array<const std::string*, kMaxJoints> joint_names{};
+  std::array<double, kMaxJoints> joint_positions{};
+  std::array<double, kMaxJoints> joint_velocities{};
+  std::array<double, kMaxJoints> joint_efforts{};
+};
+
+/**
+ * @brief Create a snapshot of a robot state.
+ *
+ * @param robot_state Robot state from Spot.
+ * @param clock_skew Clock skew between Spot and the host, which is used to stamp the snapshot in the clock of the host.
+ * @return The snapshot, or nullopt if the robot state does not contain the body poses in the odom and vision frames.
+ */
+std::optional<RobotStateSnapshot> makeRobotStateSnapshot(const ::bosdyn::api::RobotState& robot_state,
+                                                         const google::protobuf::Duration& clock_skew);
+
+/**
+ * @brief Fixed-size history of the most recent robot state snapshots, which can be queried at any time within the
+ * history.
+ * @details Snapshots are added by a single writer, and read by any number of threads without locks. Every slot is
+ * guarded by a sequence number, so a reader which raced with the writer retries or skips the slot instead of waiting.
+ */
+class RobotStateHistory {
+ public:
+  /**
+   * @brief Constructor for RobotStateHistory.
+   *
+   * @param capacity Number of snapshots which are kept. It is at least one.
+   */
+  explicit RobotStateHistory(std::size_t capacity);
+
+  /**
+   * @brief Add a snapshot, which replaces the oldest one once the history is full. Must only be called from one thread
+   * at a time, with stamps that do not decrease.
+   */
+  void add(const RobotStateSnapshot& snapshot);
+
+  /** @return The most recent snapshot, or nullopt if the history is empty. */
+  [[nodiscard]] std::optional<RobotStateSnapshot> latest() const;
+
+  /**
+   * @brief Get the robot state at a time within the history.
+   * @details The positions, velocities and joint states are linearly interpolated between the two snapshots around the
+   * requested time, and the orientations are spherically interpolated.
+   *
+   * @param stamp_ns Time in nanoseconds in the clock of the host.
+   * @return The interpolated snapshot, or nullopt if the time is before the oldest or after the latest snapshot.
+   */
+  [[nodiscard]] std::optional<RobotStateSnapshot> lookup(std::int64_t stamp_ns) const;
+
+  [[nodiscard]] std::size_t capacity() const { return capacity_; }
+
+ private:
+  struct Slot {
+    /** @brief Twice the index of the snapshot in the slot plus two once it is written, and plus one while writing. */
+    std::atomic<std::uint64_t> sequence{0};
+    RobotStateSnapshot snapshot;
+  };
+
+  /**
+   * @brief Copy a snapshot out of its slot.
+   *
+   * @param index Index of the snapshot, counted from the first snapshot that was added.
+   * @param snapshot Receives the snapshot.
+   * @return False if the snapshot was overwritten by a newer one.
+   */
+  bool read(std::uint64_t index, RobotStateSnapshot& snapshot) const;
+
+  std::size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  /** @brief Number of snapshots added so far, which is only published after the newest snapshot is written. */
+  std::atomic<std::uint64_t> count_{0};
+};
+
+}  // namespace spot_ros2
@@ -8,7 +8,9 @@
 #include <nav_msgs/msg/odometry.hpp>
 #include <rclcpp/node.hpp>
 #include <rclcpp/node_options.hpp>
+#include <rclcpp/qos.hpp>
 #include <sensor_msgs/msg/joint_state.hpp>
+#include <spot_driver/recording/recording_tap.hpp>
 #include <spot_driver/robot_state/state_publisher.hpp>
 #include <spot_driver/types.hpp>
 #include <spot_msgs/msg/battery_state_array.hpp>
@@ -16,8 +18,10 @@
 #include <spot_msgs/msg/e_stop_state_array.hpp>
 #include <spot_msgs/msg/foot_state_array.hpp>
 #include <spot_msgs/msg/power_state.hpp>
+#include <spot_msgs/msg/serialized_proto.hpp>
 #include <spot_msgs/msg/system_fault_state.hpp>
 #include <spot_msgs/msg/wi_fi_state.hpp>
+#include <spot_msgs/srv/get_robot_state_at_time.hpp>
 
 namespace spot_ros2 {
 
@@ -28,11 +32,27 @@ namespace spot_ros2 {
 class StateMiddlewareHandle : public StatePublisher::MiddlewareHandle {
  public:
   /**
-   * @brief Constructor for StateMiddlewareHandle.
+   * @brief Read the QoS profile of the robot state publishers from the `qos.state.*` parameters. If they are invalid,
+   * fall back to the default profile, with a warning.
+   * @param parameters Parameter interface to read the QoS settings from.
+   * @param logger Logger for the warning about invalid settings.
+   * @return The QoS profile.
+   */
+  static rclcpp::QoS loadPublisherQoS(const ParameterInterfaceBase& parameters, const LoggerInterfaceBase& logger);
+
+  /**
+   * @brief Constructor for StateMiddlewareHandle, whose publishers use the default QoS profile.
    * @param node A shared_pr to an instance of rclcpp::Node.
    */
   explicit StateMiddlewareHandle(const std::shared_ptr<rclcpp::Node>& node);
 
+  /**
+   * @brief Constructor for StateMiddlewareHandle.
+   * @param node A shared_pr to an instance of rclcpp::Node.
+   * @param qos QoS profile of the publishers, usually from loadPublisherQoS().
+   */
+  StateMiddlewareHandle(const std::shared_ptr<rclcpp::Node>& node, const rclcpp::QoS& qos);
+
   /**
    * @brief Constructor for StateMiddlewareHandle.
    * @details This constructor creates a new rclcpp::Node using the provided NodeOptions.
@@ -43,15 +63,57 @@ class StateMiddlewareHandle : public StatePublisher::MiddlewareHandle {
   ~StateMiddlewareHandle() override = default;
 
   /**
-   * @brief Publish robot state messages
+   * @brief Publish the odometry and odometry twist messages
+   * @param robot_state_msgs Robot state messages, of which only the odometry and odometry twist are published
+   */
+  void publishOdometry(const RobotStateMessages& robot_state_msgs) override;
+
+  /**
+   * @brief Publish robot state messages, except for the odometry and odometry twist
    * @param robot_state_msgs Robot state messages to publish
    */
   void publishRobotState(const RobotStateMessages& robot_state_msgs) override;
 
+  /**
+   * @brief Publish the serialized robot state on robot_state/raw. The publisher is created on the first call, so that
+   * the topic only exists if raw robot states are published.
+   * @param robot_state Robot state to serialize.
+   */
+  void publishRawRobotState(const bosdyn::api::RobotState& robot_state) override;
+
+  /**
+   * @brief Check whether a robot state topic has subscribers, so that its conversion can be skipped otherwise.
+   * @param topic Robot state topic.
+   * @return True if the topic has subscribers or keeps its last message for late subscribers.
+   */
+  bool hasSubscribers(StatePublisher::Topic topic) const override;
+
+  /**
+   * @brief Create the service which answers requests for the robot state at a time within the robot state history.
+   * @param callback Fills the response of each request.
+   */
+  void createGetRobotStateAtTimeService(const GetRobotStateAtTimeCallback& callback) override;
+
+  /**
+   * @brief Subscribe to low_level/joint_states, on which spot_ros2_control streams the joint states of the hardware
+   * interface. Only the latest message is kept, since older joint states are stale.
+   * @param callback Called with each message.
+   */
+  void subscribeToLowLevelJointStates(const JointStatesCallback& callback) override;
+
+  /**
+   * @brief Publish joint states on joint_states, and hand them to the recorder if it is recording.
+   * @param joint_states Joint states to publish.
+   */
+  void publishJointStates(const sensor_msgs::msg::JointState& joint_states) override;
+
  private:
   /** @brief Shared instance of an rclcpp node to create publishers */
   std::shared_ptr<rclcpp::Node> node_;
 
+  /** @brief QoS profile of the publishers, which is only read from the parameters once. */
+  rclcpp::QoS qos_;
+
   std::shared_ptr<rclcpp::Publisher<spot_msgs::msg::BatteryStateArray>> battery_states_publisher_;
   std::shared_ptr<rclcpp::Publisher<spot_msgs::msg::WiFiState>> wifi_state_publisher_;
   std::shared_ptr<rclcpp::Publisher<spot_msgs::msg::FootStateArray>> foot_states_publisher_;
@@ -64,6 +126,13 @@ class StateMiddlewareHandle : public StatePublisher::MiddlewareHandle {
   std::shared_ptr<rclcpp::Publisher<bosdyn_api_msgs::msg::ManipulatorState>> manipulator_state_publisher_;
   std::shared_ptr<rclcpp::Publisher<geometry_msgs::msg::Vector3Stamped>> end_effector_force_publisher_;
   std::shared_ptr<rclcpp::Publisher<spot_msgs::msg::BehaviorFaultState>> behavior_fault_state_publisher_;
+  std::shared_ptr<rclcpp::Publisher<spot_msgs::msg::SerializedProto>> raw_robot_state_publisher_;
+  /** @brief Message of the serialized robot state, which is reused so that its buffer stays allocated. */
+  spot_msgs::msg::SerializedProto raw_robot_state_;
+  std::shared_ptr<rclcpp::Service<spot_msgs::srv::GetRobotStateAtTime>> get_robot_state_at_time_service_;
+  std::shared_ptr<rclcpp::Subscription<sensor_msgs::msg::JointState>> low_level_joint_states_subscription_;
+  /** @brief Tap through which the converted robot state is also handed to a recorder in the same process. */
+  std::shared_ptr<recording::RecordingTap> recording_tap_{recording::RecordingTap::getDefault()};
 };
 
 }  // namespace spot_ros2
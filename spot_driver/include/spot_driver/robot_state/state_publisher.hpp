@@ -2,17 +2,33 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <thread>
 
+#include <bosdyn/api/robot_state.pb.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <sensor_msgs/msg/joint_state.hpp>
+
+#include <spot_driver/api/link_monitor.hpp>
 #include <spot_driver/api/middleware_handle_base.hpp>
 #include <spot_driver/api/state_client_interface.hpp>
 #include <spot_driver/api/time_sync_api.hpp>
+#include <spot_driver/conversions/robot_state.hpp>
+#include <spot_driver/robot_state/robot_state_history.hpp>
 #include <spot_driver/interfaces/logger_interface_base.hpp>
 #include <spot_driver/interfaces/parameter_interface_base.hpp>
 #include <spot_driver/interfaces/tf_broadcaster_interface_base.hpp>
 #include <spot_driver/interfaces/timer_interface_base.hpp>
+#include <spot_driver/metrics/metrics_registry.hpp>
 #include <spot_driver/types.hpp>
+#include <spot_msgs/srv/get_robot_state_at_time.hpp>
 
 namespace spot_ros2 {
 
@@ -22,13 +38,50 @@ namespace spot_ros2 {
  */
 class StatePublisher {
  public:
+  /** @brief Robot state topics, which can each be published at their own rate. */
+  enum class Topic : std::size_t {
+    kBatteryStates,
+    kWifi,
+    kFeet,
+    kEStop,
+    kJointStates,
+    kTf,
+    kOdometryTwist,
+    kOdometry,
+    kPowerStates,
+    kSystemFaults,
+    kManipulationState,
+    kEndEffectorForce,
+    kBehaviorFaults,
+    /** @brief Serialized robot state protobuf, which is only published if `publish_raw_protobuf` is set. */
+    kRaw,
+    kCount,
+  };
+
   /**
    * @brief A handle that enables dependency injection of ROS and rclcpp::Node operations
    */
   class MiddlewareHandle : public MiddlewareHandleBase {
    public:
     virtual ~MiddlewareHandle() = default;
+    /** @brief Publish the odometry and odometry twist messages, which are published ahead of the other topics. */
+    virtual void publishOdometry(const RobotStateMessages& robot_state_msgs) = 0;
+    /** @brief Publish every other robot state message. */
     virtual void publishRobotState(const RobotStateMessages& robot_state_msgs) = 0;
+    /** @brief Publish the robot state as the serialized protobuf message, without converting it. */
+    virtual void publishRawRobotState(const bosdyn::api::RobotState& robot_state) = 0;
+    virtual bool hasSubscribers(Topic topic) const = 0;
+
+    using GetRobotStateAtTimeCallback =
+        std::function<void(const std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Request>,
+                           std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Response>)>;
+    virtual void createGetRobotStateAtTimeService(const GetRobotStateAtTimeCallback& callback) = 0;
+
+    using JointStatesCallback = std::function<void(const sensor_msgs::msg::JointState&)>;
+    /** @brief Subscribe to the joint states which spot_ros2_control streams from the hardware interface. */
+    virtual void subscribeToLowLevelJointStates(const JointStatesCallback& callback) = 0;
+    /** @brief Publish joint states which did not come from the robot state, i.e. the relayed low-level ones. */
+    virtual void publishJointStates(const sensor_msgs::msg::JointState& joint_states) = 0;
   };
 
   /**
@@ -44,7 +97,9 @@ class StatePublisher {
    * @param logger_interface Logs error messages if requesting, processing, and publishing the robot state info does not
    * succeed.
    * @param tf_broadcaster_interface Publishes the dynamic transforms in Spot's robot state to TF.
-   * @param timer_interface Repeatedly triggers timerCallback() using the middleware's clock.
+   * @param timer_interface Repeatedly triggers timerCallback() using the middleware's clock. It is not used if the
+   * robot state is streamed.
+   * @param metrics_registry Records the failures and latencies of the robot state requests, in the `robot_state` group.
    *
    */
   StatePublisher(const std::shared_ptr<StateClientInterface>& state_client_interface,
@@ -52,7 +107,19 @@ class StatePublisher {
                  std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                  std::unique_ptr<LoggerInterfaceBase> logger_interface,
                  std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
-                 std::unique_ptr<TimerInterfaceBase> timer_interface);
+                 std::unique_ptr<TimerInterfaceBase> timer_interface,
+                 const std::shared_ptr<metrics::MetricsRegistry>& metrics_registry =
+                     metrics::MetricsRegistry::getDefault());
+
+  /** @brief Stops streaming the robot state, if it is streamed. */
+  ~StatePublisher();
+
+  /**
+   * @brief Get the history of recent robot states, which composed nodes can query without a service call.
+   *
+   * @return The history, which is filled with every new robot state, or nullptr if the history is disabled.
+   */
+  [[nodiscard]] std::shared_ptr<const RobotStateHistory> getRobotStateHistory() const { return robot_state_history_; }
 
  private:
   /**
@@ -60,12 +127,146 @@ class StatePublisher {
    */
   void timerCallback();
 
+  /**
+   * @brief Request the robot state back to back until the StatePublisher is destroyed, and publish each new state as
+   * soon as it arrives.
+   */
+  void streamRobotState();
+
+  /**
+   * @brief Request the robot state once, and publish it.
+   *
+   * @param drop_repeated If true, a state with the same acquisition timestamp as the previous one is not published.
+   * @return False if the clock skew or robot state could not be retrieved.
+   */
+  bool requestAndPublishRobotState(bool drop_repeated);
+
+  /**
+   * @brief Read the quality of the link from link_monitor_, and log when it changes.
+   *
+   * @return True if the link is degraded, in which case the robot state is requested and the status topics are
+   * published less often.
+   */
+  bool updateLinkDegraded();
+
+  /**
+   * @brief Relay joint states of the low-level stream on joint_states, and note their arrival so that the joint states
+   * of the robot state are not published while the stream is live.
+   *
+   * @param joint_states Joint states streamed by spot_ros2_control.
+   */
+  void lowLevelJointStatesCallback(const sensor_msgs::msg::JointState& joint_states);
+
+  /**
+   * @brief Check whether low-level joint states arrived recently enough to replace the joint states of the robot state.
+   *
+   * @param now Current time.
+   * @return True if the low-level stream is relayed and its last message is newer than kLowLevelJointStatesTimeout.
+   */
+  bool lowLevelJointStatesLive(std::chrono::steady_clock::time_point now) const;
+
+  /** @brief Publish rate limit of one robot state topic. */
+  struct TopicRate {
+    /** @brief Minimum time between two messages. Zero publishes every robot state. */
+    std::chrono::steady_clock::duration period{0};
+    /** @brief Earliest time at which the next message is published. */
+    std::chrono::steady_clock::time_point next_publish;
+    /** @brief Fingerprint of the content of the last message, for topics which are only published on change. */
+    std::optional<std::size_t> fingerprint;
+    /** @brief Time at which the last message was published, used for the heartbeat of topics published on change. */
+    std::chrono::steady_clock::time_point last_publish;
+  };
+
+  /**
+   * @brief Check whether a topic has to be published with the current robot state, and if so, schedule its next
+   * message. Topics without subscribers are never due, except for TF, which is also broadcast to the TF buffer of the
+   * driver.
+   *
+   * @param topic Robot state topic.
+   * @param now Time at which the robot state is published.
+   * @return True if the message of the topic is due, or false if its conversion can be skipped.
+   */
+  bool isDue(Topic topic, std::chrono::steady_clock::time_point now);
+
+  /**
+   * @brief Check whether the content of a status topic changed since its last message, if status topics are only
+   * published on change.
+   *
+   * @param topic Status topic, which is one of the battery, WiFi, E-Stop, power and fault topics.
+   * @param robot_state Current robot state.
+   * @param now Time at which the robot state is published.
+   * @return True if the content changed, the heartbeat period elapsed since the last message, or status topics are
+   * always published.
+   */
+  bool hasChanged(Topic topic, const bosdyn::api::RobotState& robot_state, std::chrono::steady_clock::time_point now);
+
+  /**
+   * @brief Answer a request for the robot state at a time within robot_state_history_.
+   *
+   * @param request Requested time in the clock of the host.
+   * @param response Interpolated poses, velocity and joint states, or success set to false if the time is not within
+   * the history.
+   */
+  void getRobotStateAtTime(const std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Request>& request,
+                           const std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Response>& response) const;
+
   std::string full_tf_root_id_;
 
   std::string frame_prefix_;
 
   bool is_using_vision_;
 
+  /** @brief Converts the frame tree snapshot of each robot state into a reused TF message. */
+  std::optional<FrameTreeConverter> tf_converter_;
+
+  /** @brief Converts the joint states of each robot state into joint_states_. */
+  std::optional<JointStateConverter> joint_state_converter_;
+
+  /** @brief Joint state message which is reused between robot states, so that its vectors stay allocated. */
+  std::optional<sensor_msgs::msg::JointState> joint_states_;
+
+  /** @brief If true, the low-level joint states of spot_ros2_control are relayed on joint_states while they stream. */
+  bool low_level_joint_states_{false};
+
+  /**
+   * @brief Arrival time of the last low-level joint states. Written by the subscription and read by the thread which
+   * requests the robot state.
+   */
+  std::atomic<std::chrono::steady_clock::time_point> last_low_level_joint_states_{};
+
+  /** @brief Recent robot states, which are read by the get_robot_state_at_time service and by composed nodes. */
+  std::shared_ptr<RobotStateHistory> robot_state_history_;
+
+  /** @brief If true, the robot state is requested back to back on stream_thread_ instead of on timer_interface_. */
+  bool stream_robot_state_{false};
+
+  /** @brief Acquisition timestamp of the last published robot state, used to drop repeated states when streaming. */
+  google::protobuf::Timestamp last_acquisition_timestamp_;
+
+  /** @brief If true, the battery, WiFi, E-Stop, power and fault status are only published when they change. */
+  bool publish_status_on_change_{false};
+
+  /** @brief Maximum time between two messages of a status topic which is published on change. */
+  std::chrono::steady_clock::duration status_heartbeat_period_{0};
+  /** @brief Time after which a robot state request is cancelled, so that the next one gets a fresh robot state. */
+  std::chrono::duration<double> request_timeout_{0.0};
+  /** @brief If true, every robot state is also published as its serialized protobuf message. */
+  bool publish_raw_protobuf_{false};
+  /** @brief If true, only the serialized robot state is published, and every conversion to ROS messages is skipped. */
+  bool raw_protobuf_only_{false};
+
+  /** @brief Monitor of the link to the robot, or nullptr if the publisher does not degrade on a poor link. */
+  std::shared_ptr<LinkMonitor> link_monitor_;
+  /** @brief Factor by which the robot state rate and the status topic rates are lowered while the link is degraded. */
+  std::size_t degraded_rate_divisor_{1};
+  /** @brief True while the link is degraded. Only accessed by the thread which requests the robot state. */
+  bool link_degraded_{false};
+  /** @brief Number of timer ticks. While the link is degraded, only every degraded_rate_divisor_-th tick requests. */
+  std::size_t timer_ticks_{0};
+
+  /** @brief Publish rate limit of every robot state topic, indexed by Topic. */
+  std::array<TopicRate, static_cast<std::size_t>(Topic::kCount)> topic_rates_;
+
   // Interface classes to interact with Spot and the middleware.
   std::shared_ptr<StateClientInterface> state_client_interface_;
   std::shared_ptr<TimeSyncApi> time_sync_interface_;
@@ -74,5 +275,19 @@ class StatePublisher {
   std::unique_ptr<LoggerInterfaceBase> logger_interface_;
   std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface_;
   std::unique_ptr<TimerInterfaceBase> timer_interface_;
+
+  /** @brief Registry which owns the metrics below. */
+  std::shared_ptr<metrics::MetricsRegistry> metrics_registry_;
+  metrics::Counter& clock_skew_failures_;
+  metrics::Counter& rpc_failures_;
+  metrics::Counter& repeated_states_dropped_;
+  metrics::Histogram& rpc_latency_;
+  metrics::Histogram& publish_time_;
+
+  /** @brief Set by the destructor to stop stream_thread_. */
+  std::atomic<bool> stop_streaming_{false};
+
+  /** @brief Thread which requests the robot state when it is streamed. Joined by the destructor. */
+  std::thread stream_thread_;
 };
 }  // namespace spot_ros2
@@ -2,13 +2,16 @@
 
 #pragma once
 
+#include <rclcpp/node.hpp>
 #include <rclcpp/node_interfaces/node_base_interface.hpp>
 #include <rclcpp/node_options.hpp>
+#include <rclcpp/parameter_event_handler.hpp>
 #include <spot_driver/api/spot_api.hpp>
 #include <spot_driver/interfaces/logger_interface_base.hpp>
 #include <spot_driver/interfaces/parameter_interface_base.hpp>
 #include <spot_driver/interfaces/tf_broadcaster_interface_base.hpp>
 #include <spot_driver/interfaces/timer_interface_base.hpp>
+#include <spot_driver/metrics/metrics_publisher.hpp>
 #include <spot_driver/robot_state/state_publisher.hpp>
 
 #include <memory>
@@ -17,6 +20,9 @@
 namespace spot_ros2 {
 /**
  * @brief Wraps StatePublisher to allow using it like a rclcpp::Node.
+ * @details When created with the rclcpp constructor, a change of any parameter of the node replaces the
+ * StatePublisher, which reads the parameters again and recreates its publishers and timer. The connection to Spot is
+ * kept, so this takes effect without creating, authenticating and time syncing the robot again.
  */
 class StatePublisherNode {
  public:
@@ -61,6 +67,17 @@ class StatePublisherNode {
    */
   std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> get_node_base_interface();
 
+  /**
+   * @brief Get the history of recent robot states, so that nodes composed into the same process can look up the robot
+   * state at past times without a service call.
+   *
+   * @return The history, or nullptr if it is disabled by setting robot_state_history_size to 0. A new history is
+   * created when the parameters change.
+   */
+  [[nodiscard]] std::shared_ptr<const RobotStateHistory> getRobotStateHistory() const {
+    return internal_ ? internal_->getRobotStateHistory() : nullptr;
+  }
+
  private:
   /**
    * @brief Connect to and authenticate with Spot, and then create the StatePublisher class member.
@@ -84,8 +101,36 @@ class StatePublisherNode {
                   std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
                   std::unique_ptr<TimerInterfaceBase> timer_interface);
 
+  /**
+   * @brief Create a StatePublisher with the connection of spot_api_.
+   * @return The publisher.
+   * @throw std::runtime_error if the robot state client is not available.
+   */
+  std::unique_ptr<StatePublisher> createPublisher(std::unique_ptr<StatePublisher::MiddlewareHandle> middleware_handle,
+                                                  std::unique_ptr<ParameterInterfaceBase> parameter_interface,
+                                                  std::unique_ptr<LoggerInterfaceBase> logger_interface,
+                                                  std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
+                                                  std::unique_ptr<TimerInterfaceBase> timer_interface);
+
+  /**
+   * @brief Replace the StatePublisher with one that uses the current parameters. Only used with node_.
+   * @details The timer and the services of the publisher are in the default callback group, like the parameter event
+   * callback which calls this, so none of them runs while the publisher is replaced. If the new publisher fails to
+   * start, the current one is kept.
+   */
+  void reconfigure();
+
   std::unique_ptr<NodeInterfaceBase> node_base_interface_;
   std::unique_ptr<SpotApi> spot_api_;
+  /** @brief Node of the rclcpp constructor, and the handler of its parameter events. */
+  std::shared_ptr<rclcpp::Node> node_;
+  std::shared_ptr<rclcpp::ParameterEventHandler> parameter_event_handler_;
+  std::shared_ptr<rclcpp::ParameterEventCallbackHandle> parameter_event_callback_;
+  rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr set_parameters_callback_;
+  /** @brief Registry of the robot of this node, which keeps its metrics apart from those of other robots. */
+  std::shared_ptr<metrics::MetricsRegistry> metrics_registry_ = metrics::MetricsRegistry::getDefault();
+  /** @brief Publishes the metrics of this node. Only created by the rclcpp constructor. */
+  std::unique_ptr<metrics::MetricsPublisher> metrics_publisher_;
   std::unique_ptr<StatePublisher> internal_;
 };
 }  // namespace spot_ros2
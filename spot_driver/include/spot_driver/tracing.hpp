@@ -0,0 +1,52 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <cstdint>
+
+namespace spot_ros2::tracing {
+
+/** @brief Name of the pipeline which requests, decodes and publishes the images of Spot's cameras. */
+inline constexpr auto kImagePipeline = "images";
+/** @brief Name of the pipeline which requests, converts and publishes the robot state. */
+inline constexpr auto kRobotStatePipeline = "robot_state";
+/** @brief Name of the pipeline which stitches the images of the front cameras. */
+inline constexpr auto kStitcherPipeline = "stitcher";
+
+/**
+ * @brief Emit the spot_driver:stage_begin LTTng tracepoint.
+ * @details The driver emits tracepoints at the stages of its pipelines, so that they can be shown next to the rclcpp
+ * and DDS tracepoints of ros2_tracing in one timeline. If LTTng was not found when the driver was built, or no tracing
+ * session enables the spot_driver events, this costs a function call.
+ *
+ * @param pipeline Name of the pipeline, which is one of the constants above.
+ * @param stage Name of the stage within the pipeline.
+ * @param source Name of the camera or other source that the stage works on, or an empty string.
+ * @param id Identifier which relates the stages of the same data, such as its acquisition time in nanoseconds, or 0.
+ */
+void stageBegin(const char* pipeline, const char* stage, const char* source = "", std::uint64_t id = 0);
+
+/** @brief Emit the spot_driver:stage_end LTTng tracepoint, with the same arguments as the matching stageBegin(). */
+void stageEnd(const char* pipeline, const char* stage, const char* source = "", std::uint64_t id = 0);
+
+/** @brief Traces the begin of a stage when it is constructed, and its end when it is destroyed. */
+class ScopedStage {
+ public:
+  /** @brief Constructor for ScopedStage, which takes the arguments of stageBegin(). The strings must outlive it. */
+  ScopedStage(const char* pipeline, const char* stage, const char* source = "", std::uint64_t id = 0)
+      : pipeline_{pipeline}, stage_{stage}, source_{source}, id_{id} {
+    stageBegin(pipeline_, stage_, source_, id_);
+  }
+
+  ~ScopedStage() { stageEnd(pipeline_, stage_, source_, id_); }
+
+  ScopedStage(const ScopedStage&) = delete;
+  ScopedStage& operator=(const ScopedStage&) = delete;
+
+ private:
+  const char* pipeline_;
+  const char* stage_;
+  const char* source_;
+  std::uint64_t id_;
+};
+}  // namespace spot_ros2::tracing
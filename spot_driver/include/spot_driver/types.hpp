@@ -106,13 +106,11 @@ struct std::less<spot_ros2::ImageSource> {
  * @brief A struct of ROS message types that define Spot's Robot State
  */
 struct RobotStateMessages {
-  spot_msgs::msg::BatteryStateArray battery_states;
-  spot_msgs::msg::WiFiState wifi_state;
-  spot_msgs::msg::FootStateArray foot_state;
-  spot_msgs::msg::EStopStateArray estop_states;
-
+  std::optional<spot_msgs::msg::BatteryStateArray> maybe_battery_states;
+  std::optional<spot_msgs::msg::WiFiState> maybe_wifi_state;
+  std::optional<spot_msgs::msg::FootStateArray> maybe_foot_state;
+  std::optional<spot_msgs::msg::EStopStateArray> maybe_estop_states;
   std::optional<sensor_msgs::msg::JointState> maybe_joint_states;
-  std::optional<tf2_msgs::msg::TFMessage> maybe_tf;
   std::optional<geometry_msgs::msg::TwistWithCovarianceStamped> maybe_odom_twist;
   std::optional<nav_msgs::msg::Odometry> maybe_odom;
   std::optional<spot_msgs::msg::PowerState> maybe_power_state;
@@ -7,7 +7,8 @@ from launch.actions import DeclareLaunchArgument, IncludeLaunchDescription, Opaq
 from launch.conditions import IfCondition
 from launch.launch_description_sources import PythonLaunchDescriptionSource
 from launch.substitutions import Command, FindExecutable, LaunchConfiguration, PathJoinSubstitution, TextSubstitution
-from launch_ros.actions import Node
+from launch_ros.actions import ComposableNodeContainer, Node
+from launch_ros.descriptions import ComposableNode
 from launch_ros.substitutions import FindPackageShare
 from synchros2.launch.actions import DeclareBooleanLaunchArgument
 
@@ -24,6 +25,8 @@ def launch_setup(context: LaunchContext, ld: LaunchDescription) -> None:
     tf_prefix = LaunchConfiguration("tf_prefix").perform(context)
     mock_enable = IfCondition(LaunchConfiguration("mock_enable", default="False")).evaluate(context)
     robot_description_package = LaunchConfiguration("robot_description_package").perform(context)
+    compose_driver_nodes = IfCondition(LaunchConfiguration("compose_driver_nodes")).evaluate(context)
+    record_mcap = IfCondition(LaunchConfiguration("record_mcap")).evaluate(context)
 
     # if config_file has been set (and is not the default empty string) and is also not a file, do not launch anything.
     config_file_path = config_file.perform(context)
@@ -63,24 +66,6 @@ def launch_setup(context: LaunchContext, ld: LaunchDescription) -> None:
 
     spot_name_param = {"spot_name": spot_name}
 
-    kinematic_node = Node(
-        package="spot_driver",
-        executable="spot_inverse_kinematics_node",
-        output="screen",
-        parameters=[config_file, spot_name_param],
-        namespace=spot_name,
-    )
-    ld.add_action(kinematic_node)
-
-    object_sync_node = Node(
-        package="spot_driver",
-        executable="object_synchronizer_node",
-        output="screen",
-        parameters=[config_file, spot_name_param],
-        namespace=spot_name,
-    )
-    ld.add_action(object_sync_node)
-
     robot_description = Command(
         [
             PathJoinSubstitution([FindExecutable(name="xacro")]),
@@ -96,6 +81,41 @@ def launch_setup(context: LaunchContext, ld: LaunchDescription) -> None:
         ]
     )
     robot_description_params = {"robot_description": robot_description}
+
+    # Driver nodes which are composed into one container share a single connection to Spot, so that they authenticate
+    # and synchronize time with the robot only once.
+    driver_container_name = "driver_container"
+    image_publisher_container = ""
+    driver_components = []
+    if compose_driver_nodes:
+        image_publisher_container = "/" + "/".join(filter(None, [spot_name, driver_container_name]))
+        driver_components.append(
+            ComposableNode(
+                package="spot_driver",
+                plugin="spot_ros2::kinematic::KinematicNode",
+                parameters=[config_file, spot_name_param, robot_description_params],
+                namespace=spot_name,
+            )
+        )
+    else:
+        kinematic_node = Node(
+            package="spot_driver",
+            executable="spot_inverse_kinematics_node",
+            output="screen",
+            parameters=[config_file, spot_name_param, robot_description_params],
+            namespace=spot_name,
+        )
+        ld.add_action(kinematic_node)
+
+    object_sync_node = Node(
+        package="spot_driver",
+        executable="object_synchronizer_node",
+        output="screen",
+        parameters=[config_file, spot_name_param],
+        namespace=spot_name,
+    )
+    ld.add_action(object_sync_node)
+
     robot_state_publisher = Node(
         package="robot_state_publisher",
         executable="robot_state_publisher",
@@ -105,14 +125,47 @@ def launch_setup(context: LaunchContext, ld: LaunchDescription) -> None:
     )
     ld.add_action(robot_state_publisher)
 
-    spot_robot_state_publisher = Node(
-        package="spot_driver",
-        executable="state_publisher_node",
-        output="screen",
-        parameters=[config_file, spot_name_param],
-        namespace=spot_name,
-    )
-    ld.add_action(spot_robot_state_publisher)
+    if compose_driver_nodes:
+        driver_components.append(
+            ComposableNode(
+                package="spot_driver",
+                plugin="spot_ros2::StatePublisherNode",
+                parameters=[config_file, spot_name_param],
+                namespace=spot_name,
+            )
+        )
+        if record_mcap:
+            driver_components.append(
+                ComposableNode(
+                    package="spot_driver",
+                    plugin="spot_ros2::recording::McapRecorderNode",
+                    parameters=[config_file],
+                    namespace=spot_name,
+                )
+            )
+        # The image publisher blocks its callback groups while it waits for images, so the container must be
+        # multi-threaded.
+        driver_container = ComposableNodeContainer(
+            name=driver_container_name,
+            namespace=spot_name,
+            package="rclcpp_components",
+            executable="component_container_mt",
+            output="screen",
+            composable_node_descriptions=driver_components,
+        )
+        ld.add_action(driver_container)
+    else:
+        if record_mcap:
+            # The recorder only receives the data of the driver nodes which run in its own process.
+            raise ValueError("record_mcap requires compose_driver_nodes.")
+        spot_robot_state_publisher = Node(
+            package="spot_driver",
+            executable="state_publisher_node",
+            output="screen",
+            parameters=[config_file, spot_name_param],
+            namespace=spot_name,
+        )
+        ld.add_action(spot_robot_state_publisher)
 
     spot_alert_node = Node(
         package="spot_driver",
@@ -140,7 +193,8 @@ def launch_setup(context: LaunchContext, ld: LaunchDescription) -> None:
             PathJoinSubstitution([FindPackageShare(THIS_PACKAGE), "launch", "spot_image_publishers.launch.py"])
         ),
         launch_arguments={
-            key: LaunchConfiguration(key) for key in ["config_file", "spot_name"] + IMAGE_PUBLISHER_ARGS
+            **{key: LaunchConfiguration(key) for key in ["config_file", "spot_name"] + IMAGE_PUBLISHER_ARGS},
+            "image_publisher_container": image_publisher_container,
         }.items(),
         condition=IfCondition(LaunchConfiguration("launch_image_publishers")),
     )
@@ -192,6 +246,26 @@ def generate_launch_description() -> LaunchDescription:
             description="Package from where the robot model description is. Must have path /urdf/spot.urdf.xacro",
         )
     )
+    launch_args.append(
+        DeclareBooleanLaunchArgument(
+            "compose_driver_nodes",
+            default_value=False,
+            description=(
+                "Choose whether to run the image publisher, state publisher and inverse kinematics nodes in one"
+                " component container, where they share a single connection to Spot."
+            ),
+        )
+    )
+    launch_args.append(
+        DeclareBooleanLaunchArgument(
+            "record_mcap",
+            default_value=False,
+            description=(
+                "Choose whether to record the images, robot state and TF of the driver to an MCAP file from within the"
+                " driver container, without subscribing to them. Requires compose_driver_nodes."
+            ),
+        )
+    )
     launch_args += declare_image_publisher_args()
     launch_args.append(DeclareLaunchArgument("spot_name", default_value="", description="Name of Spot"))
 
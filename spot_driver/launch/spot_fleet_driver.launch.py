@@ -0,0 +1,157 @@
+# Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+import os
+
+from launch import LaunchContext, LaunchDescription
+from launch.actions import DeclareLaunchArgument, OpaqueFunction
+from launch.conditions import IfCondition
+from launch.substitutions import Command, FindExecutable, LaunchConfiguration, PathJoinSubstitution, TextSubstitution
+from launch_ros.actions import ComposableNodeContainer, Node
+from launch_ros.descriptions import ComposableNode
+from launch_ros.substitutions import FindPackageShare
+from synchros2.launch.actions import DeclareBooleanLaunchArgument
+
+from spot_driver.launch.spot_launch_helpers import get_fleet_robots, spot_has_arm
+
+
+def launch_setup(context: LaunchContext, ld: LaunchDescription) -> None:
+    fleet_file = LaunchConfiguration("fleet_file").perform(context)
+    robot_description_package = LaunchConfiguration("robot_description_package").perform(context)
+    launch_image_publishers = IfCondition(LaunchConfiguration("launch_image_publishers")).evaluate(context)
+    container_threads = int(LaunchConfiguration("container_threads").perform(context))
+
+    if not os.path.isfile(fleet_file):
+        raise FileNotFoundError("Fleet file '{}' does not exist!".format(fleet_file))
+    robots = get_fleet_robots(fleet_file)
+    for spot_name, config_file in robots:
+        if config_file and not os.path.isfile(config_file):
+            raise FileNotFoundError("Configuration file '{}' of {} does not exist!".format(config_file, spot_name))
+
+    robot_description_pkg_share = FindPackageShare(robot_description_package).find(robot_description_package)
+
+    # The image, state, object synchronization and inverse kinematics nodes of every robot are composed into one
+    # container. They share its executor and the process-wide resources of the driver: one Spot SDK instance per
+    # certificate, one connection per robot and one pool of worker threads.
+    driver_components = []
+    for spot_name, config_file in robots:
+        parameters = [config_file] if config_file else []
+        spot_name_param = {"spot_name": spot_name}
+        has_arm = spot_has_arm(config_file_path=config_file, spot_name=spot_name)
+        robot_description = Command(
+            [
+                PathJoinSubstitution([FindExecutable(name="xacro")]),
+                " ",
+                PathJoinSubstitution([robot_description_pkg_share, "urdf", "spot.urdf.xacro"]),
+                " ",
+                "arm:=",
+                TextSubstitution(text=str(has_arm).lower()),
+                " ",
+                "tf_prefix:=",
+                TextSubstitution(text=spot_name + "/"),
+                " ",
+            ]
+        )
+        robot_description_params = {"robot_description": robot_description}
+
+        driver_components += [
+            ComposableNode(
+                package="spot_driver",
+                plugin="spot_ros2::kinematic::KinematicNode",
+                parameters=parameters + [spot_name_param, robot_description_params],
+                namespace=spot_name,
+            ),
+            ComposableNode(
+                package="spot_driver",
+                plugin="spot_ros2::StatePublisherNode",
+                parameters=parameters + [spot_name_param],
+                namespace=spot_name,
+            ),
+            ComposableNode(
+                package="spot_driver",
+                plugin="spot_ros2::ObjectSynchronizerNode",
+                parameters=parameters + [spot_name_param],
+                namespace=spot_name,
+            ),
+            ComposableNode(
+                package="robot_state_publisher",
+                plugin="robot_state_publisher::RobotStatePublisher",
+                parameters=[robot_description_params],
+                namespace=spot_name,
+            ),
+        ]
+        if launch_image_publishers:
+            driver_components.append(
+                ComposableNode(
+                    package="spot_driver",
+                    plugin="spot_ros2::images::SpotImagePublisherNode",
+                    parameters=parameters + [spot_name_param],
+                    namespace=spot_name,
+                )
+            )
+
+        # The Python driver, which offers the commands of the robot, still runs as its own process per robot.
+        ld.add_action(
+            Node(
+                package="spot_driver",
+                executable="spot_ros2",
+                name="spot_ros2",
+                output="screen",
+                parameters=parameters + [spot_name_param],
+                namespace=spot_name,
+            )
+        )
+
+    # The image publishers block their callback groups while they wait for images, so the container must be
+    # multi-threaded.
+    ld.add_action(
+        ComposableNodeContainer(
+            name="fleet_driver_container",
+            namespace="",
+            package="rclcpp_components",
+            executable="component_container_mt",
+            output="screen",
+            parameters=[{"thread_num": container_threads}] if container_threads > 0 else [],
+            composable_node_descriptions=driver_components,
+        )
+    )
+
+
+def generate_launch_description() -> LaunchDescription:
+    launch_args = []
+
+    launch_args.append(
+        DeclareLaunchArgument(
+            "fleet_file",
+            description=(
+                "Path to the fleet file, which lists the spot_name and config_file of every robot under `robots`. See"
+                " config/spot_fleet_example.yaml."
+            ),
+        )
+    )
+    launch_args.append(
+        DeclareLaunchArgument(
+            "robot_description_package",
+            default_value="spot_description",
+            description="Package from where the robot model description is. Must have path /urdf/spot.urdf.xacro",
+        )
+    )
+    launch_args.append(
+        DeclareBooleanLaunchArgument(
+            "launch_image_publishers",
+            default_value=True,
+            description="Choose whether to load the image publisher of every robot into the container.",
+        )
+    )
+    launch_args.append(
+        DeclareLaunchArgument(
+            "container_threads",
+            default_value="0",
+            description="Number of threads of the executor of the container, or 0 for one thread per core.",
+        )
+    )
+
+    ld = LaunchDescription(launch_args)
+
+    ld.add_action(OpaqueFunction(function=launch_setup, args=[ld]))
+
+    return ld
@@ -130,14 +130,30 @@ def launch_setup(context: LaunchContext, ld: LaunchDescription) -> None:
     if depth_registered_mode is not DepthRegisteredMode.FROM_SPOT:
         spot_image_publisher_params.update({"publish_depth_registered": False})
 
-    spot_image_publisher_node = launch_ros.actions.Node(
-        package="spot_driver",
-        executable="spot_image_publisher_node",
-        output="screen",
-        parameters=[config_file, spot_image_publisher_params],
-        namespace=spot_name,
-    )
-    ld.add_action(spot_image_publisher_node)
+    image_publisher_container = LaunchConfiguration("image_publisher_container").perform(context)
+    if image_publisher_container:
+        # Load the image publisher next to the other driver nodes, so that it shares their connection to Spot.
+        spot_image_publisher_component = launch_ros.actions.LoadComposableNodes(
+            target_container=image_publisher_container,
+            composable_node_descriptions=[
+                launch_ros.descriptions.ComposableNode(
+                    package="spot_driver",
+                    plugin="spot_ros2::images::SpotImagePublisherNode",
+                    parameters=[config_file, spot_image_publisher_params],
+                    namespace=spot_name,
+                )
+            ],
+        )
+        ld.add_action(spot_image_publisher_component)
+    else:
+        spot_image_publisher_node = launch_ros.actions.Node(
+            package="spot_driver",
+            executable="spot_image_publisher_node",
+            output="screen",
+            parameters=[config_file, spot_image_publisher_params],
+            namespace=spot_name,
+        )
+        ld.add_action(spot_image_publisher_node)
 
     # Parse config options to create a list of composable node descriptions for the nodelets we want to run within the
     # composable node container.
@@ -175,14 +191,39 @@ def launch_setup(context: LaunchContext, ld: LaunchDescription) -> None:
                 (f"{cam_prefix}/left/camera_info", f"{cam_prefix}/camera/frontleft/camera_info"),
                 (f"{cam_prefix}/right/image", f"{cam_prefix}/camera/frontright/image"),
                 (f"{cam_prefix}/right/camera_info", f"{cam_prefix}/camera/frontright/camera_info"),
+                (f"{cam_prefix}/left/compressed", f"{cam_prefix}/camera/frontleft/compressed"),
+                (f"{cam_prefix}/right/compressed", f"{cam_prefix}/camera/frontright/compressed"),
                 (f"{cam_prefix}/virtual_camera/image", f"{cam_prefix}/camera/{virtual_camera_frame}/image"),
                 (f"{cam_prefix}/virtual_camera/camera_info", f"{cam_prefix}/camera/{virtual_camera_frame}/camera_info"),
+                (f"{cam_prefix}/virtual_camera/compressed", f"{cam_prefix}/camera/{virtual_camera_frame}/compressed"),
             ],
             parameters=[config_file, stitcher_params],
             condition=IfCondition(LaunchConfiguration("stitch_front_images")),
         )
         ld.add_action(image_stitcher_node)
 
+    # add the surround stitcher node for every body camera that is enabled, since it needs at least two to stitch.
+    surround_cameras = [
+        camera for camera in ["frontleft", "frontright", "right", "back", "left"] if camera in camera_sources
+    ]
+    if len(surround_cameras) >= 2:
+        cam_prefix = f"/{spot_name}" if spot_name else ""
+        surround_stitcher_node = launch_ros.actions.Node(
+            package="spot_driver",
+            executable="surround_stitcher_node",
+            namespace=spot_name,
+            output="screen",
+            remappings=[
+                (f"{cam_prefix}/surround_camera/image", f"{cam_prefix}/camera/surround_virtual/image"),
+            ],
+            parameters=[
+                config_file,
+                {"spot_name": spot_name, "body_frame": "body", "surround_cameras": surround_cameras},
+            ],
+            condition=IfCondition(LaunchConfiguration("stitch_surround_images")),
+        )
+        ld.add_action(surround_stitcher_node)
+
 
 def generate_launch_description() -> launch.LaunchDescription:
     launch_args = []
@@ -195,6 +236,16 @@ def generate_launch_description() -> launch.LaunchDescription:
         )
     )
     launch_args.append(DeclareLaunchArgument("spot_name", default_value="", description="Name of Spot"))
+    launch_args.append(
+        DeclareLaunchArgument(
+            "image_publisher_container",
+            default_value="",
+            description=(
+                "Fully qualified name of a component container to load the image publisher into. If empty, the image"
+                " publisher runs as its own node."
+            ),
+        )
+    )
     launch_args += declare_image_publisher_args()
 
     ld = launch.LaunchDescription(launch_args)
@@ -30,6 +30,7 @@ IMAGE_PUBLISHER_ARGS = [
     "uncompress_images",
     "publish_compressed_images",
     "stitch_front_images",
+    "stitch_surround_images",
 ]
 
 
@@ -100,6 +101,13 @@ def declare_image_publisher_args() -> List[DeclareLaunchArgument]:
             ),
         )
     )
+    launch_args.append(
+        DeclareBooleanLaunchArgument(
+            "stitch_surround_images",
+            default_value=False,
+            description="Choose whether to publish a 360 degree panorama stitched from all of Spot's body cameras.",
+        )
+    )
     return launch_args
 
 
@@ -260,3 +268,30 @@ def spot_has_arm(config_file_path: str, spot_name: str) -> bool:
         gripperless=gripperless,
     )
     return spot_wrapper.has_arm()
+
+
+def get_fleet_robots(fleet_file_path: str) -> List[Tuple[str, str]]:
+    """Get the robots of a fleet file, which lists the name and configuration file of every robot under `robots`.
+
+    Args:
+        fleet_file_path (str): Path to the fleet yaml
+
+    Raises:
+        ValueError: If the fleet file lists no robots, a robot has no name or two robots have the same name
+
+    Returns:
+        List[Tuple[str, str]]: spot_name and config_file of every robot
+    """
+    with open(fleet_file_path, "r") as fleet_yaml:
+        try:
+            fleet_dict = yaml.safe_load(fleet_yaml) or {}
+        except yaml.YAMLError as exc:
+            raise yaml.YAMLError(f"Fleet file {fleet_file_path} couldn't be parsed: failed with '{exc}'")
+    robots = [(robot.get("spot_name", ""), robot.get("config_file", "")) for robot in fleet_dict.get("robots") or []]
+    if not robots:
+        raise ValueError(f"Fleet file {fleet_file_path} does not list any robots under 'robots'.")
+    names = [spot_name for spot_name, _ in robots]
+    if not all(names) or len(set(names)) != len(names):
+        # The nodes of every robot are told apart by the namespace of its name within the shared container.
+        raise ValueError(f"Every robot in fleet file {fleet_file_path} must have its own, non-empty spot_name.")
+    return robots
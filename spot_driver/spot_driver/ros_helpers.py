@@ -126,7 +126,11 @@ def _create_compressed_image_msg(
     local_time = robot_to_local_time(data.shot.acquisition_time)
     image_msg.header.stamp = Time(sec=local_time.seconds, nanosec=local_time.nanos)
     image_msg.header.frame_id = frame_prefix + data.shot.frame_name_image_sensor
-    image_msg.format = "jpeg"
+    # Name the encoding which the JPEG decodes to, so that decoders of the greyscale cameras keep a single channel.
+    if data.shot.image.pixel_format == image_pb2.Image.PIXEL_FORMAT_GREYSCALE_U8:
+        image_msg.format = "mono8; jpeg compressed mono8"
+    else:
+        image_msg.format = "bgr8; jpeg compressed bgr8"
     image_msg.data = data.shot.image.data
     return image_msg
 
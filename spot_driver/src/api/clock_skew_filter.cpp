@@ -0,0 +1,49 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/api/clock_skew_filter.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace spot_ros2 {
+
+void ClockSkewFilter::update(const std::int64_t local_time, const std::int64_t clock_skew) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (initialized_ && clock_skew == last_measurement_) {
+    return;
+  }
+  last_measurement_ = clock_skew;
+
+  const auto elapsed = local_time - reference_time_;
+  const auto predicted = initialized_ ? predictLocked(local_time) : clock_skew;
+  const auto residual = clock_skew - predicted;
+  if (!initialized_ || elapsed <= 0 || std::abs(residual) > kMaxResidual) {
+    initialized_ = true;
+    reference_time_ = local_time;
+    offset_ = clock_skew;
+    drift_rate_ = 0.0;
+    return;
+  }
+
+  offset_ = predicted + std::llround(kOffsetGain * static_cast<double>(residual));
+  drift_rate_ = std::clamp(drift_rate_ + kDriftGain * static_cast<double>(residual) / static_cast<double>(elapsed),
+                           -kMaxDriftRate, kMaxDriftRate);
+  reference_time_ = local_time;
+}
+
+std::optional<std::int64_t> ClockSkewFilter::predict(const std::int64_t local_time) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (!initialized_) {
+    return std::nullopt;
+  }
+  return predictLocked(local_time);
+}
+
+std::int64_t ClockSkewFilter::predictLocked(const std::int64_t local_time) const {
+  return offset_ + std::llround(drift_rate_ * static_cast<double>(local_time - reference_time_));
+}
+
+}  // namespace spot_ros2
@@ -12,25 +12,53 @@
 #include <geometry_msgs/msg/vector3.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <sensor_msgs/distortion_models.hpp>
+#include <sensor_msgs/image_encodings.hpp>
 #include <sensor_msgs/msg/camera_info.hpp>
 #include <sensor_msgs/msg/image.hpp>
 #include <spot_driver/api/default_time_sync_api.hpp>
+#include <spot_driver/api/image_message_pool.hpp>
+#include <spot_driver/api/request_deadline.hpp>
 #include <spot_driver/api/spot_image_sources.hpp>
+#include <spot_driver/conversions/compressed_depth.hpp>
+#include <spot_driver/conversions/depth_filter.hpp>
 #include <spot_driver/conversions/decompress_images.hpp>
+#include <spot_driver/conversions/depth_laser_scan.hpp>
+#include <spot_driver/conversions/depth_point_cloud.hpp>
+#include <spot_driver/conversions/depth_ray_table.hpp>
+#include <spot_driver/conversions/frame_tree_resolver.hpp>
 #include <spot_driver/conversions/geometry.hpp>
+#include <spot_driver/conversions/jpeg_encoder.hpp>
 #include <spot_driver/conversions/time.hpp>
+#include <spot_driver/tracing.hpp>
 #include <spot_driver/types.hpp>
 #include <std_msgs/msg/header.hpp>
 #include <string>
 #include <tl_expected/expected.hpp>
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <optional>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 namespace {
 
+// Number of calls to getImages after which the outstanding requests for a GetImageRequest that has not been made again
+// are discarded.
+constexpr std::size_t kMaxIdlePipelineCalls{100};
+
+// Depth scale used if an image source does not report one. Spot's depth images are in millimeters.
+constexpr double kFallbackDepthScale{1000.0};
+
+// Frame of the laser scan which is merged from the depth images, and parent frame of the returned camera transforms.
+constexpr auto kBodyFrame = "body";
+
 static const std::set<std::string> kExcludedStaticTfFrames{
     // We exclude the odometry frames from static transforms since they are not static. We can ignore the body
     // frame because it is a child of odom or vision depending on the preferred_odom_frame, and will be published
@@ -46,6 +74,16 @@ static const std::set<std::string> kExcludedStaticTfFrames{
     "arm0.link_wr1",
 };
 
+/** @brief Convert a ROS time to seconds. */
+double toSeconds(const builtin_interfaces::msg::Time& time) {
+  return static_cast<double>(time.sec) + static_cast<double>(time.nanosec) * 1e-9;
+}
+
+/** @brief Convert a system clock time point to seconds since the epoch. */
+double toSeconds(const std::chrono::system_clock::time_point& time) {
+  return std::chrono::duration<double>{time.time_since_epoch()}.count();
+}
+
 tl::expected<sensor_msgs::msg::CameraInfo, std::string> toCameraInfoMsg(
     const bosdyn::api::ImageResponse& image_response, const std::string& robot_name,
     const google::protobuf::Duration& clock_skew) {
@@ -92,23 +130,14 @@ tl::expected<sensor_msgs::msg::CameraInfo, std::string> toCameraInfoMsg(
   return info_msg;
 }
 
-std_msgs::msg::Header createImageHeader(const bosdyn::api::ImageCapture& image_capture, const std::string& robot_name,
-                                        const google::protobuf::Duration& clock_skew) {
-  std_msgs::msg::Header header;
-  // Omit leading `/` from frame ID if robot_name is empty
-  header.frame_id = (robot_name.empty() ? "" : robot_name + "/") + image_capture.frame_name_image_sensor();
-  header.stamp = spot_ros2::robotTimeToLocalTime(image_capture.acquisition_time(), clock_skew);
-  return header;
-}
-
 tl::expected<std::vector<geometry_msgs::msg::TransformStamped>, std::string> getImageTransforms(
     const bosdyn::api::ImageResponse& image_response, const std::string& robot_name,
-    const google::protobuf::Duration& clock_skew) {
+    const google::protobuf::Duration& clock_skew, const std::set<std::string>& emitted_static_frames) {
   std::vector<geometry_msgs::msg::TransformStamped> out;
   for (const auto& [child_frame_id, transform] :
        image_response.shot().transforms_snapshot().child_to_parent_edge_map()) {
-    // Do not publish static transforms for excluded frames
-    if (kExcludedStaticTfFrames.count(child_frame_id) > 0) {
+    // Do not publish static transforms for excluded frames, or for frames which were already published
+    if (kExcludedStaticTfFrames.count(child_frame_id) > 0 || emitted_static_frames.count(child_frame_id) > 0) {
       continue;
     }
 
@@ -128,91 +157,636 @@ tl::expected<std::vector<geometry_msgs::msg::TransformStamped>, std::string> get
   return out;
 }
 
-tl::expected<sensor_msgs::msg::CompressedImage, std::string> toCompressedImageMsg(
-    const bosdyn::api::ImageCapture& image_capture, const std::string& robot_name,
-    const google::protobuf::Duration& clock_skew) {
+/**
+ * @brief Check whether a CameraInfo message built from an earlier image response still describes a new image response.
+ *
+ * @param info_msg CameraInfo message built by toCameraInfoMsg.
+ * @param frame_name_image_sensor Image sensor frame name of the image response the message was built from.
+ * @param image_response New image response.
+ * @return True if the resolution, intrinsics and sensor frame of the image response match the message.
+ */
+bool matchesCameraInfo(const sensor_msgs::msg::CameraInfo& info_msg, const std::string& frame_name_image_sensor,
+                       const bosdyn::api::ImageResponse& image_response) {
+  const auto& shot = image_response.shot();
+  const auto& intrinsics = image_response.source().pinhole().intrinsics();
+  return info_msg.height == static_cast<uint32_t>(shot.image().rows()) &&
+         info_msg.width == static_cast<uint32_t>(shot.image().cols()) &&
+         info_msg.k[0] == intrinsics.focal_length().x() && info_msg.k[2] == intrinsics.principal_point().x() &&
+         info_msg.k[4] == intrinsics.focal_length().y() && info_msg.k[5] == intrinsics.principal_point().y() &&
+         frame_name_image_sensor == shot.frame_name_image_sensor();
+}
+
+/**
+ * @brief Copy a cached CameraInfo message and stamp the copy with the acquisition time of an image response.
+ *
+ * @param info Cached CameraInfo message.
+ * @param image_response Image response the copy is for.
+ * @param clock_skew Clock skew between the robot and the local system.
+ * @return The stamped copy.
+ */
+sensor_msgs::msg::CameraInfo toStampedCameraInfo(const sensor_msgs::msg::CameraInfo& info,
+                                                 const bosdyn::api::ImageResponse& image_response,
+                                                 const google::protobuf::Duration& clock_skew) {
+  auto info_msg = info;
+  info_msg.header.stamp = spot_ros2::robotTimeToLocalTime(image_response.shot().acquisition_time(), clock_skew);
+  return info_msg;
+}
+
+tl::expected<void, std::string> toCompressedImageMsg(const bosdyn::api::ImageCapture& image_capture,
+                                                     const std_msgs::msg::Header& header,
+                                                     sensor_msgs::msg::CompressedImage& compressed_image) {
   const auto& image = image_capture.image();
   if (image.format() != bosdyn::api::Image_Format_FORMAT_JPEG) {
     return tl::make_unexpected("Only JPEG image can be sent as ROS2-compressed image. Format is: " +
                                std::to_string(image.format()));
   }
 
-  auto data = image.data();
-  sensor_msgs::msg::CompressedImage compressed_image;
-  compressed_image.header = createImageHeader(image_capture, robot_name, clock_skew);
-  compressed_image.format = "jpeg";
-  compressed_image.data.insert(compressed_image.data.begin(), data.begin(), data.end());
-  return compressed_image;
+  // The image has the same frame and stamp as its CameraInfo.
+  compressed_image.header = header;
+  // Name the encoding which the JPEG decodes to, like getDecompressImageMsg() does, so that decoders of the greyscale
+  // body cameras keep a single channel.
+  const bool is_grey = image.pixel_format() == bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_GREYSCALE_U8;
+  compressed_image.format = spot_ros2::getJpegCompressedFormat(is_grey ? sensor_msgs::image_encodings::MONO8
+                                                                       : sensor_msgs::image_encodings::BGR8);
+  // Copy the JPEG bytes straight from the protobuf buffer into the message. The JPEG payload is already in the format
+  // the ROS message expects, so this is the only copy made before the message is handed to the middleware.
+  const auto& data = image.data();
+  compressed_image.data.assign(data.cbegin(), data.cend());
+  return {};
+}
+
+/** @brief Get the number of depth image units per meter of an image response. */
+double getDepthScale(const bosdyn::api::ImageResponse& image_response) {
+  return image_response.source().depth_scale() > 0.0 ? image_response.source().depth_scale() : kFallbackDepthScale;
+}
+
+/**
+ * @brief Look up the transform from the body frame to the image sensor of an image response in its transforms snapshot.
+ *
+ * @param image_response Image response received from Spot.
+ * @return The body_tform_camera transform, or nullopt if the snapshot does not connect the two frames.
+ */
+std::optional<geometry_msgs::msg::Transform> getBodyTformCamera(const bosdyn::api::ImageResponse& image_response) {
+  // Each worker keeps its own resolver, so that the buffers for the frame tree are reused between images.
+  thread_local spot_ros2::FrameTreeResolver resolver;
+  const auto& shot = image_response.shot();
+  if (!resolver.compile(shot.transforms_snapshot(), kBodyFrame)) {
+    return std::nullopt;
+  }
+  const auto body_tform_camera = resolver.rootTformFrame(shot.frame_name_image_sensor());
+  if (!body_tform_camera.has_value()) {
+    return std::nullopt;
+  }
+  return spot_ros2::toTransformStamped(body_tform_camera.value(), kBodyFrame, "", {}).transform;
+}
+
+/**
+ * @brief Holds the ROS messages converted from a single image response.
+ */
+struct ConvertedImageResponse {
+  spot_ros2::ImageSource source;
+  std::optional<spot_ros2::ImageWithCameraInfo> image;
+  std::optional<spot_ros2::CompressedImageWithCameraInfo> compressed_image;
+  std::optional<sensor_msgs::msg::PointCloud2> point_cloud;
+  std::optional<sensor_msgs::msg::CompressedImage> compressed_depth_image;
+  std::optional<spot_ros2::ImageWithCameraInfo> filtered_depth_image;
+  std::optional<sensor_msgs::msg::LaserScan> laser_scan;
+  std::optional<geometry_msgs::msg::Transform> body_tform_camera;
+  spot_ros2::ImageLatency latency;
+  std::vector<geometry_msgs::msg::TransformStamped> transforms;
+};
+
+/**
+ * @brief Convert a single image response from Spot into ROS messages.
+ * @details This only reads from the image response, so it is safe to convert several responses concurrently.
+ *
+ * @param image_response Image response received from Spot.
+ * @param source Image source of the image response.
+ * @param info CameraInfo message of the image source. The messages which are returned carry copies of it, stamped with
+ * the acquisition time of the image response.
+ * @param robot_name Name of the robot, used to prefix the frame IDs.
+ * @param clock_skew Clock skew between the robot and the local system.
+ * @param uncompress_images If true, decode JPEG images into uncompressed ROS Image messages.
+ * @param publish_compressed_images If true, convert JPEG images into ROS CompressedImage messages.
+ * @param jpeg_decoder Library used to decode JPEG-compressed images.
+ * @param color_encodings Encoding to decode the JPEG-compressed color images of every camera into.
+ * @param emitted_static_frames Child frames whose static transforms do not need to be converted again.
+ * @param point_cloud_options If set, also create a point cloud from the image if it is a depth image.
+ * @param rays Ray table of the image source, which is only used for depth images when point_cloud_options is set.
+ * @param compressed_depth_format If set, also compress the image in this format if it is a depth image.
+ * @param depth_filter_options If set, also filter the image into a smaller depth image if it is a depth image.
+ * @param laser_scan_options If set, also add the image to a laser scan in the body frame if it is a depth image of a
+ * body camera. The ray table is needed for this as well.
+ * @param body_transform_sources Image sources for which the transform from the body frame to the camera is returned.
+ * @param message_pool If not null, the image messages are taken from this pool.
+ * @return The converted messages if the conversion succeeded, or an error message if it failed.
+ */
+tl::expected<ConvertedImageResponse, std::string> convertImageResponse(
+    const bosdyn::api::ImageResponse& image_response, const spot_ros2::ImageSource& source,
+    const sensor_msgs::msg::CameraInfo& info, const std::string& robot_name,
+    const google::protobuf::Duration& clock_skew, bool uncompress_images, bool publish_compressed_images,
+    spot_ros2::JpegDecoderBackend jpeg_decoder,
+    const std::array<spot_ros2::JpegOutputEncoding, spot_ros2::kNumSpotCameras>& color_encodings,
+    const std::set<std::string>& emitted_static_frames,
+    const std::optional<spot_ros2::PointCloudOptions>& point_cloud_options, const spot_ros2::DepthRayTable* rays,
+    const std::optional<spot_ros2::CompressedDepthFormat> compressed_depth_format,
+    const std::optional<spot_ros2::DepthFilterOptions>& depth_filter_options,
+    const std::optional<spot_ros2::LaserScanOptions>& laser_scan_options,
+    const std::set<spot_ros2::ImageSource>& body_transform_sources, spot_ros2::ImageMessagePool* message_pool) {
+  const auto& image = image_response.shot().image();
+
+  ConvertedImageResponse out{source, std::nullopt, std::nullopt, std::nullopt, std::nullopt,
+                             std::nullopt, std::nullopt, std::nullopt, {}, {}};
+
+  if (body_transform_sources.count(out.source) > 0) {
+    out.body_tform_camera = getBodyTformCamera(image_response);
+    if (!out.body_tform_camera.has_value()) {
+      return tl::make_unexpected("Failed to get the transform from the body frame to " +
+                                 image_response.shot().frame_name_image_sensor() + " from the snapshot.");
+    }
+  }
+
+  const auto publish_image = image.format() != bosdyn::api::Image_Format_FORMAT_JPEG || uncompress_images;
+  auto info_msg = toStampedCameraInfo(info, image_response, clock_skew);
+
+  if (image.format() == bosdyn::api::Image_Format_FORMAT_JPEG && publish_compressed_images) {
+    auto compressed_image_msg = message_pool != nullptr ? message_pool->acquireCompressedImage(out.source)
+                                                        : sensor_msgs::msg::CompressedImage{};
+    const auto compressed_result = toCompressedImageMsg(image_response.shot(), info_msg.header, compressed_image_msg);
+    if (!compressed_result) {
+      return tl::make_unexpected("Failed to convert SDK image response to ROS Image message: " +
+                                 compressed_result.error());
+    }
+    // Only copy the CameraInfo if it is also needed for the uncompressed image.
+    out.compressed_image = spot_ros2::CompressedImageWithCameraInfo{std::move(compressed_image_msg),
+                                                                    publish_image ? info_msg : std::move(info_msg)};
+  }
+
+  if (publish_image) {
+    // Convert the image directly into the output struct to avoid copying the image data more than once.
+    // A recycled message already has a data buffer of the right size, so decoding into it does not allocate.
+    auto& image_with_info = out.image.emplace(spot_ros2::ImageWithCameraInfo{
+        message_pool != nullptr ? message_pool->acquireImage(out.source) : sensor_msgs::msg::Image{},
+        std::move(info_msg)});
+    // The image has the same frame and stamp as its CameraInfo, so its header does not need to be created again.
+    const auto decompress_result = spot_ros2::getDecompressImageMsg(
+        image_response.shot(), image_with_info.info.header, image_with_info.image, jpeg_decoder,
+        color_encodings[static_cast<std::size_t>(out.source.camera)]);
+    if (!decompress_result) {
+      return tl::make_unexpected("Failed to convert SDK image response to ROS Image message: " +
+                                 decompress_result.error());
+    }
+
+    // Compressing the depth image on this worker keeps it off the thread which publishes the images.
+    if (compressed_depth_format.has_value() &&
+        image.pixel_format() == bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_DEPTH_U16) {
+      const auto compress_result = spot_ros2::compressDepthImage(
+          image_with_info.image, compressed_depth_format.value(), out.compressed_depth_image.emplace());
+      if (!compress_result) {
+        return tl::make_unexpected("Failed to compress depth image: " + compress_result.error());
+      }
+    }
+
+    // Likewise, the depth image is filtered once here instead of in every consumer of the filtered image.
+    if (depth_filter_options.has_value() &&
+        image.pixel_format() == bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_DEPTH_U16) {
+      auto& filtered = out.filtered_depth_image.emplace();
+      const auto filter_result =
+          spot_ros2::filterDepthImage(image_with_info.image, image_with_info.info, getDepthScale(image_response),
+                                      depth_filter_options.value(), filtered.image, filtered.info);
+      if (!filter_result) {
+        return tl::make_unexpected("Failed to filter depth image: " + filter_result.error());
+      }
+    }
+
+    if (laser_scan_options.has_value() && rays != nullptr && out.source.type == spot_ros2::SpotImageType::DEPTH &&
+        out.source.camera != spot_ros2::SpotCamera::HAND) {
+      const auto body_tform_camera =
+          out.body_tform_camera.has_value() ? out.body_tform_camera : getBodyTformCamera(image_response);
+      if (!body_tform_camera.has_value()) {
+        return tl::make_unexpected("Failed to add depth image to laser scan: the transform from " +
+                                   image_response.shot().frame_name_image_sensor() +
+                                   " to the body frame is not in the snapshot.");
+      }
+      auto& scan = out.laser_scan.emplace();
+      spot_ros2::resetLaserScan(laser_scan_options.value(), kBodyFrame, image_with_info.info.header.stamp, scan);
+      const auto scan_result =
+          spot_ros2::addDepthImageToLaserScan(image_with_info.image, *rays, getDepthScale(image_response),
+                                              body_tform_camera.value(), laser_scan_options.value(), scan);
+      if (!scan_result) {
+        return tl::make_unexpected("Failed to add depth image to laser scan: " + scan_result.error());
+      }
+    }
+
+    // Reproject the decoded depth image here, while it is still hot in the cache of this worker. Registered depth
+    // images which are colored wait for the RGB image of their camera, which another worker may still be decoding.
+    if (point_cloud_options.has_value() && rays != nullptr &&
+        image.pixel_format() == bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_DEPTH_U16 &&
+        !(point_cloud_options->colorize_registered && out.source.type == spot_ros2::SpotImageType::DEPTH_REGISTERED)) {
+      auto& cloud = out.point_cloud.emplace();
+      const auto point_cloud_result =
+          spot_ros2::createPointCloud(image_with_info.image, image_with_info.info, *rays, getDepthScale(image_response),
+                                      point_cloud_options.value(), cloud);
+      if (!point_cloud_result) {
+        return tl::make_unexpected("Failed to create point cloud from depth image: " + point_cloud_result.error());
+      }
+    }
+  }
+
+  auto transforms_result = getImageTransforms(image_response, robot_name, clock_skew, emitted_static_frames);
+  if (!transforms_result.has_value()) {
+    return tl::make_unexpected("Failed to get image transforms: " + transforms_result.error());
+  }
+  out.transforms = std::move(transforms_result.value());
+
+  return out;
 }
 }  // namespace
 
 namespace spot_ros2 {
 
+std::shared_future<::bosdyn::client::GetImageResultType> DefaultImageClient::fetchImages(
+    const ::bosdyn::api::GetImageRequest& request, const std::size_t max_requests_in_flight,
+    const std::chrono::duration<double> timeout) {
+  const auto parameters = makeRpcParameters(timeout);
+  if (max_requests_in_flight <= 1) {
+    return image_client_->GetImageAsync(request, parameters);
+  }
+
+  std::shared_future<::bosdyn::client::GetImageResultType> next_result;
+  {
+    std::lock_guard<std::mutex> lock{pipelines_mutex_};
+    const auto call = ++pipeline_calls_;
+    auto& pipeline = pipelines_[request.SerializeAsString()];
+    pipeline.last_used = call;
+    if (pipeline.in_flight.empty()) {
+      pipeline.in_flight.push_back(image_client_->GetImageAsync(request, parameters));
+    }
+    next_result = pipeline.in_flight.front();
+    pipeline.in_flight.pop_front();
+    // Keep the pipeline full while the caller waits for and converts this response.
+    while (pipeline.in_flight.size() + 1 < max_requests_in_flight) {
+      pipeline.in_flight.push_back(image_client_->GetImageAsync(request, parameters));
+    }
+
+    // Drop the pipelines of requests that are no longer being made, so that their responses are not kept around.
+    for (auto it = pipelines_.begin(); it != pipelines_.end();) {
+      it = (call - it->second.last_used > kMaxIdlePipelineCalls) ? pipelines_.erase(it) : std::next(it);
+    }
+  }
+  return next_result;
+}
+
+tl::expected<std::shared_ptr<const sensor_msgs::msg::CameraInfo>, std::string> DefaultImageClient::getCameraInfo(
+    const ::bosdyn::api::ImageResponse& image_response, const std::optional<ImageSource>& source,
+    const google::protobuf::Duration& clock_skew) {
+  if (source.has_value()) {
+    std::lock_guard<std::mutex> lock{camera_info_cache_mutex_};
+    const auto& cached = camera_info_cache_[toImageSourceIndex(source.value())];
+    if (cached.has_value() && matchesCameraInfo(*cached->info, cached->frame_name_image_sensor, image_response)) {
+      return cached->info;
+    }
+  }
+
+  auto info_msg = toCameraInfoMsg(image_response, robot_name_, clock_skew);
+  if (!info_msg) {
+    return tl::make_unexpected(info_msg.error());
+  }
+  auto info = std::make_shared<const sensor_msgs::msg::CameraInfo>(std::move(info_msg.value()));
+  if (source.has_value()) {
+    // A rebuilt message replaces the cached one instead of modifying it, so messages that were handed out earlier are
+    // not changed while they are being copied.
+    std::lock_guard<std::mutex> lock{camera_info_cache_mutex_};
+    camera_info_cache_[toImageSourceIndex(source.value())] =
+        CachedCameraInfo{info, image_response.shot().frame_name_image_sensor()};
+  }
+  return info;
+}
+
+std::shared_ptr<const DepthRayTable> DefaultImageClient::getRayTable(const ImageSource& source,
+                                                                     const sensor_msgs::msg::CameraInfo& info) {
+  std::lock_guard<std::mutex> lock{ray_tables_mutex_};
+  auto& rays = ray_tables_[toImageSourceIndex(source)];
+  if (!rays || !rays->matches(info)) {
+    rays = std::make_shared<const DepthRayTable>(info);
+  }
+  return rays;
+}
+
 DefaultImageClient::DefaultImageClient(::bosdyn::client::ImageClient* image_client,
-                                       std::shared_ptr<TimeSyncApi> time_sync_api, const std::string& robot_name)
-    : image_client_{image_client}, time_sync_api_{time_sync_api}, robot_name_{robot_name} {}
+                                       std::shared_ptr<TimeSyncApi> time_sync_api, const std::string& robot_name,
+                                       std::shared_ptr<ThreadPoolInterfaceBase> thread_pool,
+                                       std::shared_ptr<LinkMonitor> link_monitor)
+    : image_client_{image_client},
+      time_sync_api_{time_sync_api},
+      robot_name_{robot_name},
+      thread_pool_{std::move(thread_pool)},
+      link_monitor_{std::move(link_monitor)} {}
 
 tl::expected<GetImagesResult, std::string> DefaultImageClient::getImages(::bosdyn::api::GetImageRequest request,
                                                                          bool uncompress_images,
-                                                                         bool publish_compressed_images) {
-  std::shared_future<::bosdyn::client::GetImageResultType> get_image_result_future =
-      image_client_->GetImageAsync(request);
-
-  ::bosdyn::client::GetImageResultType get_image_result = get_image_result_future.get();
+                                                                         bool publish_compressed_images,
+                                                                         const GetImagesOptions& options) {
+  const auto request_time = std::chrono::steady_clock::now();
+  tracing::stageBegin(tracing::kImagePipeline, "get_image");
+  // The future keeps the response alive while the images are converted straight from it.
+  const auto get_image_future = fetchImages(request, options.max_requests_in_flight, options.timeout);
+  if (!waitForRequest(get_image_future, options.timeout)) {
+    // The requests sent ahead of time were sent around the same time as this one, so they are not waited for either.
+    {
+      std::lock_guard<std::mutex> lock{pipelines_mutex_};
+      pipelines_.erase(request.SerializeAsString());
+    }
+    recordRequest(link_monitor_, request_time, false);
+    tracing::stageEnd(tracing::kImagePipeline, "get_image");
+    return tl::make_unexpected(makeTimedOutMessage("GetImage", options.timeout));
+  }
+  const auto& get_image_result = get_image_future.get();
+  recordRequest(link_monitor_, request_time, static_cast<bool>(get_image_result.status));
+  tracing::stageEnd(tracing::kImagePipeline, "get_image");
+  const auto response_time = std::chrono::steady_clock::now();
+  const auto response_system_time = std::chrono::system_clock::now();
   if (!get_image_result.status) {
     return tl::make_unexpected("Failed to get images: " + get_image_result.status.DebugString());
   }
 
+  GetImagesResult out;
+  out.request_duration_ = response_time - request_time;
+  out.response_sizes_.reserve(static_cast<std::size_t>(get_image_result.response.image_responses_size()));
+  for (const auto& image_response : get_image_result.response.image_responses()) {
+    if (const auto source = fromSpotImageSourceName(image_response.source().name()); source.has_value()) {
+      out.response_sizes_.emplace_back(source.value(), image_response.shot().image().data().size());
+    }
+  }
+
+  // The raw response is serialized before stale images are dropped, so that a log holds every image Spot sent.
+  if (options.keep_raw_response) {
+    out.raw_response_.resize(get_image_result.response.ByteSizeLong());
+    get_image_result.response.SerializeWithCachedSizesToArray(out.raw_response_.data());
+  }
+  if (!options.convert_images) {
+    return out;
+  }
+
   const auto clock_skew_result = time_sync_api_->getClockSkew();
   if (!clock_skew_result) {
     return tl::make_unexpected("Failed to get latest clock skew: " + clock_skew_result.error());
   }
 
-  GetImagesResult out;
+  // Drop images which are already too old to be useful before spending any time on converting them. The response is
+  // shared with the future, so the images which are kept are referenced instead of being removed from it.
+  std::vector<const bosdyn::api::ImageResponse*> image_responses;
+  image_responses.reserve(static_cast<std::size_t>(get_image_result.response.image_responses_size()));
+  const auto now = toSeconds(response_system_time);
+  const auto clock_skew = toNanoseconds(clock_skew_result.value());
   for (const auto& image_response : get_image_result.response.image_responses()) {
-    const auto& image = image_response.shot().image();
-    auto data = image.data();
+    if (options.max_image_age.count() > 0.0) {
+      const auto acquisition_ns =
+          robotTimeToLocalTime(toNanoseconds(image_response.shot().acquisition_time()), clock_skew);
+      const auto acquisition_time = static_cast<double>(acquisition_ns) * 1e-9;
+      if (now - acquisition_time > options.max_image_age.count()) {
+        ++out.stale_images_dropped_;
+        continue;
+      }
+    }
+    image_responses.push_back(&image_response);
+  }
+  const auto num_responses = image_responses.size();
+
+  // The source of every response is only looked up once, and then indexes the per-source state of this client.
+  std::vector<std::optional<ImageSource>> sources;
+  sources.reserve(num_responses);
+  for (const auto* image_response : image_responses) {
+    sources.push_back(findImageSource(image_response->source().name()));
+  }
 
-    const auto info_msg = toCameraInfoMsg(image_response, robot_name_, clock_skew_result.value());
+  // Look up the CameraInfo of every response before converting them, so that the cache is only used by this thread.
+  std::vector<std::shared_ptr<const sensor_msgs::msg::CameraInfo>> camera_infos;
+  camera_infos.reserve(num_responses);
+  for (std::size_t index = 0; index < num_responses; ++index) {
+    auto info_msg = getCameraInfo(*image_responses[index], sources[index], clock_skew_result.value());
     if (!info_msg) {
       return tl::make_unexpected("Failed to convert SDK image response to ROS CameraInfo message: " + info_msg.error());
     }
+    camera_infos.push_back(std::move(info_msg.value()));
+  }
 
-    const auto& camera_name = image_response.source().name();
-    const auto get_source_name_result = fromSpotImageSourceName(camera_name);
-    if (!get_source_name_result.has_value()) {
-      return tl::make_unexpected("Failed to convert API image source name to ImageSource: " +
-                                 get_source_name_result.error());
+  // Likewise look up the ray tables of the depth images which are reprojected into point clouds or laser scans.
+  std::vector<std::shared_ptr<const DepthRayTable>> ray_tables(num_responses);
+  if (options.point_clouds.has_value() || options.laser_scan.has_value()) {
+    for (std::size_t index = 0; index < num_responses; ++index) {
+      const auto& image_response = *image_responses[index];
+      if (sources[index].has_value() &&
+          image_response.shot().image().pixel_format() == bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_DEPTH_U16) {
+        ray_tables[index] = getRayTable(sources[index].value(), *camera_infos[index]);
+      }
     }
+  }
 
-    if (image.format() == bosdyn::api::Image_Format_FORMAT_JPEG && publish_compressed_images) {
-      const auto compressed_image_msg =
-          toCompressedImageMsg(image_response.shot(), robot_name_, clock_skew_result.value());
-      if (!compressed_image_msg) {
-        return tl::make_unexpected("Failed to convert SDK image response to ROS Image message: " +
-                                   compressed_image_msg.error());
+  const auto emitted_static_frames = getEmittedStaticFrames(options.static_transforms_refresh_period);
+
+  // When a JPEG image is both decoded and published compressed, copying its payload into the compressed message is a
+  // job of its own, so that another worker does it while the image is decoded instead of after the decode. Both jobs
+  // read the same protobuf payload, and each writes into its own message.
+  const auto split_compressed_images =
+      uncompress_images && publish_compressed_images && options.max_decode_threads > 1;
+  std::vector<std::size_t> compressed_jobs;
+  std::vector<std::optional<CompressedImageWithCameraInfo>> compressed_images(num_responses);
+  std::vector<tl::expected<void, std::string>> compressed_results(num_responses);
+  if (split_compressed_images) {
+    for (std::size_t index = 0; index < num_responses; ++index) {
+      const auto& image_response = *image_responses[index];
+      const auto& source = sources[index];
+      if (image_response.shot().image().format() != bosdyn::api::Image_Format_FORMAT_JPEG || !source.has_value()) {
+        continue;
       }
-      out.compressed_images_.try_emplace(get_source_name_result.value(),
-                                         CompressedImageWithCameraInfo{compressed_image_msg.value(), info_msg.value()});
+      compressed_images[index] = CompressedImageWithCameraInfo{
+          options.message_pool ? options.message_pool->acquireCompressedImage(source.value())
+                               : sensor_msgs::msg::CompressedImage{},
+          toStampedCameraInfo(*camera_infos[index], image_response, clock_skew_result.value())};
+      compressed_jobs.push_back(index);
     }
+  }
 
-    if (image.format() != bosdyn::api::Image_Format_FORMAT_JPEG || uncompress_images) {
-      const auto image_msg = getDecompressImageMsg(image_response.shot(), robot_name_, clock_skew_result.value());
-      if (!image_msg) {
-        return tl::make_unexpected("Failed to convert SDK image response to ROS Image message: " + image_msg.error());
+  std::vector<tl::expected<ConvertedImageResponse, std::string>> converted(num_responses);
+
+  const auto convert = [&](const std::size_t index) {
+    const auto& image_response = *image_responses[index];
+    const auto acquisition_ns = toNanoseconds(image_response.shot().acquisition_time());
+    const tracing::ScopedStage trace{tracing::kImagePipeline, "decode", image_response.source().name().c_str(),
+                                     static_cast<std::uint64_t>(acquisition_ns)};
+    const auto decode_start = std::chrono::steady_clock::now();
+    if (!sources[index].has_value()) {
+      converted[index] = tl::make_unexpected("Failed to convert API image source name to ImageSource: " +
+                                             fromSpotImageSourceName(image_response.source().name()).error());
+      return;
+    }
+    converted[index] = convertImageResponse(image_response, sources[index].value(), *camera_infos[index],
+                                            robot_name_, clock_skew_result.value(), uncompress_images,
+                                            publish_compressed_images && !compressed_images[index].has_value(),
+                                            options.jpeg_decoder, options.color_image_encodings, *emitted_static_frames,
+                                            options.point_clouds, ray_tables[index].get(), options.compressed_depth,
+                                            options.depth_filter, options.laser_scan, options.body_transform_sources,
+                                            options.message_pool.get());
+    if (options.measure_latency && converted[index].has_value()) {
+      auto& latency = converted[index].value().latency;
+      latency.decode = std::chrono::duration<double>{std::chrono::steady_clock::now() - decode_start}.count();
+      latency.robot_to_host = toSeconds(response_system_time) -
+                              toSeconds(robotTimeToLocalTime(image_response.shot().acquisition_time(),
+                                                             clock_skew_result.value()));
+      latency.response_time = response_time;
+    }
+  };
+
+  // The decode jobs come first, since they take the longest, and are followed by the compressed copies.
+  const auto num_jobs = num_responses + compressed_jobs.size();
+  const auto run_job = [&](const std::size_t job) {
+    if (job < num_responses) {
+      convert(job);
+      return;
+    }
+    const auto index = compressed_jobs[job - num_responses];
+    auto& compressed_image = compressed_images[index].value();
+    compressed_results[index] = toCompressedImageMsg(image_responses[index]->shot(), compressed_image.info.header,
+                                                     compressed_image.image);
+  };
+
+  // Each worker claims the next job until none are left, so that a slow decode on one camera does not leave the other
+  // workers idle. Every result is written to its own slot, so no further locking is needed.
+  thread_pool_->parallelFor(num_jobs, options.max_decode_threads, run_job);
+
+  if (options.point_clouds.has_value() && options.point_clouds->colorize_registered) {
+    // Color the point clouds of the registered depth images with the RGB image of the same camera. Without an RGB
+    // image of the same resolution in this request, the point cloud is created without colors. NV12 images cannot color
+    // a point cloud, since they have no color per pixel.
+    std::array<const ImageWithCameraInfo*, kNumSpotCameras> color_images{};
+    for (const auto& result : converted) {
+      if (result.has_value() && result->source.type == SpotImageType::RGB && result->image.has_value() &&
+          options.color_image_encodings[static_cast<std::size_t>(result->source.camera)] != JpegOutputEncoding::NV12) {
+        color_images[static_cast<std::size_t>(result->source.camera)] = &result->image.value();
+      }
+    }
+    for (std::size_t index = 0; index < num_responses; ++index) {
+      auto& result = converted[index];
+      if (!result.has_value() || result->source.type != SpotImageType::DEPTH_REGISTERED ||
+          !result->image.has_value() || !ray_tables[index]) {
+        continue;
+      }
+      const auto& depth = result->image.value();
+      const auto depth_scale = getDepthScale(*image_responses[index]);
+      auto* color = color_images[static_cast<std::size_t>(result->source.camera)];
+      if (color != nullptr && (color->image.width != depth.image.width || color->image.height != depth.image.height)) {
+        color = nullptr;
+      }
+      auto& cloud = result->point_cloud.emplace();
+      const auto point_cloud_result =
+          color != nullptr ? createColoredPointCloud(depth.image, color->image, depth.info, *ray_tables[index],
+                                                     depth_scale, options.point_clouds.value(), cloud)
+                           : createPointCloud(depth.image, depth.info, *ray_tables[index], depth_scale,
+                                              options.point_clouds.value(), cloud);
+      if (!point_cloud_result) {
+        return tl::make_unexpected("Failed to create point cloud from depth image: " + point_cloud_result.error());
       }
-      out.images_.try_emplace(get_source_name_result.value(), ImageWithCameraInfo{image_msg.value(), info_msg.value()});
     }
+  }
 
-    const auto transforms_result = getImageTransforms(image_response, robot_name_, clock_skew_result.value());
-    if (transforms_result.has_value()) {
-      out.transforms_.insert(out.transforms_.end(), transforms_result.value().begin(), transforms_result.value().end());
-    } else {
-      return tl::make_unexpected("Failed to get image transforms: " + transforms_result.error());
+  // Merge the results in the order of the responses so that the output does not depend on which worker finished first.
+  out.images_.reserve(num_responses);
+  out.compressed_images_.reserve(num_responses);
+  out.point_clouds_.reserve(num_responses);
+  if (options.compressed_depth.has_value()) {
+    out.compressed_depth_images_.reserve(num_responses);
+  }
+  if (options.depth_filter.has_value()) {
+    out.filtered_depth_images_.reserve(num_responses);
+  }
+  if (options.measure_latency) {
+    out.latencies_.reserve(num_responses);
+  }
+  for (std::size_t index = 0; index < num_responses; ++index) {
+    auto& result = converted[index];
+    if (!result.has_value()) {
+      return tl::make_unexpected(result.error());
+    }
+    auto& value = result.value();
+    if (compressed_images[index].has_value()) {
+      if (!compressed_results[index].has_value()) {
+        return tl::make_unexpected("Failed to convert SDK image response to ROS Image message: " +
+                                   compressed_results[index].error());
+      }
+      out.compressed_images_.emplace_back(value.source, std::move(compressed_images[index].value()));
+    }
+    if (value.compressed_image.has_value()) {
+      out.compressed_images_.emplace_back(value.source, std::move(value.compressed_image.value()));
+    }
+    if (value.image.has_value()) {
+      out.images_.emplace_back(value.source, std::move(value.image.value()));
     }
+    if (value.point_cloud.has_value()) {
+      out.point_clouds_.emplace_back(value.source, std::move(value.point_cloud.value()));
+    }
+    if (value.compressed_depth_image.has_value()) {
+      out.compressed_depth_images_.emplace_back(value.source, std::move(value.compressed_depth_image.value()));
+    }
+    if (value.filtered_depth_image.has_value()) {
+      out.filtered_depth_images_.emplace_back(value.source, std::move(value.filtered_depth_image.value()));
+    }
+    if (value.body_tform_camera.has_value()) {
+      out.body_transforms_.emplace_back(value.source, value.body_tform_camera.value());
+    }
+    if (value.laser_scan.has_value()) {
+      // The scans of the cameras are merged into the first one, which is stamped with the newest of their images.
+      auto& scan = value.laser_scan.value();
+      if (!out.laser_scan_.has_value()) {
+        scan.header.frame_id = robot_name_.empty() ? kBodyFrame : robot_name_ + "/" + kBodyFrame;
+        out.laser_scan_ = std::move(scan);
+      } else {
+        if (const auto merge_result = mergeLaserScans(scan, out.laser_scan_.value()); !merge_result) {
+          return tl::make_unexpected("Failed to merge laser scans: " + merge_result.error());
+        }
+        if (toSeconds(scan.header.stamp) > toSeconds(out.laser_scan_->header.stamp)) {
+          out.laser_scan_->header.stamp = scan.header.stamp;
+        }
+      }
+    }
+    if (options.measure_latency) {
+      out.latencies_.emplace_back(value.source, value.latency);
+    }
+    out.transforms_.insert(out.transforms_.end(), std::make_move_iterator(value.transforms.begin()),
+                           std::make_move_iterator(value.transforms.end()));
+  }
+
+  if (!out.transforms_.empty()) {
+    addEmittedStaticFrames(*emitted_static_frames, out.transforms_);
   }
 
   return out;
 }
 
+std::shared_ptr<const std::set<std::string>> DefaultImageClient::getEmittedStaticFrames(
+    const std::chrono::duration<double> refresh_period) {
+  std::lock_guard<std::mutex> lock{emitted_static_frames_mutex_};
+  const auto now = std::chrono::steady_clock::now();
+  if (refresh_period.count() > 0.0 && now - emitted_static_frames_reset_time_ >= refresh_period) {
+    emitted_static_frames_ = std::make_shared<const std::set<std::string>>();
+    emitted_static_frames_reset_time_ = now;
+  }
+  return emitted_static_frames_;
+}
+
+void DefaultImageClient::addEmittedStaticFrames(const std::set<std::string>& previous_frames,
+                                                const std::vector<geometry_msgs::msg::TransformStamped>& transforms) {
+  // The child frames in the transforms are prefixed with the robot name, but the frames in the image responses are not.
+  const auto prefix_length = robot_name_.empty() ? 0 : robot_name_.size() + 1;
+  auto frames = previous_frames;
+  for (const auto& transform : transforms) {
+    frames.insert(transform.child_frame_id.substr(prefix_length));
+  }
+
+  std::lock_guard<std::mutex> lock{emitted_static_frames_mutex_};
+  // Merge with any frames which were added by a concurrent call since this call read the set.
+  frames.insert(emitted_static_frames_->cbegin(), emitted_static_frames_->cend());
+  emitted_static_frames_ = std::make_shared<const std::set<std::string>>(std::move(frames));
+}
+
 }  // namespace spot_ros2
@@ -1,26 +1,98 @@
 // Copyright (c) 2023 Boston Dynamics AI Institute LLC. All rights reserved.
 
 #include <spot_driver/api/default_kinematic_api.hpp>
+#include <spot_driver/api/request_deadline.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <utility>
+
+namespace {
+tl::expected<spot_ros2::InverseKinematicsResponse, std::string> toExpected(
+    const spot_ros2::Result<spot_ros2::InverseKinematicsResponse>& result) {
+  if (result) {
+    return result.response;
+  }
+
+  const auto error_code = result.status.code().value();
+  const auto error_message = result.status.message();
+  return tl::make_unexpected("The InverseKinematics service returned with error code " + std::to_string(error_code) +
+                             ": " + error_message);
+}
+}  // namespace
 
 namespace spot_ros2 {
-DefaultKinematicApi::DefaultKinematicApi(bosdyn::client::InverseKinematicsClient* kinematic_client)
-    : kinematic_client_{kinematic_client} {}
+DefaultKinematicApi::DefaultKinematicApi(bosdyn::client::InverseKinematicsClient* kinematic_client,
+                                         std::shared_ptr<LinkMonitor> link_monitor)
+    : kinematic_client_{kinematic_client}, link_monitor_{std::move(link_monitor)} {}
 
 tl::expected<InverseKinematicsResponse, std::string> DefaultKinematicApi::getSolutions(
-    InverseKinematicsRequest& request) {
+    InverseKinematicsRequest& request, const std::chrono::duration<double> timeout) {
+  const auto request_start = std::chrono::steady_clock::now();
   try {
-    auto result = kinematic_client_->InverseKinematics(request);
-    if (result) {
-      return result.response;
+    const auto future = kinematic_client_->InverseKinematicsAsync(request, makeRpcParameters(timeout));
+    if (!waitForRequest(future, timeout)) {
+      recordRequest(link_monitor_, request_start, false);
+      return tl::make_unexpected(makeTimedOutMessage("InverseKinematics", timeout));
     }
-
-    const auto error_code = result.status.code().value();
-    const auto error_message = result.status.message();
-    return tl::make_unexpected("The InverseKinematics service returned with error code " + std::to_string(error_code) +
-                               ": " + error_message);
+    auto response = toExpected(future.get());
+    recordRequest(link_monitor_, request_start, response.has_value());
+    return response;
   } catch (const std::exception& ex) {
+    recordRequest(link_monitor_, request_start, false);
     return tl::make_unexpected("Failed to query the InverseKinematics service: " + std::string{ex.what()});
   }
 }
 
+std::vector<tl::expected<InverseKinematicsResponse, std::string>> DefaultKinematicApi::getBatchSolutions(
+    std::vector<InverseKinematicsRequest>& requests, const std::size_t max_requests_in_flight,
+    const std::chrono::duration<double> timeout) {
+  std::vector<tl::expected<InverseKinematicsResponse, std::string>> responses;
+  responses.reserve(requests.size());
+  // Each request is kept with the time at which it was sent, so that its latency can be recorded.
+  std::deque<std::pair<std::chrono::steady_clock::time_point, std::shared_future<Result<InverseKinematicsResponse>>>>
+      in_flight;
+  const auto collect_oldest = [this, &responses, &in_flight, timeout]() {
+    const auto& [request_start, future] = in_flight.front();
+    try {
+      // A request which is still outstanding past its deadline is abandoned, so that it does not hold up the others.
+      if (waitForRequest(future, timeout)) {
+        responses.push_back(toExpected(future.get()));
+      } else {
+        responses.push_back(tl::make_unexpected(makeTimedOutMessage("InverseKinematics", timeout)));
+      }
+    } catch (const std::exception& ex) {
+      responses.push_back(
+          tl::make_unexpected("Failed to query the InverseKinematics service: " + std::string{ex.what()}));
+    }
+    recordRequest(link_monitor_, request_start, responses.back().has_value());
+    in_flight.pop_front();
+  };
+
+  // The responses are collected in the order of the requests, starting a new request whenever one finishes.
+  for (auto& request : requests) {
+    if (in_flight.size() >= std::max<std::size_t>(max_requests_in_flight, 1)) {
+      collect_oldest();
+    }
+    try {
+      const auto request_start = std::chrono::steady_clock::now();
+      in_flight.emplace_back(request_start,
+                             kinematic_client_->InverseKinematicsAsync(request, makeRpcParameters(timeout)));
+    } catch (const std::exception& ex) {
+      // Wait for the outstanding requests, so that this failure is reported in its place.
+      while (!in_flight.empty()) {
+        collect_oldest();
+      }
+      responses.push_back(
+          tl::make_unexpected("Failed to query the InverseKinematics service: " + std::string{ex.what()}));
+    }
+  }
+  while (!in_flight.empty()) {
+    collect_oldest();
+  }
+  return responses;
+}
+
 }  // namespace spot_ros2
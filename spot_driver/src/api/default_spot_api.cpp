@@ -8,25 +8,50 @@
 #include <spot_driver/api/default_spot_api.hpp>
 #include <spot_driver/api/default_state_client.hpp>
 #include <spot_driver/api/default_time_sync_api.hpp>
+#include <spot_driver/api/link_monitor.hpp>
+#include <spot_driver/interfaces/work_stealing_thread_pool.hpp>
 #include <tl_expected/expected.hpp>
 #include "spot_driver/api/default_world_object_client.hpp"
 #include "spot_driver/api/state_client_interface.hpp"
 
+namespace {
+/** Return the client of the default service of the given type, or nullptr if it cannot be created. */
+template <typename ClientT>
+ClientT* ensureServiceClient(::bosdyn::client::Robot& robot) {
+  const auto result = robot.EnsureServiceClient<ClientT>(ClientT::GetDefaultServiceName());
+  return result.status ? result.response : nullptr;
+}
+}  // namespace
+
 namespace spot_ros2 {
 
+std::map<DefaultSpotApi::SessionKey, std::weak_ptr<DefaultSpotApi::Session>> DefaultSpotApi::sessions_;
+std::mutex DefaultSpotApi::sessions_mutex_;
+std::map<std::optional<std::string>, std::weak_ptr<::bosdyn::client::ClientSdk>> DefaultSpotApi::client_sdks_;
+
 DefaultSpotApi::DefaultSpotApi(const std::string& sdk_client_name, const std::chrono::seconds timesync_timeout,
                                const std::optional<std::string>& certificate)
-    : timesync_timeout_(timesync_timeout) {
-  if (certificate.has_value()) {
-    client_sdk_ = std::make_unique<::bosdyn::client::ClientSdk>();
-    client_sdk_->SetClientName(sdk_client_name);
-    if (const auto status = client_sdk_->LoadRobotCertFromFile(certificate.value()); !status) {
-      throw std::runtime_error(status.message());
+    : sdk_client_name_(sdk_client_name), certificate_(certificate), timesync_timeout_(timesync_timeout) {}
+
+tl::expected<std::shared_ptr<::bosdyn::client::ClientSdk>, std::string> DefaultSpotApi::getClientSdk() const {
+  auto& shared_sdk = client_sdks_[certificate_];
+  if (auto sdk = shared_sdk.lock()) {
+    return sdk;
+  }
+
+  std::shared_ptr<::bosdyn::client::ClientSdk> sdk;
+  if (certificate_.has_value()) {
+    sdk = std::make_shared<::bosdyn::client::ClientSdk>();
+    sdk->SetClientName(sdk_client_name_);
+    if (const auto status = sdk->LoadRobotCertFromFile(certificate_.value()); !status) {
+      return tl::make_unexpected("Failed to load the robot certificate: " + status.message());
     }
-    client_sdk_->Init();
+    sdk->Init();
   } else {
-    client_sdk_ = ::bosdyn::client::CreateStandardSDK(sdk_client_name);
+    sdk = ::bosdyn::client::CreateStandardSDK(sdk_client_name_);
   }
+  shared_sdk = sdk;
+  return sdk;
 }
 
 tl::expected<void, std::string> DefaultSpotApi::createRobot(const std::string& robot_name,
@@ -34,117 +59,163 @@ tl::expected<void, std::string> DefaultSpotApi::createRobot(const std::string& r
                                                             const std::optional<int>& port) {
   robot_name_ = robot_name;
 
-  auto create_robot_result = client_sdk_->CreateRobot(ip_address, ::bosdyn::client::USE_PROXY);
+  std::lock_guard<std::mutex> lock{sessions_mutex_};
+  auto& shared_session = sessions_[SessionKey{robot_name, ip_address, port}];
+  if (auto session = shared_session.lock()) {
+    session_ = std::move(session);
+    return {};
+  }
+
+  // The SDK is only created when this is the first session in the process which uses its certificate.
+  auto client_sdk = getClientSdk();
+  if (!client_sdk) {
+    return tl::make_unexpected(client_sdk.error());
+  }
+
+  auto create_robot_result = client_sdk.value()->CreateRobot(ip_address, ::bosdyn::client::USE_PROXY);
   if (!create_robot_result.status) {
     return tl::make_unexpected("Received error result when creating SDK robot interface: " +
                                create_robot_result.status.DebugString());
   }
 
-  robot_ = std::move(create_robot_result.response);
+  auto session = std::make_shared<Session>();
+  session->robot = std::move(create_robot_result.response);
 
   if (port.has_value()) {
-    robot_->UpdateSecureChannelPort(port.value());
+    session->robot->UpdateSecureChannelPort(port.value());
   }
 
+  // The robot interface keeps using the SDK it was created with, so the SDK has to live as long as the session.
+  session->client_sdk = std::move(client_sdk.value());
+  shared_session = session;
+  session_ = std::move(session);
   return {};
 }
 
 tl::expected<void, std::string> DefaultSpotApi::authenticate(const std::string& username, const std::string& password) {
-  const auto authenticate_result = robot_->Authenticate(username, password);
+  if (!session_) {
+    return tl::make_unexpected("The robot interface must be created before authenticating.");
+  }
+  std::lock_guard<std::mutex> lock{session_->mutex};
+  // Another node in this process already authenticated the session with the same credentials, so its clients and time
+  // synchronization can be used as they are.
+  if (session_->credentials.has_value() && session_->credentials->first == username &&
+      session_->credentials->second == password) {
+    return {};
+  }
+
+  auto& robot = session_->robot;
+  const auto authenticate_result = robot->Authenticate(username, password);
   if (!authenticate_result) {
     return tl::make_unexpected("Authentication with provided username and password did not succeed: " +
                                authenticate_result.DebugString());
   }
   // Start time synchronization between the robot and the client system.
   // This must be done only after a successful authentication.
-  const auto start_time_sync_response = robot_->StartTimeSync();
+  const auto start_time_sync_response = robot->StartTimeSync();
   if (!start_time_sync_response) {
     return tl::make_unexpected("Failed to start time synchronization.");
   }
 
-  const auto get_time_sync_thread_response = robot_->GetTimeSyncThread();
+  const auto get_time_sync_thread_response = robot->GetTimeSyncThread();
   if (!get_time_sync_thread_response) {
     return tl::make_unexpected("Failed to get the time synchronization thread.");
   }
-  time_sync_api_ = std::make_shared<DefaultTimeSyncApi>(get_time_sync_thread_response.response, timesync_timeout_);
-
-  // Image API.
-  const auto image_client_result = robot_->EnsureServiceClient<::bosdyn::client::ImageClient>(
-      ::bosdyn::client::ImageClient::GetDefaultServiceName());
-  if (!image_client_result.status) {
-    return tl::make_unexpected("Failed to create Image client.");
-  }
-  // TODO(jschornak-bdai): apply clock skew in the image publisher instead of in DefaultImageClient
-  image_client_interface_ =
-      std::make_shared<DefaultImageClient>(image_client_result.response, time_sync_api_, robot_name_);
-
-  const auto robot_state_result = robot_->EnsureServiceClient<::bosdyn::client::RobotStateClient>(
-      ::bosdyn::client::RobotStateClient::GetDefaultServiceName());
-  if (!robot_state_result.status) {
-    return tl::make_unexpected("Failed to get robot state service client.");
-  }
-  state_client_interface_ = std::make_shared<DefaultStateClient>(robot_state_result.response);
-
-  // Kinematic API.
-  const auto kinematic_api_result = robot_->EnsureServiceClient<::bosdyn::client::InverseKinematicsClient>(
-      ::bosdyn::client::InverseKinematicsClient::GetDefaultServiceName());
-  if (!kinematic_api_result.status) {
-    // Failure to create the kinematic interface is not an error state, since it does not exist in older versions of the
-    // Spot firmware, so don't return here.
-    kinematic_interface_ = nullptr;
-  } else {
-    // The kinematic interface is only available if the corresponding Spot API client was successfully created.
-    kinematic_interface_ = std::make_shared<DefaultKinematicApi>(kinematic_api_result.response);
-  }
-
-  const auto world_object_client_result = robot_->EnsureServiceClient<::bosdyn::client::WorldObjectClient>(
-      ::bosdyn::client::WorldObjectClient::GetDefaultServiceName());
-  if (!world_object_client_result.status) {
-    return tl::make_unexpected("Failed to create world object client: " +
-                               world_object_client_result.status.DebugString());
-  }
-  if (world_object_client_result.response == nullptr) {
-    return tl::make_unexpected("Failed to create world object client (nullptr): " +
-                               world_object_client_result.status.DebugString());
-  }
-  world_object_client_interface_ = std::make_shared<DefaultWorldObjectClient>(world_object_client_result.response);
+  session_->time_sync_api =
+      std::make_shared<DefaultTimeSyncApi>(get_time_sync_thread_response.response, timesync_timeout_);
 
+  // The service clients are created when they are first accessed, since each one needs a directory lookup and most
+  // nodes only use one of them.
+  session_->credentials.emplace(username, password);
   return {};
 }
 
 tl::expected<bool, std::string> DefaultSpotApi::hasArm() const {
+  if (!session_) {
+    return tl::make_unexpected("The robot interface must be created before checking for an arm.");
+  }
+  std::lock_guard<std::mutex> lock{session_->mutex};
+  // The arm does not change while the driver is running, so the service list is only queried once per session.
+  if (session_->has_arm.has_value()) {
+    return session_->has_arm.value();
+  }
+
   // Determine if Spot has an arm by checking if the client for gripper camera parameters exists, since Spots without
   // arms do not have this client.
-  const auto list_result = robot_->ListServices();
+  const auto list_result = session_->robot->ListServices();
   if (!list_result.status) {
     return tl::make_unexpected("Failed to retrieve list of Spot services.");
   }
 
   const auto& services = list_result.response;
 
-  return std::find_if(services.cbegin(), services.cend(), [](const ::bosdyn::api::ServiceEntry& entry) {
-           return entry.name() == ::bosdyn::client::GripperCameraParamClient::GetDefaultServiceName();
-         }) != services.cend();
+  session_->has_arm = std::find_if(services.cbegin(), services.cend(), [](const ::bosdyn::api::ServiceEntry& entry) {
+                        return entry.name() == ::bosdyn::client::GripperCameraParamClient::GetDefaultServiceName();
+                      }) != services.cend();
+  return session_->has_arm.value();
 }
 
 std::shared_ptr<ImageClientInterface> DefaultSpotApi::image_client_interface() const {
-  return image_client_interface_;
+  if (!session_) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock{session_->mutex};
+  if (!session_->image_client_interface && session_->credentials.has_value()) {
+    if (auto* client = ensureServiceClient<::bosdyn::client::ImageClient>(*session_->robot)) {
+      // TODO(jschornak-bdai): apply clock skew in the image publisher instead of in DefaultImageClient
+      session_->image_client_interface =
+          std::make_shared<DefaultImageClient>(client, session_->time_sync_api, robot_name_, getSharedThreadPool(),
+                                               LinkMonitor::getForRobot(robot_name_));
+    }
+  }
+  return session_->image_client_interface;
 }
 
 std::shared_ptr<StateClientInterface> DefaultSpotApi::stateClientInterface() const {
-  return state_client_interface_;
+  if (!session_) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock{session_->mutex};
+  if (!session_->state_client_interface && session_->credentials.has_value()) {
+    if (auto* client = ensureServiceClient<::bosdyn::client::RobotStateClient>(*session_->robot)) {
+      session_->state_client_interface =
+          std::make_shared<DefaultStateClient>(client, LinkMonitor::getForRobot(robot_name_));
+    }
+  }
+  return session_->state_client_interface;
 }
 
 std::shared_ptr<KinematicApi> DefaultSpotApi::kinematicInterface() const {
-  return kinematic_interface_;
+  if (!session_) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock{session_->mutex};
+  // The kinematic client does not exist in older versions of the Spot firmware, in which case nullptr is returned.
+  if (!session_->kinematic_interface && session_->credentials.has_value()) {
+    if (auto* client = ensureServiceClient<::bosdyn::client::InverseKinematicsClient>(*session_->robot)) {
+      session_->kinematic_interface =
+          std::make_shared<DefaultKinematicApi>(client, LinkMonitor::getForRobot(robot_name_));
+    }
+  }
+  return session_->kinematic_interface;
 }
 
 std::shared_ptr<TimeSyncApi> DefaultSpotApi::timeSyncInterface() const {
-  return time_sync_api_;
+  return session_ ? session_->time_sync_api : nullptr;
 }
 
 std::shared_ptr<WorldObjectClientInterface> DefaultSpotApi::worldObjectClientInterface() const {
-  return world_object_client_interface_;
+  if (!session_) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock{session_->mutex};
+  if (!session_->world_object_client_interface && session_->credentials.has_value()) {
+    if (auto* client = ensureServiceClient<::bosdyn::client::WorldObjectClient>(*session_->robot)) {
+      session_->world_object_client_interface =
+          std::make_shared<DefaultWorldObjectClient>(client, LinkMonitor::getForRobot(robot_name_));
+    }
+  }
+  return session_->world_object_client_interface;
 }
 
 }  // namespace spot_ros2
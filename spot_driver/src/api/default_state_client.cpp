@@ -2,16 +2,30 @@
 
 #include <bosdyn/api/robot_state.pb.h>
 #include <spot_driver/api/default_state_client.hpp>
+#include <spot_driver/api/request_deadline.hpp>
 #include <spot_driver/conversions/robot_state.hpp>
+#include <chrono>
 #include <string>
 #include <tl_expected/expected.hpp>
+#include <utility>
 
 namespace spot_ros2 {
 
-DefaultStateClient::DefaultStateClient(::bosdyn::client::RobotStateClient* client) : client_{client} {}
+DefaultStateClient::DefaultStateClient(::bosdyn::client::RobotStateClient* client,
+                                       std::shared_ptr<LinkMonitor> link_monitor)
+    : client_{client}, link_monitor_{std::move(link_monitor)} {}
 
-tl::expected<bosdyn::api::RobotState, std::string> DefaultStateClient::getRobotState() {
-  const auto get_robot_state_result = client_->GetRobotStateAsync().get();
+tl::expected<bosdyn::api::RobotState, std::string> DefaultStateClient::getRobotState(
+    const std::chrono::duration<double> timeout) {
+  // The result is read in place from the future, so that the robot state is only copied once, into the return value.
+  const auto request_start = std::chrono::steady_clock::now();
+  auto get_robot_state_future = client_->GetRobotStateAsync(makeRpcParameters(timeout));
+  if (!waitForRequest(get_robot_state_future, timeout)) {
+    recordRequest(link_monitor_, request_start, false);
+    return tl::make_unexpected(makeTimedOutMessage("GetRobotState", timeout));
+  }
+  const auto& get_robot_state_result = get_robot_state_future.get();
+  recordRequest(link_monitor_, request_start, static_cast<bool>(get_robot_state_result.status));
   if (!get_robot_state_result.status || !get_robot_state_result.response.has_robot_state()) {
     return tl::make_unexpected("Failed to get robot state: " + get_robot_state_result.status.DebugString());
   }
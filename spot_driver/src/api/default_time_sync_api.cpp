@@ -1,9 +1,24 @@
 // Copyright (c) 2023-2024 Boston Dynamics AI Institute LLC. All rights reserved.
 
 #include <chrono>
+#include <cstdint>
 #include <spot_driver/api/default_time_sync_api.hpp>
 #include <tl_expected/expected.hpp>
 
+namespace {
+constexpr std::int64_t kNanosecondsPerSecond = 1000000000;
+
+std::int64_t steadyClockNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::int64_t systemClockNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+}  // namespace
+
 namespace spot_ros2 {
 
 DefaultTimeSyncApi::DefaultTimeSyncApi(std::shared_ptr<::bosdyn::client::TimeSyncThread> time_sync_thread,
@@ -11,6 +26,27 @@ DefaultTimeSyncApi::DefaultTimeSyncApi(std::shared_ptr<::bosdyn::client::TimeSyn
     : time_sync_thread_{time_sync_thread}, timesync_timeout_{timesync_timeout} {}
 
 tl::expected<google::protobuf::Duration, std::string> DefaultTimeSyncApi::getClockSkew() {
+  const auto refreshed_ns = clock_skew_refreshed_ns_.load(std::memory_order_acquire);
+  if (refreshed_ns == 0 ||
+      steadyClockNanoseconds() - refreshed_ns >=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(kClockSkewRefreshPeriod).count()) {
+    if (const auto result = refreshClockSkew(); !result) {
+      return tl::make_unexpected(result.error());
+    }
+  }
+  const auto predicted_clock_skew = clock_skew_filter_.predict(systemClockNanoseconds());
+  if (!predicted_clock_skew) {
+    return tl::make_unexpected("Clock skew was not measured yet.");
+  }
+  // Seconds and nanos of a protobuf Duration have the same sign, as does the truncating division.
+  const auto clock_skew_ns = *predicted_clock_skew;
+  google::protobuf::Duration clock_skew;
+  clock_skew.set_seconds(clock_skew_ns / kNanosecondsPerSecond);
+  clock_skew.set_nanos(static_cast<std::int32_t>(clock_skew_ns % kNanosecondsPerSecond));
+  return clock_skew;
+}
+
+tl::expected<void, std::string> DefaultTimeSyncApi::refreshClockSkew() {
   if (!time_sync_thread_) {
     return tl::make_unexpected("Time sync thread was not initialized.");
   }
@@ -25,7 +61,11 @@ tl::expected<google::protobuf::Duration, std::string> DefaultTimeSyncApi::getClo
     return tl::make_unexpected("Received a failure result from the TimeSyncEndpoint: " +
                                get_skew_response.status.DebugString());
   }
-  return *get_skew_response.response;
+  const auto& clock_skew = *get_skew_response.response;
+  clock_skew_filter_.update(systemClockNanoseconds(),
+                            clock_skew.seconds() * kNanosecondsPerSecond + clock_skew.nanos());
+  clock_skew_refreshed_ns_.store(steadyClockNanoseconds(), std::memory_order_release);
+  return {};
 }
 
 }  // namespace spot_ros2
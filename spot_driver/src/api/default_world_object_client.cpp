@@ -1,40 +1,122 @@
 // Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
 
 #include <spot_driver/api/default_world_object_client.hpp>
+#include <spot_driver/api/request_deadline.hpp>
 
 #include <bosdyn/api/world_object.pb.h>
 #include <bosdyn/client/world_objects/world_object_client.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <future>
 #include <tl_expected/expected.hpp>
+#include <utility>
+#include <vector>
+
+namespace {
+tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string> toExpected(
+    const ::bosdyn::client::MutateWorldObjectsResultType& result) {
+  if (result) {
+    return result.response;
+  }
+  return tl::make_unexpected("The MutateWorldObjects service returned with error code " +
+                             std::to_string(result.status.code().value()) + ": " + result.status.message());
+}
+}  // namespace
 
 namespace spot_ros2 {
 
-DefaultWorldObjectClient::DefaultWorldObjectClient(bosdyn::client::WorldObjectClient* client) : client_{client} {}
+DefaultWorldObjectClient::DefaultWorldObjectClient(bosdyn::client::WorldObjectClient* client,
+                                                   std::shared_ptr<LinkMonitor> link_monitor)
+    : client_{client}, link_monitor_{std::move(link_monitor)} {}
 
 tl::expected<::bosdyn::api::ListWorldObjectResponse, std::string> DefaultWorldObjectClient::listWorldObjects(
-    ::bosdyn::api::ListWorldObjectRequest& request) const {
+    ::bosdyn::api::ListWorldObjectRequest& request, const std::chrono::duration<double> timeout) const {
+  const auto request_start = std::chrono::steady_clock::now();
   try {
-    auto result = client_->ListWorldObjects(request);
+    const auto future = client_->ListWorldObjectsAsync(request, makeRpcParameters(timeout));
+    if (!waitForRequest(future, timeout)) {
+      recordRequest(link_monitor_, request_start, false);
+      return tl::make_unexpected(makeTimedOutMessage("ListWorldObjects", timeout));
+    }
+    const auto& result = future.get();
+    recordRequest(link_monitor_, request_start, static_cast<bool>(result));
     if (result) {
       return result.response;
     }
     return tl::make_unexpected("The ListWorldObjects service returned with error code " +
                                std::to_string(result.status.code().value()) + ": " + result.status.message());
   } catch (const std::exception& ex) {
+    recordRequest(link_monitor_, request_start, false);
     return tl::make_unexpected("Failed to query the ListWorldObjects service: " + std::string{ex.what()});
   }
 }
 
 tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string> DefaultWorldObjectClient::mutateWorldObject(
-    ::bosdyn::api::MutateWorldObjectRequest& request) const {
+    ::bosdyn::api::MutateWorldObjectRequest& request, const std::chrono::duration<double> timeout) const {
+  const auto request_start = std::chrono::steady_clock::now();
   try {
-    auto result = client_->MutateWorldObjects(request);
-    if (result) {
-      return result.response;
+    const auto future = client_->MutateWorldObjectsAsync(request, makeRpcParameters(timeout));
+    if (!waitForRequest(future, timeout)) {
+      recordRequest(link_monitor_, request_start, false);
+      return tl::make_unexpected(makeTimedOutMessage("MutateWorldObjects", timeout));
     }
-    return tl::make_unexpected("The MutateWorldObjects service returned with error code " +
-                               std::to_string(result.status.code().value()) + ": " + result.status.message());
+    auto response = toExpected(future.get());
+    recordRequest(link_monitor_, request_start, response.has_value());
+    return response;
   } catch (const std::exception& ex) {
+    recordRequest(link_monitor_, request_start, false);
     return tl::make_unexpected("Failed to query the MutateWorldObjects service: " + std::string{ex.what()});
   }
 }
+
+std::vector<tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>>
+DefaultWorldObjectClient::mutateWorldObjects(std::vector<::bosdyn::api::MutateWorldObjectRequest>& requests,
+                                             const std::size_t max_requests_in_flight,
+                                             const std::chrono::duration<double> timeout) const {
+  std::vector<tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>> responses;
+  responses.reserve(requests.size());
+  // Each request is kept with the time at which it was sent, so that its latency can be recorded.
+  std::deque<std::pair<std::chrono::steady_clock::time_point,
+                       std::shared_future<::bosdyn::client::MutateWorldObjectsResultType>>>
+      in_flight;
+  const auto collect_oldest = [this, &responses, &in_flight, timeout]() {
+    const auto& [request_start, future] = in_flight.front();
+    try {
+      // A request which is still outstanding past its deadline is abandoned, so that it does not hold up the others.
+      if (waitForRequest(future, timeout)) {
+        responses.push_back(toExpected(future.get()));
+      } else {
+        responses.push_back(tl::make_unexpected(makeTimedOutMessage("MutateWorldObjects", timeout)));
+      }
+    } catch (const std::exception& ex) {
+      responses.push_back(
+          tl::make_unexpected("Failed to query the MutateWorldObjects service: " + std::string{ex.what()}));
+    }
+    recordRequest(link_monitor_, request_start, responses.back().has_value());
+    in_flight.pop_front();
+  };
+
+  // The responses are collected in the order of the requests, starting a new request whenever one finishes.
+  for (auto& request : requests) {
+    if (in_flight.size() >= std::max<std::size_t>(max_requests_in_flight, 1)) {
+      collect_oldest();
+    }
+    try {
+      const auto request_start = std::chrono::steady_clock::now();
+      in_flight.emplace_back(request_start, client_->MutateWorldObjectsAsync(request, makeRpcParameters(timeout)));
+    } catch (const std::exception& ex) {
+      // Wait for the outstanding requests, so that this failure is reported in its place.
+      while (!in_flight.empty()) {
+        collect_oldest();
+      }
+      responses.push_back(
+          tl::make_unexpected("Failed to query the MutateWorldObjects service: " + std::string{ex.what()}));
+    }
+  }
+  while (!in_flight.empty()) {
+    collect_oldest();
+  }
+  return responses;
+}
 }  // namespace spot_ros2
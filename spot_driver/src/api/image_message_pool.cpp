@@ -0,0 +1,55 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/api/image_message_pool.hpp>
+
+#include <utility>
+
+namespace {
+// Number of messages kept for each image source. One message per source is enough for a single conversion at a time,
+// and the second covers a conversion that overlaps with the previous publish.
+constexpr std::size_t kMaxPooledMessagesPerSource{2};
+
+template <typename MessageT>
+MessageT takeMessage(std::vector<MessageT>& messages) {
+  if (messages.empty()) {
+    return MessageT{};
+  }
+  auto message = std::move(messages.back());
+  messages.pop_back();
+  return message;
+}
+
+template <typename MessageT>
+void keepMessage(std::vector<MessageT>& messages, MessageT&& message) {
+  // A message whose data was moved out has no buffer worth keeping.
+  if (message.data.capacity() == 0 || messages.size() >= kMaxPooledMessagesPerSource) {
+    return;
+  }
+  messages.push_back(std::move(message));
+}
+}  // namespace
+
+namespace spot_ros2 {
+
+sensor_msgs::msg::Image ImageMessagePool::acquireImage(const ImageSource& image_source) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return takeMessage(images_[toImageSourceIndex(image_source)]);
+}
+
+sensor_msgs::msg::CompressedImage ImageMessagePool::acquireCompressedImage(const ImageSource& image_source) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return takeMessage(compressed_images_[toImageSourceIndex(image_source)]);
+}
+
+void ImageMessagePool::releaseImage(const ImageSource& image_source, sensor_msgs::msg::Image&& image) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  keepMessage(images_[toImageSourceIndex(image_source)], std::move(image));
+}
+
+void ImageMessagePool::releaseCompressedImage(const ImageSource& image_source,
+                                              sensor_msgs::msg::CompressedImage&& compressed_image) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  keepMessage(compressed_images_[toImageSourceIndex(image_source)], std::move(compressed_image));
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,108 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/api/link_monitor.hpp>
+
+#include <algorithm>
+#include <map>
+
+namespace spot_ros2 {
+
+LinkMonitorOptions makeLinkMonitorOptions(const ParameterInterfaceBase& parameters) {
+  LinkMonitorOptions options;
+  options.degraded_latency = std::chrono::duration<double>{parameters.getLinkDegradedLatency()};
+  options.degraded_failure_rate = std::clamp(parameters.getLinkDegradedFailureRate(), 0.0, 1.0);
+  return options;
+}
+
+std::shared_ptr<LinkMonitor> LinkMonitor::getForRobot(const std::string& robot_name) {
+  static std::mutex mutex;
+  static std::map<std::string, std::shared_ptr<LinkMonitor>> monitors;
+  std::lock_guard<std::mutex> lock{mutex};
+  auto& monitor = monitors[robot_name];
+  if (!monitor) {
+    monitor = std::make_shared<LinkMonitor>();
+  }
+  return monitor;
+}
+
+void LinkMonitor::configure(const LinkMonitorOptions& options) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  options_ = options;
+}
+
+void LinkMonitor::record(const std::chrono::steady_clock::duration latency, const bool success) {
+  const auto time = now();
+  std::lock_guard<std::mutex> lock{mutex_};
+  requests_.push_back(Request{time, latency, success});
+  update(time);
+}
+
+LinkMonitor::Statistics LinkMonitor::statistics() const {
+  const auto time = now();
+  std::lock_guard<std::mutex> lock{mutex_};
+  update(time);
+  return computeStatistics();
+}
+
+LinkQuality LinkMonitor::quality() const {
+  const auto time = now();
+  std::lock_guard<std::mutex> lock{mutex_};
+  update(time);
+  return quality_;
+}
+
+std::chrono::steady_clock::time_point LinkMonitor::now() const {
+  return std::chrono::steady_clock::now();
+}
+
+void LinkMonitor::update(const std::chrono::steady_clock::time_point now) const {
+  while (!requests_.empty() && now - requests_.front().time > options_.window) {
+    requests_.pop_front();
+  }
+
+  // Without enough recent requests there is nothing to judge the link on, so it keeps its quality. A link which is so
+  // bad that no request finishes still records the requests which time out.
+  const auto statistics = computeStatistics();
+  if (statistics.requests < options_.min_requests) {
+    return;
+  }
+  const auto degraded =
+      (statistics.failures > 0 && statistics.failureRate() >= options_.degraded_failure_rate) ||
+      (options_.degraded_latency.count() > 0.0 && statistics.mean_latency >= options_.degraded_latency);
+  if (degraded) {
+    quality_ = LinkQuality::kDegraded;
+    looks_good_ = false;
+    return;
+  }
+  if (quality_ == LinkQuality::kGood) {
+    return;
+  }
+  if (!looks_good_) {
+    looks_good_ = true;
+    good_since_ = now;
+  }
+  if (now - good_since_ >= options_.recovery_period) {
+    quality_ = LinkQuality::kGood;
+    looks_good_ = false;
+  }
+}
+
+LinkMonitor::Statistics LinkMonitor::computeStatistics() const {
+  Statistics statistics;
+  std::chrono::steady_clock::duration total_latency{0};
+  for (const auto& request : requests_) {
+    ++statistics.requests;
+    if (request.success) {
+      total_latency += request.latency;
+    } else {
+      ++statistics.failures;
+    }
+  }
+  const auto successes = statistics.requests - statistics.failures;
+  if (successes > 0) {
+    statistics.mean_latency = std::chrono::duration<double>{total_latency} / static_cast<double>(successes);
+  }
+  return statistics;
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,44 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/api/middleware_handle_base.hpp>
+
+#include <rclcpp/duration.hpp>
+
+#include <chrono>
+
+namespace spot_ros2 {
+
+rclcpp::QoS MiddlewareHandleBase::makePublisherQoS(size_t const publisherHistoryDepth,
+                                                   const PublisherQoSParameters& parameters) {
+  rclcpp::QoS qos{parameters.depth.value_or(publisherHistoryDepth)};
+  if (parameters.reliable) {
+    qos.reliable();
+  } else {
+    qos.best_effort();
+  }
+  if (parameters.transient_local) {
+    qos.transient_local();
+  } else {
+    qos.durability_volatile();
+  }
+  if (parameters.deadline.count() > 0.0) {
+    qos.deadline(rclcpp::Duration{std::chrono::duration_cast<std::chrono::nanoseconds>(parameters.deadline)});
+  }
+  if (parameters.lifespan.count() > 0.0) {
+    qos.lifespan(rclcpp::Duration{std::chrono::duration_cast<std::chrono::nanoseconds>(parameters.lifespan)});
+  }
+  return qos;
+}
+
+rclcpp::QoS MiddlewareHandleBase::makePublisherQoS(const ParameterInterfaceBase& parameters,
+                                                   const LoggerInterfaceBase& logger, const std::string& category,
+                                                   size_t const publisherHistoryDepth) {
+  const auto qos_parameters = parameters.getPublisherQoS(category);
+  if (!qos_parameters) {
+    logger.logWarn(qos_parameters.error() + " Using the default QoS profile.");
+    return makePublisherQoS(publisherHistoryDepth);
+  }
+  return makePublisherQoS(publisherHistoryDepth, qos_parameters.value());
+}
+
+}  // namespace spot_ros2
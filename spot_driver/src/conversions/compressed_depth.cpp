@@ -0,0 +1,150 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/conversions/compressed_depth.hpp>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <sensor_msgs/image_encodings.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace spot_ros2 {
+namespace {
+
+// PNG compression level of the depth images. compressed_depth_image_transport defaults to 9, which takes several times
+// longer than the lowest level for a few percent smaller images.
+constexpr int kPngCompressionLevel{1};
+
+/**
+ * @brief Configuration header which compressed_depth_image_transport expects in front of the payload.
+ * @details The depth quantization parameters are only used for 32FC1 images, so they are zero for 16UC1 images.
+ */
+struct ConfigHeader {
+  std::int32_t format{0};
+  float depth_param[2]{0.0F, 0.0F};
+};
+static_assert(sizeof(ConfigHeader) == 12, "compressed_depth_image_transport expects a 12 byte header.");
+
+/**
+ * @brief Writes the RVL encoding of a depth image, from "Fast Lossless Depth Image Compression" by Andrew D. Wilson.
+ * @details Runs of zero and nonzero pixels alternate. The length of each run and the difference of every nonzero pixel
+ * to the previous one are written as variable-length integers of 3-bit nibbles, which are packed into 32-bit words from
+ * the most significant nibble down.
+ */
+class RvlEncoder {
+ public:
+  explicit RvlEncoder(std::vector<unsigned char>& output) : output_{output} {}
+
+  void encode(const std::uint16_t* input, const std::size_t num_pixels) {
+    const auto* const end = input + num_pixels;
+    std::uint16_t previous = 0;
+    while (input != end) {
+      std::uint32_t zeros = 0;
+      for (; input != end && *input == 0; ++input) {
+        ++zeros;
+      }
+      encodeVle(zeros);
+      std::uint32_t nonzeros = 0;
+      for (const auto* pixel = input; pixel != end && *pixel != 0; ++pixel) {
+        ++nonzeros;
+      }
+      encodeVle(nonzeros);
+      for (std::uint32_t i = 0; i < nonzeros; ++i, ++input) {
+        const auto delta = static_cast<std::int32_t>(*input) - static_cast<std::int32_t>(previous);
+        // Zigzag-encode the difference, so that small negative differences are also short.
+        encodeVle((static_cast<std::uint32_t>(delta) << 1) ^ static_cast<std::uint32_t>(delta >> 31));
+        previous = *input;
+      }
+    }
+    if (nibbles_written_ > 0) {
+      writeWord(word_ << (4 * (8 - nibbles_written_)));
+    }
+  }
+
+ private:
+  void encodeVle(std::uint32_t value) {
+    do {
+      auto nibble = value & 0x7U;
+      value >>= 3;
+      if (value != 0) {
+        nibble |= 0x8U;
+      }
+      word_ = (word_ << 4) | nibble;
+      if (++nibbles_written_ == 8) {
+        writeWord(word_);
+        nibbles_written_ = 0;
+        word_ = 0;
+      }
+    } while (value != 0);
+  }
+
+  void writeWord(const std::uint32_t word) {
+    const auto offset = output_.size();
+    output_.resize(offset + sizeof(word));
+    std::memcpy(output_.data() + offset, &word, sizeof(word));
+  }
+
+  std::vector<unsigned char>& output_;
+  std::uint32_t word_{0};
+  int nibbles_written_{0};
+};
+
+}  // namespace
+
+tl::expected<CompressedDepthFormat, std::string> toCompressedDepthFormat(const std::string& name) {
+  if (name == "png") {
+    return CompressedDepthFormat::PNG;
+  } else if (name == "rvl") {
+    return CompressedDepthFormat::RVL;
+  }
+  return tl::make_unexpected("Unknown compressed depth format '" + name + "'. Expected 'png' or 'rvl'.");
+}
+
+tl::expected<void, std::string> compressDepthImage(const sensor_msgs::msg::Image& image,
+                                                   const CompressedDepthFormat format,
+                                                   sensor_msgs::msg::CompressedImage& compressed) {
+  if (image.encoding != sensor_msgs::image_encodings::TYPE_16UC1 &&
+      image.encoding != sensor_msgs::image_encodings::MONO16) {
+    return tl::make_unexpected("Cannot compress depth images with the encoding " + image.encoding + ".");
+  }
+  const auto row_size = static_cast<std::size_t>(image.width) * sizeof(std::uint16_t);
+  if (image.step < row_size || image.data.size() < static_cast<std::size_t>(image.step) * image.height) {
+    return tl::make_unexpected("The depth image has less data than its size and step require.");
+  }
+
+  compressed.header = image.header;
+  compressed.data.resize(sizeof(ConfigHeader));
+  const ConfigHeader config;
+  std::memcpy(compressed.data.data(), &config, sizeof(config));
+
+  // The image is only read, so it is wrapped without copying it.
+  const cv::Mat depth{static_cast<int>(image.height), static_cast<int>(image.width), CV_16UC1,
+                      const_cast<unsigned char*>(image.data.data()), image.step};
+  if (format == CompressedDepthFormat::PNG) {
+    compressed.format = image.encoding + "; compressedDepth png";
+    std::vector<unsigned char> png;
+    if (!cv::imencode(".png", depth, png, {cv::IMWRITE_PNG_COMPRESSION, kPngCompressionLevel})) {
+      return tl::make_unexpected("Failed to encode the depth image as PNG.");
+    }
+    compressed.data.insert(compressed.data.end(), png.cbegin(), png.cend());
+    return {};
+  }
+
+  // RVL runs over the pixels in order, so rows with padding are copied into a continuous image first.
+  compressed.format = image.encoding + "; compressedDepth rvl";
+  const auto continuous = depth.isContinuous() ? depth : depth.clone();
+  const std::uint32_t size[2] = {image.width, image.height};
+  const auto offset = compressed.data.size();
+  compressed.data.resize(offset + sizeof(size));
+  std::memcpy(compressed.data.data() + offset, size, sizeof(size));
+  // In the worst case, every pixel takes six nibbles.
+  compressed.data.reserve(compressed.data.size() + continuous.total() * 3 + sizeof(std::uint32_t));
+  RvlEncoder{compressed.data}.encode(continuous.ptr<std::uint16_t>(), continuous.total());
+  return {};
+}
+
+}  // namespace spot_ros2
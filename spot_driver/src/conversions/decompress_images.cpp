@@ -2,19 +2,27 @@
 
 #include <bosdyn/api/directory.pb.h>
 #include <bosdyn/api/image.pb.h>
-#include <cv_bridge/cv_bridge.h>
 #include <google/protobuf/duration.pb.h>
-#include <opencv2/imgcodecs.hpp>
+#include <opencv2/core.hpp>
+#include <sensor_msgs/image_encodings.hpp>
 #include <sensor_msgs/msg/image.hpp>
 #include <spot_driver/api/default_time_sync_api.hpp>
 #include <spot_driver/api/spot_image_sources.hpp>
 #include <spot_driver/conversions/decompress_images.hpp>
 #include <spot_driver/conversions/geometry.hpp>
+#include <spot_driver/conversions/jpeg_decoder.hpp>
 #include <spot_driver/conversions/time.hpp>
 #include <spot_driver/types.hpp>
 #include <std_msgs/msg/header.hpp>
 #include <tl_expected/expected.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
 namespace spot_ros2 {
 
 tl::expected<int, std::string> getCvPixelFormat(const bosdyn::api::Image_PixelFormat& format) {
@@ -40,6 +48,48 @@ tl::expected<int, std::string> getCvPixelFormat(const bosdyn::api::Image_PixelFo
   }
 }
 
+tl::expected<void, std::string> decodeRunLengthEncoding(const std::string& data, const std::size_t bytes_per_pixel,
+                                                        std::vector<uint8_t>& output) {
+  if (bytes_per_pixel == 0) {
+    return tl::make_unexpected("Pixels must be at least one byte wide.");
+  }
+  const auto* input = reinterpret_cast<const uint8_t*>(data.data());
+  const auto input_size = data.size();
+  const auto record_size = 1 + bytes_per_pixel;
+  if (input_size % record_size != 0) {
+    return tl::make_unexpected("Data size is not a multiple of the run size.");
+  }
+
+  auto* out = output.data();
+  const auto* const out_end = output.data() + output.size();
+  for (std::size_t offset = 0; offset < input_size; offset += record_size) {
+    const std::size_t run_length = input[offset];
+    const auto* value = input + offset + 1;
+    if (static_cast<std::size_t>(out_end - out) < run_length * bytes_per_pixel) {
+      return tl::make_unexpected("Data decodes to more pixels than the image holds.");
+    }
+    // Use fills of the native pixel width for the common 8 and 16 bit formats, which compilers turn into vectorized
+    // stores. The output buffer comes from a std::vector, so it is suitably aligned for 16 bit writes.
+    if (bytes_per_pixel == 1) {
+      std::memset(out, *value, run_length);
+    } else if (bytes_per_pixel == 2) {
+      uint16_t pixel;
+      std::memcpy(&pixel, value, sizeof(pixel));
+      std::fill_n(reinterpret_cast<uint16_t*>(out), run_length, pixel);
+    } else {
+      for (std::size_t i = 0; i < run_length; ++i) {
+        std::memcpy(out + i * bytes_per_pixel, value, bytes_per_pixel);
+      }
+    }
+    out += run_length * bytes_per_pixel;
+  }
+
+  if (out != out_end) {
+    return tl::make_unexpected("Data decodes to fewer pixels than the image holds.");
+  }
+  return {};
+}
+
 std_msgs::msg::Header createImageHeader(const bosdyn::api::ImageCapture& image_capture, const std::string& robot_name,
                                         const google::protobuf::Duration& clock_skew) {
   std_msgs::msg::Header header;
@@ -49,49 +99,74 @@ std_msgs::msg::Header createImageHeader(const bosdyn::api::ImageCapture& image_c
   return header;
 }
 
-tl::expected<sensor_msgs::msg::Image, std::string> getDecompressImageMsg(const bosdyn::api::ImageCapture& image_capture,
-                                                                         const std::string& robot_name,
-                                                                         const google::protobuf::Duration& clock_skew) {
+tl::expected<void, std::string> getDecompressImageMsg(const bosdyn::api::ImageCapture& image_capture,
+                                                      const std::string& robot_name,
+                                                      const google::protobuf::Duration& clock_skew,
+                                                      sensor_msgs::msg::Image& image_msg,
+                                                      const JpegDecoderBackend jpeg_decoder,
+                                                      const JpegOutputEncoding color_encoding) {
+  return getDecompressImageMsg(image_capture, createImageHeader(image_capture, robot_name, clock_skew), image_msg,
+                               jpeg_decoder, color_encoding);
+}
+
+tl::expected<void, std::string> getDecompressImageMsg(const bosdyn::api::ImageCapture& image_capture,
+                                                      const std_msgs::msg::Header& header,
+                                                      sensor_msgs::msg::Image& image_msg,
+                                                      const JpegDecoderBackend jpeg_decoder,
+                                                      const JpegOutputEncoding color_encoding) {
   const auto& image = image_capture.image();
-  auto data = image.data();
+  const auto& data = image.data();
 
-  const auto header = createImageHeader(image_capture, robot_name, clock_skew);
   const auto pixel_format_cv = getCvPixelFormat(image.pixel_format());
   if (!pixel_format_cv) {
     return tl::make_unexpected("Failed to determine pixel format: " + pixel_format_cv.error());
   }
 
+  image_msg.header = header;
+  image_msg.is_bigendian = false;
+
   if (image.format() == bosdyn::api::Image_Format_FORMAT_JPEG) {
-    // When the image is JPEG-compressed, it is represented as a 1 x (width * height) row of bytes.
-    // First we create a cv::Mat which contains the compressed image data...
-    const cv::Mat img_compressed{1, image.rows() * image.cols(), CV_8UC1, &data.front()};
-    // Then we decode it to extract the raw image into a new cv::Mat.
-    if (image.pixel_format() == bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_GREYSCALE_U8) {
-      const cv::Mat img_grey = cv::imdecode(img_compressed, cv::IMREAD_GRAYSCALE);
-      if (!img_grey.data) {
-        return tl::make_unexpected("Failed to decode JPEG-compressed image.");
-      }
-      const auto image = cv_bridge::CvImage{header, "mono8", img_grey}.toImageMsg();
-      return *image;
-    } else {
-      const cv::Mat img_bgr = cv::imdecode(img_compressed, cv::IMREAD_COLOR);
-      if (!img_bgr.data) {
-        return tl::make_unexpected("Failed to decode JPEG-compressed image.");
-      }
-      const auto image = cv_bridge::CvImage{header, "bgr8", img_bgr}.toImageMsg();
-      return *image;
-    }
+    const bool is_grey = image.pixel_format() == bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_GREYSCALE_U8;
+    return decodeJpeg(std::string_view{data}, is_grey ? JpegOutputEncoding::MONO8 : color_encoding, 1, jpeg_decoder,
+                      image_msg);
   } else if (image.format() == bosdyn::api::Image_Format_FORMAT_RAW) {
-    const cv::Mat img = cv::Mat(image.rows(), image.cols(), pixel_format_cv.value(), &data.front());
-    if (!img.data) {
+    const auto step = static_cast<std::size_t>(image.cols()) * CV_ELEM_SIZE(pixel_format_cv.value());
+    const auto expected_size = step * image.rows();
+    if (data.empty() || data.size() < expected_size) {
       return tl::make_unexpected("Failed to decode raw-formatted image.");
     }
-    const auto image = cv_bridge::CvImage{header, sensor_msgs::image_encodings::TYPE_16UC1, img}.toImageMsg();
-    return *image;
+    // Raw images are already laid out row by row, so they can be copied straight into the message.
+    image_msg.height = image.rows();
+    image_msg.width = image.cols();
+    image_msg.step = static_cast<sensor_msgs::msg::Image::_step_type>(step);
+    image_msg.encoding = sensor_msgs::image_encodings::TYPE_16UC1;
+    image_msg.data.assign(data.cbegin(), data.cbegin() + expected_size);
+    return {};
   } else if (image.format() == bosdyn::api::Image_Format_FORMAT_RLE) {
-    return tl::make_unexpected("Conversion from FORMAT_RLE is not yet implemented.");
+    const auto bytes_per_pixel = static_cast<std::size_t>(CV_ELEM_SIZE(pixel_format_cv.value()));
+    const auto step = static_cast<std::size_t>(image.cols()) * bytes_per_pixel;
+    // Decode the runs directly into the data buffer of the output message.
+    image_msg.data.resize(step * image.rows());
+    if (const auto result = decodeRunLengthEncoding(data, bytes_per_pixel, image_msg.data); !result) {
+      return tl::make_unexpected("Failed to decode RLE-formatted image: " + result.error());
+    }
+    image_msg.height = image.rows();
+    image_msg.width = image.cols();
+    image_msg.step = static_cast<sensor_msgs::msg::Image::_step_type>(step);
+    image_msg.encoding = sensor_msgs::image_encodings::TYPE_16UC1;
+    return {};
   } else {
     return tl::make_unexpected("Unknown image format.");
   }
 }
+
+tl::expected<sensor_msgs::msg::Image, std::string> getDecompressImageMsg(const bosdyn::api::ImageCapture& image_capture,
+                                                                         const std::string& robot_name,
+                                                                         const google::protobuf::Duration& clock_skew) {
+  sensor_msgs::msg::Image image_msg;
+  if (const auto result = getDecompressImageMsg(image_capture, robot_name, clock_skew, image_msg); !result) {
+    return tl::make_unexpected(result.error());
+  }
+  return image_msg;
+}
 }  // namespace spot_ros2
@@ -0,0 +1,165 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/conversions/depth_filter.hpp>
+
+#include <sensor_msgs/image_encodings.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+/** @brief Depth of pixels without a valid depth. */
+constexpr std::uint16_t kInvalidDepth = 0;
+
+/**
+ * @brief Value of invalid pixels while the image is decimated. Valid depths are shifted down by one, so that invalid
+ * pixels become the largest value and never win the minimum of a block.
+ */
+constexpr std::uint16_t kShiftedInvalidDepth = std::numeric_limits<std::uint16_t>::max();
+
+/** @brief Convert a distance in meters to depth image units, clamped to the range of the depth image. */
+std::uint16_t toDepthUnits(const double meters, const double depth_scale) {
+  constexpr auto kMaxDepth = static_cast<double>(std::numeric_limits<std::uint16_t>::max());
+  return static_cast<std::uint16_t>(std::clamp(std::round(meters * depth_scale), 0.0, kMaxDepth));
+}
+
+/**
+ * @brief Get the lower median of the valid pixels in the 3x3 neighborhood of a pixel. The lower median prefers the
+ * nearer of the two middle depths, which errs on the side of obstacles.
+ *
+ * @param image Depth image, stored without padding.
+ * @param width Width of the depth image.
+ * @param height Height of the depth image.
+ * @param x Column of the pixel.
+ * @param y Row of the pixel.
+ * @return The median depth, or kInvalidDepth if no pixel of the neighborhood is valid.
+ */
+std::uint16_t getMedianOfValidNeighbors(const std::uint16_t* image, const std::size_t width, const std::size_t height,
+                                        const std::size_t x, const std::size_t y) {
+  std::array<std::uint16_t, 9> depths;
+  std::size_t num_depths = 0;
+  for (auto row = y > 0 ? y - 1 : y; row <= std::min(y + 1, height - 1); ++row) {
+    for (auto col = x > 0 ? x - 1 : x; col <= std::min(x + 1, width - 1); ++col) {
+      const auto depth = image[row * width + col];
+      if (depth != kInvalidDepth) {
+        depths[num_depths++] = depth;
+      }
+    }
+  }
+  if (num_depths == 0) {
+    return kInvalidDepth;
+  }
+  const auto median = depths.begin() + (num_depths - 1) / 2;
+  std::nth_element(depths.begin(), median, depths.begin() + num_depths);
+  return *median;
+}
+}  // namespace
+
+namespace spot_ros2 {
+
+tl::expected<void, std::string> filterDepthImage(const sensor_msgs::msg::Image& depth_image,
+                                                 const sensor_msgs::msg::CameraInfo& info, const double depth_scale,
+                                                 const DepthFilterOptions& options,
+                                                 sensor_msgs::msg::Image& filtered_image,
+                                                 sensor_msgs::msg::CameraInfo& filtered_info) {
+  namespace enc = sensor_msgs::image_encodings;
+  if (depth_image.encoding != enc::TYPE_16UC1 && depth_image.encoding != enc::MONO16) {
+    return tl::make_unexpected("Unsupported depth image encoding for filtering: " + depth_image.encoding);
+  }
+  if (depth_image.step < depth_image.width * sizeof(std::uint16_t) ||
+      depth_image.data.size() < static_cast<std::size_t>(depth_image.step) * depth_image.height) {
+    return tl::make_unexpected("The depth image data is smaller than its dimensions.");
+  }
+  if (depth_scale <= 0.0) {
+    return tl::make_unexpected("The depth scale must be positive.");
+  }
+  if (options.decimation == 0) {
+    return tl::make_unexpected("The depth filter decimation must be at least 1.");
+  }
+  const auto factor = static_cast<std::size_t>(options.decimation);
+  const auto width = depth_image.width / factor;
+  const auto height = depth_image.height / factor;
+  if (width == 0 || height == 0) {
+    return tl::make_unexpected("The " + std::to_string(depth_image.width) + "x" + std::to_string(depth_image.height) +
+                               " depth image is smaller than the depth filter decimation.");
+  }
+
+  // The range is applied in depth image units, in which 0 is always invalid.
+  const auto min_depth = std::max<std::uint16_t>(toDepthUnits(options.min_range, depth_scale), 1);
+  const auto max_depth = options.max_range > 0.0 ? toDepthUnits(options.max_range, depth_scale)
+                                                 : std::numeric_limits<std::uint16_t>::max();
+
+  filtered_image.header = depth_image.header;
+  filtered_image.encoding = depth_image.encoding;
+  filtered_image.is_bigendian = false;
+  filtered_image.height = static_cast<std::uint32_t>(height);
+  filtered_image.width = static_cast<std::uint32_t>(width);
+  filtered_image.step = static_cast<std::uint32_t>(width * sizeof(std::uint16_t));
+  filtered_image.data.resize(width * height * sizeof(std::uint16_t));
+  auto* const output = reinterpret_cast<std::uint16_t*>(filtered_image.data.data());
+
+  // Take the minimum over the rows of every block column by column first, which reads the rows in order, and then
+  // over the columns of every block.
+  const auto used_cols = width * factor;
+  thread_local std::vector<std::uint16_t> column_min;
+  column_min.resize(used_cols);
+  for (std::size_t y = 0; y < height; ++y) {
+    std::fill(column_min.begin(), column_min.end(), kShiftedInvalidDepth);
+    for (std::size_t block_row = 0; block_row < factor; ++block_row) {
+      const auto* const row =
+          reinterpret_cast<const std::uint16_t*>(depth_image.data.data() + (y * factor + block_row) * depth_image.step);
+      for (std::size_t col = 0; col < used_cols; ++col) {
+        const std::uint16_t depth = row[col];
+        const auto shifted = depth >= min_depth && depth <= max_depth ? static_cast<std::uint16_t>(depth - 1)
+                                                                      : kShiftedInvalidDepth;
+        column_min[col] = std::min(column_min[col], shifted);
+      }
+    }
+    auto* const output_row = output + y * width;
+    for (std::size_t x = 0; x < width; ++x) {
+      auto block_min = kShiftedInvalidDepth;
+      for (std::size_t block_col = 0; block_col < factor; ++block_col) {
+        block_min = std::min(block_min, column_min[x * factor + block_col]);
+      }
+      // Undo the shift, which wraps blocks without any valid depth around to kInvalidDepth.
+      output_row[x] = static_cast<std::uint16_t>(block_min + 1);
+    }
+  }
+
+  if (options.fill_holes) {
+    // Holes are filled from the decimated image before any hole was filled, so that the result does not depend on the
+    // order of the pixels.
+    thread_local std::vector<std::uint16_t> unfilled;
+    unfilled.assign(output, output + width * height);
+    for (std::size_t y = 0; y < height; ++y) {
+      for (std::size_t x = 0; x < width; ++x) {
+        if (unfilled[y * width + x] == kInvalidDepth) {
+          output[y * width + x] = getMedianOfValidNeighbors(unfilled.data(), width, height, x, y);
+        }
+      }
+    }
+  }
+
+  // Map the intrinsics into the filtered image. Pixel centers are at half-pixel offsets, so the principal point is
+  // shifted before and after scaling.
+  const auto scale = 1.0 / static_cast<double>(factor);
+  filtered_info = info;
+  filtered_info.width = filtered_image.width;
+  filtered_info.height = filtered_image.height;
+  filtered_info.k[0] = info.k[0] * scale;
+  filtered_info.k[2] = (info.k[2] + 0.5) * scale - 0.5;
+  filtered_info.k[4] = info.k[4] * scale;
+  filtered_info.k[5] = (info.k[5] + 0.5) * scale - 0.5;
+  filtered_info.p[0] = info.p[0] * scale;
+  filtered_info.p[2] = (info.p[2] + 0.5) * scale - 0.5;
+  filtered_info.p[5] = info.p[5] * scale;
+  filtered_info.p[6] = (info.p[6] + 0.5) * scale - 0.5;
+  return {};
+}
+
+}  // namespace spot_ros2
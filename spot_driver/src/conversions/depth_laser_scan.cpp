@@ -0,0 +1,115 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/conversions/depth_laser_scan.hpp>
+
+#include <eigen3/Eigen/Geometry>
+#include <sensor_msgs/image_encodings.hpp>
+#include <tf2_eigen/tf2_eigen.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace spot_ros2 {
+
+void resetLaserScan(const LaserScanOptions& options, const std::string& frame_id,
+                    const builtin_interfaces::msg::Time& stamp, sensor_msgs::msg::LaserScan& scan) {
+  const auto num_beams = static_cast<std::size_t>(std::max(std::lround(2.0 * M_PI / options.angle_increment), 1L));
+  scan.header.frame_id = frame_id;
+  scan.header.stamp = stamp;
+  scan.angle_increment = static_cast<float>(2.0 * M_PI / static_cast<double>(num_beams));
+  scan.angle_min = static_cast<float>(-M_PI);
+  scan.angle_max = scan.angle_min + scan.angle_increment * static_cast<float>(num_beams - 1);
+  // The beams are not measured one after the other, so there is no time between them.
+  scan.time_increment = 0.0F;
+  scan.scan_time = 0.0F;
+  scan.range_min = static_cast<float>(options.range_min);
+  scan.range_max = static_cast<float>(options.range_max);
+  scan.ranges.assign(num_beams, std::numeric_limits<float>::infinity());
+  scan.intensities.clear();
+}
+
+tl::expected<void, std::string> addDepthImageToLaserScan(const sensor_msgs::msg::Image& depth_image,
+                                                         const DepthRayTable& rays, const double depth_scale,
+                                                         const geometry_msgs::msg::Transform& scan_tform_camera,
+                                                         const LaserScanOptions& options,
+                                                         sensor_msgs::msg::LaserScan& scan) {
+  namespace enc = sensor_msgs::image_encodings;
+  if (depth_image.encoding != enc::TYPE_16UC1 && depth_image.encoding != enc::MONO16) {
+    return tl::make_unexpected("Unsupported depth image encoding for laser scans: " + depth_image.encoding);
+  }
+  const auto width = static_cast<std::size_t>(depth_image.width);
+  const auto height = static_cast<std::size_t>(depth_image.height);
+  if (depth_image.step < width * sizeof(std::uint16_t) || depth_image.data.size() < depth_image.step * height) {
+    return tl::make_unexpected("The depth image data is smaller than its dimensions.");
+  }
+  if (rays.width() != depth_image.width || rays.height() != depth_image.height) {
+    return tl::make_unexpected("The ray table does not match the resolution of the depth image.");
+  }
+  if (depth_scale <= 0.0) {
+    return tl::make_unexpected("The depth scale must be positive.");
+  }
+  if (scan.ranges.empty()) {
+    return tl::make_unexpected("The laser scan has no beams. It must be reset before depth images are added.");
+  }
+
+  // The points are transformed in single precision, which is plenty for the few meters that the cameras see.
+  const Eigen::Isometry3f transform = tf2::transformToEigen(scan_tform_camera).cast<float>();
+  const Eigen::Matrix3f rotation = transform.linear();
+  const Eigen::Vector3f translation = transform.translation();
+  const auto meters_per_unit = static_cast<float>(1.0 / depth_scale);
+  const auto min_height = static_cast<float>(options.min_height);
+  const auto max_height = static_cast<float>(options.max_height);
+  const auto range_min_squared = static_cast<float>(options.range_min * options.range_min);
+  const auto range_max_squared = static_cast<float>(options.range_max * options.range_max);
+  const auto num_beams = static_cast<std::int64_t>(scan.ranges.size());
+  const auto beams_per_radian = 1.0F / scan.angle_increment;
+
+  const auto& ray_x = rays.x();
+  const auto& ray_y = rays.y();
+  std::uint16_t depth = 0;
+  for (std::size_t row = 0; row < height; ++row) {
+    const auto* const row_data = depth_image.data.data() + row * depth_image.step;
+    for (std::size_t col = 0; col < width; ++col) {
+      std::memcpy(&depth, row_data + col * sizeof(depth), sizeof(depth));
+      if (depth == 0) {
+        continue;
+      }
+      const auto index = row * width + col;
+      const auto z = static_cast<float>(depth) * meters_per_unit;
+      const Eigen::Vector3f point = rotation * Eigen::Vector3f{ray_x[index] * z, ray_y[index] * z, z} + translation;
+      if (point.z() < min_height || point.z() > max_height) {
+        continue;
+      }
+      const auto range_squared = point.x() * point.x() + point.y() * point.y();
+      if (range_squared < range_min_squared || range_squared > range_max_squared) {
+        continue;
+      }
+      auto beam = std::lround((std::atan2(point.y(), point.x()) - scan.angle_min) * beams_per_radian);
+      // The beams wrap around at -pi, so the last half beam belongs to the first beam.
+      if (beam >= num_beams) {
+        beam -= num_beams;
+      }
+      auto& range = scan.ranges[static_cast<std::size_t>(std::max(beam, 0L))];
+      range = std::min(range, std::sqrt(range_squared));
+    }
+  }
+  return {};
+}
+
+tl::expected<void, std::string> mergeLaserScans(const sensor_msgs::msg::LaserScan& scan,
+                                                sensor_msgs::msg::LaserScan& merged) {
+  if (scan.ranges.size() != merged.ranges.size()) {
+    return tl::make_unexpected("Cannot merge a laser scan with " + std::to_string(scan.ranges.size()) +
+                               " beams into one with " + std::to_string(merged.ranges.size()) + " beams.");
+  }
+  std::transform(scan.ranges.cbegin(), scan.ranges.cend(), merged.ranges.cbegin(), merged.ranges.begin(),
+                 [](const float a, const float b) { return std::min(a, b); });
+  return {};
+}
+
+}  // namespace spot_ros2
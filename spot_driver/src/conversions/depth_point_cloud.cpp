@@ -0,0 +1,251 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/conversions/depth_point_cloud.hpp>
+
+#include <sensor_msgs/image_encodings.hpp>
+#include <sensor_msgs/msg/point_field.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr std::uint32_t kPointStep = 3 * sizeof(float);
+// Colored points append the color as a float32 `rgb` field, which holds the packed 0x00RRGGBB value as used by PCL.
+constexpr std::uint32_t kColoredPointStep = 4 * sizeof(float);
+
+// Number of bits used for each axis of a voxel key, which covers +/- 2^20 voxels around the camera.
+constexpr int kVoxelKeyBits = 21;
+constexpr std::int64_t kVoxelKeyOffset = std::int64_t{1} << (kVoxelKeyBits - 1);
+constexpr std::uint64_t kVoxelKeyMask = (std::uint64_t{1} << kVoxelKeyBits) - 1;
+
+sensor_msgs::msg::PointField makeFloatField(const std::string& name, const std::uint32_t offset) {
+  sensor_msgs::msg::PointField field;
+  field.name = name;
+  field.offset = offset;
+  field.datatype = sensor_msgs::msg::PointField::FLOAT32;
+  field.count = 1;
+  return field;
+}
+
+/**
+ * @brief Pack the voxel coordinates of a point into a single key.
+ *
+ * @param point Pointer to the x, y and z coordinates of the point.
+ * @param inverse_voxel_size Inverse of the voxel edge length.
+ * @return The voxel key.
+ */
+std::uint64_t toVoxelKey(const float* point, const float inverse_voxel_size) {
+  std::uint64_t key = 0;
+  for (int axis = 0; axis < 3; ++axis) {
+    const auto index = static_cast<std::int64_t>(std::floor(point[axis] * inverse_voxel_size)) + kVoxelKeyOffset;
+    key = (key << kVoxelKeyBits) | (static_cast<std::uint64_t>(index) & kVoxelKeyMask);
+  }
+  return key;
+}
+
+/**
+ * @brief Check that a depth image can be reprojected along the rays of a ray table.
+ *
+ * @return Nothing if the depth image is valid, or an error message if it is not.
+ */
+tl::expected<void, std::string> validateDepthImage(const sensor_msgs::msg::Image& depth_image,
+                                                   const spot_ros2::DepthRayTable& rays, const double depth_scale) {
+  namespace enc = sensor_msgs::image_encodings;
+  if (depth_image.encoding != enc::TYPE_16UC1 && depth_image.encoding != enc::MONO16) {
+    return tl::make_unexpected("Unsupported depth image encoding for point clouds: " + depth_image.encoding);
+  }
+  const auto width = static_cast<std::size_t>(depth_image.width);
+  const auto height = static_cast<std::size_t>(depth_image.height);
+  if (depth_image.step < width * sizeof(std::uint16_t) || depth_image.data.size() < depth_image.step * height) {
+    return tl::make_unexpected("The depth image data is smaller than its dimensions.");
+  }
+  if (rays.width() != depth_image.width || rays.height() != depth_image.height) {
+    return tl::make_unexpected("The ray table does not match the resolution of the depth image.");
+  }
+  if (depth_scale <= 0.0) {
+    return tl::make_unexpected("The depth scale must be positive.");
+  }
+  return {};
+}
+
+/**
+ * @brief Keep only the first point of every voxel, compacting the points at the front of the buffer in place.
+ *
+ * @param points Buffer of points, each of which starts with its x, y and z coordinates.
+ * @param num_points Number of points in the buffer.
+ * @param point_step Size of each point, in bytes.
+ * @param voxel_size Edge length of the voxels.
+ * @return The number of points that were kept.
+ */
+std::size_t decimateVoxels(std::uint8_t* points, const std::size_t num_points, const std::size_t point_step,
+                           const double voxel_size) {
+  const auto inverse_voxel_size = static_cast<float>(1.0 / voxel_size);
+  std::unordered_set<std::uint64_t> occupied_voxels;
+  occupied_voxels.reserve(num_points);
+  std::size_t kept = 0;
+  float xyz[3];
+  for (std::size_t index = 0; index < num_points; ++index) {
+    const auto* point = points + point_step * index;
+    std::memcpy(xyz, point, sizeof(xyz));
+    if (occupied_voxels.insert(toVoxelKey(xyz, inverse_voxel_size)).second) {
+      std::memmove(points + point_step * kept, point, point_step);
+      ++kept;
+    }
+  }
+  return kept;
+}
+
+/**
+ * @brief Set the layout of an unorganized point cloud, and size its buffer to hold a point for every pixel.
+ */
+void initializeCloud(const std_msgs::msg::Header& header, std::vector<sensor_msgs::msg::PointField> fields,
+                     const std::uint32_t point_step, const std::size_t num_pixels,
+                     sensor_msgs::msg::PointCloud2& cloud) {
+  cloud.header = header;
+  cloud.height = 1;
+  cloud.fields = std::move(fields);
+  cloud.is_bigendian = false;
+  cloud.point_step = point_step;
+  cloud.is_dense = true;
+  // Size the buffer for every pixel and shrink it afterwards, so that it is only allocated once.
+  cloud.data.resize(num_pixels * point_step);
+}
+
+/** @brief Decimate the points of a cloud if requested, and shrink its buffer to the points that were kept. */
+void finalizeCloud(std::size_t num_points, const spot_ros2::PointCloudOptions& options,
+                   sensor_msgs::msg::PointCloud2& cloud) {
+  if (options.voxel_size > 0.0 && num_points > 0) {
+    num_points = decimateVoxels(cloud.data.data(), num_points, cloud.point_step, options.voxel_size);
+  }
+  cloud.width = static_cast<std::uint32_t>(num_points);
+  cloud.row_step = cloud.width * cloud.point_step;
+  cloud.data.resize(num_points * cloud.point_step);
+}
+}  // namespace
+
+namespace spot_ros2 {
+
+tl::expected<void, std::string> createPointCloud(const sensor_msgs::msg::Image& depth_image,
+                                                 const sensor_msgs::msg::CameraInfo& info, const double depth_scale,
+                                                 const PointCloudOptions& options,
+                                                 sensor_msgs::msg::PointCloud2& cloud) {
+  if (info.k[0] <= 0.0 || info.k[4] <= 0.0) {
+    return tl::make_unexpected("The depth image has invalid focal lengths.");
+  }
+  return createPointCloud(depth_image, info, DepthRayTable{info}, depth_scale, options, cloud);
+}
+
+tl::expected<void, std::string> createPointCloud(const sensor_msgs::msg::Image& depth_image,
+                                                 const sensor_msgs::msg::CameraInfo& info, const DepthRayTable& rays,
+                                                 const double depth_scale, const PointCloudOptions& options,
+                                                 sensor_msgs::msg::PointCloud2& cloud) {
+  if (const auto valid = validateDepthImage(depth_image, rays, depth_scale); !valid) {
+    return valid;
+  }
+  const auto width = static_cast<std::size_t>(depth_image.width);
+  const auto height = static_cast<std::size_t>(depth_image.height);
+  const auto meters_per_unit = static_cast<float>(1.0 / depth_scale);
+
+  initializeCloud(info.header,
+                  {makeFloatField("x", 0), makeFloatField("y", sizeof(float)), makeFloatField("z", 2 * sizeof(float))},
+                  kPointStep, width * height, cloud);
+  auto* out = reinterpret_cast<float*>(cloud.data.data());
+
+  std::vector<std::uint16_t> row(width);
+  const auto* ray_x = rays.x().data();
+  const auto* ray_y = rays.y().data();
+  for (std::size_t v = 0; v < height; ++v) {
+    // Copy the row out of the message so that the 16 bit reads are aligned regardless of the image step.
+    std::memcpy(row.data(), depth_image.data.data() + v * depth_image.step, width * sizeof(std::uint16_t));
+    const auto* row_x = ray_x + v * width;
+    const auto* row_y = ray_y + v * width;
+    for (std::size_t u = 0; u < width; ++u) {
+      // Always write the point and only advance past it if the depth is valid, which keeps the loop free of branches.
+      // The buffer holds a point for every pixel, so writing past the last valid point is safe.
+      const auto z = static_cast<float>(row[u]) * meters_per_unit;
+      out[0] = row_x[u] * z;
+      out[1] = row_y[u] * z;
+      out[2] = z;
+      out += (row[u] != 0) ? 3 : 0;
+    }
+  }
+  finalizeCloud(static_cast<std::size_t>(out - reinterpret_cast<float*>(cloud.data.data())) / 3, options, cloud);
+  return {};
+}
+
+tl::expected<void, std::string> createColoredPointCloud(const sensor_msgs::msg::Image& depth_image,
+                                                        const sensor_msgs::msg::Image& color_image,
+                                                        const sensor_msgs::msg::CameraInfo& info,
+                                                        const DepthRayTable& rays, const double depth_scale,
+                                                        const PointCloudOptions& options,
+                                                        sensor_msgs::msg::PointCloud2& cloud) {
+  if (const auto valid = validateDepthImage(depth_image, rays, depth_scale); !valid) {
+    return valid;
+  }
+  namespace enc = sensor_msgs::image_encodings;
+  // Offsets of the red, green and blue channels within a pixel. Greyscale images use their single channel for all.
+  std::size_t channels;
+  std::size_t red;
+  std::size_t blue;
+  if (color_image.encoding == enc::BGR8) {
+    channels = 3;
+    red = 2;
+    blue = 0;
+  } else if (color_image.encoding == enc::RGB8) {
+    channels = 3;
+    red = 0;
+    blue = 2;
+  } else if (color_image.encoding == enc::MONO8) {
+    channels = 1;
+    red = 0;
+    blue = 0;
+  } else {
+    return tl::make_unexpected("Unsupported color image encoding for point clouds: " + color_image.encoding);
+  }
+  const auto green = channels == 3 ? std::size_t{1} : std::size_t{0};
+  const auto width = static_cast<std::size_t>(depth_image.width);
+  const auto height = static_cast<std::size_t>(depth_image.height);
+  if (color_image.width != depth_image.width || color_image.height != depth_image.height) {
+    return tl::make_unexpected("The color image does not match the resolution of the depth image.");
+  }
+  if (color_image.step < width * channels || color_image.data.size() < color_image.step * height) {
+    return tl::make_unexpected("The color image data is smaller than its dimensions.");
+  }
+  const auto meters_per_unit = static_cast<float>(1.0 / depth_scale);
+
+  initializeCloud(info.header,
+                  {makeFloatField("x", 0), makeFloatField("y", sizeof(float)), makeFloatField("z", 2 * sizeof(float)),
+                   makeFloatField("rgb", 3 * sizeof(float))},
+                  kColoredPointStep, width * height, cloud);
+  auto* out = cloud.data.data();
+
+  std::vector<std::uint16_t> row(width);
+  const auto* ray_x = rays.x().data();
+  const auto* ray_y = rays.y().data();
+  for (std::size_t v = 0; v < height; ++v) {
+    std::memcpy(row.data(), depth_image.data.data() + v * depth_image.step, width * sizeof(std::uint16_t));
+    const auto* row_x = ray_x + v * width;
+    const auto* row_y = ray_y + v * width;
+    const auto* color_row = color_image.data.data() + v * color_image.step;
+    for (std::size_t u = 0; u < width; ++u) {
+      // Like the uncolored cloud, write every point and only advance past the valid ones.
+      const auto z = static_cast<float>(row[u]) * meters_per_unit;
+      const float xyz[3] = {row_x[u] * z, row_y[u] * z, z};
+      const auto* pixel = color_row + u * channels;
+      const std::uint32_t rgb = (std::uint32_t{pixel[red]} << 16) | (std::uint32_t{pixel[green]} << 8) | pixel[blue];
+      std::memcpy(out, xyz, sizeof(xyz));
+      std::memcpy(out + sizeof(xyz), &rgb, sizeof(rgb));
+      out += (row[u] != 0) ? kColoredPointStep : 0;
+    }
+  }
+  finalizeCloud(static_cast<std::size_t>(out - cloud.data.data()) / kColoredPointStep, options, cloud);
+  return {};
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,44 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/conversions/depth_ray_table.hpp>
+
+#include <cstddef>
+
+namespace spot_ros2 {
+
+DepthRayTable::DepthRayTable(const sensor_msgs::msg::CameraInfo& info) {
+  update(info);
+}
+
+bool DepthRayTable::matches(const sensor_msgs::msg::CameraInfo& info) const {
+  return !x_.empty() && info.width == width_ && info.height == height_ && info.k[0] == fx_ && info.k[4] == fy_ &&
+         info.k[2] == cx_ && info.k[5] == cy_;
+}
+
+bool DepthRayTable::update(const sensor_msgs::msg::CameraInfo& info) {
+  if (matches(info)) {
+    return false;
+  }
+
+  width_ = info.width;
+  height_ = info.height;
+  fx_ = info.k[0];
+  fy_ = info.k[4];
+  cx_ = info.k[2];
+  cy_ = info.k[5];
+
+  const auto width = static_cast<std::size_t>(width_);
+  const auto height = static_cast<std::size_t>(height_);
+  x_.resize(width * height);
+  y_.resize(width * height);
+  for (std::size_t v = 0; v < height; ++v) {
+    const auto y = static_cast<float>((static_cast<double>(v) - cy_) / fy_);
+    for (std::size_t u = 0; u < width; ++u) {
+      x_[v * width + u] = static_cast<float>((static_cast<double>(u) - cx_) / fx_);
+      y_[v * width + u] = y;
+    }
+  }
+  return true;
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,145 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/conversions/depth_reregistration.hpp>
+
+#include <opencv2/calib3d.hpp>
+#include <opencv2/core.hpp>
+#include <sensor_msgs/image_encodings.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace spot_ros2 {
+namespace {
+// Points farther than this many meters from the depth camera are dropped, like in the Python publisher this replaces.
+constexpr double kMaxDepthMeters{10.0};
+
+bool isValidCameraMatrix(const std::array<double, 9>& matrix) {
+  return matrix[0] > 0.0 && matrix[4] > 0.0;
+}
+}  // namespace
+
+tl::expected<DepthReregistration, std::string> DepthReregistration::create(
+    const DepthReregistrationCalibration& calibration, const double depth_scale) {
+  if (!isValidCameraMatrix(calibration.camera_matrix_depth) || !isValidCameraMatrix(calibration.camera_matrix_rgb)) {
+    return tl::make_unexpected("The focal lengths of both camera matrices must be positive.");
+  }
+  const auto& [depth_height, depth_width] = calibration.depth_image_dim;
+  const auto& [rgb_height, rgb_width] = calibration.rgb_image_dim;
+  if (depth_height == 0 || depth_width == 0 || rgb_height == 0 || rgb_width == 0) {
+    return tl::make_unexpected("The image dimensions of both cameras must be set.");
+  }
+  if (depth_scale <= 0.0) {
+    return tl::make_unexpected("The depth scale must be positive.");
+  }
+
+  DepthReregistration out;
+  out.depth_width_ = depth_width;
+  out.depth_height_ = depth_height;
+  out.rgb_width_ = rgb_width;
+  out.rgb_height_ = rgb_height;
+  const auto& rgb = calibration.camera_matrix_rgb;
+  out.fx_ = static_cast<float>(rgb[0]);
+  out.fy_ = static_cast<float>(rgb[4]);
+  out.cx_ = static_cast<float>(rgb[2]);
+  out.cy_ = static_cast<float>(rgb[5]);
+  for (std::size_t i = 0; i < 3; ++i) {
+    out.translation_[i] = static_cast<float>(calibration.depth_t_rgb_T[i] * depth_scale);
+  }
+  out.max_depth_ = static_cast<float>(kMaxDepthMeters * depth_scale);
+
+  // Normalized image coordinates of every depth pixel, which are the x and y components of its ray at z = 1.
+  const auto num_pixels = static_cast<std::size_t>(depth_width) * depth_height;
+  cv::Mat pixels{static_cast<int>(num_pixels), 1, CV_64FC2};
+  for (std::uint32_t v = 0; v < depth_height; ++v) {
+    for (std::uint32_t u = 0; u < depth_width; ++u) {
+      pixels.at<cv::Vec2d>(static_cast<int>(v * depth_width + u)) = {static_cast<double>(u), static_cast<double>(v)};
+    }
+  }
+  const cv::Mat camera_matrix_depth{3, 3, CV_64F, const_cast<double*>(calibration.camera_matrix_depth.data())};
+  cv::Mat dist_coeffs;
+  if (calibration.undistort) {
+    dist_coeffs = cv::Mat{calibration.dist_coeffs_depth, true};
+  }
+  cv::Mat normalized;
+  cv::undistortPoints(pixels, normalized, camera_matrix_depth, dist_coeffs);
+
+  // Rotate the rays into the RGB camera once, so that a pixel only needs its depth and the translation afterwards.
+  const auto& r = calibration.depth_t_rgb_R;
+  out.ray_x_.resize(num_pixels);
+  out.ray_y_.resize(num_pixels);
+  out.ray_z_.resize(num_pixels);
+  for (std::size_t i = 0; i < num_pixels; ++i) {
+    const auto& ray = normalized.at<cv::Vec2d>(static_cast<int>(i));
+    out.ray_x_[i] = static_cast<float>(r[0] * ray[0] + r[1] * ray[1] + r[2]);
+    out.ray_y_[i] = static_cast<float>(r[3] * ray[0] + r[4] * ray[1] + r[5]);
+    out.ray_z_[i] = static_cast<float>(r[6] * ray[0] + r[7] * ray[1] + r[8]);
+  }
+  return out;
+}
+
+tl::expected<void, std::string> DepthReregistration::reregister(const sensor_msgs::msg::Image& depth_image,
+                                                                sensor_msgs::msg::Image& registered) const {
+  namespace enc = sensor_msgs::image_encodings;
+  if (depth_image.encoding != enc::TYPE_16UC1 && depth_image.encoding != enc::MONO16) {
+    return tl::make_unexpected("Unsupported depth image encoding for re-registration: " + depth_image.encoding);
+  }
+  if (depth_image.width != depth_width_ || depth_image.height != depth_height_) {
+    return tl::make_unexpected("The depth image is " + std::to_string(depth_image.width) + "x" +
+                               std::to_string(depth_image.height) + ", but the calibration is for " +
+                               std::to_string(depth_width_) + "x" + std::to_string(depth_height_) + " images.");
+  }
+  const auto width = static_cast<std::size_t>(depth_width_);
+  if (depth_image.step < width * sizeof(std::uint16_t) || depth_image.data.size() < depth_image.step * depth_height_) {
+    return tl::make_unexpected("The depth image data is smaller than its dimensions.");
+  }
+
+  registered.header = depth_image.header;
+  registered.width = rgb_width_;
+  registered.height = rgb_height_;
+  registered.encoding = enc::TYPE_16UC1;
+  registered.is_bigendian = depth_image.is_bigendian;
+  registered.step = rgb_width_ * static_cast<std::uint32_t>(sizeof(std::uint16_t));
+  registered.data.assign(static_cast<std::size_t>(registered.step) * rgb_height_, 0);
+  auto* const output = reinterpret_cast<std::uint16_t*>(registered.data.data());
+
+  const auto max_x = static_cast<float>(rgb_width_) - 0.5F;
+  const auto max_y = static_cast<float>(rgb_height_) - 0.5F;
+  std::uint16_t depth = 0;
+  for (std::size_t row = 0; row < depth_height_; ++row) {
+    const auto* const row_data = depth_image.data.data() + row * depth_image.step;
+    for (std::size_t col = 0; col < width; ++col) {
+      std::memcpy(&depth, row_data + col * sizeof(depth), sizeof(depth));
+      if (depth == 0) {
+        continue;
+      }
+      const auto index = row * width + col;
+      const auto d = static_cast<float>(depth);
+      const auto z = ray_z_[index] * d + translation_[2];
+      if (d > max_depth_ || z <= 0.0F || z > static_cast<float>(std::numeric_limits<std::uint16_t>::max())) {
+        continue;
+      }
+      const auto inverse_z = 1.0F / z;
+      const auto x = fx_ * (ray_x_[index] * d + translation_[0]) * inverse_z + cx_;
+      const auto y = fy_ * (ray_y_[index] * d + translation_[1]) * inverse_z + cy_;
+      if (!(x > -0.5F && x < max_x && y > -0.5F && y < max_y)) {
+        continue;
+      }
+      const auto u = static_cast<std::size_t>(std::lround(x));
+      const auto v = static_cast<std::size_t>(std::lround(y));
+      auto& pixel = output[v * rgb_width_ + u];
+      const auto value = static_cast<std::uint16_t>(std::lround(z));
+      // Several depth pixels can land on the same RGB pixel, in which case the nearest one occludes the others.
+      if (pixel == 0 || value < pixel) {
+        pixel = value;
+      }
+    }
+  }
+  return {};
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,132 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/conversions/frame_tree_resolver.hpp>
+
+#include <bosdyn/api/geometry.pb.h>
+#include <bosdyn/math/proto_math.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+constexpr std::uint8_t kUnvisited = 0;
+constexpr std::uint8_t kVisiting = 1;
+constexpr std::uint8_t kVisited = 2;
+}  // namespace
+
+namespace spot_ros2 {
+
+bool FrameTreeResolver::compile(const ::bosdyn::api::FrameTreeSnapshot& snapshot, const std::string_view root_frame) {
+  frame_count_ = 0;
+  index_of_frame_.clear();
+  parents_.clear();
+  parent_tform_frames_.clear();
+  order_.clear();
+
+  // Every edge adds at most its child and its parent frame, and the names must not move once they are indexed.
+  const auto& edges = snapshot.child_to_parent_edge_map();
+  if (frame_names_.size() < 2 * edges.size()) {
+    frame_names_.resize(2 * edges.size());
+  }
+  for (const auto& [frame, edge] : edges) {
+    const auto index = addFrame(frame);
+    if (!edge.parent_frame_name().empty()) {
+      const auto parent = addFrame(edge.parent_frame_name());
+      parents_[static_cast<std::size_t>(index)] = parent;
+      parent_tform_frames_[static_cast<std::size_t>(index)] = &edge.parent_tform_child();
+    }
+  }
+  const auto root = index_of_frame_.find(root_frame);
+  if (root == index_of_frame_.end()) {
+    index_of_frame_.clear();
+    return false;
+  }
+  const auto root_index = static_cast<std::size_t>(root->second);
+
+  // Walk up from every frame which was not sorted yet, and sort the walked frames from the topmost one down.
+  const auto count = parents_.size();
+  visit_states_.assign(count, kUnvisited);
+  for (std::size_t start = 0; start < count; ++start) {
+    path_.clear();
+    auto frame = static_cast<std::int32_t>(start);
+    while (frame != -1 && visit_states_[static_cast<std::size_t>(frame)] == kUnvisited) {
+      visit_states_[static_cast<std::size_t>(frame)] = kVisiting;
+      path_.push_back(frame);
+      frame = parents_[static_cast<std::size_t>(frame)];
+    }
+    if (frame != -1 && visit_states_[static_cast<std::size_t>(frame)] == kVisiting) {
+      index_of_frame_.clear();
+      order_.clear();
+      return false;
+    }
+    for (auto it = path_.rbegin(); it != path_.rend(); ++it) {
+      visit_states_[static_cast<std::size_t>(*it)] = kVisited;
+      order_.push_back(*it);
+    }
+  }
+
+  // Compose the transforms from the root of every tree in one pass, since every parent is composed before its children.
+  tree_roots_.resize(count);
+  tree_root_tform_frames_.resize(count);
+  for (const auto frame : order_) {
+    const auto index = static_cast<std::size_t>(frame);
+    const auto parent = parents_[index];
+    if (parent == -1) {
+      tree_roots_[index] = frame;
+      tree_root_tform_frames_[index] =
+          ::bosdyn::api::CreateSE3Pose(::bosdyn::api::CreateQuaternion(1, 0, 0, 0), ::bosdyn::api::CreateVec3(0, 0, 0));
+    } else {
+      tree_roots_[index] = tree_roots_[static_cast<std::size_t>(parent)];
+      tree_root_tform_frames_[index] =
+          tree_root_tform_frames_[static_cast<std::size_t>(parent)] * *parent_tform_frames_[index];
+    }
+  }
+
+  // Frames in the tree of the root frame are resolved relative to it.
+  const auto root_tform_tree_root = ~tree_root_tform_frames_[root_index];
+  root_tform_frames_.resize(count);
+  resolved_.assign(count, false);
+  for (std::size_t index = 0; index < count; ++index) {
+    if (tree_roots_[index] == tree_roots_[root_index]) {
+      root_tform_frames_[index] = root_tform_tree_root * tree_root_tform_frames_[index];
+      resolved_[index] = true;
+    }
+  }
+  return true;
+}
+
+std::optional<::bosdyn::api::SE3Pose> FrameTreeResolver::rootTformFrame(const std::string_view frame) const {
+  const auto it = index_of_frame_.find(frame);
+  if (it == index_of_frame_.end() || !resolved_[static_cast<std::size_t>(it->second)]) {
+    return std::nullopt;
+  }
+  return root_tform_frames_[static_cast<std::size_t>(it->second)];
+}
+
+std::vector<std::string_view> FrameTreeResolver::sortedFrames() const {
+  std::vector<std::string_view> frames;
+  frames.reserve(order_.size());
+  for (const auto frame : order_) {
+    frames.emplace_back(frame_names_[static_cast<std::size_t>(frame)]);
+  }
+  return frames;
+}
+
+std::int32_t FrameTreeResolver::addFrame(const std::string& frame) {
+  if (const auto it = index_of_frame_.find(frame); it != index_of_frame_.end()) {
+    return it->second;
+  }
+  const auto index = static_cast<std::int32_t>(frame_count_);
+  auto& name = frame_names_[frame_count_++];
+  name = frame;
+  index_of_frame_.emplace(name, index);
+  parents_.push_back(-1);
+  parent_tform_frames_.push_back(nullptr);
+  return index;
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,103 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/conversions/image_preview.hpp>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <sensor_msgs/image_encodings.hpp>
+
+#include <algorithm>
+
+namespace {
+/**
+ * @brief Get the OpenCV matrix type which matches the encoding of an Image message.
+ *
+ * @param encoding Encoding of the Image message.
+ * @return The OpenCV matrix type, or an error message if the encoding is not supported.
+ */
+tl::expected<int, std::string> getCvType(const std::string& encoding) {
+  namespace enc = sensor_msgs::image_encodings;
+  // Only the luma plane of NV12 images, which comes first, is previewed.
+  if (encoding == enc::MONO8 || encoding == "nv12") {
+    return CV_8UC1;
+  }
+  if (encoding == enc::BGR8 || encoding == enc::RGB8) {
+    return CV_8UC3;
+  }
+  if (encoding == enc::MONO16 || encoding == enc::TYPE_16UC1) {
+    return CV_16UC1;
+  }
+  return tl::make_unexpected("Unsupported image encoding for previews: " + encoding);
+}
+}  // namespace
+
+namespace spot_ros2 {
+
+tl::expected<void, std::string> createImagePreview(const sensor_msgs::msg::Image& image,
+                                                   const sensor_msgs::msg::CameraInfo& info,
+                                                   const ImagePreviewOptions& options,
+                                                   sensor_msgs::msg::Image& preview,
+                                                   sensor_msgs::msg::CameraInfo& preview_info) {
+  const auto cv_type = getCvType(image.encoding);
+  if (!cv_type) {
+    return tl::make_unexpected(cv_type.error());
+  }
+  if (options.scale_divisor == 0) {
+    return tl::make_unexpected("The preview scale divisor must be at least 1.");
+  }
+
+  const auto crop = options.roi_width > 0 && options.roi_height > 0;
+  const auto roi_x = crop ? options.roi_x : 0;
+  const auto roi_y = crop ? options.roi_y : 0;
+  const auto roi_width = crop ? options.roi_width : image.width;
+  const auto roi_height = crop ? options.roi_height : image.height;
+  if (roi_x + roi_width > image.width || roi_y + roi_height > image.height) {
+    return tl::make_unexpected("The preview region of interest does not fit inside the " + std::to_string(image.width) +
+                               "x" + std::to_string(image.height) + " image.");
+  }
+
+  const auto width = std::max(roi_width / options.scale_divisor, 1U);
+  const auto height = std::max(roi_height / options.scale_divisor, 1U);
+
+  // Wrap the message buffers without copying them.
+  const cv::Mat source{static_cast<int>(image.height), static_cast<int>(image.width), cv_type.value(),
+                       const_cast<uint8_t*>(image.data.data()), image.step};
+  const auto source_roi = source(cv::Rect{static_cast<int>(roi_x), static_cast<int>(roi_y),
+                                          static_cast<int>(roi_width), static_cast<int>(roi_height)});
+
+  preview.header = image.header;
+  preview.encoding = cv_type.value() == CV_8UC1 ? sensor_msgs::image_encodings::MONO8 : image.encoding;
+  preview.is_bigendian = image.is_bigendian;
+  preview.height = height;
+  preview.width = width;
+  preview.step = width * static_cast<uint32_t>(source.elemSize());
+  preview.data.resize(static_cast<std::size_t>(preview.step) * height);
+  cv::Mat destination{static_cast<int>(height), static_cast<int>(width), cv_type.value(), preview.data.data(),
+                      preview.step};
+
+  if (width == roi_width && height == roi_height) {
+    source_roi.copyTo(destination);
+  } else {
+    const auto interpolation = cv_type.value() == CV_16UC1 ? cv::INTER_NEAREST : cv::INTER_AREA;
+    cv::resize(source_roi, destination, destination.size(), 0.0, 0.0, interpolation);
+  }
+
+  // Map the intrinsics into the preview. Pixel centers are at half-pixel offsets, so the principal point is shifted
+  // before and after scaling.
+  const auto scale_x = static_cast<double>(width) / roi_width;
+  const auto scale_y = static_cast<double>(height) / roi_height;
+  preview_info = info;
+  preview_info.width = width;
+  preview_info.height = height;
+  preview_info.k[0] = info.k[0] * scale_x;
+  preview_info.k[2] = (info.k[2] - roi_x + 0.5) * scale_x - 0.5;
+  preview_info.k[4] = info.k[4] * scale_y;
+  preview_info.k[5] = (info.k[5] - roi_y + 0.5) * scale_y - 0.5;
+  preview_info.p[0] = info.p[0] * scale_x;
+  preview_info.p[2] = (info.p[2] - roi_x + 0.5) * scale_x - 0.5;
+  preview_info.p[5] = info.p[5] * scale_y;
+  preview_info.p[6] = (info.p[6] - roi_y + 0.5) * scale_y - 0.5;
+  return {};
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,398 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/conversions/jpeg_decoder.hpp>
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <sensor_msgs/image_encodings.hpp>
+
+#ifdef SPOT_DRIVER_HAS_TURBOJPEG
+#include <turbojpeg.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace spot_ros2 {
+namespace {
+
+// sensor_msgs only names the NV21 layout, whose chroma samples are in the opposite order.
+constexpr auto kNv12Encoding = "nv12";
+
+/** @brief Parts of a JPEG start-of-frame header. */
+struct JpegFrameHeader {
+  int rows;
+  int cols;
+  int components;
+};
+
+/**
+ * @brief Read the dimensions and number of color components of a JPEG image from its start-of-frame marker.
+ *
+ * @param data JPEG-compressed image data.
+ * @return The frame header of the image, or nullopt if the data does not have a valid JPEG header.
+ */
+std::optional<JpegFrameHeader> readJpegFrameHeader(const std::string_view data) {
+  const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+  const auto size = data.size();
+  // Every JPEG image starts with the start-of-image marker 0xFFD8.
+  if (size < 4 || bytes[0] != 0xFF || bytes[1] != 0xD8) {
+    return std::nullopt;
+  }
+  std::size_t offset = 2;
+  while (offset + 4 <= size) {
+    if (bytes[offset] != 0xFF) {
+      return std::nullopt;
+    }
+    const auto marker = bytes[offset + 1];
+    const std::size_t segment_length = (bytes[offset + 2] << 8) | bytes[offset + 3];
+    // Start-of-frame markers are 0xC0 to 0xCF, except for 0xC4 (DHT), 0xC8 (JPG), and 0xCC (DAC).
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+      if (offset + 10 > size) {
+        return std::nullopt;
+      }
+      const int rows = (bytes[offset + 5] << 8) | bytes[offset + 6];
+      const int cols = (bytes[offset + 7] << 8) | bytes[offset + 8];
+      const int components = bytes[offset + 9];
+      if (rows == 0 || cols == 0 || components == 0) {
+        return std::nullopt;
+      }
+      return JpegFrameHeader{rows, cols, components};
+    }
+    offset += 2 + segment_length;
+  }
+  return std::nullopt;
+}
+
+/**
+ * @brief Get the flags of cv::imdecode that decode a JPEG image with the given color mode and DCT scaling.
+ *
+ * @param greyscale If true, decode into one channel. If false, decode into three channels.
+ * @param scale_denominator Factor to divide the resolution of the image by, which is one of 1, 2, 4 or 8.
+ * @return The cv::ImreadModes flags.
+ */
+int toImreadFlags(const bool greyscale, const int scale_denominator) {
+  switch (scale_denominator) {
+    case 2: {
+      return greyscale ? cv::IMREAD_REDUCED_GRAYSCALE_2 : cv::IMREAD_REDUCED_COLOR_2;
+    }
+    case 4: {
+      return greyscale ? cv::IMREAD_REDUCED_GRAYSCALE_4 : cv::IMREAD_REDUCED_COLOR_4;
+    }
+    case 8: {
+      return greyscale ? cv::IMREAD_REDUCED_GRAYSCALE_8 : cv::IMREAD_REDUCED_COLOR_8;
+    }
+    default: {
+      return greyscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR;
+    }
+  }
+}
+
+/**
+ * @brief Interleave the U and V planes of an image with chroma subsampled by 2 in both directions into the chroma plane
+ * of an NV12 image.
+ *
+ * @param u U plane of the image.
+ * @param v V plane of the image, with as many samples as the U plane.
+ * @param num_samples Number of samples in each of the U and V planes.
+ * @param uv Chroma plane of the NV12 image, which holds twice as many samples.
+ */
+void interleaveChromaPlanes(const unsigned char* u, const unsigned char* v, const std::size_t num_samples,
+                            unsigned char* uv) {
+  for (std::size_t index = 0; index < num_samples; ++index) {
+    uv[2 * index] = u[index];
+    uv[2 * index + 1] = v[index];
+  }
+}
+
+/** @brief Set the dimensions of an NV12 image message, whose step is that of its luma plane. */
+void setNv12Dimensions(const int width, const int height, sensor_msgs::msg::Image& image_msg) {
+  image_msg.height = height;
+  image_msg.width = width;
+  image_msg.step = width;
+}
+
+/**
+ * @brief Convert a decoded bgr8 image into an NV12 image message.
+ *
+ * @param bgr Decoded image.
+ * @param image_msg Image message to write the NV12 image into.
+ * @return Nothing if the conversion succeeded, or an error message if the image has an odd width or height.
+ */
+tl::expected<void, std::string> convertBgrToNv12(const cv::Mat& bgr, sensor_msgs::msg::Image& image_msg) {
+  if (bgr.cols % 2 != 0 || bgr.rows % 2 != 0) {
+    return tl::make_unexpected("Cannot decode a JPEG image of " + std::to_string(bgr.cols) + "x" +
+                               std::to_string(bgr.rows) + " pixels into nv12, which needs an even width and height.");
+  }
+  // OpenCV only converts into planar YUV, so the chroma planes are interleaved afterwards.
+  thread_local cv::Mat i420;
+  cv::cvtColor(bgr, i420, cv::COLOR_BGR2YUV_I420);
+  const auto luma_size = static_cast<std::size_t>(bgr.cols) * bgr.rows;
+  const auto chroma_size = luma_size / 4;
+  image_msg.data.resize(luma_size + 2 * chroma_size);
+  std::copy_n(i420.data, luma_size, image_msg.data.data());
+  interleaveChromaPlanes(i420.data + luma_size, i420.data + luma_size + chroma_size, chroma_size,
+                         image_msg.data.data() + luma_size);
+  setNv12Dimensions(bgr.cols, bgr.rows, image_msg);
+  return {};
+}
+
+tl::expected<void, std::string> decodeJpegOpenCv(const std::string_view data, const JpegOutputEncoding output_encoding,
+                                                 const int scale_denominator, sensor_msgs::msg::Image& image_msg) {
+  // cv::imdecode leaves the destination untouched if it cannot parse the header, so check the header here to be able
+  // to tell a failed decode apart from a successful one.
+  const auto header = readJpegFrameHeader(data);
+  if (!header.has_value()) {
+    return tl::make_unexpected("Failed to read the header of the JPEG-compressed image.");
+  }
+  // libjpeg rounds the dimensions of DCT-scaled images up
+  const int rows = (header->rows + scale_denominator - 1) / scale_denominator;
+  const int cols = (header->cols + scale_denominator - 1) / scale_denominator;
+
+  // Wrap the compressed data in a 1 x (number of bytes) cv::Mat without copying it.
+  const cv::Mat img_compressed{1, static_cast<int>(data.size()), CV_8UC1,
+                               const_cast<void*>(static_cast<const void*>(data.data()))};
+  const bool greyscale = output_encoding == JpegOutputEncoding::MONO8;
+
+  if (output_encoding == JpegOutputEncoding::NV12) {
+    // OpenCV cannot decode into YUV, so the image is decoded into a buffer of this thread and converted from there.
+    thread_local cv::Mat img_bgr;
+    img_bgr.create(rows, cols, CV_8UC3);
+    cv::imdecode(img_compressed, toImreadFlags(false, scale_denominator), &img_bgr);
+    if (!img_bgr.data) {
+      return tl::make_unexpected("Failed to decode JPEG-compressed image.");
+    }
+    return convertBgrToNv12(img_bgr, image_msg);
+  }
+
+  const int decoded_type = greyscale ? CV_8UC1 : CV_8UC3;
+  // cv::imdecode reuses the destination buffer since its size and type already match the decoded image.
+  image_msg.data.resize(static_cast<std::size_t>(rows) * cols * CV_ELEM_SIZE(decoded_type));
+  cv::Mat img_decoded{rows, cols, decoded_type, image_msg.data.data()};
+  cv::imdecode(img_compressed, toImreadFlags(greyscale, scale_denominator), &img_decoded);
+  if (!img_decoded.data) {
+    return tl::make_unexpected("Failed to decode JPEG-compressed image.");
+  }
+  if (img_decoded.data != image_msg.data.data()) {
+    // The decoded image did not fit in the preallocated buffer, so fall back to copying it.
+    const cv::Mat img_continuous = img_decoded.isContinuous() ? img_decoded : img_decoded.clone();
+    image_msg.data.assign(img_continuous.datastart, img_continuous.dataend);
+  }
+  image_msg.height = img_decoded.rows;
+  image_msg.width = img_decoded.cols;
+  image_msg.step = static_cast<sensor_msgs::msg::Image::_step_type>(img_decoded.cols * img_decoded.elemSize());
+  if (output_encoding == JpegOutputEncoding::RGB8) {
+    // cv::imdecode always decodes into BGR order, so the channels are swapped in place.
+    cv::Mat img_rgb{img_decoded.rows, img_decoded.cols, decoded_type, image_msg.data.data()};
+    cv::cvtColor(img_rgb, img_rgb, cv::COLOR_BGR2RGB);
+  }
+  return {};
+}
+
+#ifdef SPOT_DRIVER_HAS_TURBOJPEG
+struct TurboJpegHandleDeleter {
+  void operator()(void* handle) const { tjDestroy(handle); }
+};
+
+/** @brief Get the TurboJPEG pixel format which decodes into an encoding, which is bgr8 for NV12. */
+int toTurboJpegPixelFormat(const JpegOutputEncoding output_encoding) {
+  switch (output_encoding) {
+    case JpegOutputEncoding::RGB8: {
+      return TJPF_RGB;
+    }
+    case JpegOutputEncoding::MONO8: {
+      return TJPF_GRAY;
+    }
+    default: {
+      return TJPF_BGR;
+    }
+  }
+}
+
+tl::expected<void, std::string> decodeJpegTurbo(const std::string_view data, const JpegOutputEncoding output_encoding,
+                                                const int scale_denominator, sensor_msgs::msg::Image& image_msg) {
+  // TurboJPEG handles must not be shared between threads, so keep one per thread to allow decoding concurrently.
+  thread_local const std::unique_ptr<void, TurboJpegHandleDeleter> handle{tjInitDecompress()};
+  if (!handle) {
+    return tl::make_unexpected("Failed to initialize TurboJPEG decompressor.");
+  }
+
+  const auto* jpeg_buffer = reinterpret_cast<const unsigned char*>(data.data());
+  const auto jpeg_size = static_cast<unsigned long>(data.size());  // NOLINT(runtime/int)
+  int width = 0;
+  int height = 0;
+  int subsampling = 0;
+  int colorspace = 0;
+  if (tjDecompressHeader3(handle.get(), jpeg_buffer, jpeg_size, &width, &height, &subsampling, &colorspace) != 0) {
+    return tl::make_unexpected(std::string{"Failed to read JPEG header: "} + tjGetErrorStr2(handle.get()));
+  }
+
+  // TurboJPEG picks the DCT scaling factor that matches the requested dimensions
+  const tjscalingfactor scaling_factor{1, scale_denominator};
+  width = TJSCALED(width, scaling_factor);
+  height = TJSCALED(height, scaling_factor);
+
+  if (output_encoding == JpegOutputEncoding::NV12 && subsampling == TJSAMP_420 && width % 2 == 0 && height % 2 == 0) {
+    // The planes of the JPEG already have the layout of NV12 apart from the interleaving of the chroma, so the luma
+    // plane is decoded straight into the message and the chroma planes into buffers of this thread.
+    const auto luma_size = static_cast<std::size_t>(width) * height;
+    const auto chroma_size = luma_size / 4;
+    image_msg.data.resize(luma_size + 2 * chroma_size);
+    thread_local std::vector<unsigned char> chroma_planes;
+    chroma_planes.resize(2 * chroma_size);
+    unsigned char* planes[3] = {image_msg.data.data(), chroma_planes.data(), chroma_planes.data() + chroma_size};
+    int strides[3] = {width, width / 2, width / 2};
+    if (tjDecompressToYUVPlanes(handle.get(), jpeg_buffer, jpeg_size, planes, width, strides, height,
+                                TJFLAG_FASTDCT) != 0) {
+      return tl::make_unexpected(std::string{"Failed to decode JPEG-compressed image: "} +
+                                 tjGetErrorStr2(handle.get()));
+    }
+    interleaveChromaPlanes(planes[1], planes[2], chroma_size, image_msg.data.data() + luma_size);
+    setNv12Dimensions(width, height, image_msg);
+    return {};
+  }
+
+  const int pixel_format = toTurboJpegPixelFormat(output_encoding);
+  const int pitch = width * tjPixelSize[pixel_format];
+  if (output_encoding == JpegOutputEncoding::NV12) {
+    // Any other chroma subsampling has to be resampled, so the image is decoded into a buffer of this thread and
+    // converted from there.
+    thread_local std::vector<unsigned char> bgr_buffer;
+    bgr_buffer.resize(static_cast<std::size_t>(pitch) * height);
+    if (tjDecompress2(handle.get(), jpeg_buffer, jpeg_size, bgr_buffer.data(), width, pitch, height, pixel_format,
+                      TJFLAG_FASTDCT) != 0) {
+      return tl::make_unexpected(std::string{"Failed to decode JPEG-compressed image: "} +
+                                 tjGetErrorStr2(handle.get()));
+    }
+    return convertBgrToNv12(cv::Mat{height, width, CV_8UC3, bgr_buffer.data()}, image_msg);
+  }
+
+  image_msg.data.resize(static_cast<std::size_t>(pitch) * height);
+  if (tjDecompress2(handle.get(), jpeg_buffer, jpeg_size, image_msg.data.data(), width, pitch, height, pixel_format,
+                    TJFLAG_FASTDCT) != 0) {
+    return tl::make_unexpected(std::string{"Failed to decode JPEG-compressed image: "} + tjGetErrorStr2(handle.get()));
+  }
+  image_msg.height = height;
+  image_msg.width = width;
+  image_msg.step = pitch;
+  return {};
+}
+#endif
+
+}  // namespace
+
+tl::expected<JpegOutputEncoding, std::string> toJpegOutputEncoding(const std::string& name) {
+  if (name == sensor_msgs::image_encodings::BGR8) {
+    return JpegOutputEncoding::BGR8;
+  } else if (name == sensor_msgs::image_encodings::RGB8) {
+    return JpegOutputEncoding::RGB8;
+  } else if (name == sensor_msgs::image_encodings::MONO8) {
+    return JpegOutputEncoding::MONO8;
+  } else if (name == kNv12Encoding) {
+    return JpegOutputEncoding::NV12;
+  }
+  return tl::make_unexpected("Cannot decode JPEG images into encoding '" + name +
+                             "'. Expected 'bgr8', 'rgb8', 'mono8' or 'nv12'.");
+}
+
+std::string toImageEncodingName(const JpegOutputEncoding encoding) {
+  switch (encoding) {
+    case JpegOutputEncoding::RGB8: {
+      return sensor_msgs::image_encodings::RGB8;
+    }
+    case JpegOutputEncoding::MONO8: {
+      return sensor_msgs::image_encodings::MONO8;
+    }
+    case JpegOutputEncoding::NV12: {
+      return kNv12Encoding;
+    }
+    default: {
+      return sensor_msgs::image_encodings::BGR8;
+    }
+  }
+}
+
+tl::expected<JpegDecoderBackend, std::string> toJpegDecoderBackend(const std::string& name) {
+  if (name == "opencv") {
+    return JpegDecoderBackend::OPENCV;
+  } else if (name == "turbojpeg") {
+    return JpegDecoderBackend::TURBOJPEG;
+  }
+  return tl::make_unexpected("Unknown JPEG decoder backend '" + name + "'. Expected 'opencv' or 'turbojpeg'.");
+}
+
+bool isJpegDecoderBackendAvailable(const JpegDecoderBackend backend) {
+  switch (backend) {
+    case JpegDecoderBackend::OPENCV: {
+      return true;
+    }
+    case JpegDecoderBackend::TURBOJPEG: {
+#ifdef SPOT_DRIVER_HAS_TURBOJPEG
+      return true;
+#else
+      return false;
+#endif
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
+tl::expected<void, std::string> decodeJpeg(const std::string& data, const bool greyscale,
+                                           const JpegDecoderBackend backend, sensor_msgs::msg::Image& image_msg) {
+  return decodeJpeg(std::string_view{data}, greyscale, 1, backend, image_msg);
+}
+
+tl::expected<void, std::string> decodeJpeg(const std::string_view data, const bool greyscale,
+                                           const int scale_denominator, const JpegDecoderBackend backend,
+                                           sensor_msgs::msg::Image& image_msg) {
+  return decodeJpeg(data, greyscale ? JpegOutputEncoding::MONO8 : JpegOutputEncoding::BGR8, scale_denominator, backend,
+                    image_msg);
+}
+
+tl::expected<void, std::string> decodeJpeg(const std::string_view data, const JpegOutputEncoding output_encoding,
+                                           const int scale_denominator, const JpegDecoderBackend backend,
+                                           sensor_msgs::msg::Image& image_msg) {
+  if (data.empty()) {
+    return tl::make_unexpected("Cannot decode an empty JPEG-compressed image.");
+  }
+  if (scale_denominator != 1 && scale_denominator != 2 && scale_denominator != 4 && scale_denominator != 8) {
+    return tl::make_unexpected("JPEG scale denominator must be 1, 2, 4 or 8. Got " +
+                               std::to_string(scale_denominator) + ".");
+  }
+
+  tl::expected<void, std::string> result;
+#ifdef SPOT_DRIVER_HAS_TURBOJPEG
+  if (backend == JpegDecoderBackend::TURBOJPEG) {
+    result = decodeJpegTurbo(data, output_encoding, scale_denominator, image_msg);
+  } else {
+    result = decodeJpegOpenCv(data, output_encoding, scale_denominator, image_msg);
+  }
+#else
+  (void)backend;
+  result = decodeJpegOpenCv(data, output_encoding, scale_denominator, image_msg);
+#endif
+  if (!result) {
+    return result;
+  }
+
+  image_msg.encoding = toImageEncodingName(output_encoding);
+  image_msg.is_bigendian = false;
+  return {};
+}
+
+tl::expected<bool, std::string> isGreyscaleJpeg(const std::string_view data) {
+  const auto header = readJpegFrameHeader(data);
+  if (!header.has_value()) {
+    return tl::make_unexpected("Failed to read the header of the JPEG-compressed image.");
+  }
+  return header->components == 1;
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,134 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/conversions/jpeg_encoder.hpp>
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <sensor_msgs/image_encodings.hpp>
+
+#ifdef SPOT_DRIVER_HAS_TURBOJPEG
+#include <turbojpeg.h>
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spot_ros2 {
+namespace {
+
+constexpr auto kJpegFormat = "jpeg";
+constexpr auto kJpegCompressedFormatSeparator = "; jpeg compressed ";
+
+/** @brief Number of channels of the image encodings that can be encoded, or 0 if the encoding is not supported. */
+int getEncodableChannels(const std::string& encoding) {
+  if (encoding == sensor_msgs::image_encodings::MONO8) {
+    return 1;
+  }
+  if (encoding == sensor_msgs::image_encodings::BGR8 || encoding == sensor_msgs::image_encodings::RGB8) {
+    return 3;
+  }
+  return 0;
+}
+
+tl::expected<void, std::string> encodeJpegOpenCv(const sensor_msgs::msg::Image& image, const int channels,
+                                                 const int quality, sensor_msgs::msg::CompressedImage& compressed_msg) {
+  // Wrap the pixels in a cv::Mat without copying them. cv::imencode expects color images in BGR order.
+  const cv::Mat pixels{static_cast<int>(image.height), static_cast<int>(image.width), CV_8UC(channels),
+                       const_cast<unsigned char*>(image.data.data()), image.step};
+  cv::Mat bgr;
+  if (image.encoding == sensor_msgs::image_encodings::RGB8) {
+    cv::cvtColor(pixels, bgr, cv::COLOR_RGB2BGR);
+  }
+  // cv::imencode writes into the vector, which keeps its capacity between frames
+  if (!cv::imencode(".jpg", bgr.empty() ? pixels : bgr, compressed_msg.data, {cv::IMWRITE_JPEG_QUALITY, quality})) {
+    return tl::make_unexpected("Failed to encode the image as JPEG.");
+  }
+  return {};
+}
+
+#ifdef SPOT_DRIVER_HAS_TURBOJPEG
+struct TurboJpegHandleDeleter {
+  void operator()(void* handle) const { tjDestroy(handle); }
+};
+
+tl::expected<void, std::string> encodeJpegTurbo(const sensor_msgs::msg::Image& image, const int channels,
+                                                const int quality, sensor_msgs::msg::CompressedImage& compressed_msg) {
+  // TurboJPEG handles must not be shared between threads, so keep one per thread to allow encoding concurrently.
+  thread_local const std::unique_ptr<void, TurboJpegHandleDeleter> handle{tjInitCompress()};
+  if (!handle) {
+    return tl::make_unexpected("Failed to initialize TurboJPEG compressor.");
+  }
+
+  const int width = static_cast<int>(image.width);
+  const int height = static_cast<int>(image.height);
+  int pixel_format = TJPF_GRAY;
+  int subsampling = TJSAMP_GRAY;
+  if (channels == 3) {
+    pixel_format = image.encoding == sensor_msgs::image_encodings::RGB8 ? TJPF_RGB : TJPF_BGR;
+    subsampling = TJSAMP_420;
+  }
+  // Compress straight into the message, which is sized for the worst case so TurboJPEG never has to reallocate it
+  compressed_msg.data.resize(tjBufSize(width, height, subsampling));
+  auto* jpeg_buffer = compressed_msg.data.data();
+  unsigned long jpeg_size = compressed_msg.data.size();  // NOLINT(runtime/int)
+  if (tjCompress2(handle.get(), image.data.data(), width, static_cast<int>(image.step), height, pixel_format,
+                  &jpeg_buffer, &jpeg_size, subsampling, quality, TJFLAG_FASTDCT | TJFLAG_NOREALLOC) != 0) {
+    return tl::make_unexpected(std::string{"Failed to encode the image as JPEG: "} + tjGetErrorStr2(handle.get()));
+  }
+  compressed_msg.data.resize(jpeg_size);
+  return {};
+}
+#endif
+
+}  // namespace
+
+std::string getJpegCompressedFormat(const std::string& encoding) {
+  // JPEG stores color images as BGR, and greyscale images as a single channel.
+  if (encoding == sensor_msgs::image_encodings::MONO8) {
+    return encoding + kJpegCompressedFormatSeparator + sensor_msgs::image_encodings::MONO8;
+  }
+  if (encoding == sensor_msgs::image_encodings::BGR8 || encoding == sensor_msgs::image_encodings::RGB8) {
+    return encoding + kJpegCompressedFormatSeparator + sensor_msgs::image_encodings::BGR8;
+  }
+  return kJpegFormat;
+}
+
+tl::expected<void, std::string> encodeJpeg(const sensor_msgs::msg::Image& image, const int quality,
+                                           const JpegDecoderBackend backend,
+                                           sensor_msgs::msg::CompressedImage& compressed_msg) {
+  const int channels = getEncodableChannels(image.encoding);
+  if (channels == 0) {
+    return tl::make_unexpected("Cannot encode images with encoding '" + image.encoding +
+                               "' as JPEG. Expected mono8, bgr8 or rgb8.");
+  }
+  if (image.width == 0 || image.height == 0 ||
+      image.data.size() < static_cast<std::size_t>(image.step) * image.height) {
+    return tl::make_unexpected("Cannot encode an empty or truncated image as JPEG.");
+  }
+  if (quality < 1 || quality > 100) {
+    return tl::make_unexpected("JPEG quality must be between 1 and 100. Got " + std::to_string(quality) + ".");
+  }
+
+  tl::expected<void, std::string> result;
+#ifdef SPOT_DRIVER_HAS_TURBOJPEG
+  if (backend == JpegDecoderBackend::TURBOJPEG) {
+    result = encodeJpegTurbo(image, channels, quality, compressed_msg);
+  } else {
+    result = encodeJpegOpenCv(image, channels, quality, compressed_msg);
+  }
+#else
+  (void)backend;
+  result = encodeJpegOpenCv(image, channels, quality, compressed_msg);
+#endif
+  if (!result) {
+    return result;
+  }
+
+  compressed_msg.header = image.header;
+  compressed_msg.format = getJpegCompressedFormat(image.encoding);
+  return {};
+}
+
+}  // namespace spot_ros2
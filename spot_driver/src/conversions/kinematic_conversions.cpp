@@ -4,8 +4,32 @@
 
 #include <spot_driver/conversions/common_conversions.hpp>
 
+#include <google/protobuf/repeated_ptr_field.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
 namespace spot_ros2 {
 
+namespace {
+/**
+ * Convert every element of a repeated proto field into the element of a ROS array at the same index.
+ *
+ * The array is resized rather than rebuilt, and every element is converted in place, so converting into a reused
+ * message keeps the memory of its elements instead of copying temporaries into new ones.
+ */
+template <typename ProtoT, typename RosT>
+void convertRepeatedToRos(const google::protobuf::RepeatedPtrField<ProtoT>& proto, std::vector<RosT>& ros_msg) {
+  ros_msg.resize(static_cast<std::size_t>(proto.size()));
+  for (int i = 0; i < proto.size(); ++i) {
+    convertToRos(proto.Get(i), ros_msg[static_cast<std::size_t>(i)]);
+  }
+}
+}  // namespace
+
 ///////////////////////////////////////////////////////////////////////////////
 // ROS to Protobuf.
 
@@ -189,23 +213,38 @@ void convertToRos(const bosdyn::api::FrameTreeSnapshot::ParentEdge& proto,
 }
 
 void convertToRos(const bosdyn::api::FrameTreeSnapshot& proto, bosdyn_api_msgs::msg::FrameTreeSnapshot& ros_msg) {
-  ros_msg.child_to_parent_edge_map.clear();
-  for (const auto& item : proto.child_to_parent_edge_map()) {
-    bosdyn_api_msgs::msg::FrameTreeSnapshotChildToParentEdgeMapEntry edge;
-    edge.key = item.first;
-    convertToRos(item.second, edge.value);
-    ros_msg.child_to_parent_edge_map.push_back(edge);
+  // Map entries are converted in place, like repeated fields, instead of copying a temporary entry for every edge.
+  auto& entries = ros_msg.child_to_parent_edge_map;
+  entries.resize(proto.child_to_parent_edge_map().size());
+  auto entry = entries.begin();
+  for (const auto& [child, edge] : proto.child_to_parent_edge_map()) {
+    entry->key = child;
+    convertToRos(edge, entry->value);
+    ++entry;
+  }
+}
+
+void convertToRos(const bosdyn::api::FrameTreeSnapshot& proto, bosdyn_api_msgs::msg::FrameTreeSnapshot& ros_msg,
+                  std::vector<std::int32_t>& parent_indices) {
+  convertToRos(proto, ros_msg);
+
+  const auto& entries = ros_msg.child_to_parent_edge_map;
+  std::unordered_map<std::string_view, std::int32_t> index_of_frame;
+  index_of_frame.reserve(entries.size());
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    index_of_frame.emplace(entries[i].key, static_cast<std::int32_t>(i));
+  }
+  parent_indices.resize(entries.size());
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    const auto& parent_frame_name = entries[i].value.parent_frame_name;
+    const auto it = parent_frame_name.empty() ? index_of_frame.end() : index_of_frame.find(parent_frame_name);
+    parent_indices[i] = it == index_of_frame.end() ? -1 : it->second;
   }
 }
 
 void convertToRos(const bosdyn::api::KinematicState& proto, bosdyn_api_msgs::msg::KinematicState& ros_msg) {
   ros_msg.has_field = 0u;
-  ros_msg.joint_states.clear();
-  for (const auto& item : proto.joint_states()) {
-    bosdyn_api_msgs::msg::JointState joint_state;
-    convertToRos(item, joint_state);
-    ros_msg.joint_states.push_back(joint_state);
-  }
+  convertRepeatedToRos(proto.joint_states(), ros_msg.joint_states);
   if (proto.has_acquisition_timestamp()) {
     convertToRos(proto.acquisition_timestamp(), ros_msg.acquisition_timestamp);
     ros_msg.has_field |= bosdyn_api_msgs::msg::KinematicState::ACQUISITION_TIMESTAMP_FIELD_SET;
@@ -5,8 +5,10 @@
 #include <bosdyn/math/proto_math.h>
 #include <google/protobuf/duration.pb.h>
 #include <google/protobuf/timestamp.pb.h>
+#include <algorithm>
 #include <builtin_interfaces/msg/duration.hpp>
 #include <optional>
+#include <utility>
 #include <spot_driver/api/time_sync_api.hpp>
 #include <spot_driver/conversions/common_conversions.hpp>
 #include <spot_driver/conversions/geometry.hpp>
@@ -86,22 +88,54 @@ spot_msgs::msg::EStopStateArray getEstopStates(const ::bosdyn::api::RobotState&
 std::optional<sensor_msgs::msg::JointState> getJointStates(const ::bosdyn::api::RobotState& robot_state,
                                                            const google::protobuf::Duration& clock_skew,
                                                            const std::string& prefix) {
-  if (!robot_state.has_kinematic_state()) {
+  sensor_msgs::msg::JointState joint_states;
+  if (!JointStateConverter{prefix}.convert(robot_state, clock_skew, joint_states)) {
     return std::nullopt;
   }
+  return joint_states;
+}
 
-  sensor_msgs::msg::JointState joint_states;
-  joint_states.header.stamp = robotTimeToLocalTime(robot_state.kinematic_state().acquisition_timestamp(), clock_skew);
+JointStateConverter::JointStateConverter(std::string prefix) : prefix_{std::move(prefix)} {}
 
-  for (const auto& joint : robot_state.kinematic_state().joint_states()) {
-    const auto joint_name = prefix + kFriendlyJointNames.at(joint.name());
-    joint_states.name.push_back(joint_name);
-    joint_states.position.push_back(joint.position().value());
-    joint_states.velocity.push_back(joint.velocity().value());
-    joint_states.effort.push_back(joint.load().value());
+bool JointStateConverter::convert(const ::bosdyn::api::RobotState& robot_state,
+                                  const google::protobuf::Duration& clock_skew,
+                                  sensor_msgs::msg::JointState& joint_states) {
+  if (!robot_state.has_kinematic_state()) {
+    return false;
   }
 
-  return joint_states;
+  const auto& joints = robot_state.kinematic_state().joint_states();
+  const auto count = static_cast<std::size_t>(joints.size());
+
+  // Spot reports the same joints in the same order in every robot state, so the names are only built once.
+  const auto same_joints =
+      api_names_.size() == count && std::equal(api_names_.cbegin(), api_names_.cend(), joints.cbegin(),
+                                               [](const std::string& name, const ::bosdyn::api::JointState& joint) {
+                                                 return name == joint.name();
+                                               });
+  if (!same_joints) {
+    api_names_.clear();
+    names_.clear();
+    for (const auto& joint : joints) {
+      api_names_.push_back(joint.name());
+      names_.push_back(prefix_ + kFriendlyJointNames.at(joint.name()));
+    }
+  }
+  if (joint_states.name != names_) {
+    joint_states.name = names_;
+  }
+
+  joint_states.header.stamp = robotTimeToLocalTime(robot_state.kinematic_state().acquisition_timestamp(), clock_skew);
+  joint_states.position.resize(count);
+  joint_states.velocity.resize(count);
+  joint_states.effort.resize(count);
+  for (std::size_t index = 0; index < count; ++index) {
+    const auto& joint = joints.Get(static_cast<int>(index));
+    joint_states.position[index] = joint.position().value();
+    joint_states.velocity[index] = joint.velocity().value();
+    joint_states.effort[index] = joint.load().value();
+  }
+  return true;
 }
 
 std::optional<tf2_msgs::msg::TFMessage> getTf(const ::bosdyn::api::RobotState& robot_state,
@@ -120,47 +154,83 @@ std::optional<tf2_msgs::msg::TFMessage> getTf(const ::bosdyn::api::FrameTreeSnap
                                               const google::protobuf::Duration& clock_skew, const std::string& prefix,
                                               const std::string& preferred_base_frame_id,
                                               const std::set<std::string, std::less<>>& frames_to_ignore) {
-  if (frame_tree_snapshot.child_to_parent_edge_map().empty()) {
+  FrameTreeConverter converter{prefix, preferred_base_frame_id, frames_to_ignore};
+  if (!converter.convert(frame_tree_snapshot, timestamp_robot, clock_skew)) {
     return std::nullopt;
   }
+  return converter.takeMessage();
+}
+
+FrameTreeConverter::FrameTreeConverter(std::string prefix, std::string preferred_base_frame_id,
+                                       std::set<std::string, std::less<>> frames_to_ignore)
+    : prefix_{std::move(prefix)},
+      preferred_base_frame_id_{std::move(preferred_base_frame_id)},
+      frames_to_ignore_{std::move(frames_to_ignore)} {}
+
+bool FrameTreeConverter::convert(const ::bosdyn::api::FrameTreeSnapshot& frame_tree_snapshot,
+                                 const google::protobuf::Timestamp& timestamp_robot,
+                                 const google::protobuf::Duration& clock_skew) {
+  if (frame_tree_snapshot.child_to_parent_edge_map().empty()) {
+    return false;
+  }
 
   const auto timestamp_local = robotTimeToLocalTime(timestamp_robot, clock_skew);
 
-  tf2_msgs::msg::TFMessage tf_msg;
+  // The transforms are overwritten in place, so their frame name strings keep their capacity between calls.
+  auto& transforms = tf_msg_.transforms;
+  std::size_t count = 0;
   for (const auto& [frame_id, transform] : frame_tree_snapshot.child_to_parent_edge_map()) {
-    // In Spot's FrameTreeSnapshot, a frame without a parent is a root frame.
-    // In TF, root frames are expressed by publishing a transform whose parent frame ID is not the child frame ID of any
-    // other transform. To satisfy this requirement, do not publish frames from the frame tree snapshot if they do not
-    // have a parent frame ID.
-    if (transform.parent_frame_name().empty()) {
+    const auto& edge = getEdge(frame_id, transform.parent_frame_name());
+    if (edge.skip) {
       continue;
     }
-
-    // If this frame is in the list of frames to ignore, skip it.
-    if (frames_to_ignore.find(frame_id) != frames_to_ignore.end()) {
-      continue;
-    }
-
-    // These frames are duplicates of arm_link_wr1 (published with robot state) and shouldn't be added to the TF tree!
-    if ((frame_id == "arm0.link_wr1") || (frame_id == "link_wr1")) {
-      continue;
+    if (count == transforms.size()) {
+      transforms.emplace_back();
     }
-
-    const auto parent_frame_name = transform.parent_frame_name().find('/') == std::string::npos
-                                       ? prefix + transform.parent_frame_name()
-                                       : transform.parent_frame_name();
-    const auto frame_name = frame_id.find('/') == std::string::npos ? prefix + frame_id : frame_id;
-
+    auto& tf = transforms[count++];
+    tf.header.stamp = timestamp_local;
     // set preferred base frame as the root node in tf tree
-    if (preferred_base_frame_id == frame_name) {
-      tf_msg.transforms.push_back(
-          toTransformStamped(~(transform.parent_tform_child()), frame_name, parent_frame_name, timestamp_local));
+    if (edge.is_base_frame) {
+      tf.header.frame_id = edge.frame_name;
+      tf.child_frame_id = edge.parent_frame_name;
+      convertToRos(~(transform.parent_tform_child()), tf.transform);
     } else {
-      tf_msg.transforms.push_back(
-          toTransformStamped(transform.parent_tform_child(), parent_frame_name, frame_name, timestamp_local));
+      tf.header.frame_id = edge.parent_frame_name;
+      tf.child_frame_id = edge.frame_name;
+      convertToRos(transform.parent_tform_child(), tf.transform);
     }
   }
-  return tf_msg;
+  transforms.resize(count);
+  return true;
+}
+
+const FrameTreeConverter::Edge& FrameTreeConverter::getEdge(const std::string& frame_id,
+                                                            const std::string& snapshot_parent_frame_name) {
+  auto it = edges_.find(frame_id);
+  if (it != edges_.end() && it->second.snapshot_parent_frame_name == snapshot_parent_frame_name) {
+    return it->second;
+  }
+  if (it == edges_.end()) {
+    it = edges_.emplace(frame_id, Edge{}).first;
+  }
+
+  auto& edge = it->second;
+  edge.snapshot_parent_frame_name = snapshot_parent_frame_name;
+  edge.parent_frame_name = snapshot_parent_frame_name.find('/') == std::string::npos
+                               ? prefix_ + snapshot_parent_frame_name
+                               : snapshot_parent_frame_name;
+  edge.frame_name = frame_id.find('/') == std::string::npos ? prefix_ + frame_id : frame_id;
+  edge.is_base_frame = preferred_base_frame_id_ == edge.frame_name;
+  // In Spot's FrameTreeSnapshot, a frame without a parent is a root frame.
+  // In TF, root frames are expressed by publishing a transform whose parent frame ID is not the child frame ID of any
+  // other transform. To satisfy this requirement, do not publish frames from the frame tree snapshot if they do not
+  // have a parent frame ID.
+  // Frames in the list of frames to ignore are skipped as well.
+  // "arm0.link_wr1" and "link_wr1" are duplicates of arm_link_wr1 (published with robot state) and shouldn't be added
+  // to the TF tree!
+  edge.skip = snapshot_parent_frame_name.empty() || frames_to_ignore_.find(frame_id) != frames_to_ignore_.end() ||
+              frame_id == "arm0.link_wr1" || frame_id == "link_wr1";
+  return edge;
 }
 
 std::optional<geometry_msgs::msg::TwistWithCovarianceStamped> getOdomTwist(const ::bosdyn::api::RobotState& robot_state,
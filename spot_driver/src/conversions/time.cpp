@@ -7,57 +7,58 @@
 #include <builtin_interfaces/msg/time.hpp>
 
 namespace {
-/**
- * @brief Modify seconds and nanoseconds in-place to enforce that the nanoseconds must contain a value between 0 and
- * 999,999,999 by adding or removing whole seconds.
- */
-void normalize(int64_t& seconds, int32_t& nanos) {
-  if (nanos < 0) {
-    nanos += 1e9;
-    seconds -= 1;
-  } else if (nanos >= 1e9) {
-    nanos -= 1e9;
-    seconds += 1;
-  }
-}
+constexpr std::int64_t kNanosecondsPerSecond = 1'000'000'000;
 }  // namespace
 
 namespace spot_ros2 {
-builtin_interfaces::msg::Time robotTimeToLocalTime(const google::protobuf::Timestamp& timestamp_robot,
-                                                   const google::protobuf::Duration& clock_skew) {
-  int64_t seconds_local = timestamp_robot.seconds() - clock_skew.seconds();
-  int32_t nanos_local = timestamp_robot.nanos() - clock_skew.nanos();
+std::int64_t toNanoseconds(const google::protobuf::Timestamp& timestamp) {
+  return timestamp.seconds() * kNanosecondsPerSecond + timestamp.nanos();
+}
 
-  // Carry over a second if needed
-  // Note: Since ROS Time messages store the nanoseconds component as an unsigned integer, we need to do this before
-  // converting to ROS Time.
-  normalize(seconds_local, nanos_local);
+std::int64_t toNanoseconds(const google::protobuf::Duration& duration) {
+  return duration.seconds() * kNanosecondsPerSecond + duration.nanos();
+}
 
-  // If the timestamp contains a negative time, create an all-zero ROS Time.
-  if (seconds_local < 0) {
-    return builtin_interfaces::build<builtin_interfaces::msg::Time>().sec(0).nanosec(0);
-  }
+std::int64_t toNanoseconds(const builtin_interfaces::msg::Time& time) {
+  return static_cast<std::int64_t>(time.sec) * kNanosecondsPerSecond + static_cast<std::int64_t>(time.nanosec);
+}
+
+builtin_interfaces::msg::Time toRosTime(const std::int64_t nanoseconds) {
   return builtin_interfaces::build<builtin_interfaces::msg::Time>()
-      .sec(static_cast<int>(seconds_local))
-      .nanosec(nanos_local);
+      .sec(static_cast<std::int32_t>(nanoseconds / kNanosecondsPerSecond))
+      .nanosec(static_cast<std::uint32_t>(nanoseconds % kNanosecondsPerSecond));
+}
+
+google::protobuf::Timestamp toProtoTimestamp(const std::int64_t nanoseconds) {
+  google::protobuf::Timestamp timestamp;
+  timestamp.set_seconds(nanoseconds / kNanosecondsPerSecond);
+  timestamp.set_nanos(static_cast<std::int32_t>(nanoseconds % kNanosecondsPerSecond));
+  return timestamp;
+}
+
+builtin_interfaces::msg::Time robotTimeToLocalTime(const google::protobuf::Timestamp& timestamp_robot,
+                                                   const google::protobuf::Duration& clock_skew) {
+  // Converting to nanoseconds first carries over any number of seconds between the seconds and nanoseconds fields, and
+  // clamps times before the epoch to an all-zero ROS Time.
+  return toRosTime(robotTimeToLocalTime(toNanoseconds(timestamp_robot), toNanoseconds(clock_skew)));
 }
 
 google::protobuf::Timestamp localTimeToRobotTime(const builtin_interfaces::msg::Time& timestamp_local,
                                                  const google::protobuf::Duration& clock_skew) {
-  int64_t seconds_robot = static_cast<int64_t>(timestamp_local.sec) + clock_skew.seconds();
-  int32_t nanos_robot = static_cast<int32_t>(timestamp_local.nanosec) + clock_skew.nanos();
-
-  // Carry over a second if needed
-  normalize(seconds_robot, nanos_robot);
+  return toProtoTimestamp(localTimeToRobotTime(toNanoseconds(timestamp_local), toNanoseconds(clock_skew)));
+}
 
-  // If the timestamp contains a negative time, return an all-zero timestamp
-  if (seconds_robot < 0) {
-    return google::protobuf::Timestamp{};
+void robotTimesToLocalTimes(const std::int64_t* timestamps_robot, const std::size_t count,
+                            const std::int64_t clock_skew, std::int64_t* timestamps_local) {
+  for (std::size_t i = 0; i < count; ++i) {
+    timestamps_local[i] = robotTimeToLocalTime(timestamps_robot[i], clock_skew);
   }
+}
 
-  google::protobuf::Timestamp timestamp_robot;
-  timestamp_robot.set_seconds(seconds_robot);
-  timestamp_robot.set_nanos(nanos_robot);
-  return timestamp_robot;
+void localTimesToRobotTimes(const std::int64_t* timestamps_local, const std::size_t count,
+                            const std::int64_t clock_skew, std::int64_t* timestamps_robot) {
+  for (std::size_t i = 0; i < count; ++i) {
+    timestamps_robot[i] = localTimeToRobotTime(timestamps_local[i], clock_skew);
+  }
 }
 }  // namespace spot_ros2
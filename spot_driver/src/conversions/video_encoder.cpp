@@ -0,0 +1,375 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/conversions/video_encoder.hpp>
+
+#include <sensor_msgs/image_encodings.hpp>
+
+#ifdef SPOT_DRIVER_HAS_LIBAV
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/hwcontext.h>
+#include <libavutil/opt.h>
+#include <libswscale/swscale.h>
+}
+#endif
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace spot_ros2 {
+
+#ifdef SPOT_DRIVER_HAS_LIBAV
+namespace {
+
+/** @brief FFmpeg encoder which may be used for a codec and backend. */
+struct EncoderCandidate {
+  const char* name;
+  VideoEncoderBackend backend;
+};
+
+/**
+ * @brief Get the FFmpeg encoders to try for a codec, in order of preference.
+ *
+ * @param codec Codec to encode.
+ * @param backend Requested backend. AUTO tries the hardware encoders before the software encoder.
+ * @return The encoders to try.
+ */
+std::vector<EncoderCandidate> encoderCandidates(const VideoCodec codec, const VideoEncoderBackend backend) {
+  const auto h265 = codec == VideoCodec::H265;
+  const std::vector<EncoderCandidate> all{
+      {h265 ? "hevc_nvenc" : "h264_nvenc", VideoEncoderBackend::NVENC},
+      {h265 ? "hevc_vaapi" : "h264_vaapi", VideoEncoderBackend::VAAPI},
+      {h265 ? "libx265" : "libx264", VideoEncoderBackend::SOFTWARE},
+  };
+  if (backend == VideoEncoderBackend::AUTO) {
+    return all;
+  }
+  std::vector<EncoderCandidate> candidates;
+  for (const auto& candidate : all) {
+    if (candidate.backend == backend) {
+      candidates.push_back(candidate);
+    }
+  }
+  return candidates;
+}
+
+std::string toErrorString(const int error) {
+  char buffer[AV_ERROR_MAX_STRING_SIZE]{};
+  av_strerror(error, buffer, sizeof(buffer));
+  return buffer;
+}
+
+/**
+ * @brief Get the FFmpeg pixel format of a ROS image encoding.
+ *
+ * @param encoding Encoding of a ROS image.
+ * @return The pixel format, or AV_PIX_FMT_NONE if images of this encoding cannot be encoded.
+ */
+AVPixelFormat toPixelFormat(const std::string& encoding) {
+  namespace enc = sensor_msgs::image_encodings;
+  if (encoding == enc::MONO8) {
+    return AV_PIX_FMT_GRAY8;
+  } else if (encoding == enc::BGR8) {
+    return AV_PIX_FMT_BGR24;
+  } else if (encoding == enc::RGB8) {
+    return AV_PIX_FMT_RGB24;
+  } else if (encoding == enc::BGRA8) {
+    return AV_PIX_FMT_BGRA;
+  } else if (encoding == enc::RGBA8) {
+    return AV_PIX_FMT_RGBA;
+  }
+  return AV_PIX_FMT_NONE;
+}
+
+}  // namespace
+
+struct VideoEncoder::Impl {
+  ~Impl() {
+    sws_freeContext(scaler);
+    av_packet_free(&packet);
+    av_frame_free(&hardware_frame);
+    av_frame_free(&frame);
+    avcodec_free_context(&context);
+    av_buffer_unref(&hardware_device);
+  }
+
+  AVCodecContext* context{nullptr};
+  /** @brief YUV frame which the images are converted into. */
+  AVFrame* frame{nullptr};
+  /** @brief Surface on the GPU which the YUV frame is uploaded to, if the encoder uses VA-API. */
+  AVFrame* hardware_frame{nullptr};
+  AVBufferRef* hardware_device{nullptr};
+  AVPacket* packet{nullptr};
+  SwsContext* scaler{nullptr};
+
+  std::string encoder_name;
+  std::string format;
+  std::int64_t next_pts{0};
+  bool keyframe_requested{false};
+  /** @brief Headers of the images which were sent to the encoder and whose frames were not received yet. */
+  std::deque<std::pair<std::int64_t, std_msgs::msg::Header>> pending_headers;
+};
+
+namespace {
+
+/**
+ * @brief Open an FFmpeg encoder.
+ *
+ * @param candidate Encoder to open.
+ * @param options Options of the stream.
+ * @param width Width of the images in pixels.
+ * @param height Height of the images in pixels.
+ * @return The state of the open encoder, or an error message if it is not available.
+ */
+tl::expected<std::unique_ptr<VideoEncoder::Impl>, std::string> openEncoder(const EncoderCandidate& candidate,
+                                                                          const VideoEncoderOptions& options,
+                                                                          const int width, const int height) {
+  const auto* codec = avcodec_find_encoder_by_name(candidate.name);
+  if (codec == nullptr) {
+    return tl::make_unexpected(std::string{candidate.name} + ": FFmpeg was built without this encoder.");
+  }
+
+  auto impl = std::make_unique<VideoEncoder::Impl>();
+  impl->encoder_name = candidate.name;
+  impl->format = options.codec == VideoCodec::H265 ? "h265" : "h264";
+  impl->context = avcodec_alloc_context3(codec);
+  auto* context = impl->context;
+  context->width = width;
+  context->height = height;
+  context->time_base = AVRational{1, options.frame_rate};
+  context->framerate = AVRational{options.frame_rate, 1};
+  context->bit_rate = options.bit_rate;
+  context->gop_size = options.keyframe_interval;
+  // B-frames are encoded after the frames that follow them, which would hold every image back by at least a frame.
+  context->max_b_frames = 0;
+
+  const auto vaapi = candidate.backend == VideoEncoderBackend::VAAPI;
+  const auto software_format = vaapi ? AV_PIX_FMT_NV12 : AV_PIX_FMT_YUV420P;
+  context->pix_fmt = vaapi ? AV_PIX_FMT_VAAPI : software_format;
+
+  // The options only exist for some encoders, so failures to set them are ignored. Keyframes which are requested for
+  // new subscribers must be IDR frames, which reset the references of the decoder.
+  av_opt_set(context->priv_data, "forced-idr", "1", 0);
+  if (candidate.backend == VideoEncoderBackend::SOFTWARE) {
+    av_opt_set(context->priv_data, "preset", "veryfast", 0);
+    av_opt_set(context->priv_data, "tune", "zerolatency", 0);
+  } else if (candidate.backend == VideoEncoderBackend::NVENC) {
+    av_opt_set(context->priv_data, "preset", "p2", 0);
+    av_opt_set(context->priv_data, "tune", "ll", 0);
+    av_opt_set(context->priv_data, "zerolatency", "1", 0);
+  }
+
+  if (vaapi) {
+    if (const auto result =
+            av_hwdevice_ctx_create(&impl->hardware_device, AV_HWDEVICE_TYPE_VAAPI, nullptr, nullptr, 0);
+        result < 0) {
+      return tl::make_unexpected(std::string{candidate.name} + ": No VA-API device is available: " +
+                                 toErrorString(result));
+    }
+    auto* frames_reference = av_hwframe_ctx_alloc(impl->hardware_device);
+    auto* frames = reinterpret_cast<AVHWFramesContext*>(frames_reference->data);
+    frames->format = AV_PIX_FMT_VAAPI;
+    frames->sw_format = software_format;
+    frames->width = width;
+    frames->height = height;
+    frames->initial_pool_size = 4;
+    if (const auto result = av_hwframe_ctx_init(frames_reference); result < 0) {
+      av_buffer_unref(&frames_reference);
+      return tl::make_unexpected(std::string{candidate.name} + ": Could not create the VA-API surfaces: " +
+                                 toErrorString(result));
+    }
+    context->hw_frames_ctx = frames_reference;
+    impl->hardware_frame = av_frame_alloc();
+  }
+
+  if (const auto result = avcodec_open2(context, codec, nullptr); result < 0) {
+    return tl::make_unexpected(std::string{candidate.name} + ": " + toErrorString(result));
+  }
+
+  impl->frame = av_frame_alloc();
+  impl->frame->format = software_format;
+  impl->frame->width = width;
+  impl->frame->height = height;
+  if (const auto result = av_frame_get_buffer(impl->frame, 0); result < 0) {
+    return tl::make_unexpected(std::string{candidate.name} + ": Could not allocate a frame: " + toErrorString(result));
+  }
+  impl->packet = av_packet_alloc();
+  return impl;
+}
+
+}  // namespace
+#else
+struct VideoEncoder::Impl {
+  std::string encoder_name;
+};
+#endif
+
+tl::expected<VideoCodec, std::string> toVideoCodec(const std::string& name) {
+  if (name == "h264") {
+    return VideoCodec::H264;
+  } else if (name == "h265") {
+    return VideoCodec::H265;
+  }
+  return tl::make_unexpected("Unknown video codec '" + name + "'. Expected 'h264' or 'h265'.");
+}
+
+tl::expected<VideoEncoderBackend, std::string> toVideoEncoderBackend(const std::string& name) {
+  if (name == "auto") {
+    return VideoEncoderBackend::AUTO;
+  } else if (name == "nvenc") {
+    return VideoEncoderBackend::NVENC;
+  } else if (name == "vaapi") {
+    return VideoEncoderBackend::VAAPI;
+  } else if (name == "software") {
+    return VideoEncoderBackend::SOFTWARE;
+  }
+  return tl::make_unexpected("Unknown video encoder backend '" + name +
+                             "'. Expected 'auto', 'nvenc', 'vaapi' or 'software'.");
+}
+
+bool isVideoEncodingAvailable() {
+#ifdef SPOT_DRIVER_HAS_LIBAV
+  return true;
+#else
+  return false;
+#endif
+}
+
+VideoEncoder::VideoEncoder(std::unique_ptr<Impl> impl) : impl_{std::move(impl)} {}
+
+VideoEncoder::~VideoEncoder() = default;
+
+tl::expected<std::unique_ptr<VideoEncoder>, std::string> VideoEncoder::create(const VideoEncoderOptions& options,
+                                                                              const int width, const int height) {
+#ifdef SPOT_DRIVER_HAS_LIBAV
+  if (width <= 0 || height <= 0 || options.frame_rate <= 0 || options.keyframe_interval <= 0) {
+    return tl::make_unexpected("Invalid video encoder options: the image size, frame rate and keyframe interval must "
+                               "be positive.");
+  }
+  // YUV 4:2:0 stores the color at half the resolution, which every encoder requires to be a whole number of pixels.
+  if (width % 2 != 0 || height % 2 != 0) {
+    return tl::make_unexpected("Cannot encode images of " + std::to_string(width) + "x" + std::to_string(height) +
+                               " pixels. The width and height must be even.");
+  }
+  std::string errors;
+  for (const auto& candidate : encoderCandidates(options.codec, options.backend)) {
+    auto impl = openEncoder(candidate, options, width, height);
+    if (impl.has_value()) {
+      return std::unique_ptr<VideoEncoder>{new VideoEncoder{std::move(impl.value())}};
+    }
+    errors += " " + impl.error() + ".";
+  }
+  return tl::make_unexpected("Could not open a video encoder." + errors);
+#else
+  (void)options;
+  (void)width;
+  (void)height;
+  return tl::make_unexpected("The driver was built without FFmpeg, so video cannot be encoded.");
+#endif
+}
+
+tl::expected<std::vector<spot_msgs::msg::CompressedVideo>, std::string> VideoEncoder::encode(
+    const sensor_msgs::msg::Image& image) {
+#ifdef SPOT_DRIVER_HAS_LIBAV
+  auto* context = impl_->context;
+  auto* frame = impl_->frame;
+  if (static_cast<int>(image.width) != context->width || static_cast<int>(image.height) != context->height) {
+    return tl::make_unexpected("The image has " + std::to_string(image.width) + "x" + std::to_string(image.height) +
+                               " pixels, but the encoder was opened for " + std::to_string(context->width) + "x" +
+                               std::to_string(context->height) + ".");
+  }
+  const auto source_format = toPixelFormat(image.encoding);
+  if (source_format == AV_PIX_FMT_NONE) {
+    return tl::make_unexpected("Cannot encode images with the encoding " + image.encoding + ".");
+  }
+
+  // The encoder may still reference the previous frame, in which case it gets a new buffer.
+  if (const auto result = av_frame_make_writable(frame); result < 0) {
+    return tl::make_unexpected("Could not write the frame: " + toErrorString(result));
+  }
+  impl_->scaler = sws_getCachedContext(impl_->scaler, context->width, context->height, source_format, context->width,
+                                       context->height, static_cast<AVPixelFormat>(frame->format), SWS_BILINEAR,
+                                       nullptr, nullptr, nullptr);
+  const std::uint8_t* const source_planes[] = {image.data.data()};
+  const int source_strides[] = {static_cast<int>(image.step)};
+  sws_scale(impl_->scaler, source_planes, source_strides, 0, context->height, frame->data, frame->linesize);
+
+  frame->pts = impl_->next_pts++;
+  frame->pict_type = impl_->keyframe_requested ? AV_PICTURE_TYPE_I : AV_PICTURE_TYPE_NONE;
+  impl_->keyframe_requested = false;
+  auto* input = frame;
+  if (impl_->hardware_frame != nullptr) {
+    av_frame_unref(impl_->hardware_frame);
+    if (const auto result = av_hwframe_get_buffer(context->hw_frames_ctx, impl_->hardware_frame, 0); result < 0) {
+      return tl::make_unexpected("Could not get a VA-API surface: " + toErrorString(result));
+    }
+    if (const auto result = av_hwframe_transfer_data(impl_->hardware_frame, frame, 0); result < 0) {
+      return tl::make_unexpected("Could not upload the frame: " + toErrorString(result));
+    }
+    impl_->hardware_frame->pts = frame->pts;
+    impl_->hardware_frame->pict_type = frame->pict_type;
+    input = impl_->hardware_frame;
+  }
+
+  if (const auto result = avcodec_send_frame(context, input); result < 0) {
+    return tl::make_unexpected("Could not encode the frame: " + toErrorString(result));
+  }
+  impl_->pending_headers.emplace_back(frame->pts, image.header);
+
+  std::vector<spot_msgs::msg::CompressedVideo> encoded_frames;
+  while (true) {
+    const auto result = avcodec_receive_packet(context, impl_->packet);
+    if (result == AVERROR(EAGAIN) || result == AVERROR_EOF) {
+      break;
+    }
+    if (result < 0) {
+      return tl::make_unexpected("Could not receive an encoded frame: " + toErrorString(result));
+    }
+    auto& encoded_frame = encoded_frames.emplace_back();
+    // Without B-frames the frames come out in the order of their images, so the oldest header is the frame's own.
+    while (!impl_->pending_headers.empty() && impl_->pending_headers.front().first <= impl_->packet->pts) {
+      encoded_frame.header = std::move(impl_->pending_headers.front().second);
+      impl_->pending_headers.pop_front();
+    }
+    encoded_frame.format = impl_->format;
+    encoded_frame.keyframe = (impl_->packet->flags & AV_PKT_FLAG_KEY) != 0;
+    encoded_frame.data.assign(impl_->packet->data, impl_->packet->data + impl_->packet->size);
+    av_packet_unref(impl_->packet);
+  }
+  return encoded_frames;
+#else
+  (void)image;
+  return tl::make_unexpected("The driver was built without FFmpeg, so video cannot be encoded.");
+#endif
+}
+
+void VideoEncoder::requestKeyframe() {
+#ifdef SPOT_DRIVER_HAS_LIBAV
+  impl_->keyframe_requested = true;
+#endif
+}
+
+const std::string& VideoEncoder::encoderName() const {
+  return impl_->encoder_name;
+}
+
+int VideoEncoder::width() const {
+#ifdef SPOT_DRIVER_HAS_LIBAV
+  return impl_->context->width;
+#else
+  return 0;
+#endif
+}
+
+int VideoEncoder::height() const {
+#ifdef SPOT_DRIVER_HAS_LIBAV
+  return impl_->context->height;
+#else
+  return 0;
+#endif
+}
+
+}  // namespace spot_ros2
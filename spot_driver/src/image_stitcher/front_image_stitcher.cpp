@@ -0,0 +1,77 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/image_stitcher/front_image_stitcher.hpp>
+
+#include <opencv2/core/ocl.hpp>
+
+#include <memory>
+#include <string>
+
+namespace spot_ros2 {
+namespace {
+/** @brief Check if a camera built for the previous CameraInfo can also be used for the next one. */
+bool hasSameGeometry(const sensor_msgs::msg::CameraInfo& previous, const sensor_msgs::msg::CameraInfo& next) {
+  return previous.width == next.width && previous.height == next.height && previous.k == next.k;
+}
+}  // namespace
+
+FrontImageStitcher::FrontImageStitcher(const FrontImageStitcherOptions& options) : options_{options} {}
+
+FrontImageStitcher::~FrontImageStitcher() = default;
+
+void FrontImageStitcher::setCameraTransforms(const geometry_msgs::msg::Transform& body_tform_left,
+                                             const geometry_msgs::msg::Transform& body_tform_right) {
+  body_tform_left_ = body_tform_left;
+  body_tform_right_ = body_tform_right;
+}
+
+bool FrontImageStitcher::hasCameraTransforms() const {
+  return body_tform_left_.has_value() && body_tform_right_.has_value();
+}
+
+tl::expected<void, std::string> FrontImageStitcher::stitch(const ImageWithCameraInfo& left,
+                                                           const ImageWithCameraInfo& right) {
+  if (!hasCameraTransforms()) {
+    return tl::make_unexpected("The transforms from " + options_.body_frame +
+                               " to the front cameras are not known yet.");
+  }
+  // Whether OpenCL is used is set per thread, and the images are stitched on the thread that publishes them
+  cv::ocl::setUseOpenCL(options_.use_gpu);
+  if (!camera_ || !hasSameGeometry(camera_info_left_, left.info) || !hasSameGeometry(camera_info_right_, right.info)) {
+    camera_ = std::make_unique<MiddleCamera>(options_.intrinsics, options_.plane_normal, options_.plane_distance,
+                                             options_.row_padding, options_.seam_update_period, options_.blend_mode,
+                                             options_.blend_width, options_.use_gpu, JpegDecoderBackend::OPENCV, false,
+                                             *body_tform_left_, *body_tform_right_, left.info, right.info);
+    camera_info_left_ = left.info;
+    camera_info_right_ = right.info;
+  }
+
+  // The images are owned by the response and outlive this call, so they are shared without taking ownership
+  const std::shared_ptr<const sensor_msgs::msg::Image> left_image{std::shared_ptr<void>{}, &left.image};
+  const std::shared_ptr<const sensor_msgs::msg::Image> right_image{std::shared_ptr<void>{}, &right.image};
+  image_ = &camera_->stitch(left_image, right_image);
+
+  const auto& stamp = left.info.header.stamp;
+  image_->header.stamp = stamp;
+  image_->header.frame_id = options_.camera_frame;
+  // The camera info only has to be rebuilt if the size of the stitched image changes, otherwise it is just restamped
+  if (info_.width != image_->width || info_.height != image_->height) {
+    info_ = toCameraInfo(stamp, options_.camera_frame, image_->width, image_->height, options_.intrinsics);
+  }
+  info_.header.stamp = stamp;
+  return {};
+}
+
+std::optional<geometry_msgs::msg::TransformStamped> FrontImageStitcher::getVirtualCameraTransform() const {
+  if (!camera_) {
+    return std::nullopt;
+  }
+  geometry_msgs::msg::TransformStamped transform;
+  transform.header.stamp = info_.header.stamp;
+  transform.header.frame_id = options_.body_frame;
+  transform.child_frame_id = options_.camera_frame;
+  transform.transform = camera_->getTransform();
+  return transform;
+}
+
+}  // namespace spot_ros2
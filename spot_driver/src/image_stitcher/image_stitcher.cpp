@@ -1,17 +1,27 @@
 // Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
 #include <cv_bridge/cv_bridge.h>
+#include <algorithm>
+#include <array>
 #include <builtin_interfaces/msg/detail/time__struct.hpp>
+#include <chrono>
+#include <cstdint>
+#include <exception>
 #include <geometry_msgs/msg/detail/transform_stamped__struct.hpp>
 #include <image_transport/subscriber_filter.hpp>
+#include <limits>
 #include <memory>
 #include <opencv2/core/types.hpp>
+#include <spot_driver/conversions/jpeg_encoder.hpp>
+#include <spot_driver/conversions/time.hpp>
 #include <spot_driver/image_stitcher/image_stitcher.hpp>
+#include <spot_driver/tracing.hpp>
 
 #include <message_filters/time_synchronizer.h>
 #include <opencv2/core/hal/interface.h>
 
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/matx.hpp>
+#include <opencv2/core/ocl.hpp>
 #include <opencv2/core/quaternion.hpp>
 #include <opencv2/highgui.hpp>
 #include <opencv2/imgproc.hpp>
@@ -20,10 +30,31 @@
 #include <std_msgs/msg/detail/header__struct.hpp>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tf2_eigen/tf2_eigen.hpp>
 #include <vector>
 namespace {
 constexpr auto kHistoryDepth = 10;
+constexpr auto kDiagnosticsTopic = "/diagnostics";
+constexpr auto kDiagnosticsHistoryDepth = 10;
+constexpr auto kTimingReportPeriod = std::chrono::seconds{1};
+constexpr auto kTimingDiagnosticsNamePrefix = "image_stitcher: ";
+constexpr auto kDefaultJpegQuality = 90;
+// Parameters of the virtual camera and blending that can be changed while the stitcher is running
+constexpr std::array<const char*, 7> kDynamicParameters{
+    "virtual_camera_intrinsics",
+    "virtual_camera_projection_plane",
+    "virtual_camera_plane_distance",
+    "stitched_image_row_padding",
+    "stitched_image_seam_update_period",
+    "stitched_image_blend_mode",
+    "stitched_image_blend_width",
+};
+
+/* Identify the stages of a stitched frame in a trace by the timestamp of its images */
+std::uint64_t toTraceId(const builtin_interfaces::msg::Time& stamp) {
+  return static_cast<std::uint64_t>(spot_ros2::toNanoseconds(stamp));
+}
 
 cv::Vec3d toCvVec3d(const std::vector<double>& flattened) {
   if (flattened.size() != 3) {
@@ -91,34 +122,6 @@ cv::Matx44d toCvMatx44d(const geometry_msgs::msg::Transform& tf) {
   return toCvMatx44d(q, t);
 }
 
-sensor_msgs::msg::CameraInfo toCameraInfo(const builtin_interfaces::msg::Time& stamp, const std::string& frame,
-                                          size_t width, size_t height, const cv::Matx33d& K) {
-  sensor_msgs::msg::CameraInfo info;
-  // Set header with new frame
-  info.header.stamp = stamp;
-  info.header.frame_id = frame;
-  // Set dimensions
-  info.width = width;
-  info.height = height;
-  // Set intrinsics
-  info.k = {                            //
-            K(0, 0), K(0, 1), K(0, 2),  //
-            K(1, 0), K(1, 1), K(1, 2),  //
-            K(2, 0), K(2, 1), K(2, 2)};
-  // Set the projection matrix (P)
-  // P is a 3x4 matrix, so we extend the intrinsic matrix with zeros
-  info.p = {                                 //
-            K(0, 0), K(0, 1), K(0, 2), 0.0,  //
-            K(1, 0), K(1, 1), K(1, 2), 0.0,  //
-            K(2, 0), K(2, 1), K(2, 2), 0.0};
-  // Set the distortion coefficients
-  info.d = std::vector<double>(5, 0.);
-  // Typical distortion model
-  info.distortion_model = "plumb_bob";
-
-  return info;
-}
-
 void convertToRos(const cv::Matx44d& transform, geometry_msgs::msg::Transform& ros_msg) {
   // Extract rotation matrix
   auto const R = transform.get_minor<3, 3>(0, 0);
@@ -184,32 +187,202 @@ cv::Matx33d computeHomography(const cv::Matx33d& Km, const cv::Matx33d& Kc, cons
   H /= H(2, 2);
   return H;
 }
+
+/**
+ * @brief Build the maps for cv::remap that are equivalent to cv::warpPerspective with a homography, so that the
+ * per-pixel inverse mapping only has to be computed once for a homography that does not change.
+ *
+ * @param homography Homography from the source image into the destination image.
+ * @param size Size of the destination image.
+ * @param map_xy Output fixed-point map of the integer source coordinates, encoded in CV_16SC2.
+ * @param map_interpolation Output map of the interpolation table indices, encoded in CV_16UC1.
+ */
+void buildPerspectiveMaps(const cv::Matx33d& homography, const cv::Size& size, cv::UMat& map_xy,
+                          cv::UMat& map_interpolation) {
+  // cv::warpPerspective samples the source image through the inverse of the homography
+  const cv::Matx33d inverse = homography.inv();
+  cv::Mat map_x{size, CV_32F};
+  cv::Mat map_y{size, CV_32F};
+  for (int row = 0; row < size.height; ++row) {
+    auto* const x_row = map_x.ptr<float>(row);
+    auto* const y_row = map_y.ptr<float>(row);
+    for (int col = 0; col < size.width; ++col) {
+      const cv::Vec3d source = inverse * cv::Vec3d{static_cast<double>(col), static_cast<double>(row), 1.};
+      const double scale = source(2) != 0. ? 1. / source(2) : 0.;
+      x_row[col] = static_cast<float>(source(0) * scale);
+      y_row[col] = static_cast<float>(source(1) * scale);
+    }
+  }
+  cv::convertMaps(map_x, map_y, map_xy, map_interpolation, CV_16SC2);
+}
+
+/**
+ * @brief Build the weights of one image for a linear alpha ramp across the seam, for use with cv::blendLinear.
+ *
+ * @param seam_mask Mask of the image cut along the seam.
+ * @param warped_mask Mask of the whole warped image, which limits the ramp to valid pixels.
+ * @param blend_width Width of the ramp in pixels, centered on the seam.
+ * @param weights Output weights in CV_32F, which are 0.5 on the seam and reach 1 half the width inside the seam mask.
+ */
+void buildBlendWeights(const cv::UMat& seam_mask, const cv::UMat& warped_mask, int blend_width, cv::UMat& weights) {
+  const int half_width = std::max(1, blend_width / 2);
+  // Grow the mask past the seam so that the ramp of each image overlaps the other one
+  cv::UMat grown_mask;
+  cv::dilate(seam_mask, grown_mask,
+             cv::getStructuringElement(cv::MORPH_RECT, cv::Size{2 * half_width + 1, 2 * half_width + 1}));
+  cv::bitwise_and(grown_mask, warped_mask, grown_mask);
+  cv::UMat distance;
+  cv::distanceTransform(grown_mask, distance, cv::DIST_L2, cv::DIST_MASK_3);
+  distance.convertTo(weights, CV_32F, 1. / (2. * half_width));
+  cv::min(weights, 1., weights);
+}
+
+/**
+ * @brief Size an Image message for a stitched image, and wrap its data in a cv::Mat that the image can be written into.
+ * @details The message keeps its buffer between frames, so this only allocates when the size of the image grows.
+ *
+ * @param size Size of the stitched image.
+ * @param type CV_8UC1, or CV_8UC3 with the BGR channel order.
+ * @param message Image message, which gets the mono8 or bgr8 encoding. The header is left as it is.
+ * @return Matrix header that shares the data of the message.
+ */
+cv::Mat wrapImageMessage(const cv::Size& size, int type, spot_ros2::Image& message) {
+  message.height = static_cast<uint32_t>(size.height);
+  message.width = static_cast<uint32_t>(size.width);
+  message.encoding =
+      CV_MAT_CN(type) == 1 ? sensor_msgs::image_encodings::MONO8 : sensor_msgs::image_encodings::BGR8;
+  message.is_bigendian = false;
+  message.step = static_cast<uint32_t>(size.width * CV_ELEM_SIZE(type));
+  message.data.resize(static_cast<size_t>(message.step) * message.height);
+  return cv::Mat{size, type, message.data.data(), message.step};
+}
+
+/**
+ * @brief Find the largest factor that the input images can be downscaled by while still having at least one input
+ * pixel for every pixel of the stitched image.
+ *
+ * @param homographies Homographies from the input images into the stitched image.
+ * @param result_size Size of the stitched image.
+ * @param input_size Size of the input images.
+ * @return The downscaling factor, which is one of the DCT scaling factors 1, 2, 4 or 8 of JPEG decoding.
+ */
+int chooseDecodeScale(const std::vector<cv::Matx33d>& homographies, const cv::Size& result_size,
+                      const cv::Size& input_size) {
+  // Spacing of the sampled stitched pixels, which is dense enough to find the least downscaled part of the images
+  constexpr int kSampleStep = 8;
+  const auto project = [](const cv::Matx33d& inverse, const double col, const double row) {
+    const cv::Vec3d source = inverse * cv::Vec3d{col, row, 1.};
+    return cv::Vec2d{source(0) / source(2), source(1) / source(2)};
+  };
+  double min_step = std::numeric_limits<double>::infinity();
+  for (const auto& homography : homographies) {
+    const cv::Matx33d inverse = homography.inv();
+    for (int row = 0; row < result_size.height; row += kSampleStep) {
+      for (int col = 0; col < result_size.width; col += kSampleStep) {
+        const auto source = project(inverse, col, row);
+        if (source(0) < 0. || source(0) >= input_size.width || source(1) < 0. || source(1) >= input_size.height) {
+          continue;
+        }
+        // Distance between the input pixels of neighboring stitched pixels
+        const double col_step = cv::norm(project(inverse, col + 1, row) - source);
+        const double row_step = cv::norm(project(inverse, col, row + 1) - source);
+        min_step = std::min({min_step, col_step, row_step});
+      }
+    }
+  }
+  int scale = 8;
+  while (scale > 1 && scale > min_step) {
+    scale /= 2;
+  }
+  return scale;
+}
+
 }  // namespace
 
 namespace spot_ros2 {
 
+StitchBlendMode toStitchBlendMode(const std::string& name) {
+  if (name == "multiband") {
+    return StitchBlendMode::kMultiBand;
+  }
+  if (name == "feather") {
+    return StitchBlendMode::kFeather;
+  }
+  throw std::domain_error("Blend mode must be multiband or feather. Got " + name);
+}
+
+sensor_msgs::msg::CameraInfo toCameraInfo(const builtin_interfaces::msg::Time& stamp, const std::string& frame,
+                                          std::size_t width, std::size_t height, const cv::Matx33d& K) {
+  sensor_msgs::msg::CameraInfo info;
+  // Set header with new frame
+  info.header.stamp = stamp;
+  info.header.frame_id = frame;
+  // Set dimensions
+  info.width = width;
+  info.height = height;
+  // Set intrinsics
+  info.k = {                            //
+            K(0, 0), K(0, 1), K(0, 2),  //
+            K(1, 0), K(1, 1), K(1, 2),  //
+            K(2, 0), K(2, 1), K(2, 2)};
+  // Set the projection matrix (P)
+  // P is a 3x4 matrix, so we extend the intrinsic matrix with zeros
+  info.p = {                                 //
+            K(0, 0), K(0, 1), K(0, 2), 0.0,  //
+            K(1, 0), K(1, 1), K(1, 2), 0.0,  //
+            K(2, 0), K(2, 1), K(2, 2), 0.0};
+  // Set the distortion coefficients
+  info.d = std::vector<double>(5, 0.);
+  // Typical distortion model
+  info.distortion_model = "plumb_bob";
+
+  return info;
+}
+
 RclcppCameraSynchronizer::RclcppCameraSynchronizer(const std::shared_ptr<rclcpp::Node>& node) {
   // These topics are remapped onto the actual Spot camera topics in the launch file
-  subscriber_image1_.subscribe(node.get(), "left/image", "raw");
   subscriber_info1_.subscribe(node, "left/camera_info");
-  subscriber_image2_.subscribe(node.get(), "right/image", "raw");
   subscriber_info2_.subscribe(node, "right/camera_info");
+  // Stitching from the compressed images lets the image publisher skip decoding and sending the raw images
+  if (node->declare_parameter("stitched_image_use_compressed", false)) {
+    subscriber_compressed1_.subscribe(node, "left/compressed");
+    subscriber_compressed2_.subscribe(node, "right/compressed");
+    compressed_sync_ = std::make_unique<CompressedSynchronizer>(CompressedApproximateTimePolicy(kHistoryDepth),
+                                                                subscriber_compressed1_, subscriber_info1_,
+                                                                subscriber_compressed2_, subscriber_info2_);
+    return;
+  }
+  subscriber_image1_.subscribe(node.get(), "left/image", "raw");
+  subscriber_image2_.subscribe(node.get(), "right/image", "raw");
 
   sync_ = std::make_unique<Synchronizer>(ApproximateTimePolicy(kHistoryDepth), subscriber_image1_, subscriber_info1_,
                                          subscriber_image2_, subscriber_info2_);
 }
 
 void RclcppCameraSynchronizer::registerCallback(const DualImageCallbackFn& fn) {
+  if (!sync_) {
+    return;
+  }
   // This must be a bind instead of a lambda because of how registerCallback is templated within message_filters.
   sync_->registerCallback(
       std::bind(fn, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
 }
 
+void RclcppCameraSynchronizer::registerCompressedCallback(const DualCompressedImageCallbackFn& fn) {
+  if (!compressed_sync_) {
+    return;
+  }
+  compressed_sync_->registerCallback(
+      std::bind(fn, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
+}
+
 RclcppCameraHandle::RclcppCameraHandle(const std::shared_ptr<rclcpp::Node>& node)
     : image_transport_{node},
       camera_publisher_{
           image_transport_.advertiseCamera("virtual_camera/image", 1)},  // Remap to actual topic in launch file
-      tf_broadcaster_{node} {
+      tf_broadcaster_{node},
+      logger_{node->get_logger()},
+      parameter_handler_{std::make_shared<rclcpp::ParameterEventHandler>(node)} {
   const auto spot_name = node->declare_parameter("spot_name", "");
   const auto frame_prefix = spot_name.empty() ? "" : spot_name + "/";
   // Name of the frame to relate the virtual camera with respect to
@@ -238,6 +411,46 @@ RclcppCameraHandle::RclcppCameraHandle(const std::shared_ptr<rclcpp::Node>& node
   plane_distance_ = node->declare_parameter("virtual_camera_plane_distance", 1.);
   // Amount to increase the size of the stitched image rows from the original camera image rows
   row_padding_ = node->declare_parameter("stitched_image_row_padding", 0);
+  // Number of frames between updates of the gain compensation and seam masks, or 0 to only compute them once
+  seam_update_period_ = std::max(0, static_cast<int>(node->declare_parameter("stitched_image_seam_update_period", 1)));
+  // Method to blend the images along the seam, which falls back to multi-band blending if it is unknown
+  try {
+    blend_mode_ = toStitchBlendMode(node->declare_parameter("stitched_image_blend_mode", "multiband"));
+  } catch (const std::domain_error& e) {
+    RCLCPP_ERROR(node->get_logger(), "Stitched image blend mode parameter could not be parsed. %s", e.what());
+    blend_mode_ = StitchBlendMode::kMultiBand;
+  }
+  // Width of the alpha ramp across the seam in the feather blend mode
+  blend_width_ = std::max(1, static_cast<int>(node->declare_parameter("stitched_image_blend_width", 50)));
+  // Run the stitching pipeline on the GPU through OpenCL, and with CUDA for the multi-band blender if it is available
+  use_gpu_ = node->declare_parameter("stitched_image_use_gpu", true);
+  cv::ocl::setUseOpenCL(use_gpu_);
+  if (use_gpu_ && !cv::ocl::useOpenCL()) {
+    RCLCPP_WARN(node->get_logger(), "No OpenCL device is available, so the stitched image is computed on the CPU.");
+  }
+  // Library to decode the images with when stitching from compressed images, which is shared with the image publisher
+  const auto jpeg_decoder = toJpegDecoderBackend(node->declare_parameter("jpeg_decoder", "opencv"));
+  if (jpeg_decoder.has_value()) {
+    jpeg_decoder_ = jpeg_decoder.value();
+  } else {
+    RCLCPP_ERROR(node->get_logger(), "JPEG decoder parameter could not be parsed. %s", jpeg_decoder.error().c_str());
+    jpeg_decoder_ = JpegDecoderBackend::OPENCV;
+  }
+  // Measure the time spent in each stage of the stitching pipeline, and publish it on /diagnostics once per second
+  publish_timing_diagnostics_ = node->declare_parameter("stitched_image_publish_timing_diagnostics", false);
+  clock_ = node->get_clock();
+  if (publish_timing_diagnostics_) {
+    diagnostics_publisher_ = node->create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+        kDiagnosticsTopic, rclcpp::QoS(rclcpp::KeepLast(kDiagnosticsHistoryDepth)));
+  }
+  // Also publish the stitched image as JPEG, which is encoded with the library selected by jpeg_decoder
+  publish_compressed_ = node->declare_parameter("stitched_image_publish_compressed", false);
+  jpeg_quality_ =
+      std::clamp(static_cast<int>(node->declare_parameter("stitched_image_jpeg_quality", kDefaultJpegQuality)), 1, 100);
+  if (publish_compressed_) {
+    // Remap to actual topic in launch file
+    compressed_publisher_ = node->create_publisher<CompressedImage>("virtual_camera/compressed", rclcpp::QoS(1));
+  }
 }
 
 void RclcppCameraHandle::publish(const Image& image, const CameraInfo& info) const {
@@ -277,20 +490,155 @@ int RclcppCameraHandle::getRowPadding() const {
   return row_padding_;
 }
 
+int RclcppCameraHandle::getSeamUpdatePeriod() const {
+  return seam_update_period_;
+}
+
+StitchBlendMode RclcppCameraHandle::getBlendMode() const {
+  return blend_mode_;
+}
+
+int RclcppCameraHandle::getBlendWidth() const {
+  return blend_width_;
+}
+
+bool RclcppCameraHandle::getUseGpu() const {
+  return use_gpu_;
+}
+
+JpegDecoderBackend RclcppCameraHandle::getJpegDecoder() const {
+  return jpeg_decoder_;
+}
+
+bool RclcppCameraHandle::getPublishTimingDiagnostics() const {
+  return publish_timing_diagnostics_;
+}
+
+void RclcppCameraHandle::publishDiagnostics(const diagnostic_msgs::msg::DiagnosticArray& diagnostics) {
+  if (!diagnostics_publisher_) {
+    return;
+  }
+  auto message = diagnostics;
+  message.header.stamp = clock_->now();
+  diagnostics_publisher_->publish(message);
+}
+
+bool RclcppCameraHandle::getPublishCompressed() const {
+  return publish_compressed_;
+}
+
+int RclcppCameraHandle::getJpegQuality() const {
+  return jpeg_quality_;
+}
+
+void RclcppCameraHandle::publishCompressed(const CompressedImage& image) const {
+  if (compressed_publisher_) {
+    compressed_publisher_->publish(image);
+  }
+}
+
+void RclcppCameraHandle::registerParameterCallback(const ParameterCallbackFn& fn) {
+  for (const auto* name : kDynamicParameters) {
+    parameter_callbacks_.push_back(
+        parameter_handler_->add_parameter_callback(name, [this, fn](const rclcpp::Parameter& parameter) {
+          if (updateParameter(parameter)) {
+            fn();
+          }
+        }));
+  }
+}
+
+bool RclcppCameraHandle::updateParameter(const rclcpp::Parameter& parameter) {
+  const auto& name = parameter.get_name();
+  try {
+    if (name == "virtual_camera_intrinsics") {
+      intrinsics_ = toCvMatx33d(parameter.as_double_array());
+    } else if (name == "virtual_camera_projection_plane") {
+      plane_normal_ = toCvVec3d(parameter.as_double_array());
+    } else if (name == "virtual_camera_plane_distance") {
+      plane_distance_ = parameter.as_double();
+    } else if (name == "stitched_image_row_padding") {
+      row_padding_ = static_cast<int>(parameter.as_int());
+    } else if (name == "stitched_image_seam_update_period") {
+      seam_update_period_ = std::max(0, static_cast<int>(parameter.as_int()));
+    } else if (name == "stitched_image_blend_mode") {
+      blend_mode_ = toStitchBlendMode(parameter.as_string());
+    } else if (name == "stitched_image_blend_width") {
+      blend_width_ = std::max(1, static_cast<int>(parameter.as_int()));
+    } else {
+      return false;
+    }
+  } catch (const std::exception& e) {
+    // Both malformed values and values of the wrong type keep the previous value of the parameter
+    RCLCPP_ERROR(logger_, "Parameter %s could not be updated. %s", name.c_str(), e.what());
+    return false;
+  }
+  return true;
+}
+
+void StitchTimingStatistics::add(const StitchStageDurations& durations) {
+  decode_.add(durations.decode);
+  warp_.add(durations.warp);
+  compensate_.add(durations.compensate);
+  seam_convert_.add(durations.seam_convert);
+  seam_.add(durations.seam);
+  blend_convert_.add(durations.blend_convert);
+  blend_.add(durations.blend);
+  output_.add(durations.output);
+  total_.add(durations.decode + durations.warp + durations.compensate + durations.seam_convert + durations.seam +
+             durations.blend_convert + durations.blend + durations.output);
+}
+
+diagnostic_msgs::msg::DiagnosticStatus StitchTimingStatistics::toDiagnosticStatus(const std::string& name) const {
+  diagnostic_msgs::msg::DiagnosticStatus status;
+  status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+  status.name = name;
+  status.message = std::to_string(total_.count()) + " images";
+  images::addStageValues("decode", decode_, status);
+  images::addStageValues("warp", warp_, status);
+  images::addStageValues("compensate", compensate_, status);
+  images::addStageValues("seam_convert", seam_convert_, status);
+  images::addStageValues("seam", seam_, status);
+  images::addStageValues("blend_convert", blend_convert_, status);
+  images::addStageValues("blend", blend_, status);
+  images::addStageValues("output", output_, status);
+  images::addStageValues("total", total_, status);
+  return status;
+}
+
+void StitchTimingStatistics::clear() {
+  *this = StitchTimingStatistics{};
+}
+
 MiddleCamera::MiddleCamera(const cv::Matx33d& virtual_intrinsics, const cv::Vec3d& plane_normal, double plane_distance,
-                           int row_padding, const Transform& body_tform_left, const Transform& body_tform_right,
+                           int row_padding, int seam_update_period, StitchBlendMode blend_mode, int blend_width,
+                           bool use_gpu, JpegDecoderBackend jpeg_decoder, bool measure_stages,
+                           const Transform& body_tform_left, const Transform& body_tform_right,
                            const CameraInfo& info_left, const CameraInfo& info_right)
     : body_tform_left_{toCvMatx44d(body_tform_left)},
       body_tform_right_{toCvMatx44d(body_tform_right)},
       body_tform_virtual_{middle(toCvMatx44d(body_tform_left), toCvMatx44d(body_tform_right))},
       homography_(2),
+      maps_xy_(2),
+      maps_interpolation_(2),
+      jpeg_decoder_{jpeg_decoder},
+      decoded_images_(2),
+      measure_stages_{measure_stages},
       corners_{cv::Point{0, 0}, cv::Point{0, 0}},
       warped_images_(2),
       warped_images_f_(2),
       warped_images_s_(2),
+      color_images_(2),
+      gain_maps_(2),
       warped_masks_(2),
       level_masks_(2),
-      result_size_{static_cast<int>(info_left.width), static_cast<int>(info_left.height) + row_padding} {
+      seam_masks_(2),
+      seam_update_period_{seam_update_period},
+      blend_mode_{blend_mode},
+      blend_width_{blend_width},
+      blend_weights_(2),
+      result_size_{static_cast<int>(info_left.width), static_cast<int>(info_left.height) + row_padding},
+      blender_{use_gpu} {
   /**
    * The math behind these homography computations for the virtual camera can be found here
    * https://docs.opencv.org/4.x/d9/dab/tutorial_homography.html#tutorial_homography_Demo3
@@ -310,8 +658,12 @@ MiddleCamera::MiddleCamera(const cv::Matx33d& virtual_intrinsics, const cv::Vec3
   homography_[1] =
       computeHomography(virtual_intrinsics, right_intrinsics, right_tform_virtual, plane_distance, plane_normal);
 
-  // Warp white masks the size of the image using their homographies
+  // The homographies are fixed, so the mapping of every output pixel into the input images is only computed once
+  buildMaps(1);
   const cv::Size input_size{static_cast<int>(info_left.width), static_cast<int>(info_left.height)};
+  decode_scale_ = chooseDecodeScale(homography_, result_size_, input_size);
+
+  // Warp white masks the size of the image using their homographies
   for (size_t ndx = 0; ndx < warped_masks_.size(); ++ndx) {
     cv::warpPerspective(cv::UMat{input_size, CV_8U, 255}, warped_masks_[ndx], homography_[ndx], result_size_);
   }
@@ -321,49 +673,210 @@ MiddleCamera::MiddleCamera(const cv::Matx33d& virtual_intrinsics, const cv::Vec3
   }
 }
 
-Image::SharedPtr MiddleCamera::stitch(const std::shared_ptr<const Image>& left,
-                                      const std::shared_ptr<const Image>& right) {
+void MiddleCamera::setBlendOptions(StitchBlendMode blend_mode, int blend_width, int seam_update_period) {
+  blend_mode_ = blend_mode;
+  blend_width_ = blend_width;
+  seam_update_period_ = seam_update_period;
+  // The feather weights are only built with the seams, so the next frame has to update them
+  frame_count_ = 0;
+}
+
+void MiddleCamera::buildMaps(int decode_scale) {
+  if (decode_scale == maps_scale_) {
+    return;
+  }
+  // Maps pixel centers of the downscaled input images onto the pixel centers they cover at full resolution
+  const double scale = decode_scale;
+  const double offset = 0.5 * scale - 0.5;
+  const cv::Matx33d full_tform_scaled{scale, 0., offset, 0., scale, offset, 0., 0., 1.};
+  for (size_t ndx = 0; ndx < homography_.size(); ++ndx) {
+    buildPerspectiveMaps(homography_[ndx] * full_tform_scaled, result_size_, maps_xy_[ndx], maps_interpolation_[ndx]);
+  }
+  maps_scale_ = decode_scale;
+}
+
+const StitchStageDurations& MiddleCamera::getStageDurations() const {
+  return stage_durations_;
+}
+
+double MiddleCamera::finishStage(const char* stage) {
+  // The stages of a frame follow each other, so only their ends are traced.
+  tracing::stageEnd(tracing::kStitcherPipeline, stage);
+  if (!measure_stages_) {
+    return 0.0;
+  }
+  // OpenCL calls return before the device is done, so the work of a stage would otherwise be timed in a later one
+  if (cv::ocl::useOpenCL()) {
+    cv::ocl::finish();
+  }
+  const auto now = std::chrono::steady_clock::now();
+  const auto duration = std::chrono::duration<double>{now - stage_start_}.count();
+  stage_start_ = now;
+  return duration;
+}
+
+Image& MiddleCamera::stitch(const std::shared_ptr<const Image>& left, const std::shared_ptr<const Image>& right) {
   // Convert the images into a format the can be used by opencv.
   // While the image is coming from the camera on the left of the robot, it sees the right side
   // of the scene and vice versa. This may need to be extracted if this code is to be generalized
   // for something other than the Boston Dynamics Spot Robot, as well as checking the homographies.
-  const auto scene_right = cv_bridge::toCvShare(left, sensor_msgs::image_encodings::BGR8);
-  const auto scene_left = cv_bridge::toCvShare(right, sensor_msgs::image_encodings::BGR8);
+  // Greyscale cameras are stitched in mono8, which has a third of the memory traffic of BGR8.
+  stage_durations_ = StitchStageDurations{};
+  stage_start_ = std::chrono::steady_clock::now();
+  const bool mono =
+      sensor_msgs::image_encodings::isMono(left->encoding) && sensor_msgs::image_encodings::isMono(right->encoding);
+  const auto encoding = mono ? sensor_msgs::image_encodings::MONO8 : sensor_msgs::image_encodings::BGR8;
+  const auto scene_right = cv_bridge::toCvShare(left, encoding);
+  const auto scene_left = cv_bridge::toCvShare(right, encoding);
+  buildMaps(1);
+  stage_durations_.decode = finishStage("decode");
+  return stitchScenes(scene_left->image, scene_right->image, mono);
+}
+
+Image& MiddleCamera::stitch(const cv::Mat& left, const cv::Mat& right, bool mono) {
+  // As for messages, the left camera sees the right side of the scene and vice versa
+  stage_durations_ = StitchStageDurations{};
+  stage_start_ = std::chrono::steady_clock::now();
+  buildMaps(1);
+  stage_durations_.decode = finishStage("decode");
+  return stitchScenes(right, left, mono);
+}
 
+tl::expected<std::reference_wrapper<Image>, std::string> MiddleCamera::stitch(
+    const std::shared_ptr<const CompressedImage>& left, const std::shared_ptr<const CompressedImage>& right) {
+  // As for raw images, the left camera sees the right side of the scene and vice versa
+  const std::vector<std::shared_ptr<const CompressedImage>> scenes{right, left};
+  stage_durations_ = StitchStageDurations{};
+  stage_start_ = std::chrono::steady_clock::now();
+  bool mono = true;
+  for (const auto& scene : scenes) {
+    const auto greyscale =
+        isGreyscaleJpeg(std::string_view{reinterpret_cast<const char*>(scene->data.data()), scene->data.size()});
+    if (!greyscale) {
+      return tl::make_unexpected(greyscale.error());
+    }
+    mono = mono && greyscale.value();
+  }
+  // The stitched image has a lower resolution than the inputs, so the images are decoded straight to the resolution
+  // that it needs
+  std::vector<cv::Mat> decoded;
+  for (size_t ndx = 0; ndx < scenes.size(); ++ndx) {
+    const auto& data = scenes[ndx]->data;
+    const auto result = decodeJpeg(std::string_view{reinterpret_cast<const char*>(data.data()), data.size()}, mono,
+                                   decode_scale_, jpeg_decoder_, decoded_images_[ndx]);
+    if (!result) {
+      return tl::make_unexpected(result.error());
+    }
+    auto& image = decoded_images_[ndx];
+    decoded.emplace_back(static_cast<int>(image.height), static_cast<int>(image.width), mono ? CV_8UC1 : CV_8UC3,
+                         image.data.data(), image.step);
+  }
+  buildMaps(decode_scale_);
+  stage_durations_.decode = finishStage("decode");
+  return stitchScenes(decoded[0], decoded[1], mono);
+}
+
+Image& MiddleCamera::stitchScenes(const cv::Mat& scene_left, const cv::Mat& scene_right, bool mono) {
   // Transform the images into the virtual center camera space
-  cv::warpPerspective(scene_left->image, warped_images_[0], homography_[0], result_size_);
-  cv::warpPerspective(scene_right->image, warped_images_[1], homography_[1], result_size_);
+  cv::remap(scene_left, warped_images_[0], maps_xy_[0], maps_interpolation_[0], cv::INTER_LINEAR);
+  cv::remap(scene_right, warped_images_[1], maps_xy_[1], maps_interpolation_[1], cv::INTER_LINEAR);
+  stage_durations_.warp = finishStage("warp");
+
+  // The cameras are rigidly mounted, so the gains and seam only change with the scene and can be reused between updates
+  const auto period = static_cast<std::size_t>(seam_update_period_);
+  const bool update_seams = frame_count_ == 0 || (period > 0 && frame_count_ % period == 0);
+  ++frame_count_;
+
+  // The compensator and seam finder only take BGR images, so greyscale images are only expanded when they are updated
+  if (update_seams && mono) {
+    for (size_t ndx = 0; ndx < warped_images_.size(); ndx++) {
+      cv::cvtColor(warped_images_[ndx], color_images_[ndx], cv::COLOR_GRAY2BGR);
+    }
+  }
+  const auto& update_images = mono ? color_images_ : warped_images_;
 
   // Color compensate the images so they blend better
-  compensator_.feed(corners_, warped_images_, level_masks_);
+  if (update_seams) {
+    compensator_.feed(corners_, update_images, level_masks_);
+    if (mono) {
+      // Keep the gain maps at full resolution to apply them to the greyscale images
+      std::vector<cv::Mat> gains;
+      compensator_.getMatGains(gains);
+      for (size_t ndx = 0; ndx < gains.size(); ndx++) {
+        cv::resize(gains[ndx], gain_maps_[ndx], result_size_, 0, 0, cv::INTER_LINEAR);
+      }
+    }
+  }
   for (size_t ndx = 0; ndx < warped_images_.size(); ndx++) {
-    compensator_.apply(ndx, corners_[ndx], warped_images_[ndx], warped_masks_);
+    if (mono) {
+      cv::multiply(warped_images_[ndx], gain_maps_[ndx], warped_images_[ndx], 1, CV_8U);
+    } else {
+      compensator_.apply(ndx, corners_[ndx], warped_images_[ndx], warped_masks_);
+    }
   }
+  stage_durations_.compensate = finishStage("compensate");
 
   // Create seam masks for the two images to find the best path to blend them
-  // Convert images to a different colorspace for seaming
-  for (size_t ndx = 0; ndx < warped_images_.size(); ndx++) {
-    warped_images_[ndx].convertTo(warped_images_f_[ndx], CV_32F);
+  if (update_seams) {
+    // Convert images to a different colorspace for seaming
+    for (size_t ndx = 0; ndx < warped_images_.size(); ndx++) {
+      update_images[ndx].convertTo(warped_images_f_[ndx], CV_32F);
+      // The seam finder cuts the masks in place, so it starts from the full warped masks every update
+      warped_masks_[ndx].copyTo(seam_masks_[ndx]);
+    }
+    stage_durations_.seam_convert = finishStage("seam_convert");
+    // Find optimal seams to cut at
+    seamer_.find(warped_images_f_, corners_, seam_masks_);
+    if (blend_mode_ == StitchBlendMode::kFeather) {
+      for (size_t ndx = 0; ndx < seam_masks_.size(); ndx++) {
+        buildBlendWeights(seam_masks_[ndx], warped_masks_[ndx], blend_width_, blend_weights_[ndx]);
+      }
+    }
+    stage_durations_.seam = finishStage("seam");
+  }
+
+  if (blend_mode_ == StitchBlendMode::kFeather) {
+    // Mix the images with the cached alpha ramps, which works directly on the mono8 or BGR images
+    cv::blendLinear(warped_images_[0], warped_images_[1], blend_weights_[0], blend_weights_[1], result_);
+    stage_durations_.blend = finishStage("blend");
+    // Download the result straight into the message that is published
+    auto destination = wrapImageMessage(result_size_, result_.type(), result_message_);
+    result_.copyTo(destination);
+    stage_durations_.output = finishStage("output");
+    return result_message_;
   }
-  // Find optimal seams to cut at
-  seamer_.find(warped_images_f_, corners_, warped_masks_);
 
   // Blend the images together around the seam
   // Tell the blender to consider the whole warped image for blending
   blender_.prepare(cv::Rect{cv::Point{0, 0}, result_size_});
-  // Convert images to a different colorspace for blending
+  // Convert images to a different colorspace for blending. The blender only takes three channels, so greyscale images
+  // are expanded here and the result is converted back to greyscale.
   for (size_t ndx = 0; ndx < warped_images_.size(); ndx++) {
-    warped_images_[ndx].convertTo(warped_images_s_[ndx], CV_16S);
+    if (mono) {
+      cv::cvtColor(warped_images_[ndx], color_images_[ndx], cv::COLOR_GRAY2BGR);
+      color_images_[ndx].convertTo(warped_images_s_[ndx], CV_16S);
+    } else {
+      warped_images_[ndx].convertTo(warped_images_s_[ndx], CV_16S);
+    }
   }
+  stage_durations_.blend_convert = finishStage("blend_convert");
   // Feed the warped images and their masks to the blender
-  blender_.feed(warped_images_s_[0], warped_masks_[0], cv::Point{0, 0});
-  blender_.feed(warped_images_s_[1], warped_masks_[1], cv::Point{0, 0});
+  blender_.feed(warped_images_s_[0], seam_masks_[0], cv::Point{0, 0});
+  blender_.feed(warped_images_s_[1], seam_masks_[1], cv::Point{0, 0});
   blender_.blend(result_, blend_mask_);
+  stage_durations_.blend = finishStage("blend");
 
-  // Convert the image back to the BGR color space
-  result_.convertTo(result_, CV_8U);
-  // Return the image in a format that can be published
-  return cv_bridge::CvImage(std_msgs::msg::Header{}, "bgr8", result_.getMat(cv::ACCESS_READ)).toImageMsg();
+  // Convert the image back to 8 bits, straight into the message that is published
+  if (mono) {
+    result_.convertTo(result_color_, CV_8U);
+    auto destination = wrapImageMessage(result_size_, CV_8UC1, result_message_);
+    cv::cvtColor(result_color_, destination, cv::COLOR_BGR2GRAY);
+  } else {
+    auto destination = wrapImageMessage(result_size_, CV_8UC3, result_message_);
+    result_.convertTo(destination, CV_8U);
+  }
+  stage_durations_.output = finishStage("output");
+  return result_message_;
 }
 
 Transform MiddleCamera::getTransform() {
@@ -375,64 +888,247 @@ Transform MiddleCamera::getTransform() {
 ImageStitcher::ImageStitcher(std::unique_ptr<CameraSynchronizerBase> synchronizer,
                              std::unique_ptr<TfListenerInterfaceBase> tf_listener,
                              std::unique_ptr<CameraHandleBase> camera_handle,
-                             std::unique_ptr<LoggerInterfaceBase> logger)
+                             std::unique_ptr<LoggerInterfaceBase> logger,
+                             std::shared_ptr<ThreadPoolInterfaceBase> thread_pool)
     : synchronizer_{std::move(synchronizer)},
       tf_listener_{std::move(tf_listener)},
       camera_handle_{std::move(camera_handle)},
-      logger_{std::move(logger)} {
+      logger_{std::move(logger)},
+      thread_pool_{std::move(thread_pool)} {
   synchronizer_->registerCallback(
       [this](const std::shared_ptr<const Image>& image_left, const std::shared_ptr<const CameraInfo>& info_left,
              const std::shared_ptr<const Image>& image_right, const std::shared_ptr<const CameraInfo>& info_right) {
         callback(image_left, info_left, image_right, info_right);
       });
+  synchronizer_->registerCompressedCallback(
+      [this](const std::shared_ptr<const CompressedImage>& image_left,
+             const std::shared_ptr<const CameraInfo>& info_left,
+             const std::shared_ptr<const CompressedImage>& image_right,
+             const std::shared_ptr<const CameraInfo>& info_right) {
+        compressedCallback(image_left, info_left, image_right, info_right);
+      });
+  camera_handle_->registerParameterCallback([this]() {
+    parameters_changed_ = true;
+  });
+}
+
+ImageStitcher::~ImageStitcher() {
+  if (pending_camera_.valid()) {
+    pending_camera_.wait();
+  }
+  if (pending_encode_.valid()) {
+    pending_encode_.wait();
+  }
 }
 
 void ImageStitcher::callback(const std::shared_ptr<const Image>& image_left,
                              const std::shared_ptr<const CameraInfo>& info_left,
                              const std::shared_ptr<const Image>& image_right,
                              const std::shared_ptr<const CameraInfo>& info_right) {
-  // The transforms and camera info are assumed to be static, so we only need to lookup these
-  // things once, and use them to initialize the stitching camera. It cannot stitch without these
-  // parameters so if we can't get them we have to exit the callback.
-  if (!camera_.has_value()) {
-    const auto body_frame = camera_handle_->getBodyFrame();
-    const auto body_tform_left =
-        tf_listener_->lookupTransform(info_left->header.frame_id, body_frame, info_left->header.stamp);
-    const auto body_tform_right =
-        tf_listener_->lookupTransform(info_right->header.frame_id, body_frame, info_right->header.stamp);
-    if (!body_tform_left || !body_tform_right) {
-      if (!body_tform_left) {
-        logger_->logWarn("Valid transform for image frame " + info_left->header.frame_id + " to " + body_frame +
-                         " could not be found");
-      }
-      if (!body_tform_right) {
-        logger_->logWarn("Valid transform for image frame " + info_right->header.frame_id + " to " + body_frame +
-                         " could not be found");
-      }
-      return;
+  if (!initializeCamera(*info_left, *info_right)) {
+    return;
+  }
+  // The rest of the time we should just be stitching and publishing
+  const auto trace_id = toTraceId(info_left->header.stamp);
+  tracing::stageBegin(tracing::kStitcherPipeline, "stitch", "", trace_id);
+  auto& image_stitched = camera_->stitch(image_left, image_right);
+  tracing::stageEnd(tracing::kStitcherPipeline, "stitch", "", trace_id);
+  publishStitched(image_stitched, info_left->header.stamp);
+}
+
+void ImageStitcher::compressedCallback(const std::shared_ptr<const CompressedImage>& image_left,
+                                       const std::shared_ptr<const CameraInfo>& info_left,
+                                       const std::shared_ptr<const CompressedImage>& image_right,
+                                       const std::shared_ptr<const CameraInfo>& info_right) {
+  if (!initializeCamera(*info_left, *info_right)) {
+    return;
+  }
+  const auto trace_id = toTraceId(info_left->header.stamp);
+  tracing::stageBegin(tracing::kStitcherPipeline, "stitch", "", trace_id);
+  const auto image_stitched = camera_->stitch(image_left, image_right);
+  tracing::stageEnd(tracing::kStitcherPipeline, "stitch", "", trace_id);
+  if (!image_stitched) {
+    logger_->logWarn("Compressed images could not be stitched: " + image_stitched.error());
+    return;
+  }
+  publishStitched(image_stitched.value(), info_left->header.stamp);
+}
+
+bool ImageStitcher::initializeCamera(const CameraInfo& info_left, const CameraInfo& info_right) {
+  // The transforms are assumed to be static, so they are only looked up when the camera is built. It cannot stitch
+  // without them, so if we can't get them we have to exit the callback.
+  if (!camera_) {
+    const auto config = getCameraConfig(info_left, info_right);
+    camera_ = buildCamera(config);
+    if (!camera_) {
+      return false;
     }
-    // Build the stitching camera
-    camera_ = MiddleCamera{camera_handle_->getIntrinsics(),
-                           camera_handle_->getPlaneNormal(),
-                           camera_handle_->getPlaneDistance(),
-                           camera_handle_->getRowPadding(),
-                           body_tform_left->transform,
-                           body_tform_right->transform,
-                           *info_left,
-                           *info_right};
+    camera_config_ = config;
     // Virtual camera transform only has to be broadcast once since it is static wrt the body
-    camera_handle_->broadcast(camera_->getTransform(), info_left->header.stamp);
+    camera_handle_->broadcast(camera_->getTransform(), info_left.header.stamp);
+    return true;
+  }
+
+  // Swap in a rebuilt camera between two frames, so the stitched stream never waits for a rebuild
+  if (pending_camera_.valid() && pending_camera_.wait_for(std::chrono::seconds{0}) == std::future_status::ready) {
+    if (auto camera = pending_camera_.get(); camera) {
+      camera_ = std::move(camera);
+      // The intrinsics of the stitched image may have changed without changing its size
+      info_stitched_ = CameraInfo{};
+      // Parameters that changed during the rebuild still have to be applied to the new camera
+      parameters_changed_ = true;
+    } else {
+      // The transforms could not be looked up, so the rebuild is retried on the next frame
+      camera_config_.reset();
+    }
+  }
+
+  // Blending parameters only change how the warped images are mixed, so they are applied without a rebuild
+  if (parameters_changed_.exchange(false)) {
+    camera_->setBlendOptions(camera_handle_->getBlendMode(), camera_handle_->getBlendWidth(),
+                             camera_handle_->getSeamUpdatePeriod());
+  }
+
+  // The homographies and remap tables depend on the virtual camera and the intrinsics of both cameras, so a change of
+  // any of them rebuilds the camera in the background while the current one keeps stitching
+  const auto same_info = [](const CameraInfo& lhs, const CameraInfo& rhs) {
+    return lhs.width == rhs.width && lhs.height == rhs.height && lhs.k == rhs.k;
+  };
+  const bool same_geometry = camera_config_.has_value() &&
+                             camera_handle_->getIntrinsics() == camera_config_->intrinsics &&
+                             camera_handle_->getPlaneNormal() == camera_config_->plane_normal &&
+                             camera_handle_->getPlaneDistance() == camera_config_->plane_distance &&
+                             camera_handle_->getRowPadding() == camera_config_->row_padding &&
+                             same_info(info_left, camera_config_->info_left) &&
+                             same_info(info_right, camera_config_->info_right);
+  if (!same_geometry && !pending_camera_.valid()) {
+    logger_->logInfo("Virtual camera parameters or camera intrinsics changed, rebuilding the stitching camera.");
+    camera_config_ = getCameraConfig(info_left, info_right);
+    auto camera = std::make_shared<std::promise<std::unique_ptr<MiddleCamera>>>();
+    pending_camera_ = camera->get_future();
+    thread_pool_->post([this, config = camera_config_.value(), camera]() {
+      try {
+        camera->set_value(buildCamera(config));
+      } catch (...) {
+        camera->set_exception(std::current_exception());
+      }
+    });
+  }
+  return true;
+}
+
+ImageStitcher::CameraConfig ImageStitcher::getCameraConfig(const CameraInfo& info_left,
+                                                           const CameraInfo& info_right) const {
+  return CameraConfig{camera_handle_->getBodyFrame(),
+                      camera_handle_->getIntrinsics(),
+                      camera_handle_->getPlaneNormal(),
+                      camera_handle_->getPlaneDistance(),
+                      camera_handle_->getRowPadding(),
+                      camera_handle_->getSeamUpdatePeriod(),
+                      camera_handle_->getBlendMode(),
+                      camera_handle_->getBlendWidth(),
+                      camera_handle_->getUseGpu(),
+                      camera_handle_->getJpegDecoder(),
+                      camera_handle_->getPublishTimingDiagnostics(),
+                      info_left,
+                      info_right};
+}
+
+std::unique_ptr<MiddleCamera> ImageStitcher::buildCamera(const CameraConfig& config) const {
+  const auto& info_left = config.info_left;
+  const auto& info_right = config.info_right;
+  const auto body_tform_left =
+      tf_listener_->lookupTransform(info_left.header.frame_id, config.body_frame, info_left.header.stamp);
+  const auto body_tform_right =
+      tf_listener_->lookupTransform(info_right.header.frame_id, config.body_frame, info_right.header.stamp);
+  if (!body_tform_left || !body_tform_right) {
+    if (!body_tform_left) {
+      logger_->logWarn("Valid transform for image frame " + info_left.header.frame_id + " to " + config.body_frame +
+                       " could not be found");
+    }
+    if (!body_tform_right) {
+      logger_->logWarn("Valid transform for image frame " + info_right.header.frame_id + " to " + config.body_frame +
+                       " could not be found");
+    }
+    return nullptr;
   }
-  const auto& current_stamp = info_left->header.stamp;
+  // Whether OpenCL is used is set per thread, so a camera that is built in the background has to set it again
+  cv::ocl::setUseOpenCL(config.use_gpu);
+  // Build the stitching camera
+  auto camera = std::make_unique<MiddleCamera>(config.intrinsics, config.plane_normal, config.plane_distance,
+                                               config.row_padding, config.seam_update_period, config.blend_mode,
+                                               config.blend_width, config.use_gpu, config.jpeg_decoder,
+                                               config.measure_stages, body_tform_left->transform,
+                                               body_tform_right->transform, info_left, info_right);
+  // The maps are written on the OpenCL queue of this thread, so they have to be done before another thread reads them
+  if (cv::ocl::useOpenCL()) {
+    cv::ocl::finish();
+  }
+  return camera;
+}
+
+void ImageStitcher::publishStitched(Image& image_stitched, const Time& stamp) {
+  const tracing::ScopedStage trace{tracing::kStitcherPipeline, "publish", "", toTraceId(stamp)};
   const auto& camera_frame = camera_handle_->getCameraFrame();
-  // The rest of the time we should just be stitching and publishing
-  const auto image_stitched = camera_->stitch(image_left, image_right);
-  image_stitched->header.stamp = current_stamp;
-  image_stitched->header.frame_id = camera_frame;
-  // The only reason we have to remake this every time is to update the time stamp
-  const auto info_stitched = toCameraInfo(current_stamp, camera_frame, image_stitched->width, image_stitched->height,
-                                          camera_handle_->getIntrinsics());
-  camera_handle_->publish(*image_stitched, info_stitched);
+  image_stitched.header.stamp = stamp;
+  image_stitched.header.frame_id = camera_frame;
+  // The camera info only has to be rebuilt if the size of the stitched image changes, otherwise it is just restamped
+  if (info_stitched_.width != image_stitched.width || info_stitched_.height != image_stitched.height) {
+    info_stitched_ =
+        toCameraInfo(stamp, camera_frame, image_stitched.width, image_stitched.height, camera_handle_->getIntrinsics());
+  }
+  info_stitched_.header.stamp = stamp;
+  // Both messages are published by reference. Without intra-process subscribers they are serialized straight from the
+  // reused messages, so publishing does not allocate a copy of the image.
+  camera_handle_->publish(image_stitched, info_stitched_);
+  if (camera_handle_->getPublishCompressed()) {
+    encodeStitched(image_stitched);
+  }
+  if (camera_handle_->getPublishTimingDiagnostics()) {
+    recordTimings();
+  }
+}
+
+void ImageStitcher::encodeStitched(const Image& image_stitched) {
+  // Encoding usually takes less time than stitching, so the previous frame is already done by now
+  if (pending_encode_.valid()) {
+    pending_encode_.get();
+  }
+  // The stitched image is overwritten by the next frame, so it is copied into a buffer that keeps its capacity. The
+  // copy is much cheaper than the encoding that it takes off the stitching thread.
+  encode_input_ = image_stitched;
+  const auto quality = camera_handle_->getJpegQuality();
+  const auto backend = camera_handle_->getJpegDecoder();
+  auto encoded = std::make_shared<std::promise<void>>();
+  pending_encode_ = encoded->get_future();
+  thread_pool_->post([this, quality, backend, encoded]() {
+    try {
+      if (const auto result = encodeJpeg(encode_input_, quality, backend, encode_output_); result) {
+        camera_handle_->publishCompressed(encode_output_);
+      } else {
+        logger_->logWarn("Stitched image could not be encoded: " + result.error());
+      }
+      encoded->set_value();
+    } catch (...) {
+      encoded->set_exception(std::current_exception());
+    }
+  });
+}
+
+void ImageStitcher::recordTimings() {
+  timing_statistics_.add(camera_->getStageDurations());
+
+  const auto now = std::chrono::steady_clock::now();
+  if (now - last_timing_report_ < kTimingReportPeriod) {
+    return;
+  }
+  last_timing_report_ = now;
+
+  diagnostic_msgs::msg::DiagnosticArray diagnostics;
+  diagnostics.status.push_back(
+      timing_statistics_.toDiagnosticStatus(kTimingDiagnosticsNamePrefix + camera_handle_->getCameraFrame()));
+  timing_statistics_.clear();
+  camera_handle_->publishDiagnostics(diagnostics);
 }
 
 }  // namespace spot_ros2
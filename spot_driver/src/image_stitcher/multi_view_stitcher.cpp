@@ -0,0 +1,227 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/image_stitcher/multi_view_stitcher.hpp>
+
+#include <cv_bridge/cv_bridge.h>
+#include <algorithm>
+#include <iterator>
+#include <opencv2/core/ocl.hpp>
+#include <sensor_msgs/image_encodings.hpp>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+constexpr auto kDefaultMaxStitchThreads = 4;
+const std::vector<double> kIdentityIntrinsics{1., 0., 0., 0., 1., 0., 0., 0., 1.};
+}  // namespace
+
+namespace spot_ros2 {
+
+std::vector<std::string> getInputCameras(const std::vector<VirtualViewOptions>& views) {
+  std::vector<std::string> cameras;
+  for (const auto& view : views) {
+    for (const auto& camera : {view.left_camera, view.right_camera}) {
+      if (std::find(cameras.cbegin(), cameras.cend(), camera) == cameras.cend()) {
+        cameras.push_back(camera);
+      }
+    }
+  }
+  return cameras;
+}
+
+RclcppMultiViewCameraHandle::RclcppMultiViewCameraHandle(const std::shared_ptr<rclcpp::Node>& node)
+    : image_transport_{node}, tf_broadcaster_{node} {
+  const auto spot_name = node->declare_parameter("spot_name", "");
+  const auto frame_prefix = spot_name.empty() ? "" : spot_name + "/";
+  // Name of the frame to relate the virtual cameras with respect to
+  const auto body_frame = frame_prefix + node->declare_parameter("body_frame", "body");
+  // Number of views that are warped and blended at the same time
+  max_stitch_threads_ = static_cast<std::size_t>(
+      std::max(1, static_cast<int>(node->declare_parameter("max_stitch_threads", kDefaultMaxStitchThreads))));
+  // Run the stitching pipeline on the GPU through OpenCL, which applies to all views
+  use_gpu_ = node->declare_parameter("stitched_image_use_gpu", true);
+  cv::ocl::setUseOpenCL(use_gpu_);
+  if (use_gpu_ && !cv::ocl::useOpenCL()) {
+    RCLCPP_WARN(node->get_logger(), "No OpenCL device is available, so the stitched images are computed on the CPU.");
+  }
+
+  const auto view_names =
+      node->declare_parameter("virtual_views", std::vector<std::string>{"frontmiddle_virtual"});
+  for (const auto& name : view_names) {
+    VirtualViewOptions view;
+    view.name = name;
+    view.left_camera = node->declare_parameter(name + ".left_camera", "frontleft");
+    view.right_camera = node->declare_parameter(name + ".right_camera", "frontright");
+    auto& camera = view.camera;
+    camera.body_frame = body_frame;
+    camera.camera_frame = frame_prefix + node->declare_parameter(name + ".virtual_camera_frame", name);
+    // The virtual camera parameters could have the wrong number of values, in which case the view is not stitched
+    const auto intrinsics = node->declare_parameter(name + ".virtual_camera_intrinsics", kIdentityIntrinsics);
+    const auto plane_normal =
+        node->declare_parameter(name + ".virtual_camera_projection_plane", std::vector<double>{0., 0., 1.});
+    if (intrinsics.size() != 9 || plane_normal.size() != 3) {
+      RCLCPP_ERROR(node->get_logger(),
+                   "Virtual camera parameters of view %s could not be parsed. The intrinsics need 9 values and the "
+                   "projection plane 3 values. Not stitching the view.",
+                   name.c_str());
+      continue;
+    }
+    camera.intrinsics = cv::Matx33d(intrinsics.data());
+    camera.plane_normal = cv::Vec3d(plane_normal.data());
+    camera.plane_distance = node->declare_parameter(name + ".virtual_camera_plane_distance", 1.);
+    camera.row_padding = static_cast<int>(node->declare_parameter(name + ".stitched_image_row_padding", 0));
+    camera.seam_update_period =
+        std::max(0, static_cast<int>(node->declare_parameter(name + ".stitched_image_seam_update_period", 1)));
+    try {
+      camera.blend_mode = toStitchBlendMode(node->declare_parameter(name + ".stitched_image_blend_mode", "multiband"));
+    } catch (const std::domain_error& e) {
+      RCLCPP_ERROR(node->get_logger(), "Blend mode of view %s could not be parsed. %s", name.c_str(), e.what());
+      camera.blend_mode = StitchBlendMode::kMultiBand;
+    }
+    camera.blend_width =
+        std::max(1, static_cast<int>(node->declare_parameter(name + ".stitched_image_blend_width", 50)));
+    camera.use_gpu = use_gpu_;
+    camera_publishers_.push_back(image_transport_.advertiseCamera("camera/" + name + "/image", 1));
+    views_.push_back(std::move(view));
+  }
+}
+
+std::vector<VirtualViewOptions> RclcppMultiViewCameraHandle::getViews() const {
+  return views_;
+}
+
+std::size_t RclcppMultiViewCameraHandle::getMaxStitchThreads() const {
+  return max_stitch_threads_;
+}
+
+bool RclcppMultiViewCameraHandle::getUseGpu() const {
+  return use_gpu_;
+}
+
+void RclcppMultiViewCameraHandle::publish(std::size_t view, const Image& image, const CameraInfo& info) {
+  camera_publishers_[view].publish(image, info);
+}
+
+void RclcppMultiViewCameraHandle::broadcast(const std::vector<geometry_msgs::msg::TransformStamped>& transforms) {
+  tf_broadcaster_.updateStaticTransforms(transforms);
+}
+
+MultiViewStitcher::MultiViewStitcher(std::unique_ptr<MultiCameraSynchronizerBase> synchronizer,
+                                     std::unique_ptr<TfListenerInterfaceBase> tf_listener,
+                                     std::unique_ptr<MultiViewCameraHandleBase> camera_handle,
+                                     std::unique_ptr<LoggerInterfaceBase> logger,
+                                     std::shared_ptr<ThreadPoolInterfaceBase> thread_pool)
+    : synchronizer_{std::move(synchronizer)},
+      tf_listener_{std::move(tf_listener)},
+      camera_handle_{std::move(camera_handle)},
+      logger_{std::move(logger)},
+      thread_pool_{std::move(thread_pool)},
+      max_stitch_threads_{camera_handle_->getMaxStitchThreads()},
+      use_gpu_{camera_handle_->getUseGpu()} {
+  // The synchronizer calls back with the images of the input cameras in the order of getInputCameras()
+  const auto views = camera_handle_->getViews();
+  const auto cameras = getInputCameras(views);
+  const auto index_of = [&cameras](const std::string& camera) {
+    const auto found = std::find(cameras.cbegin(), cameras.cend(), camera);
+    return static_cast<std::size_t>(std::distance(cameras.cbegin(), found));
+  };
+  for (const auto& options : views) {
+    views_.push_back(
+        View{options, index_of(options.left_camera), index_of(options.right_camera), nullptr, nullptr, {}});
+  }
+  synchronizer_->registerCallback([this](const std::vector<std::shared_ptr<const Image>>& images,
+                                         const std::vector<std::shared_ptr<const CameraInfo>>& infos) {
+    callback(images, infos);
+  });
+}
+
+MultiViewStitcher::~MultiViewStitcher() = default;
+
+bool MultiViewStitcher::initializeCameras(const std::vector<std::shared_ptr<const CameraInfo>>& infos) {
+  // As for the single stitcher, the transforms and camera info are assumed to be static, so they are only looked up
+  // once. Every input camera is looked up once, even if several views use it.
+  std::vector<Transform> body_tform_cameras;
+  for (const auto& info : infos) {
+    const auto& body_frame = views_.front().options.camera.body_frame;
+    const auto body_tform_camera = tf_listener_->lookupTransform(info->header.frame_id, body_frame, info->header.stamp);
+    if (!body_tform_camera) {
+      logger_->logWarn("Valid transform for image frame " + info->header.frame_id + " to " + body_frame +
+                       " could not be found");
+      return false;
+    }
+    body_tform_cameras.push_back(body_tform_camera->transform);
+  }
+
+  std::vector<geometry_msgs::msg::TransformStamped> virtual_transforms;
+  for (auto& view : views_) {
+    const auto& options = view.options.camera;
+    view.camera = std::make_unique<MiddleCamera>(
+        options.intrinsics, options.plane_normal, options.plane_distance, options.row_padding,
+        options.seam_update_period, options.blend_mode, options.blend_width, options.use_gpu,
+        JpegDecoderBackend::OPENCV, false, body_tform_cameras[view.left], body_tform_cameras[view.right],
+        *infos[view.left], *infos[view.right]);
+    auto& transform = virtual_transforms.emplace_back();
+    transform.header.stamp = infos[view.left]->header.stamp;
+    transform.header.frame_id = options.body_frame;
+    transform.child_frame_id = options.camera_frame;
+    transform.transform = view.camera->getTransform();
+  }
+  // The virtual camera transforms only have to be broadcast once since they are static wrt the body
+  camera_handle_->broadcast(virtual_transforms);
+  return true;
+}
+
+void MultiViewStitcher::callback(const std::vector<std::shared_ptr<const Image>>& images,
+                                 const std::vector<std::shared_ptr<const CameraInfo>>& infos) {
+  if (views_.empty()) {
+    return;
+  }
+  if (!cameras_initialized_) {
+    cameras_initialized_ = initializeCameras(infos);
+    if (!cameras_initialized_) {
+      return;
+    }
+  }
+
+  // Every input camera is converted once and shared by all views that use it. Greyscale cameras are stitched in mono8,
+  // which has a third of the memory traffic of BGR8.
+  const bool mono = std::all_of(images.cbegin(), images.cend(), [](const auto& image) {
+    return sensor_msgs::image_encodings::isMono(image->encoding);
+  });
+  const auto encoding = mono ? sensor_msgs::image_encodings::MONO8 : sensor_msgs::image_encodings::BGR8;
+  std::vector<cv_bridge::CvImageConstPtr> converted;
+  std::vector<cv::Mat> scenes;
+  converted.reserve(images.size());
+  scenes.reserve(images.size());
+  for (const auto& image : images) {
+    converted.push_back(cv_bridge::toCvShare(image, encoding));
+    scenes.push_back(converted.back()->image);
+  }
+
+  const auto& stamp = infos.front()->header.stamp;
+  // Every view only writes to its own camera and buffers, so no further locking is needed
+  thread_pool_->parallelFor(views_.size(), max_stitch_threads_, [&](const std::size_t view) {
+    // Whether OpenCL is used is set per thread, and the views may run on any thread of the pool
+    cv::ocl::setUseOpenCL(use_gpu_);
+    stitchView(views_[view], scenes, mono, stamp);
+  });
+
+  for (std::size_t view = 0; view < views_.size(); ++view) {
+    camera_handle_->publish(view, *views_[view].image, views_[view].info);
+  }
+}
+
+void MultiViewStitcher::stitchView(View& view, const std::vector<cv::Mat>& scenes, bool mono, const Time& stamp) {
+  const auto& options = view.options.camera;
+  auto& image = view.camera->stitch(scenes[view.left], scenes[view.right], mono);
+  image.header.stamp = stamp;
+  image.header.frame_id = options.camera_frame;
+  // The camera info only has to be rebuilt if the size of the stitched image changes, otherwise it is just restamped
+  if (view.info.width != image.width || view.info.height != image.height) {
+    view.info = toCameraInfo(stamp, options.camera_frame, image.width, image.height, options.intrinsics);
+  }
+  view.info.header.stamp = stamp;
+  view.image = &image;
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,32 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/image_stitcher/multi_view_stitcher_node.hpp>
+
+#include <rclcpp/duration.hpp>
+#include <rclcpp/node.hpp>
+#include <spot_driver/interfaces/rclcpp_logger_interface.hpp>
+#include <spot_driver/interfaces/rclcpp_tf_listener_interface.hpp>
+#include <spot_driver/interfaces/work_stealing_thread_pool.hpp>
+
+#include <utility>
+
+namespace spot_ros2 {
+MultiViewStitcherNode::MultiViewStitcherNode(const rclcpp::NodeOptions& options)
+    : node_{std::make_shared<rclcpp::Node>("multi_view_stitcher", options)} {
+  // The views are read first, since they decide which cameras have to be subscribed to
+  auto camera_handle = std::make_unique<RclcppMultiViewCameraHandle>(node_);
+  const auto max_time_difference = rclcpp::Duration::from_seconds(node_->declare_parameter("max_time_difference", 0.1));
+  auto synchronizer = std::make_unique<RclcppMultiCameraSynchronizer>(
+      node_, getInputCameras(camera_handle->getViews()), max_time_difference);
+  stitcher_ = std::make_unique<MultiViewStitcher>(std::move(synchronizer),
+                                                  std::make_unique<RclcppTfListenerInterface>(node_),
+                                                  std::move(camera_handle),
+                                                  std::make_unique<RclcppLoggerInterface>(node_->get_logger()),
+                                                  getSharedThreadPool());
+}
+
+std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> MultiViewStitcherNode::get_node_base_interface() {
+  return node_->get_node_base_interface();
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,13 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <rclcpp/node_options.hpp>
+#include <rclcpp/utilities.hpp>
+#include <spot_driver/image_stitcher/multi_view_stitcher_node.hpp>
+#include <spot_driver/interfaces/rclcpp_executor.hpp>
+
+int main(int argc, char* argv[]) {
+  rclcpp::init(argc, argv);
+  spot_ros2::MultiViewStitcherNode node{rclcpp::NodeOptions()};
+  spot_ros2::spinNode(node.get_node_base_interface(), spot_ros2::ExecutorType::SINGLE_THREADED);
+  return 0;
+}
@@ -0,0 +1,347 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/image_stitcher/surround_stitcher.hpp>
+
+#include <cv_bridge/cv_bridge.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <eigen3/Eigen/Geometry>
+#include <opencv2/imgproc.hpp>
+#include <tf2_eigen/tf2_eigen.hpp>
+#include <utility>
+
+namespace {
+constexpr auto kHistoryDepth = 10;
+// Pixels whose normalized weight is within this tolerance of 1 are only seen by one camera
+constexpr auto kExclusiveWeight = 1. - 1e-6;
+
+/** @brief Projection of the panorama pixels into one camera image. */
+struct CameraProjection {
+  // Source coordinates of every panorama pixel in CV_32F, or -1 where the camera does not see the pixel
+  cv::Mat map_x;
+  cv::Mat map_y;
+  // Pixels of the panorama that the camera sees in CV_8U
+  cv::Mat valid;
+};
+
+/**
+ * @brief Project every pixel of the panorama into a camera.
+ * @details The panorama is the unrolled surface of a vertical cylinder around the body frame. The center column looks
+ * along the x axis of the body frame, the azimuth decreases from left to right, and the center row is at the height of
+ * the body frame.
+ *
+ * @param image_size Size of the panorama.
+ * @param cylinder_radius Radius of the cylinder in meters, at which the cameras are aligned without parallax.
+ * @param body_tform_camera Transform from the camera frame to the body frame.
+ * @param info Camera info of the camera, which provides the pinhole intrinsics and the resolution.
+ * @return The projection of the panorama into the camera image.
+ */
+CameraProjection projectPanorama(const cv::Size& image_size, double cylinder_radius,
+                                 const spot_ros2::Transform& body_tform_camera, const spot_ros2::CameraInfo& info) {
+  const Eigen::Isometry3d camera_tform_body = tf2::transformToEigen(body_tform_camera).inverse();
+  // Square pixels, so the vertical focal length also spans the full circle over the width
+  const double focal_length = image_size.width / (2. * M_PI);
+  const double center_row = image_size.height / 2.;
+  const double fx = info.k[0];
+  const double cx = info.k[2];
+  const double fy = info.k[4];
+  const double cy = info.k[5];
+  const double max_x = static_cast<double>(info.width) - 1.;
+  const double max_y = static_cast<double>(info.height) - 1.;
+
+  CameraProjection projection{cv::Mat{image_size, CV_32F, cv::Scalar{-1.}},
+                              cv::Mat{image_size, CV_32F, cv::Scalar{-1.}}, cv::Mat::zeros(image_size, CV_8U)};
+  for (int row = 0; row < image_size.height; ++row) {
+    const double height = (center_row - (row + 0.5)) / focal_length * cylinder_radius;
+    auto* const x_row = projection.map_x.ptr<float>(row);
+    auto* const y_row = projection.map_y.ptr<float>(row);
+    auto* const valid_row = projection.valid.ptr<uchar>(row);
+    for (int col = 0; col < image_size.width; ++col) {
+      const double azimuth = M_PI - 2. * M_PI * (col + 0.5) / image_size.width;
+      const Eigen::Vector3d point_body{cylinder_radius * std::cos(azimuth), cylinder_radius * std::sin(azimuth),
+                                       height};
+      const Eigen::Vector3d point_camera = camera_tform_body * point_body;
+      if (point_camera.z() <= 0.) {
+        continue;
+      }
+      const double x = fx * point_camera.x() / point_camera.z() + cx;
+      const double y = fy * point_camera.y() / point_camera.z() + cy;
+      if (x < 0. || x > max_x || y < 0. || y > max_y) {
+        continue;
+      }
+      x_row[col] = static_cast<float>(x);
+      y_row[col] = static_cast<float>(y);
+      valid_row[col] = 255;
+    }
+  }
+  return projection;
+}
+
+/**
+ * @brief Find the bounding boxes of the contiguous column ranges that a camera sees in the panorama.
+ *
+ * @param valid Pixels of the panorama that the camera sees in CV_8U.
+ * @return One bounding box for every contiguous range of columns with valid pixels.
+ */
+std::vector<cv::Rect> findTileRois(const cv::Mat& valid) {
+  std::vector<cv::Rect> rois;
+  int first_col = -1;
+  for (int col = 0; col <= valid.cols; ++col) {
+    const bool has_valid = col < valid.cols && cv::countNonZero(valid.col(col)) > 0;
+    if (has_valid && first_col < 0) {
+      first_col = col;
+    } else if (!has_valid && first_col >= 0) {
+      const cv::Rect columns{first_col, 0, col - first_col, valid.rows};
+      std::vector<cv::Point> points;
+      cv::findNonZero(valid(columns), points);
+      rois.push_back(cv::boundingRect(points) + columns.tl());
+      first_col = -1;
+    }
+  }
+  return rois;
+}
+}  // namespace
+
+namespace spot_ros2 {
+
+// Names of the cameras to stitch, which are subscribed under camera/<name> in the namespace of the node
+RclcppMultiCameraSynchronizer::RclcppMultiCameraSynchronizer(const std::shared_ptr<rclcpp::Node>& node)
+    : RclcppMultiCameraSynchronizer{
+          node,
+          node->declare_parameter("surround_cameras",
+                                  std::vector<std::string>{"frontleft", "frontright", "right", "back", "left"}),
+          rclcpp::Duration::from_seconds(node->declare_parameter("surround_max_time_difference", 0.1))} {}
+
+RclcppMultiCameraSynchronizer::RclcppMultiCameraSynchronizer(const std::shared_ptr<rclcpp::Node>& node,
+                                                             const std::vector<std::string>& camera_names,
+                                                             const rclcpp::Duration& max_time_difference)
+    : max_time_difference_{max_time_difference} {
+  for (std::size_t ndx = 0; ndx < camera_names.size(); ++ndx) {
+    auto camera = std::make_unique<CameraSubscription>();
+    camera->image.subscribe(node.get(), "camera/" + camera_names[ndx] + "/image", "raw");
+    camera->info.subscribe(node, "camera/" + camera_names[ndx] + "/camera_info");
+    camera->sync = std::make_unique<CameraSynchronizer>(camera->image, camera->info, kHistoryDepth);
+    // This must be a bind instead of a lambda because of how registerCallback is templated within message_filters.
+    camera->sync->registerCallback(
+        std::bind(&RclcppMultiCameraSynchronizer::onCamera, this, ndx, std::placeholders::_1, std::placeholders::_2));
+    cameras_.push_back(std::move(camera));
+  }
+  images_.resize(camera_names.size());
+  infos_.resize(camera_names.size());
+}
+
+void RclcppMultiCameraSynchronizer::registerCallback(const MultiImageCallbackFn& fn) {
+  callback_ = fn;
+}
+
+void RclcppMultiCameraSynchronizer::onCamera(std::size_t ndx, const std::shared_ptr<const Image>& image,
+                                             const std::shared_ptr<const CameraInfo>& info) {
+  images_[ndx] = image;
+  infos_[ndx] = info;
+  if (std::any_of(infos_.cbegin(), infos_.cend(), [](const auto& camera_info) { return !camera_info; })) {
+    return;
+  }
+  const auto [oldest, newest] = std::minmax_element(
+      infos_.cbegin(), infos_.cend(), [](const auto& lhs, const auto& rhs) {
+        return rclcpp::Time{lhs->header.stamp} < rclcpp::Time{rhs->header.stamp};
+      });
+  const rclcpp::Time newest_stamp{(*newest)->header.stamp};
+  if (newest_stamp - rclcpp::Time{(*oldest)->header.stamp} > max_time_difference_) {
+    // Drop the images that are too old to be stitched with the newest one, and wait for newer ones
+    for (std::size_t camera = 0; camera < infos_.size(); ++camera) {
+      if (newest_stamp - rclcpp::Time{infos_[camera]->header.stamp} > max_time_difference_) {
+        images_[camera].reset();
+        infos_[camera].reset();
+      }
+    }
+    return;
+  }
+  if (callback_) {
+    callback_(images_, infos_);
+  }
+  std::fill(images_.begin(), images_.end(), nullptr);
+  std::fill(infos_.begin(), infos_.end(), nullptr);
+}
+
+RclcppSurroundCameraHandle::RclcppSurroundCameraHandle(const std::shared_ptr<rclcpp::Node>& node)
+    : image_transport_{node},
+      publisher_{image_transport_.advertise("surround_camera/image", 1)} {  // Remap to actual topic in launch file
+  const auto spot_name = node->declare_parameter("spot_name", "");
+  const auto frame_prefix = spot_name.empty() ? "" : spot_name + "/";
+  // Name of the frame at the center of the cylinder that the panorama is projected on
+  const auto body_frame_param = node->declare_parameter("body_frame", "body");
+  body_frame_ = frame_prefix + body_frame_param;
+  // Size of the panorama, whose width spans the full circle around the robot
+  image_size_ = cv::Size{std::max(1, static_cast<int>(node->declare_parameter("surround_image_width", 2048))),
+                         std::max(1, static_cast<int>(node->declare_parameter("surround_image_height", 512)))};
+  // Distance from the body frame to the cylinder that the images are projected on
+  cylinder_radius_ = node->declare_parameter("surround_cylinder_radius", 2.);
+  // Width of the feather ramp across the overlap of neighboring cameras
+  blend_width_ = std::max(1, static_cast<int>(node->declare_parameter("surround_image_blend_width", 50)));
+}
+
+void RclcppSurroundCameraHandle::publish(const Image& image) const {
+  publisher_.publish(image);
+}
+
+std::string RclcppSurroundCameraHandle::getBodyFrame() const {
+  return body_frame_;
+}
+
+cv::Size RclcppSurroundCameraHandle::getImageSize() const {
+  return image_size_;
+}
+
+double RclcppSurroundCameraHandle::getCylinderRadius() const {
+  return cylinder_radius_;
+}
+
+int RclcppSurroundCameraHandle::getBlendWidth() const {
+  return blend_width_;
+}
+
+SurroundCamera::SurroundCamera(const cv::Size& image_size, double cylinder_radius, int blend_width,
+                               const std::vector<Transform>& body_tform_cameras, const std::vector<CameraInfo>& infos)
+    : image_size_{image_size} {
+  // Feather each camera from the edges of its footprint. Cameras are fully weighted blend_width pixels inside their
+  // footprint, so pixels that only one camera sees are copied as they are.
+  std::vector<CameraProjection> projections;
+  std::vector<cv::Mat> weights;
+  cv::Mat weight_sum = cv::Mat::zeros(image_size, CV_32F);
+  for (std::size_t ndx = 0; ndx < infos.size(); ++ndx) {
+    projections.push_back(projectPanorama(image_size, cylinder_radius, body_tform_cameras[ndx], infos[ndx]));
+    cv::Mat distance;
+    cv::distanceTransform(projections.back().valid, distance, cv::DIST_L2, cv::DIST_MASK_3);
+    cv::Mat weight;
+    distance.convertTo(weight, CV_32F, 1. / blend_width);
+    cv::min(weight, 1., weight);
+    weight_sum += weight;
+    weights.push_back(weight);
+  }
+  // Every pixel that a camera sees has a positive weight, so this only keeps the pixels that no camera sees at zero
+  cv::max(weight_sum, 1e-6, weight_sum);
+  for (auto& weight : weights) {
+    cv::divide(weight, weight_sum, weight);
+  }
+
+  // Split the footprint of each camera into tiles, so that every camera is only warped into the part of the panorama
+  // that it sees, and only the overlap between cameras is blended
+  for (std::size_t ndx = 0; ndx < projections.size(); ++ndx) {
+    const auto& projection = projections[ndx];
+    for (const auto& roi : findTileRois(projection.valid)) {
+      Tile tile;
+      tile.camera = ndx;
+      tile.roi = roi;
+      cv::convertMaps(projection.map_x(roi), projection.map_y(roi), tile.map_xy, tile.map_interpolation, CV_16SC2);
+      const cv::Mat tile_weight = weights[ndx](roi);
+      cv::compare(tile_weight, kExclusiveWeight, tile.exclusive_mask, cv::CMP_GE);
+      cv::Mat overlap_mask = (tile_weight > 0.) & (tile_weight < kExclusiveWeight);
+      std::vector<cv::Point> overlap;
+      cv::findNonZero(overlap_mask, overlap);
+      if (!overlap.empty()) {
+        const auto blend_roi = cv::boundingRect(overlap);
+        tile.blend_roi = blend_roi + roi.tl();
+        overlap_mask(blend_roi).copyTo(tile.blend_mask);
+        tile_weight(blend_roi).copyTo(tile.blend_weights);
+        cv::Mat blend_weights_color;
+        cv::merge(std::vector<cv::Mat>(3, tile_weight(blend_roi)), blend_weights_color);
+        blend_weights_color.copyTo(tile.blend_weights_color);
+      }
+      tiles_.push_back(std::move(tile));
+    }
+  }
+}
+
+Image::SharedPtr SurroundCamera::stitch(const std::vector<std::shared_ptr<const Image>>& images) {
+  // Greyscale cameras are stitched in mono8, which has a third of the memory traffic of BGR8
+  const bool mono = std::all_of(images.cbegin(), images.cend(), [](const auto& image) {
+    return sensor_msgs::image_encodings::isMono(image->encoding);
+  });
+  const auto encoding = mono ? sensor_msgs::image_encodings::MONO8 : sensor_msgs::image_encodings::BGR8;
+  std::vector<cv_bridge::CvImageConstPtr> scenes;
+  scenes.reserve(images.size());
+  for (const auto& image : images) {
+    scenes.push_back(cv_bridge::toCvShare(image, encoding));
+  }
+  // Pixels that no camera sees are never written, so the panorama is only cleared when its type changes
+  const int result_type = mono ? CV_8UC1 : CV_8UC3;
+  if (result_.empty() || result_.type() != result_type) {
+    result_.create(image_size_, result_type);
+    result_.setTo(cv::Scalar::all(0.));
+    accumulator_.create(image_size_, mono ? CV_32FC1 : CV_32FC3);
+  }
+
+  // Warp every camera into its tiles, and copy the pixels that no other camera sees straight into the panorama
+  for (auto& tile : tiles_) {
+    cv::remap(scenes[tile.camera]->image, tile.warped, tile.map_xy, tile.map_interpolation, cv::INTER_LINEAR);
+    tile.warped.copyTo(result_(tile.roi), tile.exclusive_mask);
+    if (!tile.blend_roi.empty()) {
+      accumulator_(tile.blend_roi).setTo(cv::Scalar::all(0.));
+    }
+  }
+
+  // Sum the weighted cameras in the overlaps, which are the only pixels that need floating point work
+  for (const auto& tile : tiles_) {
+    if (tile.blend_roi.empty()) {
+      continue;
+    }
+    tile.warped(tile.blend_roi - tile.roi.tl()).convertTo(weighted_, CV_32F);
+    cv::multiply(weighted_, mono ? tile.blend_weights : tile.blend_weights_color, weighted_);
+    cv::UMat accumulator = accumulator_(tile.blend_roi);
+    cv::add(accumulator, weighted_, accumulator);
+  }
+  for (const auto& tile : tiles_) {
+    if (tile.blend_roi.empty()) {
+      continue;
+    }
+    accumulator_(tile.blend_roi).convertTo(blended_, CV_8U);
+    blended_.copyTo(result_(tile.blend_roi), tile.blend_mask);
+  }
+
+  return cv_bridge::CvImage(std_msgs::msg::Header{}, encoding, result_.getMat(cv::ACCESS_READ)).toImageMsg();
+}
+
+SurroundStitcher::SurroundStitcher(std::unique_ptr<MultiCameraSynchronizerBase> synchronizer,
+                                   std::unique_ptr<TfListenerInterfaceBase> tf_listener,
+                                   std::unique_ptr<SurroundCameraHandleBase> camera_handle,
+                                   std::unique_ptr<LoggerInterfaceBase> logger)
+    : synchronizer_{std::move(synchronizer)},
+      tf_listener_{std::move(tf_listener)},
+      camera_handle_{std::move(camera_handle)},
+      logger_{std::move(logger)} {
+  synchronizer_->registerCallback([this](const std::vector<std::shared_ptr<const Image>>& images,
+                                         const std::vector<std::shared_ptr<const CameraInfo>>& infos) {
+    callback(images, infos);
+  });
+}
+
+void SurroundStitcher::callback(const std::vector<std::shared_ptr<const Image>>& images,
+                                const std::vector<std::shared_ptr<const CameraInfo>>& infos) {
+  // As for the front image stitcher, the transforms and camera info are assumed to be static, so they are only looked
+  // up once to build the surround camera.
+  if (!camera_.has_value()) {
+    const auto body_frame = camera_handle_->getBodyFrame();
+    std::vector<Transform> body_tform_cameras;
+    std::vector<CameraInfo> camera_infos;
+    for (const auto& info : infos) {
+      const auto body_tform_camera =
+          tf_listener_->lookupTransform(info->header.frame_id, body_frame, info->header.stamp);
+      if (!body_tform_camera) {
+        logger_->logWarn("Valid transform for image frame " + info->header.frame_id + " to " + body_frame +
+                         " could not be found");
+        return;
+      }
+      body_tform_cameras.push_back(body_tform_camera->transform);
+      camera_infos.push_back(*info);
+    }
+    camera_ = SurroundCamera{camera_handle_->getImageSize(), camera_handle_->getCylinderRadius(),
+                             camera_handle_->getBlendWidth(), body_tform_cameras, camera_infos};
+  }
+  const auto image_stitched = camera_->stitch(images);
+  image_stitched->header.stamp = infos.front()->header.stamp;
+  image_stitched->header.frame_id = camera_handle_->getBodyFrame();
+  camera_handle_->publish(*image_stitched);
+}
+
+}  // namespace spot_ros2
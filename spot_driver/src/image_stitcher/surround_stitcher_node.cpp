@@ -0,0 +1,20 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/image_stitcher/surround_stitcher_node.hpp>
+
+#include <rclcpp/node.hpp>
+#include <spot_driver/interfaces/rclcpp_logger_interface.hpp>
+#include <spot_driver/interfaces/rclcpp_tf_listener_interface.hpp>
+
+namespace spot_ros2 {
+SurroundStitcherNode::SurroundStitcherNode(const rclcpp::NodeOptions& options)
+    : node_{std::make_shared<rclcpp::Node>("surround_stitcher", options)},
+      stitcher_{std::make_unique<RclcppMultiCameraSynchronizer>(node_),
+                std::make_unique<RclcppTfListenerInterface>(node_), std::make_unique<RclcppSurroundCameraHandle>(node_),
+                std::make_unique<RclcppLoggerInterface>(node_->get_logger())} {}
+
+std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> SurroundStitcherNode::get_node_base_interface() {
+  return node_->get_node_base_interface();
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,98 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/images/bandwidth_budget.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+// Weight of the newest response in the size estimate of a source. The size of an image changes with the scene, so the
+// estimate follows it over a few responses without jumping on a single outlier.
+constexpr auto kSizeSmoothing = 0.3;
+}  // namespace
+
+namespace spot_ros2::images {
+
+BandwidthBudget::BandwidthBudget(const double bytes_per_second, const double min_quality, const double max_quality)
+    : bytes_per_second_{std::max(bytes_per_second, 0.0)},
+      min_quality_{std::clamp(std::min(min_quality, max_quality), 0.0, 100.0)},
+      max_quality_{std::clamp(max_quality, 0.0, 100.0)} {}
+
+void BandwidthBudget::addSource(const ImageSource& image_source, const double rate, const int priority) {
+  auto& source = sources_[toImageSourceIndex(image_source)];
+  source.added = true;
+  source.rgb = image_source.type == SpotImageType::RGB;
+  source.wanted = true;
+  source.rate = std::max(rate, 0.0);
+  source.priority = priority;
+  source.admitted = true;
+  source.quality = max_quality_;
+}
+
+void BandwidthBudget::setWanted(const ImageSource& image_source, const bool wanted) {
+  sources_[toImageSourceIndex(image_source)].wanted = wanted;
+}
+
+void BandwidthBudget::update(const ImageSource& image_source, const std::size_t size, const double quality) {
+  auto& source = sources_[toImageSourceIndex(image_source)];
+  if (!source.added) {
+    return;
+  }
+  auto bytes_per_image = static_cast<double>(size);
+  if (source.rgb) {
+    // Images requested at a quality of zero carry no information about the size at other qualities.
+    if (quality <= 0.0) {
+      return;
+    }
+    bytes_per_image *= max_quality_ / quality;
+  }
+  source.bytes_per_image = source.observed
+                               ? source.bytes_per_image + kSizeSmoothing * (bytes_per_image - source.bytes_per_image)
+                               : bytes_per_image;
+  source.observed = true;
+}
+
+void BandwidthBudget::allocate() {
+  std::array<std::size_t, kNumImageSources> order;
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  std::stable_sort(order.begin(), order.end(), [this](const std::size_t lhs, const std::size_t rhs) {
+    return sources_[lhs].priority > sources_[rhs].priority;
+  });
+
+  auto remaining = bytes_per_second_;
+  for (const auto index : order) {
+    auto& source = sources_[index];
+    source.admitted = false;
+    source.quality = max_quality_;
+    if (!source.added || !source.wanted) {
+      continue;
+    }
+    if (!source.observed) {
+      source.admitted = true;
+      continue;
+    }
+
+    const auto full_cost = source.bytes_per_image * source.rate;
+    if (full_cost <= remaining) {
+      source.admitted = true;
+      remaining -= full_cost;
+    } else if (source.rgb && full_cost > 0.0) {
+      const auto quality = max_quality_ * remaining / full_cost;
+      if (quality >= min_quality_) {
+        source.admitted = true;
+        source.quality = quality;
+        remaining = 0.0;
+      }
+    }
+  }
+}
+
+bool BandwidthBudget::isAdmitted(const ImageSource& image_source) const {
+  return sources_[toImageSourceIndex(image_source)].admitted;
+}
+
+double BandwidthBudget::quality(const ImageSource& image_source) const {
+  return sources_[toImageSourceIndex(image_source)].quality;
+}
+
+}  // namespace spot_ros2::images
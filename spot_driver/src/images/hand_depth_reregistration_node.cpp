@@ -0,0 +1,100 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/images/hand_depth_reregistration_node.hpp>
+
+#include <rclcpp/qos.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr auto kNodeName{"hand_depth_reregistration"};
+constexpr auto kRegisteredFrame = "hand_color_image_sensor";
+constexpr auto kPublisherHistoryDepth = 10;
+constexpr auto kErrorThrottlePeriodMs = 5000;
+
+/**
+ * @brief Copy a list parameter into a fixed size array.
+ *
+ * @param values Values of the parameter.
+ * @param array Array to copy the values into. It is left unchanged if the parameter has the wrong number of values.
+ * @return True if the parameter has as many values as the array.
+ */
+template <typename T, typename U, std::size_t N>
+bool toArray(const std::vector<U>& values, std::array<T, N>& array) {
+  if (values.size() != N) {
+    return false;
+  }
+  std::transform(values.cbegin(), values.cend(), array.begin(), [](const U value) { return static_cast<T>(value); });
+  return true;
+}
+}  // namespace
+
+namespace spot_ros2::images {
+
+HandDepthReregistrationNode::HandDepthReregistrationNode(const rclcpp::NodeOptions& options)
+    : node_{std::make_shared<rclcpp::Node>(kNodeName, options)} {
+  DepthReregistrationCalibration calibration;
+  const auto camera_matrix_depth = node_->declare_parameter("camera_matrix_depth", std::vector<double>(9, 0.0));
+  calibration.dist_coeffs_depth = node_->declare_parameter("dist_coeffs_depth", std::vector<double>(5, 0.0));
+  const auto camera_matrix_rgb = node_->declare_parameter("camera_matrix_rgb", std::vector<double>(9, 0.0));
+  const auto depth_t_rgb_R = node_->declare_parameter("depth_t_rgb_R", std::vector<double>(9, 0.0));
+  const auto depth_t_rgb_T = node_->declare_parameter("depth_t_rgb_T", std::vector<double>(3, 0.0));
+  const auto depth_image_dim = node_->declare_parameter("depth_image_dim", std::vector<std::int64_t>(2, 0));
+  const auto rgb_image_dim = node_->declare_parameter("rgb_image_dim", std::vector<std::int64_t>(2, 0));
+  calibration.undistort = node_->declare_parameter("undistort", false);
+  const auto robot_name = node_->declare_parameter<std::string>("robot_name", "");
+  const auto raw_depth_topic = node_->declare_parameter<std::string>("raw_depth_topic", "depth/hand/image");
+  const auto topic_name = node_->declare_parameter<std::string>("topic_name", "depth_registered/hand_custom_cal/image");
+  frame_id_ = robot_name.empty() ? kRegisteredFrame : robot_name + "/" + kRegisteredFrame;
+
+  if (!toArray(camera_matrix_depth, calibration.camera_matrix_depth) ||
+      !toArray(camera_matrix_rgb, calibration.camera_matrix_rgb) ||
+      !toArray(depth_t_rgb_R, calibration.depth_t_rgb_R) || !toArray(depth_t_rgb_T, calibration.depth_t_rgb_T) ||
+      !toArray(depth_image_dim, calibration.depth_image_dim) || !toArray(rgb_image_dim, calibration.rgb_image_dim)) {
+    RCLCPP_ERROR(node_->get_logger(),
+                 "Invalid calibration parameters! The matrices need 9 values, depth_t_rgb_T 3 values and the image "
+                 "dimensions 2 values. Not re-registering the hand depth images.");
+    return;
+  }
+  auto reregistration = DepthReregistration::create(calibration);
+  if (!reregistration.has_value()) {
+    RCLCPP_ERROR(node_->get_logger(), "Invalid calibration! Got error: %s Not re-registering the hand depth images.",
+                 reregistration.error().c_str());
+    return;
+  }
+  reregistration_ = std::move(reregistration.value());
+
+  // The Python publisher used a reliable topic, which existing subscribers may require.
+  publisher_ = node_->create_publisher<sensor_msgs::msg::Image>(topic_name, rclcpp::QoS(kPublisherHistoryDepth));
+  subscription_ = node_->create_subscription<sensor_msgs::msg::Image>(
+      raw_depth_topic, rclcpp::SensorDataQoS(),
+      [this](const std::shared_ptr<const sensor_msgs::msg::Image>& depth_image) { onDepthImage(*depth_image); });
+}
+
+std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> HandDepthReregistrationNode::get_node_base_interface() {
+  return node_->get_node_base_interface();
+}
+
+void HandDepthReregistrationNode::onDepthImage(const sensor_msgs::msg::Image& depth_image) {
+  if (publisher_->get_subscription_count() == 0) {
+    return;
+  }
+  // The image is published as a unique pointer, so that subscribers in the same process take it over without a copy.
+  auto registered = std::make_unique<sensor_msgs::msg::Image>();
+  if (const auto result = reregistration_->reregister(depth_image, *registered); !result) {
+    RCLCPP_ERROR_THROTTLE(node_->get_logger(), *node_->get_clock(), kErrorThrottlePeriodMs,
+                          "Failed to re-register hand depth image: %s", result.error().c_str());
+    return;
+  }
+  registered->header.frame_id = frame_id_;
+  publisher_->publish(std::move(registered));
+}
+
+}  // namespace spot_ros2::images
@@ -0,0 +1,87 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/images/image_latency_probe.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+namespace {
+constexpr double kNanosecondsPerSecond = 1e9;
+
+std::int64_t toNanoseconds(const builtin_interfaces::msg::Time& time) {
+  return static_cast<std::int64_t>(time.sec) * 1000000000LL + static_cast<std::int64_t>(time.nanosec);
+}
+
+/** @brief Get the nearest-rank percentile of sorted values, which must not be empty. */
+double percentile(const std::vector<double>& sorted, const double fraction) {
+  const auto rank =
+      static_cast<std::size_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(sorted.size())));
+  return sorted[std::max<std::size_t>(rank, 1) - 1];
+}
+}  // namespace
+
+namespace spot_ros2::images {
+
+double frameAge(const builtin_interfaces::msg::Time& stamp, const builtin_interfaces::msg::Time& receive_time) {
+  return static_cast<double>(toNanoseconds(receive_time) - toNanoseconds(stamp)) / kNanosecondsPerSecond;
+}
+
+void FrameAgeStatistics::add(const std::string& topic, const double age) {
+  ages_[topic].push_back(age);
+}
+
+std::vector<FrameAgeStatistics::Summary> FrameAgeStatistics::summarize() const {
+  std::vector<Summary> out;
+  out.reserve(ages_.size());
+  for (const auto& [topic, ages] : ages_) {
+    if (ages.empty()) {
+      continue;
+    }
+    auto sorted = ages;
+    std::sort(sorted.begin(), sorted.end());
+    Summary summary;
+    summary.topic = topic;
+    summary.count = sorted.size();
+    summary.mean = std::accumulate(sorted.cbegin(), sorted.cend(), 0.0) / static_cast<double>(sorted.size());
+    summary.p50 = percentile(sorted, 0.5);
+    summary.p90 = percentile(sorted, 0.9);
+    summary.p99 = percentile(sorted, 0.99);
+    summary.max = sorted.back();
+    out.push_back(std::move(summary));
+  }
+  return out;
+}
+
+void FrameAgeStatistics::clear() {
+  ages_.clear();
+}
+
+void writeSummaryCsv(const std::vector<FrameAgeStatistics::Summary>& summaries, std::ostream& out) {
+  out << "topic,count,mean_ms,p50_ms,p90_ms,p99_ms,max_ms\n";
+  out << std::fixed << std::setprecision(3);
+  for (const auto& summary : summaries) {
+    out << summary.topic << "," << summary.count << "," << summary.mean * 1e3 << "," << summary.p50 * 1e3 << ","
+        << summary.p90 * 1e3 << "," << summary.p99 * 1e3 << "," << summary.max * 1e3 << "\n";
+  }
+}
+
+std::string formatSummaryTable(const std::vector<FrameAgeStatistics::Summary>& summaries) {
+  std::ostringstream out;
+  out << std::left << std::setw(40) << "topic" << std::right << std::setw(8) << "count" << std::setw(10) << "mean ms"
+      << std::setw(10) << "p50 ms" << std::setw(10) << "p90 ms" << std::setw(10) << "p99 ms" << std::setw(10)
+      << "max ms";
+  out << std::fixed << std::setprecision(1);
+  for (const auto& summary : summaries) {
+    out << "\n"
+        << std::left << std::setw(40) << summary.topic << std::right << std::setw(8) << summary.count << std::setw(10)
+        << summary.mean * 1e3 << std::setw(10) << summary.p50 * 1e3 << std::setw(10) << summary.p90 * 1e3
+        << std::setw(10) << summary.p99 * 1e3 << std::setw(10) << summary.max * 1e3;
+  }
+  return out.str();
+}
+
+}  // namespace spot_ros2::images
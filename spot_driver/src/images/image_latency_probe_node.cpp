@@ -0,0 +1,87 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/images/image_latency_probe_node.hpp>
+
+#include <rclcpp/qos.hpp>
+
+#include <chrono>
+#include <iomanip>
+
+namespace spot_ros2::images {
+
+ImageLatencyProbeNode::ImageLatencyProbeNode(const rclcpp::NodeOptions& options)
+    : node_{std::make_shared<rclcpp::Node>("image_latency_probe", options)} {
+  // Sources are subscribed under <source>/image and <source>/camera_info in the namespace of the node, which should
+  // match the name of the robot, e.g. camera/frontleft or depth/hand.
+  const auto sources = node_->declare_parameter(
+      "latency_probe_sources",
+      std::vector<std::string>{"camera/frontleft", "camera/frontright", "camera/left", "camera/right", "camera/back",
+                               "depth/frontleft", "depth/frontright", "depth/left", "depth/right", "depth/back"});
+  const auto report_period = node_->declare_parameter("latency_probe_report_period", 5.0);
+  const auto csv_file = node_->declare_parameter("latency_probe_csv_file", "");
+  summary_file_ = node_->declare_parameter("latency_probe_summary_file", "");
+
+  if (!csv_file.empty()) {
+    csv_file_.open(csv_file, std::ios::out | std::ios::trunc);
+    if (csv_file_) {
+      csv_file_ << "topic,stamp_s,receive_s,age_ms\n" << std::fixed << std::setprecision(6);
+    } else {
+      RCLCPP_ERROR(node_->get_logger(), "Could not open the CSV file `%s`.", csv_file.c_str());
+    }
+  }
+
+  // Best effort subscriptions match both reliable and best effort publishers, and do not hold up the publisher.
+  const auto qos = rclcpp::SensorDataQoS();
+  for (const auto& source : sources) {
+    const auto image_topic = source + "/image";
+    image_subscriptions_.push_back(node_->create_subscription<sensor_msgs::msg::Image>(
+        image_topic, qos, [this, image_topic](const std::shared_ptr<const sensor_msgs::msg::Image>& image) {
+          onFrame(image_topic, image->header.stamp);
+        }));
+    const auto info_topic = source + "/camera_info";
+    info_subscriptions_.push_back(node_->create_subscription<sensor_msgs::msg::CameraInfo>(
+        info_topic, qos, [this, info_topic](const std::shared_ptr<const sensor_msgs::msg::CameraInfo>& info) {
+          onFrame(info_topic, info->header.stamp);
+        }));
+  }
+
+  if (report_period > 0.0) {
+    report_timer_ = node_->create_wall_timer(std::chrono::duration<double>{report_period}, [this] {
+      report();
+    });
+  }
+}
+
+ImageLatencyProbeNode::~ImageLatencyProbeNode() {
+  report();
+  if (!summary_file_.empty()) {
+    std::ofstream summary{summary_file_, std::ios::out | std::ios::trunc};
+    writeSummaryCsv(statistics_.summarize(), summary);
+  }
+}
+
+std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> ImageLatencyProbeNode::get_node_base_interface() {
+  return node_->get_node_base_interface();
+}
+
+void ImageLatencyProbeNode::onFrame(const std::string& topic, const builtin_interfaces::msg::Time& stamp) {
+  // The receive time is taken from the clock of the node, which is the clock the image publisher stamps with.
+  const builtin_interfaces::msg::Time receive_time = node_->now();
+  const auto age = frameAge(stamp, receive_time);
+  statistics_.add(topic, age);
+  if (csv_file_.is_open()) {
+    csv_file_ << topic << "," << stamp.sec + stamp.nanosec * 1e-9 << ","
+              << receive_time.sec + receive_time.nanosec * 1e-9 << "," << age * 1e3 << "\n";
+  }
+}
+
+void ImageLatencyProbeNode::report() {
+  const auto summaries = statistics_.summarize();
+  if (summaries.empty()) {
+    RCLCPP_INFO(node_->get_logger(), "No frames received yet.");
+    return;
+  }
+  RCLCPP_INFO(node_->get_logger(), "Frame ages since start:\n%s", formatSummaryTable(summaries).c_str());
+}
+
+}  // namespace spot_ros2::images
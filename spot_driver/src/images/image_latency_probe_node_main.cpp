@@ -0,0 +1,17 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <rclcpp/node_options.hpp>
+#include <rclcpp/utilities.hpp>
+#include <spot_driver/images/image_latency_probe_node.hpp>
+#include <spot_driver/interfaces/rclcpp_executor.hpp>
+
+int main(int argc, char* argv[]) {
+  rclcpp::init(argc, argv);
+  {
+    // The node writes its summary when it is destroyed, so it goes out of scope once spinning stops on Ctrl-C.
+    spot_ros2::images::ImageLatencyProbeNode node{rclcpp::NodeOptions()};
+    spot_ros2::spinNode(node.get_node_base_interface(), spot_ros2::ExecutorType::SINGLE_THREADED);
+  }
+  rclcpp::shutdown();
+  return 0;
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/images/image_latency_statistics.hpp>
+
+#include <diagnostic_msgs/msg/key_value.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <utility>
+
+namespace spot_ros2::images {
+
+void addStageValues(const std::string& stage, const LatencyHistogram& histogram,
+                    diagnostic_msgs::msg::DiagnosticStatus& status) {
+  const auto add_value = [&status, &stage](const std::string& key, const double seconds) {
+    std::ostringstream value;
+    value.precision(3);
+    value << std::fixed << seconds * 1e3;
+    status.values.push_back(
+        diagnostic_msgs::build<diagnostic_msgs::msg::KeyValue>().key(stage + " " + key + " (ms)").value(value.str()));
+  };
+  add_value("mean", histogram.mean());
+  add_value("p50", histogram.percentile(0.5));
+  add_value("p95", histogram.percentile(0.95));
+  add_value("max", histogram.max());
+}
+
+void LatencyHistogram::add(const double seconds) {
+  const auto bucket = std::lower_bound(kBucketEdges.cbegin(), kBucketEdges.cend(), seconds) - kBucketEdges.cbegin();
+  ++buckets_[static_cast<std::size_t>(bucket)];
+  ++count_;
+  sum_ += seconds;
+  max_ = std::max(max_, seconds);
+}
+
+double LatencyHistogram::percentile(const double fraction) const {
+  if (count_ == 0) {
+    return 0.0;
+  }
+  const auto rank = static_cast<std::size_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(count_)));
+  std::size_t cumulative = 0;
+  for (std::size_t bucket = 0; bucket < kBucketEdges.size(); ++bucket) {
+    cumulative += buckets_[bucket];
+    if (cumulative >= std::max<std::size_t>(rank, 1)) {
+      // The bucket edge is an upper bound, but the maximum is tighter if every latency is below the edge.
+      return std::min(kBucketEdges[bucket], max_);
+    }
+  }
+  return max_;
+}
+
+void ImageLatencyStatistics::add(const ImageSource& image_source, const ImageLatency& latency) {
+  auto& histograms = histograms_[toImageSourceIndex(image_source)];
+  histograms.source = image_source;
+  histograms.robot_to_host.add(latency.robot_to_host);
+  histograms.decode.add(latency.decode);
+  histograms.publish.add(latency.publish);
+  histograms.total.add(
+      latency.robot_to_host +
+      std::chrono::duration<double>{std::chrono::steady_clock::now() - latency.response_time}.count());
+}
+
+std::vector<diagnostic_msgs::msg::DiagnosticStatus> ImageLatencyStatistics::toDiagnosticStatus(
+    const std::string& name_prefix) const {
+  std::vector<diagnostic_msgs::msg::DiagnosticStatus> out;
+  for (const auto& histograms : histograms_) {
+    if (!histograms.source.has_value()) {
+      continue;
+    }
+    diagnostic_msgs::msg::DiagnosticStatus status;
+    status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+    status.name = name_prefix + toRosTopic(histograms.source.value());
+    status.message = std::to_string(histograms.total.count()) + " images";
+    addStageValues("robot_to_host", histograms.robot_to_host, status);
+    addStageValues("decode", histograms.decode, status);
+    addStageValues("publish", histograms.publish, status);
+    addStageValues("total", histograms.total, status);
+    out.push_back(std::move(status));
+  }
+  return out;
+}
+
+void ImageLatencyStatistics::clear() {
+  histograms_.fill(SourceHistograms{});
+}
+
+}  // namespace spot_ros2::images
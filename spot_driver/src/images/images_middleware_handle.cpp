@@ -1,5 +1,6 @@
 // Copyright (c) 2023-2024 Boston Dynamics AI Institute LLC. All rights reserved.
 
+#include <bosdyn/api/image.pb.h>
 #include <rclcpp/node.hpp>
 #include <spot_driver/api/spot_image_sources.hpp>
 #include <spot_driver/images/images_middleware_handle.hpp>
@@ -8,80 +9,369 @@
 #include <spot_driver/interfaces/rclcpp_tf_broadcaster_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_wall_timer_interface.hpp>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace {
 constexpr auto kPublisherHistoryDepth = 10;
+constexpr auto kImageQoSCategory = "image";
+constexpr auto kCompressedImageQoSCategory = "compressed_image";
+constexpr auto kCameraInfoQoSCategory = "camera_info";
+constexpr auto kPointCloudQoSCategory = "point_cloud";
+constexpr auto kLaserScanTopic = "scan";
+constexpr auto kImageBundleTopic = "image_bundle";
+constexpr auto kRawImageResponseTopic = "image_responses/raw";
+constexpr auto kDiagnosticsTopic = "/diagnostics";
+constexpr auto kDiagnosticsHistoryDepth = 1;
+
+/**
+ * @brief Publish a message, either by moving it into the middleware or by publishing it in place.
+ *
+ * @param publisher Publisher to publish the message with.
+ * @param message Message to publish. It is left in a moved-from state if move_message is true.
+ * @param move_message If true, hand the message to the middleware as a unique_ptr.
+ */
+template <typename MessageT>
+void publishMessage(rclcpp::Publisher<MessageT>& publisher, MessageT& message, const bool move_message) {
+  if (move_message) {
+    publisher.publish(std::make_unique<MessageT>(std::move(message)));
+  } else {
+    publisher.publish(message);
+  }
+}
 
 }  // namespace
 
 namespace spot_ros2::images {
 
-ImagesMiddlewareHandle::ImagesMiddlewareHandle(const std::shared_ptr<rclcpp::Node>& node) : node_{node} {}
+ImagesMiddlewareHandle::PublisherQoS ImagesMiddlewareHandle::loadPublisherQoS(const ParameterInterfaceBase& parameters,
+                                                                               const LoggerInterfaceBase& logger) {
+  // Large images usually need different settings than the small camera info messages, so each category is read on its
+  // own.
+  return PublisherQoS{makePublisherQoS(parameters, logger, kImageQoSCategory, kPublisherHistoryDepth),
+                      makePublisherQoS(parameters, logger, kCompressedImageQoSCategory, kPublisherHistoryDepth),
+                      makePublisherQoS(parameters, logger, kCameraInfoQoSCategory, kPublisherHistoryDepth),
+                      makePublisherQoS(parameters, logger, kPointCloudQoSCategory, kPublisherHistoryDepth)};
+}
+
+ImagesMiddlewareHandle::ImagesMiddlewareHandle(const std::shared_ptr<rclcpp::Node>& node)
+    : ImagesMiddlewareHandle(node, PublisherQoS{makePublisherQoS(kPublisherHistoryDepth),
+                                                makePublisherQoS(kPublisherHistoryDepth),
+                                                makePublisherQoS(kPublisherHistoryDepth),
+                                                makePublisherQoS(kPublisherHistoryDepth)}) {}
+
+ImagesMiddlewareHandle::ImagesMiddlewareHandle(const std::shared_ptr<rclcpp::Node>& node, const PublisherQoS& qos)
+    : node_{node}, qos_{qos} {}
 
 ImagesMiddlewareHandle::ImagesMiddlewareHandle(const rclcpp::NodeOptions& node_options)
     : ImagesMiddlewareHandle(std::make_shared<rclcpp::Node>("image_publisher", node_options)) {}
 
-void ImagesMiddlewareHandle::createPublishers(const std::set<ImageSource>& image_sources, bool uncompress_images,
-                                              bool publish_compressed_images) {
-  image_publishers_.clear();
-  info_publishers_.clear();
+void ImagesMiddlewareHandle::createPublishers(const std::set<ImageSource>& image_sources,
+                                              const PublisherOptions& options) {
+  // Publishers which are still needed are kept, so that their subscribers do not miss images while the image sources
+  // are changed at runtime. The others are reset and created below.
+  const auto must_create = [](auto& publisher, bool needed) {
+    if (!needed) {
+      publisher.reset();
+    }
+    return needed && !publisher;
+  };
+  std::array<bool, kNumImageSources> published{};
+  for (const auto& image_source : image_sources) {
+    published[toImageSourceIndex(image_source)] = true;
+  }
+  for (std::size_t index = 0; index < kNumImageSources; ++index) {
+    if (!published[index]) {
+      publishers_[index] = SourcePublishers{};
+    }
+  }
+
+  auto image_qos = qos_.image;
+  auto compressed_image_qos = qos_.compressed_image;
+  auto info_qos = qos_.camera_info;
+  auto point_cloud_qos = qos_.point_cloud;
+
+  // rclcpp only supports intra-process communication for publishers with volatile durability, so late-joining
+  // subscribers do not get the last image when the node is composed with intra-process communication enabled.
+  move_messages_ = node_->get_node_options().use_intra_process_comms();
+  if (move_messages_) {
+    image_qos.durability_volatile();
+    compressed_image_qos.durability_volatile();
+    info_qos.durability_volatile();
+    point_cloud_qos.durability_volatile();
+  }
 
   for (const auto& image_source : image_sources) {
+    const bool is_rgb = image_source.type == SpotImageType::RGB;
     // Since these topic names do not have a leading `/` character, they will be published within the namespace of the
     // node, which should match the name of the robot. For example, the topic for the front left RGB camera will
     // ultimately appear as `/MyRobotName/camera/frontleft/image`.
-    const auto image_topic_name = toRosTopic(image_source);
+    const auto& image_topic_name = toRosTopic(image_source);
+    auto& publishers = publishers_[toImageSourceIndex(image_source)];
 
-    if (image_source.type == SpotImageType::RGB && publish_compressed_images) {
-      compressed_image_publishers_.try_emplace(
-          image_topic_name, node_->create_publisher<sensor_msgs::msg::CompressedImage>(
-                                image_topic_name + "/compressed", makePublisherQoS(kPublisherHistoryDepth)));
+    if (must_create(publishers.compressed_image, is_rgb && options.publish_compressed_images)) {
+      publishers.compressed_image = node_->create_publisher<sensor_msgs::msg::CompressedImage>(
+          image_topic_name + "/compressed", compressed_image_qos);
+    }
+    if (must_create(publishers.image, options.uncompress_images || !is_rgb)) {
+      publishers.image = node_->create_publisher<sensor_msgs::msg::Image>(image_topic_name + "/image", image_qos);
+    }
+    if (!publishers.info) {
+      publishers.info =
+          node_->create_publisher<sensor_msgs::msg::CameraInfo>(image_topic_name + "/camera_info", info_qos);
+    }
+    // Previews are derived from the uncompressed images, so they are only available if those are published.
+    const bool preview = options.publish_preview_images && (options.uncompress_images || !is_rgb);
+    if (must_create(publishers.preview_image, preview)) {
+      publishers.preview_image =
+          node_->create_publisher<sensor_msgs::msg::Image>(image_topic_name + "/image_preview", image_qos);
+    }
+    if (must_create(publishers.preview_info, preview)) {
+      publishers.preview_info =
+          node_->create_publisher<sensor_msgs::msg::CameraInfo>(image_topic_name + "/camera_info_preview", info_qos);
+    }
+    if (must_create(publishers.point_cloud, options.publish_point_clouds && !is_rgb)) {
+      publishers.point_cloud =
+          node_->create_publisher<sensor_msgs::msg::PointCloud2>(image_topic_name + "/points", point_cloud_qos);
+    }
+    // Compressed depth images are compressed like the RGB images, so they use the same QoS settings.
+    if (must_create(publishers.compressed_depth_image, options.publish_compressed_depth_images && !is_rgb)) {
+      publishers.compressed_depth_image = node_->create_publisher<sensor_msgs::msg::CompressedImage>(
+          image_topic_name + "/compressedDepth", compressed_image_qos);
+    }
+    // Filtered depth images are published next to the depth images, like the previews.
+    if (must_create(publishers.filtered_depth_image, options.publish_filtered_depth_images && !is_rgb)) {
+      publishers.filtered_depth_image =
+          node_->create_publisher<sensor_msgs::msg::Image>(image_topic_name + "/image_filtered", image_qos);
     }
-    if (uncompress_images || (image_source.type != SpotImageType::RGB)) {
-      image_publishers_.try_emplace(
-          image_topic_name, node_->create_publisher<sensor_msgs::msg::Image>(image_topic_name + "/image",
-                                                                             makePublisherQoS(kPublisherHistoryDepth)));
+    if (must_create(publishers.filtered_depth_info, options.publish_filtered_depth_images && !is_rgb)) {
+      publishers.filtered_depth_info =
+          node_->create_publisher<sensor_msgs::msg::CameraInfo>(image_topic_name + "/camera_info_filtered", info_qos);
     }
-    info_publishers_.try_emplace(image_topic_name,
-                                 node_->create_publisher<sensor_msgs::msg::CameraInfo>(
-                                     image_topic_name + "/camera_info", makePublisherQoS(kPublisherHistoryDepth)));
+  }
+
+  // The scan is derived from the depth images like the point clouds, so it uses the same QoS settings.
+  if (must_create(laser_scan_publisher_, options.publish_laser_scan)) {
+    laser_scan_publisher_ = node_->create_publisher<sensor_msgs::msg::LaserScan>(kLaserScanTopic, point_cloud_qos);
+  }
+  // The stitched image is published like the images of a camera, under the name of its virtual camera.
+  if (options.stitched_camera != stitched_camera_) {
+    stitched_image_publisher_.reset();
+    stitched_info_publisher_.reset();
+    stitched_camera_ = options.stitched_camera;
+  }
+  if (!options.stitched_camera.empty() && !stitched_image_publisher_) {
+    const auto stitched_topic_name = std::string{"camera/"} + options.stitched_camera;
+    stitched_image_publisher_ =
+        node_->create_publisher<sensor_msgs::msg::Image>(stitched_topic_name + "/image", image_qos);
+    stitched_info_publisher_ =
+        node_->create_publisher<sensor_msgs::msg::CameraInfo>(stitched_topic_name + "/camera_info", info_qos);
+  }
+  // A bundle holds full images, so it uses the same QoS settings as the images.
+  if (must_create(image_bundle_publisher_, options.publish_image_bundle)) {
+    image_bundle_publisher_ = node_->create_publisher<spot_msgs::msg::ImageBundle>(kImageBundleTopic, image_qos);
+  }
+  // Likewise for the raw responses, which hold the image data as Spot sent it.
+  if (must_create(raw_response_publisher_, options.publish_raw_responses)) {
+    raw_response_publisher_ =
+        node_->create_publisher<spot_msgs::msg::SerializedProto>(kRawImageResponseTopic, image_qos);
   }
 }
 
 tl::expected<void, std::string> ImagesMiddlewareHandle::publishImages(
-    const std::map<ImageSource, ImageWithCameraInfo>& images,
-    const std::map<ImageSource, CompressedImageWithCameraInfo>& compressed_images) {
-  std::set<std::string> camera_infos_sent;
-  for (const auto& [image_source, image_data] : images) {
-    const auto image_topic_name = toRosTopic(image_source);
-    try {
-      image_publishers_.at(image_topic_name)->publish(image_data.image);
-    } catch (const std::out_of_range& e) {
-      return tl::make_unexpected("No image publisher exists for image topic `" + image_topic_name + "`.");
-    }
-    try {
-      info_publishers_.at(image_topic_name)->publish(image_data.info);
-      camera_infos_sent.insert(image_topic_name);
-    } catch (const std::out_of_range& e) {
-      return tl::make_unexpected("No camera_info publisher exists for camera info topic`" + image_topic_name + "`.");
-    }
-  }
-  for (const auto& [image_source, compressed_image_data] : compressed_images) {
-    const auto image_topic_name = toRosTopic(image_source);
-    try {
-      compressed_image_publishers_.at(image_topic_name)->publish(compressed_image_data.image);
-    } catch (const std::out_of_range& e) {
-      return tl::make_unexpected("No compressed image publisher exists for image topic `" + image_topic_name + "`.");
-    }
-    auto camera_info_insert_result = camera_infos_sent.insert(image_topic_name);
-    if (camera_info_insert_result.second) {
-      try {
-        info_publishers_.at(image_topic_name)->publish(compressed_image_data.info);
-      } catch (const std::out_of_range& e) {
-        return tl::make_unexpected("No camera_info publisher exists for camera info topic`" + image_topic_name + "`.");
+    std::vector<std::pair<ImageSource, ImageWithCameraInfo>>& images,
+    std::vector<std::pair<ImageSource, CompressedImageWithCameraInfo>>& compressed_images) {
+  // With intra-process communication, every message is handed to the middleware as a unique_ptr, which rclcpp can pass
+  // on to a single intra-process subscriber without copying it. Without it, rclcpp serializes the message either way,
+  // so it is published in place and its buffer stays with the caller. Topic names are only built to report errors.
+  // Messages are copied for the recorder before they are published, since publishing may move them.
+  const auto recording = recording_tap_->isActive();
+  const auto log_time = recording ? node_->now() : rclcpp::Time{};
+  std::array<bool, kNumImageSources> camera_infos_sent{};
+  for (auto& [image_source, image_data] : images) {
+    const auto index = toImageSourceIndex(image_source);
+    auto& publishers = publishers_[index];
+    if (!publishers.image) {
+      return tl::make_unexpected("No image publisher exists for image topic `" + toRosTopic(image_source) + "`.");
+    }
+    if (recording && image_source.type != SpotImageType::RGB) {
+      recording_tap_->record(publishers.image->get_topic_name(), image_data.image, log_time);
+    }
+    publishMessage(*publishers.image, image_data.image, move_messages_);
+    if (!publishers.info) {
+      return tl::make_unexpected("No camera_info publisher exists for camera info topic`" + toRosTopic(image_source) +
+                                 "`.");
+    }
+    if (recording) {
+      recording_tap_->record(publishers.info->get_topic_name(), image_data.info, log_time);
+    }
+    publishMessage(*publishers.info, image_data.info, move_messages_);
+    camera_infos_sent[index] = true;
+  }
+  for (auto& [image_source, compressed_image_data] : compressed_images) {
+    const auto index = toImageSourceIndex(image_source);
+    auto& publishers = publishers_[index];
+    if (!publishers.compressed_image) {
+      return tl::make_unexpected("No compressed image publisher exists for image topic `" + toRosTopic(image_source) +
+                                 "`.");
+    }
+    if (recording) {
+      recording_tap_->record(publishers.compressed_image->get_topic_name(), compressed_image_data.image, log_time);
+    }
+    publishMessage(*publishers.compressed_image, compressed_image_data.image, move_messages_);
+    if (!camera_infos_sent[index]) {
+      if (!publishers.info) {
+        return tl::make_unexpected("No camera_info publisher exists for camera info topic`" +
+                                   toRosTopic(image_source) + "`.");
+      }
+      if (recording) {
+        recording_tap_->record(publishers.info->get_topic_name(), compressed_image_data.info, log_time);
       }
+      publishMessage(*publishers.info, compressed_image_data.info, move_messages_);
+      camera_infos_sent[index] = true;
+    }
+  }
+  return {};
+}
+
+tl::expected<void, std::string> ImagesMiddlewareHandle::publishPreviewImages(
+    std::vector<std::pair<ImageSource, ImageWithCameraInfo>> preview_images) {
+  for (auto& [image_source, preview_data] : preview_images) {
+    auto& publishers = publishers_[toImageSourceIndex(image_source)];
+    if (!publishers.preview_image || !publishers.preview_info) {
+      return tl::make_unexpected("No preview publishers exist for image topic `" + toRosTopic(image_source) + "`.");
+    }
+    publishers.preview_image->publish(std::make_unique<sensor_msgs::msg::Image>(std::move(preview_data.image)));
+    publishers.preview_info->publish(std::make_unique<sensor_msgs::msg::CameraInfo>(std::move(preview_data.info)));
+  }
+  return {};
+}
+
+tl::expected<void, std::string> ImagesMiddlewareHandle::publishPointClouds(
+    std::vector<std::pair<ImageSource, sensor_msgs::msg::PointCloud2>> point_clouds) {
+  for (auto& [image_source, point_cloud] : point_clouds) {
+    auto& publishers = publishers_[toImageSourceIndex(image_source)];
+    if (!publishers.point_cloud) {
+      return tl::make_unexpected("No point cloud publisher exists for image topic `" + toRosTopic(image_source) + "`.");
+    }
+    publishers.point_cloud->publish(std::make_unique<sensor_msgs::msg::PointCloud2>(std::move(point_cloud)));
+  }
+  return {};
+}
+
+tl::expected<void, std::string> ImagesMiddlewareHandle::publishCompressedDepthImages(
+    std::vector<std::pair<ImageSource, sensor_msgs::msg::CompressedImage>> compressed_depth_images) {
+  for (auto& [image_source, compressed_depth_image] : compressed_depth_images) {
+    auto& publishers = publishers_[toImageSourceIndex(image_source)];
+    if (!publishers.compressed_depth_image) {
+      return tl::make_unexpected("No compressed depth image publisher exists for image topic `" +
+                                 toRosTopic(image_source) + "`.");
+    }
+    publishers.compressed_depth_image->publish(
+        std::make_unique<sensor_msgs::msg::CompressedImage>(std::move(compressed_depth_image)));
+  }
+  return {};
+}
+
+tl::expected<void, std::string> ImagesMiddlewareHandle::publishFilteredDepthImages(
+    std::vector<std::pair<ImageSource, ImageWithCameraInfo>> filtered_depth_images) {
+  for (auto& [image_source, filtered_data] : filtered_depth_images) {
+    auto& publishers = publishers_[toImageSourceIndex(image_source)];
+    if (!publishers.filtered_depth_image || !publishers.filtered_depth_info) {
+      return tl::make_unexpected("No filtered depth image publishers exist for image topic `" +
+                                 toRosTopic(image_source) + "`.");
     }
+    publishers.filtered_depth_image->publish(std::make_unique<sensor_msgs::msg::Image>(std::move(filtered_data.image)));
+    publishers.filtered_depth_info->publish(
+        std::make_unique<sensor_msgs::msg::CameraInfo>(std::move(filtered_data.info)));
+  }
+  return {};
+}
+
+tl::expected<void, std::string> ImagesMiddlewareHandle::publishLaserScan(sensor_msgs::msg::LaserScan scan) {
+  if (!laser_scan_publisher_) {
+    return tl::make_unexpected(std::string{"No laser scan publisher exists for topic `"} + kLaserScanTopic + "`.");
   }
+  laser_scan_publisher_->publish(std::make_unique<sensor_msgs::msg::LaserScan>(std::move(scan)));
   return {};
 }
 
+tl::expected<void, std::string> ImagesMiddlewareHandle::publishStitchedImage(const sensor_msgs::msg::Image& image,
+                                                                             const sensor_msgs::msg::CameraInfo& info) {
+  if (!stitched_image_publisher_ || !stitched_info_publisher_) {
+    return tl::make_unexpected(std::string{"No stitched image publisher exists."});
+  }
+  stitched_image_publisher_->publish(image);
+  stitched_info_publisher_->publish(info);
+  return {};
+}
+
+tl::expected<void, std::string> ImagesMiddlewareHandle::publishImageBundle(spot_msgs::msg::ImageBundle bundle) {
+  if (!image_bundle_publisher_) {
+    return tl::make_unexpected(std::string{"No image bundle publisher exists for topic `"} + kImageBundleTopic + "`.");
+  }
+  image_bundle_publisher_->publish(std::make_unique<spot_msgs::msg::ImageBundle>(std::move(bundle)));
+  return {};
+}
+
+tl::expected<void, std::string> ImagesMiddlewareHandle::publishRawImageResponse(std::vector<std::uint8_t> data) {
+  if (!raw_response_publisher_) {
+    return tl::make_unexpected(std::string{"No raw image response publisher exists for topic `"} +
+                               kRawImageResponseTopic + "`.");
+  }
+  auto message = std::make_unique<spot_msgs::msg::SerializedProto>();
+  message->header.stamp = node_->now();
+  message->type_name = ::bosdyn::api::GetImageResponse::descriptor()->full_name();
+  message->data = std::move(data);
+  raw_response_publisher_->publish(std::move(message));
+  return {};
+}
+
+bool ImagesMiddlewareHandle::hasSubscribers(const ImageSource& image_source) const {
+  // The recorder needs every image, like a subscriber of every topic.
+  if (recording_tap_->isActive()) {
+    return true;
+  }
+  const auto& publishers = publishers_[toImageSourceIndex(image_source)];
+  const auto has_subscribers = [](const auto& publisher) {
+    return publisher && publisher->get_subscription_count() > 0;
+  };
+  return has_subscribers(publishers.image) || has_subscribers(publishers.compressed_image) ||
+         has_subscribers(publishers.info) || has_subscribers(publishers.preview_image) ||
+         has_subscribers(publishers.preview_info) || has_subscribers(publishers.point_cloud) ||
+         has_subscribers(publishers.compressed_depth_image) || has_subscribers(publishers.filtered_depth_image) ||
+         has_subscribers(publishers.filtered_depth_info);
+}
+
+bool ImagesMiddlewareHandle::hasImageBundleSubscribers() const {
+  return image_bundle_publisher_ && image_bundle_publisher_->get_subscription_count() > 0;
+}
+
+bool ImagesMiddlewareHandle::hasLaserScanSubscribers() const {
+  return laser_scan_publisher_ && laser_scan_publisher_->get_subscription_count() > 0;
+}
+
+bool ImagesMiddlewareHandle::hasStitchedImageSubscribers() const {
+  return (stitched_image_publisher_ && stitched_image_publisher_->get_subscription_count() > 0) ||
+         (stitched_info_publisher_ && stitched_info_publisher_->get_subscription_count() > 0);
+}
+
+bool ImagesMiddlewareHandle::hasRawImageResponseSubscribers() const {
+  return raw_response_publisher_ && raw_response_publisher_->get_subscription_count() > 0;
+}
+
+void ImagesMiddlewareHandle::publishLatencyDiagnostics(const diagnostic_msgs::msg::DiagnosticArray& diagnostics) {
+  if (!diagnostics_publisher_) {
+    diagnostics_publisher_ = node_->create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+        kDiagnosticsTopic, rclcpp::QoS(rclcpp::KeepLast(kDiagnosticsHistoryDepth)));
+  }
+  auto message = diagnostics;
+  message.header.stamp = node_->now();
+  diagnostics_publisher_->publish(message);
+}
+
 }  // namespace spot_ros2::images
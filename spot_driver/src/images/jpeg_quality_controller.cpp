@@ -0,0 +1,67 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/images/jpeg_quality_controller.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+// Fraction of the period which a request may take before the quality is lowered. The rest is left for converting and
+// publishing the images, and for variations of the link throughput.
+constexpr auto kMaxPeriodUtilization = 0.8;
+// Fraction of the period below which a request is fast enough to raise the quality again. The gap to
+// kMaxPeriodUtilization keeps the quality from oscillating while the throughput is stable.
+constexpr auto kMinPeriodUtilization = 0.5;
+// Largest step by which the quality of a source is lowered after a single slow request.
+constexpr auto kMaxQualityDecrease = 20.0;
+// Step by which the quality is raised after a fast request. This is smaller than the decrease, so that the controller
+// backs off quickly when the link degrades and probes carefully when it recovers.
+constexpr auto kQualityIncrease = 2.0;
+}  // namespace
+
+namespace spot_ros2::images {
+
+JpegQualityController::JpegQualityController(const double min_quality, const double max_quality,
+                                             const std::chrono::duration<double> target_period)
+    : min_quality_{std::clamp(std::min(min_quality, max_quality), 0.0, 100.0)},
+      max_quality_{std::clamp(max_quality, 0.0, 100.0)},
+      target_period_{target_period} {
+  qualities_.fill(max_quality_);
+}
+
+void JpegQualityController::update(const std::vector<std::pair<ImageSource, std::size_t>>& response_sizes,
+                                   const std::chrono::duration<double> request_duration) {
+  if (response_sizes.empty() || target_period_.count() <= 0.0) {
+    return;
+  }
+
+  const auto utilization = request_duration / target_period_;
+  if (utilization < kMinPeriodUtilization) {
+    for (const auto& [source, size] : response_sizes) {
+      auto& quality = qualities_[toImageSourceIndex(source)];
+      quality = std::min(quality + kQualityIncrease, max_quality_);
+    }
+    return;
+  }
+  if (utilization <= kMaxPeriodUtilization) {
+    return;
+  }
+
+  // Lower the quality in proportion to how far the request overran, and to the share of the bytes of each source.
+  const auto total_size = std::accumulate(response_sizes.cbegin(), response_sizes.cend(), std::size_t{0},
+                                          [](const std::size_t sum, const auto& entry) { return sum + entry.second; });
+  const auto overrun = std::min(utilization / kMaxPeriodUtilization - 1.0, 1.0);
+  for (const auto& [source, size] : response_sizes) {
+    const auto share = total_size > 0 ? static_cast<double>(size) / static_cast<double>(total_size)
+                                      : 1.0 / static_cast<double>(response_sizes.size());
+    const auto relative_share = std::min(share * static_cast<double>(response_sizes.size()), 1.0);
+    auto& quality = qualities_[toImageSourceIndex(source)];
+    quality = std::max(quality - kMaxQualityDecrease * overrun * relative_share, min_quality_);
+  }
+}
+
+double JpegQualityController::quality(const ImageSource& image_source) const {
+  return qualities_[toImageSourceIndex(image_source)];
+}
+
+}  // namespace spot_ros2::images
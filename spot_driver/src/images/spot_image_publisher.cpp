@@ -8,34 +8,130 @@
 #include <sensor_msgs/msg/image.hpp>
 #include <spot_driver/api/default_image_client.hpp>
 #include <spot_driver/api/spot_image_sources.hpp>
+#include <spot_driver/conversions/compressed_depth.hpp>
+#include <spot_driver/conversions/depth_filter.hpp>
+#include <spot_driver/conversions/depth_laser_scan.hpp>
+#include <spot_driver/conversions/jpeg_decoder.hpp>
+#include <spot_driver/image_stitcher/front_image_stitcher.hpp>
 #include <spot_driver/images/images_middleware_handle.hpp>
 #include <spot_driver/interfaces/rclcpp_logger_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_parameter_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_tf_broadcaster_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_wall_timer_interface.hpp>
+#include <spot_driver/interfaces/thread_settings.hpp>
+#include <spot_driver/interfaces/work_stealing_thread_pool.hpp>
+#include <spot_driver/tracing.hpp>
 #include <spot_driver/types.hpp>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
 #include <memory>
 #include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace {
-constexpr auto kImageCallbackPeriod = std::chrono::duration<double>{1.0 / 15.0};  // 15 Hz
+constexpr auto kFallbackImagePublishRate = 15.0;  // Hz
 constexpr auto kDefaultDepthImageQuality = 100.0;
+constexpr auto kLatencyReportPeriod = std::chrono::seconds{1};
+constexpr auto kLatencyDiagnosticsNamePrefix = "spot_image_publisher: ";
+constexpr auto kBodyFrame = "body";
+// Failures in the image pipeline repeat with every request until they clear, e.g. while the robot is out of WiFi
+// range, so they are logged at most once per period.
+constexpr auto kFailureLogPeriod = std::chrono::seconds{5};
+// Sums of the request shares of a group can fall short of a whole request by rounding, e.g. three shares of 2/3.
+constexpr auto kRequestCreditTolerance = 1e-9;
+
+/**
+ * @brief Read the virtual camera and blending parameters of the front image stitcher, which are the same as those of
+ * the image stitcher node.
+ *
+ * @param parameters Parameters of the driver.
+ * @return The options of the stitcher, or an error message if the intrinsics, the projection plane or the blend mode
+ * are not valid.
+ */
+tl::expected<spot_ros2::FrontImageStitcherOptions, std::string> getFrontImageStitcherOptions(
+    const spot_ros2::ParameterInterfaceBase& parameters) {
+  spot_ros2::FrontImageStitcherOptions options;
+  const auto spot_name = parameters.getSpotName();
+  const auto frame_prefix = spot_name.empty() ? "" : spot_name + "/";
+  options.body_frame = frame_prefix + kBodyFrame;
+  options.camera_frame = frame_prefix + parameters.getVirtualCameraFrame();
+  const auto intrinsics = parameters.getVirtualCameraIntrinsics();
+  if (!intrinsics.empty()) {
+    if (intrinsics.size() != 9) {
+      return tl::make_unexpected("virtual_camera_intrinsics must have 9 values, but has " +
+                                 std::to_string(intrinsics.size()) + ".");
+    }
+    options.intrinsics = cv::Matx33d(intrinsics.data());
+  }
+  const auto plane_normal = parameters.getVirtualCameraProjectionPlane();
+  if (!plane_normal.empty()) {
+    if (plane_normal.size() != 3) {
+      return tl::make_unexpected("virtual_camera_projection_plane must have 3 values, but has " +
+                                 std::to_string(plane_normal.size()) + ".");
+    }
+    options.plane_normal = cv::Vec3d(plane_normal.data());
+  }
+  try {
+    options.blend_mode = spot_ros2::toStitchBlendMode(parameters.getStitchedImageBlendMode());
+  } catch (const std::domain_error& e) {
+    return tl::make_unexpected(std::string{"Invalid stitched_image_blend_mode: "} + e.what());
+  }
+  options.plane_distance = parameters.getVirtualCameraPlaneDistance();
+  options.row_padding = parameters.getStitchedImageRowPadding();
+  options.seam_update_period = std::max(0, parameters.getStitchedImageSeamUpdatePeriod());
+  options.blend_width = std::max(1, parameters.getStitchedImageBlendWidth());
+  options.use_gpu = parameters.getStitchedImageUseGpu();
+  return options;
+}
+
+/**
+ * @brief Move the entries of image sources which are marked as repeated to the end of a vector.
+ *
+ * @param entries Entries of the image sources, which keep their order if they are not repeated.
+ * @param repeated Whether each image source is repeated, indexed by toImageSourceIndex().
+ * @return Iterator to the first repeated entry.
+ */
+template <typename T>
+typename std::vector<std::pair<spot_ros2::ImageSource, T>>::iterator partitionRepeated(
+    std::vector<std::pair<spot_ros2::ImageSource, T>>& entries,
+    const std::array<bool, spot_ros2::kNumImageSources>& repeated) {
+  return std::stable_partition(entries.begin(), entries.end(), [&repeated](const auto& entry) {
+    return !repeated[spot_ros2::toImageSourceIndex(entry.first)];
+  });
+}
 }  // namespace
 
 namespace spot_ros2::images {
 ::bosdyn::api::GetImageRequest createImageRequest(const std::set<ImageSource>& sources, const bool has_rgb_cameras,
-                                                  const double rgb_image_quality, const bool get_raw_rgb_images) {
+                                                  const double rgb_image_quality, const bool get_raw_rgb_images,
+                                                  const bool get_rle_depth_images, const double rgb_resize_ratio) {
   ::bosdyn::api::GetImageRequest request_message;
 
   for (const auto& source : sources) {
-    const auto source_name = toSpotImageSourceName(source);
+    const auto& source_name = toSpotImageSourceName(source);
 
     if (source.type == SpotImageType::RGB) {
       bosdyn::api::ImageRequest* image_request = request_message.add_image_requests();
       image_request->set_image_source_name(source_name);
       // JPEG images can have a user-configurable image quality setting.
       image_request->set_quality_percent(rgb_image_quality);
+      // Spot only scales images down, and a ratio of 1.0 is the same as not setting it.
+      if (rgb_resize_ratio < 1.0) {
+        image_request->set_resize_ratio(rgb_resize_ratio);
+      }
       // The hand camera always provides RGB images
       if (source.camera == SpotCamera::HAND || has_rgb_cameras) {
         image_request->set_pixel_format(bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_RGB_U8);
@@ -51,13 +147,16 @@ namespace spot_ros2::images {
       bosdyn::api::ImageRequest* image_request = request_message.add_image_requests();
       image_request->set_image_source_name(source_name);
       image_request->set_quality_percent(kDefaultDepthImageQuality);
-      image_request->set_image_format(bosdyn::api::Image_Format_FORMAT_RAW);
+      // Depth images can be either raw or run-length encoded, which is lossless.
+      image_request->set_image_format(get_rle_depth_images ? bosdyn::api::Image_Format_FORMAT_RLE
+                                                           : bosdyn::api::Image_Format_FORMAT_RAW);
     } else {
       // SpotImageType::DEPTH_REGISTERED
       bosdyn::api::ImageRequest* image_request = request_message.add_image_requests();
       image_request->set_image_source_name(source_name);
       image_request->set_quality_percent(kDefaultDepthImageQuality);
-      image_request->set_image_format(bosdyn::api::Image_Format_FORMAT_RAW);
+      image_request->set_image_format(get_rle_depth_images ? bosdyn::api::Image_Format_FORMAT_RLE
+                                                           : bosdyn::api::Image_Format_FORMAT_RAW);
     }
   }
 
@@ -69,70 +168,1000 @@ SpotImagePublisher::SpotImagePublisher(const std::shared_ptr<ImageClientInterfac
                                        std::unique_ptr<ParameterInterfaceBase> parameters,
                                        std::unique_ptr<LoggerInterfaceBase> logger,
                                        std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster,
-                                       std::unique_ptr<TimerInterfaceBase> timer, bool has_arm)
+                                       std::unique_ptr<TimerInterfaceBase> timer, bool has_arm,
+                                       std::unique_ptr<TimerInterfaceBase> hand_camera_timer,
+                                       const std::shared_ptr<metrics::MetricsRegistry>& metrics_registry,
+                                       std::shared_ptr<ThreadPoolInterfaceBase> thread_pool)
     : image_client_interface_{image_client_interface},
       middleware_handle_{std::move(middleware_handle)},
       parameters_{std::move(parameters)},
       logger_{std::move(logger)},
       tf_broadcaster_{std::move(tf_broadcaster)},
       timer_{std::move(timer)},
-      has_arm_{has_arm} {}
+      hand_camera_timer_{std::move(hand_camera_timer)},
+      thread_pool_{std::move(thread_pool)},
+      has_arm_{has_arm},
+      metrics_registry_{metrics_registry},
+      rpc_failures_{metrics_registry_->counter("images.rpc_failures")},
+      stale_images_dropped_{metrics_registry_->counter("images.stale_images_dropped")},
+      rpc_latency_{metrics_registry_->histogram("images.rpc_latency")},
+      decode_time_{metrics_registry_->histogram("images.decode_time")},
+      publish_time_{metrics_registry_->histogram("images.publish_time")} {}
+
+SpotImagePublisher::~SpotImagePublisher() {
+  // Stop every source of new requests before waiting for the requests in flight. A tick which is already running sees
+  // stopping_ once it holds its mutex, and does not start any further request.
+  stopping_ = true;
+  timer_->clearTimer();
+  if (hand_camera_timer_) {
+    hand_camera_timer_->clearTimer();
+  }
+  {
+    std::lock_guard<std::mutex> lock{request_groups_mutex_};
+    waitForGroupRequests();
+  }
+  // The stream thread either saw stopping_ while it held the mutex, or is waiting for this notification.
+  stream_resumed_.notify_all();
+  if (stream_thread_.joinable()) {
+    stream_thread_.join();
+  }
+  {
+    std::lock_guard<std::mutex> lock{hand_camera_mutex_};
+    if (hand_camera_request_.valid()) {
+      hand_camera_request_.wait();
+    }
+  }
+}
 
 bool SpotImagePublisher::initialize() {
   // These parameters all fall back to default values if the user did not set them at runtime
-  const auto rgb_image_quality = parameters_->getRGBImageQuality();
-  const auto publish_rgb_images = parameters_->getPublishRGBImages();
-  const auto publish_depth_images = parameters_->getPublishDepthImages();
-  const auto publish_depth_registered_images = parameters_->getPublishDepthRegisteredImages();
-  const auto has_rgb_cameras = parameters_->getHasRGBCameras();
-  // always use compressed transport from SPOT, we decompress it in paralell if desired
-  const auto publish_raw_rgb_cameras = false;
   const auto uncompress_images = parameters_->getUncompressImages();
   const auto publish_compressed_images = parameters_->getPublishCompressedImages();
-  const auto gripperless = parameters_->getGripperless();
+  uncompress_images_ = uncompress_images;
+  publish_compressed_images_ = publish_compressed_images;
+  on_demand_images_ = parameters_->getOnDemandImages();
+  link_monitor_.reset();
+  if (parameters_->getDegradeOnPoorLink()) {
+    link_monitor_ = LinkMonitor::getForRobot(parameters_->getSpotName());
+    link_monitor_->configure(makeLinkMonitorOptions(*parameters_));
+    degraded_rate_divisor_ = static_cast<std::size_t>(std::max(parameters_->getDegradedRateDivisor(), 1));
+    degraded_rgb_image_quality_ = std::clamp(parameters_->getDegradedRGBImageQuality(), 0.0, 100.0);
+  }
+  publish_image_bundle_ = parameters_->getPublishImageBundle();
+  publish_raw_protobuf_ = parameters_->getPublishRawProtobuf();
+  stream_images_ = parameters_->getStreamImages();
+  last_image_stamps_.fill(builtin_interfaces::msg::Time{});
+  last_laser_scan_stamp_ = builtin_interfaces::msg::Time{};
+  image_bundle_transforms_.clear();
+  get_images_options_.max_decode_threads =
+      static_cast<std::size_t>(std::max(parameters_->getImageDecodeThreads(), 1));
+  get_images_options_.max_requests_in_flight =
+      static_cast<std::size_t>(std::max(parameters_->getImageRequestsInFlight(), 1));
+  get_images_options_.timeout = std::chrono::duration<double>{parameters_->getImageRequestTimeout()};
+  get_images_options_.static_transforms_refresh_period =
+      std::chrono::duration<double>{parameters_->getStaticTransformsRefreshPeriod()};
+  get_images_options_.message_pool = message_pool_;
+  get_images_options_.measure_latency = parameters_->getPublishImageLatencyDiagnostics();
+  latency_statistics_.clear();
+  last_latency_report_ = {};
+  get_images_options_.max_image_age = std::chrono::duration<double>{std::max(parameters_->getMaxImageAge(), 0.0)};
+  get_images_options_.keep_raw_response = publish_raw_protobuf_;
+  get_images_options_.convert_images = !(publish_raw_protobuf_ && parameters_->getRawProtobufOnly());
+
+  const auto jpeg_decoder_parameter = toJpegDecoderBackend(parameters_->getJpegDecoder());
+  if (jpeg_decoder_parameter.has_value()) {
+    get_images_options_.jpeg_decoder = jpeg_decoder_parameter.value();
+  } else {
+    logger_->logWarn("Invalid jpeg_decoder parameter! Got error: " + jpeg_decoder_parameter.error() +
+                     " Defaulting to decoding with OpenCV.");
+    get_images_options_.jpeg_decoder = JpegDecoderBackend::OPENCV;
+  }
+  if (!isJpegDecoderBackendAvailable(get_images_options_.jpeg_decoder)) {
+    logger_->logWarn("The requested JPEG decoder backend was not available at build time. Decoding with OpenCV.");
+    get_images_options_.jpeg_decoder = JpegDecoderBackend::OPENCV;
+  }
+  for (const auto& [camera_name, camera] : kRosStringToSpotCamera) {
+    const auto encoding = toJpegOutputEncoding(parameters_->getCameraImageEncoding(camera));
+    if (encoding.has_value()) {
+      get_images_options_.color_image_encodings[static_cast<std::size_t>(camera)] = encoding.value();
+    } else {
+      logger_->logWarn("Invalid image_encoding." + camera_name + " parameter! Got error: " + encoding.error() +
+                       " Defaulting to bgr8.");
+      get_images_options_.color_image_encodings[static_cast<std::size_t>(camera)] = JpegOutputEncoding::BGR8;
+    }
+  }
+
+  get_images_options_.point_clouds.reset();
+  if (parameters_->getPublishDepthPointClouds()) {
+    PointCloudOptions point_cloud_options;
+    point_cloud_options.voxel_size = parameters_->getPointCloudVoxelSize();
+    point_cloud_options.colorize_registered = parameters_->getColorizeRegisteredPointClouds();
+    if (point_cloud_options.colorize_registered && !uncompress_images) {
+      logger_->logWarn("colorize_registered_point_clouds needs uncompress_images to decode the RGB images. Publishing "
+                       "point clouds without colors.");
+      point_cloud_options.colorize_registered = false;
+    }
+    if (point_cloud_options.voxel_size < 0.0) {
+      logger_->logWarn("Invalid point_cloud_voxel_size parameter: " + std::to_string(point_cloud_options.voxel_size) +
+                       ". Publishing point clouds without decimation.");
+      point_cloud_options.voxel_size = 0.0;
+    }
+    get_images_options_.point_clouds = point_cloud_options;
+  }
+
+  get_images_options_.compressed_depth.reset();
+  if (parameters_->getPublishCompressedDepthImages()) {
+    const auto compressed_depth_format = toCompressedDepthFormat(parameters_->getCompressedDepthFormat());
+    if (compressed_depth_format.has_value()) {
+      get_images_options_.compressed_depth = compressed_depth_format.value();
+    } else {
+      logger_->logWarn("Invalid compressed_depth_format parameter! Got error: " + compressed_depth_format.error() +
+                       " Defaulting to PNG.");
+      get_images_options_.compressed_depth = CompressedDepthFormat::PNG;
+    }
+  }
+
+  get_images_options_.depth_filter.reset();
+  if (parameters_->getPublishFilteredDepthImages()) {
+    DepthFilterOptions depth_filter_options;
+    const auto decimation = parameters_->getFilteredDepthDecimation();
+    if (decimation < 1) {
+      logger_->logWarn("Invalid filtered_depth_decimation parameter: " + std::to_string(decimation) +
+                       ". Filtering depth images without decimation.");
+    }
+    depth_filter_options.decimation = static_cast<std::uint32_t>(std::max(decimation, 1));
+    depth_filter_options.fill_holes = parameters_->getFilteredDepthFillHoles();
+    depth_filter_options.min_range = std::max(parameters_->getFilteredDepthMinRange(), 0.0);
+    depth_filter_options.max_range = parameters_->getFilteredDepthMaxRange();
+    get_images_options_.depth_filter = depth_filter_options;
+  }
+
+  get_images_options_.laser_scan.reset();
+  if (parameters_->getPublishLaserScan()) {
+    LaserScanOptions laser_scan_options;
+    laser_scan_options.min_height = parameters_->getLaserScanMinHeight();
+    laser_scan_options.max_height = parameters_->getLaserScanMaxHeight();
+    laser_scan_options.range_max = parameters_->getLaserScanRangeMax();
+    laser_scan_options.angle_increment = parameters_->getLaserScanAngleIncrement();
+    if (laser_scan_options.min_height >= laser_scan_options.max_height ||
+        laser_scan_options.range_max <= laser_scan_options.range_min || laser_scan_options.angle_increment <= 0.0) {
+      logger_->logWarn("Invalid laser scan parameters! laser_scan_min_height must be below laser_scan_max_height, "
+                       "laser_scan_range_max above the minimum range and laser_scan_angle_increment positive. Not "
+                       "publishing the laser scan.");
+    } else {
+      get_images_options_.laser_scan = laser_scan_options;
+    }
+  }
+
+  preview_options_.reset();
+  const auto preview_scale = parameters_->getImagePreviewScale();
+  const auto preview_roi = parameters_->getImagePreviewRegion();
+  const auto valid_preview_roi =
+      preview_roi.size() == 4 && std::all_of(preview_roi.cbegin(), preview_roi.cend(), [](const auto value) {
+        return value >= 0 && value <= std::numeric_limits<std::uint32_t>::max();
+      });
+  if (preview_scale < 1) {
+    logger_->logWarn("Invalid image_preview_scale parameter: " + std::to_string(preview_scale) +
+                     ". Not publishing preview images.");
+  } else if (!preview_roi.empty() && !valid_preview_roi) {
+    logger_->logWarn("Invalid image_preview_roi parameter! Expected [x, y, width, height] in pixels. Not publishing "
+                     "preview images.");
+  } else if (preview_scale > 1 || valid_preview_roi) {
+    ImagePreviewOptions options;
+    options.scale_divisor = static_cast<std::uint32_t>(preview_scale);
+    if (valid_preview_roi) {
+      options.roi_x = static_cast<std::uint32_t>(preview_roi[0]);
+      options.roi_y = static_cast<std::uint32_t>(preview_roi[1]);
+      options.roi_width = static_cast<std::uint32_t>(preview_roi[2]);
+      options.roi_height = static_cast<std::uint32_t>(preview_roi[3]);
+    }
+    preview_options_ = options;
+  }
+
+  auto plan = createImageRequestPlan(*parameters_);
+  const auto& sources = plan.sources;
+  image_request_groups_ = std::move(plan.groups);
+  hand_camera_group_ = std::move(plan.hand_camera_group);
+  hand_camera_period_ = plan.hand_camera_period;
+  {
+    std::lock_guard<std::mutex> budget_lock{bandwidth_budget_mutex_};
+    bandwidth_budget_ = std::move(plan.bandwidth_budget);
+  }
+  timer_period_ = plan.timer_period;
+  skip_next_tick_ = false;
+
+  // The front images are stitched straight from the responses, which needs both of them decoded in the same request.
+  front_stitcher_.reset();
+  virtual_camera_transform_sent_ = false;
+  get_images_options_.body_transform_sources.clear();
+  stitched_camera_.clear();
+  if (parameters_->getPublishStitchedFrontImage()) {
+    const ImageSource left_source{SpotCamera::FRONTLEFT, SpotImageType::RGB};
+    const ImageSource right_source{SpotCamera::FRONTRIGHT, SpotImageType::RGB};
+    const auto stitcher_options = getFrontImageStitcherOptions(*parameters_);
+    if (!uncompress_images) {
+      logger_->logWarn("publish_stitched_front_image needs uncompress_images to decode the front images. Not "
+                       "publishing the stitched image.");
+    } else if (sources.count(left_source) == 0 || sources.count(right_source) == 0) {
+      logger_->logWarn("publish_stitched_front_image needs the RGB images of the frontleft and frontright cameras. Not "
+                       "publishing the stitched image.");
+    } else if (parameters_->getCameraPublishRate(SpotCamera::FRONTLEFT) !=
+               parameters_->getCameraPublishRate(SpotCamera::FRONTRIGHT)) {
+      logger_->logWarn("publish_stitched_front_image needs the same image_rate for the frontleft and frontright "
+                       "cameras, so that their images are requested together. Not publishing the stitched image.");
+    } else if (get_images_options_.color_image_encodings[static_cast<std::size_t>(SpotCamera::FRONTLEFT)] ==
+                   JpegOutputEncoding::NV12 ||
+               get_images_options_.color_image_encodings[static_cast<std::size_t>(SpotCamera::FRONTRIGHT)] ==
+                   JpegOutputEncoding::NV12) {
+      logger_->logWarn("publish_stitched_front_image cannot stitch the front images in the nv12 image_encoding. Not "
+                       "publishing the stitched image.");
+    } else if (!stitcher_options.has_value()) {
+      logger_->logWarn("Invalid stitched image parameters! Got error: " + stitcher_options.error() +
+                       " Not publishing the stitched image.");
+    } else {
+      front_stitcher_ = std::make_unique<FrontImageStitcher>(stitcher_options.value());
+      get_images_options_.body_transform_sources = {left_source, right_source};
+      stitched_camera_ = parameters_->getVirtualCameraFrame();
+    }
+  }
+
+  // Create a publisher for each image source
+  createPublishers(sources);
+
+  // The image client decodes the images on the workers of the shared thread pool.
+  if (const auto result =
+          makeThreadSettings(*parameters_, "workers", "spot_worker").and_then(configureSharedThreadPool);
+      !result) {
+    logger_->logWarn(result.error());
+  }
+
+  if (parameters_->getWarmUpImages()) {
+    warmUp(uncompress_images, publish_compressed_images);
+  }
+
+  if (stream_images_) {
+    stopping_ = false;
+    stream_thread_ = std::thread{[this, uncompress_images, publish_compressed_images]() {
+      streamImages(uncompress_images, publish_compressed_images);
+    }};
+    if (const auto result =
+            configureThread(stream_thread_.native_handle(), *parameters_, "image_stream", "spot_images");
+        !result) {
+      logger_->logWarn(result.error());
+    }
+  } else {
+    // Create a timer to request and publish images at a fixed rate
+    timer_->setTimer(timer_period_, [this, uncompress_images, publish_compressed_images]() {
+      timerCallback(uncompress_images, publish_compressed_images);
+    });
+  }
+  if (hand_camera_group_.has_value()) {
+    hand_camera_timer_->setTimer(hand_camera_period_, [this, uncompress_images, publish_compressed_images]() {
+                                   handCameraTimerCallback(uncompress_images, publish_compressed_images);
+                                 });
+  }
+
+  return true;
+}
+
+bool SpotImagePublisher::updateImageSources(std::unique_ptr<ParameterInterfaceBase> parameters) {
+  auto plan = createImageRequestPlan(*parameters);
+
+  // The stitcher and its publishers are only created by initialize(), which is needed if the new sources or rates
+  // would enable or disable it.
+  const bool front_cameras_stitchable =
+      plan.sources.count(ImageSource{SpotCamera::FRONTLEFT, SpotImageType::RGB}) > 0 &&
+      plan.sources.count(ImageSource{SpotCamera::FRONTRIGHT, SpotImageType::RGB}) > 0 &&
+      parameters->getCameraPublishRate(SpotCamera::FRONTLEFT) ==
+          parameters->getCameraPublishRate(SpotCamera::FRONTRIGHT);
+  const bool stitching_requested = parameters->getPublishStitchedFrontImage() && uncompress_images_;
+  if ((front_stitcher_ && !front_cameras_stitchable) ||
+      (!front_stitcher_ && stitching_requested && front_cameras_stitchable)) {
+    return false;
+  }
+
+  // Wait for the body camera request and the hand camera request in flight, if any. The publishers are replaced last,
+  // since the requests take the publish mutex while they hold the others.
+  update_pending_ = true;
+  std::lock_guard<std::mutex> groups_lock{request_groups_mutex_};
+  waitForGroupRequests();
+  std::lock_guard<std::mutex> hand_camera_lock{hand_camera_mutex_};
+  if (hand_camera_request_.valid()) {
+    hand_camera_request_.wait();
+  }
+  {
+    std::lock_guard<std::mutex> publish_lock{publish_mutex_};
+    createPublishers(plan.sources);
+  }
+
+  image_request_groups_ = std::move(plan.groups);
+  {
+    std::lock_guard<std::mutex> budget_lock{bandwidth_budget_mutex_};
+    bandwidth_budget_ = std::move(plan.bandwidth_budget);
+  }
+  skip_next_tick_ = false;
+  if (plan.timer_period != timer_period_) {
+    timer_period_ = plan.timer_period;
+    if (!stream_images_) {
+      timer_->setTimer(timer_period_, [this]() {
+        timerCallback(uncompress_images_, publish_compressed_images_);
+      });
+    }
+  }
+
+  hand_camera_group_ = std::move(plan.hand_camera_group);
+  if (plan.hand_camera_period != hand_camera_period_) {
+    hand_camera_period_ = plan.hand_camera_period;
+    if (hand_camera_group_.has_value()) {
+      hand_camera_timer_->setTimer(hand_camera_period_, [this]() {
+        handCameraTimerCallback(uncompress_images_, publish_compressed_images_);
+      });
+    } else {
+      hand_camera_timer_->clearTimer();
+    }
+  }
+  // Only read by initialize(), createImageRequestPlan() and this function, which all run on the thread of the caller.
+  parameters_ = std::move(parameters);
+  // The stream thread takes the mutex again once this function returns.
+  update_pending_ = false;
+  stream_resumed_.notify_all();
+  return true;
+}
+
+void SpotImagePublisher::pause() {
+  paused_ = true;
+  {
+    std::lock_guard<std::mutex> lock{request_groups_mutex_};
+    waitForGroupRequests();
+  }
+  std::lock_guard<std::mutex> lock{hand_camera_mutex_};
+  if (hand_camera_request_.valid()) {
+    hand_camera_request_.wait();
+  }
+}
+
+void SpotImagePublisher::resume() {
+  {
+    std::lock_guard<std::mutex> lock{request_groups_mutex_};
+    paused_ = false;
+  }
+  stream_resumed_.notify_all();
+}
+
+SpotImagePublisher::ImageRequestPlan SpotImagePublisher::createImageRequestPlan(
+    const ParameterInterfaceBase& parameters) {
+  const auto rgb_image_quality = parameters.getRGBImageQuality();
+  const auto publish_rgb_images = parameters.getPublishRGBImages();
+  const auto publish_depth_images = parameters.getPublishDepthImages();
+  const auto publish_depth_registered_images = parameters.getPublishDepthRegisteredImages();
+  const auto has_rgb_cameras = parameters.getHasRGBCameras();
+  // always use compressed transport from SPOT, we decompress it in paralell if desired
+  const auto publish_raw_rgb_cameras = false;
+  const auto gripperless = parameters.getGripperless();
+  const auto rle_depth_images = parameters.getRLEDepthImages();
+  const auto adaptive_rgb_image_quality = parameters.getAdaptiveRGBImageQuality();
+  const auto min_rgb_image_quality = parameters.getMinRGBImageQuality();
+  ImageRequestPlan plan;
 
   std::set<spot_ros2::SpotCamera> cameras_used;
-  const auto cameras_used_parameter = parameters_->getCamerasUsed(has_arm_, gripperless);
+  const auto cameras_used_parameter = parameters.getCamerasUsed(has_arm_, gripperless);
   if (cameras_used_parameter.has_value()) {
     cameras_used = cameras_used_parameter.value();
   } else {
     logger_->logWarn("Invalid cameras_used parameter! Got error: " + cameras_used_parameter.error() +
                      " Defaulting to publishing from all cameras.");
-    cameras_used = parameters_->getDefaultCamerasUsed(has_arm_, gripperless);
+    cameras_used = parameters.getDefaultCamerasUsed(has_arm_, gripperless);
   }
 
   // Generate the set of image sources based on which cameras the user has requested that we publish
-  const auto sources =
+  plan.sources =
       createImageSources(publish_rgb_images, publish_depth_images, publish_depth_registered_images, cameras_used);
+  const auto& sources = plan.sources;
 
-  // Generate the image request message to capture the data from the specified image sources
-  image_request_message_ = createImageRequest(sources, has_rgb_cameras, rgb_image_quality, publish_raw_rgb_cameras);
+  // The hand camera can be streamed on its own timer, so that its larger images do not stall the body cameras.
+  const auto hand_camera_stream_rate = parameters.getHandCameraStreamRate();
+  std::set<ImageSource> hand_camera_sources;
+  if (hand_camera_stream_rate > 0.0 && !hand_camera_timer_) {
+    logger_->logWarn("The hand camera stream is not available. Requesting the hand camera with the body cameras.");
+  } else if (hand_camera_stream_rate > 0.0) {
+    for (const auto& source : sources) {
+      if (source.camera == SpotCamera::HAND) {
+        hand_camera_sources.insert(source);
+      }
+    }
+  }
 
-  // Create a publisher for each image source
-  middleware_handle_->createPublishers(sources, uncompress_images, publish_compressed_images);
+  if (!hand_camera_sources.empty()) {
+    auto resize_ratio = parameters.getHandCameraStreamResizeRatio();
+    if (resize_ratio <= 0.0 || resize_ratio > 1.0) {
+      logger_->logWarn("Invalid hand_camera_stream_resize_ratio parameter: " + std::to_string(resize_ratio) +
+                       ". Streaming the hand camera at full resolution.");
+      resize_ratio = 1.0;
+    }
+    plan.hand_camera_period = std::chrono::duration<double>{1.0 / hand_camera_stream_rate};
+    plan.hand_camera_group = ImageRequestGroup{
+        createImageRequest(hand_camera_sources, has_rgb_cameras, parameters.getHandCameraStreamQuality(),
+                           publish_raw_rgb_cameras, rle_depth_images, resize_ratio),
+        1, std::vector<ImageSource>(hand_camera_sources.cbegin(), hand_camera_sources.cend()), {}, {}, {}};
+    if (adaptive_rgb_image_quality) {
+      plan.hand_camera_group->quality_controller.emplace(
+          min_rgb_image_quality, parameters.getHandCameraStreamQuality(), plan.hand_camera_period);
+    }
+  }
 
-  // Create a timer to request and publish images at a fixed rate
-  timer_->setTimer(kImageCallbackPeriod, [this, uncompress_images, publish_compressed_images]() {
-    timerCallback(uncompress_images, publish_compressed_images);
-  });
+  // Group the image sources by the publish rate of their camera, ordered from the fastest to the slowest rate, so
+  // that cameras which are polled slowly do not add to the latency of requests for cameras which are polled quickly.
+  std::map<double, std::set<ImageSource>, std::greater<double>> sources_by_rate;
+  for (const auto& source : sources) {
+    if (hand_camera_sources.count(source) > 0) {
+      continue;
+    }
+    auto rate = parameters.getCameraPublishRate(source.camera);
+    if (rate <= 0.0) {
+      logger_->logWarn("Invalid image_rate parameter for " + toRosTopic(source) + ": " + std::to_string(rate) +
+                       " Hz. Defaulting to " + std::to_string(kFallbackImagePublishRate) + " Hz.");
+      rate = kFallbackImagePublishRate;
+    }
+    sources_by_rate[rate].insert(source);
+  }
 
-  return true;
+  // The timer runs at the fastest rate, and every group is requested on its share of the timer ticks.
+  const auto timer_rate = sources_by_rate.empty() ? kFallbackImagePublishRate : sources_by_rate.begin()->first;
+
+  // Generate the image request messages to capture the data from the specified image sources
+  for (const auto& [rate, group_sources] : sources_by_rate) {
+    // createImageRequest adds exactly one image request per source, in the order of the set.
+    plan.groups.push_back(ImageRequestGroup{
+        createImageRequest(group_sources, has_rgb_cameras, rgb_image_quality, publish_raw_rgb_cameras,
+                           rle_depth_images),
+        rate / timer_rate, std::vector<ImageSource>(group_sources.cbegin(), group_sources.cend()), {}, {}, {}});
+    if (adaptive_rgb_image_quality) {
+      plan.groups.back().quality_controller.emplace(min_rgb_image_quality, rgb_image_quality,
+                                                    std::chrono::duration<double>{1.0 / rate});
+    }
+  }
+  plan.timer_period = std::chrono::duration<double>{1.0 / timer_rate};
+
+  // The budget is shared by the sources of all groups, and gives each of them its share by the priority of its camera.
+  const auto bandwidth_budget = parameters.getImageBandwidthBudget();
+  if (bandwidth_budget > 0.0) {
+    plan.bandwidth_budget.emplace(bandwidth_budget, min_rgb_image_quality, rgb_image_quality);
+    for (const auto& group : plan.groups) {
+      const auto group_rate = timer_rate * group.requests_per_tick;
+      for (const auto& source : group.sources) {
+        plan.bandwidth_budget->addSource(source, group_rate, parameters.getCameraPriority(source.camera));
+      }
+    }
+    if (plan.hand_camera_group.has_value()) {
+      for (const auto& source : plan.hand_camera_group->sources) {
+        plan.bandwidth_budget->addSource(source, hand_camera_stream_rate,
+                                         parameters.getCameraPriority(source.camera));
+      }
+    }
+  }
+  return plan;
+}
+
+void SpotImagePublisher::createPublishers(const std::set<ImageSource>& sources) {
+  PublisherOptions options;
+  options.uncompress_images = uncompress_images_;
+  options.publish_compressed_images = publish_compressed_images_;
+  options.publish_preview_images = preview_options_.has_value();
+  options.publish_point_clouds = get_images_options_.point_clouds.has_value();
+  options.publish_image_bundle = publish_image_bundle_;
+  options.publish_raw_responses = publish_raw_protobuf_;
+  options.publish_compressed_depth_images = get_images_options_.compressed_depth.has_value();
+  options.publish_filtered_depth_images = get_images_options_.depth_filter.has_value();
+  options.publish_laser_scan = get_images_options_.laser_scan.has_value();
+  options.stitched_camera = stitched_camera_;
+  middleware_handle_->createPublishers(sources, options);
 }
 
 void SpotImagePublisher::timerCallback(bool uncompress_images, bool publish_compressed_images) {
-  if (!image_request_message_) {
-    logger_->logError("No image request message generated. Returning.");
+  std::lock_guard<std::mutex> lock{request_groups_mutex_};
+  if (stopping_ || paused_) {
+    return;
+  }
+  if (image_request_groups_.empty() && !hand_camera_group_.has_value()) {
+    logger_->logThrottled(LogLevel::kError, "no_image_requests", kFailureLogPeriod,
+                          "No image request message generated. Returning.");
+    return;
+  }
+
+  if (skip_next_tick_) {
+    skip_next_tick_ = false;
+    logger_->logDebug("Skipping an image request, since the previous one took longer than the timer period.");
     return;
   }
 
-  const auto image_result =
-      image_client_interface_->getImages(*image_request_message_, uncompress_images, publish_compressed_images);
+  const auto callback_start = std::chrono::steady_clock::now();
+  requestDueGroups(uncompress_images, publish_compressed_images);
+  skip_next_tick_ = std::chrono::steady_clock::now() - callback_start > timer_period_;
+}
+
+std::size_t SpotImagePublisher::requestDueGroups(bool uncompress_images, bool publish_compressed_images) {
+  std::size_t requests_sent = 0;
+  const auto rate_divisor = static_cast<double>(updateLinkDegraded() ? degraded_rate_divisor_ : 1);
+  for (std::size_t index = 0; index < image_request_groups_.size() && !stopping_ && !paused_; ++index) {
+    auto& group = image_request_groups_[index];
+    // The credit keeps rates which are not an integer fraction of the timer rate on average, e.g. a group at 20 Hz is
+    // requested on two of every three ticks of a 30 Hz timer.
+    const auto due = group.request_credit >= 1.0 - kRequestCreditTolerance;
+    group.request_credit += group.requests_per_tick / rate_divisor - (due ? 1.0 : 0.0);
+    if (!due) {
+      continue;
+    }
+    // Skip a slower group while its previous request is in flight, rather than queueing requests up behind it.
+    if (group.request_in_flight.valid() &&
+        group.request_in_flight.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+      continue;
+    }
+
+    const auto& request = getRequest(group);
+    if (request.image_requests_size() == 0) {
+      continue;
+    }
+
+    if (index == 0) {
+      requestAndPublishImages(group, request, uncompress_images, publish_compressed_images);
+    } else {
+      // The request is copied, since the cached one may be rebuilt once this one finished.
+      auto finished = std::make_shared<std::promise<void>>();
+      group.request_in_flight = finished->get_future();
+      thread_pool_->post([this, &group, request, uncompress_images, publish_compressed_images, finished]() {
+        requestAndPublishImages(group, request, uncompress_images, publish_compressed_images);
+        finished->set_value();
+      });
+    }
+    ++requests_sent;
+  }
+  return requests_sent;
+}
+
+void SpotImagePublisher::waitForGroupRequests() {
+  for (auto& group : image_request_groups_) {
+    if (group.request_in_flight.valid()) {
+      group.request_in_flight.wait();
+    }
+  }
+}
+
+void SpotImagePublisher::streamImages(bool uncompress_images, bool publish_compressed_images) {
+  while (!stopping_) {
+    std::unique_lock<std::mutex> lock{request_groups_mutex_};
+    // Let updateImageSources() swap the groups before the next request, and wait while paused. Waiting releases the
+    // mutex, which updateImageSources() and pause() wait for.
+    stream_resumed_.wait(lock, [this]() {
+      return stopping_ || (!update_pending_ && !paused_);
+    });
+    if (requestDueGroups(uncompress_images, publish_compressed_images) == 0) {
+      // Nothing was due, for example because no image source has subscribers, so wait instead of spinning.
+      const auto timer_period = timer_period_;
+      lock.unlock();
+      std::this_thread::sleep_for(timer_period);
+    }
+  }
+}
+
+void SpotImagePublisher::handCameraTimerCallback(bool uncompress_images, bool publish_compressed_images) {
+  std::lock_guard<std::mutex> lock{hand_camera_mutex_};
+  // Skip this tick if the previous request is still in flight, rather than queueing requests up. The group may also
+  // have been removed by updateImageSources() while this tick was waiting for the lock.
+  if (stopping_ || paused_ ||
+      (hand_camera_request_.valid() &&
+       hand_camera_request_.wait_for(std::chrono::seconds{0}) != std::future_status::ready) ||
+      !hand_camera_group_.has_value()) {
+    return;
+  }
+  const auto tick = hand_camera_ticks_++;
+  if (updateLinkDegraded() && tick % degraded_rate_divisor_ != 0) {
+    return;
+  }
+
+  auto& group = hand_camera_group_.value();
+  const auto& request = getRequest(group);
+  if (request.image_requests_size() == 0) {
+    return;
+  }
+
+  // The request is copied, since the cached one may be rebuilt by the next tick while this one is in flight.
+  auto finished = std::make_shared<std::promise<void>>();
+  hand_camera_request_ = finished->get_future();
+  thread_pool_->post([this, &group, request, uncompress_images, publish_compressed_images, finished]() {
+    requestAndPublishImages(group, request, uncompress_images, publish_compressed_images);
+    finished->set_value();
+  });
+}
+
+void SpotImagePublisher::warmUp(bool uncompress_images, bool publish_compressed_images) {
+  // Nothing else requests images yet, so the groups are used without their mutexes.
+  const auto start = std::chrono::steady_clock::now();
+  for (auto& group : image_request_groups_) {
+    if (group.request.image_requests_size() > 0) {
+      requestAndPublishImages(group, group.request, uncompress_images, publish_compressed_images);
+    }
+  }
+  if (hand_camera_group_.has_value() && hand_camera_group_->request.image_requests_size() > 0) {
+    requestAndPublishImages(*hand_camera_group_, hand_camera_group_->request, uncompress_images,
+                            publish_compressed_images);
+  }
+  const auto duration = std::chrono::duration<double, std::milli>{std::chrono::steady_clock::now() - start};
+  logger_->logInfo("Warmed up the image pipeline in " + std::to_string(static_cast<int>(duration.count())) + " ms.");
+}
+
+void SpotImagePublisher::requestAndPublishImages(ImageRequestGroup& group,
+                                                 const ::bosdyn::api::GetImageRequest& request,
+                                                 bool uncompress_images, bool publish_compressed_images) {
+  const auto request_start = std::chrono::steady_clock::now();
+  auto image_result =
+      image_client_interface_->getImages(request, uncompress_images, publish_compressed_images, get_images_options_);
+  const auto request_end = std::chrono::steady_clock::now();
   if (!image_result.has_value()) {
-    logger_->logError(std::string{"Failed to get images: "}.append(image_result.error()));
+    rpc_failures_.increment();
+    rpc_latency_.record(request_end - request_start);
+    logger_->logThrottled(LogLevel::kError, "get_images", kFailureLogPeriod,
+                          std::string{"Failed to get images: "}.append(image_result.error()));
     return;
   }
+  const auto rpc_duration =
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(image_result.value().request_duration_);
+  rpc_latency_.record(rpc_duration);
+  decode_time_.record(request_end - request_start - rpc_duration);
+  stale_images_dropped_.increment(image_result.value().stale_images_dropped_);
+  if (image_result.value().stale_images_dropped_ > 0) {
+    logger_->logDebug("Dropped " + std::to_string(image_result.value().stale_images_dropped_) +
+                      " images which were older than max_image_age.");
+  }
+
+  if (group.quality_controller.has_value()) {
+    group.quality_controller->update(image_result.value().response_sizes_, image_result.value().request_duration_);
+    for (std::size_t index = 0; index < group.sources.size(); ++index) {
+      if (group.sources[index].type == SpotImageType::RGB) {
+        group.request.mutable_image_requests(static_cast<int>(index))
+            ->set_quality_percent(group.quality_controller->quality(group.sources[index]));
+      }
+    }
+    // Rebuild the filtered request from the updated one on the next call.
+    group.subscribed.clear();
+  }
+
+  {
+    std::lock_guard<std::mutex> budget_lock{bandwidth_budget_mutex_};
+    if (bandwidth_budget_.has_value()) {
+      // The budget learns the size of each source at the quality it was actually requested at.
+      std::array<double, kNumImageSources> qualities{};
+      for (const auto& image_request : request.image_requests()) {
+        if (const auto source = fromSpotImageSourceName(image_request.image_source_name()); source.has_value()) {
+          qualities[toImageSourceIndex(source.value())] = image_request.quality_percent();
+        }
+      }
+      for (const auto& [source, size] : image_result.value().response_sizes_) {
+        bandwidth_budget_->update(source, size, qualities[toImageSourceIndex(source)]);
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lock{publish_mutex_};
+  if (publish_raw_protobuf_) {
+    if (const auto result = middleware_handle_->publishRawImageResponse(std::move(image_result.value().raw_response_));
+        !result) {
+      logger_->logThrottled(LogLevel::kError, "publish_raw_response", kFailureLogPeriod,
+                            "Failed to publish raw image response: " + result.error());
+    }
+  }
+  if (stream_images_) {
+    dropRepeatedImages(image_result.value());
+  }
+  if (preview_options_.has_value()) {
+    publishPreviewImages(image_result.value().images_);
+  }
+  // The front images are stitched before they are published, since publishing may move them into the middleware.
+  if (front_stitcher_) {
+    publishStitchedImage(image_result.value());
+  }
 
-  middleware_handle_->publishImages(image_result.value().images_, image_result.value().compressed_images_);
+  auto& images = image_result.value().images_;
+  auto& compressed_images = image_result.value().compressed_images_;
+  if (publish_image_bundle_) {
+    publishImageBundle(images, compressed_images, image_result.value().transforms_);
+  }
+  const auto publish_start = std::chrono::steady_clock::now();
+  tracing::stageBegin(tracing::kImagePipeline, "publish");
+  middleware_handle_->publishImages(images, compressed_images);
+  tracing::stageEnd(tracing::kImagePipeline, "publish");
+  publish_time_.record(std::chrono::steady_clock::now() - publish_start);
+  if (get_images_options_.measure_latency) {
+    recordLatencies(image_result.value().latencies_, std::chrono::steady_clock::now() - publish_start);
+  }
+  // Recycle the messages which the middleware did not take ownership of.
+  for (auto& [source, image] : images) {
+    message_pool_->releaseImage(source, std::move(image.image));
+  }
+  for (auto& [source, compressed_image] : compressed_images) {
+    message_pool_->releaseCompressedImage(source, std::move(compressed_image.image));
+  }
+  if (get_images_options_.point_clouds.has_value()) {
+    middleware_handle_->publishPointClouds(std::move(image_result.value().point_clouds_));
+  }
+  if (get_images_options_.compressed_depth.has_value()) {
+    middleware_handle_->publishCompressedDepthImages(std::move(image_result.value().compressed_depth_images_));
+  }
+  if (get_images_options_.depth_filter.has_value()) {
+    middleware_handle_->publishFilteredDepthImages(std::move(image_result.value().filtered_depth_images_));
+  }
+  if (image_result.value().laser_scan_.has_value()) {
+    middleware_handle_->publishLaserScan(std::move(image_result.value().laser_scan_.value()));
+  }
   tf_broadcaster_->updateStaticTransforms(image_result.value().transforms_);
 }
+
+void SpotImagePublisher::dropRepeatedImages(GetImagesResult& result) {
+  const auto is_newer = [](const builtin_interfaces::msg::Time& stamp, const builtin_interfaces::msg::Time& last) {
+    return std::tie(stamp.sec, stamp.nanosec) > std::tie(last.sec, last.nanosec);
+  };
+  // An RGB source can have both an image and a compressed image with the same stamp, so each source is only checked
+  // against the stamp from before this response.
+  std::array<bool, kNumImageSources> repeated{};
+  auto newest_stamps = last_image_stamps_;
+  const auto check_stamp = [&](const ImageSource& source, const builtin_interfaces::msg::Time& stamp) {
+    const auto index = toImageSourceIndex(source);
+    repeated[index] = !is_newer(stamp, last_image_stamps_[index]);
+    if (!repeated[index]) {
+      newest_stamps[index] = stamp;
+    }
+  };
+  for (const auto& [source, image] : result.images_) {
+    check_stamp(source, image.image.header.stamp);
+  }
+  for (const auto& [source, compressed_image] : result.compressed_images_) {
+    check_stamp(source, compressed_image.image.header.stamp);
+  }
+  last_image_stamps_ = newest_stamps;
+
+  // The messages of repeated images are recycled, so that dropping a frame does not cost an allocation later.
+  const auto repeated_images = partitionRepeated(result.images_, repeated);
+  for (auto it = repeated_images; it != result.images_.end(); ++it) {
+    message_pool_->releaseImage(it->first, std::move(it->second.image));
+  }
+  result.images_.erase(repeated_images, result.images_.end());
+  const auto repeated_compressed_images = partitionRepeated(result.compressed_images_, repeated);
+  for (auto it = repeated_compressed_images; it != result.compressed_images_.end(); ++it) {
+    message_pool_->releaseCompressedImage(it->first, std::move(it->second.image));
+  }
+  result.compressed_images_.erase(repeated_compressed_images, result.compressed_images_.end());
+  result.point_clouds_.erase(partitionRepeated(result.point_clouds_, repeated), result.point_clouds_.end());
+  result.compressed_depth_images_.erase(partitionRepeated(result.compressed_depth_images_, repeated),
+                                        result.compressed_depth_images_.end());
+  result.filtered_depth_images_.erase(partitionRepeated(result.filtered_depth_images_, repeated),
+                                      result.filtered_depth_images_.end());
+  // The scan is stamped with the newest of its depth images, so it is only repeated if all of them are.
+  if (result.laser_scan_.has_value()) {
+    if (is_newer(result.laser_scan_->header.stamp, last_laser_scan_stamp_)) {
+      last_laser_scan_stamp_ = result.laser_scan_->header.stamp;
+    } else {
+      result.laser_scan_.reset();
+    }
+  }
+  result.latencies_.erase(partitionRepeated(result.latencies_, repeated), result.latencies_.end());
+}
+
+void SpotImagePublisher::publishPreviewImages(const std::vector<std::pair<ImageSource, ImageWithCameraInfo>>& images) {
+  std::vector<std::pair<ImageSource, ImageWithCameraInfo>> preview_images;
+  preview_images.reserve(images.size());
+  for (const auto& [source, image] : images) {
+    ImageWithCameraInfo preview;
+    const auto preview_result =
+        createImagePreview(image.image, image.info, preview_options_.value(), preview.image, preview.info);
+    if (!preview_result) {
+      logger_->logThrottled(LogLevel::kError, "create_preview", kFailureLogPeriod,
+                            "Failed to create preview image for " + toRosTopic(source) + ": " + preview_result.error());
+      continue;
+    }
+    preview_images.emplace_back(source, std::move(preview));
+  }
+  middleware_handle_->publishPreviewImages(std::move(preview_images));
+}
+
+void SpotImagePublisher::publishImageBundle(
+    const std::vector<std::pair<ImageSource, ImageWithCameraInfo>>& images,
+    const std::vector<std::pair<ImageSource, CompressedImageWithCameraInfo>>& compressed_images,
+    const std::vector<geometry_msgs::msg::TransformStamped>& transforms) {
+  // Transforms are only part of a response when they are refreshed, so keep the latest one of each camera.
+  for (const auto& transform : transforms) {
+    const auto existing = std::find_if(image_bundle_transforms_.begin(), image_bundle_transforms_.end(),
+                                       [&transform](const geometry_msgs::msg::TransformStamped& kept) {
+                                         return kept.child_frame_id == transform.child_frame_id;
+                                       });
+    if (existing != image_bundle_transforms_.end()) {
+      *existing = transform;
+    } else {
+      image_bundle_transforms_.push_back(transform);
+    }
+  }
+
+  if ((images.empty() && compressed_images.empty()) || !middleware_handle_->hasImageBundleSubscribers()) {
+    return;
+  }
+
+  spot_msgs::msg::ImageBundle bundle;
+  bundle.header.stamp = images.empty() ? compressed_images.front().second.image.header.stamp
+                                       : images.front().second.image.header.stamp;
+  bundle.image_sources.reserve(images.size());
+  bundle.images.reserve(images.size());
+  bundle.camera_infos.reserve(images.size());
+  for (const auto& [source, image] : images) {
+    bundle.image_sources.push_back(toRosTopic(source));
+    bundle.images.push_back(image.image);
+    bundle.camera_infos.push_back(image.info);
+  }
+  bundle.compressed_image_sources.reserve(compressed_images.size());
+  bundle.compressed_images.reserve(compressed_images.size());
+  bundle.compressed_camera_infos.reserve(compressed_images.size());
+  for (const auto& [source, compressed_image] : compressed_images) {
+    bundle.compressed_image_sources.push_back(toRosTopic(source));
+    bundle.compressed_images.push_back(compressed_image.image);
+    bundle.compressed_camera_infos.push_back(compressed_image.info);
+  }
+  bundle.transforms = image_bundle_transforms_;
+
+  if (const auto result = middleware_handle_->publishImageBundle(std::move(bundle)); !result) {
+    logger_->logThrottled(LogLevel::kError, "publish_image_bundle", kFailureLogPeriod,
+                          "Failed to publish image bundle: " + result.error());
+  }
+}
+
+void SpotImagePublisher::publishStitchedImage(const GetImagesResult& result) {
+  const auto find_transform = [&result](const SpotCamera camera) -> const geometry_msgs::msg::Transform* {
+    const auto it = std::find_if(result.body_transforms_.cbegin(), result.body_transforms_.cend(),
+                                 [camera](const auto& entry) { return entry.first.camera == camera; });
+    return it != result.body_transforms_.cend() ? &it->second : nullptr;
+  };
+  const auto* const body_tform_left = find_transform(SpotCamera::FRONTLEFT);
+  const auto* const body_tform_right = find_transform(SpotCamera::FRONTRIGHT);
+  if (body_tform_left != nullptr && body_tform_right != nullptr) {
+    front_stitcher_->setCameraTransforms(*body_tform_left, *body_tform_right);
+  }
+  if (!middleware_handle_->hasStitchedImageSubscribers()) {
+    return;
+  }
+
+  const auto find_image = [&result](const SpotCamera camera) -> const ImageWithCameraInfo* {
+    const auto it = std::find_if(result.images_.cbegin(), result.images_.cend(), [camera](const auto& entry) {
+      return entry.first.camera == camera && entry.first.type == SpotImageType::RGB;
+    });
+    return it != result.images_.cend() ? &it->second : nullptr;
+  };
+  const auto* const left = find_image(SpotCamera::FRONTLEFT);
+  const auto* const right = find_image(SpotCamera::FRONTRIGHT);
+  // Either image can be missing if it was filtered out of the request or dropped as a repeated frame.
+  if (left == nullptr || right == nullptr) {
+    return;
+  }
+  if (const auto stitch_result = front_stitcher_->stitch(*left, *right); !stitch_result) {
+    logger_->logThrottled(LogLevel::kWarn, "stitch_front_images", kFailureLogPeriod,
+                          "Failed to stitch the front images: " + stitch_result.error());
+    return;
+  }
+  if (const auto publish_result =
+          middleware_handle_->publishStitchedImage(front_stitcher_->image(), front_stitcher_->info());
+      !publish_result) {
+    logger_->logThrottled(LogLevel::kError, "publish_stitched_image", kFailureLogPeriod,
+                          "Failed to publish stitched image: " + publish_result.error());
+  }
+  if (!virtual_camera_transform_sent_) {
+    if (const auto transform = front_stitcher_->getVirtualCameraTransform(); transform.has_value()) {
+      tf_broadcaster_->updateStaticTransforms({transform.value()});
+      virtual_camera_transform_sent_ = true;
+    }
+  }
+}
+
+void SpotImagePublisher::recordLatencies(std::vector<std::pair<ImageSource, ImageLatency>>& latencies,
+                                         const std::chrono::steady_clock::duration publish_duration) {
+  for (auto& [source, latency] : latencies) {
+    latency.publish = std::chrono::duration<double>{publish_duration}.count();
+    latency_statistics_.add(source, latency);
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  if (now - last_latency_report_ < kLatencyReportPeriod) {
+    return;
+  }
+  last_latency_report_ = now;
+
+  diagnostic_msgs::msg::DiagnosticArray diagnostics;
+  diagnostics.status = latency_statistics_.toDiagnosticStatus(kLatencyDiagnosticsNamePrefix);
+  latency_statistics_.clear();
+  if (!diagnostics.status.empty()) {
+    middleware_handle_->publishLatencyDiagnostics(diagnostics);
+  }
+}
+
+const ::bosdyn::api::GetImageRequest& SpotImagePublisher::getSubscribedRequest(ImageRequestGroup& group) {
+  // A subscriber of the bundle or of the raw responses needs every image of the request.
+  const auto bundle_subscribed = (publish_image_bundle_ && middleware_handle_->hasImageBundleSubscribers()) ||
+                                 (publish_raw_protobuf_ && middleware_handle_->hasRawImageResponseSubscribers());
+  // A subscriber of the laser scan needs the depth images of the body cameras.
+  const auto laser_scan_subscribed =
+      get_images_options_.laser_scan.has_value() && middleware_handle_->hasLaserScanSubscribers();
+  // A subscriber of the stitched image needs the RGB images of the front cameras.
+  const auto stitched_image_subscribed = front_stitcher_ && middleware_handle_->hasStitchedImageSubscribers();
+  std::vector<bool> subscribed;
+  subscribed.reserve(group.sources.size());
+  for (const auto& source : group.sources) {
+    const auto scanned =
+        laser_scan_subscribed && source.type == SpotImageType::DEPTH && source.camera != SpotCamera::HAND;
+    const auto stitched = stitched_image_subscribed && get_images_options_.body_transform_sources.count(source) > 0;
+    subscribed.push_back(bundle_subscribed || scanned || stitched || middleware_handle_->hasSubscribers(source));
+  }
+
+  if (subscribed != group.subscribed) {
+    group.subscribed = std::move(subscribed);
+    group.subscribed_request.Clear();
+    for (std::size_t index = 0; index < group.sources.size(); ++index) {
+      if (group.subscribed[index]) {
+        *group.subscribed_request.add_image_requests() = group.request.image_requests(static_cast<int>(index));
+      }
+    }
+  }
+  return group.subscribed_request;
+}
+
+const ::bosdyn::api::GetImageRequest& SpotImagePublisher::getRequest(ImageRequestGroup& group) {
+  const auto& request = on_demand_images_ ? getSubscribedRequest(group) : group.request;
+  std::unique_lock<std::mutex> lock{bandwidth_budget_mutex_};
+  if (!bandwidth_budget_.has_value()) {
+    lock.unlock();
+    return link_degraded_ ? getDegradedRequest(group, request) : request;
+  }
+
+  for (std::size_t index = 0; index < group.sources.size(); ++index) {
+    bandwidth_budget_->setWanted(group.sources[index], !on_demand_images_ || group.subscribed[index]);
+  }
+  bandwidth_budget_->allocate();
+
+  group.budgeted_request.Clear();
+  for (std::size_t index = 0; index < group.sources.size(); ++index) {
+    const auto& source = group.sources[index];
+    if (!bandwidth_budget_->isAdmitted(source)) {
+      continue;
+    }
+    auto& image_request = *group.budgeted_request.add_image_requests();
+    image_request = group.request.image_requests(static_cast<int>(index));
+    if (source.type == SpotImageType::RGB) {
+      image_request.set_quality_percent(std::min(image_request.quality_percent(), bandwidth_budget_->quality(source)));
+    }
+  }
+  lock.unlock();
+  return link_degraded_ ? getDegradedRequest(group, group.budgeted_request) : group.budgeted_request;
+}
+
+const ::bosdyn::api::GetImageRequest& SpotImagePublisher::getDegradedRequest(
+    ImageRequestGroup& group, const ::bosdyn::api::GetImageRequest& request) {
+  group.degraded_request.Clear();
+  for (const auto& image_request : request.image_requests()) {
+    // The depth images are the largest responses, and the driver can do without them until the link recovers.
+    const auto source = fromSpotImageSourceName(image_request.image_source_name());
+    if (source.has_value() && source.value().type != SpotImageType::RGB) {
+      continue;
+    }
+    auto& degraded = *group.degraded_request.add_image_requests();
+    degraded = image_request;
+    degraded.set_quality_percent(std::min(degraded.quality_percent(), degraded_rgb_image_quality_));
+  }
+  return group.degraded_request;
+}
+
+bool SpotImagePublisher::updateLinkDegraded() {
+  if (!link_monitor_) {
+    return false;
+  }
+  const auto degraded = link_monitor_->quality() == LinkQuality::kDegraded;
+  if (link_degraded_.exchange(degraded) != degraded) {
+    logger_->logWarn(degraded ? "The link to the robot is degraded, requesting fewer images at a lower quality and "
+                                "suspending the depth images."
+                              : "The link to the robot recovered, restoring the image rates.");
+  }
+  return degraded;
+}
 }  // namespace spot_ros2::images
@@ -4,4 +4,6 @@
 #include <rclcpp_components/register_node_macro.hpp>
 #include <spot_driver/images/spot_image_publisher_node.hpp>
 
+// When this component is loaded into a container with `use_intra_process_comms` enabled, the images are handed to other
+// components in the same container without being copied or serialized.
 RCLCPP_COMPONENTS_REGISTER_NODE(spot_ros2::images::SpotImagePublisherNode)
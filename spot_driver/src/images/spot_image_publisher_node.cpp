@@ -1,6 +1,15 @@
 // Copyright (c) 2023-2024 Boston Dynamics AI Institute LLC. All rights reserved.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
 #include <spot_driver/images/spot_image_publisher_node.hpp>
 
 #include <spot_driver/api/default_spot_api.hpp>
@@ -11,11 +20,52 @@
 #include <spot_driver/interfaces/rclcpp_parameter_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_tf_broadcaster_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_wall_timer_interface.hpp>
+#include <spot_driver/metrics/metrics_middleware_handle.hpp>
 
 namespace {
 constexpr auto kSDKClientName = "spot_image_publisher";
+
+/**
+ * @brief Check whether a parameter only selects the image sources, their quality or their rates, which
+ * SpotImagePublisher::updateImageSources() applies without replacing the publisher.
+ */
+bool isImageSourceParameter(const std::string& name) {
+  static const std::set<std::string> kImageSourceParameters{
+      "cameras_used", "publish_rgb", "publish_depth", "publish_depth_registered", "image_quality",
+      "adaptive_rgb_image_quality", "min_rgb_image_quality", "hand_camera_stream_rate", "hand_camera_stream_quality",
+      "hand_camera_stream_resize_ratio", "image_bandwidth_budget"};
+  return kImageSourceParameters.count(name) > 0 || name.rfind("image_rate.", 0) == 0 ||
+         name.rfind("image_priority.", 0) == 0;
 }
 
+/**
+ * @brief Timer whose callbacks hold a shared lock while they run, and are skipped once they are disabled, so that the
+ * SpotImagePublisher which they call can be destroyed while the executor may still run them on other threads.
+ */
+class GuardedTimer : public spot_ros2::TimerInterfaceBase {
+ public:
+  GuardedTimer(std::unique_ptr<spot_ros2::TimerInterfaceBase> timer, std::shared_ptr<std::shared_mutex> mutex,
+               std::shared_ptr<std::atomic_bool> enabled)
+      : timer_{std::move(timer)}, mutex_{std::move(mutex)}, enabled_{std::move(enabled)} {}
+
+  void setTimer(const std::chrono::duration<double>& period, const std::function<void()>& callback) override {
+    timer_->setTimer(period, [mutex = mutex_, enabled = enabled_, callback]() {
+      std::shared_lock lock{*mutex};
+      if (*enabled) {
+        callback();
+      }
+    });
+  }
+
+  void clearTimer() override { timer_->clearTimer(); }
+
+ private:
+  std::unique_ptr<spot_ros2::TimerInterfaceBase> timer_;
+  std::shared_ptr<std::shared_mutex> mutex_;
+  std::shared_ptr<std::atomic_bool> enabled_;
+};
+}  // namespace
+
 namespace spot_ros2::images {
 SpotImagePublisherNode::SpotImagePublisherNode(std::unique_ptr<SpotApi> spot_api,
                                                std::unique_ptr<SpotImagePublisher::MiddlewareHandle> mw_handle,
@@ -30,20 +80,66 @@ SpotImagePublisherNode::SpotImagePublisherNode(std::unique_ptr<SpotApi> spot_api
 }
 
 SpotImagePublisherNode::SpotImagePublisherNode(const rclcpp::NodeOptions& node_options) {
-  const auto node = std::make_shared<rclcpp::Node>("image_publisher", node_options);
-  node_base_interface_ = std::make_unique<RclcppNodeInterface>(node->get_node_base_interface());
+  node_ = std::make_shared<rclcpp::Node>("image_publisher", node_options);
+  node_base_interface_ = std::make_unique<RclcppNodeInterface>(node_->get_node_base_interface());
+
+  auto parameters = std::make_unique<RclcppParameterInterface>(node_);
+  // Each timer blocks while it waits for images from Spot, so each one gets its own callback group. When the node is
+  // spun by a multi-threaded executor, a slow request then neither delays the other timer nor the parameter services
+  // and other callbacks in the default group. The groups are mutually exclusive, since a timer callback must not
+  // overlap with itself.
+  timer_group_ = node_->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+  hand_camera_timer_group_ = node_->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
 
-  auto mw_handle = std::make_unique<ImagesMiddlewareHandle>(node);
-  auto parameters = std::make_unique<RclcppParameterInterface>(node);
-  auto logger = std::make_unique<RclcppLoggerInterface>(node->get_logger());
-  auto tf_broadcaster = std::make_unique<RclcppTfBroadcasterInterface>(node);
-  auto timer = std::make_unique<RclcppWallTimerInterface>(node);
+  // Composed nodes of the same robot share its registry, so each node only reports the group of metrics it records.
+  // The metrics are only read from the thread-safe registry, so their timer also gets its own group and keeps
+  // publishing while the image timers wait for Spot.
+  metrics_registry_ = metrics::MetricsRegistry::getForRobot(parameters->getSpotName());
+  metrics_publisher_ = std::make_unique<metrics::MetricsPublisher>(
+      metrics_registry_, std::vector<std::string>{"images"}, "image_publisher: ",
+      metrics::makeMetricsPublisherOptions(*parameters), std::make_unique<metrics::MetricsMiddlewareHandle>(node_),
+      std::make_unique<RclcppLoggerInterface>(node_->get_logger()),
+      std::make_unique<RclcppWallTimerInterface>(
+          node_, node_->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive)));
 
   const auto timesync_timeout = parameters->getTimeSyncTimeout();
   auto spot_api = std::make_unique<DefaultSpotApi>(kSDKClientName, timesync_timeout, parameters->getCertificate());
 
-  initialize(std::move(spot_api), std::move(mw_handle), std::move(parameters), std::move(logger),
-             std::move(tf_broadcaster), std::move(timer));
+  // The QoS profiles are read through the same parameters as the rest of the publisher.
+  auto mw_handle = std::make_unique<ImagesMiddlewareHandle>(
+      node_, ImagesMiddlewareHandle::loadPublisherQoS(*parameters, RclcppLoggerInterface{node_->get_logger()}));
+  initialize(std::move(spot_api), std::move(mw_handle), std::move(parameters),
+             std::make_unique<RclcppLoggerInterface>(node_->get_logger()),
+             std::make_unique<RclcppTfBroadcasterInterface>(node_), createTimer(timer_group_, timers_enabled_),
+             createTimer(hand_camera_timer_group_, timers_enabled_));
+
+  // Invalid values are rejected when they are set, so that the running publisher is not replaced by one which fails to
+  // start. The callback is only added once every parameter was declared, so that declaring them does not run it.
+  set_parameters_callback_ = node_->add_on_set_parameters_callback(&RclcppParameterInterface::validateParameters);
+
+  // Changes of the image sources, their quality and their rates are applied to the running publisher, so that the
+  // streams of the other sources continue. Other parameters are only read when the publisher is created, so it is
+  // replaced after any other change. Changes of the parameters of the connection, such as the hostname, only take
+  // effect when the node is restarted.
+  parameter_event_handler_ = std::make_shared<rclcpp::ParameterEventHandler>(node_);
+  parameter_event_callback_ = parameter_event_handler_->add_parameter_event_callback(
+      [this](const rcl_interfaces::msg::ParameterEvent& event) {
+        if (event.node != node_->get_fully_qualified_name() || event.changed_parameters.empty()) {
+          return;
+        }
+        const auto only_image_sources =
+            std::all_of(event.changed_parameters.cbegin(), event.changed_parameters.cend(),
+                        [](const rcl_interfaces::msg::Parameter& parameter) {
+                          return isImageSourceParameter(parameter.name);
+                        });
+        // The parameters are read through a new interface, since the current one keeps the values it read first.
+        if (only_image_sources && internal_ &&
+            internal_->updateImageSources(std::make_unique<RclcppParameterInterface>(node_))) {
+          RclcppLoggerInterface{node_->get_logger()}.logInfo("Parameters changed, updated the image requests.");
+          return;
+        }
+        reconfigure();
+      });
 }
 
 void SpotImagePublisherNode::initialize(std::unique_ptr<SpotApi> spot_api,
@@ -51,7 +147,8 @@ void SpotImagePublisherNode::initialize(std::unique_ptr<SpotApi> spot_api,
                                         std::unique_ptr<ParameterInterfaceBase> parameters,
                                         std::unique_ptr<LoggerInterfaceBase> logger,
                                         std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster,
-                                        std::unique_ptr<TimerInterfaceBase> timer) {
+                                        std::unique_ptr<TimerInterfaceBase> timer,
+                                        std::unique_ptr<TimerInterfaceBase> hand_camera_timer) {
   spot_api_ = std::move(spot_api);
 
   const auto hostname = parameters->getHostname();
@@ -80,16 +177,76 @@ void SpotImagePublisherNode::initialize(std::unique_ptr<SpotApi> spot_api,
     throw std::runtime_error(error_msg);
   }
 
-  internal_ = std::make_unique<SpotImagePublisher>(spot_api_->image_client_interface(), std::move(mw_handle),
-                                                   std::move(parameters), std::move(logger), std::move(tf_broadcaster),
-                                                   std::move(timer), expected_has_arm.value());
+  has_arm_ = expected_has_arm.value();
+
+  internal_ = createPublisher(std::move(mw_handle), std::move(parameters), std::move(logger),
+                              std::move(tf_broadcaster), std::move(timer), std::move(hand_camera_timer));
+}
+
+std::unique_ptr<SpotImagePublisher> SpotImagePublisherNode::createPublisher(
+    std::unique_ptr<SpotImagePublisher::MiddlewareHandle> mw_handle, std::unique_ptr<ParameterInterfaceBase> parameters,
+    std::unique_ptr<LoggerInterfaceBase> logger, std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster,
+    std::unique_ptr<TimerInterfaceBase> timer, std::unique_ptr<TimerInterfaceBase> hand_camera_timer) {
+  auto image_client = spot_api_->image_client_interface();
+  if (image_client == nullptr) {
+    constexpr auto error_msg{"Failed to create the Spot API's image client, which is required to run this node."};
+    logger->logError(error_msg);
+    throw std::runtime_error(error_msg);
+  }
+
+  // The logger is moved into the publisher, but is still needed if it fails to initialize.
+  const auto* const logger_ptr = logger.get();
+  auto publisher = std::make_unique<SpotImagePublisher>(image_client, std::move(mw_handle), std::move(parameters),
+                                                        std::move(logger), std::move(tf_broadcaster), std::move(timer),
+                                                        has_arm_, std::move(hand_camera_timer), metrics_registry_);
 
   // TODO(jschornak): initialize() always returns true -- revise implementation to make it return void
-  if (!internal_->initialize()) {
+  if (!publisher->initialize()) {
     constexpr auto error_msg{"Failed to initialize image publisher."};
-    logger->logError(error_msg);
+    logger_ptr->logError(error_msg);
     throw std::runtime_error(error_msg);
   }
+  return publisher;
+}
+
+void SpotImagePublisherNode::reconfigure() {
+  const RclcppLoggerInterface logger{node_->get_logger()};
+  logger.logInfo("Parameters changed, recreating the image requests and publishers.");
+  // The current publisher stops requesting images before the new one is created, so that the warm-up and first ticks
+  // of the new one are not published alongside its own. Waiting for the timer callbacks in progress, and pausing it,
+  // drains its requests in flight. It only stops advertising its topics once the new one replaced it.
+  {
+    std::unique_lock lock{*timer_callback_mutex_};
+    timers_enabled_->store(false);
+  }
+  internal_->pause();
+  // The new publisher gets its own timer flag, so that its timers run while those of the current one are disabled.
+  auto timers_enabled = std::make_shared<std::atomic_bool>(true);
+  std::unique_ptr<SpotImagePublisher> publisher;
+  try {
+    auto parameters = std::make_unique<RclcppParameterInterface>(node_);
+    auto mw_handle =
+        std::make_unique<ImagesMiddlewareHandle>(node_, ImagesMiddlewareHandle::loadPublisherQoS(*parameters, logger));
+    publisher = createPublisher(std::move(mw_handle), std::move(parameters),
+                                std::make_unique<RclcppLoggerInterface>(node_->get_logger()),
+                                std::make_unique<RclcppTfBroadcasterInterface>(node_),
+                                createTimer(timer_group_, timers_enabled),
+                                createTimer(hand_camera_timer_group_, timers_enabled));
+  } catch (const std::runtime_error&) {
+    // The error was logged by createPublisher().
+    logger.logWarn("Keeping the current image publisher, since the new one failed to start.");
+    internal_->resume();
+    timers_enabled_->store(true);
+    return;
+  }
+  timers_enabled_ = std::move(timers_enabled);
+  internal_ = std::move(publisher);
+}
+
+std::unique_ptr<TimerInterfaceBase> SpotImagePublisherNode::createTimer(
+    const rclcpp::CallbackGroup::SharedPtr& callback_group, const std::shared_ptr<std::atomic_bool>& enabled) {
+  return std::make_unique<GuardedTimer>(std::make_unique<RclcppWallTimerInterface>(node_, callback_group),
+                                        timer_callback_mutex_, enabled);
 }
 
 std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> SpotImagePublisherNode::get_node_base_interface() {
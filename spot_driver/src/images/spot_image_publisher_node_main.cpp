@@ -1,8 +1,8 @@
 // Copyright (c) 2023 Boston Dynamics AI Institute LLC. All rights reserved.
 
-#include <rclcpp/executors.hpp>
 #include <rclcpp/utilities.hpp>
 #include <spot_driver/images/spot_image_publisher_node.hpp>
+#include <spot_driver/interfaces/rclcpp_executor.hpp>
 
 #include <memory>
 
@@ -11,8 +11,9 @@ int main(int argc, char* argv[]) {
 
   const auto node = std::make_shared<spot_ros2::images::SpotImagePublisherNode>();
 
-  // Spins the node with the default single-threaded executor.
-  rclcpp::spin(node->get_node_base_interface());
+  // This node uses a multithreaded executor by default because its image request timers block while they wait for
+  // Spot, and they must not block each other or the parameter services of the node.
+  spot_ros2::spinNode(node->get_node_base_interface(), spot_ros2::ExecutorType::MULTI_THREADED);
 
   return 0;
 }
@@ -0,0 +1,9 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <rclcpp/node_options.hpp>
+#include <rclcpp_components/register_node_macro.hpp>
+#include <spot_driver/images/video_encoder_node.hpp>
+
+// When this component is loaded next to the image publisher with `use_intra_process_comms` enabled, it receives the
+// images without them being copied or serialized.
+RCLCPP_COMPONENTS_REGISTER_NODE(spot_ros2::images::VideoEncoderNode)
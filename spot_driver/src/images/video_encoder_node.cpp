@@ -0,0 +1,118 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/images/video_encoder_node.hpp>
+
+#include <rclcpp/qos.hpp>
+
+#include <string_view>
+#include <utility>
+
+namespace {
+constexpr auto kNodeName{"video_encoder"};
+// Frames of a video depend on the frames before them, so the video topics are reliable.
+constexpr auto kPublisherHistoryDepth = 10;
+constexpr auto kImageSuffix = std::string_view{"/image"};
+constexpr auto kVideoSuffix = "/video";
+constexpr auto kErrorThrottlePeriodMs = 5000;
+
+/**
+ * @brief Get the topic of the video of an image topic, which replaces its `image` with `video`.
+ *
+ * @param image_topic Image topic, e.g. `camera/frontleft/image`.
+ * @return The video topic, e.g. `camera/frontleft/video`.
+ */
+std::string toVideoTopic(const std::string& image_topic) {
+  if (image_topic.size() >= kImageSuffix.size() &&
+      image_topic.compare(image_topic.size() - kImageSuffix.size(), kImageSuffix.size(), kImageSuffix) == 0) {
+    return image_topic.substr(0, image_topic.size() - kImageSuffix.size()) + kVideoSuffix;
+  }
+  return image_topic + kVideoSuffix;
+}
+}  // namespace
+
+namespace spot_ros2::images {
+
+VideoEncoderNode::VideoEncoderNode(const rclcpp::NodeOptions& options)
+    : node_{std::make_shared<rclcpp::Node>(kNodeName, options)} {
+  const auto sources = node_->declare_parameter("video_sources", std::vector<std::string>{"camera/frontleft/image"});
+  const auto codec = node_->declare_parameter("video_codec", "h264");
+  const auto backend = node_->declare_parameter("video_encoder_backend", "auto");
+  options_.bit_rate = node_->declare_parameter("video_bit_rate", options_.bit_rate);
+  options_.frame_rate = static_cast<int>(node_->declare_parameter("video_frame_rate", options_.frame_rate));
+  options_.keyframe_interval =
+      static_cast<int>(node_->declare_parameter("video_keyframe_interval", options_.keyframe_interval));
+
+  if (!isVideoEncodingAvailable()) {
+    RCLCPP_ERROR(node_->get_logger(), "The driver was built without FFmpeg, so no video is encoded.");
+    return;
+  }
+  if (const auto video_codec = toVideoCodec(codec); video_codec.has_value()) {
+    options_.codec = video_codec.value();
+  } else {
+    RCLCPP_WARN(node_->get_logger(), "Invalid video_codec parameter! Got error: %s Defaulting to h264.",
+                video_codec.error().c_str());
+  }
+  if (const auto encoder_backend = toVideoEncoderBackend(backend); encoder_backend.has_value()) {
+    options_.backend = encoder_backend.value();
+  } else {
+    RCLCPP_WARN(node_->get_logger(), "Invalid video_encoder_backend parameter! Got error: %s Defaulting to auto.",
+                encoder_backend.error().c_str());
+  }
+
+  // Best effort subscriptions match both reliable and best effort publishers. An image which is lost is simply not
+  // encoded, while the frames which were encoded still decode.
+  for (const auto& source : sources) {
+    auto& stream = *streams_.emplace_back(std::make_unique<VideoStream>());
+    stream.image_topic = source;
+    stream.publisher = node_->create_publisher<spot_msgs::msg::CompressedVideo>(toVideoTopic(source),
+                                                                                 rclcpp::QoS(kPublisherHistoryDepth));
+    stream.subscription = node_->create_subscription<sensor_msgs::msg::Image>(
+        source, rclcpp::SensorDataQoS(), [this, &stream](const std::shared_ptr<const sensor_msgs::msg::Image>& image) {
+          onImage(stream, *image);
+        });
+  }
+}
+
+std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> VideoEncoderNode::get_node_base_interface() {
+  return node_->get_node_base_interface();
+}
+
+void VideoEncoderNode::onImage(VideoStream& stream, const sensor_msgs::msg::Image& image) {
+  // Nothing is encoded without subscribers, so a keyframe is also needed whenever the first subscriber joins.
+  const auto subscriber_count = stream.publisher->get_subscription_count();
+  const auto subscriber_joined = subscriber_count > stream.subscriber_count;
+  stream.subscriber_count = subscriber_count;
+  if (subscriber_count == 0) {
+    return;
+  }
+
+  const auto width = static_cast<int>(image.width);
+  const auto height = static_cast<int>(image.height);
+  if (!stream.encoder || stream.encoder->width() != width || stream.encoder->height() != height) {
+    // A new encoder starts with a keyframe.
+    auto encoder = VideoEncoder::create(options_, width, height);
+    if (!encoder.has_value()) {
+      RCLCPP_ERROR(node_->get_logger(), "Could not encode %s, so it is not encoded anymore: %s",
+                   stream.image_topic.c_str(), encoder.error().c_str());
+      stream.subscription.reset();
+      return;
+    }
+    stream.encoder = std::move(encoder.value());
+    RCLCPP_INFO(node_->get_logger(), "Encoding %s with %s.", stream.image_topic.c_str(),
+                stream.encoder->encoderName().c_str());
+  } else if (subscriber_joined) {
+    stream.encoder->requestKeyframe();
+  }
+
+  auto frames = stream.encoder->encode(image);
+  if (!frames.has_value()) {
+    RCLCPP_ERROR_THROTTLE(node_->get_logger(), *node_->get_clock(), kErrorThrottlePeriodMs, "Failed to encode %s: %s",
+                          stream.image_topic.c_str(), frames.error().c_str());
+    return;
+  }
+  for (auto& frame : frames.value()) {
+    stream.publisher->publish(std::move(frame));
+  }
+}
+
+}  // namespace spot_ros2::images
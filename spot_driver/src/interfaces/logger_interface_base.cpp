@@ -0,0 +1,116 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/interfaces/logger_interface_base.hpp>
+
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace {
+/** @brief Append the number of messages which were held back to a message, if there were any. */
+std::string withSuppressedCount(const std::string& message, const std::size_t suppressed) {
+  if (suppressed == 0) {
+    return message;
+  }
+  return message + " (" + std::to_string(suppressed) + " similar messages suppressed)";
+}
+}  // namespace
+
+namespace spot_ros2 {
+
+void LoggerInterfaceBase::log(const LogLevel level, const std::string& message) const {
+  switch (level) {
+    case LogLevel::kDebug:
+      logDebug(message);
+      break;
+    case LogLevel::kInfo:
+      logInfo(message);
+      break;
+    case LogLevel::kWarn:
+      logWarn(message);
+      break;
+    case LogLevel::kError:
+      logError(message);
+      break;
+    case LogLevel::kFatal:
+      logFatal(message);
+      break;
+  }
+}
+
+void LoggerInterfaceBase::logThrottled(const LogLevel level, const std::string_view key,
+                                       const std::chrono::steady_clock::duration period,
+                                       const std::string& message) const {
+  const auto time = now();
+  std::size_t suppressed = 0;
+  {
+    std::lock_guard<std::mutex> lock{suppression_->mutex};
+    auto it = suppression_->keys.find(key);
+    if (it == suppression_->keys.end()) {
+      it = suppression_->keys.emplace(std::string{key}, KeyState{}).first;
+    } else if (time - it->second.last_logged < period) {
+      ++it->second.suppressed;
+      return;
+    }
+    it->second.last_logged = time;
+    suppressed = std::exchange(it->second.suppressed, 0);
+  }
+  log(level, withSuppressedCount(message, suppressed));
+}
+
+void LoggerInterfaceBase::logOnce(const LogLevel level, const std::string_view key, const std::string& message) const {
+  {
+    std::lock_guard<std::mutex> lock{suppression_->mutex};
+    const auto [it, inserted] = suppression_->keys.try_emplace(std::string{key});
+    if (!inserted) {
+      ++it->second.suppressed;
+      return;
+    }
+  }
+  log(level, message);
+}
+
+void LoggerInterfaceBase::logDeduplicated(const LogLevel level, const std::string_view key,
+                                          const std::string& message) const {
+  std::optional<std::string> repeated;
+  {
+    std::lock_guard<std::mutex> lock{suppression_->mutex};
+    auto it = suppression_->keys.find(key);
+    if (it == suppression_->keys.end()) {
+      it = suppression_->keys.emplace(std::string{key}, KeyState{}).first;
+    } else if (it->second.last_message == message) {
+      ++it->second.suppressed;
+      return;
+    } else if (it->second.suppressed > 0) {
+      repeated = "The previous message was repeated " + std::to_string(it->second.suppressed) + " more times.";
+    }
+    it->second.last_message = message;
+    it->second.suppressed = 0;
+  }
+  if (repeated.has_value()) {
+    log(level, repeated.value());
+  }
+  log(level, message);
+}
+
+void LoggerInterfaceBase::resetLog(const std::string_view key) const {
+  std::size_t suppressed = 0;
+  {
+    std::lock_guard<std::mutex> lock{suppression_->mutex};
+    const auto it = suppression_->keys.find(key);
+    if (it == suppression_->keys.end()) {
+      return;
+    }
+    suppressed = it->second.suppressed;
+    suppression_->keys.erase(it);
+  }
+  if (suppressed > 0) {
+    logInfo(std::to_string(suppressed) + " similar messages were suppressed before the condition cleared.");
+  }
+}
+
+std::chrono::steady_clock::time_point LoggerInterfaceBase::now() const {
+  return std::chrono::steady_clock::now();
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,151 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/interfaces/rclcpp_executor.hpp>
+
+#include <rcl/arguments.h>
+#include <rcl/error_handling.h>
+#include <rcl/node.h>
+#include <rcl_yaml_param_parser/parser.h>
+#include <rclcpp/executors/multi_threaded_executor.hpp>
+#include <rclcpp/executors/single_threaded_executor.hpp>
+#include <rclcpp/parameter_map.hpp>
+#include <rclcpp/parameter_value.hpp>
+#include <spot_driver/interfaces/rclcpp_logger_interface.hpp>
+#ifdef SPOT_DRIVER_HAS_EVENTS_EXECUTOR
+#include <rclcpp/experimental/executors/events_executor/events_executor.hpp>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace {
+constexpr auto kParameterNameExecutor = "executor";
+constexpr auto kParameterNameExecutorThreads = "executor_threads";
+
+/**
+ * @brief Find the override of a parameter of a node on the command line or in a parameter file.
+ * @details The arguments of the node take precedence over the global arguments, like they do for the parameters of
+ * the node itself.
+ *
+ * @param node Node whose parameter overrides are searched.
+ * @param name Name of the parameter.
+ * @return The value of the parameter, or nullopt if it is not overridden.
+ */
+std::optional<rclcpp::ParameterValue> getParameterOverride(rclcpp::node_interfaces::NodeBaseInterface& node,
+                                                           const std::string& name) {
+  const auto* const node_options = rcl_node_get_options(node.get_rcl_node_handle());
+  std::vector<const rcl_arguments_t*> arguments;
+  if (node_options != nullptr) {
+    arguments.push_back(&node_options->arguments);
+  }
+  if (node_options == nullptr || node_options->use_global_arguments) {
+    arguments.push_back(&node.get_context()->get_rcl_context()->global_arguments);
+  }
+
+  for (const auto* const argument : arguments) {
+    rcl_params_t* params = nullptr;
+    if (rcl_arguments_get_param_overrides(argument, &params) != RCL_RET_OK) {
+      rcl_reset_error();
+      continue;
+    }
+    if (params == nullptr) {
+      continue;
+    }
+    const auto parameter_map = rclcpp::parameter_map_from(params, node.get_fully_qualified_name());
+    rcl_yaml_node_struct_fini(params);
+    for (const auto& [node_name, parameters] : parameter_map) {
+      const auto parameter = std::find_if(parameters.cbegin(), parameters.cend(),
+                                          [&name](const rclcpp::Parameter& entry) { return entry.get_name() == name; });
+      if (parameter != parameters.cend()) {
+        return parameter->get_parameter_value();
+      }
+    }
+  }
+  return std::nullopt;
+}
+}  // namespace
+
+namespace spot_ros2 {
+tl::expected<ExecutorType, std::string> toExecutorType(const std::string& name) {
+  if (name == "single_threaded") {
+    return ExecutorType::SINGLE_THREADED;
+  } else if (name == "multi_threaded") {
+    return ExecutorType::MULTI_THREADED;
+  } else if (name == "events") {
+    return ExecutorType::EVENTS;
+  }
+  return tl::make_unexpected("Unknown executor '" + name +
+                             "'. Expected 'single_threaded', 'multi_threaded' or 'events'.");
+}
+
+bool isExecutorAvailable(const ExecutorType type) {
+  switch (type) {
+    case ExecutorType::SINGLE_THREADED:
+    case ExecutorType::MULTI_THREADED: {
+      return true;
+    }
+    case ExecutorType::EVENTS: {
+#ifdef SPOT_DRIVER_HAS_EVENTS_EXECUTOR
+      return true;
+#else
+      return false;
+#endif
+    }
+  }
+  return false;
+}
+
+void spinNode(const std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface>& node,
+              const ExecutorType default_type) {
+  const RclcppLoggerInterface logger{rclcpp::get_logger(node->get_name())};
+
+  auto type = default_type;
+  if (const auto executor_parameter = getParameterOverride(*node, kParameterNameExecutor); executor_parameter) {
+    tl::expected<ExecutorType, std::string> requested_type =
+        tl::make_unexpected(std::string{"The executor parameter must be a string."});
+    if (executor_parameter->get_type() == rclcpp::ParameterType::PARAMETER_STRING) {
+      requested_type = toExecutorType(executor_parameter->get<std::string>());
+    }
+    if (!requested_type.has_value()) {
+      logger.logWarn("Invalid executor parameter! Got error: " + requested_type.error() +
+                     " Spinning with the default executor.");
+    } else if (!isExecutorAvailable(requested_type.value())) {
+      logger.logWarn("The requested executor was not available at build time. Spinning with the default executor.");
+    } else {
+      type = requested_type.value();
+    }
+  }
+
+  // Zero threads lets the multi-threaded executor use one thread per core.
+  std::size_t threads = 0;
+  if (const auto threads_parameter = getParameterOverride(*node, kParameterNameExecutorThreads);
+      threads_parameter && threads_parameter->get_type() == rclcpp::ParameterType::PARAMETER_INTEGER) {
+    threads = static_cast<std::size_t>(std::max<std::int64_t>(threads_parameter->get<std::int64_t>(), 0));
+  }
+
+  std::unique_ptr<rclcpp::Executor> executor;
+  switch (type) {
+    case ExecutorType::MULTI_THREADED: {
+      executor = std::make_unique<rclcpp::executors::MultiThreadedExecutor>(rclcpp::ExecutorOptions{}, threads);
+      break;
+    }
+    case ExecutorType::EVENTS: {
+#ifdef SPOT_DRIVER_HAS_EVENTS_EXECUTOR
+      executor = std::make_unique<rclcpp::experimental::executors::EventsExecutor>();
+#else
+      // Never selected without the events executor, since it is not available then.
+      executor = std::make_unique<rclcpp::executors::SingleThreadedExecutor>();
+#endif
+      break;
+    }
+    case ExecutorType::SINGLE_THREADED: {
+      executor = std::make_unique<rclcpp::executors::SingleThreadedExecutor>();
+      break;
+    }
+  }
+  executor->add_node(node);
+  executor->spin();
+}
+}  // namespace spot_ros2
@@ -2,8 +2,14 @@
 
 #include <spot_driver/interfaces/rclcpp_parameter_interface.hpp>
 
+#include <algorithm>
+#include <any>
 #include <chrono>
 #include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -26,10 +32,88 @@ constexpr auto kParameterNameUncompressImages = "uncompress_images";
 constexpr auto kParameterNamePublishCompressedImages = "publish_compressed_images";
 constexpr auto kParameterNamePublishDepthImages = "publish_depth";
 constexpr auto kParameterNamePublishDepthRegisteredImages = "publish_depth_registered";
+constexpr auto kParameterNameImageDecodeThreads = "image_decode_threads";
+constexpr auto kParameterNameJpegDecoder = "jpeg_decoder";
+constexpr auto kParameterNameRLEDepthImages = "rle_depth_images";
+constexpr auto kParameterPrefixCameraPublishRate = "image_rate.";
+constexpr auto kParameterNameImageRequestsInFlight = "image_requests_in_flight";
+constexpr auto kParameterNameOnDemandImages = "on_demand_images";
+constexpr auto kParameterNameStaticTransformsRefreshPeriod = "static_transforms_refresh_period";
+constexpr auto kParameterNameImagePreviewScale = "image_preview_scale";
+constexpr auto kParameterNameImagePreviewRegion = "image_preview_roi";
+constexpr auto kParameterNamePublishDepthPointClouds = "publish_depth_point_clouds";
+constexpr auto kParameterNamePointCloudVoxelSize = "point_cloud_voxel_size";
+constexpr auto kParameterNamePublishCompressedDepthImages = "publish_compressed_depth";
+constexpr auto kParameterNameCompressedDepthFormat = "compressed_depth_format";
+constexpr auto kParameterNamePublishFilteredDepthImages = "publish_filtered_depth";
+constexpr auto kParameterNameFilteredDepthDecimation = "filtered_depth_decimation";
+constexpr auto kParameterNameFilteredDepthFillHoles = "filtered_depth_fill_holes";
+constexpr auto kParameterNameFilteredDepthMinRange = "filtered_depth_min_range";
+constexpr auto kParameterNameFilteredDepthMaxRange = "filtered_depth_max_range";
+constexpr auto kParameterNamePublishLaserScan = "publish_laser_scan";
+constexpr auto kParameterNameLaserScanMinHeight = "laser_scan_min_height";
+constexpr auto kParameterNameLaserScanMaxHeight = "laser_scan_max_height";
+constexpr auto kParameterNameLaserScanRangeMax = "laser_scan_range_max";
+constexpr auto kParameterNameLaserScanAngleIncrement = "laser_scan_angle_increment";
+constexpr auto kParameterNamePublishStitchedFrontImage = "publish_stitched_front_image";
+constexpr auto kParameterNameVirtualCameraFrame = "virtual_camera_frame";
+constexpr auto kParameterNameVirtualCameraIntrinsics = "virtual_camera_intrinsics";
+constexpr auto kParameterNameVirtualCameraProjectionPlane = "virtual_camera_projection_plane";
+constexpr auto kParameterNameVirtualCameraPlaneDistance = "virtual_camera_plane_distance";
+constexpr auto kParameterNameStitchedImageRowPadding = "stitched_image_row_padding";
+constexpr auto kParameterNameStitchedImageSeamUpdatePeriod = "stitched_image_seam_update_period";
+constexpr auto kParameterNameStitchedImageBlendMode = "stitched_image_blend_mode";
+constexpr auto kParameterNameStitchedImageBlendWidth = "stitched_image_blend_width";
+constexpr auto kParameterNameStitchedImageUseGpu = "stitched_image_use_gpu";
+constexpr auto kParameterNamePublishImageLatencyDiagnostics = "publish_image_latency_diagnostics";
+constexpr auto kParameterNameHandCameraStreamRate = "hand_camera_stream_rate";
+constexpr auto kParameterNameHandCameraStreamQuality = "hand_camera_stream_quality";
+constexpr auto kParameterNameHandCameraStreamResizeRatio = "hand_camera_stream_resize_ratio";
+constexpr auto kParameterNameAdaptiveRGBImageQuality = "adaptive_rgb_image_quality";
+constexpr auto kParameterNameMinRGBImageQuality = "min_rgb_image_quality";
+constexpr auto kParameterNameMaxImageAge = "max_image_age";
+constexpr auto kParameterNameImageBandwidthBudget = "image_bandwidth_budget";
+constexpr auto kParameterPrefixCameraPriority = "image_priority.";
+constexpr auto kParameterPrefixCameraImageEncoding = "image_encoding.";
+constexpr auto kParameterNameColorizeRegisteredPointClouds = "colorize_registered_point_clouds";
+constexpr auto kParameterNamePublishImageBundle = "publish_image_bundle";
+constexpr auto kParameterNameStreamImages = "stream_images";
+constexpr auto kParameterNameWarmUpImages = "warm_up_images";
+constexpr auto kParameterNameStreamRobotState = "stream_robot_state";
+constexpr auto kParameterNameLowLevelJointStates = "low_level_joint_states";
+constexpr auto kParameterNamePublishStatusOnChange = "publish_status_on_change";
+constexpr auto kParameterNameStatusHeartbeatPeriod = "status_heartbeat_period";
+constexpr auto kParameterNameMetricsPublishPeriod = "metrics_publish_period";
+constexpr auto kParameterNameMetricsTextfile = "metrics_textfile";
+constexpr auto kParameterNamePublishRawProtobuf = "publish_raw_protobuf";
+constexpr auto kParameterNameRawProtobufOnly = "raw_protobuf_only";
+constexpr auto kParameterNameRobotStateHistorySize = "robot_state_history_size";
+constexpr auto kParameterPrefixRobotStatePublishRate = "robot_state_rate.";
 constexpr auto kParameterPreferredOdomFrame = "preferred_odom_frame";
 constexpr auto kParameterTFRoot = "tf_root";
+constexpr auto kParameterNameObjectSyncTranslationThreshold = "object_sync_translation_threshold";
+constexpr auto kParameterNameObjectSyncRotationThreshold = "object_sync_rotation_threshold";
+constexpr auto kParameterNameObjectSyncTfCacheDuration = "object_sync_tf_cache_duration";
+constexpr auto kParameterNameObjectSyncTfFrameAllowlist = "object_sync_tf_frame_allowlist";
+constexpr auto kParameterNameObjectSyncTfFrameDenylist = "object_sync_tf_frame_denylist";
+constexpr auto kParameterNameObjectSyncWorldObjectTfRate = "object_sync_world_object_tf_rate";
+constexpr auto kParameterPrefixThreadCpus = "thread_cpus.";
+constexpr auto kParameterNameIKCacheSize = "ik_cache_size";
+constexpr auto kParameterNameIKCachePositionTolerance = "ik_cache_position_tolerance";
+constexpr auto kParameterNameIKCacheRotationTolerance = "ik_cache_rotation_tolerance";
+constexpr auto kParameterNameRobotDescription = "robot_description";
 constexpr auto kParameterNameGripperless = "gripperless";
 constexpr auto kParameterTimeSyncTimeout = "timesync_timeout";
+constexpr auto kParameterNameImageRequestTimeout = "image_request_timeout";
+constexpr auto kParameterNameRobotStateRequestTimeout = "robot_state_request_timeout";
+constexpr auto kParameterNameWorldObjectRequestTimeout = "world_object_request_timeout";
+constexpr auto kParameterNameKinematicRequestTimeout = "kinematic_request_timeout";
+constexpr auto kParameterNameDegradeOnPoorLink = "degrade_on_poor_link";
+constexpr auto kParameterNameLinkDegradedLatency = "link_degraded_latency";
+constexpr auto kParameterNameLinkDegradedFailureRate = "link_degraded_failure_rate";
+constexpr auto kParameterNameDegradedRateDivisor = "degraded_rate_divisor";
+constexpr auto kParameterNameDegradedRGBImageQuality = "degraded_image_quality";
+constexpr auto kParameterPrefixQoS = "qos.";
 
 /**
  * @brief Get a rclcpp parameter. If the parameter has not been declared, declare it with the provided default value and
@@ -137,74 +221,523 @@ namespace spot_ros2 {
 
 RclcppParameterInterface::RclcppParameterInterface(const std::shared_ptr<rclcpp::Node>& node) : node_{node} {}
 
+template <typename ValueT, typename ResolveT>
+ValueT RclcppParameterInterface::getCached(const std::string& key, const ResolveT& resolve) const {
+  {
+    std::lock_guard<std::mutex> lock{cache_mutex_};
+    if (const auto it = cache_.find(key); it != cache_.end()) {
+      return std::any_cast<ValueT>(it->second);
+    }
+  }
+  // The node is not called under the lock. If two threads resolve the same key, the first cached value is used.
+  ValueT value = resolve();
+  std::lock_guard<std::mutex> lock{cache_mutex_};
+  return std::any_cast<ValueT>(cache_.try_emplace(key, std::move(value)).first->second);
+}
+
+template <typename ParameterT>
+ParameterT RclcppParameterInterface::getParameter(const std::string& name, const ParameterT& default_value) const {
+  return getCached<ParameterT>(name, [&] { return declareAndGetParameter<ParameterT>(node_, name, default_value); });
+}
+
 std::string RclcppParameterInterface::getHostname() const {
-  return getEnvironmentVariableParameterFallback(node_, kEnvVarNameHostname, kParameterNameHostname, kDefaultHostname);
+  return getCached<std::string>(kParameterNameHostname, [this] {
+    return getEnvironmentVariableParameterFallback(node_, kEnvVarNameHostname, kParameterNameHostname,
+                                                   kDefaultHostname);
+  });
 }
 
 std::optional<int> RclcppParameterInterface::getPort() const {
-  return getEnvironmentVariableParameterFallback<int>(node_, kEnvVarNamePort, kParameterNamePort);
+  return getCached<std::optional<int>>(kParameterNamePort, [this] {
+    return getEnvironmentVariableParameterFallback<int>(node_, kEnvVarNamePort, kParameterNamePort);
+  });
 }
 
 std::string RclcppParameterInterface::getUsername() const {
-  return getEnvironmentVariableParameterFallback(node_, kEnvVarNameUsername, kParameterNameUsername, kDefaultUsername);
+  return getCached<std::string>(kParameterNameUsername, [this] {
+    return getEnvironmentVariableParameterFallback(node_, kEnvVarNameUsername, kParameterNameUsername,
+                                                   kDefaultUsername);
+  });
 }
 
 std::string RclcppParameterInterface::getPassword() const {
-  return getEnvironmentVariableParameterFallback(node_, kEnvVarNamePassword, kParameterNamePassword, kDefaultPassword);
+  return getCached<std::string>(kParameterNamePassword, [this] {
+    return getEnvironmentVariableParameterFallback(node_, kEnvVarNamePassword, kParameterNamePassword,
+                                                   kDefaultPassword);
+  });
 }
 
 std::optional<std::string> RclcppParameterInterface::getCertificate() const {
-  return getEnvironmentVariableParameterFallback<std::string>(node_, kEnvVarNameCertificate, kParameterNameCertificate);
+  return getCached<std::optional<std::string>>(kParameterNameCertificate, [this] {
+    return getEnvironmentVariableParameterFallback<std::string>(node_, kEnvVarNameCertificate,
+                                                                kParameterNameCertificate);
+  });
 }
 
 double RclcppParameterInterface::getRGBImageQuality() const {
-  return declareAndGetParameter<double>(node_, kParameterNameRGBImageQuality, kDefaultRGBImageQuality);
+  return getParameter<double>(kParameterNameRGBImageQuality, kDefaultRGBImageQuality);
 }
 
 bool RclcppParameterInterface::getHasRGBCameras() const {
-  return declareAndGetParameter<bool>(node_, kParameterNameHasRGBCameras, kDefaultHasRGBCameras);
+  return getParameter<bool>(kParameterNameHasRGBCameras, kDefaultHasRGBCameras);
 }
 
 bool RclcppParameterInterface::getPublishRGBImages() const {
-  return declareAndGetParameter<bool>(node_, kParameterNamePublishRGBImages, kDefaultPublishRGBImages);
+  return getParameter<bool>(kParameterNamePublishRGBImages, kDefaultPublishRGBImages);
 }
 
 bool RclcppParameterInterface::getUncompressImages() const {
-  return declareAndGetParameter<bool>(node_, kParameterNameUncompressImages, kDefaultUncompressImages);
+  return getParameter<bool>(kParameterNameUncompressImages, kDefaultUncompressImages);
 }
 
 bool RclcppParameterInterface::getPublishCompressedImages() const {
-  return declareAndGetParameter<bool>(node_, kParameterNamePublishCompressedImages, kDefaultPublishCompressedImages);
+  return getParameter<bool>(kParameterNamePublishCompressedImages, kDefaultPublishCompressedImages);
 }
 
 bool RclcppParameterInterface::getPublishDepthImages() const {
-  return declareAndGetParameter<bool>(node_, kParameterNamePublishDepthImages, kDefaultPublishDepthImages);
+  return getParameter<bool>(kParameterNamePublishDepthImages, kDefaultPublishDepthImages);
 }
 
 bool RclcppParameterInterface::getPublishDepthRegisteredImages() const {
-  return declareAndGetParameter<bool>(node_, kParameterNamePublishDepthRegisteredImages,
-                                      kDefaultPublishDepthRegisteredImages);
+  return getParameter<bool>(kParameterNamePublishDepthRegisteredImages, kDefaultPublishDepthRegisteredImages);
+}
+
+int RclcppParameterInterface::getImageDecodeThreads() const {
+  return getParameter<int>(kParameterNameImageDecodeThreads, kDefaultImageDecodeThreads);
+}
+
+std::string RclcppParameterInterface::getJpegDecoder() const {
+  return getParameter<std::string>(kParameterNameJpegDecoder, kDefaultJpegDecoder);
+}
+
+bool RclcppParameterInterface::getRLEDepthImages() const {
+  return getParameter<bool>(kParameterNameRLEDepthImages, kDefaultRLEDepthImages);
+}
+
+double RclcppParameterInterface::getCameraPublishRate(const spot_ros2::SpotCamera camera) const {
+  // Each camera has its own parameter, e.g. `image_rate.hand`.
+  const auto camera_name = std::find_if(kRosStringToSpotCamera.cbegin(), kRosStringToSpotCamera.cend(),
+                                        [camera](const auto& entry) { return entry.second == camera; });
+  if (camera_name == kRosStringToSpotCamera.cend()) {
+    return kDefaultCameraPublishRate;
+  }
+  return getParameter<double>(kParameterPrefixCameraPublishRate + camera_name->first, kDefaultCameraPublishRate);
+}
+
+int RclcppParameterInterface::getImageRequestsInFlight() const {
+  return getParameter<int>(kParameterNameImageRequestsInFlight, kDefaultImageRequestsInFlight);
+}
+
+bool RclcppParameterInterface::getOnDemandImages() const {
+  return getParameter<bool>(kParameterNameOnDemandImages, kDefaultOnDemandImages);
+}
+
+double RclcppParameterInterface::getStaticTransformsRefreshPeriod() const {
+  return getParameter<double>(kParameterNameStaticTransformsRefreshPeriod, kDefaultStaticTransformsRefreshPeriod);
+}
+
+int RclcppParameterInterface::getImagePreviewScale() const {
+  return getParameter<int>(kParameterNameImagePreviewScale, kDefaultImagePreviewScale);
+}
+
+std::vector<int64_t> RclcppParameterInterface::getImagePreviewRegion() const {
+  // The region is given as [x, y, width, height] in pixels of the full-resolution images. Empty keeps the whole image.
+  return getParameter<std::vector<int64_t>>(kParameterNameImagePreviewRegion, {});
+}
+
+bool RclcppParameterInterface::getPublishDepthPointClouds() const {
+  return getParameter<bool>(kParameterNamePublishDepthPointClouds, kDefaultPublishDepthPointClouds);
+}
+
+double RclcppParameterInterface::getPointCloudVoxelSize() const {
+  return getParameter<double>(kParameterNamePointCloudVoxelSize, kDefaultPointCloudVoxelSize);
+}
+
+bool RclcppParameterInterface::getPublishCompressedDepthImages() const {
+  return getParameter<bool>(kParameterNamePublishCompressedDepthImages, kDefaultPublishCompressedDepthImages);
+}
+
+std::string RclcppParameterInterface::getCompressedDepthFormat() const {
+  return getParameter<std::string>(kParameterNameCompressedDepthFormat, kDefaultCompressedDepthFormat);
+}
+
+bool RclcppParameterInterface::getPublishFilteredDepthImages() const {
+  return getParameter<bool>(kParameterNamePublishFilteredDepthImages, kDefaultPublishFilteredDepthImages);
+}
+
+int RclcppParameterInterface::getFilteredDepthDecimation() const {
+  return getParameter<int>(kParameterNameFilteredDepthDecimation, kDefaultFilteredDepthDecimation);
+}
+
+bool RclcppParameterInterface::getFilteredDepthFillHoles() const {
+  return getParameter<bool>(kParameterNameFilteredDepthFillHoles, kDefaultFilteredDepthFillHoles);
+}
+
+double RclcppParameterInterface::getFilteredDepthMinRange() const {
+  return getParameter<double>(kParameterNameFilteredDepthMinRange, kDefaultFilteredDepthMinRange);
+}
+
+double RclcppParameterInterface::getFilteredDepthMaxRange() const {
+  return getParameter<double>(kParameterNameFilteredDepthMaxRange, kDefaultFilteredDepthMaxRange);
+}
+
+bool RclcppParameterInterface::getPublishLaserScan() const {
+  return getParameter<bool>(kParameterNamePublishLaserScan, kDefaultPublishLaserScan);
+}
+
+double RclcppParameterInterface::getLaserScanMinHeight() const {
+  return getParameter<double>(kParameterNameLaserScanMinHeight, kDefaultLaserScanMinHeight);
+}
+
+double RclcppParameterInterface::getLaserScanMaxHeight() const {
+  return getParameter<double>(kParameterNameLaserScanMaxHeight, kDefaultLaserScanMaxHeight);
+}
+
+double RclcppParameterInterface::getLaserScanRangeMax() const {
+  return getParameter<double>(kParameterNameLaserScanRangeMax, kDefaultLaserScanRangeMax);
+}
+
+double RclcppParameterInterface::getLaserScanAngleIncrement() const {
+  return getParameter<double>(kParameterNameLaserScanAngleIncrement, kDefaultLaserScanAngleIncrement);
+}
+
+bool RclcppParameterInterface::getPublishStitchedFrontImage() const {
+  return getParameter<bool>(kParameterNamePublishStitchedFrontImage, kDefaultPublishStitchedFrontImage);
+}
+
+std::string RclcppParameterInterface::getVirtualCameraFrame() const {
+  return getParameter<std::string>(kParameterNameVirtualCameraFrame, kDefaultVirtualCameraFrame);
+}
+
+std::vector<double> RclcppParameterInterface::getVirtualCameraIntrinsics() const {
+  // The intrinsics are given as a row-major 3x3 matrix. Empty keeps the identity matrix, like the image stitcher node.
+  return getParameter<std::vector<double>>(kParameterNameVirtualCameraIntrinsics, {});
+}
+
+std::vector<double> RclcppParameterInterface::getVirtualCameraProjectionPlane() const {
+  // The normal of the plane is given as [x, y, z]. Empty keeps the optical axis of the virtual camera.
+  return getParameter<std::vector<double>>(kParameterNameVirtualCameraProjectionPlane, {});
+}
+
+double RclcppParameterInterface::getVirtualCameraPlaneDistance() const {
+  return getParameter<double>(kParameterNameVirtualCameraPlaneDistance, kDefaultVirtualCameraPlaneDistance);
+}
+
+int RclcppParameterInterface::getStitchedImageRowPadding() const {
+  return getParameter<int>(kParameterNameStitchedImageRowPadding, kDefaultStitchedImageRowPadding);
+}
+
+int RclcppParameterInterface::getStitchedImageSeamUpdatePeriod() const {
+  return getParameter<int>(kParameterNameStitchedImageSeamUpdatePeriod, kDefaultStitchedImageSeamUpdatePeriod);
+}
+
+std::string RclcppParameterInterface::getStitchedImageBlendMode() const {
+  return getParameter<std::string>(kParameterNameStitchedImageBlendMode, kDefaultStitchedImageBlendMode);
+}
+
+int RclcppParameterInterface::getStitchedImageBlendWidth() const {
+  return getParameter<int>(kParameterNameStitchedImageBlendWidth, kDefaultStitchedImageBlendWidth);
+}
+
+bool RclcppParameterInterface::getStitchedImageUseGpu() const {
+  return getParameter<bool>(kParameterNameStitchedImageUseGpu, kDefaultStitchedImageUseGpu);
+}
+
+bool RclcppParameterInterface::getPublishImageLatencyDiagnostics() const {
+  return getParameter<bool>(kParameterNamePublishImageLatencyDiagnostics, kDefaultPublishImageLatencyDiagnostics);
+}
+
+double RclcppParameterInterface::getHandCameraStreamRate() const {
+  return getParameter<double>(kParameterNameHandCameraStreamRate, kDefaultHandCameraStreamRate);
+}
+
+double RclcppParameterInterface::getHandCameraStreamQuality() const {
+  return getParameter<double>(kParameterNameHandCameraStreamQuality, kDefaultHandCameraStreamQuality);
+}
+
+double RclcppParameterInterface::getHandCameraStreamResizeRatio() const {
+  return getParameter<double>(kParameterNameHandCameraStreamResizeRatio, kDefaultHandCameraStreamResizeRatio);
+}
+
+bool RclcppParameterInterface::getAdaptiveRGBImageQuality() const {
+  return getParameter<bool>(kParameterNameAdaptiveRGBImageQuality, kDefaultAdaptiveRGBImageQuality);
+}
+
+double RclcppParameterInterface::getMinRGBImageQuality() const {
+  return getParameter<double>(kParameterNameMinRGBImageQuality, kDefaultMinRGBImageQuality);
+}
+
+double RclcppParameterInterface::getMaxImageAge() const {
+  return getParameter<double>(kParameterNameMaxImageAge, kDefaultMaxImageAge);
+}
+
+double RclcppParameterInterface::getImageBandwidthBudget() const {
+  return getParameter<double>(kParameterNameImageBandwidthBudget, kDefaultImageBandwidthBudget);
+}
+
+int RclcppParameterInterface::getCameraPriority(const spot_ros2::SpotCamera camera) const {
+  // Each camera has its own parameter, e.g. `image_priority.hand`.
+  const auto camera_name = std::find_if(kRosStringToSpotCamera.cbegin(), kRosStringToSpotCamera.cend(),
+                                        [camera](const auto& entry) { return entry.second == camera; });
+  if (camera_name == kRosStringToSpotCamera.cend()) {
+    return kDefaultCameraPriority;
+  }
+  return getParameter<int>(kParameterPrefixCameraPriority + camera_name->first, kDefaultCameraPriority);
+}
+
+std::string RclcppParameterInterface::getCameraImageEncoding(const spot_ros2::SpotCamera camera) const {
+  // Each camera has its own parameter, e.g. `image_encoding.hand`.
+  const auto camera_name = std::find_if(kRosStringToSpotCamera.cbegin(), kRosStringToSpotCamera.cend(),
+                                        [camera](const auto& entry) { return entry.second == camera; });
+  if (camera_name == kRosStringToSpotCamera.cend()) {
+    return kDefaultCameraImageEncoding;
+  }
+  return getParameter<std::string>(kParameterPrefixCameraImageEncoding + camera_name->first,
+                                   kDefaultCameraImageEncoding);
+}
+
+bool RclcppParameterInterface::getColorizeRegisteredPointClouds() const {
+  return getParameter<bool>(kParameterNameColorizeRegisteredPointClouds, kDefaultColorizeRegisteredPointClouds);
+}
+
+bool RclcppParameterInterface::getPublishImageBundle() const {
+  return getParameter<bool>(kParameterNamePublishImageBundle, kDefaultPublishImageBundle);
+}
+
+bool RclcppParameterInterface::getStreamImages() const {
+  return getParameter<bool>(kParameterNameStreamImages, kDefaultStreamImages);
+}
+
+bool RclcppParameterInterface::getWarmUpImages() const {
+  return getParameter<bool>(kParameterNameWarmUpImages, kDefaultWarmUpImages);
+}
+
+bool RclcppParameterInterface::getStreamRobotState() const {
+  return getParameter<bool>(kParameterNameStreamRobotState, kDefaultStreamRobotState);
+}
+
+bool RclcppParameterInterface::getLowLevelJointStates() const {
+  return getParameter<bool>(kParameterNameLowLevelJointStates, kDefaultLowLevelJointStates);
+}
+
+bool RclcppParameterInterface::getPublishStatusOnChange() const {
+  return getParameter<bool>(kParameterNamePublishStatusOnChange, kDefaultPublishStatusOnChange);
+}
+
+double RclcppParameterInterface::getStatusHeartbeatPeriod() const {
+  return getParameter<double>(kParameterNameStatusHeartbeatPeriod, kDefaultStatusHeartbeatPeriod);
+}
+
+double RclcppParameterInterface::getMetricsPublishPeriod() const {
+  return getParameter<double>(kParameterNameMetricsPublishPeriod, kDefaultMetricsPublishPeriod);
+}
+
+std::string RclcppParameterInterface::getMetricsTextfile() const {
+  return getParameter<std::string>(kParameterNameMetricsTextfile, kDefaultMetricsTextfile);
+}
+
+bool RclcppParameterInterface::getPublishRawProtobuf() const {
+  return getParameter<bool>(kParameterNamePublishRawProtobuf, kDefaultPublishRawProtobuf);
+}
+
+bool RclcppParameterInterface::getRawProtobufOnly() const {
+  return getParameter<bool>(kParameterNameRawProtobufOnly, kDefaultRawProtobufOnly);
+}
+
+int RclcppParameterInterface::getRobotStateHistorySize() const {
+  return getParameter<int>(kParameterNameRobotStateHistorySize, kDefaultRobotStateHistorySize);
+}
+
+double RclcppParameterInterface::getRobotStatePublishRate(const std::string& topic) const {
+  // Each robot state topic has its own parameter, e.g. `robot_state_rate.battery_states`.
+  return getParameter<double>(kParameterPrefixRobotStatePublishRate + topic, kDefaultRobotStatePublishRate);
 }
 
 std::string RclcppParameterInterface::getPreferredOdomFrame() const {
-  return declareAndGetParameter<std::string>(node_, kParameterPreferredOdomFrame, kDefaultPreferredOdomFrame);
+  return getParameter<std::string>(kParameterPreferredOdomFrame, kDefaultPreferredOdomFrame);
 }
 
 std::string RclcppParameterInterface::getTFRoot() const {
-  return declareAndGetParameter<std::string>(node_, kParameterTFRoot, kDefaultTFRoot);
+  return getParameter<std::string>(kParameterTFRoot, kDefaultTFRoot);
+}
+
+double RclcppParameterInterface::getObjectSyncTranslationThreshold() const {
+  return getParameter<double>(kParameterNameObjectSyncTranslationThreshold, kDefaultObjectSyncTranslationThreshold);
+}
+
+double RclcppParameterInterface::getObjectSyncRotationThreshold() const {
+  return getParameter<double>(kParameterNameObjectSyncRotationThreshold, kDefaultObjectSyncRotationThreshold);
+}
+
+double RclcppParameterInterface::getObjectSyncTfCacheDuration() const {
+  return getParameter<double>(kParameterNameObjectSyncTfCacheDuration, kDefaultObjectSyncTfCacheDuration);
+}
+
+std::vector<std::string> RclcppParameterInterface::getObjectSyncTfFrameAllowlist() const {
+  return getParameter<std::vector<std::string>>(kParameterNameObjectSyncTfFrameAllowlist, {});
+}
+
+std::vector<std::string> RclcppParameterInterface::getObjectSyncTfFrameDenylist() const {
+  return getParameter<std::vector<std::string>>(kParameterNameObjectSyncTfFrameDenylist, {});
+}
+
+double RclcppParameterInterface::getObjectSyncWorldObjectTfRate() const {
+  return getParameter<double>(kParameterNameObjectSyncWorldObjectTfRate, kDefaultObjectSyncWorldObjectTfRate);
+}
+
+std::string RclcppParameterInterface::getThreadCpus(const std::string& thread_class) const {
+  // Each class of threads has its own parameter, e.g. `thread_cpus.image_stream`.
+  return getParameter<std::string>(kParameterPrefixThreadCpus + thread_class, kDefaultThreadCpus);
+}
+
+int RclcppParameterInterface::getIKCacheSize() const {
+  return getParameter<int>(kParameterNameIKCacheSize, kDefaultIKCacheSize);
+}
+
+double RclcppParameterInterface::getIKCachePositionTolerance() const {
+  return getParameter<double>(kParameterNameIKCachePositionTolerance, kDefaultIKCachePositionTolerance);
+}
+
+double RclcppParameterInterface::getIKCacheRotationTolerance() const {
+  return getParameter<double>(kParameterNameIKCacheRotationTolerance, kDefaultIKCacheRotationTolerance);
+}
+
+std::string RclcppParameterInterface::getRobotDescription() const {
+  return getParameter<std::string>(kParameterNameRobotDescription, "");
 }
 
 bool RclcppParameterInterface::getGripperless() const {
-  return declareAndGetParameter<bool>(node_, kParameterNameGripperless, kDefaultGripperless);
+  return getParameter<bool>(kParameterNameGripperless, kDefaultGripperless);
 }
 
 std::chrono::seconds RclcppParameterInterface::getTimeSyncTimeout() const {
-  int timeout_seconds =
-      declareAndGetParameter<int>(node_, kParameterTimeSyncTimeout,
-                                  std::chrono::duration_cast<std::chrono::seconds>(kDefaultTimeSyncTimeout).count());
+  int timeout_seconds = getParameter<int>(
+      kParameterTimeSyncTimeout, std::chrono::duration_cast<std::chrono::seconds>(kDefaultTimeSyncTimeout).count());
   return std::chrono::seconds(timeout_seconds);
 }
 
+double RclcppParameterInterface::getImageRequestTimeout() const {
+  return getParameter<double>(kParameterNameImageRequestTimeout, kDefaultImageRequestTimeout);
+}
+
+double RclcppParameterInterface::getRobotStateRequestTimeout() const {
+  return getParameter<double>(kParameterNameRobotStateRequestTimeout, kDefaultRobotStateRequestTimeout);
+}
+
+double RclcppParameterInterface::getWorldObjectRequestTimeout() const {
+  return getParameter<double>(kParameterNameWorldObjectRequestTimeout, kDefaultWorldObjectRequestTimeout);
+}
+
+double RclcppParameterInterface::getKinematicRequestTimeout() const {
+  return getParameter<double>(kParameterNameKinematicRequestTimeout, kDefaultKinematicRequestTimeout);
+}
+
+bool RclcppParameterInterface::getDegradeOnPoorLink() const {
+  return getParameter<bool>(kParameterNameDegradeOnPoorLink, kDefaultDegradeOnPoorLink);
+}
+
+double RclcppParameterInterface::getLinkDegradedLatency() const {
+  return getParameter<double>(kParameterNameLinkDegradedLatency, kDefaultLinkDegradedLatency);
+}
+
+double RclcppParameterInterface::getLinkDegradedFailureRate() const {
+  return getParameter<double>(kParameterNameLinkDegradedFailureRate, kDefaultLinkDegradedFailureRate);
+}
+
+int RclcppParameterInterface::getDegradedRateDivisor() const {
+  return getParameter<int>(kParameterNameDegradedRateDivisor, kDefaultDegradedRateDivisor);
+}
+
+double RclcppParameterInterface::getDegradedRGBImageQuality() const {
+  return getParameter<double>(kParameterNameDegradedRGBImageQuality, kDefaultDegradedRGBImageQuality);
+}
+
+tl::expected<PublisherQoSParameters, std::string> RclcppParameterInterface::getPublisherQoS(
+    const std::string& category) const {
+  // Each category of topics has its own parameters, e.g. `qos.image.reliability`.
+  const auto prefix = kParameterPrefixQoS + category + ".";
+  const auto reliability = getParameter<std::string>(prefix + "reliability", kDefaultQoSReliability);
+  const auto durability = getParameter<std::string>(prefix + "durability", kDefaultQoSDurability);
+  const auto depth = getParameter<int>(prefix + "depth", kDefaultQoSDepth);
+  const auto deadline = getParameter<double>(prefix + "deadline", kDefaultQoSDeadline);
+  const auto lifespan = getParameter<double>(prefix + "lifespan", kDefaultQoSLifespan);
+
+  PublisherQoSParameters qos;
+  if (reliability == "reliable" || reliability == "best_effort") {
+    qos.reliable = reliability == "reliable";
+  } else {
+    return tl::make_unexpected("Invalid QoS reliability '" + reliability + "' for " + category +
+                               " topics. Use 'reliable' or 'best_effort'.");
+  }
+  if (durability == "transient_local" || durability == "volatile") {
+    qos.transient_local = durability == "transient_local";
+  } else {
+    return tl::make_unexpected("Invalid QoS durability '" + durability + "' for " + category +
+                               " topics. Use 'transient_local' or 'volatile'.");
+  }
+  if (depth < 0 || deadline < 0.0 || lifespan < 0.0) {
+    return tl::make_unexpected("The QoS depth, deadline and lifespan for " + category +
+                               " topics must not be negative.");
+  }
+  if (depth > 0) {
+    qos.depth = static_cast<std::size_t>(depth);
+  }
+  qos.deadline = std::chrono::duration<double>{deadline};
+  qos.lifespan = std::chrono::duration<double>{lifespan};
+  return qos;
+}
+
+tl::expected<void, std::string> RclcppParameterInterface::validateParameter(const rclcpp::Parameter& parameter) {
+  // Values of the wrong type are already rejected by the node, since every parameter is declared with its type.
+  const auto& name = parameter.get_name();
+  const auto type = parameter.get_type();
+  if (name.rfind(kParameterPrefixQoS, 0) == 0) {
+    const auto setting = name.substr(name.rfind('.') + 1);
+    if (type == rclcpp::ParameterType::PARAMETER_STRING) {
+      const auto& value = parameter.as_string();
+      if (setting == "reliability" && value != "reliable" && value != "best_effort") {
+        return tl::make_unexpected("Invalid QoS reliability '" + value + "'. Use 'reliable' or 'best_effort'.");
+      }
+      if (setting == "durability" && value != "transient_local" && value != "volatile") {
+        return tl::make_unexpected("Invalid QoS durability '" + value + "'. Use 'transient_local' or 'volatile'.");
+      }
+    } else if ((type == rclcpp::ParameterType::PARAMETER_INTEGER && parameter.as_int() < 0) ||
+               (type == rclcpp::ParameterType::PARAMETER_DOUBLE && parameter.as_double() < 0.0)) {
+      return tl::make_unexpected("The QoS depth, deadline and lifespan must not be negative.");
+    }
+  } else if (name.rfind(kParameterPrefixCameraPublishRate, 0) == 0) {
+    if (type == rclcpp::ParameterType::PARAMETER_DOUBLE && parameter.as_double() <= 0.0) {
+      return tl::make_unexpected("The image rate of a camera must be positive.");
+    }
+  } else if (name == kParameterNameHandCameraStreamResizeRatio) {
+    if (type == rclcpp::ParameterType::PARAMETER_DOUBLE &&
+        (parameter.as_double() <= 0.0 || parameter.as_double() > 1.0)) {
+      return tl::make_unexpected("The hand camera stream resize ratio must be greater than 0 and at most 1.");
+    }
+  } else if (name == kParameterNameCamerasUsed && type == rclcpp::ParameterType::PARAMETER_STRING_ARRAY) {
+    for (const auto& camera : parameter.as_string_array()) {
+      if (kRosStringToSpotCamera.count(camera) == 0) {
+        return tl::make_unexpected("Cannot convert camera '" + camera + "' to a SpotCamera.");
+      }
+    }
+  }
+  return {};
+}
+
+rcl_interfaces::msg::SetParametersResult RclcppParameterInterface::validateParameters(
+    const std::vector<rclcpp::Parameter>& parameters) {
+  rcl_interfaces::msg::SetParametersResult result;
+  result.successful = true;
+  for (const auto& parameter : parameters) {
+    if (const auto valid = validateParameter(parameter); !valid) {
+      result.successful = false;
+      result.reason = parameter.get_name() + ": " + valid.error();
+      break;
+    }
+  }
+  return result;
+}
+
 std::set<spot_ros2::SpotCamera> RclcppParameterInterface::getDefaultCamerasUsed(const bool has_arm,
                                                                                 const bool gripperless) const {
   const bool has_hand_camera = has_arm && (!gripperless);
@@ -223,7 +756,7 @@ tl::expected<std::set<spot_ros2::SpotCamera>, std::string> RclcppParameterInterf
   const std::vector<std::string> kDefaultCamerasUsedVector(std::begin(kDefaultCamerasUsed),
                                                            std::end(kDefaultCamerasUsed));
   const auto cameras_used_param =
-      declareAndGetParameter<std::vector<std::string>>(node_, kParameterNameCamerasUsed, kDefaultCamerasUsedVector);
+      getParameter<std::vector<std::string>>(kParameterNameCamerasUsed, kDefaultCamerasUsedVector);
   std::set<spot_ros2::SpotCamera> spot_cameras_used;
   for (const auto& camera : cameras_used_param) {
     try {
@@ -2,32 +2,63 @@
 
 #include <spot_driver/interfaces/rclcpp_tf_broadcaster_interface.hpp>
 
+#include <tf2_msgs/msg/tf_message.hpp>
+
+namespace {
+constexpr auto kTfTopic{"/tf"};
+constexpr auto kTfStaticTopic{"/tf_static"};
+}  // namespace
+
 namespace spot_ros2 {
 RclcppTfBroadcasterInterface::RclcppTfBroadcasterInterface(const std::shared_ptr<rclcpp::Node>& node)
-    : static_tf_broadcaster_{node}, dynamic_tf_broadcaster_{node} {}
+    : node_{node}, static_tf_broadcaster_{node}, dynamic_tf_broadcaster_{node} {}
 
 void RclcppTfBroadcasterInterface::updateStaticTransforms(
     const std::vector<geometry_msgs::msg::TransformStamped>& transforms) {
-  bool has_new_frame = false;
+  changed_static_transforms_.clear();
   for (const auto& transform : transforms) {
-    // If one of the transforms is to a new child frame, flag that a new transform needs to be published and add the
-    // child frame to the set of currently-published frames.
-    if (current_static_child_frames_.count(transform.child_frame_id) == 0) {
-      has_new_frame = true;
-      current_static_child_frames_.insert(current_static_child_frames_.end(), transform.child_frame_id);
+    // A transform is sent if its child frame is new, or if its parent frame or value changed. The stamp is ignored,
+    // since callers restamp static transforms with every image.
+    const auto [it, inserted] = current_static_transforms_.try_emplace(transform.child_frame_id, transform);
+    if (!inserted) {
+      if (it->second.header.frame_id == transform.header.frame_id && it->second.transform == transform.transform) {
+        continue;
+      }
+      it->second = transform;
     }
+    changed_static_transforms_.push_back(transform);
+  }
+
+  // Only publish if the static transforms changed.
+  // Note that unlike in Python, the rclcpp StaticTransformPublisher will correctly re-publish all previous transforms,
+  // so only the changed ones need to be given to it.
+  if (!changed_static_transforms_.empty()) {
+    static_tf_broadcaster_.sendTransform(changed_static_transforms_);
   }
 
-  // Only publish if there is a new transform.
-  // Note that unlike in Python, the rclcpp StaticTransformPublisher will correctly re-publish all previous transforms.
-  if (has_new_frame) {
-    static_tf_broadcaster_.sendTransform(transforms);
+  // The recording has no late subscribers to replay /tf_static to, so every static transform is recorded whenever one
+  // changes, and once when a recorder is attached.
+  if (!recording_tap_->isActive()) {
+    static_transforms_recorded_ = false;
+  } else if (!changed_static_transforms_.empty() || !static_transforms_recorded_) {
+    tf2_msgs::msg::TFMessage message;
+    message.transforms.reserve(current_static_transforms_.size());
+    for (const auto& [child_frame_id, transform] : current_static_transforms_) {
+      message.transforms.push_back(transform);
+    }
+    recording_tap_->record(kTfStaticTopic, std::move(message), node_->now());
+    static_transforms_recorded_ = true;
   }
 }
 
 void RclcppTfBroadcasterInterface::sendDynamicTransforms(
     const std::vector<geometry_msgs::msg::TransformStamped>& transforms) {
   dynamic_tf_broadcaster_.sendTransform(transforms);
+  if (recording_tap_->isActive()) {
+    tf2_msgs::msg::TFMessage message;
+    message.transforms = transforms;
+    recording_tap_->record(kTfTopic, std::move(message), node_->now());
+  }
 }
 
 }  // namespace spot_ros2
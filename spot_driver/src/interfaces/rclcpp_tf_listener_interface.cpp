@@ -3,15 +3,76 @@
 #include <tf2/exceptions.h>
 #include <tf2/time.h>
 #include <tf2_ros/buffer.h>
-#include <tf2_ros/transform_listener.h>
+#include <tf2_ros/buffer_interface.h>
+#include <tf2_ros/qos.hpp>
+#include <rclcpp/logging.hpp>
+#include <algorithm>
 #include <memory>
 #include <spot_driver/interfaces/rclcpp_tf_listener_interface.hpp>
 #include <tl_expected/expected.hpp>
 
+namespace {
+// Static transforms can be republished with new values, so they are looked up in the buffer again after this time.
+constexpr auto kStaticTransformCacheLifetime = std::chrono::seconds(1);
+
+constexpr auto kTfTopic = "/tf";
+constexpr auto kTfStaticTopic = "/tf_static";
+// Like tf2_ros::TransformListener, the publishers of TF messages are not tracked.
+constexpr auto kAuthority = "Authority undetectable";
+}  // namespace
+
 namespace spot_ros2 {
-RclcppTfListenerInterface::RclcppTfListenerInterface(const std::shared_ptr<rclcpp::Node>& node)
-    : buffer_{node->get_clock()}, listener_{buffer_, node, false} {
+RclcppTfListenerInterface::RclcppTfListenerInterface(const std::shared_ptr<rclcpp::Node>& node,
+                                                     const TfListenerOptions& options)
+    : logger_{node->get_logger()},
+      allowed_frame_prefixes_{options.allowed_frame_prefixes},
+      denied_frame_prefixes_{options.denied_frame_prefixes},
+      buffer_{node->get_clock(), options.cache_duration} {
   buffer_.setUsingDedicatedThread(true);
+  tf_subscription_ = node->create_subscription<tf2_msgs::msg::TFMessage>(
+      kTfTopic, tf2_ros::DynamicListenerQoS(),
+      [this](const std::shared_ptr<const tf2_msgs::msg::TFMessage> msg) { onTransforms(*msg, false); });
+  tf_static_subscription_ = node->create_subscription<tf2_msgs::msg::TFMessage>(
+      kTfStaticTopic, tf2_ros::StaticListenerQoS(),
+      [this](const std::shared_ptr<const tf2_msgs::msg::TFMessage> msg) { onTransforms(*msg, true); });
+}
+
+bool RclcppTfListenerInterface::isTracked(const std::string& frame) const {
+  const auto starts_frame = [&frame](const std::string& prefix) {
+    return frame.compare(0, prefix.size(), prefix) == 0;
+  };
+  if (std::any_of(denied_frame_prefixes_.cbegin(), denied_frame_prefixes_.cend(), starts_frame)) {
+    return false;
+  }
+  return allowed_frame_prefixes_.empty() ||
+         std::any_of(allowed_frame_prefixes_.cbegin(), allowed_frame_prefixes_.cend(), starts_frame);
+}
+
+void RclcppTfListenerInterface::onTransforms(const tf2_msgs::msg::TFMessage& msg, const bool is_static) {
+  for (const auto& transform : msg.transforms) {
+    if (!isTracked(transform.child_frame_id)) {
+      continue;
+    }
+    try {
+      buffer_.setTransform(transform, kAuthority, is_static);
+    } catch (const tf2::TransformException& e) {
+      RCLCPP_ERROR(logger_, "Failure to set received transform from %s to %s: %s", transform.header.frame_id.c_str(),
+                   transform.child_frame_id.c_str(), e.what());
+    }
+  }
+
+  std::lock_guard lock{generations_mutex_};
+  ++generation_;
+  for (const auto& transform : msg.transforms) {
+    if (!isTracked(transform.child_frame_id)) {
+      continue;
+    }
+    if (const auto it = frame_generations_.find(transform.child_frame_id); it != frame_generations_.end()) {
+      it->second = generation_;
+    } else {
+      frame_generations_.emplace(transform.child_frame_id, generation_);
+    }
+  }
 }
 
 std::vector<std::string> RclcppTfListenerInterface::getAllFrameNames() const {
@@ -19,10 +80,58 @@ std::vector<std::string> RclcppTfListenerInterface::getAllFrameNames() const {
   return buffer_.getAllFrameNames();
 }
 
+std::vector<std::string> RclcppTfListenerInterface::getUpdatedFrameNames(std::uint64_t& generation) const {
+  std::vector<std::string> frame_names;
+  std::lock_guard lock{generations_mutex_};
+  for (const auto& [frame_name, frame_generation] : frame_generations_) {
+    if (frame_generation > generation) {
+      frame_names.push_back(frame_name);
+    }
+  }
+  generation = generation_;
+  return frame_names;
+}
+
 tl::expected<geometry_msgs::msg::TransformStamped, std::string> RclcppTfListenerInterface::lookupTransform(
     const std::string& parent, const std::string& child, const rclcpp::Time& timepoint) const {
+  const auto now = std::chrono::steady_clock::now();
+  auto key = std::make_pair(parent, child);
+  {
+    std::lock_guard lock{static_transforms_mutex_};
+    if (const auto it = static_transforms_.find(key); it != static_transforms_.end() && it->second.expiry > now) {
+      auto transform = it->second.transform;
+      transform.header.stamp = timepoint;
+      return transform;
+    }
+  }
+
   try {
-    // Use the non-blocking version of lookupTransform that does not set a timeout duration
+    // The transform is first looked up at time zero, which returns a zero stamp if every transform between the frames
+    // is static. The value of such a transform is the same at every time, so it is cached.
+    // Buffer::canTransform reports the common case of a transform which is not available yet without throwing.
+    std::string error;
+    if (!buffer_.canTransform(child, parent, tf2::TimePointZero, &error)) {
+      // Without a transform at any time, there is none at the requested time either.
+      return tl::make_unexpected(error);
+    }
+    auto transform = buffer_.lookupTransform(child, parent, tf2::TimePointZero);
+    if (rclcpp::Time(transform.header.stamp).nanoseconds() == 0) {
+      {
+        std::lock_guard lock{static_transforms_mutex_};
+        static_transforms_.insert_or_assign(std::move(key),
+                                            CachedTransform{transform, now + kStaticTransformCacheLifetime});
+      }
+      transform.header.stamp = timepoint;
+      return transform;
+    }
+    if (timepoint.nanoseconds() == 0) {
+      return transform;
+    }
+
+    // Use the non-blocking versions of canTransform and lookupTransform that do not set a timeout duration.
+    if (!buffer_.canTransform(child, parent, tf2_ros::fromRclcpp(timepoint), &error)) {
+      return tl::make_unexpected(error);
+    }
     return buffer_.lookupTransform(child, parent, timepoint);
   } catch (const tf2::LookupException& e) {
     return tl::make_unexpected(e.what());
@@ -3,11 +3,13 @@
 #include <spot_driver/interfaces/rclcpp_wall_timer_interface.hpp>
 
 namespace spot_ros2 {
-RclcppWallTimerInterface::RclcppWallTimerInterface(const std::shared_ptr<rclcpp::Node>& node) : node_{node} {}
+RclcppWallTimerInterface::RclcppWallTimerInterface(const std::shared_ptr<rclcpp::Node>& node,
+                                                   const rclcpp::CallbackGroup::SharedPtr& callback_group)
+    : node_{node}, callback_group_{callback_group} {}
 
 void RclcppWallTimerInterface::setTimer(const std::chrono::duration<double>& period,
                                         const std::function<void()>& callback) {
-  timer_ = node_->create_wall_timer(period, callback);
+  timer_ = node_->create_wall_timer(period, callback, callback_group_);
 }
 
 void RclcppWallTimerInterface::clearTimer() {
@@ -0,0 +1,98 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/interfaces/thread_settings.hpp>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <charconv>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace {
+// Linux limits thread names to 15 characters plus the terminating null character.
+constexpr std::size_t kMaxThreadNameLength = 15;
+
+/** @brief Parse a CPU number within [0, CPU_SETSIZE). */
+std::optional<int> parseCpu(const std::string_view text) {
+  int cpu = 0;
+  const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), cpu);
+  if (error != std::errc{} || end != text.data() + text.size() || cpu < 0 || cpu >= CPU_SETSIZE) {
+    return std::nullopt;
+  }
+  return cpu;
+}
+}  // namespace
+
+namespace spot_ros2 {
+tl::expected<std::vector<int>, std::string> parseCpuList(std::string_view cpu_list) {
+  std::vector<int> cpus;
+  if (cpu_list.empty()) {
+    return cpus;
+  }
+  for (auto comma = std::string_view::size_type{0}; comma != std::string_view::npos;) {
+    comma = cpu_list.find(',');
+    const auto item = cpu_list.substr(0, comma);
+    cpu_list.remove_prefix(comma == std::string_view::npos ? cpu_list.size() : comma + 1);
+
+    const auto dash = item.find('-');
+    const auto first = parseCpu(item.substr(0, dash));
+    const auto last = dash == std::string_view::npos ? first : parseCpu(item.substr(dash + 1));
+    if (!first || !last || *last < *first) {
+      return tl::make_unexpected("`" + std::string{item} + "` is not a CPU or a range of CPUs below " +
+                                 std::to_string(CPU_SETSIZE) + ".");
+    }
+    for (int cpu = *first; cpu <= *last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+tl::expected<ThreadSettings, std::string> makeThreadSettings(const ParameterInterfaceBase& parameters,
+                                                             const std::string& thread_class, std::string name) {
+  const auto cpus = parseCpuList(parameters.getThreadCpus(thread_class));
+  if (!cpus) {
+    return tl::make_unexpected("Invalid parameter thread_cpus." + thread_class + ": " + cpus.error());
+  }
+  return ThreadSettings{std::move(name), cpus.value()};
+}
+
+tl::expected<void, std::string> applyThreadSettings(const std::thread::native_handle_type thread,
+                                                    const ThreadSettings& settings) {
+  std::string errors;
+  if (!settings.name.empty()) {
+    const auto name = settings.name.substr(0, kMaxThreadNameLength);
+    if (const int error = pthread_setname_np(thread, name.c_str()); error != 0) {
+      errors += "Could not name the thread `" + name + "`: " + std::strerror(error) + ". ";
+    }
+  }
+  if (!settings.cpus.empty()) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (const auto cpu : settings.cpus) {
+      CPU_SET(cpu, &cpus);
+    }
+    if (const int error = pthread_setaffinity_np(thread, sizeof(cpus), &cpus); error != 0) {
+      errors += "Could not pin the thread `" + settings.name + "` to its CPUs: " + std::strerror(error) + ". ";
+    }
+  }
+  if (!errors.empty()) {
+    errors.pop_back();
+    return tl::make_unexpected(errors);
+  }
+  return {};
+}
+
+tl::expected<void, std::string> configureThread(const std::thread::native_handle_type thread,
+                                                const ParameterInterfaceBase& parameters,
+                                                const std::string& thread_class, std::string name) {
+  const auto settings = makeThreadSettings(parameters, thread_class, std::move(name));
+  if (!settings) {
+    return tl::make_unexpected(settings.error());
+  }
+  return applyThreadSettings(thread, settings.value());
+}
+}  // namespace spot_ros2
@@ -0,0 +1,199 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/interfaces/work_stealing_thread_pool.hpp>
+
+#include <rclcpp/logger.hpp>
+#include <spot_driver/interfaces/rclcpp_logger_interface.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <utility>
+
+namespace {
+// Pool and queue of the worker thread which is running, so that the tasks it posts go to its own queue.
+thread_local const void* current_pool = nullptr;
+thread_local std::size_t current_queue = 0;
+
+/** @brief Jobs of one parallelFor() call, which outlive the call if a worker only starts on them after it returned. */
+struct ParallelJobs {
+  std::function<void(std::size_t)> job;
+  std::size_t num_jobs;
+  std::atomic<std::size_t> next_job{0};
+  std::atomic<std::size_t> finished_jobs{0};
+  std::mutex mutex;
+  std::condition_variable finished;
+  std::exception_ptr error;
+
+  /** @brief Run jobs until every job has been claimed. */
+  void run() {
+    for (auto index = next_job++; index < num_jobs; index = next_job++) {
+      try {
+        job(index);
+      } catch (...) {
+        std::lock_guard lock{mutex};
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+      if (finished_jobs.fetch_add(1) + 1 == num_jobs) {
+        std::lock_guard lock{mutex};
+        finished.notify_all();
+      }
+    }
+  }
+};
+}  // namespace
+
+namespace spot_ros2 {
+WorkStealingThreadPool::WorkStealingThreadPool(const std::size_t num_threads,
+                                               std::unique_ptr<LoggerInterfaceBase> logger)
+    : logger_{std::move(logger)} {
+  const auto count = std::max<std::size_t>(num_threads, 1);
+  for (std::size_t index = 0; index < count; ++index) {
+    queues_.push_back(std::make_unique<TaskQueue>());
+  }
+  threads_.reserve(count);
+  for (std::size_t index = 0; index < count; ++index) {
+    threads_.emplace_back([this, index]() {
+      run(index);
+    });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    std::lock_guard lock{wake_mutex_};
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkStealingThreadPool::post(std::function<void()> task) {
+  const auto index = current_pool == this ? current_queue : next_queue_++ % queues_.size();
+  {
+    std::lock_guard lock{queues_[index]->mutex};
+    queues_[index]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard lock{wake_mutex_};
+    ++unclaimed_tasks_;
+  }
+  wake_.notify_one();
+}
+
+void WorkStealingThreadPool::parallelFor(const std::size_t num_jobs, const std::size_t max_workers,
+                                         const std::function<void(std::size_t)>& job) {
+  const auto num_helpers = std::min({num_jobs, std::max<std::size_t>(max_workers, 1), threads_.size() + 1}) - 1;
+  if (num_helpers == 0) {
+    for (std::size_t index = 0; index < num_jobs; ++index) {
+      job(index);
+    }
+    return;
+  }
+
+  // Helpers which only start once every job was claimed return without calling job, which may no longer be valid
+  auto jobs = std::make_shared<ParallelJobs>();
+  jobs->job = job;
+  jobs->num_jobs = num_jobs;
+  for (std::size_t helper = 0; helper < num_helpers; ++helper) {
+    post([jobs]() {
+      jobs->run();
+    });
+  }
+  jobs->run();
+
+  std::unique_lock lock{jobs->mutex};
+  jobs->finished.wait(lock, [&jobs, num_jobs]() {
+    return jobs->finished_jobs == num_jobs;
+  });
+  if (jobs->error) {
+    std::rethrow_exception(jobs->error);
+  }
+}
+
+std::size_t WorkStealingThreadPool::getNumThreads() const {
+  return threads_.size();
+}
+
+void WorkStealingThreadPool::run(const std::size_t index) {
+  current_pool = this;
+  current_queue = index;
+  while (true) {
+    {
+      std::unique_lock lock{wake_mutex_};
+      wake_.wait(lock, [this]() {
+        return stopping_ || unclaimed_tasks_ > 0;
+      });
+      if (unclaimed_tasks_ == 0) {
+        return;
+      }
+      --unclaimed_tasks_;
+    }
+    const auto task = takeTask(index);
+    try {
+      task();
+    } catch (const std::exception& e) {
+      logger_->logError(std::string{"A task of the thread pool threw an exception: "}.append(e.what()));
+    } catch (...) {
+      logger_->logError("A task of the thread pool threw an unknown exception.");
+    }
+  }
+}
+
+std::function<void()> WorkStealingThreadPool::takeTask(const std::size_t index) {
+  // The claimed task may be taken by another worker between two passes, but then that worker took a task which this
+  // worker claimed, and its own claimed task is still queued.
+  while (true) {
+    {
+      auto& own = *queues_[index];
+      std::lock_guard lock{own.mutex};
+      if (!own.tasks.empty()) {
+        auto task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        return task;
+      }
+    }
+    for (std::size_t offset = 1; offset < queues_.size(); ++offset) {
+      auto& other = *queues_[(index + offset) % queues_.size()];
+      std::lock_guard lock{other.mutex};
+      if (!other.tasks.empty()) {
+        auto task = std::move(other.tasks.front());
+        other.tasks.pop_front();
+        return task;
+      }
+    }
+  }
+}
+
+tl::expected<void, std::string> WorkStealingThreadPool::setThreadSettings(const ThreadSettings& settings) {
+  for (std::size_t index = 0; index < threads_.size(); ++index) {
+    const auto name = settings.name.empty() ? settings.name : settings.name + "_" + std::to_string(index);
+    if (auto result = applyThreadSettings(threads_[index].native_handle(), ThreadSettings{name, settings.cpus});
+        !result) {
+      return result;
+    }
+  }
+  return {};
+}
+
+namespace {
+std::shared_ptr<WorkStealingThreadPool> getSharedWorkStealingThreadPool() {
+  // spot_api is a shared library, so every component loaded into the same container gets the same pool
+  static const auto pool = std::make_shared<WorkStealingThreadPool>(
+      std::thread::hardware_concurrency(), std::make_unique<RclcppLoggerInterface>(rclcpp::get_logger("spot_workers")));
+  return pool;
+}
+}  // namespace
+
+std::shared_ptr<ThreadPoolInterfaceBase> getSharedThreadPool() {
+  return getSharedWorkStealingThreadPool();
+}
+
+tl::expected<void, std::string> configureSharedThreadPool(const ThreadSettings& settings) {
+  return getSharedWorkStealingThreadPool()->setThreadSettings(settings);
+}
+}  // namespace spot_ros2
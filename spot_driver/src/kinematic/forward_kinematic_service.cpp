@@ -0,0 +1,85 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/kinematic/forward_kinematic_service.hpp>
+
+#include <tf2_eigen/tf2_eigen.hpp>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr auto kServiceName = "get_forward_kinematic_solutions";
+}  // namespace
+
+namespace spot_ros2::kinematic {
+
+ForwardKinematicService::ForwardKinematicService(ForwardKinematics kinematics,
+                                                 std::unique_ptr<MiddlewareHandle> middleware_handle)
+    : kinematics_{std::move(kinematics)}, middleware_handle_{std::move(middleware_handle)} {}
+
+void ForwardKinematicService::initialize() {
+  middleware_handle_->createService(kServiceName,
+                                    [this](const std::shared_ptr<GetForwardKinematicSolutions::Request> request,
+                                           std::shared_ptr<GetForwardKinematicSolutions::Response> response) {
+                                      getSolutions(request, response);
+                                    });
+}
+
+void ForwardKinematicService::getSolutions(const std::shared_ptr<GetForwardKinematicSolutions::Request> request,
+                                           std::shared_ptr<GetForwardKinematicSolutions::Response> response) const {
+  response->root_link = kinematics_.getRootLink();
+  response->joint_names = kinematics_.getJointNames();
+
+  std::vector<std::size_t> links;
+  if (request->link_names.empty()) {
+    response->link_names = kinematics_.getLinkNames();
+    for (std::size_t link = 0; link < response->link_names.size(); ++link) {
+      links.push_back(link);
+    }
+  } else {
+    for (const auto& name : request->link_names) {
+      const auto link = kinematics_.getLinkIndex(name);
+      if (!link) {
+        response->success = false;
+        response->message = "The URDF has no link " + name + ".";
+        return;
+      }
+      links.push_back(*link);
+    }
+    response->link_names = request->link_names;
+  }
+
+  const auto num_solutions = request->joint_states.size() * links.size();
+  const auto jacobian_size = 6 * kinematics_.getJointNames().size();
+  response->poses.reserve(num_solutions);
+  if (request->compute_jacobians) {
+    response->jacobians.reserve(num_solutions * jacobian_size);
+  }
+  std::vector<Eigen::Isometry3d> root_tform_links;
+  Jacobian jacobian;
+  for (const auto& joint_state : request->joint_states) {
+    const auto positions = kinematics_.toJointPositions(joint_state);
+    if (!positions) {
+      response->success = false;
+      response->message = positions.error();
+      response->poses.clear();
+      response->jacobians.clear();
+      return;
+    }
+    kinematics_.computeLinkPoses(*positions, root_tform_links);
+    for (const auto link : links) {
+      response->poses.push_back(tf2::toMsg(root_tform_links[link]));
+      if (request->compute_jacobians) {
+        kinematics_.computeJacobian(root_tform_links, link, jacobian);
+        for (Eigen::Index row = 0; row < jacobian.rows(); ++row) {
+          for (Eigen::Index col = 0; col < jacobian.cols(); ++col) {
+            response->jacobians.push_back(jacobian(row, col));
+          }
+        }
+      }
+    }
+  }
+  response->success = true;
+}
+}  // namespace spot_ros2::kinematic
@@ -0,0 +1,155 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/kinematic/forward_kinematics.hpp>
+
+#include <urdf/model.h>
+
+#include <limits>
+#include <utility>
+
+namespace spot_ros2::kinematic {
+
+tl::expected<ForwardKinematics, std::string> ForwardKinematics::fromUrdf(const std::string& urdf) {
+  urdf::Model model;
+  if (!model.initString(urdf)) {
+    return tl::make_unexpected("Failed to parse the URDF.");
+  }
+
+  ForwardKinematics kinematics;
+  std::vector<double> lower_limits;
+  std::vector<double> upper_limits;
+  const auto root = model.getRoot();
+  kinematics.root_link_ = root->name;
+
+  // Links are added in depth first order, so that every parent comes before its children
+  std::vector<std::pair<urdf::LinkConstSharedPtr, std::size_t>> stack{{root, 0}};
+  while (!stack.empty()) {
+    const auto [link, parent] = stack.back();
+    stack.pop_back();
+
+    Link entry{parent, Eigen::Isometry3d::Identity(), JointType::kFixed, Eigen::Vector3d::UnitZ(), 0};
+    if (const auto& joint = link->parent_joint; joint != nullptr) {
+      const auto& origin = joint->parent_to_joint_origin_transform;
+      entry.parent_tform_joint.translation() << origin.position.x, origin.position.y, origin.position.z;
+      entry.parent_tform_joint.linear() =
+          Eigen::Quaterniond{origin.rotation.w, origin.rotation.x, origin.rotation.y, origin.rotation.z}
+              .toRotationMatrix();
+      switch (joint->type) {
+        case urdf::Joint::FIXED:
+          break;
+        case urdf::Joint::REVOLUTE:
+        case urdf::Joint::CONTINUOUS:
+          entry.type = JointType::kRevolute;
+          break;
+        case urdf::Joint::PRISMATIC:
+          entry.type = JointType::kPrismatic;
+          break;
+        default:
+          return tl::make_unexpected("Joint " + joint->name + " is neither fixed, revolute, continuous nor prismatic.");
+      }
+      if (entry.type != JointType::kFixed) {
+        if (kinematics.joint_names_.size() >= static_cast<std::size_t>(kMaxJoints)) {
+          return tl::make_unexpected("The URDF has more than " + std::to_string(kMaxJoints) + " movable joints.");
+        }
+        entry.axis = Eigen::Vector3d{joint->axis.x, joint->axis.y, joint->axis.z}.normalized();
+        entry.joint = kinematics.joint_names_.size();
+        kinematics.joint_indices_.emplace(joint->name, entry.joint);
+        kinematics.joint_names_.push_back(joint->name);
+        const bool limited = joint->type != urdf::Joint::CONTINUOUS && joint->limits != nullptr;
+        lower_limits.push_back(limited ? joint->limits->lower : -std::numeric_limits<double>::infinity());
+        upper_limits.push_back(limited ? joint->limits->upper : std::numeric_limits<double>::infinity());
+      }
+    }
+
+    const auto index = kinematics.links_.size();
+    kinematics.links_.push_back(entry);
+    kinematics.link_indices_.emplace(link->name, index);
+    kinematics.link_names_.push_back(link->name);
+    for (const auto& child : link->child_links) {
+      stack.emplace_back(child, index);
+    }
+  }
+  const auto num_joints = static_cast<Eigen::Index>(kinematics.joint_names_.size());
+  kinematics.lower_limits_ = Eigen::Map<const Eigen::VectorXd>(lower_limits.data(), num_joints);
+  kinematics.upper_limits_ = Eigen::Map<const Eigen::VectorXd>(upper_limits.data(), num_joints);
+  return kinematics;
+}
+
+std::optional<std::size_t> ForwardKinematics::getLinkIndex(const std::string& link) const {
+  if (const auto it = link_indices_.find(link); it != link_indices_.end()) {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
+std::optional<std::size_t> ForwardKinematics::getJointIndex(const std::string& joint) const {
+  if (const auto it = joint_indices_.find(joint); it != joint_indices_.end()) {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
+tl::expected<JointPositions, std::string> ForwardKinematics::toJointPositions(
+    const sensor_msgs::msg::JointState& joint_state) const {
+  if (joint_state.name.size() != joint_state.position.size()) {
+    return tl::make_unexpected("The joint state has " + std::to_string(joint_state.name.size()) + " names but " +
+                               std::to_string(joint_state.position.size()) + " positions.");
+  }
+  JointPositions positions(static_cast<Eigen::Index>(joint_names_.size()));
+  std::size_t num_found = 0;
+  for (std::size_t i = 0; i < joint_state.name.size(); ++i) {
+    // Joints which the model does not have, such as those of another robot, are ignored
+    if (const auto it = joint_indices_.find(joint_state.name[i]); it != joint_indices_.end()) {
+      positions[static_cast<Eigen::Index>(it->second)] = joint_state.position[i];
+      ++num_found;
+    }
+  }
+  if (num_found != joint_names_.size()) {
+    return tl::make_unexpected("The joint state is missing positions of the joints of the URDF.");
+  }
+  return positions;
+}
+
+void ForwardKinematics::computeLinkPoses(const JointPositions& positions,
+                                         std::vector<Eigen::Isometry3d>& root_tform_links) const {
+  root_tform_links.resize(links_.size());
+  root_tform_links.front().setIdentity();
+  for (std::size_t i = 1; i < links_.size(); ++i) {
+    const auto& link = links_[i];
+    auto& root_tform_link = root_tform_links[i];
+    root_tform_link = root_tform_links[link.parent] * link.parent_tform_joint;
+    switch (link.type) {
+      case JointType::kFixed:
+        break;
+      case JointType::kRevolute:
+        root_tform_link.rotate(Eigen::AngleAxisd{positions[static_cast<Eigen::Index>(link.joint)], link.axis});
+        break;
+      case JointType::kPrismatic:
+        root_tform_link.translate(positions[static_cast<Eigen::Index>(link.joint)] * link.axis);
+        break;
+    }
+  }
+}
+
+void ForwardKinematics::computeJacobian(const std::vector<Eigen::Isometry3d>& root_tform_links, std::size_t link,
+                                        Jacobian& jacobian) const {
+  jacobian.setZero(6, static_cast<Eigen::Index>(joint_names_.size()));
+  const Eigen::Vector3d tip = root_tform_links[link].translation();
+  // The joint of each link on the way to the root moves the tip. A joint only rotates or translates the link frame
+  // along its axis, so the axis in the link frame and the joint origin are the same as in the joint frame.
+  for (auto i = link; i != 0; i = links_[i].parent) {
+    const auto& current = links_[i];
+    if (current.type == JointType::kFixed) {
+      continue;
+    }
+    const Eigen::Vector3d axis = root_tform_links[i].linear() * current.axis;
+    auto column = jacobian.col(static_cast<Eigen::Index>(current.joint));
+    if (current.type == JointType::kRevolute) {
+      column.head<3>() = axis.cross(tip - root_tform_links[i].translation());
+      column.tail<3>() = axis;
+    } else {
+      column.head<3>() = axis;
+    }
+  }
+}
+}  // namespace spot_ros2::kinematic
@@ -0,0 +1,117 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/kinematic/kinematic_cache.hpp>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/text_format.h>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+constexpr auto kQuaternionTypeName = "bosdyn.api.Quaternion";
+
+void appendFloatingPoint(const double value, const double tolerance, std::string& key) {
+  if (tolerance > 0.0) {
+    key += std::to_string(std::llround(value / tolerance));
+  } else {
+    // Enough digits to tell apart any two doubles.
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    key += buffer;
+  }
+}
+
+// Append the set fields of a message, in the order of their numbers, with floating point values rounded to the
+// tolerances.
+void appendMessage(const google::protobuf::Message& message, const double position_tolerance,
+                   const double rotation_tolerance, std::string& key) {
+  const auto* reflection = message.GetReflection();
+  const double tolerance =
+      message.GetDescriptor()->full_name() == kQuaternionTypeName ? rotation_tolerance : position_tolerance;
+
+  std::vector<const google::protobuf::FieldDescriptor*> fields;
+  reflection->ListFields(message, &fields);
+  for (const auto* field : fields) {
+    key += std::to_string(field->number());
+    key += '{';
+    const int count = field->is_repeated() ? reflection->FieldSize(message, field) : 1;
+    for (int i = 0; i < count; ++i) {
+      switch (field->cpp_type()) {
+        case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+          appendFloatingPoint(field->is_repeated() ? reflection->GetRepeatedDouble(message, field, i)
+                                                   : reflection->GetDouble(message, field),
+                              tolerance, key);
+          break;
+        case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+          appendFloatingPoint(field->is_repeated() ? reflection->GetRepeatedFloat(message, field, i)
+                                                   : reflection->GetFloat(message, field),
+                              tolerance, key);
+          break;
+        case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+          appendMessage(field->is_repeated() ? reflection->GetRepeatedMessage(message, field, i)
+                                             : reflection->GetMessage(message, field),
+                        position_tolerance, rotation_tolerance, key);
+          break;
+        default: {
+          std::string value;
+          google::protobuf::TextFormat::PrintFieldValueToString(message, field, field->is_repeated() ? i : -1, &value);
+          key += value;
+        }
+      }
+      key += ',';
+    }
+    key += '}';
+  }
+}
+}  // namespace
+
+namespace spot_ros2::kinematic {
+
+KinematicCache::KinematicCache(const std::size_t capacity, const double position_tolerance,
+                               const double rotation_tolerance)
+    : capacity_{capacity}, position_tolerance_{position_tolerance}, rotation_tolerance_{rotation_tolerance} {}
+
+std::optional<InverseKinematicsResponse> KinematicCache::find(const InverseKinematicsRequest& request) {
+  const auto key = makeKey(request);
+  std::lock_guard lock{mutex_};
+  const auto it = index_.find(key);
+  if (it == index_.end()) {
+    return std::nullopt;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->second;
+}
+
+void KinematicCache::insert(const InverseKinematicsRequest& request, const InverseKinematicsResponse& response) {
+  if (capacity_ == 0) {
+    return;
+  }
+  auto key = makeKey(request);
+  std::lock_guard lock{mutex_};
+  if (const auto it = index_.find(key); it != index_.end()) {
+    it->second->second = response;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+  if (entries_.size() >= capacity_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.emplace_front(key, response);
+  index_.emplace(std::move(key), entries_.begin());
+}
+
+std::size_t KinematicCache::size() const {
+  std::lock_guard lock{mutex_};
+  return entries_.size();
+}
+
+std::string KinematicCache::makeKey(const InverseKinematicsRequest& request) const {
+  std::string key;
+  appendMessage(request, position_tolerance_, rotation_tolerance_, key);
+  return key;
+}
+}  // namespace spot_ros2::kinematic
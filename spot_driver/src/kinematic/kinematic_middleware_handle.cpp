@@ -7,9 +7,42 @@ namespace spot_ros2::kinematic {
 KinematicMiddlewareHandle::KinematicMiddlewareHandle(std::shared_ptr<rclcpp::Node> node) : node_{node} {}
 
 void KinematicMiddlewareHandle::createService(
-    std::string service_name, std::function<void(const std::shared_ptr<GetInverseKinematicSolutions::Request>,
-                                                 std::shared_ptr<GetInverseKinematicSolutions::Response>)>
+    std::string service_name,
+    std::function<void(const std::shared_ptr<GetInverseKinematicSolutions::Request>, KinematicService::Responder)>
+        callback) {
+  // The response is deferred: it is sent with the service handle whenever the responder is called.
+  service_ = node_->create_service<GetInverseKinematicSolutions>(
+      service_name, [callback](const std::shared_ptr<rclcpp::Service<GetInverseKinematicSolutions>> service,
+                               const std::shared_ptr<rmw_request_id_t> request_header,
+                               const std::shared_ptr<GetInverseKinematicSolutions::Request> request) {
+        callback(request, [service, request_header](std::shared_ptr<GetInverseKinematicSolutions::Response> response) {
+          service->send_response(*request_header, *response);
+        });
+      });
+}
+
+void KinematicMiddlewareHandle::createBatchService(
+    std::string service_name, std::function<void(const std::shared_ptr<GetInverseKinematicSolutionsBatch::Request>,
+                                                 KinematicService::BatchResponder)>
+                                  callback) {
+  batch_service_ = node_->create_service<GetInverseKinematicSolutionsBatch>(
+      service_name, [callback](const std::shared_ptr<rclcpp::Service<GetInverseKinematicSolutionsBatch>> service,
+                               const std::shared_ptr<rmw_request_id_t> request_header,
+                               const std::shared_ptr<GetInverseKinematicSolutionsBatch::Request> request) {
+        callback(request,
+                 [service, request_header](std::shared_ptr<GetInverseKinematicSolutionsBatch::Response> response) {
+                   service->send_response(*request_header, *response);
+                 });
+      });
+}
+
+ForwardKinematicMiddlewareHandle::ForwardKinematicMiddlewareHandle(std::shared_ptr<rclcpp::Node> node)
+    : node_{node} {}
+
+void ForwardKinematicMiddlewareHandle::createService(
+    std::string service_name, std::function<void(const std::shared_ptr<GetForwardKinematicSolutions::Request>,
+                                                 std::shared_ptr<GetForwardKinematicSolutions::Response>)>
                                   callback) {
-  service_ = node_->create_service<GetInverseKinematicSolutions>(service_name, callback);
+  service_ = node_->create_service<GetForwardKinematicSolutions>(service_name, callback);
 }
 }  // namespace spot_ros2::kinematic
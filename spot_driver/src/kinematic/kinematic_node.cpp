@@ -2,13 +2,20 @@
 
 #include <spot_driver/kinematic/kinematic_middleware_handle.hpp>
 #include <spot_driver/kinematic/kinematic_node.hpp>
+#include <spot_driver/kinematic/local_kinematic_api.hpp>
 
 #include <spot_driver/api/default_spot_api.hpp>
 #include <spot_driver/interfaces/rclcpp_logger_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_parameter_interface.hpp>
+#include <spot_driver/interfaces/thread_settings.hpp>
+#include <spot_driver/interfaces/work_stealing_thread_pool.hpp>
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <utility>
 
 namespace {
 constexpr auto kSDKClientName = "inverse_kinematic";
@@ -57,15 +64,55 @@ void KinematicNode::initialize(std::shared_ptr<rclcpp::Node> node, std::unique_p
     throw std::runtime_error(errorMsg);
   }
 
+  // Forward kinematics and the local arm solver use the URDF, so they are only offered if the node is given the URDF
+  std::shared_ptr<KinematicApi> local_kinematic_api;
+  if (const auto robot_description = parameter_interface->getRobotDescription(); !robot_description.empty()) {
+    auto kinematics = ForwardKinematics::fromUrdf(robot_description);
+    if (!kinematics) {
+      const auto error_msg{std::string{"Failed to load the robot description: "}.append(kinematics.error())};
+      logger_interface->logError(error_msg);
+      throw std::runtime_error(error_msg);
+    }
+    const auto frame_prefix = robot_name.empty() ? "" : robot_name + "/";
+    if (auto local_api = LocalKinematicApi::create(kinematics.value(), frame_prefix, getSharedThreadPool())) {
+      local_kinematic_api = std::move(local_api).value();
+      if (const auto result = makeThreadSettings(*parameter_interface, "workers", "spot_worker")
+                                  .and_then(configureSharedThreadPool);
+          !result) {
+        logger_interface->logWarn(result.error());
+      }
+    } else {
+      logger_interface->logInfo(std::string{"Not offering the local arm solver: "}.append(local_api.error()));
+    }
+    forward_kinematics_ = std::make_unique<ForwardKinematicService>(
+        std::move(kinematics).value(), std::make_unique<ForwardKinematicMiddlewareHandle>(node_));
+    forward_kinematics_->initialize();
+  }
+
   if (spot_api_->kinematicInterface() == nullptr) {
-    constexpr auto errorMsg{
-        "Failed to initialize the Spot API's inverse kinematics client, which is required to run this node."};
-    logger_interface->logError(errorMsg);
-    throw std::runtime_error(errorMsg);
+    if (local_kinematic_api == nullptr) {
+      constexpr auto errorMsg{
+          "Failed to initialize the Spot API's inverse kinematics client, which is required to run this node without "
+          "the local arm solver."};
+      logger_interface->logError(errorMsg);
+      throw std::runtime_error(errorMsg);
+    }
+    logger_interface->logWarn(
+        "Spot does not offer an inverse kinematics service, so all requests are solved by the local arm solver.");
+  }
+
+  std::unique_ptr<KinematicCache> cache;
+  if (const auto cache_size = parameter_interface->getIKCacheSize(); cache_size > 0) {
+    cache = std::make_unique<KinematicCache>(static_cast<std::size_t>(cache_size),
+                                             parameter_interface->getIKCachePositionTolerance(),
+                                             parameter_interface->getIKCacheRotationTolerance());
   }
 
+  const std::chrono::duration<double> request_timeout{parameter_interface->getKinematicRequestTimeout()};
   internal_ = std::make_unique<KinematicService>(spot_api_->kinematicInterface(), logger_interface,
-                                                 std::make_unique<KinematicMiddlewareHandle>(node_));
+                                                 std::make_unique<KinematicMiddlewareHandle>(node_), std::move(cache),
+                                                 std::move(local_kinematic_api), request_timeout,
+                                                 getSharedThreadPool());
   internal_->initialize();
 }
 
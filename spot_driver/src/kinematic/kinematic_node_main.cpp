@@ -1,7 +1,7 @@
 // Copyright (c) 2023 Boston Dynamics AI Institute LLC. All rights reserved.
 
-#include <rclcpp/executors.hpp>
 #include <rclcpp/utilities.hpp>
+#include <spot_driver/interfaces/rclcpp_executor.hpp>
 #include <spot_driver/kinematic/kinematic_node.hpp>
 
 #include <memory>
@@ -11,8 +11,8 @@ int main(int argc, char* argv[]) {
 
   const auto node = std::make_shared<spot_ros2::kinematic::KinematicNode>();
 
-  // Spins the node with the default single-threaded executor.
-  rclcpp::spin(node->get_node_base_interface());
+  // Spins the node with a single-threaded executor, unless another one is selected by the executor parameter.
+  spot_ros2::spinNode(node->get_node_base_interface(), spot_ros2::ExecutorType::SINGLE_THREADED);
 
   return 0;
 }
@@ -6,22 +6,94 @@
 #include <spot_driver/interfaces/rclcpp_logger_interface.hpp>
 #include <spot_driver/kinematic/kinematic_middleware_handle.hpp>
 
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <vector>
+
 namespace {
 constexpr auto kServiceName = "get_inverse_kinematic_solutions";
+constexpr auto kBatchServiceName = "get_inverse_kinematic_solutions_batch";
+// Maximum number of IK requests of a batch which are outstanding with Spot, or solved locally, at the same time.
+constexpr std::size_t kMaxRequestsInFlight = 8;
+// Maximum number of service requests which are solved concurrently. Further requests wait in the executor.
+constexpr std::size_t kMaxConcurrentRequests = 16;
+
+void setFailedResponse(bosdyn_spot_api_msgs::msg::InverseKinematicsResponse& response) {
+  response.status.value = bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_UNKNOWN;
 }
+}  // namespace
 
 namespace spot_ros2::kinematic {
 KinematicService::KinematicService(std::shared_ptr<KinematicApi> kinematic_api,
                                    std::shared_ptr<LoggerInterfaceBase> logger,
-                                   std::unique_ptr<MiddlewareHandle> middleware_handle)
-    : kinematic_api_{kinematic_api}, logger_{std::move(logger)}, middleware_handle_{std::move(middleware_handle)} {}
+                                   std::unique_ptr<MiddlewareHandle> middleware_handle,
+                                   std::unique_ptr<KinematicCache> cache,
+                                   std::shared_ptr<KinematicApi> local_kinematic_api,
+                                   std::chrono::duration<double> request_timeout,
+                                   std::shared_ptr<ThreadPoolInterfaceBase> thread_pool)
+    : kinematic_api_{kinematic_api},
+      logger_{std::move(logger)},
+      middleware_handle_{std::move(middleware_handle)},
+      cache_{std::move(cache)},
+      local_kinematic_api_{std::move(local_kinematic_api)},
+      request_timeout_{request_timeout},
+      thread_pool_{std::move(thread_pool)} {}
+
+KinematicApi* KinematicService::selectApi(std::uint8_t solver) const {
+  if (solver == GetInverseKinematicSolutions::Request::SOLVER_LOCAL || kinematic_api_ == nullptr) {
+    return local_kinematic_api_.get();
+  }
+  return kinematic_api_.get();
+}
+
+KinematicService::~KinematicService() {
+  std::lock_guard lock{pending_mutex_};
+  for (auto& task : pending_) {
+    task.wait();
+  }
+}
 
 void KinematicService::initialize() {
-  middleware_handle_->createService(kServiceName,
-                                    [this](const std::shared_ptr<GetInverseKinematicSolutions::Request> request,
-                                           std::shared_ptr<GetInverseKinematicSolutions::Response> response) {
-                                      this->getSolutions(request, response);
-                                    });
+  middleware_handle_->createService(
+      kServiceName, [this](const std::shared_ptr<GetInverseKinematicSolutions::Request> request, Responder respond) {
+        dispatch([this, request, respond = std::move(respond)]() {
+          auto response = std::make_shared<GetInverseKinematicSolutions::Response>();
+          this->getSolutions(request, response);
+          respond(response);
+        });
+      });
+  middleware_handle_->createBatchService(
+      kBatchServiceName,
+      [this](const std::shared_ptr<GetInverseKinematicSolutionsBatch::Request> request, BatchResponder respond) {
+        dispatch([this, request, respond = std::move(respond)]() {
+          auto response = std::make_shared<GetInverseKinematicSolutionsBatch::Response>();
+          this->getBatchSolutions(request, response);
+          respond(response);
+        });
+      });
+}
+
+void KinematicService::dispatch(std::function<void()> task) {
+  std::lock_guard lock{pending_mutex_};
+  pending_.remove_if([](const std::future<void>& pending) {
+    return pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+  });
+  if (pending_.size() >= kMaxConcurrentRequests) {
+    pending_.front().wait();
+    pending_.pop_front();
+  }
+  // Like a task of std::async, a task which throws makes its future ready with the exception instead of escaping.
+  auto finished = std::make_shared<std::promise<void>>();
+  pending_.push_back(finished->get_future());
+  thread_pool_->post([task = std::move(task), finished]() {
+    try {
+      task();
+      finished->set_value();
+    } catch (...) {
+      finished->set_exception(std::current_exception());
+    }
+  });
 }
 
 void KinematicService::getSolutions(const std::shared_ptr<GetInverseKinematicSolutions::Request> request,
@@ -31,12 +103,119 @@ void KinematicService::getSolutions(const std::shared_ptr<GetInverseKinematicSol
   bosdyn::api::spot::InverseKinematicsRequest proto_request;
   convertToProto(ros_request, proto_request);
 
-  auto expected = kinematic_api_->getSolutions(proto_request);
+  auto* const api = selectApi(request->solver);
+  if (api == nullptr) {
+    logger_->logError("The requested inverse kinematics solver is not available.");
+    setFailedResponse(response->response);
+    return;
+  }
+  // Only the responses of Spot are cached, since the local solver is cheap to query
+  auto* const cache = api == kinematic_api_.get() ? cache_.get() : nullptr;
+  if (cache) {
+    if (const auto cached = cache->find(proto_request)) {
+      convertToRos(*cached, response->response);
+      return;
+    }
+  }
+
+  // Identical requests to Spot which arrive while one of them is being sent share its response.
+  auto expected = api == kinematic_api_.get() ? getCoalescedSolutions(proto_request)
+                                              : api->getSolutions(proto_request, request_timeout_);
   if (!expected) {
     logger_->logError(std::string{"Error querying the Inverse Kinematics service: "}.append(expected.error()));
-    response->response.status.value = bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_UNKNOWN;
+    setFailedResponse(response->response);
   } else {
+    if (cache) {
+      cache->insert(proto_request, expected.value());
+    }
     convertToRos(expected.value(), response->response);
   }
 }
+
+tl::expected<InverseKinematicsResponse, std::string> KinematicService::getCoalescedSolutions(
+    InverseKinematicsRequest& request) {
+  auto key = request.SerializeAsString();
+  std::promise<tl::expected<InverseKinematicsResponse, std::string>> promise;
+  std::shared_future<tl::expected<InverseKinematicsResponse, std::string>> in_flight;
+  {
+    std::lock_guard lock{in_flight_mutex_};
+    if (const auto it = in_flight_.find(key); it != in_flight_.end()) {
+      in_flight = it->second;
+    } else {
+      in_flight_.emplace(key, promise.get_future().share());
+    }
+  }
+  if (in_flight.valid()) {
+    return in_flight.get();
+  }
+
+  // Callers which attached to this request are released whether it succeeds, fails or throws.
+  try {
+    auto result = kinematic_api_->getSolutions(request, request_timeout_);
+    {
+      std::lock_guard lock{in_flight_mutex_};
+      in_flight_.erase(key);
+    }
+    promise.set_value(result);
+    return result;
+  } catch (...) {
+    {
+      std::lock_guard lock{in_flight_mutex_};
+      in_flight_.erase(key);
+    }
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+}
+
+void KinematicService::getBatchSolutions(const std::shared_ptr<GetInverseKinematicSolutionsBatch::Request> request,
+                                         std::shared_ptr<GetInverseKinematicSolutionsBatch::Response> response) {
+  response->responses.resize(request->requests.size());
+
+  auto* const api = selectApi(request->solver);
+  if (api == nullptr) {
+    logger_->logError("The requested inverse kinematics solver is not available.");
+    for (auto& failed : response->responses) {
+      setFailedResponse(failed);
+    }
+    return;
+  }
+  auto* const cache = api == kinematic_api_.get() ? cache_.get() : nullptr;
+
+  // Only the requests which are not cached are sent to Spot. pending_indices holds their index in the batch.
+  std::vector<bosdyn::api::spot::InverseKinematicsRequest> proto_requests;
+  std::vector<std::size_t> pending_indices;
+  proto_requests.reserve(request->requests.size());
+  pending_indices.reserve(request->requests.size());
+  for (std::size_t i = 0; i < request->requests.size(); ++i) {
+    bosdyn::api::spot::InverseKinematicsRequest proto_request;
+    convertToProto(request->requests[i], proto_request);
+    if (cache) {
+      if (const auto cached = cache->find(proto_request)) {
+        convertToRos(*cached, response->responses[i]);
+        continue;
+      }
+    }
+    proto_requests.push_back(std::move(proto_request));
+    pending_indices.push_back(i);
+  }
+  if (proto_requests.empty()) {
+    return;
+  }
+
+  const auto results = api->getBatchSolutions(proto_requests, kMaxRequestsInFlight, request_timeout_);
+  for (std::size_t j = 0; j < pending_indices.size(); ++j) {
+    const auto i = pending_indices[j];
+    if (j >= results.size() || !results[j]) {
+      logger_->logError(std::string{"Error querying the Inverse Kinematics service for request "} +
+                        std::to_string(i) + ": " + (j < results.size() ? results[j].error() : "no response"));
+      setFailedResponse(response->responses[i]);
+    } else {
+      if (cache) {
+        cache->insert(proto_requests[j], results[j].value());
+      }
+      convertToRos(results[j].value(), response->responses[i]);
+    }
+  }
+}
 }  // namespace spot_ros2::kinematic
@@ -0,0 +1,242 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/kinematic/local_kinematic_api.hpp>
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace spot_ros2::kinematic {
+namespace {
+using Vector6d = Eigen::Matrix<double, 6, 1>;
+using Matrix6d = Eigen::Matrix<double, 6, 6>;
+
+/** Name of every arm joint in the URDF, without the frame prefix, and in the responses of Spot. */
+constexpr std::array<std::pair<const char*, const char*>, kNumArmJoints> kArmJointNames{{
+    {"arm_sh0", "arm0.sh0"},
+    {"arm_sh1", "arm0.sh1"},
+    {"arm_el0", "arm0.el0"},
+    {"arm_el1", "arm0.el1"},
+    {"arm_wr0", "arm0.wr0"},
+    {"arm_wr1", "arm0.wr1"},
+}};
+constexpr auto kWristLink = "arm_link_wr1";
+constexpr auto kBodyFrame = "body";
+
+// Offset of the hand frame from the wrist, which is the tool of requests that do not set one.
+constexpr double kWristToHand = 0.19557;
+
+// The solver stops once the wrist is this close to the desired pose, or after this many iterations.
+constexpr double kPositionTolerance = 1e-4;
+constexpr double kRotationTolerance = 1e-3;
+constexpr int kMaxIterations = 100;
+// Damping of the least squares steps, which keeps them small near singular configurations.
+constexpr double kDamping = 0.05;
+// Largest error which is corrected in one step, so that far away poses are approached gradually.
+constexpr double kMaxPositionStep = 0.2;
+constexpr double kMaxRotationStep = 0.5;
+
+/** Arm configurations in front of the body, from which requests are retried if the warm start fails. */
+const std::array<Eigen::Matrix<double, kNumArmJoints, 1>, 4> kSeeds{
+    (Eigen::Matrix<double, kNumArmJoints, 1>() << 0.0, -1.0, 1.5, 0.0, -0.5, 0.0).finished(),
+    (Eigen::Matrix<double, kNumArmJoints, 1>() << 0.0, -2.0, 2.5, 0.0, -0.5, 0.0).finished(),
+    (Eigen::Matrix<double, kNumArmJoints, 1>() << 0.8, -1.0, 1.5, 0.0, -0.5, 0.0).finished(),
+    (Eigen::Matrix<double, kNumArmJoints, 1>() << -0.8, -1.0, 1.5, 0.0, -0.5, 0.0).finished(),
+};
+
+Eigen::Isometry3d toEigen(const ::bosdyn::api::SE3Pose& pose) {
+  Eigen::Isometry3d transform = Eigen::Isometry3d::Identity();
+  transform.translation() << pose.position().x(), pose.position().y(), pose.position().z();
+  // An unset rotation is the identity rather than the zero quaternion
+  if (pose.has_rotation()) {
+    const auto& rotation = pose.rotation();
+    const Eigen::Quaterniond quaternion{rotation.w(), rotation.x(), rotation.y(), rotation.z()};
+    if (quaternion.norm() > 0.0) {
+      transform.linear() = quaternion.normalized().toRotationMatrix();
+    }
+  }
+  return transform;
+}
+
+void toProto(const Eigen::Isometry3d& transform, ::bosdyn::api::SE3Pose& pose) {
+  const Eigen::Quaterniond quaternion{transform.linear()};
+  pose.mutable_position()->set_x(transform.translation().x());
+  pose.mutable_position()->set_y(transform.translation().y());
+  pose.mutable_position()->set_z(transform.translation().z());
+  pose.mutable_rotation()->set_w(quaternion.w());
+  pose.mutable_rotation()->set_x(quaternion.x());
+  pose.mutable_rotation()->set_y(quaternion.y());
+  pose.mutable_rotation()->set_z(quaternion.z());
+}
+
+/** Scale a vector down to a maximum norm. */
+void clampNorm(Eigen::Ref<Eigen::Vector3d> vector, double max_norm) {
+  if (const auto norm = vector.norm(); norm > max_norm) {
+    vector *= max_norm / norm;
+  }
+}
+}  // namespace
+
+tl::expected<std::unique_ptr<LocalKinematicApi>, std::string> LocalKinematicApi::create(
+    ForwardKinematics kinematics, const std::string& frame_prefix,
+    std::shared_ptr<ThreadPoolInterfaceBase> thread_pool) {
+  std::array<std::size_t, kNumArmJoints> arm_joints;
+  for (std::size_t i = 0; i < kNumArmJoints; ++i) {
+    const auto joint = kinematics.getJointIndex(frame_prefix + kArmJointNames[i].first);
+    if (!joint) {
+      return tl::make_unexpected("The URDF has no arm joint " + frame_prefix + kArmJointNames[i].first + ".");
+    }
+    arm_joints[i] = *joint;
+  }
+  const auto wrist_link = kinematics.getLinkIndex(frame_prefix + kWristLink);
+  if (!wrist_link) {
+    return tl::make_unexpected("The URDF has no wrist link " + frame_prefix + kWristLink + ".");
+  }
+  return std::unique_ptr<LocalKinematicApi>{
+      new LocalKinematicApi{std::move(kinematics), arm_joints, *wrist_link, std::move(thread_pool)}};
+}
+
+LocalKinematicApi::LocalKinematicApi(ForwardKinematics kinematics, std::array<std::size_t, kNumArmJoints> arm_joints,
+                                     std::size_t wrist_link, std::shared_ptr<ThreadPoolInterfaceBase> thread_pool)
+    : kinematics_{std::move(kinematics)},
+      arm_joints_{arm_joints},
+      wrist_link_{wrist_link},
+      thread_pool_{std::move(thread_pool)} {
+  for (std::size_t i = 0; i < kNumArmJoints; ++i) {
+    const auto joint = static_cast<Eigen::Index>(arm_joints_[i]);
+    lower_limits_[static_cast<Eigen::Index>(i)] = kinematics_.getLowerLimits()[joint];
+    upper_limits_[static_cast<Eigen::Index>(i)] = kinematics_.getUpperLimits()[joint];
+  }
+}
+
+tl::expected<InverseKinematicsResponse, std::string> LocalKinematicApi::getSolutions(
+    InverseKinematicsRequest& request, const std::chrono::duration<double> /*timeout*/) {
+  if (request.has_body_mounted_tool()) {
+    return tl::make_unexpected("The local solver only supports wrist mounted tools.");
+  }
+  if (!request.has_tool_pose_task()) {
+    return tl::make_unexpected("The local solver only supports tool pose tasks.");
+  }
+
+  // The body stays where the request would like it to be, and the arm moves the tool to the task
+  const Eigen::Isometry3d scene_tform_body = request.has_scene_tform_body_nominal()
+                                                 ? toEigen(request.scene_tform_body_nominal())
+                                                 : Eigen::Isometry3d::Identity();
+  Eigen::Isometry3d wrist_tform_tool = Eigen::Isometry3d::Identity();
+  if (request.has_wrist_mounted_tool() && request.wrist_mounted_tool().has_wrist_tform_tool()) {
+    wrist_tform_tool = toEigen(request.wrist_mounted_tool().wrist_tform_tool());
+  } else {
+    wrist_tform_tool.translation().x() = kWristToHand;
+  }
+  const Eigen::Isometry3d body_tform_wrist = scene_tform_body.inverse() * toEigen(request.scene_tform_task()) *
+                                             toEigen(request.tool_pose_task().task_tform_desired_tool()) *
+                                             wrist_tform_tool.inverse();
+
+  std::vector<ArmPositions> seeds;
+  seeds.reserve(kSeeds.size() + 1);
+  {
+    std::lock_guard lock{last_solution_mutex_};
+    if (last_solution_) {
+      seeds.push_back(*last_solution_);
+    }
+  }
+  if (request.has_nominal_arm_configuration_overrides()) {
+    // The overrides replace the warm start, and joints which they do not set keep its position
+    const auto& overrides = request.nominal_arm_configuration_overrides();
+    ArmPositions seed = seeds.empty() ? kSeeds.front() : seeds.front();
+    const std::array<const ::google::protobuf::DoubleValue*, kNumArmJoints> values{
+        overrides.has_sh0() ? &overrides.sh0() : nullptr, overrides.has_sh1() ? &overrides.sh1() : nullptr,
+        overrides.has_el0() ? &overrides.el0() : nullptr, overrides.has_el1() ? &overrides.el1() : nullptr,
+        overrides.has_wr0() ? &overrides.wr0() : nullptr, overrides.has_wr1() ? &overrides.wr1() : nullptr};
+    for (std::size_t i = 0; i < kNumArmJoints; ++i) {
+      if (values[i] != nullptr) {
+        seed[static_cast<Eigen::Index>(i)] = values[i]->value();
+      }
+    }
+    seeds.clear();
+    seeds.push_back(seed);
+  }
+  seeds.insert(seeds.end(), kSeeds.cbegin(), kSeeds.cend());
+
+  InverseKinematicsResponse response;
+  for (const auto& seed : seeds) {
+    const auto solution = solve(body_tform_wrist, seed);
+    if (!solution) {
+      continue;
+    }
+    {
+      std::lock_guard lock{last_solution_mutex_};
+      last_solution_ = solution;
+    }
+
+    response.set_status(bosdyn::api::spot::InverseKinematicsResponse::STATUS_OK);
+    auto& configuration = *response.mutable_robot_configuration();
+    for (std::size_t i = 0; i < kNumArmJoints; ++i) {
+      auto& joint_state = *configuration.add_joint_states();
+      joint_state.set_name(kArmJointNames[i].second);
+      joint_state.mutable_position()->set_value((*solution)[static_cast<Eigen::Index>(i)]);
+    }
+    auto& edges = *configuration.mutable_transforms_snapshot()->mutable_child_to_parent_edge_map();
+    toProto(Eigen::Isometry3d::Identity(), *edges[kBodyFrame].mutable_parent_tform_child());
+    if (!request.root_frame_name().empty()) {
+      auto& root_edge = edges[request.root_frame_name()];
+      root_edge.set_parent_frame_name(kBodyFrame);
+      const Eigen::Isometry3d root_tform_body = toEigen(request.root_tform_scene()) * scene_tform_body;
+      toProto(root_tform_body.inverse(), *root_edge.mutable_parent_tform_child());
+    }
+    return response;
+  }
+  response.set_status(bosdyn::api::spot::InverseKinematicsResponse::STATUS_NO_SOLUTION_FOUND);
+  return response;
+}
+
+std::vector<tl::expected<InverseKinematicsResponse, std::string>> LocalKinematicApi::getBatchSolutions(
+    std::vector<InverseKinematicsRequest>& requests, const std::size_t max_requests_in_flight,
+    const std::chrono::duration<double> timeout) {
+  std::vector<tl::expected<InverseKinematicsResponse, std::string>> responses(requests.size());
+  // Every job only writes the response of its own request
+  thread_pool_->parallelFor(requests.size(), max_requests_in_flight, [&](const std::size_t request) {
+    responses[request] = getSolutions(requests[request], timeout);
+  });
+  return responses;
+}
+
+std::optional<LocalKinematicApi::ArmPositions> LocalKinematicApi::solve(const Eigen::Isometry3d& body_tform_wrist,
+                                                                        const ArmPositions& seed) const {
+  // Joints other than those of the arm, such as those of the legs, do not move the wrist and stay at zero
+  JointPositions positions = JointPositions::Zero(static_cast<Eigen::Index>(kinematics_.getJointNames().size()));
+  ArmPositions arm = seed.cwiseMax(lower_limits_).cwiseMin(upper_limits_);
+  std::vector<Eigen::Isometry3d> root_tform_links;
+  Jacobian jacobian;
+  Matrix6d arm_jacobian;
+  for (int iteration = 0; iteration < kMaxIterations; ++iteration) {
+    for (std::size_t i = 0; i < kNumArmJoints; ++i) {
+      positions[static_cast<Eigen::Index>(arm_joints_[i])] = arm[static_cast<Eigen::Index>(i)];
+    }
+    kinematics_.computeLinkPoses(positions, root_tform_links);
+    const auto& root_tform_wrist = root_tform_links[wrist_link_];
+
+    Vector6d error;
+    error.head<3>() = body_tform_wrist.translation() - root_tform_wrist.translation();
+    const Eigen::AngleAxisd rotation_error{body_tform_wrist.linear() * root_tform_wrist.linear().transpose()};
+    error.tail<3>() = rotation_error.angle() * rotation_error.axis();
+    if (error.head<3>().norm() < kPositionTolerance && error.tail<3>().norm() < kRotationTolerance) {
+      return arm;
+    }
+    clampNorm(error.head<3>(), kMaxPositionStep);
+    clampNorm(error.tail<3>(), kMaxRotationStep);
+
+    kinematics_.computeJacobian(root_tform_links, wrist_link_, jacobian);
+    for (std::size_t i = 0; i < kNumArmJoints; ++i) {
+      arm_jacobian.col(static_cast<Eigen::Index>(i)) = jacobian.col(static_cast<Eigen::Index>(arm_joints_[i]));
+    }
+    const Matrix6d damped = arm_jacobian * arm_jacobian.transpose() + kDamping * kDamping * Matrix6d::Identity();
+    arm += arm_jacobian.transpose() * damped.ldlt().solve(error);
+    arm = arm.cwiseMax(lower_limits_).cwiseMin(upper_limits_);
+  }
+  return std::nullopt;
+}
+}  // namespace spot_ros2::kinematic
@@ -0,0 +1,24 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/metrics/metrics_middleware_handle.hpp>
+
+#include <rclcpp/qos.hpp>
+
+namespace {
+constexpr auto kDiagnosticsTopic = "/diagnostics";
+constexpr auto kDiagnosticsHistoryDepth = 1;
+}  // namespace
+
+namespace spot_ros2::metrics {
+
+MetricsMiddlewareHandle::MetricsMiddlewareHandle(const std::shared_ptr<rclcpp::Node>& node)
+    : node_{node},
+      diagnostics_publisher_{node_->create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+          kDiagnosticsTopic, rclcpp::QoS(rclcpp::KeepLast(kDiagnosticsHistoryDepth)))} {}
+
+void MetricsMiddlewareHandle::publishDiagnostics(const diagnostic_msgs::msg::DiagnosticArray& diagnostics) {
+  auto message = diagnostics;
+  message.header.stamp = node_->now();
+  diagnostics_publisher_->publish(message);
+}
+}  // namespace spot_ros2::metrics
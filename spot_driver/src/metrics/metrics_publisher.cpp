@@ -0,0 +1,68 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/metrics/metrics_publisher.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+namespace spot_ros2::metrics {
+
+MetricsPublisher::MetricsPublisher(const std::shared_ptr<const MetricsRegistry>& registry,
+                                   const std::vector<std::string>& groups, const std::string& name_prefix,
+                                   const Options& options, std::unique_ptr<MiddlewareHandle> middleware_handle,
+                                   std::unique_ptr<LoggerInterfaceBase> logger_interface,
+                                   std::unique_ptr<TimerInterfaceBase> timer_interface)
+    : registry_{registry},
+      groups_{groups},
+      name_prefix_{name_prefix},
+      options_{options},
+      middleware_handle_{std::move(middleware_handle)},
+      logger_interface_{std::move(logger_interface)},
+      timer_interface_{std::move(timer_interface)} {
+  if (options_.period.count() > 0.0) {
+    timer_interface_->setTimer(options_.period, [this] {
+      timerCallback();
+    });
+  }
+}
+
+void MetricsPublisher::timerCallback() {
+  diagnostic_msgs::msg::DiagnosticArray diagnostics;
+  diagnostics.status = registry_->toDiagnosticStatus(name_prefix_, groups_);
+  if (!diagnostics.status.empty()) {
+    middleware_handle_->publishDiagnostics(diagnostics);
+  }
+  if (!options_.textfile.empty()) {
+    writeTextfile();
+  }
+}
+
+void MetricsPublisher::writeTextfile() {
+  const auto temporary = options_.textfile + ".tmp";
+  {
+    std::ofstream file{temporary, std::ios::trunc};
+    file << registry_->toPrometheusText(options_.labels, groups_);
+    if (!file) {
+      // An unwritable textfile stays unwritable, so it is only logged once.
+      logger_interface_->logOnce(LogLevel::kError, "metrics_textfile",
+                                 "Failed to write the metrics textfile " + temporary);
+      return;
+    }
+  }
+  if (std::rename(temporary.c_str(), options_.textfile.c_str()) != 0) {
+    logger_interface_->logOnce(LogLevel::kError, "metrics_textfile",
+                               "Failed to replace the metrics textfile " + options_.textfile);
+  }
+}
+
+MetricsPublisher::Options makeMetricsPublisherOptions(const ParameterInterfaceBase& parameters) {
+  MetricsPublisher::Options options;
+  options.period = std::chrono::duration<double>{parameters.getMetricsPublishPeriod()};
+  options.textfile = parameters.getMetricsTextfile();
+  if (const auto spot_name = parameters.getSpotName(); !spot_name.empty()) {
+    options.labels.emplace("robot", spot_name);
+  }
+  return options;
+}
+}  // namespace spot_ros2::metrics
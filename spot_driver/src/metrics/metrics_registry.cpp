@@ -0,0 +1,221 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/metrics/metrics_registry.hpp>
+
+#include <diagnostic_msgs/msg/key_value.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <sstream>
+#include <utility>
+
+namespace {
+constexpr auto kPrometheusNamespace = "spot_driver_";
+constexpr double kNanosecondsPerSecond = 1e9;
+
+/** @brief Get the group of a metric, which is the part of its name before the first dot. */
+std::string groupOf(const std::string& name) {
+  return name.substr(0, name.find('.'));
+}
+
+bool isSelected(const std::string& name, const std::vector<std::string>& groups) {
+  return groups.empty() || std::find(groups.cbegin(), groups.cend(), groupOf(name)) != groups.cend();
+}
+
+/** @brief Convert a dot-separated metric name into a Prometheus metric name. */
+std::string toPrometheusName(const std::string& name, const std::string& suffix) {
+  std::string result = kPrometheusNamespace;
+  for (const auto character : name) {
+    result.push_back(std::isalnum(static_cast<unsigned char>(character)) ? character : '_');
+  }
+  return result.append(suffix);
+}
+
+/** @brief Format the labels of a sample, with an optional extra label such as the bucket edge of a histogram. */
+std::string toPrometheusLabels(const std::map<std::string, std::string>& labels, const std::string& extra = "") {
+  std::string result;
+  for (const auto& [key, value] : labels) {
+    result.append(result.empty() ? "" : ",").append(key).append("=\"");
+    for (const auto character : value) {
+      if (character == '\\' || character == '"') {
+        result.push_back('\\');
+      }
+      result.push_back(character == '\n' ? ' ' : character);
+    }
+    result.push_back('"');
+  }
+  if (!extra.empty()) {
+    result.append(result.empty() ? "" : ",").append(extra);
+  }
+  return result.empty() ? result : "{" + result + "}";
+}
+
+void addValue(const std::string& key, const std::string& value, diagnostic_msgs::msg::DiagnosticStatus& status) {
+  status.values.push_back(diagnostic_msgs::build<diagnostic_msgs::msg::KeyValue>().key(key).value(value));
+}
+
+std::string toMilliseconds(const double seconds) {
+  std::ostringstream value;
+  value.precision(3);
+  value << std::fixed << seconds * 1e3;
+  return value.str();
+}
+}  // namespace
+
+namespace spot_ros2::metrics {
+
+double Histogram::Snapshot::percentile(const double fraction) const {
+  if (count == 0) {
+    return 0.0;
+  }
+  const auto rank = std::max<std::uint64_t>(
+      static_cast<std::uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(count))), 1);
+  std::uint64_t cumulative = 0;
+  for (std::size_t bucket = 0; bucket < kBucketEdges.size(); ++bucket) {
+    cumulative += buckets[bucket];
+    if (cumulative >= rank) {
+      // The bucket edge is an upper bound, but the maximum is tighter if every duration is below the edge.
+      return std::min(kBucketEdges[bucket], max);
+    }
+  }
+  return max;
+}
+
+void Histogram::record(const std::chrono::steady_clock::duration duration) {
+  const auto nanoseconds = std::max<std::int64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), 0);
+  const auto seconds = static_cast<double>(nanoseconds) / kNanosecondsPerSecond;
+  const auto bucket = std::lower_bound(kBucketEdges.cbegin(), kBucketEdges.cend(), seconds) - kBucketEdges.cbegin();
+  buckets_[static_cast<std::size_t>(bucket)].fetch_add(1, std::memory_order_relaxed);
+  sum_ns_.fetch_add(static_cast<std::uint64_t>(nanoseconds), std::memory_order_relaxed);
+  auto max = max_ns_.load(std::memory_order_relaxed);
+  while (static_cast<std::uint64_t>(nanoseconds) > max &&
+         !max_ns_.compare_exchange_weak(max, static_cast<std::uint64_t>(nanoseconds), std::memory_order_relaxed)) {
+  }
+}
+
+void Histogram::record(const double seconds) {
+  record(std::chrono::round<std::chrono::steady_clock::duration>(std::chrono::duration<double>{seconds}));
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+  Snapshot snapshot;
+  for (std::size_t bucket = 0; bucket < buckets_.size(); ++bucket) {
+    snapshot.buckets[bucket] = buckets_[bucket].load(std::memory_order_relaxed);
+    snapshot.count += snapshot.buckets[bucket];
+  }
+  // The count is summed from the buckets, so that the percentiles of the snapshot are consistent with its count.
+  snapshot.sum = static_cast<double>(sum_ns_.load(std::memory_order_relaxed)) / kNanosecondsPerSecond;
+  snapshot.max = static_cast<double>(max_ns_.load(std::memory_order_relaxed)) / kNanosecondsPerSecond;
+  return snapshot;
+}
+
+std::shared_ptr<MetricsRegistry> MetricsRegistry::getDefault() {
+  static const auto registry = std::make_shared<MetricsRegistry>();
+  return registry;
+}
+
+std::shared_ptr<MetricsRegistry> MetricsRegistry::getForRobot(const std::string& robot_name) {
+  if (robot_name.empty()) {
+    return getDefault();
+  }
+  static std::mutex mutex;
+  static std::map<std::string, std::shared_ptr<MetricsRegistry>> registries;
+  std::lock_guard<std::mutex> lock{mutex};
+  auto& registry = registries[robot_name];
+  if (!registry) {
+    registry = std::make_shared<MetricsRegistry>();
+  }
+  return registry;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto& counter = counters_[name];
+  if (!counter) {
+    counter = std::make_unique<Counter>();
+  }
+  return *counter;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto& histogram = histograms_[name];
+  if (!histogram) {
+    histogram = std::make_unique<Histogram>();
+  }
+  return *histogram;
+}
+
+std::vector<diagnostic_msgs::msg::DiagnosticStatus> MetricsRegistry::toDiagnosticStatus(
+    const std::string& name_prefix, const std::vector<std::string>& groups) const {
+  std::map<std::string, diagnostic_msgs::msg::DiagnosticStatus> statuses;
+  const auto status_of = [&statuses, &name_prefix](const std::string& name) -> diagnostic_msgs::msg::DiagnosticStatus& {
+    auto& status = statuses[groupOf(name)];
+    if (status.name.empty()) {
+      status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+      status.name = name_prefix + groupOf(name);
+      status.message = "Driver metrics";
+    }
+    return status;
+  };
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  for (const auto& [name, counter] : counters_) {
+    if (isSelected(name, groups)) {
+      addValue(name, std::to_string(counter->value()), status_of(name));
+    }
+  }
+  for (const auto& [name, histogram] : histograms_) {
+    if (isSelected(name, groups)) {
+      const auto snapshot = histogram->snapshot();
+      auto& status = status_of(name);
+      addValue(name + " count", std::to_string(snapshot.count), status);
+      addValue(name + " mean (ms)", toMilliseconds(snapshot.mean()), status);
+      addValue(name + " p50 (ms)", toMilliseconds(snapshot.percentile(0.5)), status);
+      addValue(name + " p95 (ms)", toMilliseconds(snapshot.percentile(0.95)), status);
+      addValue(name + " max (ms)", toMilliseconds(snapshot.max), status);
+    }
+  }
+
+  std::vector<diagnostic_msgs::msg::DiagnosticStatus> result;
+  result.reserve(statuses.size());
+  for (auto& [group, status] : statuses) {
+    result.push_back(std::move(status));
+  }
+  return result;
+}
+
+std::string MetricsRegistry::toPrometheusText(const std::map<std::string, std::string>& labels,
+                                              const std::vector<std::string>& groups) const {
+  const auto plain_labels = toPrometheusLabels(labels);
+  std::ostringstream text;
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  for (const auto& [name, counter] : counters_) {
+    if (isSelected(name, groups)) {
+      const auto metric = toPrometheusName(name, "_total");
+      text << "# TYPE " << metric << " counter\n" << metric << plain_labels << " " << counter->value() << "\n";
+    }
+  }
+  for (const auto& [name, histogram] : histograms_) {
+    if (isSelected(name, groups)) {
+      const auto snapshot = histogram->snapshot();
+      const auto metric = toPrometheusName(name, "_seconds");
+      text << "# TYPE " << metric << " histogram\n";
+      std::uint64_t cumulative = 0;
+      for (std::size_t bucket = 0; bucket < Histogram::kBucketEdges.size(); ++bucket) {
+        cumulative += snapshot.buckets[bucket];
+        std::ostringstream edge;
+        edge << "le=\"" << Histogram::kBucketEdges[bucket] << "\"";
+        text << metric << "_bucket" << toPrometheusLabels(labels, edge.str()) << " " << cumulative << "\n";
+      }
+      text << metric << "_bucket" << toPrometheusLabels(labels, "le=\"+Inf\"") << " " << snapshot.count << "\n";
+      text << metric << "_sum" << plain_labels << " " << snapshot.sum << "\n";
+      text << metric << "_count" << plain_labels << " " << snapshot.count << "\n";
+    }
+  }
+  return text.str();
+}
+}  // namespace spot_ros2::metrics
@@ -4,13 +4,17 @@
 
 #include <bosdyn/api/world_object.pb.h>
 #include <bosdyn/math/frame_helpers.h>
+#include <eigen3/Eigen/Geometry>
 #include <google/protobuf/timestamp.pb.h>
 #include <rcl/time.h>
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <geometry_msgs/msg/detail/transform_stamped__struct.hpp>
+#include <geometry_msgs/msg/transform.hpp>
 #include <iterator>
+#include <optional>
 #include <rclcpp/duration.hpp>
 #include <rclcpp/time.hpp>
 #include <spot_driver/api/state_client_interface.hpp>
@@ -23,13 +27,32 @@
 #include <std_msgs/msg/header.hpp>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tl_expected/expected.hpp>
 #include <utility>
+#include <vector>
 
 namespace {
 constexpr auto kWorldObjectSyncPeriod = std::chrono::duration<double>{1.0};  // 1 Hz
 constexpr auto kTfBroadcasterPeriod = std::chrono::duration<double>{0.1};    // 10 Hz
+// Failures of the timer callbacks repeat every period while the robot is unreachable, so they are logged at most once
+// per this period.
+constexpr auto kFailureLogPeriod = std::chrono::seconds{5};
+// Maximum number of world object mutations which are outstanding with Spot at the same time during a sync.
+constexpr std::size_t kMaxMutationsInFlight = 8;
+// Number of incremental lists of world objects between two full lists, so the TF data of objects which did not change
+// is still republished every few seconds for late-joining listeners.
+constexpr std::size_t kIncrementalListsPerFullList = 49;
 inline const rclcpp::Duration kStaleTransformDuration{10, 0};
+// Time after which the interpolated pose of a world object is no longer published if the object was not listed again.
+// Every object is listed by the full lists, which happen every few seconds.
+inline const rclcpp::Duration kObjectPoseLifetime{10, 0};
+// Time after which the cached lists of world objects are listed again in full, to drop objects which were removed.
+// In between, only the objects updated since the last sync are listed.
+inline const rclcpp::Duration kObjectCacheLifetime{10, 0};
+// Time after which a TF frame is sent to Spot again even if it did not move, so that its world object, which expires
+// after kMutableObjectLifetime, is kept alive.
+inline const rclcpp::Duration kSentTransformRefreshPeriod{3, 0};
 
 constexpr double kMutableObjectLifetime = 5.0;
 constexpr double kDrawableArrowLength = 0.1;
@@ -98,24 +121,21 @@ inline const std::set<std::string, std::less<>> kSpotInternalFrames{
 
 /**
  * @brief Given an input string and a prefix string which is a substring starting at the beginning of the input string,
- * return a new string which is the difference between the input string and the prefix string.
+ * return a view of the input string without the prefix.
+ * @details The returned view refers to the input string, so that checking the frames of the TF tree on every sync does
+ * not allocate a new string for each frame.
  * @param input
  * @param prefix
- * @return A new string which is the difference between the input string and the prefix string.
+ * @return A view of the difference between the input string and the prefix string, or of the unmodified input if it
+ * does not begin with the prefix.
  */
-std::string stripPrefix(const std::string& input, const std::string& prefix) {
-  const std::size_t prefix_index = input.find(prefix);
-  if (prefix_index == std::string::npos) {
-    // The input does not contain the prefix
+std::string_view stripPrefix(std::string_view input, std::string_view prefix) {
+  if (input.substr(0, prefix.size()) != prefix) {
+    // The input does not begin with the prefix
     return input;
   }
-  if (prefix_index > 0) {
-    // The input does contain the prefix substring, but it does not begin at the start of the input.
-    // Return the unmodified input.
-    return input;
-  }
-
-  return input.substr(prefix.size());
+  input.remove_prefix(prefix.size());
+  return input;
 }
 
 /**
@@ -186,6 +206,52 @@ std::string toString(const ::bosdyn::api::MutateWorldObjectResponse_Status& stat
   return request;
 }
 
+/**
+ * @brief Check whether one protobuf timestamp is later than another.
+ * @param lhs
+ * @param rhs
+ * @return True if lhs is later than rhs.
+ */
+bool isLater(const google::protobuf::Timestamp& lhs, const google::protobuf::Timestamp& rhs) {
+  return lhs.seconds() > rhs.seconds() || (lhs.seconds() == rhs.seconds() && lhs.nanos() > rhs.nanos());
+}
+
+/**
+ * @brief Check whether a transform moved by more than the given thresholds.
+ * @param previous The transform before.
+ * @param current The transform now.
+ * @param translation_threshold Distance in meters that the translation must exceed.
+ * @param rotation_threshold Angle in radians that the rotation must exceed.
+ * @return True if the translation or the rotation changed by more than its threshold.
+ */
+bool hasMoved(const geometry_msgs::msg::Transform& previous, const geometry_msgs::msg::Transform& current,
+              const double translation_threshold, const double rotation_threshold) {
+  const double dx = current.translation.x - previous.translation.x;
+  const double dy = current.translation.y - previous.translation.y;
+  const double dz = current.translation.z - previous.translation.z;
+  if (std::sqrt(dx * dx + dy * dy + dz * dz) > translation_threshold) {
+    return true;
+  }
+  const auto& q0 = previous.rotation;
+  const auto& q1 = current.rotation;
+  const double dot = std::abs(q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w);
+  return 2.0 * std::acos(std::min(dot, 1.0)) > rotation_threshold;
+}
+
+/**
+ * @brief Update a timestamp to the latest acquisition time of the objects in a ListWorldObjectResponse message.
+ * @param list_objects_response Input message to parse.
+ * @param latest_time Timestamp to update.
+ */
+void updateLatestObjectTime(const ::bosdyn::api::ListWorldObjectResponse& list_objects_response,
+                            std::optional<google::protobuf::Timestamp>& latest_time) {
+  for (const auto& object : list_objects_response.world_objects()) {
+    if (!latest_time || isLater(object.acquisition_time(), *latest_time)) {
+      latest_time = object.acquisition_time();
+    }
+  }
+}
+
 /**
  * @brief Given a ListWorldObjectResponse message, create a list of all the frames listed in the transform snapshots
  * those objects.
@@ -307,6 +373,35 @@ std::map<std::string, int> getObjectNamesAndIDs(const ::bosdyn::api::ListWorldOb
       ::bosdyn::api::MutateWorldObjectRequest_Action::MutateWorldObjectRequest_Action_ACTION_CHANGE);
   return request;
 }
+
+/**
+ * @brief Interpolate between two transforms between the same frames.
+ *
+ * @param from Transform at t = 0.
+ * @param to Transform at t = 1, whose header is copied to the result.
+ * @param t Interpolation parameter between 0 and 1.
+ * @param stamp Time stamp of the result.
+ * @param result Interpolated transform.
+ */
+void interpolateTransform(const geometry_msgs::msg::TransformStamped& from,
+                          const geometry_msgs::msg::TransformStamped& to, const double t, const rclcpp::Time& stamp,
+                          geometry_msgs::msg::TransformStamped& result) {
+  result.header.frame_id = to.header.frame_id;
+  result.header.stamp = stamp;
+  result.child_frame_id = to.child_frame_id;
+  const auto& a = from.transform;
+  const auto& b = to.transform;
+  result.transform.translation.x = a.translation.x + (b.translation.x - a.translation.x) * t;
+  result.transform.translation.y = a.translation.y + (b.translation.y - a.translation.y) * t;
+  result.transform.translation.z = a.translation.z + (b.translation.z - a.translation.z) * t;
+  const Eigen::Quaterniond qa{a.rotation.w, a.rotation.x, a.rotation.y, a.rotation.z};
+  const Eigen::Quaterniond qb{b.rotation.w, b.rotation.x, b.rotation.y, b.rotation.z};
+  const auto q = qa.slerp(t, qb);
+  result.transform.rotation.w = q.w();
+  result.transform.rotation.x = q.x();
+  result.transform.rotation.y = q.y();
+  result.transform.rotation.z = q.z();
+}
 }  // namespace
 
 namespace spot_ros2 {
@@ -332,73 +427,93 @@ ObjectSynchronizer::ObjectSynchronizer(const std::shared_ptr<WorldObjectClientIn
   const auto spot_name = parameter_interface_->getSpotName();
   frame_prefix_ = spot_name.empty() ? "" : spot_name + "/";
 
-  preferred_base_frame_ = stripPrefix(parameter_interface_->getTFRoot(), frame_prefix_);
+  preferred_base_frame_ = std::string{stripPrefix(parameter_interface_->getTFRoot(), frame_prefix_)};
   preferred_base_frame_with_prefix_ = preferred_base_frame_.find('/') == std::string::npos
                                           ? frame_prefix_ + preferred_base_frame_
                                           : preferred_base_frame_;
+  translation_threshold_ = parameter_interface_->getObjectSyncTranslationThreshold();
+  rotation_threshold_ = parameter_interface_->getObjectSyncRotationThreshold();
+  request_timeout_ = std::chrono::duration<double>{parameter_interface_->getWorldObjectRequestTimeout()};
 
   // TODO(khughes): This is temporarily disabled to reduce driver's spew about TF extrapolation.
   // world_object_update_timer_->setTimer(kWorldObjectSyncPeriod, [this]() {
   //   syncWorldObjects();
   // });
 
-  tf_broadcaster_timer_->setTimer(kTfBroadcasterPeriod, [this]() {
+  // Above the rate of the lists, the objects are still listed at about that rate, and the broadcasts in between
+  // publish their interpolated poses.
+  auto tf_broadcaster_period = kTfBroadcasterPeriod;
+  const auto world_object_tf_rate = parameter_interface_->getObjectSyncWorldObjectTfRate();
+  if (world_object_tf_rate * kTfBroadcasterPeriod.count() > 1.0) {
+    tf_broadcaster_period = std::chrono::duration<double>{1.0 / world_object_tf_rate};
+    broadcasts_per_list_ = static_cast<std::size_t>(std::lround(world_object_tf_rate * kTfBroadcasterPeriod.count()));
+    blend_duration_ = rclcpp::Duration::from_seconds(static_cast<double>(broadcasts_per_list_) / world_object_tf_rate);
+  }
+
+  tf_broadcaster_timer_->setTimer(tf_broadcaster_period, [this]() {
     broadcastWorldObjectTransforms();
   });
 }
 
 void ObjectSynchronizer::addManagedFrame(const std::string& frame_id) {
   std::lock_guard lock{managed_frames_mutex_};
-  managed_frames_.insert(frame_id);
+  if (managed_frames_->count(frame_id) > 0) {
+    return;
+  }
+  // Readers keep using the previous snapshot, so the set is copied and replaced instead of modified in place.
+  auto managed_frames = std::make_shared<std::set<std::string, std::less<>>>(*managed_frames_);
+  managed_frames->insert(frame_id);
+  managed_frames_ = std::move(managed_frames);
 }
 
-std::set<std::string, std::less<>> ObjectSynchronizer::getManagedFrames() const {
+std::shared_ptr<const std::set<std::string, std::less<>>> ObjectSynchronizer::getManagedFramesSnapshot() const {
   std::lock_guard lock{managed_frames_mutex_};
   return managed_frames_;
 }
 
+std::set<std::string, std::less<>> ObjectSynchronizer::getManagedFrames() const {
+  return *getManagedFramesSnapshot();
+}
+
 void ObjectSynchronizer::syncWorldObjects() {
   if (!world_object_client_interface_) {
-    logger_interface_->logError("World object interface not initialized.");
+    logger_interface_->logOnce(LogLevel::kError, "world_object_interface", "World object interface not initialized.");
     return;
   }
 
   // Get the current timestamp at which this function was triggered
   const auto timepoint_now = clock_interface_->now();
 
-  // Get a list of all world objects which are managed by Spot itself or through other Spot operator tools.
-  // The TF tree may contain frames from these objects, and we should not attempt to modify these objects. The Spot API
-  // allows us to attempt to modify them but it will fail if we try
-  ::bosdyn::api::ListWorldObjectRequest request_non_mutable_objects = createNonMutableObjectsRequest();
-  const auto non_mutable_objects_response =
-      world_object_client_interface_->listWorldObjects(request_non_mutable_objects);
-  if (!non_mutable_objects_response) {
-    logger_interface_->logError("Failed to list non-mutable objects: " + non_mutable_objects_response.error());
+  if (!updateObjectCaches(timepoint_now)) {
     return;
   }
-  const auto non_mutable_frames_unfiltered = getObjectFrames(non_mutable_objects_response.value());
-  std::set<std::string> non_mutable_frames;
-  std::set_difference(non_mutable_frames_unfiltered.cbegin(), non_mutable_frames_unfiltered.cend(),
-                      kSpotInternalFrames.cbegin(), kSpotInternalFrames.cend(),
-                      std::inserter(non_mutable_frames, non_mutable_frames.end()));
-
-  // Get the names and IDs of all existing world objects that ObjectSynchronizer can add or modify.
-  ::bosdyn::api::ListWorldObjectRequest request_mutable_frames = createMutableObjectsRequest();
-  const auto mutable_frames_response = world_object_client_interface_->listWorldObjects(request_mutable_frames);
-  if (!mutable_frames_response) {
-    logger_interface_->logError("Failed to list mutable objects: " + mutable_frames_response.error());
-    return;
-  }
-  const auto mutable_object_names_and_ids = getObjectNamesAndIDs(mutable_frames_response.value());
+  const auto& non_mutable_frames = non_mutable_frames_;
+  const auto& mutable_object_names_and_ids = mutable_object_ids_;
 
   const auto clock_skew_result = time_sync_interface_->getClockSkew();
   if (!clock_skew_result) {
-    logger_interface_->logError(std::string{"Failed to get latest clock skew: "}.append(clock_skew_result.error()));
+    logger_interface_->logThrottled(LogLevel::kError, "get_clock_skew", kFailureLogPeriod,
+                                    std::string{"Failed to get latest clock skew: "}.append(clock_skew_result.error()));
     return;
   }
 
-  // Get a list of all frame IDs in the TF tree
-  for (const auto& child_frame_id : tf_listener_interface_->getAllFrameNames()) {
+  // Mutations are collected for all frames first, and then sent concurrently.
+  std::vector<::bosdyn::api::MutateWorldObjectRequest> requests;
+  std::vector<std::string> request_frame_ids;
+  std::vector<std::string> request_object_names;
+  std::vector<geometry_msgs::msg::Transform> request_transforms;
+
+  // Only the frames which were updated since the last sync are new to the list of recently updated frames. Frames
+  // which were not updated for longer than transforms are considered fresh are dropped from it, since their
+  // transforms would be skipped as stale.
+  for (auto& frame_id : tf_listener_interface_->getUpdatedFrameNames(tf_generation_)) {
+    updated_frames_.insert_or_assign(std::move(frame_id), timepoint_now);
+  }
+  for (auto it = updated_frames_.begin(); it != updated_frames_.end();) {
+    it = timepoint_now - it->second > kStaleTransformDuration ? updated_frames_.erase(it) : std::next(it);
+  }
+
+  for (const auto& [child_frame_id, update_time] : updated_frames_) {
     const auto child_frame_id_no_prefix = stripPrefix(child_frame_id, frame_prefix_);
 
     // Skip frames which are internal to Spot or which are from objects which we cannot mutate
@@ -413,7 +528,7 @@ void ObjectSynchronizer::syncWorldObjects() {
     const auto base_tform_child =
         tf_listener_interface_->lookupTransform(preferred_base_frame_with_prefix_, child_frame_id, rclcpp::Time{0, 0});
     if (!base_tform_child) {
-      logger_interface_->logWarn(base_tform_child.error());
+      logger_interface_->logThrottled(LogLevel::kWarn, "lookup_transform", kFailureLogPeriod, base_tform_child.error());
       continue;
     }
 
@@ -426,8 +541,18 @@ void ObjectSynchronizer::syncWorldObjects() {
         continue;
       }
     } catch (const std::runtime_error& e) {
-      logger_interface_->logWarn("Time source for timestamp of transform from `" + base_tform_child->header.frame_id +
-                                 "` to `" + base_tform_child->child_frame_id + "` is not RCL_ROS_TIME.");
+      logger_interface_->logThrottled(LogLevel::kWarn, "transform_time_source", kFailureLogPeriod,
+                                      "Time source for timestamp of transform from `" +
+                                          base_tform_child->header.frame_id + "` to `" +
+                                          base_tform_child->child_frame_id + "` is not RCL_ROS_TIME.");
+      continue;
+    }
+
+    // Skip frames which did not move since they were last sent, as long as their world object does not expire.
+    if (const auto sent = sent_transforms_.find(child_frame_id);
+        sent != sent_transforms_.end() && mutable_object_names_and_ids.count(child_frame_id_no_prefix) > 0 &&
+        timepoint_now - sent->second.time < kSentTransformRefreshPeriod &&
+        !hasMoved(sent->second.transform, base_tform_child->transform, translation_threshold_, rotation_threshold_)) {
       continue;
     }
 
@@ -444,76 +569,218 @@ void ObjectSynchronizer::syncWorldObjects() {
     ::bosdyn::api::MutateWorldObjectRequest request;
     if (mutable_object_names_and_ids.count(child_frame_id_no_prefix) > 0) {
       // Modifying a previously-added object requires specifying the ID of the object in the mutation request.
-      const auto id = mutable_object_names_and_ids.at(child_frame_id_no_prefix);
-      request = createModifyObjectRequest(base_tform_child->transform, preferred_base_frame_, child_frame_id_no_prefix,
+      const auto id = mutable_object_names_and_ids.find(child_frame_id_no_prefix)->second;
+      request = createModifyObjectRequest(base_tform_child->transform, preferred_base_frame_,
+                                          std::string{child_frame_id_no_prefix},
                                           transform_timestamp_robot_clock, id);
-      logger_interface_->logInfo("Modifying existing object for frame " + child_frame_id_no_prefix);
+      logger_interface_->logInfo("Modifying existing object for frame " + std::string{child_frame_id_no_prefix});
     } else {
-      request = createAddObjectRequest(base_tform_child->transform, preferred_base_frame_, child_frame_id_no_prefix,
+      request = createAddObjectRequest(base_tform_child->transform, preferred_base_frame_,
+                                       std::string{child_frame_id_no_prefix},
                                        transform_timestamp_robot_clock);
-      logger_interface_->logInfo("Adding new object for frame " + child_frame_id_no_prefix);
+      logger_interface_->logInfo("Adding new object for frame " + std::string{child_frame_id_no_prefix});
     }
 
-    // Send the request to the API's client interface to add the object in Spot's environment.
-    const auto response = world_object_client_interface_->mutateWorldObject(request);
+    requests.push_back(std::move(request));
+    request_frame_ids.push_back(child_frame_id);
+    request_object_names.emplace_back(child_frame_id_no_prefix);
+    request_transforms.push_back(base_tform_child->transform);
+  }
+
+  // Send the requests to the API's client interface to add the objects in Spot's environment.
+  const auto responses =
+      world_object_client_interface_->mutateWorldObjects(requests, kMaxMutationsInFlight, request_timeout_);
+  for (std::size_t i = 0; i < responses.size() && i < request_frame_ids.size(); ++i) {
+    const auto& response = responses[i];
     if (!response) {
-      logger_interface_->logWarn(std::string("Failed to modify world object: ").append(response.error()));
+      logger_interface_->logThrottled(LogLevel::kWarn, "modify_world_object", kFailureLogPeriod,
+                                      std::string("Failed to modify world object: ").append(response.error()));
       continue;
     }
     if (response->status() != ::bosdyn::api::MutateWorldObjectResponse::STATUS_OK) {
-      logger_interface_->logWarn(std::string("Failed to modify world object: ").append(toString(response->status())));
+      logger_interface_->logThrottled(
+          LogLevel::kWarn, "modify_world_object", kFailureLogPeriod,
+          std::string("Failed to modify world object: ").append(toString(response->status())));
+      // The cached object may have expired, so the next sync adds it again instead of modifying it.
+      mutable_object_ids_.erase(request_object_names[i]);
+      sent_transforms_.erase(request_frame_ids[i]);
       continue;
     }
+    // Keep the cache up to date with the object that was added or modified, without listing the objects again.
+    mutable_object_ids_.insert_or_assign(request_object_names[i], response->mutated_object_id());
+    sent_transforms_.insert_or_assign(request_frame_ids[i], SentTransform{request_transforms[i], timepoint_now});
 
     // After successfully adding new WorldObject, add the frame ID for this object to the list of frames whose
     // corresponding world objects originate in this node.
-    addManagedFrame(child_frame_id);
+    addManagedFrame(request_frame_ids[i]);
   }
 }
 
+bool ObjectSynchronizer::updateObjectCaches(const rclcpp::Time& timepoint_now) {
+  // After the lifetime of the caches, all objects are listed again so that removed objects are dropped.
+  bool full_refresh = !object_caches_refresh_time_;
+  if (!full_refresh) {
+    try {
+      full_refresh = timepoint_now - *object_caches_refresh_time_ > kObjectCacheLifetime;
+    } catch (const std::runtime_error&) {
+      full_refresh = true;
+    }
+  }
+
+  // Get a list of all world objects which are managed by Spot itself or through other Spot operator tools.
+  // The TF tree may contain frames from these objects, and we should not attempt to modify these objects. The Spot API
+  // allows us to attempt to modify them but it will fail if we try
+  ::bosdyn::api::ListWorldObjectRequest request_non_mutable_objects = createNonMutableObjectsRequest();
+  if (!full_refresh && non_mutable_objects_time_) {
+    request_non_mutable_objects.mutable_timestamp_filter()->CopyFrom(*non_mutable_objects_time_);
+  }
+  const auto non_mutable_objects_response =
+      world_object_client_interface_->listWorldObjects(request_non_mutable_objects, request_timeout_);
+  if (!non_mutable_objects_response) {
+    logger_interface_->logThrottled(LogLevel::kError, "list_non_mutable_objects", kFailureLogPeriod,
+                                    "Failed to list non-mutable objects: " + non_mutable_objects_response.error());
+    return false;
+  }
+
+  // Get the names and IDs of all existing world objects that ObjectSynchronizer can add or modify.
+  ::bosdyn::api::ListWorldObjectRequest request_mutable_frames = createMutableObjectsRequest();
+  if (!full_refresh && mutable_objects_time_) {
+    request_mutable_frames.mutable_timestamp_filter()->CopyFrom(*mutable_objects_time_);
+  }
+  const auto mutable_frames_response =
+      world_object_client_interface_->listWorldObjects(request_mutable_frames, request_timeout_);
+  if (!mutable_frames_response) {
+    logger_interface_->logThrottled(LogLevel::kError, "list_mutable_objects", kFailureLogPeriod,
+                                    "Failed to list mutable objects: " + mutable_frames_response.error());
+    return false;
+  }
+
+  if (full_refresh) {
+    non_mutable_frames_.clear();
+    mutable_object_ids_.clear();
+    non_mutable_objects_time_.reset();
+    mutable_objects_time_.reset();
+    object_caches_refresh_time_ = timepoint_now;
+  }
+  for (const auto& frame : getObjectFrames(non_mutable_objects_response.value())) {
+    if (kSpotInternalFrames.count(frame) == 0) {
+      non_mutable_frames_.insert(frame);
+    }
+  }
+  for (const auto& [name, id] : getObjectNamesAndIDs(mutable_frames_response.value())) {
+    mutable_object_ids_.insert_or_assign(name, id);
+  }
+  updateLatestObjectTime(non_mutable_objects_response.value(), non_mutable_objects_time_);
+  updateLatestObjectTime(mutable_frames_response.value(), mutable_objects_time_);
+  return true;
+}
+
 void ObjectSynchronizer::broadcastWorldObjectTransforms() {
+  if (broadcasts_per_list_ == 0) {
+    if (listWorldObjectTransforms() && !object_transforms_.empty()) {
+      tf_broadcaster_interface_->sendDynamicTransforms(object_transforms_);
+    }
+    return;
+  }
+
+  // The poses are published even if listing the objects fails, so that TF keeps the latest known poses current.
+  const auto timepoint_now = clock_interface_->now();
+  if (broadcasts_++ % broadcasts_per_list_ == 0 && listWorldObjectTransforms()) {
+    updateObjectPoses(timepoint_now);
+  }
+  publishObjectPoses(timepoint_now);
+}
+
+bool ObjectSynchronizer::listWorldObjectTransforms() {
   const auto clock_skew_result = time_sync_interface_->getClockSkew();
   if (!clock_skew_result) {
-    logger_interface_->logError(std::string{"Failed to get latest clock skew: "}.append(clock_skew_result.error()));
-    return;
+    logger_interface_->logThrottled(LogLevel::kError, "get_clock_skew", kFailureLogPeriod,
+                                    std::string{"Failed to get latest clock skew: "}.append(clock_skew_result.error()));
+    return false;
   }
 
+  // Only request the objects which were updated since the latest object that was already listed, unless it is time
+  // for a full list.
   auto request = createAllObjectsRequest();
-  const auto response = world_object_client_interface_->listWorldObjects(request);
+  const bool full_list = !latest_object_time_ || incremental_lists_ >= kIncrementalListsPerFullList;
+  if (!full_list) {
+    request.mutable_timestamp_filter()->CopyFrom(*latest_object_time_);
+  }
+  const auto response = world_object_client_interface_->listWorldObjects(request, request_timeout_);
   if (!response) {
-    logger_interface_->logError("Failed to list world objects: " + response.error());
-    return;
+    logger_interface_->logThrottled(LogLevel::kError, "list_world_objects", kFailureLogPeriod,
+                                    "Failed to list world objects: " + response.error());
+    return false;
   }
-
-  const auto objects = getObjectNamesAndIDs(response.value());
-  std::set<std::string, std::less<>> all_object_names;
-  std::transform(objects.cbegin(), objects.cend(), std::inserter(all_object_names, all_object_names.end()),
-                 [](const std::pair<std::string, int>& pair) {
-                   return pair.first;
-                 });
-
-  // Create a set of names of objects which are not managed by this node
-  const auto managed_frames = getManagedFrames();
-  std::set<std::string, std::less<>> non_managed_objects;
-  std::set_difference(all_object_names.cbegin(), all_object_names.cend(), managed_frames.cbegin(),
-                      managed_frames.cend(), std::inserter(non_managed_objects, non_managed_objects.end()));
-
+  incremental_lists_ = full_list ? 0 : incremental_lists_ + 1;
+
+  updateLatestObjectTime(response.value(), latest_object_time_);
+  // The managed frames are only read from a snapshot, so the broadcast does not copy them or hold their lock.
+  const auto managed_frames = getManagedFramesSnapshot();
+  // The transforms of all objects are sent in one TFMessage, since every node which listens to TF receives every
+  // message. The vector keeps its capacity between broadcasts.
+  object_transforms_.clear();
   for (const auto& object : response->world_objects()) {
-    // Skip publishing TF for objects this node does not manage, since the TF data for these objects is assumed to be
+    // Skip publishing TF for objects this node manages, since the TF data for these objects is assumed to be
     // published by a different source.
-    if (non_managed_objects.count(object.name()) == 0) {
+    if (managed_frames->count(object.name()) > 0) {
       continue;
     }
 
     // Convert the object's frame tree snapshot into ROS TF frames
-    const auto transforms = getTf(object.transforms_snapshot(), object.acquisition_time(), clock_skew_result.value(),
-                                  frame_prefix_, preferred_base_frame_with_prefix_, kSpotInternalFrames);
+    auto transforms = getTf(object.transforms_snapshot(), object.acquisition_time(), clock_skew_result.value(),
+                            frame_prefix_, preferred_base_frame_with_prefix_, kSpotInternalFrames);
     if (!transforms) {
-      logger_interface_->logWarn("Failed to get TF tree for object `" + object.name() + "`.");
+      logger_interface_->logThrottled(LogLevel::kWarn, "get_object_tf", kFailureLogPeriod,
+                                      "Failed to get TF tree for object `" + object.name() + "`.");
+      continue;
+    }
+    object_transforms_.insert(object_transforms_.end(), std::make_move_iterator(transforms->transforms.begin()),
+                              std::make_move_iterator(transforms->transforms.end()));
+  }
+  return true;
+}
+
+void ObjectSynchronizer::updateObjectPoses(const rclcpp::Time& timepoint_now) {
+  for (auto& transform : object_transforms_) {
+    auto [it, inserted] = object_poses_.try_emplace(transform.child_frame_id);
+    auto& pose = it->second;
+    pose.last_listed = timepoint_now;
+    if (!inserted && pose.to.header.stamp == transform.header.stamp) {
       continue;
     }
-    // Broadcast TF frames for this object
-    tf_broadcaster_interface_->sendDynamicTransforms(transforms->transforms);
+    // A new object, or one whose base frame changed, starts at its listed pose. Otherwise, the published pose blends
+    // from where it currently is to the listed pose, so that it does not jump between two lists.
+    if (inserted || pose.to.header.frame_id != transform.header.frame_id) {
+      pose.from = transform;
+    } else {
+      const auto t = std::clamp((timepoint_now - pose.blend_start).seconds() / blend_duration_.seconds(), 0.0, 1.0);
+      interpolateTransform(pose.from, pose.to, t, timepoint_now, pose.from);
+    }
+    pose.to = std::move(transform);
+    pose.blend_start = timepoint_now;
+  }
+
+  for (auto it = object_poses_.begin(); it != object_poses_.end();) {
+    if (timepoint_now - it->second.last_listed > kObjectPoseLifetime) {
+      it = object_poses_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void ObjectSynchronizer::publishObjectPoses(const rclcpp::Time& timepoint_now) {
+  // The poses are relative to the preferred base frame, so TF composes them with its latest transform to the body
+  // instead of extrapolating the body to the acquisition time of the objects.
+  interpolated_transforms_.resize(object_poses_.size());
+  auto transform = interpolated_transforms_.begin();
+  for (const auto& [frame_id, pose] : object_poses_) {
+    const auto t = std::clamp((timepoint_now - pose.blend_start).seconds() / blend_duration_.seconds(), 0.0, 1.0);
+    interpolateTransform(pose.from, pose.to, t, timepoint_now, *transform++);
+  }
+  if (!interpolated_transforms_.empty()) {
+    tf_broadcaster_interface_->sendDynamicTransforms(interpolated_transforms_);
   }
 }
 }  // namespace spot_ros2
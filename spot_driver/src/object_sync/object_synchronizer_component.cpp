@@ -0,0 +1,7 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <rclcpp/node_options.hpp>
+#include <rclcpp_components/register_node_macro.hpp>
+#include <spot_driver/object_sync/object_synchronizer_node.hpp>
+
+RCLCPP_COMPONENTS_REGISTER_NODE(spot_ros2::ObjectSynchronizerNode)
@@ -2,6 +2,7 @@
 
 #include <spot_driver/object_sync/object_synchronizer_node.hpp>
 
+#include <chrono>
 #include <memory>
 #include <spot_driver/api/default_spot_api.hpp>
 #include <spot_driver/interfaces/rclcpp_clock_interface.hpp>
@@ -39,13 +40,26 @@ ObjectSynchronizerNode::ObjectSynchronizerNode(const rclcpp::NodeOptions& node_o
   const auto node = std::make_shared<rclcpp::Node>("object_sync", node_options);
   node_base_interface_ = std::make_unique<RclcppNodeInterface>(node->get_node_base_interface());
 
-  auto mw_handle = std::make_unique<StateMiddlewareHandle>(node);
   auto parameter_interface = std::make_unique<RclcppParameterInterface>(node);
   auto logger_interface = std::make_unique<RclcppLoggerInterface>(node->get_logger());
+  auto mw_handle = std::make_unique<StateMiddlewareHandle>(
+      node, StateMiddlewareHandle::loadPublisherQoS(*parameter_interface, *logger_interface));
   auto tf_broadcaster_interface = std::make_unique<RclcppTfBroadcasterInterface>(node);
-  auto tf_listener_interface = std::make_unique<RclcppTfListenerInterface>(node);
-  auto world_object_update_timer = std::make_unique<RclcppWallTimerInterface>(node);
-  auto tf_broadcaster_timer = std::make_unique<RclcppWallTimerInterface>(node);
+  // The listener only has to keep the frames which might be synced, instead of every frame on a busy TF topic
+  TfListenerOptions tf_listener_options;
+  tf_listener_options.cache_duration = std::chrono::duration_cast<tf2::Duration>(
+      std::chrono::duration<double>{parameter_interface->getObjectSyncTfCacheDuration()});
+  tf_listener_options.allowed_frame_prefixes = parameter_interface->getObjectSyncTfFrameAllowlist();
+  tf_listener_options.denied_frame_prefixes = parameter_interface->getObjectSyncTfFrameDenylist();
+  auto tf_listener_interface = std::make_unique<RclcppTfListenerInterface>(node, tf_listener_options);
+  // Both timers block on requests to Spot's world object service, so each one gets its own callback group. When the node
+  // is spun by a multi-threaded executor, a slow sync of the world objects then does not delay the TF broadcast, and
+  // neither delays the TF listener in the default group. The groups are mutually exclusive, since a timer callback must
+  // not overlap with itself.
+  auto world_object_update_timer = std::make_unique<RclcppWallTimerInterface>(
+      node, node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive));
+  auto tf_broadcaster_timer = std::make_unique<RclcppWallTimerInterface>(
+      node, node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive));
   auto clock_interface = std::make_unique<RclcppClockInterface>(node->get_node_clock_interface());
 
   const auto timesync_timeout = parameter_interface->getTimeSyncTimeout();
@@ -86,8 +100,16 @@ void ObjectSynchronizerNode::initialize(std::unique_ptr<SpotApi> spot_api,
     throw std::runtime_error(error_msg);
   }
 
+  auto world_object_client = spot_api_->worldObjectClientInterface();
+  if (world_object_client == nullptr) {
+    constexpr auto error_msg{
+        "Failed to create the Spot API's world object client, which is required to run this node."};
+    logger_interface->logError(error_msg);
+    throw std::runtime_error(error_msg);
+  }
+
   internal_ = std::make_unique<ObjectSynchronizer>(
-      spot_api_->worldObjectClientInterface(), spot_api_->timeSyncInterface(), std::move(parameter_interface),
+      world_object_client, spot_api_->timeSyncInterface(), std::move(parameter_interface),
       std::move(logger_interface), std::move(tf_broadcaster_interface), std::move(tf_listener_interface),
       std::move(world_object_update_timer), std::move(tf_broadcaster_timer), std::move(clock_interface));
 }
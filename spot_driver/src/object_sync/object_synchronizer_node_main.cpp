@@ -1,6 +1,7 @@
 // Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
 
-#include <rclcpp/executors/multi_threaded_executor.hpp>
+#include <rclcpp/utilities.hpp>
+#include <spot_driver/interfaces/rclcpp_executor.hpp>
 #include <spot_driver/object_sync/object_synchronizer_node.hpp>
 
 int main(int argc, char* argv[]) {
@@ -8,11 +9,9 @@ int main(int argc, char* argv[]) {
 
   spot_ros2::ObjectSynchronizerNode node;
 
-  // This node uses a multithreaded executor because there are two separate timers and it is important that they do not
-  // block each other.
-  rclcpp::executors::MultiThreadedExecutor executor;
-  executor.add_node(node.get_node_base_interface());
-  executor.spin();
+  // This node uses a multithreaded executor by default because there are two separate timers in their own callback
+  // groups and it is important that they do not block each other.
+  spot_ros2::spinNode(node.get_node_base_interface(), spot_ros2::ExecutorType::MULTI_THREADED);
 
   return 0;
 }
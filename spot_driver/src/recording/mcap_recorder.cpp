@@ -0,0 +1,80 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/recording/mcap_recorder.hpp>
+
+#include <chrono>
+#include <exception>
+#include <utility>
+
+namespace spot_ros2::recording {
+
+McapRecorder::McapRecorder(std::unique_ptr<rosbag2_cpp::Writer> writer, std::size_t max_queue_size,
+                           const std::shared_ptr<metrics::MetricsRegistry>& metrics)
+    : writer_{std::move(writer)},
+      max_queue_size_{max_queue_size},
+      written_messages_{metrics->counter("recording.written_messages")},
+      dropped_messages_{metrics->counter("recording.dropped_messages")},
+      write_failures_{metrics->counter("recording.write_failures")},
+      write_time_{metrics->histogram("recording.write_time")},
+      thread_{[this] {
+        writeQueuedMessages();
+      }} {}
+
+McapRecorder::~McapRecorder() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stop_ = true;
+  }
+  queue_changed_.notify_one();
+  thread_.join();
+  // Destroying the writer writes the last chunk and the summary of the MCAP file.
+  writer_.reset();
+}
+
+tl::expected<void, std::string> McapRecorder::setThreadSettings(const ThreadSettings& settings) {
+  return applyThreadSettings(thread_.native_handle(), settings);
+}
+
+void McapRecorder::write(RecordedMessage message) {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (queue_.size() >= max_queue_size_) {
+      dropped_messages_.increment();
+      return;
+    }
+    queue_.push_back(std::move(message));
+  }
+  queue_changed_.notify_one();
+}
+
+void McapRecorder::writeQueuedMessages() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  while (true) {
+    queue_changed_.wait(lock, [this] {
+      return stop_ || !queue_.empty();
+    });
+    // The queue is drained before stopping, so that every message which was accepted ends up in the bag.
+    if (queue_.empty()) {
+      return;
+    }
+    auto message = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+
+    const auto start = std::chrono::steady_clock::now();
+    try {
+      auto serialized = std::make_shared<rclcpp::SerializedMessage>();
+      message.serialize(*serialized);
+      // The topic is created in the bag with the type of its first message.
+      writer_->write(serialized, message.topic, message.type_name, message.log_time);
+      written_messages_.increment();
+    } catch (const std::exception&) {
+      write_failures_.increment();
+    }
+    write_time_.record(std::chrono::steady_clock::now() - start);
+
+    lock.lock();
+  }
+}
+
+}  // namespace spot_ros2::recording
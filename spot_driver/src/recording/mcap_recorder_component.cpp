@@ -0,0 +1,8 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <rclcpp/node_options.hpp>
+#include <rclcpp_components/register_node_macro.hpp>
+#include <spot_driver/recording/mcap_recorder_node.hpp>
+
+// The recorder only receives data from driver nodes in its own process, so it is only registered as a component.
+RCLCPP_COMPONENTS_REGISTER_NODE(spot_ros2::recording::McapRecorderNode)
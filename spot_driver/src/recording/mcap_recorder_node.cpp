@@ -0,0 +1,85 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/recording/mcap_recorder_node.hpp>
+
+#include <rosbag2_storage/storage_options.hpp>
+#include <spot_driver/interfaces/rclcpp_parameter_interface.hpp>
+#include <spot_driver/interfaces/thread_settings.hpp>
+#include <spot_driver/metrics/metrics_registry.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <ctime>
+#include <exception>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace {
+constexpr auto kNodeName{"recorder"};
+constexpr auto kDefaultStoragePreset{"zstd_fast"};
+constexpr auto kDefaultQueueSize{1000};
+
+std::string defaultRecordingUri() {
+  const auto now = std::time(nullptr);
+  std::tm local_time{};
+  localtime_r(&now, &local_time);
+  std::ostringstream uri;
+  uri << "spot_recording_" << std::put_time(&local_time, "%Y_%m_%d-%H_%M_%S");
+  return uri.str();
+}
+}  // namespace
+
+namespace spot_ros2::recording {
+
+McapRecorderNode::McapRecorderNode(const rclcpp::NodeOptions& options)
+    : node_{std::make_shared<rclcpp::Node>(kNodeName, options)}, tap_{RecordingTap::getDefault()} {
+  auto uri = node_->declare_parameter("recording_uri", "");
+  const auto storage_preset = node_->declare_parameter("recording_storage_preset", kDefaultStoragePreset);
+  const auto queue_size = node_->declare_parameter("recording_queue_size", kDefaultQueueSize);
+  if (uri.empty()) {
+    uri = defaultRecordingUri();
+  }
+
+  const RclcppParameterInterface parameters{node_};
+  if (!parameters.getPublishCompressedImages()) {
+    RCLCPP_WARN(node_->get_logger(),
+                "publish_compressed_images is not set, so only the depth images are recorded. Set it to record the "
+                "RGB images as the JPEG images that Spot sent.");
+  }
+
+  rosbag2_storage::StorageOptions storage_options;
+  storage_options.uri = uri;
+  storage_options.storage_id = "mcap";
+  storage_options.storage_preset_profile = storage_preset;
+  auto writer = std::make_unique<rosbag2_cpp::Writer>();
+  try {
+    writer->open(storage_options);
+  } catch (const std::exception& e) {
+    RCLCPP_ERROR(node_->get_logger(), "Could not open the recording `%s`: %s", uri.c_str(), e.what());
+    return;
+  }
+
+  recorder_ = std::make_shared<McapRecorder>(std::move(writer), static_cast<std::size_t>(std::max(queue_size, 1)),
+                                             metrics::MetricsRegistry::getDefault());
+  if (const auto settings = makeThreadSettings(parameters, "recorder", "spot_recorder"); !settings) {
+    RCLCPP_WARN(node_->get_logger(), "%s", settings.error().c_str());
+  } else if (const auto result = recorder_->setThreadSettings(settings.value()); !result) {
+    RCLCPP_WARN(node_->get_logger(), "%s", result.error().c_str());
+  }
+  tap_->attach(recorder_);
+  RCLCPP_INFO(node_->get_logger(), "Recording the driver data to `%s`.", uri.c_str());
+}
+
+McapRecorderNode::~McapRecorderNode() {
+  // The publishers stop handing messages to the recorder before it writes the rest of its queue and closes the bag.
+  if (recorder_) {
+    tap_->detach(recorder_.get());
+  }
+}
+
+std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> McapRecorderNode::get_node_base_interface() {
+  return node_->get_node_base_interface();
+}
+
+}  // namespace spot_ros2::recording
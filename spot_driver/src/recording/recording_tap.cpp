@@ -0,0 +1,32 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/recording/recording_tap.hpp>
+
+namespace spot_ros2::recording {
+
+std::shared_ptr<RecordingTap> RecordingTap::getDefault() {
+  static const auto tap = std::make_shared<RecordingTap>();
+  return tap;
+}
+
+void RecordingTap::attach(std::shared_ptr<RecordingSink> sink) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  sink_ = std::move(sink);
+  active_.store(sink_ != nullptr, std::memory_order_relaxed);
+}
+
+void RecordingTap::detach(const RecordingSink* sink) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (sink_.get() != sink) {
+    return;
+  }
+  sink_.reset();
+  active_.store(false, std::memory_order_relaxed);
+}
+
+std::shared_ptr<RecordingSink> RecordingTap::currentSink() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return sink_;
+}
+
+}  // namespace spot_ros2::recording
@@ -0,0 +1,187 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/robot_state/robot_state_history.hpp>
+
+#include <bosdyn/api/geometry.pb.h>
+#include <bosdyn/math/proto_math.h>
+#include <algorithm>
+#include <eigen3/Eigen/Geometry>
+#include <spot_driver/conversions/common_conversions.hpp>
+#include <spot_driver/conversions/frame_tree_resolver.hpp>
+#include <spot_driver/conversions/robot_state.hpp>
+#include <spot_driver/conversions/time.hpp>
+
+namespace {
+constexpr std::int64_t kNanosecondsPerSecond = 1000000000;
+constexpr auto kBodyFrame = "body";
+constexpr auto kOdomFrame = "odom";
+constexpr auto kVisionFrame = "vision";
+
+double lerp(const double a, const double b, const double t) {
+  return a + t * (b - a);
+}
+
+void lerp(const geometry_msgs::msg::Vector3& a, const geometry_msgs::msg::Vector3& b, const double t,
+          geometry_msgs::msg::Vector3& result) {
+  result.x = lerp(a.x, b.x, t);
+  result.y = lerp(a.y, b.y, t);
+  result.z = lerp(a.z, b.z, t);
+}
+
+void interpolatePose(const geometry_msgs::msg::Pose& a, const geometry_msgs::msg::Pose& b, const double t,
+                     geometry_msgs::msg::Pose& result) {
+  result.position.x = lerp(a.position.x, b.position.x, t);
+  result.position.y = lerp(a.position.y, b.position.y, t);
+  result.position.z = lerp(a.position.z, b.position.z, t);
+  const Eigen::Quaterniond qa{a.orientation.w, a.orientation.x, a.orientation.y, a.orientation.z};
+  const Eigen::Quaterniond qb{b.orientation.w, b.orientation.x, b.orientation.y, b.orientation.z};
+  const auto q = qa.slerp(t, qb);
+  result.orientation.w = q.w();
+  result.orientation.x = q.x();
+  result.orientation.y = q.y();
+  result.orientation.z = q.z();
+}
+
+/** @brief Interpolate between two snapshots, where t is 0 at the first snapshot and 1 at the second one. */
+spot_ros2::RobotStateSnapshot interpolate(const spot_ros2::RobotStateSnapshot& a,
+                                          const spot_ros2::RobotStateSnapshot& b, const std::int64_t stamp_ns) {
+  const double t = static_cast<double>(stamp_ns - a.stamp_ns) / static_cast<double>(b.stamp_ns - a.stamp_ns);
+  // The joints are taken from the closer snapshot, and only interpolated if both snapshots have the same joints.
+  auto result = t < 0.5 ? a : b;
+  result.stamp_ns = stamp_ns;
+  interpolatePose(a.odom_tform_body, b.odom_tform_body, t, result.odom_tform_body);
+  interpolatePose(a.vision_tform_body, b.vision_tform_body, t, result.vision_tform_body);
+  lerp(a.body_velocity_in_odom.linear, b.body_velocity_in_odom.linear, t, result.body_velocity_in_odom.linear);
+  lerp(a.body_velocity_in_odom.angular, b.body_velocity_in_odom.angular, t, result.body_velocity_in_odom.angular);
+  if (a.joint_count == b.joint_count && a.joint_names == b.joint_names) {
+    for (std::size_t index = 0; index < a.joint_count; ++index) {
+      result.joint_positions[index] = lerp(a.joint_positions[index], b.joint_positions[index], t);
+      result.joint_velocities[index] = lerp(a.joint_velocities[index], b.joint_velocities[index], t);
+      result.joint_efforts[index] = lerp(a.joint_efforts[index], b.joint_efforts[index], t);
+    }
+  }
+  return result;
+}
+}  // namespace
+
+namespace spot_ros2 {
+
+std::optional<RobotStateSnapshot> makeRobotStateSnapshot(const ::bosdyn::api::RobotState& robot_state,
+                                                         const google::protobuf::Duration& clock_skew) {
+  if (!robot_state.has_kinematic_state() || !robot_state.kinematic_state().has_acquisition_timestamp() ||
+      !robot_state.kinematic_state().has_transforms_snapshot()) {
+    return std::nullopt;
+  }
+  const auto& kinematic_state = robot_state.kinematic_state();
+
+  // Both poses are resolved from one pass over the snapshot, instead of walking the tree once for each of them.
+  thread_local FrameTreeResolver resolver;
+  if (!resolver.compile(kinematic_state.transforms_snapshot(), kBodyFrame)) {
+    return std::nullopt;
+  }
+  const auto body_tform_odom = resolver.rootTformFrame(kOdomFrame);
+  const auto body_tform_vision = resolver.rootTformFrame(kVisionFrame);
+  if (!body_tform_odom || !body_tform_vision) {
+    return std::nullopt;
+  }
+  const auto odom_tform_body = ~*body_tform_odom;
+  const auto vision_tform_body = ~*body_tform_vision;
+
+  RobotStateSnapshot snapshot;
+  const auto stamp = robotTimeToLocalTime(kinematic_state.acquisition_timestamp(), clock_skew);
+  snapshot.stamp_ns = static_cast<std::int64_t>(stamp.sec) * kNanosecondsPerSecond + stamp.nanosec;
+  convertToRos(odom_tform_body, snapshot.odom_tform_body);
+  convertToRos(vision_tform_body, snapshot.vision_tform_body);
+  if (kinematic_state.has_velocity_of_body_in_odom()) {
+    convertToRos(kinematic_state.velocity_of_body_in_odom(), snapshot.body_velocity_in_odom);
+  }
+
+  for (const auto& joint : kinematic_state.joint_states()) {
+    const auto name = kFriendlyJointNames.find(joint.name());
+    if (name == kFriendlyJointNames.end() || snapshot.joint_count == RobotStateSnapshot::kMaxJoints) {
+      continue;
+    }
+    const auto index = snapshot.joint_count++;
+    snapshot.joint_names[index] = &name->second;
+    snapshot.joint_positions[index] = joint.position().value();
+    snapshot.joint_velocities[index] = joint.velocity().value();
+    snapshot.joint_efforts[index] = joint.load().value();
+  }
+  return snapshot;
+}
+
+RobotStateHistory::RobotStateHistory(std::size_t capacity)
+    : capacity_{std::max<std::size_t>(capacity, 1)}, slots_{std::make_unique<Slot[]>(capacity_)} {}
+
+void RobotStateHistory::add(const RobotStateSnapshot& snapshot) {
+  const auto index = count_.load(std::memory_order_relaxed);
+  auto& slot = slots_[index % capacity_];
+  slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.snapshot = snapshot;
+  slot.sequence.store(2 * index + 2, std::memory_order_release);
+  count_.store(index + 1, std::memory_order_release);
+}
+
+bool RobotStateHistory::read(std::uint64_t index, RobotStateSnapshot& snapshot) const {
+  const auto& slot = slots_[index % capacity_];
+  const auto expected = 2 * index + 2;
+  if (slot.sequence.load(std::memory_order_acquire) != expected) {
+    return false;
+  }
+  snapshot = slot.snapshot;
+  // The copy is only valid if the writer did not start to overwrite the slot in the meantime.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.sequence.load(std::memory_order_relaxed) == expected;
+}
+
+std::optional<RobotStateSnapshot> RobotStateHistory::latest() const {
+  RobotStateSnapshot snapshot;
+  // The latest snapshot can only be overwritten if the writer wraps around the whole history, so this is retried
+  // until a read succeeds.
+  for (auto count = count_.load(std::memory_order_acquire); count > 0; count = count_.load(std::memory_order_acquire)) {
+    if (read(count - 1, snapshot)) {
+      return snapshot;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<RobotStateSnapshot> RobotStateHistory::lookup(std::int64_t stamp_ns) const {
+  const auto count = count_.load(std::memory_order_acquire);
+  if (count == 0) {
+    return std::nullopt;
+  }
+
+  // Binary search for the first snapshot at or after the requested time. Snapshots which were overwritten during the
+  // search are older than any remaining one, so they are treated as before the requested time.
+  RobotStateSnapshot after;
+  auto first = count > capacity_ ? count - capacity_ : 0;
+  auto last = count;
+  bool found = false;
+  while (first < last) {
+    const auto middle = first + (last - first) / 2;
+    RobotStateSnapshot snapshot;
+    if (!read(middle, snapshot) || snapshot.stamp_ns < stamp_ns) {
+      first = middle + 1;
+    } else {
+      last = middle;
+      after = snapshot;
+      found = true;
+    }
+  }
+  if (!found) {
+    return std::nullopt;
+  }
+  if (after.stamp_ns == stamp_ns) {
+    return after;
+  }
+
+  RobotStateSnapshot before;
+  if (first == 0 || !read(first - 1, before) || before.stamp_ns > stamp_ns) {
+    return std::nullopt;
+  }
+  return interpolate(before, after, stamp_ns);
+}
+
+}  // namespace spot_ros2
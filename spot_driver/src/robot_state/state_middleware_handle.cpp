@@ -13,12 +13,18 @@
 #include <spot_msgs/msg/e_stop_state_array.hpp>
 #include <spot_msgs/msg/foot_state_array.hpp>
 #include <spot_msgs/msg/power_state.hpp>
+#include <spot_msgs/msg/serialized_proto.hpp>
 #include <spot_msgs/msg/system_fault_state.hpp>
 #include <spot_msgs/msg/wi_fi_state.hpp>
+#include <spot_msgs/srv/get_robot_state_at_time.hpp>
+
+#include <optional>
 
 namespace {
 constexpr auto kPublisherHistoryDepth = 1;
 constexpr auto kNodeName{"spot_state_publisher"};
+// All robot state topics share the QoS settings from the `qos.state.*` parameters.
+constexpr auto kQoSCategory{"state"};
 
 // ROS topic names for Spot's robot state publisher
 constexpr auto kJointStatesTopic{"joint_states"};
@@ -33,56 +39,89 @@ constexpr auto kSystemFaultsTopic{"status/system_faults"};
 constexpr auto kBehaviorFaultsTopic{"status/behavior_faults"};
 constexpr auto kEndEffectorForceTopic{"status/end_effector_force"};
 constexpr auto kManipulatorTopic{"manipulation_state"};
+constexpr auto kRawRobotStateTopic{"robot_state/raw"};
+constexpr auto kLowLevelJointStatesTopic{"low_level/joint_states"};
+
+constexpr auto kGetRobotStateAtTimeService{"get_robot_state_at_time"};
+
+/**
+ * @brief Hand a copy of a message to the recorder under the topic of its publisher, if the message was converted.
+ */
+template <typename MessageT>
+void recordMessage(spot_ros2::recording::RecordingTap& tap, const rclcpp::Publisher<MessageT>& publisher,
+                   const std::optional<MessageT>& message, const rclcpp::Time& log_time) {
+  if (message) {
+    tap.record(publisher.get_topic_name(), message.value(), log_time);
+  }
+}
 
 }  // namespace
 
 namespace spot_ros2 {
 
+rclcpp::QoS StateMiddlewareHandle::loadPublisherQoS(const ParameterInterfaceBase& parameters,
+                                                    const LoggerInterfaceBase& logger) {
+  return makePublisherQoS(parameters, logger, kQoSCategory, kPublisherHistoryDepth);
+}
+
 StateMiddlewareHandle::StateMiddlewareHandle(const std::shared_ptr<rclcpp::Node>& node)
+    : StateMiddlewareHandle(node, makePublisherQoS(kPublisherHistoryDepth)) {}
+
+StateMiddlewareHandle::StateMiddlewareHandle(const std::shared_ptr<rclcpp::Node>& node, const rclcpp::QoS& qos)
     : node_{node},
-      battery_states_publisher_{node_->create_publisher<spot_msgs::msg::BatteryStateArray>(
-          kBatteryStatesTopic, makePublisherQoS(kPublisherHistoryDepth))},
-      wifi_state_publisher_{
-          node_->create_publisher<spot_msgs::msg::WiFiState>(kWifiTopic, makePublisherQoS(kPublisherHistoryDepth))},
-      foot_states_publisher_{node_->create_publisher<spot_msgs::msg::FootStateArray>(
-          kFeetTopic, makePublisherQoS(kPublisherHistoryDepth))},
-      estop_states_publisher_{node_->create_publisher<spot_msgs::msg::EStopStateArray>(
-          kEStopTopic, makePublisherQoS(kPublisherHistoryDepth))},
-      joint_state_publisher_{node_->create_publisher<sensor_msgs::msg::JointState>(
-          kJointStatesTopic, makePublisherQoS(kPublisherHistoryDepth))},
+      qos_{qos},
+      battery_states_publisher_{node_->create_publisher<spot_msgs::msg::BatteryStateArray>(kBatteryStatesTopic, qos_)},
+      wifi_state_publisher_{node_->create_publisher<spot_msgs::msg::WiFiState>(kWifiTopic, qos_)},
+      foot_states_publisher_{node_->create_publisher<spot_msgs::msg::FootStateArray>(kFeetTopic, qos_)},
+      estop_states_publisher_{node_->create_publisher<spot_msgs::msg::EStopStateArray>(kEStopTopic, qos_)},
+      joint_state_publisher_{node_->create_publisher<sensor_msgs::msg::JointState>(kJointStatesTopic, qos_)},
       odom_twist_publisher_{node_->create_publisher<geometry_msgs::msg::TwistWithCovarianceStamped>(
-          kOdomTwistTopic, makePublisherQoS(kPublisherHistoryDepth))},
-      odom_publisher_{
-          node_->create_publisher<nav_msgs::msg::Odometry>(kOdomTopic, makePublisherQoS(kPublisherHistoryDepth))},
-      power_state_publisher_{node_->create_publisher<spot_msgs::msg::PowerState>(
-          kPowerStatesTopic, makePublisherQoS(kPublisherHistoryDepth))},
-      system_faults_publisher_{node_->create_publisher<spot_msgs::msg::SystemFaultState>(
-          kSystemFaultsTopic, makePublisherQoS(kPublisherHistoryDepth))},
+          kOdomTwistTopic, qos_)},
+      odom_publisher_{node_->create_publisher<nav_msgs::msg::Odometry>(kOdomTopic, qos_)},
+      power_state_publisher_{node_->create_publisher<spot_msgs::msg::PowerState>(kPowerStatesTopic, qos_)},
+      system_faults_publisher_{node_->create_publisher<spot_msgs::msg::SystemFaultState>(kSystemFaultsTopic, qos_)},
       manipulator_state_publisher_{node_->create_publisher<bosdyn_api_msgs::msg::ManipulatorState>(
-          kManipulatorTopic, makePublisherQoS(kPublisherHistoryDepth))},
+          kManipulatorTopic, qos_)},
       end_effector_force_publisher_{node_->create_publisher<geometry_msgs::msg::Vector3Stamped>(
-          kEndEffectorForceTopic, makePublisherQoS(kPublisherHistoryDepth))},
+          kEndEffectorForceTopic, qos_)},
       behavior_fault_state_publisher_{node_->create_publisher<spot_msgs::msg::BehaviorFaultState>(
-          kBehaviorFaultsTopic, makePublisherQoS(kPublisherHistoryDepth))} {}
+          kBehaviorFaultsTopic, qos_)} {}
 
 StateMiddlewareHandle::StateMiddlewareHandle(const rclcpp::NodeOptions& node_options)
     : StateMiddlewareHandle(std::make_shared<rclcpp::Node>(kNodeName, node_options)) {}
 
-void StateMiddlewareHandle::publishRobotState(const RobotStateMessages& robot_state_msgs) {
-  battery_states_publisher_->publish(robot_state_msgs.battery_states);
-  wifi_state_publisher_->publish(robot_state_msgs.wifi_state);
-  foot_states_publisher_->publish(robot_state_msgs.foot_state);
-  estop_states_publisher_->publish(robot_state_msgs.estop_states);
-
-  if (robot_state_msgs.maybe_joint_states) {
-    joint_state_publisher_->publish(robot_state_msgs.maybe_joint_states.value());
-  }
+void StateMiddlewareHandle::publishOdometry(const RobotStateMessages& robot_state_msgs) {
   if (robot_state_msgs.maybe_odom_twist) {
     odom_twist_publisher_->publish(robot_state_msgs.maybe_odom_twist.value());
   }
   if (robot_state_msgs.maybe_odom) {
     odom_publisher_->publish(robot_state_msgs.maybe_odom.value());
   }
+  if (recording_tap_->isActive()) {
+    const auto record = [this, log_time = node_->now()](const auto& publisher, const auto& message) {
+      recordMessage(*recording_tap_, *publisher, message, log_time);
+    };
+    record(odom_twist_publisher_, robot_state_msgs.maybe_odom_twist);
+    record(odom_publisher_, robot_state_msgs.maybe_odom);
+  }
+}
+
+void StateMiddlewareHandle::publishRobotState(const RobotStateMessages& robot_state_msgs) {
+  if (robot_state_msgs.maybe_battery_states) {
+    battery_states_publisher_->publish(robot_state_msgs.maybe_battery_states.value());
+  }
+  if (robot_state_msgs.maybe_wifi_state) {
+    wifi_state_publisher_->publish(robot_state_msgs.maybe_wifi_state.value());
+  }
+  if (robot_state_msgs.maybe_foot_state) {
+    foot_states_publisher_->publish(robot_state_msgs.maybe_foot_state.value());
+  }
+  if (robot_state_msgs.maybe_estop_states) {
+    estop_states_publisher_->publish(robot_state_msgs.maybe_estop_states.value());
+  }
+  if (robot_state_msgs.maybe_joint_states) {
+    joint_state_publisher_->publish(robot_state_msgs.maybe_joint_states.value());
+  }
   if (robot_state_msgs.maybe_power_state) {
     power_state_publisher_->publish(robot_state_msgs.maybe_power_state.value());
   }
@@ -98,6 +137,96 @@ void StateMiddlewareHandle::publishRobotState(const RobotStateMessages& robot_st
   if (robot_state_msgs.maybe_behavior_fault_state) {
     behavior_fault_state_publisher_->publish(robot_state_msgs.maybe_behavior_fault_state.value());
   }
+  if (recording_tap_->isActive()) {
+    const auto record = [this, log_time = node_->now()](const auto& publisher, const auto& message) {
+      recordMessage(*recording_tap_, *publisher, message, log_time);
+    };
+    record(battery_states_publisher_, robot_state_msgs.maybe_battery_states);
+    record(wifi_state_publisher_, robot_state_msgs.maybe_wifi_state);
+    record(foot_states_publisher_, robot_state_msgs.maybe_foot_state);
+    record(estop_states_publisher_, robot_state_msgs.maybe_estop_states);
+    record(joint_state_publisher_, robot_state_msgs.maybe_joint_states);
+    record(power_state_publisher_, robot_state_msgs.maybe_power_state);
+    record(system_faults_publisher_, robot_state_msgs.maybe_system_fault_state);
+    record(manipulator_state_publisher_, robot_state_msgs.maybe_manipulator_state);
+    record(end_effector_force_publisher_, robot_state_msgs.maybe_end_effector_force);
+    record(behavior_fault_state_publisher_, robot_state_msgs.maybe_behavior_fault_state);
+  }
+}
+
+void StateMiddlewareHandle::publishRawRobotState(const bosdyn::api::RobotState& robot_state) {
+  if (!raw_robot_state_publisher_) {
+    raw_robot_state_publisher_ = node_->create_publisher<spot_msgs::msg::SerializedProto>(kRawRobotStateTopic, qos_);
+    raw_robot_state_.type_name = robot_state.GetTypeName();
+  }
+  raw_robot_state_.header.stamp = node_->now();
+  raw_robot_state_.data.resize(robot_state.ByteSizeLong());
+  robot_state.SerializeWithCachedSizesToArray(raw_robot_state_.data.data());
+  raw_robot_state_publisher_->publish(raw_robot_state_);
+}
+
+bool StateMiddlewareHandle::hasSubscribers(StatePublisher::Topic topic) const {
+  // The recorder needs every converted topic, like a subscriber of every topic. The raw topic is not recorded.
+  if (recording_tap_->isActive() && topic != StatePublisher::Topic::kRaw) {
+    return true;
+  }
+  const auto has_subscribers = [](const auto& publisher) {
+    // Transient local topics keep their last message for late subscribers, so they are always published.
+    return publisher->get_subscription_count() > 0 ||
+           publisher->get_actual_qos().durability() == rclcpp::DurabilityPolicy::TransientLocal;
+  };
+  switch (topic) {
+    case StatePublisher::Topic::kBatteryStates:
+      return has_subscribers(battery_states_publisher_);
+    case StatePublisher::Topic::kWifi:
+      return has_subscribers(wifi_state_publisher_);
+    case StatePublisher::Topic::kFeet:
+      return has_subscribers(foot_states_publisher_);
+    case StatePublisher::Topic::kEStop:
+      return has_subscribers(estop_states_publisher_);
+    case StatePublisher::Topic::kJointStates:
+      return has_subscribers(joint_state_publisher_);
+    case StatePublisher::Topic::kOdometryTwist:
+      return has_subscribers(odom_twist_publisher_);
+    case StatePublisher::Topic::kOdometry:
+      return has_subscribers(odom_publisher_);
+    case StatePublisher::Topic::kPowerStates:
+      return has_subscribers(power_state_publisher_);
+    case StatePublisher::Topic::kSystemFaults:
+      return has_subscribers(system_faults_publisher_);
+    case StatePublisher::Topic::kManipulationState:
+      return has_subscribers(manipulator_state_publisher_);
+    case StatePublisher::Topic::kEndEffectorForce:
+      return has_subscribers(end_effector_force_publisher_);
+    case StatePublisher::Topic::kBehaviorFaults:
+      return has_subscribers(behavior_fault_state_publisher_);
+    case StatePublisher::Topic::kRaw:
+      // The raw publisher is only created by the first raw robot state.
+      return !raw_robot_state_publisher_ || has_subscribers(raw_robot_state_publisher_);
+    default:
+      // TF is broadcast by the TF broadcaster rather than by this handle.
+      return true;
+  }
+}
+
+void StateMiddlewareHandle::createGetRobotStateAtTimeService(const GetRobotStateAtTimeCallback& callback) {
+  get_robot_state_at_time_service_ =
+      node_->create_service<spot_msgs::srv::GetRobotStateAtTime>(kGetRobotStateAtTimeService, callback);
+}
+
+void StateMiddlewareHandle::subscribeToLowLevelJointStates(const JointStatesCallback& callback) {
+  low_level_joint_states_subscription_ = node_->create_subscription<sensor_msgs::msg::JointState>(
+      kLowLevelJointStatesTopic, rclcpp::SensorDataQoS().keep_last(kPublisherHistoryDepth),
+      [callback](const sensor_msgs::msg::JointState::SharedPtr joint_states) {
+        callback(*joint_states);
+      });
+}
+
+void StateMiddlewareHandle::publishJointStates(const sensor_msgs::msg::JointState& joint_states) {
+  joint_state_publisher_->publish(joint_states);
+  if (recording_tap_->isActive()) {
+    recording_tap_->record(joint_state_publisher_->get_topic_name(), joint_states, node_->now());
+  }
 }
 
 }  // namespace spot_ros2
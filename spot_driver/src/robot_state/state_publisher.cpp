@@ -1,16 +1,65 @@
 // Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <spot_driver/api/state_client_interface.hpp>
 #include <spot_driver/conversions/geometry.hpp>
 #include <spot_driver/conversions/robot_state.hpp>
+#include <spot_driver/conversions/time.hpp>
 #include <spot_driver/interfaces/rclcpp_wall_timer_interface.hpp>
+#include <spot_driver/interfaces/thread_settings.hpp>
 #include <spot_driver/robot_state/state_publisher.hpp>
+#include <spot_driver/tracing.hpp>
 #include <spot_driver/types.hpp>
+#include <string>
+#include <thread>
 #include <utility>
 
 namespace {
 constexpr auto kRobotStateCallbackPeriod = std::chrono::duration<double>{1.0 / 50.0};  // 50 Hz
+constexpr std::int64_t kNanosecondsPerSecond = 1000000000;
+// Failures to get the robot state repeat 50 times per second while the robot is unreachable, so they are logged at
+// most once per period.
+constexpr auto kFailureLogPeriod = std::chrono::seconds{5};
+// The hardware interface streams joint states at 333 Hz, so a stream which is silent for this long has stopped and the
+// joint states of the robot state are published again.
+constexpr auto kLowLevelJointStatesTimeout = std::chrono::milliseconds{200};
+
+// Names of the robot state topics in the robot_state_rate.* parameters, in the order of StatePublisher::Topic.
+constexpr std::array<const char*, 14> kTopicRateNames{"battery_states", "wifi", "feet", "estop", "joint_states", "tf",
+                                                      "odometry_twist", "odometry", "power_states", "system_faults",
+                                                      "manipulation_state", "end_effector_force", "behavior_faults",
+                                                      "raw"};
+
+/** @brief Check whether a topic is one of the status topics, which are the ones that can be published on change. */
+bool isStatusTopic(const spot_ros2::StatePublisher::Topic topic) {
+  using Topic = spot_ros2::StatePublisher::Topic;
+  return topic == Topic::kBatteryStates || topic == Topic::kWifi || topic == Topic::kEStop ||
+         topic == Topic::kPowerStates || topic == Topic::kSystemFaults || topic == Topic::kBehaviorFaults;
+}
+
+/** @brief Hash the serialized content of a protobuf message. */
+std::size_t fingerprint(const google::protobuf::Message& message) {
+  return std::hash<std::string>{}(message.SerializeAsString());
+}
+
+/**
+ * @brief Hash the serialized content of repeated protobuf messages, without their timestamps, which change with every
+ * robot state even if the status does not.
+ */
+template <typename RepeatedMessages>
+std::size_t fingerprintWithoutTimestamps(const RepeatedMessages& messages) {
+  std::string serialized;
+  for (auto message : messages) {
+    message.clear_timestamp();
+    serialized.append(message.SerializeAsString());
+  }
+  return std::hash<std::string>{}(serialized);
+}
 }
 
 namespace spot_ros2 {
@@ -21,7 +70,8 @@ StatePublisher::StatePublisher(const std::shared_ptr<StateClientInterface>& stat
                                std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                                std::unique_ptr<LoggerInterfaceBase> logger_interface,
                                std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
-                               std::unique_ptr<TimerInterfaceBase> timer_interface)
+                               std::unique_ptr<TimerInterfaceBase> timer_interface,
+                               const std::shared_ptr<metrics::MetricsRegistry>& metrics_registry)
     : is_using_vision_{false},
       state_client_interface_{state_client_interface},
       time_sync_interface_{time_sync_api},
@@ -29,7 +79,13 @@ StatePublisher::StatePublisher(const std::shared_ptr<StateClientInterface>& stat
       parameter_interface_{std::move(parameter_interface)},
       logger_interface_{std::move(logger_interface)},
       tf_broadcaster_interface_{std::move(tf_broadcaster_interface)},
-      timer_interface_{std::move(timer_interface)} {
+      timer_interface_{std::move(timer_interface)},
+      metrics_registry_{metrics_registry},
+      clock_skew_failures_{metrics_registry_->counter("robot_state.clock_skew_failures")},
+      rpc_failures_{metrics_registry_->counter("robot_state.rpc_failures")},
+      repeated_states_dropped_{metrics_registry_->counter("robot_state.repeated_states_dropped")},
+      rpc_latency_{metrics_registry_->histogram("robot_state.rpc_latency")},
+      publish_time_{metrics_registry_->histogram("robot_state.publish_time")} {
   const auto spot_name = parameter_interface_->getSpotName();
   frame_prefix_ = spot_name.empty() ? "" : spot_name + "/";
 
@@ -38,50 +94,341 @@ StatePublisher::StatePublisher(const std::shared_ptr<StateClientInterface>& stat
 
   const auto tf_root = parameter_interface_->getTFRoot();
   full_tf_root_id_ = tf_root.find('/') == std::string::npos ? frame_prefix_ + tf_root : tf_root;
+  tf_converter_.emplace(frame_prefix_, full_tf_root_id_);
+  joint_state_converter_.emplace(frame_prefix_);
+
+  static_assert(kTopicRateNames.size() == static_cast<std::size_t>(Topic::kCount));
+  for (std::size_t index = 0; index < kTopicRateNames.size(); ++index) {
+    const auto rate = parameter_interface_->getRobotStatePublishRate(kTopicRateNames[index]);
+    if (rate > 0.0) {
+      topic_rates_[index].period =
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>{1.0 / rate});
+    }
+  }
 
-  // Create a timer to request and publish robot state at a fixed rate
-  timer_interface_->setTimer(kRobotStateCallbackPeriod, [this] {
-    timerCallback();
-  });
+  publish_status_on_change_ = parameter_interface_->getPublishStatusOnChange();
+  status_heartbeat_period_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>{parameter_interface_->getStatusHeartbeatPeriod()});
+  publish_raw_protobuf_ = parameter_interface_->getPublishRawProtobuf();
+  raw_protobuf_only_ = publish_raw_protobuf_ && parameter_interface_->getRawProtobufOnly();
+  request_timeout_ = std::chrono::duration<double>{parameter_interface_->getRobotStateRequestTimeout()};
+  if (parameter_interface_->getDegradeOnPoorLink()) {
+    link_monitor_ = LinkMonitor::getForRobot(spot_name);
+    link_monitor_->configure(makeLinkMonitorOptions(*parameter_interface_));
+    degraded_rate_divisor_ = static_cast<std::size_t>(std::max(parameter_interface_->getDegradedRateDivisor(), 1));
+  }
+
+  if (const auto history_size = parameter_interface_->getRobotStateHistorySize(); history_size > 0) {
+    robot_state_history_ = std::make_shared<RobotStateHistory>(static_cast<std::size_t>(history_size));
+    middleware_handle_->createGetRobotStateAtTimeService(
+        [this](const std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Request> request,
+               std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Response> response) {
+          getRobotStateAtTime(request, response);
+        });
+  }
+
+  low_level_joint_states_ = parameter_interface_->getLowLevelJointStates();
+  if (low_level_joint_states_) {
+    middleware_handle_->subscribeToLowLevelJointStates([this](const sensor_msgs::msg::JointState& joint_states) {
+      lowLevelJointStatesCallback(joint_states);
+    });
+  }
+
+  stream_robot_state_ = parameter_interface_->getStreamRobotState();
+  if (stream_robot_state_) {
+    stream_thread_ = std::thread{[this] {
+      streamRobotState();
+    }};
+    if (const auto result = configureThread(stream_thread_.native_handle(), *parameter_interface_, "state_stream",
+                                            "spot_state");
+        !result) {
+      logger_interface_->logWarn(result.error());
+    }
+  } else {
+    // Create a timer to request and publish robot state at a fixed rate
+    timer_interface_->setTimer(kRobotStateCallbackPeriod, [this] {
+      timerCallback();
+    });
+  }
+}
+
+StatePublisher::~StatePublisher() {
+  stop_streaming_ = true;
+  if (stream_thread_.joinable()) {
+    stream_thread_.join();
+  }
 }
 
 void StatePublisher::timerCallback() {
+  const auto tick = timer_ticks_++;
+  if (updateLinkDegraded() && tick % degraded_rate_divisor_ != 0) {
+    return;
+  }
+  requestAndPublishRobotState(false);
+}
+
+void StatePublisher::streamRobotState() {
+  while (!stop_streaming_) {
+    if (updateLinkDegraded()) {
+      // Back to back requests would add the most load to a link which is already struggling.
+      std::this_thread::sleep_for(kRobotStateCallbackPeriod * static_cast<double>(degraded_rate_divisor_));
+    }
+    if (!requestAndPublishRobotState(true)) {
+      // Wait for a timer period before retrying, rather than flooding an unreachable robot with requests.
+      std::this_thread::sleep_for(kRobotStateCallbackPeriod);
+    }
+  }
+}
+
+bool StatePublisher::updateLinkDegraded() {
+  if (!link_monitor_) {
+    return false;
+  }
+  const auto degraded = link_monitor_->quality() == LinkQuality::kDegraded;
+  if (degraded != link_degraded_) {
+    link_degraded_ = degraded;
+    logger_interface_->logWarn(degraded ? "The link to the robot is degraded, requesting the robot state and "
+                                          "publishing the status topics less often."
+                                        : "The link to the robot recovered, restoring the robot state rates.");
+  }
+  return degraded;
+}
+
+void StatePublisher::lowLevelJointStatesCallback(const sensor_msgs::msg::JointState& joint_states) {
+  last_low_level_joint_states_ = std::chrono::steady_clock::now();
+  // The low-level stream is relayed as it arrives rather than at the joint_states rate, since its rate is the point.
+  if (middleware_handle_->hasSubscribers(Topic::kJointStates)) {
+    middleware_handle_->publishJointStates(joint_states);
+  }
+}
+
+bool StatePublisher::lowLevelJointStatesLive(const std::chrono::steady_clock::time_point now) const {
+  return low_level_joint_states_ && now - last_low_level_joint_states_.load() < kLowLevelJointStatesTimeout;
+}
+
+bool StatePublisher::requestAndPublishRobotState(bool drop_repeated) {
   // Get latest clock skew each time we request a robot state
   const auto clock_skew_result = time_sync_interface_->getClockSkew();
   if (!clock_skew_result) {
-    logger_interface_->logError(std::string{"Failed to get latest clock skew: "}.append(clock_skew_result.error()));
-    return;
+    clock_skew_failures_.increment();
+    logger_interface_->logThrottled(LogLevel::kError, "get_clock_skew", kFailureLogPeriod,
+                                    std::string{"Failed to get latest clock skew: "}.append(clock_skew_result.error()));
+    return false;
   }
 
-  const auto robot_state_result = state_client_interface_->getRobotState();
+  tracing::stageBegin(tracing::kRobotStatePipeline, "get_robot_state");
+  const auto request_start = std::chrono::steady_clock::now();
+  const auto robot_state_result = state_client_interface_->getRobotState(request_timeout_);
+  rpc_latency_.record(std::chrono::steady_clock::now() - request_start);
+  tracing::stageEnd(tracing::kRobotStatePipeline, "get_robot_state");
   if (!robot_state_result.has_value()) {
-    logger_interface_->logError(std::string{"Failed to get robot_state: "}.append(robot_state_result.error()));
-    return;
+    rpc_failures_.increment();
+    logger_interface_->logThrottled(LogLevel::kError, "get_robot_state", kFailureLogPeriod,
+                                    std::string{"Failed to get robot_state: "}.append(robot_state_result.error()));
+    return false;
   }
 
   const auto& clock_skew = clock_skew_result.value();
   const auto& robot_state = robot_state_result.value();
 
-  const auto robot_state_messages =
-      RobotStateMessages{getBatteryStates(robot_state, clock_skew),
-                         getWifiState(robot_state),
-                         getFootState(robot_state),
-                         getEstopStates(robot_state, clock_skew),
-                         getJointStates(robot_state, clock_skew, frame_prefix_),
-                         getTf(robot_state, clock_skew, frame_prefix_, full_tf_root_id_),
-                         getOdomTwist(robot_state, clock_skew, is_using_vision_),
-                         getOdom(robot_state, clock_skew, frame_prefix_, is_using_vision_),
-                         getPowerState(robot_state, clock_skew),
-                         getSystemFaultState(robot_state, clock_skew),
-                         getManipulatorState(robot_state),
-                         getEndEffectorForce(robot_state, clock_skew, frame_prefix_),
-                         getBehaviorFaultState(robot_state, clock_skew)};
+  // Back to back requests can return the same state again if they are faster than the robot updates it.
+  const auto& acquisition_timestamp = robot_state.kinematic_state().acquisition_timestamp();
+  if (drop_repeated && acquisition_timestamp.seconds() == last_acquisition_timestamp_.seconds() &&
+      acquisition_timestamp.nanos() == last_acquisition_timestamp_.nanos()) {
+    repeated_states_dropped_.increment();
+    return true;
+  }
+  last_acquisition_timestamp_ = acquisition_timestamp;
+  // The conversion and publication of the robot state are traced as one stage, identified by its acquisition time.
+  const tracing::ScopedStage trace{tracing::kRobotStatePipeline, "publish", "",
+                                   static_cast<std::uint64_t>(toNanoseconds(acquisition_timestamp))};
+
+  // Only the topics which are due are converted, so slow status topics and topics without subscribers cost nothing on
+  // most robot states. If status topics are published on change, they are also skipped while their content is the same.
+  const auto now = std::chrono::steady_clock::now();
+
+  // The serialized robot state is published before the conversions, which are skipped entirely when only it is logged.
+  if (publish_raw_protobuf_ && isDue(Topic::kRaw, now)) {
+    middleware_handle_->publishRawRobotState(robot_state);
+  }
+  if (raw_protobuf_only_) {
+    publish_time_.record(std::chrono::steady_clock::now() - now);
+    return true;
+  }
+
+  // Other nodes wait for the transforms and the odometry in lookupTransform and their estimators, so they are converted
+  // and sent before anything else. The transforms are converted into a reused message, since TF is published with
+  // every robot state.
+  if (isDue(Topic::kTf, now) && robot_state.has_kinematic_state() &&
+      robot_state.kinematic_state().has_transforms_snapshot() &&
+      tf_converter_->convert(robot_state.kinematic_state().transforms_snapshot(),
+                             robot_state.kinematic_state().acquisition_timestamp(), clock_skew)) {
+    tf_broadcaster_interface_->sendDynamicTransforms(tf_converter_->message().transforms);
+  }
+  RobotStateMessages robot_state_messages;
+  if (isDue(Topic::kOdometryTwist, now)) {
+    robot_state_messages.maybe_odom_twist = getOdomTwist(robot_state, clock_skew, is_using_vision_);
+  }
+  if (isDue(Topic::kOdometry, now)) {
+    robot_state_messages.maybe_odom = getOdom(robot_state, clock_skew, frame_prefix_, is_using_vision_);
+  }
+  if (robot_state_messages.maybe_odom_twist || robot_state_messages.maybe_odom) {
+    middleware_handle_->publishOdometry(robot_state_messages);
+  }
+
+  if (robot_state_history_) {
+    if (const auto snapshot = makeRobotStateSnapshot(robot_state, clock_skew)) {
+      robot_state_history_->add(snapshot.value());
+    }
+  }
+
+  if (isDue(Topic::kBatteryStates, now) && hasChanged(Topic::kBatteryStates, robot_state, now)) {
+    robot_state_messages.maybe_battery_states = getBatteryStates(robot_state, clock_skew);
+  }
+  if (isDue(Topic::kWifi, now) && hasChanged(Topic::kWifi, robot_state, now)) {
+    robot_state_messages.maybe_wifi_state = getWifiState(robot_state);
+  }
+  if (isDue(Topic::kFeet, now)) {
+    robot_state_messages.maybe_foot_state = getFootState(robot_state);
+  }
+  if (isDue(Topic::kEStop, now) && hasChanged(Topic::kEStop, robot_state, now)) {
+    robot_state_messages.maybe_estop_states = getEstopStates(robot_state, clock_skew);
+  }
+  // The joint states are also published with every robot state, so their message is lent from joint_states_ and
+  // handed back after publishing, which keeps its vectors allocated. While the low-level stream of spot_ros2_control is
+  // relayed, its fresher joint states replace these, and their conversion is skipped.
+  if (!lowLevelJointStatesLive(now) && isDue(Topic::kJointStates, now)) {
+    robot_state_messages.maybe_joint_states.swap(joint_states_);
+    if (!robot_state_messages.maybe_joint_states) {
+      robot_state_messages.maybe_joint_states.emplace();
+    }
+    if (!joint_state_converter_->convert(robot_state, clock_skew, *robot_state_messages.maybe_joint_states)) {
+      // Keep the message for the next robot state, but do not publish it.
+      robot_state_messages.maybe_joint_states.swap(joint_states_);
+    }
+  }
+  if (isDue(Topic::kPowerStates, now) && hasChanged(Topic::kPowerStates, robot_state, now)) {
+    robot_state_messages.maybe_power_state = getPowerState(robot_state, clock_skew);
+  }
+  if (isDue(Topic::kSystemFaults, now) && hasChanged(Topic::kSystemFaults, robot_state, now)) {
+    robot_state_messages.maybe_system_fault_state = getSystemFaultState(robot_state, clock_skew);
+  }
+  if (isDue(Topic::kManipulationState, now)) {
+    robot_state_messages.maybe_manipulator_state = getManipulatorState(robot_state);
+  }
+  if (isDue(Topic::kEndEffectorForce, now)) {
+    robot_state_messages.maybe_end_effector_force = getEndEffectorForce(robot_state, clock_skew, frame_prefix_);
+  }
+  if (isDue(Topic::kBehaviorFaults, now) && hasChanged(Topic::kBehaviorFaults, robot_state, now)) {
+    robot_state_messages.maybe_behavior_fault_state = getBehaviorFaultState(robot_state, clock_skew);
+  }
 
   middleware_handle_->publishRobotState(robot_state_messages);
+  if (robot_state_messages.maybe_joint_states) {
+    joint_states_.swap(robot_state_messages.maybe_joint_states);
+  }
+  publish_time_.record(std::chrono::steady_clock::now() - now);
+
+  return true;
+}
+
+bool StatePublisher::isDue(Topic topic, std::chrono::steady_clock::time_point now) {
+  auto& rate = topic_rates_[static_cast<std::size_t>(topic)];
+  if (topic != Topic::kTf && !middleware_handle_->hasSubscribers(topic)) {
+    // Forget the last message, so that a new subscriber gets the status right away if it is published on change.
+    rate.fingerprint.reset();
+    return false;
+  }
+  if (now < rate.next_publish) {
+    return false;
+  }
+  // The status topics are decimated further while the link is degraded, since they also go out over the link to
+  // remote subscribers and rarely change.
+  auto period = rate.period;
+  if (link_degraded_ && isStatusTopic(topic)) {
+    const auto timer_period =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(kRobotStateCallbackPeriod);
+    period = std::max(period, timer_period) * degraded_rate_divisor_;
+  }
+  // Keep the messages on a fixed schedule, unless the publisher fell behind by more than a period.
+  rate.next_publish += period;
+  if (rate.next_publish <= now) {
+    rate.next_publish = now + period;
+  }
+  return true;
+}
+
+bool StatePublisher::hasChanged(Topic topic, const bosdyn::api::RobotState& robot_state,
+                                std::chrono::steady_clock::time_point now) {
+  if (!publish_status_on_change_) {
+    return true;
+  }
+  std::size_t current = 0;
+  switch (topic) {
+    case Topic::kBatteryStates:
+      current = fingerprintWithoutTimestamps(robot_state.battery_states());
+      break;
+    case Topic::kWifi:
+      current = fingerprintWithoutTimestamps(robot_state.comms_states());
+      break;
+    case Topic::kEStop:
+      current = fingerprintWithoutTimestamps(robot_state.estop_states());
+      break;
+    case Topic::kPowerStates: {
+      auto power_state = robot_state.power_state();
+      power_state.clear_timestamp();
+      current = fingerprint(power_state);
+      break;
+    }
+    case Topic::kSystemFaults:
+      current = fingerprint(robot_state.system_fault_state());
+      break;
+    case Topic::kBehaviorFaults:
+      current = fingerprint(robot_state.behavior_fault_state());
+      break;
+    default:
+      return true;
+  }
+  auto& rate = topic_rates_[static_cast<std::size_t>(topic)];
+  if (rate.fingerprint == current && now - rate.last_publish < status_heartbeat_period_) {
+    return false;
+  }
+  rate.fingerprint = current;
+  rate.last_publish = now;
+  return true;
+}
+
+void StatePublisher::getRobotStateAtTime(
+    const std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Request>& request,
+    const std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Response>& response) const {
+  const auto& stamp = request->stamp;
+  const auto snapshot = robot_state_history_->lookup(static_cast<std::int64_t>(stamp.sec) * kNanosecondsPerSecond +
+                                                     static_cast<std::int64_t>(stamp.nanosec));
+  if (!snapshot) {
+    response->success = false;
+    response->message = "The requested time is not within the robot state history.";
+    return;
+  }
+
+  response->odom_pose.header.stamp = stamp;
+  response->odom_pose.header.frame_id = frame_prefix_ + "odom";
+  response->odom_pose.pose = snapshot->odom_tform_body;
+  response->vision_pose.header.stamp = stamp;
+  response->vision_pose.header.frame_id = frame_prefix_ + "vision";
+  response->vision_pose.pose = snapshot->vision_tform_body;
+  response->odom_twist.header.stamp = stamp;
+  response->odom_twist.header.frame_id = frame_prefix_ + "odom";
+  response->odom_twist.twist = snapshot->body_velocity_in_odom;
 
-  if (robot_state_messages.maybe_tf) {
-    tf_broadcaster_interface_->sendDynamicTransforms(robot_state_messages.maybe_tf->transforms);
+  auto& joint_states = response->joint_states;
+  joint_states.header.stamp = stamp;
+  for (std::size_t index = 0; index < snapshot->joint_count; ++index) {
+    joint_states.name.push_back(frame_prefix_ + *snapshot->joint_names[index]);
+    joint_states.position.push_back(snapshot->joint_positions[index]);
+    joint_states.velocity.push_back(snapshot->joint_velocities[index]);
+    joint_states.effort.push_back(snapshot->joint_efforts[index]);
   }
+  response->success = true;
 }
 
 }  // namespace spot_ros2
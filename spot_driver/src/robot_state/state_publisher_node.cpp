@@ -1,6 +1,8 @@
 // Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
 
 #include <memory>
+#include <string>
+#include <vector>
 #include <spot_driver/robot_state/state_publisher.hpp>
 #include <spot_driver/robot_state/state_publisher_node.hpp>
 #include <utility>
@@ -12,6 +14,7 @@
 #include <spot_driver/interfaces/rclcpp_parameter_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_tf_broadcaster_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_wall_timer_interface.hpp>
+#include <spot_driver/metrics/metrics_middleware_handle.hpp>
 #include <spot_driver/robot_state/state_middleware_handle.hpp>
 
 namespace {
@@ -33,14 +36,28 @@ StatePublisherNode::StatePublisherNode(std::unique_ptr<NodeInterfaceBase> node_b
 }
 
 StatePublisherNode::StatePublisherNode(const rclcpp::NodeOptions& node_options) {
-  const auto node = std::make_shared<rclcpp::Node>("state_publisher", node_options);
-  node_base_interface_ = std::make_unique<RclcppNodeInterface>(node->get_node_base_interface());
-
-  auto mw_handle = std::make_unique<StateMiddlewareHandle>(node);
-  auto parameter_interface = std::make_unique<RclcppParameterInterface>(node);
-  auto logger_interface = std::make_unique<RclcppLoggerInterface>(node->get_logger());
-  auto tf_broadcaster_interface = std::make_unique<RclcppTfBroadcasterInterface>(node);
-  auto timer_interface = std::make_unique<RclcppWallTimerInterface>(node);
+  node_ = std::make_shared<rclcpp::Node>("state_publisher", node_options);
+  node_base_interface_ = std::make_unique<RclcppNodeInterface>(node_->get_node_base_interface());
+
+  auto parameter_interface = std::make_unique<RclcppParameterInterface>(node_);
+  auto logger_interface = std::make_unique<RclcppLoggerInterface>(node_->get_logger());
+  auto mw_handle = std::make_unique<StateMiddlewareHandle>(
+      node_, StateMiddlewareHandle::loadPublisherQoS(*parameter_interface, *logger_interface));
+  auto tf_broadcaster_interface = std::make_unique<RclcppTfBroadcasterInterface>(node_);
+  auto timer_interface = std::make_unique<RclcppWallTimerInterface>(node_);
+
+  // Composed nodes of the same robot share its registry, so each node only reports the group of metrics it records.
+  // The state timer, its services and the parameter callbacks share the state of the publisher, so they stay in the
+  // default callback group. The metrics are only read from the thread-safe registry, so their timer gets its own group
+  // and keeps publishing while the state timer waits for Spot.
+  metrics_registry_ = metrics::MetricsRegistry::getForRobot(parameter_interface->getSpotName());
+  metrics_publisher_ = std::make_unique<metrics::MetricsPublisher>(
+      metrics_registry_, std::vector<std::string>{"robot_state"}, "state_publisher: ",
+      metrics::makeMetricsPublisherOptions(*parameter_interface),
+      std::make_unique<metrics::MetricsMiddlewareHandle>(node_),
+      std::make_unique<RclcppLoggerInterface>(node_->get_logger()),
+      std::make_unique<RclcppWallTimerInterface>(
+          node_, node_->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive)));
 
   const auto timesync_timeout = parameter_interface->getTimeSyncTimeout();
   auto spot_api =
@@ -48,6 +65,20 @@ StatePublisherNode::StatePublisherNode(const rclcpp::NodeOptions& node_options)
 
   initialize(std::move(spot_api), std::move(mw_handle), std::move(parameter_interface), std::move(logger_interface),
              std::move(tf_broadcaster_interface), std::move(timer_interface));
+
+  // Invalid values are rejected when they are set, so that the running publisher is not replaced by one which fails to
+  // start. The callback is only added once every parameter was declared, so that declaring them does not run it.
+  set_parameters_callback_ = node_->add_on_set_parameters_callback(&RclcppParameterInterface::validateParameters);
+
+  // Parameters are only read when the publisher is created, so it is replaced after every change. Changes of the
+  // parameters of the connection, such as the hostname, only take effect when the node is restarted.
+  parameter_event_handler_ = std::make_shared<rclcpp::ParameterEventHandler>(node_);
+  parameter_event_callback_ = parameter_event_handler_->add_parameter_event_callback(
+      [this](const rcl_interfaces::msg::ParameterEvent& event) {
+        if (event.node == node_->get_fully_qualified_name() && !event.changed_parameters.empty()) {
+          reconfigure();
+        }
+      });
 }
 
 void StatePublisherNode::initialize(std::unique_ptr<SpotApi> spot_api,
@@ -77,10 +108,48 @@ void StatePublisherNode::initialize(std::unique_ptr<SpotApi> spot_api,
     throw std::runtime_error(error_msg);
   }
 
-  internal_ = std::make_unique<StatePublisher>(spot_api_->stateClientInterface(), spot_api_->timeSyncInterface(),
-                                               std::move(middleware_handle), std::move(parameter_interface),
-                                               std::move(logger_interface), std::move(tf_broadcaster_interface),
-                                               std::move(timer_interface));
+  internal_ = createPublisher(std::move(middleware_handle), std::move(parameter_interface), std::move(logger_interface),
+                              std::move(tf_broadcaster_interface), std::move(timer_interface));
+}
+
+std::unique_ptr<StatePublisher> StatePublisherNode::createPublisher(
+    std::unique_ptr<StatePublisher::MiddlewareHandle> middleware_handle,
+    std::unique_ptr<ParameterInterfaceBase> parameter_interface, std::unique_ptr<LoggerInterfaceBase> logger_interface,
+    std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
+    std::unique_ptr<TimerInterfaceBase> timer_interface) {
+  auto state_client = spot_api_->stateClientInterface();
+  if (state_client == nullptr) {
+    constexpr auto error_msg{"Failed to create the Spot API's robot state client, which is required to run this node."};
+    logger_interface->logError(error_msg);
+    throw std::runtime_error(error_msg);
+  }
+
+  return std::make_unique<StatePublisher>(state_client, spot_api_->timeSyncInterface(), std::move(middleware_handle),
+                                          std::move(parameter_interface), std::move(logger_interface),
+                                          std::move(tf_broadcaster_interface), std::move(timer_interface),
+                                          metrics_registry_);
+}
+
+void StatePublisherNode::reconfigure() {
+  const RclcppLoggerInterface logger{node_->get_logger()};
+  logger.logInfo("Parameters changed, recreating the robot state publishers.");
+  // The new publisher is created before the current one is destroyed, so that the current one is kept if it fails. Both
+  // briefly advertise the same topics and services, which ROS allows within a node.
+  std::unique_ptr<StatePublisher> publisher;
+  try {
+    auto parameter_interface = std::make_unique<RclcppParameterInterface>(node_);
+    auto logger_interface = std::make_unique<RclcppLoggerInterface>(node_->get_logger());
+    auto middleware_handle = std::make_unique<StateMiddlewareHandle>(
+        node_, StateMiddlewareHandle::loadPublisherQoS(*parameter_interface, *logger_interface));
+    publisher = createPublisher(std::move(middleware_handle), std::move(parameter_interface),
+                                std::move(logger_interface), std::make_unique<RclcppTfBroadcasterInterface>(node_),
+                                std::make_unique<RclcppWallTimerInterface>(node_));
+  } catch (const std::runtime_error&) {
+    // The error was logged by createPublisher().
+    logger.logWarn("Keeping the current robot state publisher, since the new one failed to start.");
+    return;
+  }
+  internal_ = std::move(publisher);
 }
 
 std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> StatePublisherNode::get_node_base_interface() {
@@ -1,6 +1,7 @@
 // Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
 
-#include <rclcpp/executors.hpp>
+#include <rclcpp/utilities.hpp>
+#include <spot_driver/interfaces/rclcpp_executor.hpp>
 #include <spot_driver/robot_state/state_publisher_node.hpp>
 
 int main(int argc, char* argv[]) {
@@ -8,8 +9,10 @@ int main(int argc, char* argv[]) {
 
   spot_ros2::StatePublisherNode node;
 
-  // Spins the node with the default single-threaded executor.
-  rclcpp::spin(node.get_node_base_interface());
+  // Spins the node with a single-threaded executor, unless another one is selected by the executor parameter. The
+  // metrics are published from their own callback group, so a multi-threaded executor keeps publishing them while the
+  // state timer waits for Spot.
+  spot_ros2::spinNode(node.get_node_base_interface(), spot_ros2::ExecutorType::SINGLE_THREADED);
 
   return 0;
 }
@@ -0,0 +1,7 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+// Defines the tracepoints and the probes of the spot_driver LTTng provider.
+
+#define TRACEPOINT_CREATE_PROBES
+#define TRACEPOINT_DEFINE
+#include "tracing/tracepoints.h"
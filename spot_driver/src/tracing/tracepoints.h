@@ -0,0 +1,34 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+// LTTng tracepoint provider of the driver. It is only compiled if lttng-ust is found, and is only included by
+// tracing.cpp and tracepoints.c.
+
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER spot_driver
+
+#undef TRACEPOINT_INCLUDE
+#define TRACEPOINT_INCLUDE "tracing/tracepoints.h"
+
+#if !defined(SPOT_DRIVER_TRACING_TRACEPOINTS_H_) || defined(TRACEPOINT_HEADER_MULTI_READ)
+#define SPOT_DRIVER_TRACING_TRACEPOINTS_H_
+
+#include <lttng/tracepoint.h>
+#include <stdint.h>
+
+TRACEPOINT_EVENT_CLASS(spot_driver, stage,
+                       TP_ARGS(const char*, pipeline_arg, const char*, stage_arg, const char*, source_arg, uint64_t,
+                               id_arg),
+                       TP_FIELDS(ctf_string(pipeline, pipeline_arg) ctf_string(stage, stage_arg)
+                                     ctf_string(source, source_arg) ctf_integer(uint64_t, id, id_arg)))
+
+TRACEPOINT_EVENT_INSTANCE(spot_driver, stage, stage_begin,
+                          TP_ARGS(const char*, pipeline_arg, const char*, stage_arg, const char*, source_arg, uint64_t,
+                                  id_arg))
+
+TRACEPOINT_EVENT_INSTANCE(spot_driver, stage, stage_end,
+                          TP_ARGS(const char*, pipeline_arg, const char*, stage_arg, const char*, source_arg, uint64_t,
+                                  id_arg))
+
+#endif  // SPOT_DRIVER_TRACING_TRACEPOINTS_H_
+
+#include <lttng/tracepoint-event.h>
@@ -0,0 +1,24 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/tracing.hpp>
+
+#ifdef SPOT_DRIVER_HAS_LTTNG
+#include "tracing/tracepoints.h"
+#endif
+
+namespace spot_ros2::tracing {
+
+#ifdef SPOT_DRIVER_HAS_LTTNG
+void stageBegin(const char* pipeline, const char* stage, const char* source, const std::uint64_t id) {
+  tracepoint(spot_driver, stage_begin, pipeline, stage, source, id);
+}
+
+void stageEnd(const char* pipeline, const char* stage, const char* source, const std::uint64_t id) {
+  tracepoint(spot_driver, stage_end, pipeline, stage, source, id);
+}
+#else
+void stageBegin(const char* /*pipeline*/, const char* /*stage*/, const char* /*source*/, const std::uint64_t /*id*/) {}
+
+void stageEnd(const char* /*pipeline*/, const char* /*stage*/, const char* /*source*/, const std::uint64_t /*id*/) {}
+#endif
+}  // namespace spot_ros2::tracing
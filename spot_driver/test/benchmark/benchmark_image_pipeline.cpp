@@ -0,0 +1,332 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+// Benchmarks of the stages that each image goes through between the GetImageResponse from Spot and its publication:
+// decoding, point cloud creation, and publishing. Each benchmark reports the time per frame and the number of heap
+// allocations per frame.
+//
+// By default, the benchmarks run on synthetic 640x480 images. To replay images which were recorded from a robot, set
+// the SPOT_IMAGE_BENCHMARK_FIXTURE environment variable to a file which contains a serialized GetImageResponse. The
+// first JPEG RGB, JPEG greyscale and raw depth image in the response are then used instead.
+
+#include <benchmark/benchmark.h>
+
+#include <bosdyn/api/image.pb.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <spot_driver/api/spot_image_sources.hpp>
+#include <spot_driver/conversions/decompress_images.hpp>
+#include <spot_driver/conversions/depth_point_cloud.hpp>
+#include <spot_driver/conversions/depth_ray_table.hpp>
+#include <spot_driver/conversions/jpeg_decoder.hpp>
+#include <spot_driver/images/images_middleware_handle.hpp>
+#include <spot_driver/types.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+std::atomic<std::size_t> allocation_count{0};
+}  // namespace
+
+// Count every heap allocation of the process, so that the benchmarks can report allocations per frame.
+void* operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t /*size*/) noexcept {
+  std::free(pointer);
+}
+
+namespace {
+constexpr int kSyntheticWidth = 640;
+constexpr int kSyntheticHeight = 480;
+constexpr int kSyntheticJpegQuality = 75;
+constexpr double kDepthScale = 1000.0;
+constexpr auto kFixtureEnvironmentVariable = "SPOT_IMAGE_BENCHMARK_FIXTURE";
+
+/** @brief Image captures which the benchmarks decode, one for each kind of image that Spot sends. */
+struct Fixtures {
+  bosdyn::api::ImageCapture rgb_jpeg;
+  bosdyn::api::ImageCapture greyscale_jpeg;
+  bosdyn::api::ImageCapture raw_depth;
+};
+
+/**
+ * @brief Create a synthetic image capture with a gradient, which compresses roughly like a camera image.
+ *
+ * @param pixel_format Pixel format of the image.
+ * @param format Format of the image data. Depth images are always raw.
+ * @return The image capture.
+ */
+bosdyn::api::ImageCapture createSyntheticCapture(const bosdyn::api::Image_PixelFormat pixel_format,
+                                                 const bosdyn::api::Image_Format format) {
+  bosdyn::api::ImageCapture capture;
+  capture.set_frame_name_image_sensor("frontleft_fisheye");
+  auto* image = capture.mutable_image();
+  image->set_cols(kSyntheticWidth);
+  image->set_rows(kSyntheticHeight);
+  image->set_pixel_format(pixel_format);
+  image->set_format(format);
+
+  if (pixel_format == bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_DEPTH_U16) {
+    cv::Mat depth(kSyntheticHeight, kSyntheticWidth, CV_16UC1);
+    for (int row = 0; row < depth.rows; ++row) {
+      for (int col = 0; col < depth.cols; ++col) {
+        // Leave every 8th pixel without depth, like the invalid pixels of a real depth image.
+        depth.at<std::uint16_t>(row, col) = (col % 8 == 0) ? 0 : static_cast<std::uint16_t>(500 + row * 8 + col);
+      }
+    }
+    image->set_data(depth.data, depth.total() * depth.elemSize());
+    return capture;
+  }
+
+  const auto channels = pixel_format == bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_RGB_U8 ? 3 : 1;
+  cv::Mat pixels(kSyntheticHeight, kSyntheticWidth, CV_8UC(channels));
+  for (int row = 0; row < pixels.rows; ++row) {
+    auto* data = pixels.ptr<std::uint8_t>(row);
+    for (int col = 0; col < pixels.cols * channels; ++col) {
+      data[col] = static_cast<std::uint8_t>((row + col) % 256);
+    }
+  }
+  std::vector<std::uint8_t> jpeg;
+  cv::imencode(".jpg", pixels, jpeg, {cv::IMWRITE_JPEG_QUALITY, kSyntheticJpegQuality});
+  image->set_data(jpeg.data(), jpeg.size());
+  return capture;
+}
+
+/**
+ * @brief Load the image captures from the recorded fixture, if one is set, or create synthetic ones.
+ * @details Kinds of images which the recorded response does not contain are replaced by synthetic ones.
+ */
+Fixtures loadFixtures() {
+  Fixtures fixtures{
+      createSyntheticCapture(bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_RGB_U8, bosdyn::api::Image_Format_FORMAT_JPEG),
+      createSyntheticCapture(bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_GREYSCALE_U8,
+                             bosdyn::api::Image_Format_FORMAT_JPEG),
+      createSyntheticCapture(bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_DEPTH_U16,
+                             bosdyn::api::Image_Format_FORMAT_RAW)};
+
+  const char* fixture_path = std::getenv(kFixtureEnvironmentVariable);
+  if (fixture_path == nullptr) {
+    return fixtures;
+  }
+  std::ifstream file{fixture_path, std::ios::binary};
+  bosdyn::api::GetImageResponse response;
+  if (!file || !response.ParseFromIstream(&file)) {
+    std::fprintf(stderr, "Failed to read a GetImageResponse from %s. Using synthetic images.\n", fixture_path);
+    return fixtures;
+  }
+
+  bool has_rgb = false;
+  bool has_greyscale = false;
+  bool has_depth = false;
+  for (const auto& image_response : response.image_responses()) {
+    const auto& image = image_response.shot().image();
+    if (!has_rgb && image.format() == bosdyn::api::Image_Format_FORMAT_JPEG &&
+        image.pixel_format() == bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_RGB_U8) {
+      fixtures.rgb_jpeg = image_response.shot();
+      has_rgb = true;
+    } else if (!has_greyscale && image.format() == bosdyn::api::Image_Format_FORMAT_JPEG &&
+               image.pixel_format() == bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_GREYSCALE_U8) {
+      fixtures.greyscale_jpeg = image_response.shot();
+      has_greyscale = true;
+    } else if (!has_depth && image.format() == bosdyn::api::Image_Format_FORMAT_RAW &&
+               image.pixel_format() == bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_DEPTH_U16) {
+      fixtures.raw_depth = image_response.shot();
+      has_depth = true;
+    }
+  }
+  return fixtures;
+}
+
+const Fixtures& getFixtures() {
+  static const Fixtures fixtures = loadFixtures();
+  return fixtures;
+}
+
+/** @brief Create pinhole intrinsics for an image, centered on the image with a 90 degree horizontal field of view. */
+sensor_msgs::msg::CameraInfo createCameraInfo(const sensor_msgs::msg::Image& image) {
+  sensor_msgs::msg::CameraInfo info;
+  info.header = image.header;
+  info.width = image.width;
+  info.height = image.height;
+  const auto focal_length = image.width / 2.0;
+  info.k = {focal_length, 0.0, image.width / 2.0, 0.0, focal_length, image.height / 2.0, 0.0, 0.0, 1.0};
+  return info;
+}
+
+/**
+ * @brief Report the number of heap allocations per frame since the start of the timed loop.
+ *
+ * @param state State of the benchmark.
+ * @param allocations_at_start Allocation count when the timed loop started.
+ */
+void reportAllocations(benchmark::State& state, const std::size_t allocations_at_start) {
+  state.counters["allocs/frame"] =
+      benchmark::Counter(static_cast<double>(allocation_count.load() - allocations_at_start),
+                         benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Decode an image capture into a message which is reused across frames, like the message pool of the image
+ * client does.
+ */
+void decodeCapture(benchmark::State& state, const bosdyn::api::ImageCapture& capture,
+                   const spot_ros2::JpegDecoderBackend backend) {
+  if (!spot_ros2::isJpegDecoderBackendAvailable(backend)) {
+    state.SkipWithError("The JPEG decoder backend is not available in this build.");
+    return;
+  }
+  std_msgs::msg::Header header;
+  header.frame_id = capture.frame_name_image_sensor();
+  sensor_msgs::msg::Image image;
+  const auto allocations_at_start = allocation_count.load();
+  for (auto _ : state) {
+    if (const auto result = spot_ros2::getDecompressImageMsg(capture, header, image, backend); !result) {
+      state.SkipWithError(result.error().c_str());
+      return;
+    }
+    benchmark::DoNotOptimize(image.data.data());
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(image.data.size()));
+  reportAllocations(state, allocations_at_start);
+}
+
+void BM_DecodeRgbJpegOpenCv(benchmark::State& state) {
+  decodeCapture(state, getFixtures().rgb_jpeg, spot_ros2::JpegDecoderBackend::OPENCV);
+}
+BENCHMARK(BM_DecodeRgbJpegOpenCv);
+
+void BM_DecodeRgbJpegTurboJpeg(benchmark::State& state) {
+  decodeCapture(state, getFixtures().rgb_jpeg, spot_ros2::JpegDecoderBackend::TURBOJPEG);
+}
+BENCHMARK(BM_DecodeRgbJpegTurboJpeg);
+
+void BM_DecodeGreyscaleJpegOpenCv(benchmark::State& state) {
+  decodeCapture(state, getFixtures().greyscale_jpeg, spot_ros2::JpegDecoderBackend::OPENCV);
+}
+BENCHMARK(BM_DecodeGreyscaleJpegOpenCv);
+
+void BM_DecodeGreyscaleJpegTurboJpeg(benchmark::State& state) {
+  decodeCapture(state, getFixtures().greyscale_jpeg, spot_ros2::JpegDecoderBackend::TURBOJPEG);
+}
+BENCHMARK(BM_DecodeGreyscaleJpegTurboJpeg);
+
+void BM_DecodeRawDepth(benchmark::State& state) {
+  decodeCapture(state, getFixtures().raw_depth, spot_ros2::JpegDecoderBackend::OPENCV);
+}
+BENCHMARK(BM_DecodeRawDepth);
+
+void BM_CreatePointCloud(benchmark::State& state) {
+  sensor_msgs::msg::Image depth;
+  const auto& capture = getFixtures().raw_depth;
+  std_msgs::msg::Header header;
+  header.frame_id = capture.frame_name_image_sensor();
+  if (const auto result =
+          spot_ros2::getDecompressImageMsg(capture, header, depth, spot_ros2::JpegDecoderBackend::OPENCV);
+      !result) {
+    state.SkipWithError(result.error().c_str());
+    return;
+  }
+  const auto info = createCameraInfo(depth);
+  // The image client keeps the ray table of each camera, so building it is not part of the per-frame cost.
+  const spot_ros2::DepthRayTable rays{info};
+  spot_ros2::PointCloudOptions options;
+  options.voxel_size = static_cast<double>(state.range(0)) / 100.0;
+  sensor_msgs::msg::PointCloud2 cloud;
+  const auto allocations_at_start = allocation_count.load();
+  for (auto _ : state) {
+    if (const auto result = spot_ros2::createPointCloud(depth, info, rays, kDepthScale, options, cloud); !result) {
+      state.SkipWithError(result.error().c_str());
+      return;
+    }
+    benchmark::DoNotOptimize(cloud.data.data());
+  }
+  reportAllocations(state, allocations_at_start);
+}
+// Without decimation, and with 5 cm voxels.
+BENCHMARK(BM_CreatePointCloud)->Arg(0)->Arg(5);
+
+/**
+ * @brief Publish a decoded image with its camera info through the middleware handle, with one subscriber in another
+ * node so that the message is serialized like it is on a robot.
+ */
+void publishImage(benchmark::State& state, const bosdyn::api::ImageCapture& capture) {
+  const spot_ros2::ImageSource source{spot_ros2::SpotCamera::FRONTLEFT, spot_ros2::SpotImageType::RGB};
+  auto node = std::make_shared<rclcpp::Node>("benchmark_image_publisher");
+  spot_ros2::images::ImagesMiddlewareHandle middleware_handle{node};
+  spot_ros2::images::PublisherOptions options;
+  options.uncompress_images = true;
+  middleware_handle.createPublishers({source}, options);
+
+  auto subscriber_node = std::make_shared<rclcpp::Node>("benchmark_image_subscriber");
+  const auto subscription = subscriber_node->create_subscription<sensor_msgs::msg::Image>(
+      spot_ros2::toRosTopic(source) + "/image", rclcpp::SensorDataQoS{}, [](const sensor_msgs::msg::Image&) {});
+
+  std::vector<std::pair<spot_ros2::ImageSource, spot_ros2::ImageWithCameraInfo>> images(1);
+  images.front().first = source;
+  auto& image = images.front().second;
+  std_msgs::msg::Header header;
+  header.frame_id = capture.frame_name_image_sensor();
+  if (const auto result = spot_ros2::getDecompressImageMsg(capture, header, image.image,
+                                                           spot_ros2::JpegDecoderBackend::OPENCV);
+      !result) {
+    state.SkipWithError(result.error().c_str());
+    return;
+  }
+  image.info = createCameraInfo(image.image);
+  std::vector<std::pair<spot_ros2::ImageSource, spot_ros2::CompressedImageWithCameraInfo>> compressed_images;
+
+  const auto allocations_at_start = allocation_count.load();
+  for (auto _ : state) {
+    if (const auto result = middleware_handle.publishImages(images, compressed_images); !result) {
+      state.SkipWithError(result.error().c_str());
+      return;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(image.image.data.size()));
+  reportAllocations(state, allocations_at_start);
+}
+
+void BM_PublishRgbImage(benchmark::State& state) {
+  publishImage(state, getFixtures().rgb_jpeg);
+}
+BENCHMARK(BM_PublishRgbImage);
+
+void BM_PublishDepthImage(benchmark::State& state) {
+  publishImage(state, getFixtures().raw_depth);
+}
+BENCHMARK(BM_PublishDepthImage);
+}  // namespace
+
+int main(int argc, char** argv) {
+  rclcpp::init(argc, argv);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  rclcpp::shutdown();
+  return 0;
+}
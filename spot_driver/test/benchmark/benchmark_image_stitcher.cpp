@@ -0,0 +1,182 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+// Benchmarks of the MiddleCamera which stitches the two front cameras into one virtual camera. Each benchmark reports
+// the time per frame and the mean time per frame of every stage of the stitching pipeline.
+//
+// By default, the benchmarks stitch synthetic 640x480 images. To stitch images which were recorded from a robot, set
+// the SPOT_STITCHER_BENCHMARK_LEFT and SPOT_STITCHER_BENCHMARK_RIGHT environment variables to image files of the left
+// and right front cameras. The toy camera geometry is used in both cases, so only the cost of stitching is
+// representative, not the stitched image.
+
+#include <benchmark/benchmark.h>
+
+#include <cv_bridge/cv_bridge.h>
+#include <geometry_msgs/msg/transform.hpp>
+#include <opencv2/core.hpp>
+#include <opencv2/core/ocl.hpp>
+#include <opencv2/core/quaternion.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <sensor_msgs/image_encodings.hpp>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/image_stitcher/image_stitcher.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+namespace {
+constexpr int kSyntheticWidth = 640;
+constexpr int kSyntheticHeight = 480;
+constexpr double kFocalLength = 385.0;
+constexpr double kCameraYaw = 0.3;
+constexpr double kCameraOffset = 0.05;
+constexpr double kPlaneDistance = 2.0;
+constexpr auto kLeftFixtureEnvironmentVariable = "SPOT_STITCHER_BENCHMARK_LEFT";
+constexpr auto kRightFixtureEnvironmentVariable = "SPOT_STITCHER_BENCHMARK_RIGHT";
+
+/** @brief Configurations of the stitcher which are benchmarked. */
+struct StitchOptions {
+  spot_ros2::StitchBlendMode blend_mode;
+  int seam_update_period;
+};
+
+/**
+ * @brief Load an image from the file in an environment variable, if it is set, or create a synthetic image with random
+ * noise, which is the worst case for the seam finder.
+ */
+cv::Mat loadImage(const char* environment_variable, const int seed) {
+  if (const char* path = std::getenv(environment_variable); path != nullptr) {
+    auto image = cv::imread(path, cv::IMREAD_COLOR);
+    if (!image.empty()) {
+      cv::resize(image, image, cv::Size{kSyntheticWidth, kSyntheticHeight});
+      return image;
+    }
+    std::fprintf(stderr, "Failed to read an image from %s. Using a synthetic image.\n", path);
+  }
+  cv::Mat image{kSyntheticHeight, kSyntheticWidth, CV_8UC3};
+  cv::RNG rng{static_cast<std::uint64_t>(seed)};
+  rng.fill(image, cv::RNG::UNIFORM, 0, 256);
+  return image;
+}
+
+/** @brief Create pinhole intrinsics for a front camera, centered on the image. */
+sensor_msgs::msg::CameraInfo createCameraInfo(const std::string& frame) {
+  sensor_msgs::msg::CameraInfo info;
+  info.header.frame_id = frame;
+  info.width = kSyntheticWidth;
+  info.height = kSyntheticHeight;
+  info.k = {kFocalLength, 0.0, kSyntheticWidth / 2.0, 0.0, kFocalLength, kSyntheticHeight / 2.0, 0.0, 0.0, 1.0};
+  return info;
+}
+
+/**
+ * @brief Create the transform from the body to a forward-looking camera.
+ *
+ * @param side 1 for the left camera, which is offset to the left and yawed to the left, and -1 for the right camera.
+ */
+geometry_msgs::msg::Transform createBodyTformCamera(const double side) {
+  // Rotation of the optical frame, whose z axis looks along the x axis of the body, x axis points right and y axis
+  // points down
+  const cv::Matx33d body_r_optical{0., 0., 1., -1., 0., 0., 0., -1., 0.};
+  const double yaw = side * kCameraYaw;
+  const cv::Matx33d body_r_yawed{std::cos(yaw), -std::sin(yaw), 0., std::sin(yaw), std::cos(yaw), 0., 0., 0., 1.};
+  const auto q = cv::Quatd::createFromRotMat(body_r_yawed * body_r_optical);
+  geometry_msgs::msg::Transform tf;
+  tf.rotation.w = q.w;
+  tf.rotation.x = q.x;
+  tf.rotation.y = q.y;
+  tf.rotation.z = q.z;
+  tf.translation.y = side * kCameraOffset;
+  return tf;
+}
+
+/**
+ * @brief Stitch the same pair of images every iteration, and report the mean duration of every stage in milliseconds.
+ * @details The first argument of the benchmark is 1 to run the pipeline through OpenCL, and 0 to run it on the CPU.
+ */
+void stitchImages(benchmark::State& state, const StitchOptions& options) {
+  const bool use_gpu = state.range(0) != 0;
+  cv::ocl::setUseOpenCL(use_gpu);
+  if (use_gpu && !cv::ocl::useOpenCL()) {
+    state.SkipWithError("No OpenCL device is available.");
+    return;
+  }
+  const auto info_left = createCameraInfo("frontleft");
+  const auto info_right = createCameraInfo("frontright");
+  const cv::Matx33d virtual_intrinsics{kFocalLength, 0., kSyntheticWidth / 2.0, 0., kFocalLength,
+                                       kSyntheticHeight / 2.0, 0., 0., 1.};
+  spot_ros2::MiddleCamera camera{virtual_intrinsics,
+                                 cv::Vec3d{0., 0., 1.},
+                                 kPlaneDistance,
+                                 0,
+                                 options.seam_update_period,
+                                 options.blend_mode,
+                                 50,
+                                 use_gpu,
+                                 spot_ros2::JpegDecoderBackend::OPENCV,
+                                 true,
+                                 createBodyTformCamera(1.0),
+                                 createBodyTformCamera(-1.0),
+                                 info_left,
+                                 info_right};
+
+  const std::shared_ptr<const sensor_msgs::msg::Image> left =
+      cv_bridge::CvImage{info_left.header, sensor_msgs::image_encodings::BGR8,
+                         loadImage(kLeftFixtureEnvironmentVariable, 1)}
+          .toImageMsg();
+  const std::shared_ptr<const sensor_msgs::msg::Image> right =
+      cv_bridge::CvImage{info_right.header, sensor_msgs::image_encodings::BGR8,
+                         loadImage(kRightFixtureEnvironmentVariable, 2)}
+          .toImageMsg();
+
+  spot_ros2::StitchStageDurations total;
+  for (auto _ : state) {
+    const auto& stitched = camera.stitch(left, right);
+    benchmark::DoNotOptimize(stitched.data.data());
+    const auto& durations = camera.getStageDurations();
+    total.decode += durations.decode;
+    total.warp += durations.warp;
+    total.compensate += durations.compensate;
+    total.seam_convert += durations.seam_convert;
+    total.seam += durations.seam;
+    total.blend_convert += durations.blend_convert;
+    total.blend += durations.blend;
+    total.output += durations.output;
+  }
+  const auto report = [&state](const std::string& stage, const double seconds) {
+    state.counters[stage + " (ms)"] = benchmark::Counter(seconds * 1000.0, benchmark::Counter::kAvgIterations);
+  };
+  report("decode", total.decode);
+  report("warp", total.warp);
+  report("compensate", total.compensate);
+  report("seam_convert", total.seam_convert);
+  report("seam", total.seam);
+  report("blend_convert", total.blend_convert);
+  report("blend", total.blend);
+  report("output", total.output);
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_StitchMultiBand(benchmark::State& state) {
+  stitchImages(state, StitchOptions{spot_ros2::StitchBlendMode::kMultiBand, 1});
+}
+BENCHMARK(BM_StitchMultiBand)->Arg(0)->Arg(1);
+
+void BM_StitchFeather(benchmark::State& state) {
+  stitchImages(state, StitchOptions{spot_ros2::StitchBlendMode::kFeather, 1});
+}
+BENCHMARK(BM_StitchFeather)->Arg(0)->Arg(1);
+
+// The gains and seams are only computed on the first frame, which is the cost of a frame in between seam updates.
+void BM_StitchFeatherCachedSeams(benchmark::State& state) {
+  stitchImages(state, StitchOptions{spot_ros2::StitchBlendMode::kFeather, 0});
+}
+BENCHMARK(BM_StitchFeatherCachedSeams)->Arg(0)->Arg(1);
+}  // namespace
+
+BENCHMARK_MAIN();
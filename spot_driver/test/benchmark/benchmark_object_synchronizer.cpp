@@ -0,0 +1,344 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+// Benchmarks of the two timer callbacks of the ObjectSynchronizer on large synthetic worlds: the sync of the TF frames
+// of other nodes into Spot's world model, and the broadcast of the TF frames of Spot's world objects. Spot and the TF
+// tree are replaced by fakes which answer instantly, so that the benchmarks measure the ObjectSynchronizer itself. Each
+// benchmark reports the time per cycle and the number of heap allocations per cycle.
+//
+// The first argument of each benchmark is the number of fiducials in Spot's world model, and the second one is the
+// number of them which are detected again before every cycle, like fiducials which stay in view. The third argument is
+// the number of TF frames of other nodes, which the sync adds to Spot's world model as drawable objects.
+
+#include <benchmark/benchmark.h>
+
+#include <bosdyn/api/world_object.pb.h>
+#include <google/protobuf/duration.pb.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <rcl/time.h>
+#include <rclcpp/time.hpp>
+#include <spot_driver/api/time_sync_api.hpp>
+#include <spot_driver/api/world_object_client_interface.hpp>
+#include <spot_driver/fake/fake_parameter_interface.hpp>
+#include <spot_driver/interfaces/clock_interface_base.hpp>
+#include <spot_driver/interfaces/logger_interface_base.hpp>
+#include <spot_driver/interfaces/tf_broadcaster_interface_base.hpp>
+#include <spot_driver/interfaces/tf_listener_interface_base.hpp>
+#include <spot_driver/interfaces/timer_interface_base.hpp>
+#include <spot_driver/object_sync/object_synchronizer.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+std::atomic<std::size_t> allocation_count{0};
+}  // namespace
+
+// Count every heap allocation of the process, so that the benchmarks can report allocations per cycle.
+void* operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t /*size*/) noexcept {
+  std::free(pointer);
+}
+
+namespace {
+constexpr auto kSpotName = "Spot";
+constexpr std::array kSpotFrames{"Spot/body", "Spot/odom", "Spot/vision", "Spot/hand", "Spot/head"};
+
+bool isLater(const google::protobuf::Timestamp& lhs, const google::protobuf::Timestamp& rhs) {
+  return lhs.seconds() > rhs.seconds() || (lhs.seconds() == rhs.seconds() && lhs.nanos() > rhs.nanos());
+}
+
+/** @brief Add an edge with a pure translation along x to a frame tree snapshot. */
+void addEdge(bosdyn::api::FrameTreeSnapshot& snapshot, const std::string& child, const std::string& parent,
+             const double x) {
+  auto& edge = (*snapshot.mutable_child_to_parent_edge_map())[child];
+  edge.set_parent_frame_name(parent);
+  edge.mutable_parent_tform_child()->mutable_position()->set_x(x);
+  edge.mutable_parent_tform_child()->mutable_rotation()->set_w(1.0);
+}
+
+/** @brief Create a fiducial world object whose frame tree holds the frames which Spot reports for a fiducial. */
+bosdyn::api::WorldObject createFiducial(const std::size_t index) {
+  const auto tag = std::to_string(index);
+  bosdyn::api::WorldObject object;
+  object.set_id(static_cast<std::int32_t>(index) + 1);
+  object.set_name("world_obj_apriltag_" + tag);
+  object.mutable_acquisition_time()->set_seconds(1);
+  object.mutable_apriltag_properties()->set_tag_id(static_cast<std::int32_t>(index));
+  auto& snapshot = *object.mutable_transforms_snapshot();
+  (*snapshot.mutable_child_to_parent_edge_map())["body"];
+  addEdge(snapshot, "odom", "body", 1.0);
+  addEdge(snapshot, "vision", "body", 1.5);
+  addEdge(snapshot, "fiducial_" + tag, "vision", 0.1 * static_cast<double>(index));
+  addEdge(snapshot, "filtered_fiducial_" + tag, "vision", 0.1 * static_cast<double>(index));
+  return object;
+}
+
+/**
+ * @brief Spot's world model, which lists its objects and applies mutations instantly. Listing the objects copies them,
+ * like parsing a response would, so the time includes these copies.
+ */
+class FakeWorldObjectClient : public spot_ros2::WorldObjectClientInterface {
+ public:
+  explicit FakeWorldObjectClient(const std::size_t fiducials) {
+    objects_.reserve(fiducials);
+    for (std::size_t index = 0; index < fiducials; ++index) {
+      objects_.push_back(createFiducial(index));
+    }
+    next_id_ = static_cast<std::int32_t>(fiducials) + 1;
+  }
+
+  /** @brief Detect the first fiducials again, which updates their acquisition time. */
+  void redetect(const std::size_t count) {
+    ++time_;
+    for (std::size_t index = 0; index < count && index < objects_.size(); ++index) {
+      objects_[index].mutable_acquisition_time()->set_seconds(time_);
+    }
+  }
+
+  tl::expected<bosdyn::api::ListWorldObjectResponse, std::string> listWorldObjects(
+      bosdyn::api::ListWorldObjectRequest& request, std::chrono::duration<double> /*timeout*/) const override {
+    bosdyn::api::ListWorldObjectResponse response;
+    for (const auto& object : objects_) {
+      const auto type = object.drawable_properties_size() > 0 ? bosdyn::api::WORLD_OBJECT_DRAWABLE
+                                                              : bosdyn::api::WORLD_OBJECT_APRILTAG;
+      const auto& types = request.object_type();
+      if (!types.empty() && std::find(types.begin(), types.end(), type) == types.end()) {
+        continue;
+      }
+      if (request.has_timestamp_filter() && !isLater(object.acquisition_time(), request.timestamp_filter())) {
+        continue;
+      }
+      *response.add_world_objects() = object;
+    }
+    return response;
+  }
+
+  tl::expected<bosdyn::api::MutateWorldObjectResponse, std::string> mutateWorldObject(
+      bosdyn::api::MutateWorldObjectRequest& request, std::chrono::duration<double> /*timeout*/) const override {
+    auto object = request.mutation().object();
+    bosdyn::api::MutateWorldObjectResponse response;
+    response.set_status(bosdyn::api::MutateWorldObjectResponse_Status_STATUS_OK);
+    if (request.mutation().action() == bosdyn::api::MutateWorldObjectRequest_Action_ACTION_ADD) {
+      object.set_id(next_id_++);
+      response.set_mutated_object_id(object.id());
+      drawable_indices_.emplace(object.id(), objects_.size());
+      objects_.push_back(std::move(object));
+    } else {
+      response.set_mutated_object_id(object.id());
+      objects_[drawable_indices_.at(object.id())] = std::move(object);
+    }
+    return response;
+  }
+
+ private:
+  mutable std::vector<bosdyn::api::WorldObject> objects_;
+  /** @brief Index in objects_ of every drawable object, by its ID. */
+  mutable std::map<std::int32_t, std::size_t> drawable_indices_;
+  mutable std::int32_t next_id_{1};
+  std::int64_t time_{1};
+};
+
+/** @brief Clock whose time only moves when the benchmark advances it. */
+class FakeClock : public spot_ros2::ClockInterfaceBase {
+ public:
+  explicit FakeClock(std::shared_ptr<const std::int32_t> seconds) : seconds_{std::move(seconds)} {}
+  rclcpp::Time now() override { return rclcpp::Time{*seconds_, 0, RCL_ROS_TIME}; }
+
+ private:
+  std::shared_ptr<const std::int32_t> seconds_;
+};
+
+/**
+ * @brief TF tree with Spot's frames and the frames of other nodes. Every frame is received again before each sync,
+ * like frames which are broadcast at a high rate, and its transform does not change.
+ */
+class FakeTfListener : public spot_ros2::TfListenerInterfaceBase {
+ public:
+  FakeTfListener(const std::size_t external_frames, std::shared_ptr<const std::int32_t> seconds)
+      : seconds_{std::move(seconds)} {
+    frames_.assign(kSpotFrames.begin(), kSpotFrames.end());
+    for (std::size_t index = 0; index < external_frames; ++index) {
+      frames_.push_back("external_frame_" + std::to_string(index));
+    }
+  }
+
+  std::vector<std::string> getAllFrameNames() const override { return frames_; }
+
+  tl::expected<geometry_msgs::msg::TransformStamped, std::string> lookupTransform(
+      const std::string& parent, const std::string& child, const rclcpp::Time& /*timepoint*/) const override {
+    geometry_msgs::msg::TransformStamped transform;
+    transform.header.stamp = rclcpp::Time{*seconds_, 0, RCL_ROS_TIME};
+    transform.header.frame_id = parent;
+    transform.child_frame_id = child;
+    transform.transform.translation.x = 1.0;
+    transform.transform.rotation.w = 1.0;
+    return transform;
+  }
+
+ private:
+  std::vector<std::string> frames_;
+  std::shared_ptr<const std::int32_t> seconds_;
+};
+
+class FakeTimeSyncApi : public spot_ros2::TimeSyncApi {
+ public:
+  tl::expected<google::protobuf::Duration, std::string> getClockSkew() override { return google::protobuf::Duration{}; }
+};
+
+class FakeLogger : public spot_ros2::LoggerInterfaceBase {
+ public:
+  void logDebug(const std::string&) const override {}
+  void logInfo(const std::string&) const override {}
+  void logWarn(const std::string&) const override {}
+  void logError(const std::string&) const override {}
+  void logFatal(const std::string&) const override {}
+};
+
+class FakeTfBroadcaster : public spot_ros2::TfBroadcasterInterfaceBase {
+ public:
+  void updateStaticTransforms(const std::vector<geometry_msgs::msg::TransformStamped>&) override {}
+  void sendDynamicTransforms(const std::vector<geometry_msgs::msg::TransformStamped>& transforms) override {
+    benchmark::DoNotOptimize(transforms.data());
+  }
+};
+
+/** @brief Keeps the callback of a timer, so that the benchmark can trigger it. */
+class FakeTimer : public spot_ros2::TimerInterfaceBase {
+ public:
+  explicit FakeTimer(std::function<void()>& callback) : callback_{callback} {}
+  void setTimer(const std::chrono::duration<double>&, const std::function<void()>& callback) override {
+    callback_ = callback;
+  }
+  void clearTimer() override {}
+
+ private:
+  std::function<void()>& callback_;
+};
+
+/** @brief Exposes the sync of the ObjectSynchronizer, whose timer is disabled. */
+class ObjectSynchronizerForBenchmark : public spot_ros2::ObjectSynchronizer {
+ public:
+  using ObjectSynchronizer::ObjectSynchronizer;
+  using ObjectSynchronizer::syncWorldObjects;
+};
+
+/** @brief An ObjectSynchronizer with its fake Spot and TF tree, whose time moves by one second per cycle. */
+struct World {
+  explicit World(const benchmark::State& state)
+      : seconds{std::make_shared<std::int32_t>(1)},
+        world_object_client{std::make_shared<FakeWorldObjectClient>(static_cast<std::size_t>(state.range(0)))},
+        redetected{static_cast<std::size_t>(state.range(1))} {
+    auto parameter_interface = std::make_unique<spot_ros2::test::FakeParameterInterface>();
+    parameter_interface->spot_name = kSpotName;
+    synchronizer = std::make_unique<ObjectSynchronizerForBenchmark>(
+        world_object_client, std::make_shared<FakeTimeSyncApi>(), std::move(parameter_interface),
+        std::make_unique<FakeLogger>(), std::make_unique<FakeTfBroadcaster>(),
+        std::make_unique<FakeTfListener>(static_cast<std::size_t>(state.range(2)), seconds),
+        std::make_unique<FakeTimer>(sync_callback), std::make_unique<FakeTimer>(broadcast_callback),
+        std::make_unique<FakeClock>(seconds));
+  }
+
+  /** @brief Advance the time by one second and detect the fiducials which stay in view again. */
+  void advance() {
+    ++*seconds;
+    world_object_client->redetect(redetected);
+  }
+
+  std::shared_ptr<std::int32_t> seconds;
+  std::shared_ptr<FakeWorldObjectClient> world_object_client;
+  std::size_t redetected;
+  std::function<void()> sync_callback;
+  std::function<void()> broadcast_callback;
+  std::unique_ptr<ObjectSynchronizerForBenchmark> synchronizer;
+};
+
+/**
+ * @brief Report the number of heap allocations per cycle since the start of the timed loop.
+ *
+ * @param state State of the benchmark.
+ * @param allocations_at_start Allocation count when the timed loop started.
+ */
+void reportAllocations(benchmark::State& state, const std::size_t allocations_at_start) {
+  state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocation_count.load() - allocations_at_start),
+                                                   benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations());
+}
+
+// A small world, a room full of fiducials, and a large world model with a large TF tree.
+void worldArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"objects", "redetected", "tf_frames"})
+      ->Args({10, 2, 20})
+      ->Args({100, 20, 200})
+      ->Args({500, 50, 1000})
+      ->Args({500, 50, 5000});
+}
+
+/**
+ * @brief Sync the TF tree into Spot's world model once per second. The time includes the lists of the world objects
+ * and the mutations which the fake world object client answers, as well as the periodic full list of the objects and
+ * the periodic refresh of the objects of frames which did not move.
+ */
+void BM_SyncWorldObjects(benchmark::State& state) {
+  World world{state};
+  // The first sync adds an object for every frame, so it is not part of the steady state.
+  world.synchronizer->syncWorldObjects();
+  const auto allocations_at_start = allocation_count.load();
+  for (auto _ : state) {
+    world.advance();
+    world.synchronizer->syncWorldObjects();
+  }
+  reportAllocations(state, allocations_at_start);
+}
+BENCHMARK(BM_SyncWorldObjects)->Apply(worldArguments);
+
+/**
+ * @brief Broadcast the TF frames of Spot's world objects, which happens ten times per second. Before the timed loop,
+ * a sync adds the frames of other nodes to Spot's world model, which the broadcast then skips as managed frames. The
+ * time includes the periodic full list of the world objects.
+ */
+void BM_BroadcastWorldObjectTransforms(benchmark::State& state) {
+  World world{state};
+  if (!world.broadcast_callback) {
+    state.SkipWithError("The ObjectSynchronizer did not set a broadcast timer.");
+    return;
+  }
+  world.synchronizer->syncWorldObjects();
+  // The first broadcast lists every object and fills the buffers which are reused, so it is not part of the steady
+  // state.
+  world.broadcast_callback();
+  const auto allocations_at_start = allocation_count.load();
+  for (auto _ : state) {
+    world.advance();
+    world.broadcast_callback();
+  }
+  reportAllocations(state, allocations_at_start);
+}
+BENCHMARK(BM_BroadcastWorldObjectTransforms)->Apply(worldArguments);
+}  // namespace
+
+BENCHMARK_MAIN();
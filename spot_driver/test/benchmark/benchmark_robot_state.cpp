@@ -0,0 +1,447 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+// Benchmarks of the conversions from a RobotState to the robot state messages, which run with every robot state at
+// 50 Hz, and of a whole publish cycle of the StatePublisher with fake Spot and middleware interfaces. Each benchmark
+// reports the time per robot state and the number of heap allocations per robot state.
+//
+// By default, the benchmarks run on synthetic robot states. The first argument of each benchmark selects a robot with
+// an arm, and the second one adds that many fiducial frames to the frame tree, like a robot which sees many world
+// objects. To replay a robot state which was recorded from a robot, set the SPOT_ROBOT_STATE_BENCHMARK_FIXTURE
+// environment variable to a file which contains a serialized RobotState, which is then used for every argument.
+
+#include <benchmark/benchmark.h>
+
+#include <bosdyn/api/robot_state.pb.h>
+#include <google/protobuf/duration.pb.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <spot_driver/api/state_client_interface.hpp>
+#include <spot_driver/api/time_sync_api.hpp>
+#include <spot_driver/conversions/robot_state.hpp>
+#include <spot_driver/fake/fake_parameter_interface.hpp>
+#include <spot_driver/interfaces/logger_interface_base.hpp>
+#include <spot_driver/interfaces/tf_broadcaster_interface_base.hpp>
+#include <spot_driver/interfaces/timer_interface_base.hpp>
+#include <spot_driver/robot_state/state_publisher.hpp>
+#include <spot_driver/robot_state_test_tools.hpp>
+#include <spot_driver/types.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+std::atomic<std::size_t> allocation_count{0};
+}  // namespace
+
+// Count every heap allocation of the process, so that the benchmarks can report allocations per robot state.
+void* operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t /*size*/) noexcept {
+  std::free(pointer);
+}
+
+namespace {
+constexpr auto kFixtureEnvironmentVariable = "SPOT_ROBOT_STATE_BENCHMARK_FIXTURE";
+constexpr auto kPrefix = "Spot/";
+constexpr auto kPreferredBaseFrame = "Spot/odom";
+
+constexpr std::array kLegJoints{"fl.hx", "fl.hy", "fl.kn", "fr.hx", "fr.hy", "fr.kn",
+                                "hl.hx", "hl.hy", "hl.kn", "hr.hx", "hr.hy", "hr.kn"};
+constexpr std::array kArmJoints{"arm0.sh0", "arm0.sh1", "arm0.hr0", "arm0.el0",
+                                "arm0.el1", "arm0.wr0", "arm0.wr1", "arm0.f1x"};
+constexpr std::array kBodyFrames{"flat_body", "gpe", "head", "link_fl.hip", "link_fr.hip", "link_hl.hip", "link_hr.hip"};
+constexpr std::array kArmFrames{"arm0.link_sh0", "arm0.link_sh1", "arm0.link_hr0", "arm0.link_el0",
+                                "arm0.link_el1", "arm0.link_wr0", "arm0.link_wr1", "hand"};
+
+google::protobuf::Timestamp makeTimestamp() {
+  google::protobuf::Timestamp timestamp;
+  timestamp.set_seconds(1'700'000'000);
+  timestamp.set_nanos(123'456'789);
+  return timestamp;
+}
+
+google::protobuf::Duration makeClockSkew() {
+  google::protobuf::Duration clock_skew;
+  clock_skew.set_seconds(1);
+  clock_skew.set_nanos(234'567'891);
+  return clock_skew;
+}
+
+/**
+ * @brief Create a synthetic robot state with every field that the driver publishes.
+ *
+ * @param has_arm If true, the robot state contains the joints and frames of an arm and a manipulator state.
+ * @param extra_frames Number of fiducial frames which are added to the frame tree below the vision frame.
+ * @return The robot state.
+ */
+bosdyn::api::RobotState createSyntheticRobotState(const bool has_arm, const std::size_t extra_frames) {
+  using spot_ros2::test::addAcquisitionTimestamp;
+  using spot_ros2::test::addBodyVelocityOdom;
+  using spot_ros2::test::addBodyVelocityVision;
+  using spot_ros2::test::addRootFrame;
+  using spot_ros2::test::addTransform;
+
+  const auto timestamp = makeTimestamp();
+  bosdyn::api::RobotState robot_state;
+
+  auto* kinematic_state = robot_state.mutable_kinematic_state();
+  addAcquisitionTimestamp(kinematic_state, timestamp);
+  addBodyVelocityOdom(kinematic_state, 0.5, 0.1, 0.0, 0.0, 0.0, 0.2);
+  addBodyVelocityVision(kinematic_state, 0.5, 0.1, 0.0, 0.0, 0.0, 0.2);
+  for (const auto* joint : kLegJoints) {
+    spot_ros2::test::setJointState(kinematic_state->add_joint_states(), joint, 0.1, 0.2, 0.3, 0.4);
+  }
+  if (has_arm) {
+    for (const auto* joint : kArmJoints) {
+      spot_ros2::test::setJointState(kinematic_state->add_joint_states(), joint, 0.1, 0.2, 0.3, 0.4);
+    }
+  }
+
+  auto* snapshot = kinematic_state->mutable_transforms_snapshot();
+  addRootFrame(snapshot, "body");
+  addTransform(snapshot, "odom", "body", 1.0, 2.0, 0.5, 1.0, 0.0, 0.0, 0.0);
+  addTransform(snapshot, "vision", "body", 1.5, 2.5, 0.5, 1.0, 0.0, 0.0, 0.0);
+  for (const auto* frame : kBodyFrames) {
+    addTransform(snapshot, frame, "body", 0.1, 0.2, 0.3, 1.0, 0.0, 0.0, 0.0);
+  }
+  if (has_arm) {
+    const char* parent = "body";
+    for (const auto* frame : kArmFrames) {
+      addTransform(snapshot, frame, parent, 0.1, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+      parent = frame;
+    }
+  }
+  for (std::size_t index = 0; index < extra_frames; ++index) {
+    addTransform(snapshot, "fiducial_" + std::to_string(index), "vision", 0.1 * static_cast<double>(index), 0.0, 0.0,
+                 1.0, 0.0, 0.0, 0.0);
+  }
+
+  for (int foot = 0; foot < 4; ++foot) {
+    spot_ros2::test::setFootState(robot_state.add_foot_state(), 0.3, 0.2, -0.5,
+                                  bosdyn::api::FootState_Contact_CONTACT_MADE);
+  }
+  *robot_state.add_battery_states() = spot_ros2::test::createBatteryState(
+      "battery", timestamp, 80, 2, 50, 30.0, bosdyn::api::BatteryState_Status_STATUS_DISCHARGING);
+  *robot_state.add_comms_states()->mutable_wifi_state() =
+      spot_ros2::test::createWifiState(bosdyn::api::WiFiState_Mode_MODE_CLIENT, "spot_network");
+  auto* estop = robot_state.add_estop_states();
+  estop->set_name("software_estop");
+  estop->set_type(bosdyn::api::EStopState_Type_TYPE_SOFTWARE);
+  estop->set_state(bosdyn::api::EStopState_State_STATE_NOT_ESTOPPED);
+  estop->mutable_timestamp()->CopyFrom(timestamp);
+  auto* power_state = robot_state.mutable_power_state();
+  power_state->mutable_timestamp()->CopyFrom(timestamp);
+  power_state->set_motor_power_state(bosdyn::api::PowerState_MotorPowerState_STATE_ON);
+  power_state->set_shore_power_state(bosdyn::api::PowerState_ShorePowerState_STATE_OFF_SHORE_POWER);
+  power_state->mutable_locomotion_charge_percentage()->set_value(80.0);
+  power_state->mutable_locomotion_estimated_runtime()->set_seconds(3600);
+  spot_ros2::test::appendSystemFault(robot_state.mutable_system_fault_state(), timestamp, makeClockSkew(),
+                                     "fault", 1, 2, "message", {"attribute"},
+                                     bosdyn::api::SystemFault_Severity_SEVERITY_WARN);
+
+  if (has_arm) {
+    auto* manipulator_state = robot_state.mutable_manipulator_state();
+    manipulator_state->set_gripper_open_percentage(10.0);
+    manipulator_state->set_stow_state(bosdyn::api::ManipulatorState_StowState_STOWSTATE_STOWED);
+    manipulator_state->set_carry_state(bosdyn::api::ManipulatorState_CarryState_CARRY_STATE_NOT_CARRIABLE);
+    auto* force = manipulator_state->mutable_estimated_end_effector_force_in_hand();
+    force->set_x(1.0);
+    force->set_y(2.0);
+    force->set_z(3.0);
+    manipulator_state->mutable_velocity_of_hand_in_odom()->mutable_linear()->set_x(0.1);
+    manipulator_state->mutable_velocity_of_hand_in_vision()->mutable_linear()->set_x(0.1);
+  }
+  return robot_state;
+}
+
+/** @brief Load the recorded robot state, if the fixture is set and can be read. */
+std::optional<bosdyn::api::RobotState> loadFixture() {
+  const char* fixture_path = std::getenv(kFixtureEnvironmentVariable);
+  if (fixture_path == nullptr) {
+    return std::nullopt;
+  }
+  std::ifstream file{fixture_path, std::ios::binary};
+  bosdyn::api::RobotState robot_state;
+  if (!file || !robot_state.ParseFromIstream(&file)) {
+    std::fprintf(stderr, "Failed to read a RobotState from %s. Using synthetic robot states.\n", fixture_path);
+    return std::nullopt;
+  }
+  return robot_state;
+}
+
+/** @brief Get the robot state of a benchmark, which is the recorded one if it is set or else a synthetic one. */
+bosdyn::api::RobotState getRobotState(benchmark::State& state) {
+  static const auto fixture = loadFixture();
+  if (fixture) {
+    state.SetLabel("recorded");
+    return fixture.value();
+  }
+  return createSyntheticRobotState(state.range(0) != 0, static_cast<std::size_t>(state.range(1)));
+}
+
+/**
+ * @brief Report the number of heap allocations per robot state since the start of the timed loop.
+ *
+ * @param state State of the benchmark.
+ * @param allocations_at_start Allocation count when the timed loop started.
+ */
+void reportAllocations(benchmark::State& state, const std::size_t allocations_at_start) {
+  state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocation_count.load() - allocations_at_start),
+                                                   benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Run a conversion of the robot state of a benchmark in the timed loop.
+ *
+ * @param state State of the benchmark.
+ * @param convert Conversion, which receives the robot state and the clock skew.
+ */
+template <typename Conversion>
+void runConversion(benchmark::State& state, Conversion&& convert) {
+  const auto robot_state = getRobotState(state);
+  const auto clock_skew = makeClockSkew();
+  const auto allocations_at_start = allocation_count.load();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(convert(robot_state, clock_skew));
+  }
+  reportAllocations(state, allocations_at_start);
+}
+
+// Without an arm, with an arm, and with an arm and a large frame tree.
+void robotStateArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"arm", "extra_frames"})->Args({0, 0})->Args({1, 0})->Args({1, 128});
+}
+
+void BM_GetBatteryStates(benchmark::State& state) {
+  runConversion(state, [](const auto& robot_state, const auto& clock_skew) {
+    return spot_ros2::getBatteryStates(robot_state, clock_skew);
+  });
+}
+BENCHMARK(BM_GetBatteryStates)->Apply(robotStateArguments);
+
+void BM_GetWifiState(benchmark::State& state) {
+  runConversion(state, [](const auto& robot_state, const auto&) {
+    return spot_ros2::getWifiState(robot_state);
+  });
+}
+BENCHMARK(BM_GetWifiState)->Apply(robotStateArguments);
+
+void BM_GetFootState(benchmark::State& state) {
+  runConversion(state, [](const auto& robot_state, const auto&) {
+    return spot_ros2::getFootState(robot_state);
+  });
+}
+BENCHMARK(BM_GetFootState)->Apply(robotStateArguments);
+
+void BM_GetEstopStates(benchmark::State& state) {
+  runConversion(state, [](const auto& robot_state, const auto& clock_skew) {
+    return spot_ros2::getEstopStates(robot_state, clock_skew);
+  });
+}
+BENCHMARK(BM_GetEstopStates)->Apply(robotStateArguments);
+
+void BM_GetJointStates(benchmark::State& state) {
+  runConversion(state, [](const auto& robot_state, const auto& clock_skew) {
+    return spot_ros2::getJointStates(robot_state, clock_skew, kPrefix);
+  });
+}
+BENCHMARK(BM_GetJointStates)->Apply(robotStateArguments);
+
+void BM_JointStateConverter(benchmark::State& state) {
+  spot_ros2::JointStateConverter converter{kPrefix};
+  sensor_msgs::msg::JointState joint_states;
+  runConversion(state, [&](const auto& robot_state, const auto& clock_skew) {
+    return converter.convert(robot_state, clock_skew, joint_states);
+  });
+}
+BENCHMARK(BM_JointStateConverter)->Apply(robotStateArguments);
+
+void BM_GetTf(benchmark::State& state) {
+  runConversion(state, [](const auto& robot_state, const auto& clock_skew) {
+    return spot_ros2::getTf(robot_state, clock_skew, kPrefix, kPreferredBaseFrame);
+  });
+}
+BENCHMARK(BM_GetTf)->Apply(robotStateArguments);
+
+void BM_FrameTreeConverter(benchmark::State& state) {
+  spot_ros2::FrameTreeConverter converter{kPrefix, kPreferredBaseFrame};
+  runConversion(state, [&](const auto& robot_state, const auto& clock_skew) {
+    const auto& kinematic_state = robot_state.kinematic_state();
+    return converter.convert(kinematic_state.transforms_snapshot(), kinematic_state.acquisition_timestamp(),
+                             clock_skew);
+  });
+}
+BENCHMARK(BM_FrameTreeConverter)->Apply(robotStateArguments);
+
+void BM_GetOdomTwist(benchmark::State& state) {
+  runConversion(state, [](const auto& robot_state, const auto& clock_skew) {
+    return spot_ros2::getOdomTwist(robot_state, clock_skew, false);
+  });
+}
+BENCHMARK(BM_GetOdomTwist)->Apply(robotStateArguments);
+
+void BM_GetOdom(benchmark::State& state) {
+  runConversion(state, [](const auto& robot_state, const auto& clock_skew) {
+    return spot_ros2::getOdom(robot_state, clock_skew, kPrefix, false);
+  });
+}
+BENCHMARK(BM_GetOdom)->Apply(robotStateArguments);
+
+void BM_GetPowerState(benchmark::State& state) {
+  runConversion(state, [](const auto& robot_state, const auto& clock_skew) {
+    return spot_ros2::getPowerState(robot_state, clock_skew);
+  });
+}
+BENCHMARK(BM_GetPowerState)->Apply(robotStateArguments);
+
+void BM_GetSystemFaultState(benchmark::State& state) {
+  runConversion(state, [](const auto& robot_state, const auto& clock_skew) {
+    return spot_ros2::getSystemFaultState(robot_state, clock_skew);
+  });
+}
+BENCHMARK(BM_GetSystemFaultState)->Apply(robotStateArguments);
+
+void BM_GetManipulatorState(benchmark::State& state) {
+  runConversion(state, [](const auto& robot_state, const auto&) {
+    return spot_ros2::getManipulatorState(robot_state);
+  });
+}
+BENCHMARK(BM_GetManipulatorState)->Apply(robotStateArguments);
+
+void BM_GetEndEffectorForce(benchmark::State& state) {
+  runConversion(state, [](const auto& robot_state, const auto& clock_skew) {
+    return spot_ros2::getEndEffectorForce(robot_state, clock_skew, kPrefix);
+  });
+}
+BENCHMARK(BM_GetEndEffectorForce)->Apply(robotStateArguments);
+
+void BM_GetBehaviorFaultState(benchmark::State& state) {
+  runConversion(state, [](const auto& robot_state, const auto& clock_skew) {
+    return spot_ros2::getBehaviorFaultState(robot_state, clock_skew);
+  });
+}
+BENCHMARK(BM_GetBehaviorFaultState)->Apply(robotStateArguments);
+
+/** @brief Returns the same robot state on every request. Each request copies it, like parsing a response would. */
+class FakeStateClient : public spot_ros2::StateClientInterface {
+ public:
+  explicit FakeStateClient(bosdyn::api::RobotState robot_state) : robot_state_{std::move(robot_state)} {}
+  tl::expected<bosdyn::api::RobotState, std::string> getRobotState(std::chrono::duration<double> /*timeout*/) override {
+    return robot_state_;
+  }
+
+ private:
+  bosdyn::api::RobotState robot_state_;
+};
+
+class FakeTimeSyncApi : public spot_ros2::TimeSyncApi {
+ public:
+  tl::expected<google::protobuf::Duration, std::string> getClockSkew() override { return makeClockSkew(); }
+};
+
+/** @brief Middleware which has subscribers on every topic, but drops every message. */
+class FakeMiddlewareHandle : public spot_ros2::StatePublisher::MiddlewareHandle {
+ public:
+  void publishOdometry(const spot_ros2::RobotStateMessages& robot_state_msgs) override {
+    benchmark::DoNotOptimize(&robot_state_msgs);
+  }
+  void publishRobotState(const spot_ros2::RobotStateMessages& robot_state_msgs) override {
+    benchmark::DoNotOptimize(&robot_state_msgs);
+  }
+  void publishRawRobotState(const bosdyn::api::RobotState& robot_state) override {
+    benchmark::DoNotOptimize(&robot_state);
+  }
+  bool hasSubscribers(spot_ros2::StatePublisher::Topic) const override { return true; }
+  void createGetRobotStateAtTimeService(const GetRobotStateAtTimeCallback&) override {}
+  void subscribeToLowLevelJointStates(const JointStatesCallback&) override {}
+  void publishJointStates(const sensor_msgs::msg::JointState& joint_states) override {
+    benchmark::DoNotOptimize(&joint_states);
+  }
+};
+
+class FakeLogger : public spot_ros2::LoggerInterfaceBase {
+ public:
+  void logDebug(const std::string&) const override {}
+  void logInfo(const std::string&) const override {}
+  void logWarn(const std::string&) const override {}
+  void logError(const std::string&) const override {}
+  void logFatal(const std::string&) const override {}
+};
+
+class FakeTfBroadcaster : public spot_ros2::TfBroadcasterInterfaceBase {
+ public:
+  void updateStaticTransforms(const std::vector<geometry_msgs::msg::TransformStamped>&) override {}
+  void sendDynamicTransforms(const std::vector<geometry_msgs::msg::TransformStamped>& transforms) override {
+    benchmark::DoNotOptimize(transforms.data());
+  }
+};
+
+/** @brief Keeps the timer callback of the StatePublisher, so that the benchmark can trigger it. */
+class FakeTimer : public spot_ros2::TimerInterfaceBase {
+ public:
+  explicit FakeTimer(std::function<void()>& callback) : callback_{callback} {}
+  void setTimer(const std::chrono::duration<double>&, const std::function<void()>& callback) override {
+    callback_ = callback;
+  }
+  void clearTimer() override {}
+
+ private:
+  std::function<void()>& callback_;
+};
+
+/**
+ * @brief Trigger the timer callback of a StatePublisher, which requests, converts and publishes one robot state. The
+ * time includes the copy of the robot state which the fake state client returns.
+ */
+void BM_StatePublisherTimerCallback(benchmark::State& state) {
+  auto parameter_interface = std::make_unique<spot_ros2::test::FakeParameterInterface>();
+  parameter_interface->spot_name = "Spot";
+  std::function<void()> timer_callback;
+  const spot_ros2::StatePublisher publisher{std::make_shared<FakeStateClient>(getRobotState(state)),
+                                            std::make_shared<FakeTimeSyncApi>(),
+                                            std::make_unique<FakeMiddlewareHandle>(),
+                                            std::move(parameter_interface),
+                                            std::make_unique<FakeLogger>(),
+                                            std::make_unique<FakeTfBroadcaster>(),
+                                            std::make_unique<FakeTimer>(timer_callback)};
+  if (!timer_callback) {
+    state.SkipWithError("The StatePublisher did not set a timer.");
+    return;
+  }
+  // The first robot state fills the buffers which the StatePublisher reuses, so it is not part of the steady state.
+  timer_callback();
+  const auto allocations_at_start = allocation_count.load();
+  for (auto _ : state) {
+    timer_callback();
+  }
+  reportAllocations(state, allocations_at_start);
+}
+BENCHMARK(BM_StatePublisherTimerCallback)->Apply(robotStateArguments);
+}  // namespace
+
+BENCHMARK_MAIN();
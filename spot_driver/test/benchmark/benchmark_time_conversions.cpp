@@ -0,0 +1,81 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+// Benchmarks of the conversions between robot and local timestamps. Each benchmark converts a batch of timestamps, so
+// the per-message conversion can be compared with the nanosecond fast path and the batch conversion which the
+// publishers use for many timestamps with the same clock skew.
+
+#include <benchmark/benchmark.h>
+
+#include <builtin_interfaces/msg/time.hpp>
+#include <google/protobuf/duration.pb.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <spot_driver/conversions/time.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+constexpr std::int64_t kFirstTimestamp = 1'700'000'000'000'000'000;
+constexpr std::int64_t kTimestampStep = 3'333'333;
+constexpr std::int64_t kClockSkew = 1'234'567'891;
+
+std::vector<google::protobuf::Timestamp> makeTimestamps(const std::size_t count) {
+  std::vector<google::protobuf::Timestamp> timestamps;
+  timestamps.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    timestamps.push_back(spot_ros2::toProtoTimestamp(kFirstTimestamp + static_cast<std::int64_t>(i) * kTimestampStep));
+  }
+  return timestamps;
+}
+
+google::protobuf::Duration makeClockSkew() {
+  google::protobuf::Duration clock_skew;
+  clock_skew.set_seconds(kClockSkew / 1'000'000'000);
+  clock_skew.set_nanos(static_cast<std::int32_t>(kClockSkew % 1'000'000'000));
+  return clock_skew;
+}
+
+void BM_RobotToLocalMessages(benchmark::State& state) {
+  const auto timestamps = makeTimestamps(static_cast<std::size_t>(state.range(0)));
+  const auto clock_skew = makeClockSkew();
+  for (auto _ : state) {
+    for (const auto& timestamp : timestamps) {
+      benchmark::DoNotOptimize(spot_ros2::robotTimeToLocalTime(timestamp, clock_skew));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RobotToLocalMessages)->Arg(1)->Arg(1024);
+
+void BM_RobotToLocalNanoseconds(benchmark::State& state) {
+  const auto timestamps = makeTimestamps(static_cast<std::size_t>(state.range(0)));
+  const auto clock_skew = spot_ros2::toNanoseconds(makeClockSkew());
+  for (auto _ : state) {
+    for (const auto& timestamp : timestamps) {
+      benchmark::DoNotOptimize(
+          spot_ros2::toRosTime(spot_ros2::robotTimeToLocalTime(spot_ros2::toNanoseconds(timestamp), clock_skew)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RobotToLocalNanoseconds)->Arg(1)->Arg(1024);
+
+void BM_RobotToLocalBatch(benchmark::State& state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  std::vector<std::int64_t> timestamps(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    timestamps[i] = kFirstTimestamp + static_cast<std::int64_t>(i) * kTimestampStep;
+  }
+  std::vector<std::int64_t> out(count);
+  for (auto _ : state) {
+    spot_ros2::robotTimesToLocalTimes(timestamps.data(), count, kClockSkew, out.data());
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RobotToLocalBatch)->Arg(1)->Arg(1024);
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,35 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+
+namespace spot_ros2::test {
+/**
+ * @brief Get the number of heap allocations made by the calling thread so far.
+ * @details Linking the allocation_counter library replaces the global operator new of the test executable, which also
+ * counts the allocations of the shared libraries it loads. Only the calling thread is counted, so that the threads of
+ * rclcpp and gtest do not disturb a test.
+ */
+std::size_t getThreadAllocationCount();
+
+/**
+ * @brief Counts the heap allocations of the calling thread between its construction and a call to count().
+ * @details Used to assert that a hot path does not allocate in its steady state:
+ *
+ *   convert(message);  // The first call sizes the buffers of the message.
+ *   const ScopedAllocationCounter counter;
+ *   convert(message);
+ *   EXPECT_THAT(counter.count(), Eq(0u));
+ */
+class ScopedAllocationCounter {
+ public:
+  ScopedAllocationCounter() : allocations_at_start_{getThreadAllocationCount()} {}
+
+  /** @brief Get the number of heap allocations of the calling thread since this counter was constructed. */
+  [[nodiscard]] std::size_t count() const { return getThreadAllocationCount() - allocations_at_start_; }
+
+ private:
+  std::size_t allocations_at_start_;
+};
+}  // namespace spot_ros2::test
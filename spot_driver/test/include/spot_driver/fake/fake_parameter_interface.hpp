@@ -5,6 +5,7 @@
 #include <spot_driver/interfaces/parameter_interface_base.hpp>
 
 #include <chrono>
+#include <map>
 #include <optional>
 #include <set>
 #include <string>
@@ -37,10 +38,161 @@ class FakeParameterInterface : public ParameterInterfaceBase {
 
   bool getPublishDepthRegisteredImages() const override { return publish_depth_registered_images; }
 
+  int getImageDecodeThreads() const override { return image_decode_threads; }
+
+  std::string getJpegDecoder() const override { return jpeg_decoder; }
+
+  bool getRLEDepthImages() const override { return rle_depth_images; }
+
+  double getCameraPublishRate(const spot_ros2::SpotCamera camera) const override {
+    const auto rate = camera_publish_rates.find(camera);
+    return rate == camera_publish_rates.cend() ? kDefaultCameraPublishRate : rate->second;
+  }
+
+  int getImageRequestsInFlight() const override { return image_requests_in_flight; }
+
+  bool getOnDemandImages() const override { return on_demand_images; }
+
+  double getStaticTransformsRefreshPeriod() const override { return static_transforms_refresh_period; }
+
+  int getImagePreviewScale() const override { return image_preview_scale; }
+
+  std::vector<int64_t> getImagePreviewRegion() const override { return image_preview_roi; }
+
+  bool getPublishDepthPointClouds() const override { return publish_depth_point_clouds; }
+
+  double getPointCloudVoxelSize() const override { return point_cloud_voxel_size; }
+
+  bool getPublishCompressedDepthImages() const override { return publish_compressed_depth_images; }
+
+  std::string getCompressedDepthFormat() const override { return compressed_depth_format; }
+
+  bool getPublishFilteredDepthImages() const override { return publish_filtered_depth_images; }
+
+  int getFilteredDepthDecimation() const override { return filtered_depth_decimation; }
+
+  bool getFilteredDepthFillHoles() const override { return filtered_depth_fill_holes; }
+
+  double getFilteredDepthMinRange() const override { return filtered_depth_min_range; }
+
+  double getFilteredDepthMaxRange() const override { return filtered_depth_max_range; }
+
+  bool getPublishLaserScan() const override { return publish_laser_scan; }
+
+  double getLaserScanMinHeight() const override { return laser_scan_min_height; }
+
+  double getLaserScanMaxHeight() const override { return laser_scan_max_height; }
+
+  double getLaserScanRangeMax() const override { return laser_scan_range_max; }
+
+  double getLaserScanAngleIncrement() const override { return laser_scan_angle_increment; }
+
+  bool getPublishStitchedFrontImage() const override { return publish_stitched_front_image; }
+
+  std::string getVirtualCameraFrame() const override { return virtual_camera_frame; }
+
+  std::vector<double> getVirtualCameraIntrinsics() const override { return virtual_camera_intrinsics; }
+
+  std::vector<double> getVirtualCameraProjectionPlane() const override { return virtual_camera_projection_plane; }
+
+  double getVirtualCameraPlaneDistance() const override { return virtual_camera_plane_distance; }
+
+  int getStitchedImageRowPadding() const override { return stitched_image_row_padding; }
+
+  int getStitchedImageSeamUpdatePeriod() const override { return stitched_image_seam_update_period; }
+
+  std::string getStitchedImageBlendMode() const override { return stitched_image_blend_mode; }
+
+  int getStitchedImageBlendWidth() const override { return stitched_image_blend_width; }
+
+  bool getStitchedImageUseGpu() const override { return stitched_image_use_gpu; }
+
+  bool getPublishImageLatencyDiagnostics() const override { return publish_image_latency_diagnostics; }
+
+  double getHandCameraStreamRate() const override { return hand_camera_stream_rate; }
+
+  double getHandCameraStreamQuality() const override { return hand_camera_stream_quality; }
+
+  double getHandCameraStreamResizeRatio() const override { return hand_camera_stream_resize_ratio; }
+
+  bool getAdaptiveRGBImageQuality() const override { return adaptive_rgb_image_quality; }
+
+  double getMinRGBImageQuality() const override { return min_rgb_image_quality; }
+
+  double getMaxImageAge() const override { return max_image_age; }
+
+  double getImageBandwidthBudget() const override { return image_bandwidth_budget; }
+
+  int getCameraPriority(const spot_ros2::SpotCamera camera) const override {
+    const auto priority = camera_priorities.find(camera);
+    return priority == camera_priorities.cend() ? kDefaultCameraPriority : priority->second;
+  }
+
+  std::string getCameraImageEncoding(const spot_ros2::SpotCamera camera) const override {
+    const auto encoding = camera_image_encodings.find(camera);
+    return encoding == camera_image_encodings.cend() ? kDefaultCameraImageEncoding : encoding->second;
+  }
+
+  bool getColorizeRegisteredPointClouds() const override { return colorize_registered_point_clouds; }
+
+  bool getPublishImageBundle() const override { return publish_image_bundle; }
+
+  bool getStreamImages() const override { return stream_images; }
+
+  bool getWarmUpImages() const override { return warm_up_images; }
+
+  bool getStreamRobotState() const override { return stream_robot_state; }
+
+  bool getLowLevelJointStates() const override { return low_level_joint_states; }
+
+  bool getPublishStatusOnChange() const override { return publish_status_on_change; }
+
+  double getStatusHeartbeatPeriod() const override { return status_heartbeat_period; }
+
+  double getMetricsPublishPeriod() const override { return metrics_publish_period; }
+
+  std::string getMetricsTextfile() const override { return metrics_textfile; }
+
+  bool getPublishRawProtobuf() const override { return publish_raw_protobuf; }
+
+  bool getRawProtobufOnly() const override { return raw_protobuf_only; }
+
+  int getRobotStateHistorySize() const override { return robot_state_history_size; }
+
+  double getRobotStatePublishRate(const std::string& topic) const override {
+    const auto rate = robot_state_publish_rates.find(topic);
+    return rate == robot_state_publish_rates.cend() ? kDefaultRobotStatePublishRate : rate->second;
+  }
+
   std::string getPreferredOdomFrame() const override { return "odom"; }
 
   std::string getTFRoot() const override { return "odom"; }
 
+  double getObjectSyncTranslationThreshold() const override { return object_sync_translation_threshold; }
+
+  double getObjectSyncRotationThreshold() const override { return object_sync_rotation_threshold; }
+
+  double getObjectSyncTfCacheDuration() const override { return object_sync_tf_cache_duration; }
+
+  std::vector<std::string> getObjectSyncTfFrameAllowlist() const override { return object_sync_tf_frame_allowlist; }
+
+  std::vector<std::string> getObjectSyncTfFrameDenylist() const override { return object_sync_tf_frame_denylist; }
+
+  double getObjectSyncWorldObjectTfRate() const override { return object_sync_world_object_tf_rate; }
+
+  std::string getThreadCpus(const std::string& thread_class) const override {
+    const auto cpus = thread_cpus.find(thread_class);
+    return cpus == thread_cpus.cend() ? kDefaultThreadCpus : cpus->second;
+  }
+
+  int getIKCacheSize() const override { return ik_cache_size; }
+
+  double getIKCachePositionTolerance() const override { return ik_cache_position_tolerance; }
+
+  double getIKCacheRotationTolerance() const override { return ik_cache_rotation_tolerance; }
+
+  std::string getRobotDescription() const override { return robot_description; }
+
   std::string getSpotName() const override { return spot_name; }
 
   bool getGripperless() const override { return gripperless; }
@@ -61,6 +213,29 @@ class FakeParameterInterface : public ParameterInterfaceBase {
 
   std::chrono::seconds getTimeSyncTimeout() const override { return kDefaultTimeSyncTimeout; }
 
+  double getImageRequestTimeout() const override { return image_request_timeout; }
+
+  double getRobotStateRequestTimeout() const override { return robot_state_request_timeout; }
+
+  double getWorldObjectRequestTimeout() const override { return world_object_request_timeout; }
+
+  double getKinematicRequestTimeout() const override { return kinematic_request_timeout; }
+
+  bool getDegradeOnPoorLink() const override { return degrade_on_poor_link; }
+
+  double getLinkDegradedLatency() const override { return link_degraded_latency; }
+
+  double getLinkDegradedFailureRate() const override { return link_degraded_failure_rate; }
+
+  int getDegradedRateDivisor() const override { return degraded_rate_divisor; }
+
+  double getDegradedRGBImageQuality() const override { return degraded_rgb_image_quality; }
+
+  tl::expected<PublisherQoSParameters, std::string> getPublisherQoS(const std::string& category) const override {
+    const auto qos = publisher_qos.find(category);
+    return qos == publisher_qos.cend() ? PublisherQoSParameters{} : qos->second;
+  }
+
   static constexpr auto kExampleHostname{"192.168.0.10"};
   static constexpr auto kExampleUsername{"spot_user"};
   static constexpr auto kExamplePassword{"hunter2"};
@@ -72,7 +247,85 @@ class FakeParameterInterface : public ParameterInterfaceBase {
   bool publish_rgb_images = ParameterInterfaceBase::kDefaultPublishRGBImages;
   bool publish_depth_images = ParameterInterfaceBase::kDefaultPublishDepthImages;
   bool publish_depth_registered_images = ParameterInterfaceBase::kDefaultPublishDepthRegisteredImages;
+  int image_decode_threads = ParameterInterfaceBase::kDefaultImageDecodeThreads;
+  std::string jpeg_decoder = ParameterInterfaceBase::kDefaultJpegDecoder;
+  bool rle_depth_images = ParameterInterfaceBase::kDefaultRLEDepthImages;
+  std::map<spot_ros2::SpotCamera, double> camera_publish_rates;
+  int image_requests_in_flight = ParameterInterfaceBase::kDefaultImageRequestsInFlight;
+  bool on_demand_images = ParameterInterfaceBase::kDefaultOnDemandImages;
+  double static_transforms_refresh_period = ParameterInterfaceBase::kDefaultStaticTransformsRefreshPeriod;
+  int image_preview_scale = ParameterInterfaceBase::kDefaultImagePreviewScale;
+  std::vector<int64_t> image_preview_roi;
+  bool publish_depth_point_clouds = ParameterInterfaceBase::kDefaultPublishDepthPointClouds;
+  double point_cloud_voxel_size = ParameterInterfaceBase::kDefaultPointCloudVoxelSize;
+  bool publish_compressed_depth_images = ParameterInterfaceBase::kDefaultPublishCompressedDepthImages;
+  std::string compressed_depth_format = ParameterInterfaceBase::kDefaultCompressedDepthFormat;
+  bool publish_filtered_depth_images = ParameterInterfaceBase::kDefaultPublishFilteredDepthImages;
+  int filtered_depth_decimation = ParameterInterfaceBase::kDefaultFilteredDepthDecimation;
+  bool filtered_depth_fill_holes = ParameterInterfaceBase::kDefaultFilteredDepthFillHoles;
+  double filtered_depth_min_range = ParameterInterfaceBase::kDefaultFilteredDepthMinRange;
+  double filtered_depth_max_range = ParameterInterfaceBase::kDefaultFilteredDepthMaxRange;
+  bool publish_laser_scan = ParameterInterfaceBase::kDefaultPublishLaserScan;
+  double laser_scan_min_height = ParameterInterfaceBase::kDefaultLaserScanMinHeight;
+  double laser_scan_max_height = ParameterInterfaceBase::kDefaultLaserScanMaxHeight;
+  double laser_scan_range_max = ParameterInterfaceBase::kDefaultLaserScanRangeMax;
+  double laser_scan_angle_increment = ParameterInterfaceBase::kDefaultLaserScanAngleIncrement;
+  bool publish_stitched_front_image = ParameterInterfaceBase::kDefaultPublishStitchedFrontImage;
+  std::string virtual_camera_frame = ParameterInterfaceBase::kDefaultVirtualCameraFrame;
+  std::vector<double> virtual_camera_intrinsics;
+  std::vector<double> virtual_camera_projection_plane;
+  double virtual_camera_plane_distance = ParameterInterfaceBase::kDefaultVirtualCameraPlaneDistance;
+  int stitched_image_row_padding = ParameterInterfaceBase::kDefaultStitchedImageRowPadding;
+  int stitched_image_seam_update_period = ParameterInterfaceBase::kDefaultStitchedImageSeamUpdatePeriod;
+  std::string stitched_image_blend_mode = ParameterInterfaceBase::kDefaultStitchedImageBlendMode;
+  int stitched_image_blend_width = ParameterInterfaceBase::kDefaultStitchedImageBlendWidth;
+  bool stitched_image_use_gpu = ParameterInterfaceBase::kDefaultStitchedImageUseGpu;
+  bool publish_image_latency_diagnostics = ParameterInterfaceBase::kDefaultPublishImageLatencyDiagnostics;
+  double hand_camera_stream_rate = ParameterInterfaceBase::kDefaultHandCameraStreamRate;
+  double hand_camera_stream_quality = ParameterInterfaceBase::kDefaultHandCameraStreamQuality;
+  double hand_camera_stream_resize_ratio = ParameterInterfaceBase::kDefaultHandCameraStreamResizeRatio;
+  bool adaptive_rgb_image_quality = ParameterInterfaceBase::kDefaultAdaptiveRGBImageQuality;
+  double min_rgb_image_quality = ParameterInterfaceBase::kDefaultMinRGBImageQuality;
+  double max_image_age = ParameterInterfaceBase::kDefaultMaxImageAge;
+  double image_request_timeout = ParameterInterfaceBase::kDefaultImageRequestTimeout;
+  double robot_state_request_timeout = ParameterInterfaceBase::kDefaultRobotStateRequestTimeout;
+  double world_object_request_timeout = ParameterInterfaceBase::kDefaultWorldObjectRequestTimeout;
+  double kinematic_request_timeout = ParameterInterfaceBase::kDefaultKinematicRequestTimeout;
+  bool degrade_on_poor_link = ParameterInterfaceBase::kDefaultDegradeOnPoorLink;
+  double link_degraded_latency = ParameterInterfaceBase::kDefaultLinkDegradedLatency;
+  double link_degraded_failure_rate = ParameterInterfaceBase::kDefaultLinkDegradedFailureRate;
+  int degraded_rate_divisor = ParameterInterfaceBase::kDefaultDegradedRateDivisor;
+  double degraded_rgb_image_quality = ParameterInterfaceBase::kDefaultDegradedRGBImageQuality;
+  double image_bandwidth_budget = ParameterInterfaceBase::kDefaultImageBandwidthBudget;
+  std::map<spot_ros2::SpotCamera, int> camera_priorities;
+  std::map<spot_ros2::SpotCamera, std::string> camera_image_encodings;
+  bool colorize_registered_point_clouds = ParameterInterfaceBase::kDefaultColorizeRegisteredPointClouds;
+  bool publish_image_bundle = ParameterInterfaceBase::kDefaultPublishImageBundle;
+  bool stream_images = ParameterInterfaceBase::kDefaultStreamImages;
+  bool warm_up_images = ParameterInterfaceBase::kDefaultWarmUpImages;
+  bool stream_robot_state = ParameterInterfaceBase::kDefaultStreamRobotState;
+  bool low_level_joint_states = ParameterInterfaceBase::kDefaultLowLevelJointStates;
+  std::map<std::string, double> robot_state_publish_rates;
+  bool publish_status_on_change = ParameterInterfaceBase::kDefaultPublishStatusOnChange;
+  double status_heartbeat_period = ParameterInterfaceBase::kDefaultStatusHeartbeatPeriod;
+  double metrics_publish_period = ParameterInterfaceBase::kDefaultMetricsPublishPeriod;
+  std::string metrics_textfile = ParameterInterfaceBase::kDefaultMetricsTextfile;
+  bool publish_raw_protobuf = ParameterInterfaceBase::kDefaultPublishRawProtobuf;
+  bool raw_protobuf_only = ParameterInterfaceBase::kDefaultRawProtobufOnly;
+  int robot_state_history_size = ParameterInterfaceBase::kDefaultRobotStateHistorySize;
   bool gripperless = ParameterInterfaceBase::kDefaultGripperless;
+  double object_sync_translation_threshold = ParameterInterfaceBase::kDefaultObjectSyncTranslationThreshold;
+  double object_sync_rotation_threshold = ParameterInterfaceBase::kDefaultObjectSyncRotationThreshold;
+  double object_sync_tf_cache_duration = ParameterInterfaceBase::kDefaultObjectSyncTfCacheDuration;
+  std::vector<std::string> object_sync_tf_frame_allowlist;
+  std::vector<std::string> object_sync_tf_frame_denylist;
+  double object_sync_world_object_tf_rate = ParameterInterfaceBase::kDefaultObjectSyncWorldObjectTfRate;
+  std::map<std::string, std::string> thread_cpus;
+  int ik_cache_size = ParameterInterfaceBase::kDefaultIKCacheSize;
+  double ik_cache_position_tolerance = ParameterInterfaceBase::kDefaultIKCachePositionTolerance;
+  double ik_cache_rotation_tolerance = ParameterInterfaceBase::kDefaultIKCacheRotationTolerance;
+  std::string robot_description;
+  std::map<std::string, PublisherQoSParameters> publisher_qos;
   std::string spot_name;
 };
 }  // namespace spot_ros2::test
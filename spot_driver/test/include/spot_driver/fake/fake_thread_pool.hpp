@@ -0,0 +1,44 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <spot_driver/interfaces/thread_pool_interface_base.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <utility>
+
+namespace spot_ros2::test {
+/**
+ * @brief Thread pool which runs everything on the calling thread, so that tests are deterministic.
+ * @details Posted tasks are only run by runPendingTasks(), and parallelFor() runs its jobs in order.
+ */
+class FakeThreadPool : public ThreadPoolInterfaceBase {
+ public:
+  void post(std::function<void()> task) override { pending_tasks.push_back(std::move(task)); }
+
+  void parallelFor(const std::size_t num_jobs, const std::size_t max_workers,
+                   const std::function<void(std::size_t)>& job) override {
+    last_max_workers = max_workers;
+    for (std::size_t index = 0; index < num_jobs; ++index) {
+      job(index);
+    }
+  }
+
+  std::size_t getNumThreads() const override { return num_threads; }
+
+  /** @brief Run the posted tasks in order, including those which they post themselves. */
+  void runPendingTasks() {
+    while (!pending_tasks.empty()) {
+      auto task = std::move(pending_tasks.front());
+      pending_tasks.pop_front();
+      task();
+    }
+  }
+
+  std::deque<std::function<void()>> pending_tasks;
+  std::size_t last_max_workers{0};
+  std::size_t num_threads{1};
+};
+}  // namespace spot_ros2::test
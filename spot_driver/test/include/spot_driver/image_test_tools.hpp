@@ -0,0 +1,33 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <sensor_msgs/msg/camera_info.hpp>
+
+#include <cstdint>
+
+namespace spot_ros2::test {
+/**
+ * @brief Create the camera info of an undistorted pinhole camera in the `camera` frame, with the same intrinsics in its
+ * K and P matrices.
+ *
+ * @param width Width of the images in pixels.
+ * @param height Height of the images in pixels.
+ * @param fx Focal length along the x axis in pixels.
+ * @param fy Focal length along the y axis in pixels.
+ * @param cx Principal point along the x axis in pixels.
+ * @param cy Principal point along the y axis in pixels.
+ * @return The camera info.
+ */
+inline sensor_msgs::msg::CameraInfo createCameraInfo(const std::uint32_t width, const std::uint32_t height,
+                                                    const double fx = 100.0, const double fy = 100.0,
+                                                    const double cx = 31.5, const double cy = 23.5) {
+  sensor_msgs::msg::CameraInfo info;
+  info.header.frame_id = "camera";
+  info.width = width;
+  info.height = height;
+  info.k = {fx, 0.0, cx, 0.0, fy, cy, 0.0, 0.0, 1.0};
+  info.p = {fx, 0.0, cx, 0.0, 0.0, fy, cy, 0.0, 0.0, 0.0, 1.0, 0.0};
+  return info;
+}
+}  // namespace spot_ros2::test
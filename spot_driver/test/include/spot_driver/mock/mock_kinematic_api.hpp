@@ -7,14 +7,21 @@
 #include <spot_driver/api/kinematic_api.hpp>
 #include <spot_driver/kinematic/kinematic_service.hpp>
 
+#include <chrono>
+#include <cstddef>
 #include <string>
+#include <vector>
 
 namespace spot_ros2::test {
 
 class MockKinematicApi : public KinematicApi {
  public:
   MOCK_METHOD((tl::expected<InverseKinematicsResponse, std::string>), getSolutions,
-              (InverseKinematicsRequest & request), (override));
+              (InverseKinematicsRequest & request, std::chrono::duration<double> timeout), (override));
+  MOCK_METHOD((std::vector<tl::expected<InverseKinematicsResponse, std::string>>), getBatchSolutions,
+              (std::vector<InverseKinematicsRequest> & requests, const std::size_t max_requests_in_flight,
+               std::chrono::duration<double> timeout),
+              (override));
 };
 
 }  // namespace spot_ros2::test
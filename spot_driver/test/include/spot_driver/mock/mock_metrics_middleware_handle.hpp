@@ -0,0 +1,15 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <gmock/gmock.h>
+
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <spot_driver/metrics/metrics_publisher.hpp>
+
+namespace spot_ros2::test {
+class MockMetricsMiddlewareHandle : public metrics::MetricsPublisher::MiddlewareHandle {
+ public:
+  MOCK_METHOD(void, publishDiagnostics, (const diagnostic_msgs::msg::DiagnosticArray& diagnostics), (override));
+};
+}  // namespace spot_ros2::test
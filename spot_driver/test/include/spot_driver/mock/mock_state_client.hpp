@@ -6,11 +6,13 @@
 
 #include <bosdyn/api/robot_state.pb.h>
 #include <spot_driver/api/state_client_interface.hpp>
+#include <chrono>
 #include <string>
 
 namespace spot_ros2::test {
 class MockStateClient : public StateClientInterface {
  public:
-  MOCK_METHOD((tl::expected<bosdyn::api::RobotState, std::string>), getRobotState, (), (override));
+  MOCK_METHOD((tl::expected<bosdyn::api::RobotState, std::string>), getRobotState,
+              (std::chrono::duration<double> timeout), (override));
 };
 }  // namespace spot_ros2::test
@@ -7,6 +7,17 @@
 namespace spot_ros2::test {
 class MockStateMiddlewareHandle : public StatePublisher::MiddlewareHandle {
  public:
+  MockStateMiddlewareHandle() {
+    // Every topic has subscribers, unless a test expects otherwise.
+    ON_CALL(*this, hasSubscribers).WillByDefault(::testing::Return(true));
+  }
+
+  MOCK_METHOD(void, publishOdometry, (const RobotStateMessages& robot_state), (override));
   MOCK_METHOD(void, publishRobotState, (const RobotStateMessages& robot_state), (override));
+  MOCK_METHOD(void, publishRawRobotState, (const bosdyn::api::RobotState& robot_state), (override));
+  MOCK_METHOD(bool, hasSubscribers, (StatePublisher::Topic topic), (const, override));
+  MOCK_METHOD(void, createGetRobotStateAtTimeService, (const GetRobotStateAtTimeCallback& callback), (override));
+  MOCK_METHOD(void, subscribeToLowLevelJointStates, (const JointStatesCallback& callback), (override));
+  MOCK_METHOD(void, publishJointStates, (const sensor_msgs::msg::JointState& joint_states), (override));
 };
 }  // namespace spot_ros2::test
@@ -6,15 +6,18 @@
 
 #include <bosdyn/api/robot_state.pb.h>
 #include <spot_driver/api/world_object_client_interface.hpp>
+#include <chrono>
 #include <string>
 
 namespace spot_ros2::test {
 class MockWorldObjectClient : public WorldObjectClientInterface {
  public:
   MOCK_METHOD((tl::expected<::bosdyn::api::ListWorldObjectResponse, std::string>), listWorldObjects,
-              (::bosdyn::api::ListWorldObjectRequest & request), (const, override));
+              (::bosdyn::api::ListWorldObjectRequest & request, std::chrono::duration<double> timeout),
+              (const, override));
 
   MOCK_METHOD((tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>), mutateWorldObject,
-              (::bosdyn::api::MutateWorldObjectRequest & request), (const, override));
+              (::bosdyn::api::MutateWorldObjectRequest & request, std::chrono::duration<double> timeout),
+              (const, override));
 };
 }  // namespace spot_ros2::test
@@ -0,0 +1,115 @@
+# Copyright (c) 2024 The AI Institute LLC. See LICENSE file for more info.
+
+"""
+Load benchmark which launches one or more complete driver graphs against the mock Spot of mock_load_spot,
+and measures how long the nodes take to start publishing, the rates of their topics, and the rate, latency and
+concurrency of the RPCs that the mock serves.
+
+The file is not named test_*.py, so it does not run with the other tests. Run it explicitly, e.g.
+
+    SPOT_LOAD_ROBOTS=4 SPOT_LOAD_REPORT=/tmp/load.csv pytest -s spot_driver/test/pytests/load/benchmark_load.py
+"""
+
+import csv
+import math
+import threading
+import time
+import typing
+
+import launch
+import launch_pytest
+import pytest
+from nav_msgs.msg import Odometry
+from rclpy.qos import qos_profile_sensor_data
+from sensor_msgs.msg import Image, JointState
+from synchros2.scope import ROSAwareScope
+
+from spot_wrapper.testing.fixtures import SpotFixture
+
+from .graphs import driver_graphs_description, percentile, robot_namespace
+from .mock_load_spot import LoadProfile, RpcStatistics
+
+# Topics whose first message and rate are measured in the namespace of every driver graph.
+MEASURED_TOPICS = (("joint_states", JointState), ("odometry", Odometry), ("camera/frontleft/image", Image))
+
+# Time that all driver graphs get to publish their first messages.
+STARTUP_TIMEOUT = 120.0
+
+
+@launch_pytest.fixture
+def load_graph_description(
+    load_spot: SpotFixture, domain_id: int, load_profile: LoadProfile
+) -> typing.Iterator[launch.LaunchDescription]:
+    with driver_graphs_description(load_spot, domain_id, load_profile) as description:
+        yield description
+
+
+@pytest.mark.launch(fixture=load_graph_description)
+def test_load(
+    load_spot: SpotFixture, load_ros: ROSAwareScope, load_profile: LoadProfile, rpc_statistics: RpcStatistics
+) -> None:
+    """Measures the startup time and the steady state topic and RPC rates of the driver graphs."""
+    start = time.monotonic()
+    namespaces = [robot_namespace(load_spot, index) for index in range(load_profile.robots)]
+    lock = threading.Lock()
+    arrivals: typing.Dict[typing.Tuple[str, str], typing.List[float]] = {
+        (namespace, topic): [] for namespace in namespaces for topic, _ in MEASURED_TOPICS
+    }
+    first_arrivals: typing.Dict[typing.Tuple[str, str], float] = {}
+
+    def on_message(key: typing.Tuple[str, str]) -> typing.Callable[[typing.Any], None]:
+        def callback(_: typing.Any) -> None:
+            now = time.monotonic()
+            with lock:
+                arrivals[key].append(now)
+                first_arrivals.setdefault(key, now - start)
+
+        return callback
+
+    for namespace in namespaces:
+        for topic, message_type in MEASURED_TOPICS:
+            load_ros.node.create_subscription(
+                message_type, f"/{namespace}/{topic}", on_message((namespace, topic)), qos_profile_sensor_data
+            )
+
+    # Startup: wait until every graph published each measured topic, or the timeout expired.
+    while time.monotonic() - start < STARTUP_TIMEOUT:
+        with lock:
+            if len(first_arrivals) == len(arrivals):
+                break
+        time.sleep(0.1)
+
+    # Steady state: count the messages and RPCs over the configured duration.
+    with lock:
+        for times in arrivals.values():
+            times.clear()
+    rpc_statistics.reset()
+    time.sleep(load_profile.duration)
+    with lock:
+        steady_arrivals = {key: list(times) for key, times in arrivals.items()}
+    rpcs = rpc_statistics.snapshot()
+
+    rows: typing.List[typing.Tuple[str, str, str, float]] = []
+    for (namespace, topic), times in steady_arrivals.items():
+        gaps = [later - earlier for earlier, later in zip(times, times[1:])]
+        rows.append((namespace, topic, "startup_s", first_arrivals.get((namespace, topic), math.nan)))
+        rows.append((namespace, topic, "rate_hz", len(times) / load_profile.duration))
+        rows.append((namespace, topic, "gap_p95_s", percentile(gaps, 0.95)))
+    for rpc, (durations, peak_in_flight) in sorted(rpcs.items()):
+        rows.append(("mock", rpc, "calls_per_s", len(durations) / load_profile.duration))
+        rows.append(("mock", rpc, "latency_p50_s", percentile(durations, 0.5)))
+        rows.append(("mock", rpc, "latency_p95_s", percentile(durations, 0.95)))
+        rows.append(("mock", rpc, "peak_in_flight", float(peak_in_flight)))
+
+    print(f"\nLoad benchmark with {load_profile}")
+    for row in rows:
+        print("{:<24} {:<28} {:<16} {:.4f}".format(*row))
+    if load_profile.report is not None:
+        with load_profile.report.open("w", newline="") as report:
+            writer = csv.writer(report)
+            writer.writerow(("source", "name", "metric", "value"))
+            writer.writerows(rows)
+
+    # The benchmark only fails if a graph never came up, since the rates depend on the machine it runs on.
+    for namespace in namespaces:
+        assert (namespace, "joint_states") in first_arrivals, f"{namespace} never published joint states"
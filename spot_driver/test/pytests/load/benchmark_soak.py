@@ -0,0 +1,298 @@
+# Copyright (c) 2024 The AI Institute LLC. See LICENSE file for more info.
+
+"""
+Soak benchmark which runs the driver graphs of the load benchmark against the mock Spot for hours, and samples the
+memory and CPU use of every driver process, the age of the published messages, the latency of the mock RPCs and the
+number of distinct TF frames at a fixed interval, to expose memory growth and latency drift.
+
+Besides the variables of mock_load_spot, the benchmark is configured with:
+
+- SPOT_SOAK_DURATION: seconds that the driver graphs run for after they started (default 3600).
+- SPOT_SOAK_INTERVAL: seconds between two samples (default 60).
+- SPOT_SOAK_REPORT: path of a CSV file which every sample is written to as it is taken.
+- SPOT_SOAK_MAX_RSS_GROWTH: if set, the benchmark fails if the resident memory of a driver process grew faster than
+  this many MB per hour over the second half of the run.
+
+The file is not named test_*.py, so it does not run with the other tests. Run it explicitly, e.g.
+
+    SPOT_SOAK_DURATION=36000 SPOT_SOAK_REPORT=/tmp/soak.csv pytest -s spot_driver/test/pytests/load/benchmark_soak.py
+
+The operating system does not expose how often a process allocates, so the number of minor page faults per second is
+reported as a proxy: it rises when the heap grows or memory is freed back and faulted in again. The exact allocations
+of individual code paths are covered by test_steady_state_allocations.
+"""
+
+import csv
+import dataclasses
+import os
+import pathlib
+import threading
+import time
+import typing
+
+import launch
+import launch_pytest
+import pytest
+from rclpy.qos import DurabilityPolicy, QoSProfile, qos_profile_sensor_data
+from sensor_msgs.msg import Image, JointState
+from synchros2.scope import ROSAwareScope
+from tf2_msgs.msg import TFMessage
+
+from spot_wrapper.testing.fixtures import SpotFixture
+
+from .graphs import driver_graphs_description, percentile, robot_namespace
+from .mock_load_spot import LoadProfile, RpcStatistics
+
+# Topics whose message age is sampled in the namespace of every driver graph.
+AGED_TOPICS = (("joint_states", JointState), ("camera/frontleft/image", Image))
+
+# Time that all driver graphs get to publish their first joint states.
+STARTUP_TIMEOUT = 120.0
+
+# Number of bytes in a MB, and the units of the page and CPU time counts in /proc.
+BYTES_PER_MB = 1024.0 * 1024.0
+PAGE_SIZE = os.sysconf("SC_PAGE_SIZE")
+CLOCK_TICKS = os.sysconf("SC_CLK_TCK")
+
+
+@dataclasses.dataclass(frozen=True)
+class SoakProfile:
+    """Duration, sampling interval and pass criterion of a soak benchmark run."""
+
+    duration: float = 3600.0
+    interval: float = 60.0
+    report: typing.Optional[pathlib.Path] = None
+    max_rss_growth: typing.Optional[float] = None
+
+    @classmethod
+    def from_environment(cls) -> "SoakProfile":
+        report = os.environ.get("SPOT_SOAK_REPORT")
+        max_rss_growth = os.environ.get("SPOT_SOAK_MAX_RSS_GROWTH")
+        return cls(
+            duration=float(os.environ.get("SPOT_SOAK_DURATION", cls.duration)),
+            interval=float(os.environ.get("SPOT_SOAK_INTERVAL", cls.interval)),
+            report=pathlib.Path(report) if report else None,
+            max_rss_growth=float(max_rss_growth) if max_rss_growth else None,
+        )
+
+
+@dataclasses.dataclass(frozen=True)
+class ProcessSample:
+    """Resident memory, cumulative minor page faults and cumulative CPU time of a process."""
+
+    rss_mb: float
+    minor_faults: int
+    cpu_seconds: float
+
+
+def process_name(pid: int) -> str:
+    """Get the name of a ROS node process from its __node remapping, or the name of its executable otherwise."""
+    arguments = pathlib.Path(f"/proc/{pid}/cmdline").read_bytes().decode(errors="replace").split("\0")
+    for argument in arguments:
+        if argument.startswith("__node:="):
+            return f"{argument[len('__node:='):]}[{pid}]"
+    return f"{os.path.basename(arguments[0])}[{pid}]"
+
+
+def child_processes(parent: int) -> typing.List[int]:
+    """Get every process which descends from parent, such as the nodes started by launch."""
+    parents: typing.Dict[int, int] = {}
+    for entry in pathlib.Path("/proc").iterdir():
+        if not entry.name.isdigit():
+            continue
+        try:
+            # The name of the executable is in parentheses and may contain spaces, so the fields follow the last one.
+            fields = (entry / "stat").read_text().rsplit(")", 1)[1].split()
+        except (OSError, IndexError):
+            continue
+        parents[int(entry.name)] = int(fields[1])
+    descendants: typing.List[int] = []
+    frontier = [parent]
+    while frontier:
+        current = frontier.pop()
+        children = [pid for pid, ppid in parents.items() if ppid == current]
+        descendants.extend(children)
+        frontier.extend(children)
+    return descendants
+
+
+def sample_process(pid: int) -> typing.Optional[ProcessSample]:
+    """Sample a process, or return None if it exited in the meantime."""
+    try:
+        fields = pathlib.Path(f"/proc/{pid}/stat").read_text().rsplit(")", 1)[1].split()
+        resident_pages = int(pathlib.Path(f"/proc/{pid}/statm").read_text().split()[1])
+    except (OSError, IndexError):
+        return None
+    # Fields after the name start with the state, so minflt, utime and stime are fields 10, 14 and 15 of stat(5).
+    return ProcessSample(
+        rss_mb=resident_pages * PAGE_SIZE / BYTES_PER_MB,
+        minor_faults=int(fields[7]),
+        cpu_seconds=(int(fields[11]) + int(fields[12])) / CLOCK_TICKS,
+    )
+
+
+def growth_per_hour(points: typing.Sequence[typing.Tuple[float, float]]) -> float:
+    """Get the least squares slope of (seconds, value) points per hour, or zero with fewer than two points."""
+    if len(points) < 2:
+        return 0.0
+    mean_t = sum(t for t, _ in points) / len(points)
+    mean_v = sum(v for _, v in points) / len(points)
+    variance = sum((t - mean_t) ** 2 for t, _ in points)
+    if variance == 0.0:
+        return 0.0
+    return 3600.0 * sum((t - mean_t) * (v - mean_v) for t, v in points) / variance
+
+
+@pytest.fixture
+def soak_profile() -> SoakProfile:
+    return SoakProfile.from_environment()
+
+
+@launch_pytest.fixture
+def soak_graph_description(
+    load_spot: SpotFixture, domain_id: int, load_profile: LoadProfile
+) -> typing.Iterator[launch.LaunchDescription]:
+    with driver_graphs_description(load_spot, domain_id, load_profile) as description:
+        yield description
+
+
+@pytest.mark.launch(fixture=soak_graph_description)
+def test_soak(
+    load_spot: SpotFixture,
+    load_ros: ROSAwareScope,
+    load_profile: LoadProfile,
+    rpc_statistics: RpcStatistics,
+    soak_profile: SoakProfile,
+) -> None:
+    """Samples the memory, CPU, message age, RPC latency and TF frames of the driver graphs until the run ends."""
+    namespaces = [robot_namespace(load_spot, index) for index in range(load_profile.robots)]
+    lock = threading.Lock()
+    ages: typing.Dict[typing.Tuple[str, str], typing.List[float]] = {
+        (namespace, topic): [] for namespace in namespaces for topic, _ in AGED_TOPICS
+    }
+    tf_frames: typing.Dict[str, typing.Set[str]] = {"tf": set(), "tf_static": set()}
+
+    def on_message(key: typing.Tuple[str, str]) -> typing.Callable[[typing.Any], None]:
+        def callback(message: typing.Any) -> None:
+            # The driver stamps messages with the acquisition time on the clock of the host, which is the wall clock.
+            age = time.time() - (message.header.stamp.sec + message.header.stamp.nanosec * 1e-9)
+            with lock:
+                ages[key].append(age)
+
+        return callback
+
+    def on_tf(topic: str) -> typing.Callable[[TFMessage], None]:
+        def callback(message: TFMessage) -> None:
+            with lock:
+                tf_frames[topic].update(transform.child_frame_id for transform in message.transforms)
+
+        return callback
+
+    for namespace in namespaces:
+        for topic, message_type in AGED_TOPICS:
+            load_ros.node.create_subscription(
+                message_type, f"/{namespace}/{topic}", on_message((namespace, topic)), qos_profile_sensor_data
+            )
+    load_ros.node.create_subscription(TFMessage, "/tf", on_tf("tf"), qos_profile_sensor_data)
+    load_ros.node.create_subscription(
+        TFMessage, "/tf_static", on_tf("tf_static"), QoSProfile(depth=100, durability=DurabilityPolicy.TRANSIENT_LOCAL)
+    )
+
+    # Startup: wait until every graph published joint states, so that the first sample is taken in steady state.
+    start = time.monotonic()
+    while time.monotonic() - start < STARTUP_TIMEOUT:
+        with lock:
+            if all(ages[(namespace, "joint_states")] for namespace in namespaces):
+                break
+        time.sleep(0.1)
+
+    report = soak_profile.report.open("w", newline="") if soak_profile.report is not None else None
+    writer = csv.writer(report) if report is not None else None
+    if writer is not None:
+        writer.writerow(("elapsed_s", "source", "name", "metric", "value"))
+
+    print(f"\nSoak benchmark with {load_profile} and {soak_profile}")
+    rss_history: typing.Dict[str, typing.List[typing.Tuple[float, float]]] = {}
+    first_p95: typing.Dict[typing.Tuple[str, str], float] = {}
+    last_p95: typing.Dict[typing.Tuple[str, str], float] = {}
+    previous: typing.Dict[int, typing.Tuple[float, ProcessSample]] = {}
+    silent_namespaces: typing.List[str] = []
+    soak_start = time.monotonic()
+    with lock:
+        for values in ages.values():
+            values.clear()
+    rpc_statistics.reset()
+    try:
+        while True:
+            time.sleep(soak_profile.interval)
+            now = time.monotonic()
+            elapsed = now - soak_start
+            rows: typing.List[typing.Tuple[str, str, str, float]] = []
+
+            for pid in child_processes(os.getpid()):
+                sample = sample_process(pid)
+                if sample is None:
+                    continue
+                name = process_name(pid)
+                rows.append(("process", name, "rss_mb", sample.rss_mb))
+                rss_history.setdefault(name, []).append((elapsed, sample.rss_mb))
+                if pid in previous:
+                    previous_time, previous_sample = previous[pid]
+                    window = now - previous_time
+                    faults = sample.minor_faults - previous_sample.minor_faults
+                    cpu_seconds = sample.cpu_seconds - previous_sample.cpu_seconds
+                    rows.append(("process", name, "minor_faults_per_s", faults / window))
+                    rows.append(("process", name, "cpu_percent", 100.0 * cpu_seconds / window))
+                previous[pid] = (now, sample)
+
+            with lock:
+                window_ages = {key: list(values) for key, values in ages.items()}
+                for values in ages.values():
+                    values.clear()
+                frame_counts = {topic: len(frames) for topic, frames in tf_frames.items()}
+            silent_namespaces = [namespace for namespace in namespaces if not window_ages[(namespace, "joint_states")]]
+            for (namespace, topic), values in window_ages.items():
+                rows.append((namespace, topic, "rate_hz", len(values) / soak_profile.interval))
+                rows.append((namespace, topic, "age_p50_s", percentile(values, 0.5)))
+                rows.append((namespace, topic, "age_p95_s", percentile(values, 0.95)))
+                rows.append((namespace, topic, "age_p99_s", percentile(values, 0.99)))
+                if values:
+                    first_p95.setdefault((namespace, topic), percentile(values, 0.95))
+                    last_p95[(namespace, topic)] = percentile(values, 0.95)
+
+            for rpc, (durations, peak_in_flight) in sorted(rpc_statistics.snapshot().items()):
+                rows.append(("mock", rpc, "calls_per_s", len(durations) / soak_profile.interval))
+                rows.append(("mock", rpc, "latency_p95_s", percentile(durations, 0.95)))
+                rows.append(("mock", rpc, "peak_in_flight", float(peak_in_flight)))
+            rpc_statistics.reset()
+
+            for topic, count in frame_counts.items():
+                rows.append(("tf", topic, "child_frames", float(count)))
+
+            print(f"--- {elapsed:.0f} s")
+            for row in rows:
+                print("{:<24} {:<36} {:<20} {:.4f}".format(*row))
+            if writer is not None:
+                writer.writerows((f"{elapsed:.1f}",) + row for row in rows)
+                report.flush()
+
+            if elapsed >= soak_profile.duration:
+                break
+    finally:
+        if report is not None:
+            report.close()
+
+    # Memory growth is fitted over the second half of the run, after caches and pools reached their steady size.
+    print("\nResident memory growth over the second half of the run:")
+    growth = {}
+    for name, history in sorted(rss_history.items()):
+        growth[name] = growth_per_hour([(t, rss) for t, rss in history if t >= soak_profile.duration / 2.0])
+        print(f"{name:<48} {growth[name]:+.2f} MB/h")
+    print("\nDrift of the 95th percentile of the message age between the first and the last sample:")
+    for key, p95 in sorted(last_p95.items()):
+        print(f"{'/'.join(key):<48} {1e3 * first_p95[key]:.1f} ms -> {1e3 * p95:.1f} ms")
+
+    assert not silent_namespaces, f"{silent_namespaces} stopped publishing joint states"
+    if soak_profile.max_rss_growth is not None:
+        for name, rate in growth.items():
+            assert rate <= soak_profile.max_rss_growth, f"{name} grew by {rate:.2f} MB/h"
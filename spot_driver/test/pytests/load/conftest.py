@@ -0,0 +1,44 @@
+# Copyright (c) 2024 The AI Institute LLC. See LICENSE file for more info.
+
+"""
+Fixtures of the load benchmark, which runs the real driver nodes against a mock Spot that serves recorded data at
+configurable rates and latencies. See mock_load_spot for its configuration.
+"""
+
+import typing
+
+import pytest
+import synchros2.scope as ros_scope
+from synchros2.scope import ROSAwareScope
+
+import spot_wrapper.testing
+
+from .mock_load_spot import PROFILE, STATISTICS, LoadMockSpot, LoadProfile, RpcStatistics
+
+
+# pylint: disable=invalid-name
+@spot_wrapper.testing.fixture
+class load_spot(LoadMockSpot):
+    """
+    This is a factory that returns an instance of LoadMockSpot, served by a local GRPC server which is shut down when
+    the fixture is disposed.
+    """
+
+
+# pylint: enable=invalid-name
+
+
+@pytest.fixture
+def load_profile() -> LoadProfile:
+    return PROFILE
+
+
+@pytest.fixture
+def rpc_statistics() -> RpcStatistics:
+    return STATISTICS
+
+
+@pytest.fixture
+def load_ros(domain_id: int) -> typing.Iterator[ROSAwareScope]:
+    with ros_scope.top(global_=True, namespace="load_benchmark", domain_id=domain_id) as top:
+        yield top
@@ -0,0 +1,76 @@
+# Copyright (c) 2024 The AI Institute LLC. See LICENSE file for more info.
+
+"""
+Helpers shared by the load and soak benchmarks, which launch one or more complete driver graphs against the mock Spot
+of mock_load_spot.
+"""
+
+import contextlib
+import math
+import tempfile
+import typing
+
+import launch
+import launch.actions
+import launch.substitutions
+import launch_pytest.actions
+import launch_ros.substitutions
+import yaml
+
+from spot_wrapper.testing.fixtures import SpotFixture
+
+from .mock_load_spot import LoadProfile
+
+
+def robot_namespace(spot: SpotFixture, index: int) -> str:
+    return f"{spot.api.name}{index}"
+
+
+def percentile(values: typing.Sequence[float], fraction: float) -> float:
+    """Get the nearest-rank percentile of values, or NaN if there are none."""
+    if not values:
+        return math.nan
+    ordered = sorted(values)
+    return ordered[max(math.ceil(fraction * len(ordered)) - 1, 0)]
+
+
+@contextlib.contextmanager
+def driver_graphs_description(
+    spot: SpotFixture, domain_id: int, profile: LoadProfile
+) -> typing.Iterator[launch.LaunchDescription]:
+    """Describe one driver graph per robot of the profile, all connected to the same mock Spot."""
+    with tempfile.NamedTemporaryFile(mode="w", suffix="config.yaml") as temp:
+        data = {
+            "username": "user",
+            "password": "pass",
+            "hostname": spot.address,
+            "port": spot.port,
+            "certificate": str(spot.certificate_path),
+            "publish_depth_registered": False,
+        }
+        yaml.dump({"/**": {"ros__parameters": data}}, temp.file)
+        temp.file.close()
+
+        # Every graph connects to the same mock, so their requests compete for its channel like a fleet which reboots
+        # at once.
+        graphs = [
+            launch.actions.IncludeLaunchDescription(
+                launch.launch_description_sources.PythonLaunchDescriptionSource(
+                    launch.substitutions.PathJoinSubstitution(
+                        [launch_ros.substitutions.FindPackageShare("spot_driver"), "launch", "spot_driver.launch.py"]
+                    )
+                ),
+                launch_arguments=[
+                    ("config_file", temp.file.name),
+                    ("spot_name", robot_namespace(spot, index)),
+                    ("compose_driver_nodes", str(profile.compose)),
+                    ("depth_registered_mode", "disable"),
+                ],
+            )
+            for index in range(profile.robots)
+        ]
+        yield launch.LaunchDescription(
+            [launch.actions.SetEnvironmentVariable("ROS_DOMAIN_ID", str(domain_id))]
+            + graphs
+            + [launch_pytest.actions.ReadyToTest()],
+        )
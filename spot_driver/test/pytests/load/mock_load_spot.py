@@ -0,0 +1,238 @@
+# Copyright (c) 2024 The AI Institute LLC. See LICENSE file for more info.
+
+"""
+Mock Spot of the load benchmark, which serves recorded or synthetic data at configurable rates and latencies.
+
+The benchmark is configured with environment variables, since the launch fixtures cannot be parametrized:
+
+- SPOT_LOAD_ROBOTS: number of driver graphs launched against the mock at the same time (default 1).
+- SPOT_LOAD_COMPOSE: if true, the driver nodes of each graph share one connection in a container (default false).
+- SPOT_LOAD_DURATION: seconds over which the topic rates are measured (default 30).
+- SPOT_LOAD_DATA_RATE: rate in Hz at which the mock robot produces new robot states and images (default 50).
+- SPOT_LOAD_RPC_LATENCY: seconds that the mock waits before answering the robot state and world object RPCs
+  (default 0).
+- SPOT_LOAD_IMAGE_LATENCY: seconds that the mock waits before answering an image RPC (default 0.02).
+- SPOT_LOAD_RECORDING: directory with recorded responses, see RecordedData. Synthetic data is served without it.
+- SPOT_LOAD_REPORT: path of a CSV file which the benchmark writes its measurements to.
+"""
+
+# We disable Pylint warnings for all Protobuf files which contain objects with
+# dynamically added member attributes.
+# pylint: disable=no-member
+
+import collections
+import contextlib
+import dataclasses
+import os
+import pathlib
+import threading
+import time
+import typing
+
+import grpc
+from bosdyn.api.image_pb2 import GetImageRequest, GetImageResponse, Image, ImageCapture, ImageResponse, ImageSource
+from bosdyn.api.robot_state_pb2 import RobotState, RobotStateRequest, RobotStateResponse
+from bosdyn.api.world_object_pb2 import ListWorldObjectRequest, ListWorldObjectResponse
+from bosdyn.client.frame_helpers import BODY_FRAME_NAME, ODOM_FRAME_NAME
+
+from spot_wrapper.testing.mocks import MockSpot
+
+# Size of the synthetic images. Depth images are served at the resolution of Spot's depth cameras.
+SYNTHETIC_RGB_SIZE = (640, 480)
+SYNTHETIC_DEPTH_SIZE = (424, 240)
+
+
+def _environment_flag(name: str, default: bool) -> bool:
+    return os.environ.get(name, str(default)).lower() in ("1", "true", "yes")
+
+
+@dataclasses.dataclass(frozen=True)
+class LoadProfile:
+    """Rates, latencies and scale of a load benchmark run."""
+
+    robots: int = 1
+    compose: bool = False
+    duration: float = 30.0
+    data_rate: float = 50.0
+    rpc_latency: float = 0.0
+    image_latency: float = 0.02
+    recording: typing.Optional[pathlib.Path] = None
+    report: typing.Optional[pathlib.Path] = None
+
+    @classmethod
+    def from_environment(cls) -> "LoadProfile":
+        recording = os.environ.get("SPOT_LOAD_RECORDING")
+        report = os.environ.get("SPOT_LOAD_REPORT")
+        return cls(
+            robots=int(os.environ.get("SPOT_LOAD_ROBOTS", cls.robots)),
+            compose=_environment_flag("SPOT_LOAD_COMPOSE", cls.compose),
+            duration=float(os.environ.get("SPOT_LOAD_DURATION", cls.duration)),
+            data_rate=float(os.environ.get("SPOT_LOAD_DATA_RATE", cls.data_rate)),
+            rpc_latency=float(os.environ.get("SPOT_LOAD_RPC_LATENCY", cls.rpc_latency)),
+            image_latency=float(os.environ.get("SPOT_LOAD_IMAGE_LATENCY", cls.image_latency)),
+            recording=pathlib.Path(recording) if recording else None,
+            report=pathlib.Path(report) if report else None,
+        )
+
+
+@dataclasses.dataclass
+class RecordedData:
+    """
+    Responses which the mock serves instead of synthetic data. Each one is read from a serialized protobuf message in
+    the recording directory, if the file exists:
+
+    - robot_state.pb: a bosdyn.api.RobotState.
+    - get_image_response.pb: a bosdyn.api.GetImageResponse. Its image responses are matched to requests by source name.
+    - list_world_object_response.pb: a bosdyn.api.ListWorldObjectResponse.
+    """
+
+    robot_state: typing.Optional[RobotState] = None
+    image_responses: typing.Dict[str, ImageResponse] = dataclasses.field(default_factory=dict)
+    world_objects: typing.Optional[ListWorldObjectResponse] = None
+
+    @classmethod
+    def load(cls, directory: typing.Optional[pathlib.Path]) -> "RecordedData":
+        data = cls()
+        if directory is None:
+            return data
+        if (path := directory / "robot_state.pb").exists():
+            data.robot_state = RobotState.FromString(path.read_bytes())
+        if (path := directory / "get_image_response.pb").exists():
+            response = GetImageResponse.FromString(path.read_bytes())
+            data.image_responses = {
+                image_response.source.name: image_response for image_response in response.image_responses
+            }
+        if (path := directory / "list_world_object_response.pb").exists():
+            data.world_objects = ListWorldObjectResponse.FromString(path.read_bytes())
+        return data
+
+
+class RpcStatistics:
+    """Thread-safe count, duration and peak concurrency of the RPCs served by the mock."""
+
+    def __init__(self) -> None:
+        self._lock = threading.Lock()
+        self._durations: typing.Dict[str, typing.List[float]] = collections.defaultdict(list)
+        self._in_flight: typing.Dict[str, int] = collections.defaultdict(int)
+        self._peak_in_flight: typing.Dict[str, int] = collections.defaultdict(int)
+
+    @contextlib.contextmanager
+    def measure(self, rpc: str) -> typing.Iterator[None]:
+        """Measure one call of an RPC, from when its handler starts until it returns."""
+        start = time.monotonic()
+        with self._lock:
+            self._in_flight[rpc] += 1
+            self._peak_in_flight[rpc] = max(self._peak_in_flight[rpc], self._in_flight[rpc])
+        try:
+            yield
+        finally:
+            with self._lock:
+                self._in_flight[rpc] -= 1
+                self._durations[rpc].append(time.monotonic() - start)
+
+    def reset(self) -> None:
+        """Forget the calls so far, e.g. those made while the nodes were starting."""
+        with self._lock:
+            self._durations.clear()
+            self._peak_in_flight.clear()
+
+    def snapshot(self) -> typing.Dict[str, typing.Tuple[typing.List[float], int]]:
+        """Get the durations and the peak concurrency of each RPC."""
+        with self._lock:
+            return {rpc: (list(durations), self._peak_in_flight[rpc]) for rpc, durations in self._durations.items()}
+
+
+PROFILE = LoadProfile.from_environment()
+RECORDING = RecordedData.load(PROFILE.recording)
+STATISTICS = RpcStatistics()
+
+
+def _data_time() -> float:
+    """Get the time of the latest data of the mock robot, which advances in steps of the data rate."""
+    period = 1.0 / PROFILE.data_rate
+    return (time.time() // period) * period
+
+
+def _set_timestamp(timestamp: typing.Any, seconds: float) -> None:
+    timestamp.seconds = int(seconds)
+    timestamp.nanos = int(round((seconds - int(seconds)) * 1e9))
+
+
+def _synthetic_image_response(source_name: str, acquisition_time: float) -> ImageResponse:
+    is_depth = "depth" in source_name
+    cols, rows = SYNTHETIC_DEPTH_SIZE if is_depth else SYNTHETIC_RGB_SIZE
+    response = ImageResponse()
+    response.status = ImageResponse.Status.STATUS_OK
+    response.source.name = source_name
+    response.source.cols = cols
+    response.source.rows = rows
+    response.source.image_type = (
+        ImageSource.ImageType.IMAGE_TYPE_DEPTH if is_depth else ImageSource.ImageType.IMAGE_TYPE_VISUAL
+    )
+    response.source.pinhole.intrinsics.focal_length.x = 330.0
+    response.source.pinhole.intrinsics.focal_length.y = 330.0
+    response.source.pinhole.intrinsics.principal_point.x = cols / 2.0
+    response.source.pinhole.intrinsics.principal_point.y = rows / 2.0
+    sensor_frame = source_name.split("_")[0] + "_fisheye"
+    shot: ImageCapture = response.shot
+    shot.frame_name_image_sensor = sensor_frame
+    edges = shot.transforms_snapshot.child_to_parent_edge_map
+    edges[ODOM_FRAME_NAME].parent_frame_name = ""
+    edges[BODY_FRAME_NAME].parent_frame_name = ODOM_FRAME_NAME
+    edges[BODY_FRAME_NAME].parent_tform_child.rotation.w = 1.0
+    edges[sensor_frame].parent_frame_name = BODY_FRAME_NAME
+    edges[sensor_frame].parent_tform_child.rotation.w = 1.0
+    shot.image.cols = cols
+    shot.image.rows = rows
+    shot.image.format = Image.Format.FORMAT_RAW
+    if is_depth:
+        shot.image.pixel_format = Image.PixelFormat.PIXEL_FORMAT_DEPTH_U16
+        shot.image.data = bytes(cols * rows * 2)
+    else:
+        shot.image.pixel_format = Image.PixelFormat.PIXEL_FORMAT_RGB_U8
+        shot.image.data = bytes(cols * rows * 3)
+    _set_timestamp(shot.acquisition_time, acquisition_time)
+    return response
+
+
+# pylint: disable=invalid-name,unused-argument
+class LoadMockSpot(MockSpot):
+    """
+    A MockSpot that answers the robot state, image and world object RPCs on its own, after the configured latency,
+    instead of waiting for the test to provide each response. The time sync, authentication and directory services
+    are answered by MockSpot.
+    """
+
+    def GetRobotState(self, request: RobotStateRequest, context: grpc.ServicerContext) -> RobotStateResponse:
+        with STATISTICS.measure("GetRobotState"):
+            time.sleep(PROFILE.rpc_latency)
+            response = RobotStateResponse()
+            response.robot_state.CopyFrom(RECORDING.robot_state if RECORDING.robot_state else self.robot_state)
+            _set_timestamp(response.robot_state.kinematic_state.acquisition_timestamp, _data_time())
+            return response
+
+    def GetImage(self, request: GetImageRequest, context: grpc.ServicerContext) -> GetImageResponse:
+        with STATISTICS.measure("GetImage"):
+            time.sleep(PROFILE.image_latency)
+            acquisition_time = _data_time()
+            response = GetImageResponse()
+            for image_request in request.image_requests:
+                if image_request.image_source_name in RECORDING.image_responses:
+                    image_response = response.image_responses.add()
+                    image_response.CopyFrom(RECORDING.image_responses[image_request.image_source_name])
+                    _set_timestamp(image_response.shot.acquisition_time, acquisition_time)
+                else:
+                    response.image_responses.append(
+                        _synthetic_image_response(image_request.image_source_name, acquisition_time)
+                    )
+            return response
+
+    def ListWorldObjects(
+        self, request: ListWorldObjectRequest, context: grpc.ServicerContext
+    ) -> ListWorldObjectResponse:
+        with STATISTICS.measure("ListWorldObjects"):
+            time.sleep(PROFILE.rpc_latency)
+            return RECORDING.world_objects if RECORDING.world_objects else ListWorldObjectResponse()
+
+
+# pylint: enable=invalid-name,unused-argument
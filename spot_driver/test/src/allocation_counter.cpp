@@ -0,0 +1,34 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <spot_driver/allocation_counter.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local std::size_t thread_allocation_count = 0;
+}  // namespace
+
+// The array and nothrow forms of operator new forward to this one, so every allocation through new is counted.
+void* operator new(std::size_t size) {
+  ++thread_allocation_count;
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t /*size*/) noexcept {
+  std::free(pointer);
+}
+
+namespace spot_ros2::test {
+std::size_t getThreadAllocationCount() {
+  return thread_allocation_count;
+}
+}  // namespace spot_ros2::test
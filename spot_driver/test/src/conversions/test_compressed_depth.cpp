@@ -0,0 +1,106 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <sensor_msgs/image_encodings.hpp>
+#include <sensor_msgs/msg/compressed_image.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/conversions/compressed_depth.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+
+// Size of the configuration header of compressed_depth_image_transport in front of the payload.
+constexpr std::size_t kConfigHeaderSize{12};
+
+sensor_msgs::msg::Image makeDepthImage(const std::uint32_t width, const std::uint32_t height,
+                                       const std::vector<std::uint16_t>& depths) {
+  sensor_msgs::msg::Image image;
+  image.header.frame_id = "frontleft_fisheye";
+  image.width = width;
+  image.height = height;
+  image.encoding = sensor_msgs::image_encodings::TYPE_16UC1;
+  image.step = width * sizeof(std::uint16_t);
+  image.data.resize(depths.size() * sizeof(std::uint16_t));
+  std::memcpy(image.data.data(), depths.data(), image.data.size());
+  return image;
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(CompressedDepth, ToCompressedDepthFormat) {
+  // GIVEN the names of the supported formats and an unsupported format
+  // WHEN we convert them to a CompressedDepthFormat
+  // THEN the supported formats are converted and the unsupported format returns an error
+  EXPECT_THAT(toCompressedDepthFormat("png").value(), Eq(CompressedDepthFormat::PNG));
+  EXPECT_THAT(toCompressedDepthFormat("rvl").value(), Eq(CompressedDepthFormat::RVL));
+  EXPECT_THAT(toCompressedDepthFormat("zstd").has_value(), IsFalse());
+}
+
+TEST(CompressedDepth, CompressPngIsLossless) {
+  // GIVEN a depth image with valid and invalid (zero) pixels
+  const auto image = makeDepthImage(4, 2, {0, 1000, 1001, 65535, 0, 0, 2500, 3});
+
+  // WHEN we compress it as PNG
+  sensor_msgs::msg::CompressedImage compressed;
+  const auto result = compressDepthImage(image, CompressedDepthFormat::PNG, compressed);
+
+  // THEN the message has the format and header of compressed_depth_image_transport, and the PNG decodes to the image
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(compressed.format, StrEq("16UC1; compressedDepth png"));
+  EXPECT_THAT(compressed.header.frame_id, StrEq("frontleft_fisheye"));
+  const std::vector<unsigned char> png(compressed.data.begin() + kConfigHeaderSize, compressed.data.end());
+  const auto decoded = cv::imdecode(png, cv::IMREAD_UNCHANGED);
+  ASSERT_THAT(decoded.type(), Eq(CV_16UC1));
+  EXPECT_THAT(decoded.at<std::uint16_t>(0, 1), Eq(1000));
+  EXPECT_THAT(decoded.at<std::uint16_t>(0, 3), Eq(65535));
+  EXPECT_THAT(decoded.at<std::uint16_t>(1, 2), Eq(2500));
+}
+
+TEST(CompressedDepth, CompressRvl) {
+  // GIVEN a depth image with one invalid pixel followed by one valid pixel
+  const auto image = makeDepthImage(2, 1, {0, 5});
+
+  // WHEN we compress it with RVL
+  sensor_msgs::msg::CompressedImage compressed;
+  const auto result = compressDepthImage(image, CompressedDepthFormat::RVL, compressed);
+
+  // THEN the header is followed by the size of the image and a single word which holds a run of one zero, a run of one
+  // nonzero pixel and the zigzag-encoded difference of 5, in nibbles from the most significant one down
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(compressed.format, StrEq("16UC1; compressedDepth rvl"));
+  ASSERT_THAT(compressed.data, SizeIs(kConfigHeaderSize + 12));
+  const std::vector<unsigned char> payload(compressed.data.begin() + kConfigHeaderSize, compressed.data.end());
+  std::uint32_t words[3];
+  std::memcpy(words, payload.data(), sizeof(words));
+  EXPECT_THAT(words, ElementsAre(2U, 1U, 0x11A10000U));
+}
+
+TEST(CompressedDepth, CompressRejectsColorImage) {
+  // GIVEN a color image
+  sensor_msgs::msg::Image image;
+  image.width = 2;
+  image.height = 1;
+  image.encoding = sensor_msgs::image_encodings::BGR8;
+  image.step = 6;
+  image.data.resize(6);
+
+  // WHEN we compress it as a depth image
+  sensor_msgs::msg::CompressedImage compressed;
+  const auto result = compressDepthImage(image, CompressedDepthFormat::PNG, compressed);
+
+  // THEN an error is returned
+  EXPECT_THAT(result.has_value(), IsFalse());
+}
+}  // namespace spot_ros2::test
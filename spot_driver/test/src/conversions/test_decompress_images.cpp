@@ -0,0 +1,92 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <spot_driver/conversions/decompress_images.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::StrEq;
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(DecompressImages, DecodeRunLengthEncoding8Bit) {
+  // GIVEN run-length encoded data with 1 byte pixels: three pixels of value 7 and two pixels of value 9
+  const std::string data{'\x03', '\x07', '\x02', '\x09'};
+  std::vector<uint8_t> output(5);
+
+  // WHEN we decode the data
+  const auto result = decodeRunLengthEncoding(data, 1, output);
+
+  // THEN decoding succeeds and the runs are expanded
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(output, ElementsAre(7, 7, 7, 9, 9));
+}
+
+TEST(DecompressImages, DecodeRunLengthEncoding16Bit) {
+  // GIVEN run-length encoded data with little-endian 2 byte pixels: two pixels of value 0x0102 and one of value 0x0304
+  const std::string data{'\x02', '\x02', '\x01', '\x01', '\x04', '\x03'};
+  std::vector<uint8_t> output(6);
+
+  // WHEN we decode the data
+  const auto result = decodeRunLengthEncoding(data, 2, output);
+
+  // THEN decoding succeeds and the runs are expanded without changing the byte order
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(output, ElementsAre(0x02, 0x01, 0x02, 0x01, 0x04, 0x03));
+}
+
+TEST(DecompressImages, DecodeRunLengthEncodingSizeMismatch) {
+  // GIVEN run-length encoded data which expands to four 1 byte pixels
+  const std::string data{'\x04', '\x01'};
+
+  // WHEN we decode the data into buffers that are too small or too large
+  std::vector<uint8_t> too_small(3);
+  std::vector<uint8_t> too_large(5);
+
+  // THEN decoding fails
+  EXPECT_THAT(decodeRunLengthEncoding(data, 1, too_small).has_value(), IsFalse());
+  EXPECT_THAT(decodeRunLengthEncoding(data, 1, too_large).has_value(), IsFalse());
+}
+
+TEST(DecompressImages, DecodeRunLengthEncodingTruncatedRun) {
+  // GIVEN run-length encoded data with 2 byte pixels where the last run is missing a byte
+  const std::string data{'\x01', '\x02', '\x01', '\x01', '\x04'};
+  std::vector<uint8_t> output(4);
+
+  // WHEN we decode the data
+  // THEN decoding fails
+  EXPECT_THAT(decodeRunLengthEncoding(data, 2, output).has_value(), IsFalse());
+}
+
+TEST(DecompressImages, UsesGivenHeader) {
+  // GIVEN a raw 2x1 depth image capture, and a header that was already created for it
+  bosdyn::api::ImageCapture image_capture;
+  auto* image = image_capture.mutable_image();
+  image->set_rows(1);
+  image->set_cols(2);
+  image->set_format(bosdyn::api::Image_Format_FORMAT_RAW);
+  image->set_pixel_format(bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_DEPTH_U16);
+  image->set_data(std::string{'\x01', '\x00', '\x02', '\x00'});
+  std_msgs::msg::Header header;
+  header.frame_id = "robot/frontleft";
+  header.stamp.sec = 42;
+
+  // WHEN we convert the image capture with this header
+  sensor_msgs::msg::Image image_msg;
+  const auto result = getDecompressImageMsg(image_capture, header, image_msg, JpegDecoderBackend::OPENCV);
+
+  // THEN the conversion succeeds and the message has the given header
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(image_msg.header.frame_id, StrEq("robot/frontleft"));
+  EXPECT_THAT(image_msg.header.stamp.sec, Eq(42));
+  EXPECT_THAT(image_msg.data, ElementsAre(1, 0, 2, 0));
+}
+}  // namespace spot_ros2::test
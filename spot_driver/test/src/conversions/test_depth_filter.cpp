@@ -0,0 +1,170 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <sensor_msgs/image_encodings.hpp>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/conversions/depth_filter.hpp>
+#include <spot_driver/image_test_tools.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+using ::testing::DoubleEq;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::StrEq;
+
+// Depth image units per meter, as Spot sends them.
+constexpr double kDepthScale = 1000.0;
+
+sensor_msgs::msg::Image createDepthImage(const std::uint32_t width, const std::uint32_t height,
+                                         const std::vector<std::uint16_t>& depths) {
+  sensor_msgs::msg::Image image;
+  image.header.frame_id = "camera";
+  image.width = width;
+  image.height = height;
+  image.encoding = sensor_msgs::image_encodings::TYPE_16UC1;
+  image.step = width * sizeof(std::uint16_t);
+  image.data.resize(static_cast<std::size_t>(image.step) * height);
+  std::memcpy(image.data.data(), depths.data(), image.data.size());
+  return image;
+}
+
+std::vector<std::uint16_t> getDepths(const sensor_msgs::msg::Image& image) {
+  std::vector<std::uint16_t> depths(image.data.size() / sizeof(std::uint16_t));
+  std::memcpy(depths.data(), image.data.data(), image.data.size());
+  return depths;
+}
+
+// A depth image in which every 2x2 block has a different mix of valid and invalid (0) depths.
+sensor_msgs::msg::Image createBlockDepthImage() {
+  return createDepthImage(4, 4,
+                          {
+                              0, 500, 1000, 1000,   //
+                              800, 900, 1000, 1200,  //
+                              0, 0, 2000, 0,         //
+                              0, 0, 0, 3000,         //
+                          });
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(DepthFilter, DecimateKeepsNearestValidDepth) {
+  // GIVEN a depth image with invalid pixels
+  const auto image = createBlockDepthImage();
+  const auto info = createCameraInfo(4, 4);
+
+  // WHEN we decimate it by 2 without filling holes
+  DepthFilterOptions options;
+  options.decimation = 2;
+  options.fill_holes = false;
+  sensor_msgs::msg::Image filtered;
+  sensor_msgs::msg::CameraInfo filtered_info;
+  const auto result = filterDepthImage(image, info, kDepthScale, options, filtered, filtered_info);
+
+  // THEN every pixel keeps the nearest valid depth of its block, and blocks without a valid depth stay invalid
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(filtered.width, Eq(2U));
+  EXPECT_THAT(filtered.height, Eq(2U));
+  EXPECT_THAT(filtered.step, Eq(4U));
+  EXPECT_THAT(filtered.encoding, StrEq(sensor_msgs::image_encodings::TYPE_16UC1));
+  EXPECT_THAT(filtered.header.frame_id, StrEq("camera"));
+  EXPECT_THAT(getDepths(filtered), ElementsAre(500, 1000, 0, 2000));
+}
+
+TEST(DepthFilter, FillHolesWithMedianOfNeighbors) {
+  // GIVEN a depth image in which one block has no valid depth
+  const auto image = createBlockDepthImage();
+  const auto info = createCameraInfo(4, 4);
+
+  // WHEN we decimate it by 2 and fill holes
+  DepthFilterOptions options;
+  options.decimation = 2;
+  options.fill_holes = true;
+  sensor_msgs::msg::Image filtered;
+  sensor_msgs::msg::CameraInfo filtered_info;
+  const auto result = filterDepthImage(image, info, kDepthScale, options, filtered, filtered_info);
+
+  // THEN the empty block gets the median depth of its neighbors
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(getDepths(filtered), ElementsAre(500, 1000, 1000, 2000));
+}
+
+TEST(DepthFilter, ClipDepthsOutsideOfRange) {
+  // GIVEN a depth image with depths from 0.5 to 3 meters
+  const auto image = createBlockDepthImage();
+  const auto info = createCameraInfo(4, 4);
+
+  // WHEN we filter it with a range from 0.6 to 2.5 meters
+  DepthFilterOptions options;
+  options.decimation = 2;
+  options.fill_holes = false;
+  options.min_range = 0.6;
+  options.max_range = 2.5;
+  sensor_msgs::msg::Image filtered;
+  sensor_msgs::msg::CameraInfo filtered_info;
+  const auto result = filterDepthImage(image, info, kDepthScale, options, filtered, filtered_info);
+
+  // THEN the depths outside of the range are ignored by the decimation
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(getDepths(filtered), ElementsAre(800, 1000, 0, 2000));
+}
+
+TEST(DepthFilter, ScaleIntrinsicsAndDropPartialBlocks) {
+  // GIVEN a depth image whose dimensions are not multiples of the decimation
+  const auto image = createDepthImage(5, 5, std::vector<std::uint16_t>(25, 1500));
+  const auto info = createCameraInfo(5, 5);
+
+  // WHEN we decimate it by 2
+  DepthFilterOptions options;
+  options.decimation = 2;
+  sensor_msgs::msg::Image filtered;
+  sensor_msgs::msg::CameraInfo filtered_info;
+  const auto result = filterDepthImage(image, info, kDepthScale, options, filtered, filtered_info);
+
+  // THEN the pixels which do not fill a whole block are left out, and the intrinsics match the filtered image
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(filtered.width, Eq(2U));
+  EXPECT_THAT(filtered.height, Eq(2U));
+  EXPECT_THAT(getDepths(filtered), ElementsAre(1500, 1500, 1500, 1500));
+  EXPECT_THAT(filtered_info.width, Eq(2U));
+  EXPECT_THAT(filtered_info.height, Eq(2U));
+  EXPECT_THAT(filtered_info.k[0], DoubleEq(50.0));
+  EXPECT_THAT(filtered_info.k[2], DoubleEq(15.5));
+  EXPECT_THAT(filtered_info.k[4], DoubleEq(50.0));
+  EXPECT_THAT(filtered_info.k[5], DoubleEq(11.5));
+  EXPECT_THAT(filtered_info.p[2], DoubleEq(15.5));
+  EXPECT_THAT(filtered_info.p[6], DoubleEq(11.5));
+}
+
+TEST(DepthFilter, RejectInvalidInputs) {
+  // GIVEN a depth image
+  const auto image = createBlockDepthImage();
+  const auto info = createCameraInfo(4, 4);
+  sensor_msgs::msg::Image filtered;
+  sensor_msgs::msg::CameraInfo filtered_info;
+
+  // WHEN we filter it with a decimation of 0 or larger than the image
+  // THEN filtering fails
+  DepthFilterOptions options;
+  options.decimation = 0;
+  EXPECT_THAT(filterDepthImage(image, info, kDepthScale, options, filtered, filtered_info).has_value(), IsFalse());
+  options.decimation = 8;
+  EXPECT_THAT(filterDepthImage(image, info, kDepthScale, options, filtered, filtered_info).has_value(), IsFalse());
+
+  // WHEN we filter an image which is not a depth image
+  // THEN filtering fails
+  auto color_image = image;
+  color_image.encoding = sensor_msgs::image_encodings::BGR8;
+  options.decimation = 2;
+  EXPECT_THAT(filterDepthImage(color_image, info, kDepthScale, options, filtered, filtered_info).has_value(),
+              IsFalse());
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,168 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <geometry_msgs/msg/transform.hpp>
+#include <sensor_msgs/image_encodings.hpp>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/conversions/depth_laser_scan.hpp>
+#include <spot_driver/image_test_tools.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+using ::testing::Each;
+using ::testing::Eq;
+using ::testing::FloatEq;
+using ::testing::FloatNear;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::StrEq;
+
+constexpr float kInf = std::numeric_limits<float>::infinity();
+
+/** @brief Camera with a ray through the optical axis in its first column and one at 45 degrees in its second. */
+sensor_msgs::msg::CameraInfo createTwoRayCameraInfo() {
+  return spot_ros2::test::createCameraInfo(2, 1, 1.0, 1.0, 0.0, 0.0);
+}
+
+sensor_msgs::msg::Image createDepthImage(const std::vector<std::uint16_t>& depths) {
+  sensor_msgs::msg::Image image;
+  image.width = static_cast<std::uint32_t>(depths.size());
+  image.height = 1;
+  image.encoding = sensor_msgs::image_encodings::TYPE_16UC1;
+  image.step = image.width * sizeof(std::uint16_t);
+  image.data.resize(image.step);
+  std::memcpy(image.data.data(), depths.data(), image.data.size());
+  return image;
+}
+
+/** @brief Transform of a camera which looks along the x axis of the scan frame, with its image x axis along -y. */
+geometry_msgs::msg::Transform createForwardCameraTransform(const double height) {
+  geometry_msgs::msg::Transform transform;
+  transform.translation.z = height;
+  transform.rotation.x = -0.5;
+  transform.rotation.y = 0.5;
+  transform.rotation.z = -0.5;
+  transform.rotation.w = 0.5;
+  return transform;
+}
+
+spot_ros2::LaserScanOptions createOptions() {
+  spot_ros2::LaserScanOptions options;
+  options.angle_increment = M_PI / 4.0;
+  return options;
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(DepthLaserScan, ResetLaserScan) {
+  // GIVEN options for a scan with beams every 45 degrees
+  const auto options = createOptions();
+
+  // WHEN we reset a scan
+  sensor_msgs::msg::LaserScan scan;
+  resetLaserScan(options, "body", builtin_interfaces::msg::Time{}, scan);
+
+  // THEN it has 8 beams from -pi which have not seen anything
+  EXPECT_THAT(scan.header.frame_id, StrEq("body"));
+  EXPECT_THAT(scan.ranges.size(), Eq(8U));
+  EXPECT_THAT(scan.ranges, Each(Eq(kInf)));
+  EXPECT_THAT(scan.angle_min, FloatEq(static_cast<float>(-M_PI)));
+  EXPECT_THAT(scan.angle_increment, FloatEq(static_cast<float>(M_PI / 4.0)));
+  EXPECT_THAT(scan.range_max, FloatEq(4.0F));
+}
+
+TEST(DepthLaserScan, AddPointsInHeightBand) {
+  // GIVEN a camera at the height of the scan which sees two points 2 m in front of it
+  const auto options = createOptions();
+  const DepthRayTable rays{createTwoRayCameraInfo()};
+  const auto image = createDepthImage({2000, 2000});
+  sensor_msgs::msg::LaserScan scan;
+  resetLaserScan(options, "body", builtin_interfaces::msg::Time{}, scan);
+
+  // WHEN we add its depth image to the scan
+  const auto result = addDepthImageToLaserScan(image, rays, 1000.0, createForwardCameraTransform(0.0), options, scan);
+
+  // THEN the beam straight ahead and the one 45 degrees to the right hit the points, and the others see nothing
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(scan.ranges[4], FloatNear(2.0F, 1e-4F));
+  EXPECT_THAT(scan.ranges[3], FloatNear(2.0F * std::sqrt(2.0F), 1e-4F));
+  EXPECT_THAT(scan.ranges[0], Eq(kInf));
+  EXPECT_THAT(scan.ranges[5], Eq(kInf));
+}
+
+TEST(DepthLaserScan, IgnorePointsOutsideOfScan) {
+  // GIVEN a camera above the height band, and one in the band which sees an invalid pixel and a point out of range
+  const auto options = createOptions();
+  const DepthRayTable rays{createTwoRayCameraInfo()};
+  sensor_msgs::msg::LaserScan scan;
+  resetLaserScan(options, "body", builtin_interfaces::msg::Time{}, scan);
+
+  // WHEN we add their depth images to the scan
+  const auto high = addDepthImageToLaserScan(createDepthImage({2000, 2000}), rays, 1000.0,
+                                             createForwardCameraTransform(1.0), options, scan);
+  const auto far = addDepthImageToLaserScan(createDepthImage({0, 5000}), rays, 1000.0,
+                                            createForwardCameraTransform(0.0), options, scan);
+
+  // THEN none of the points end up in the scan
+  ASSERT_THAT(high.has_value(), IsTrue());
+  ASSERT_THAT(far.has_value(), IsTrue());
+  EXPECT_THAT(scan.ranges, Each(Eq(kInf)));
+}
+
+TEST(DepthLaserScan, RejectMismatchedRayTable) {
+  // GIVEN a depth image with a different resolution than the ray table
+  const auto options = createOptions();
+  const DepthRayTable rays{createTwoRayCameraInfo()};
+  sensor_msgs::msg::LaserScan scan;
+  resetLaserScan(options, "body", builtin_interfaces::msg::Time{}, scan);
+
+  // WHEN we add it to the scan
+  const auto result = addDepthImageToLaserScan(createDepthImage({2000, 2000, 2000}), rays, 1000.0,
+                                               createForwardCameraTransform(0.0), options, scan);
+
+  // THEN an error is returned
+  EXPECT_THAT(result.has_value(), IsFalse());
+}
+
+TEST(DepthLaserScan, MergeLaserScans) {
+  // GIVEN two scans of the same resolution which saw obstacles in different beams
+  const auto options = createOptions();
+  sensor_msgs::msg::LaserScan scan;
+  sensor_msgs::msg::LaserScan merged;
+  resetLaserScan(options, "body", builtin_interfaces::msg::Time{}, scan);
+  resetLaserScan(options, "body", builtin_interfaces::msg::Time{}, merged);
+  scan.ranges[1] = 1.0F;
+  scan.ranges[2] = 3.0F;
+  merged.ranges[2] = 2.0F;
+
+  // WHEN we merge them
+  const auto result = mergeLaserScans(scan, merged);
+
+  // THEN every beam keeps the shorter range
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(merged.ranges[1], FloatEq(1.0F));
+  EXPECT_THAT(merged.ranges[2], FloatEq(2.0F));
+  EXPECT_THAT(merged.ranges[3], Eq(kInf));
+}
+
+TEST(DepthLaserScan, MergeRejectsOtherResolution) {
+  // GIVEN two scans with a different number of beams
+  sensor_msgs::msg::LaserScan scan;
+  sensor_msgs::msg::LaserScan merged;
+  resetLaserScan(createOptions(), "body", builtin_interfaces::msg::Time{}, scan);
+  resetLaserScan(LaserScanOptions{}, "body", builtin_interfaces::msg::Time{}, merged);
+
+  // WHEN we merge them
+  const auto result = mergeLaserScans(scan, merged);
+
+  // THEN an error is returned
+  EXPECT_THAT(result.has_value(), IsFalse());
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,206 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <sensor_msgs/image_encodings.hpp>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <spot_driver/conversions/depth_point_cloud.hpp>
+#include <spot_driver/image_test_tools.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+using ::testing::Eq;
+using ::testing::FloatEq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+
+sensor_msgs::msg::Image createDepthImage(const std::uint32_t width, const std::uint32_t height,
+                                         const std::vector<std::uint16_t>& depths) {
+  sensor_msgs::msg::Image image;
+  image.header.frame_id = "camera";
+  image.width = width;
+  image.height = height;
+  image.encoding = sensor_msgs::image_encodings::TYPE_16UC1;
+  image.step = width * sizeof(std::uint16_t);
+  image.data.resize(static_cast<std::size_t>(image.step) * height);
+  std::memcpy(image.data.data(), depths.data(), image.data.size());
+  return image;
+}
+
+std::vector<float> getPoints(const sensor_msgs::msg::PointCloud2& cloud) {
+  std::vector<float> points(cloud.data.size() / sizeof(float));
+  std::memcpy(points.data(), cloud.data.data(), cloud.data.size());
+  return points;
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(DepthPointCloud, ReprojectValidPixels) {
+  // GIVEN a 3x2 depth image in millimeters where one pixel has no depth
+  const auto image = createDepthImage(3, 2, {1000, 0, 2000, 500, 1000, 4000});
+  const auto info = createCameraInfo(3, 2, 2.0, 4.0, 1.0, 0.0);
+
+  // WHEN we create a point cloud from the depth image
+  sensor_msgs::msg::PointCloud2 cloud;
+  const auto result = createPointCloud(image, info, 1000.0, PointCloudOptions{}, cloud);
+
+  // THEN the point cloud has one point for each valid pixel, in the frame of the camera
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(cloud.header.frame_id, StrEq("camera"));
+  EXPECT_THAT(cloud.height, Eq(1U));
+  EXPECT_THAT(cloud.width, Eq(5U));
+  EXPECT_THAT(cloud.point_step, Eq(12U));
+  EXPECT_THAT(cloud.row_step, Eq(60U));
+  EXPECT_THAT(cloud.is_dense, IsTrue());
+  ASSERT_THAT(cloud.fields, SizeIs(3));
+  EXPECT_THAT(cloud.fields[2].name, StrEq("z"));
+  EXPECT_THAT(cloud.fields[2].offset, Eq(8U));
+
+  // THEN each point is the pixel reprojected through the intrinsics
+  const auto points = getPoints(cloud);
+  ASSERT_THAT(points, SizeIs(15));
+  // Pixel (0, 0) at 1 m
+  EXPECT_THAT(points[0], FloatEq(-0.5F));
+  EXPECT_THAT(points[1], FloatEq(0.0F));
+  EXPECT_THAT(points[2], FloatEq(1.0F));
+  // Pixel (2, 0) at 2 m
+  EXPECT_THAT(points[3], FloatEq(1.0F));
+  EXPECT_THAT(points[4], FloatEq(0.0F));
+  EXPECT_THAT(points[5], FloatEq(2.0F));
+  // Pixel (2, 1) at 4 m
+  EXPECT_THAT(points[12], FloatEq(2.0F));
+  EXPECT_THAT(points[13], FloatEq(1.0F));
+  EXPECT_THAT(points[14], FloatEq(4.0F));
+}
+
+TEST(DepthPointCloud, DecimateIntoVoxels) {
+  // GIVEN a depth image where the first two pixels are close together, and the last pixel is far away
+  const auto image = createDepthImage(3, 1, {1000, 1001, 5000});
+  auto info = createCameraInfo(3, 1, 2.0, 4.0, 1.0, 0.0);
+  info.k[2] = 0.0;
+
+  // WHEN we create a point cloud with 1 m voxels
+  PointCloudOptions options;
+  options.voxel_size = 1.0;
+  sensor_msgs::msg::PointCloud2 cloud;
+  const auto result = createPointCloud(image, info, 1000.0, options, cloud);
+
+  // THEN only the first point of each voxel is kept
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(cloud.width, Eq(2U));
+  EXPECT_THAT(cloud.data, SizeIs(24));
+  const auto points = getPoints(cloud);
+  EXPECT_THAT(points[2], FloatEq(1.0F));
+  EXPECT_THAT(points[5], FloatEq(5.0F));
+}
+
+TEST(DepthPointCloud, RejectUnsupportedEncoding) {
+  // GIVEN a color image
+  auto image = createDepthImage(3, 1, {1000, 1000, 1000});
+  image.encoding = sensor_msgs::image_encodings::BGR8;
+
+  // WHEN we try to create a point cloud from it
+  sensor_msgs::msg::PointCloud2 cloud;
+  const auto result =
+      createPointCloud(image, createCameraInfo(3, 1, 2.0, 4.0, 1.0, 0.0), 1000.0, PointCloudOptions{}, cloud);
+
+  // THEN the conversion fails
+  EXPECT_THAT(result.has_value(), IsFalse());
+}
+
+TEST(DepthPointCloud, ReuseRayTable) {
+  // GIVEN a ray table built for a 3x2 camera
+  const auto info = createCameraInfo(3, 2, 2.0, 4.0, 1.0, 0.0);
+  const DepthRayTable rays{info};
+
+  // WHEN we create point clouds from two depth images of that camera with the same table
+  sensor_msgs::msg::PointCloud2 first_cloud;
+  const auto first_result = createPointCloud(createDepthImage(3, 2, {1000, 0, 0, 0, 0, 0}), info, rays, 1000.0,
+                                             PointCloudOptions{}, first_cloud);
+  sensor_msgs::msg::PointCloud2 second_cloud;
+  const auto second_result = createPointCloud(createDepthImage(3, 2, {0, 0, 0, 0, 0, 4000}), info, rays, 1000.0,
+                                              PointCloudOptions{}, second_cloud);
+
+  // THEN both point clouds are reprojected along the rays of their pixels
+  ASSERT_THAT(first_result.has_value(), IsTrue());
+  ASSERT_THAT(second_result.has_value(), IsTrue());
+  const auto first_points = getPoints(first_cloud);
+  ASSERT_THAT(first_points, SizeIs(3));
+  EXPECT_THAT(first_points[0], FloatEq(-0.5F));
+  const auto second_points = getPoints(second_cloud);
+  ASSERT_THAT(second_points, SizeIs(3));
+  EXPECT_THAT(second_points[0], FloatEq(2.0F));
+  EXPECT_THAT(second_points[1], FloatEq(1.0F));
+}
+
+TEST(DepthPointCloud, RejectMismatchedRayTable) {
+  // GIVEN a ray table built for a camera with a different resolution than the depth image
+  const DepthRayTable rays{createCameraInfo(4, 2, 2.0, 4.0, 1.0, 0.0)};
+
+  // WHEN we try to create a point cloud with it
+  sensor_msgs::msg::PointCloud2 cloud;
+  const auto result = createPointCloud(createDepthImage(3, 2, {1000, 1000, 1000, 1000, 1000, 1000}),
+                                       createCameraInfo(3, 2, 2.0, 4.0, 1.0, 0.0), rays, 1000.0,
+                                       PointCloudOptions{}, cloud);
+
+  // THEN the conversion fails
+  EXPECT_THAT(result.has_value(), IsFalse());
+}
+
+TEST(DepthPointCloud, ColorRegisteredDepthImage) {
+  // GIVEN a 2x1 registered depth image where the second pixel has no depth, and a bgr8 image of the same camera
+  const auto info = createCameraInfo(2, 1, 2.0, 4.0, 1.0, 0.0);
+  const DepthRayTable rays{info};
+  sensor_msgs::msg::Image color_image;
+  color_image.width = 2;
+  color_image.height = 1;
+  color_image.encoding = sensor_msgs::image_encodings::BGR8;
+  color_image.step = 6;
+  color_image.data = {0x10, 0x20, 0x30, 0x40, 0x50, 0x60};
+
+  // WHEN we create a colored point cloud from the images
+  sensor_msgs::msg::PointCloud2 cloud;
+  const auto result = createColoredPointCloud(createDepthImage(2, 1, {1000, 0}), color_image, info, rays, 1000.0,
+                                              PointCloudOptions{}, cloud);
+
+  // THEN the valid pixel becomes a point with an rgb field holding the packed color of its pixel
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(cloud.width, Eq(1U));
+  EXPECT_THAT(cloud.point_step, Eq(16U));
+  ASSERT_THAT(cloud.fields, SizeIs(4));
+  EXPECT_THAT(cloud.fields[3].name, StrEq("rgb"));
+  ASSERT_THAT(cloud.data, SizeIs(16));
+  std::uint32_t rgb;
+  std::memcpy(&rgb, cloud.data.data() + 12, sizeof(rgb));
+  EXPECT_THAT(rgb, Eq(0x302010U));
+  const auto points = getPoints(cloud);
+  EXPECT_THAT(points[2], FloatEq(1.0F));
+}
+
+TEST(DepthPointCloud, RejectColorImageWithOtherResolution) {
+  // GIVEN a color image with a different resolution than the registered depth image
+  const auto info = createCameraInfo(2, 1, 2.0, 4.0, 1.0, 0.0);
+  sensor_msgs::msg::Image color_image;
+  color_image.width = 1;
+  color_image.height = 1;
+  color_image.encoding = sensor_msgs::image_encodings::BGR8;
+  color_image.step = 3;
+  color_image.data = {0, 0, 0};
+
+  // WHEN we try to create a colored point cloud from the images
+  sensor_msgs::msg::PointCloud2 cloud;
+  const auto result = createColoredPointCloud(createDepthImage(2, 1, {1000, 1000}), color_image, info,
+                                              DepthRayTable{info}, 1000.0, PointCloudOptions{}, cloud);
+
+  // THEN the conversion fails
+  EXPECT_THAT(result.has_value(), IsFalse());
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,69 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <spot_driver/conversions/depth_ray_table.hpp>
+#include <spot_driver/image_test_tools.hpp>
+
+namespace {
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::FloatEq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(DepthRayTable, BuildRaysFromIntrinsics) {
+  // GIVEN the camera info of a 3x2 camera
+  const auto info = createCameraInfo(3, 2, 2.0, 4.0, 1.0, 2.0);
+
+  // WHEN we build its ray table
+  const DepthRayTable rays{info};
+
+  // THEN the table has a ray with a z component of 1 through every pixel, in row-major order
+  EXPECT_THAT(rays.width(), Eq(3U));
+  EXPECT_THAT(rays.height(), Eq(2U));
+  EXPECT_THAT(rays.x(), ElementsAre(FloatEq(-0.5F), FloatEq(0.0F), FloatEq(0.5F), FloatEq(-0.5F), FloatEq(0.0F),
+                                    FloatEq(0.5F)));
+  EXPECT_THAT(rays.y(), ElementsAre(FloatEq(-0.5F), FloatEq(-0.5F), FloatEq(-0.5F), FloatEq(-0.25F), FloatEq(-0.25F),
+                                    FloatEq(-0.25F)));
+}
+
+TEST(DepthRayTable, OnlyRebuildWhenCameraChanges) {
+  // GIVEN a ray table built for a camera
+  auto info = createCameraInfo(3, 2, 2.0, 4.0, 1.0, 2.0);
+  DepthRayTable rays{info};
+
+  // WHEN only the header of the camera info changes
+  info.header.frame_id = "other_camera";
+
+  // THEN the table still matches and is not rebuilt
+  EXPECT_THAT(rays.matches(info), IsTrue());
+  EXPECT_THAT(rays.update(info), IsFalse());
+
+  // WHEN the focal length changes
+  info.k[0] = 1.0;
+
+  // THEN the table no longer matches, and is rebuilt with the new intrinsics
+  EXPECT_THAT(rays.matches(info), IsFalse());
+  EXPECT_THAT(rays.update(info), IsTrue());
+  EXPECT_THAT(rays.x()[0], FloatEq(-1.0F));
+
+  // WHEN the resolution changes
+  info.width = 4;
+
+  // THEN the table is rebuilt with the new resolution
+  EXPECT_THAT(rays.update(info), IsTrue());
+  EXPECT_THAT(rays.x().size(), Eq(8U));
+}
+
+TEST(DepthRayTable, EmptyTableMatchesNothing) {
+  // GIVEN an empty ray table
+  const DepthRayTable rays;
+
+  // THEN it does not match any camera
+  EXPECT_THAT(rays.matches(createCameraInfo(3, 2, 2.0, 4.0, 1.0, 2.0)), IsFalse());
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,136 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <sensor_msgs/image_encodings.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/conversions/depth_reregistration.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+
+constexpr std::uint32_t kWidth{4};
+constexpr std::uint32_t kHeight{2};
+
+/** @brief Calibration of two identical 4x2 cameras at the same place. */
+spot_ros2::DepthReregistrationCalibration createCalibration() {
+  spot_ros2::DepthReregistrationCalibration calibration;
+  calibration.camera_matrix_depth = {2.0, 0.0, 1.5, 0.0, 2.0, 0.5, 0.0, 0.0, 1.0};
+  calibration.camera_matrix_rgb = calibration.camera_matrix_depth;
+  calibration.depth_t_rgb_R = {1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0};
+  calibration.depth_image_dim = {kHeight, kWidth};
+  calibration.rgb_image_dim = {kHeight, kWidth};
+  return calibration;
+}
+
+sensor_msgs::msg::Image createDepthImage(const std::vector<std::uint16_t>& depths, const std::uint32_t width) {
+  sensor_msgs::msg::Image image;
+  image.header.frame_id = "hand_depth_sensor";
+  image.width = width;
+  image.height = static_cast<std::uint32_t>(depths.size()) / width;
+  image.encoding = sensor_msgs::image_encodings::TYPE_16UC1;
+  image.step = width * sizeof(std::uint16_t);
+  image.data.resize(depths.size() * sizeof(std::uint16_t));
+  std::memcpy(image.data.data(), depths.data(), image.data.size());
+  return image;
+}
+
+std::vector<std::uint16_t> toDepths(const sensor_msgs::msg::Image& image) {
+  std::vector<std::uint16_t> depths(image.data.size() / sizeof(std::uint16_t));
+  std::memcpy(depths.data(), image.data.data(), image.data.size());
+  return depths;
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(DepthReregistration, IdenticalCamerasKeepImage) {
+  // GIVEN the re-registration between two identical cameras at the same place
+  const auto reregistration = DepthReregistration::create(createCalibration());
+  ASSERT_THAT(reregistration.has_value(), IsTrue()) << reregistration.error();
+  const std::vector<std::uint16_t> depths{1000, 0, 1200, 1300, 1400, 1500, 0, 1700};
+
+  // WHEN we re-register a depth image
+  sensor_msgs::msg::Image registered;
+  const auto result = reregistration->reregister(createDepthImage(depths, kWidth), registered);
+
+  // THEN the re-registered image is the same as the depth image
+  ASSERT_THAT(result.has_value(), IsTrue()) << result.error();
+  EXPECT_THAT(registered.width, Eq(kWidth));
+  EXPECT_THAT(registered.height, Eq(kHeight));
+  EXPECT_THAT(registered.encoding, Eq(sensor_msgs::image_encodings::TYPE_16UC1));
+  EXPECT_THAT(registered.header.frame_id, Eq("hand_depth_sensor"));
+  EXPECT_THAT(toDepths(registered), ElementsAreArray(depths));
+}
+
+TEST(DepthReregistration, TranslationShiftsAndOccludesPoints) {
+  // GIVEN an RGB camera which is half a meter to the left of the depth camera
+  auto calibration = createCalibration();
+  calibration.depth_t_rgb_T = {0.5, 0.0, 0.0};
+  const auto reregistration = DepthReregistration::create(calibration);
+  ASSERT_THAT(reregistration.has_value(), IsTrue()) << reregistration.error();
+
+  // WHEN we re-register a depth image in which a near and a far point land on the same RGB pixel
+  sensor_msgs::msg::Image registered;
+  const auto result =
+      reregistration->reregister(createDepthImage({500, 1000, 0, 0, 0, 0, 0, 2000}, kWidth), registered);
+
+  // THEN the points are shifted by the parallax, the nearer point occludes the farther one, and points which leave the
+  // RGB image are dropped
+  ASSERT_THAT(result.has_value(), IsTrue()) << result.error();
+  EXPECT_THAT(toDepths(registered), ElementsAre(0, 0, 500, 0, 0, 0, 0, 0));
+}
+
+TEST(DepthReregistration, RgbResolutionDefinesOutput) {
+  // GIVEN an RGB camera with twice the resolution of the depth camera
+  auto calibration = createCalibration();
+  calibration.camera_matrix_rgb = {4.0, 0.0, 3.5, 0.0, 4.0, 1.5, 0.0, 0.0, 1.0};
+  calibration.rgb_image_dim = {2 * kHeight, 2 * kWidth};
+  const auto reregistration = DepthReregistration::create(calibration);
+  ASSERT_THAT(reregistration.has_value(), IsTrue()) << reregistration.error();
+
+  // WHEN we re-register a depth image
+  sensor_msgs::msg::Image registered;
+  const auto result =
+      reregistration->reregister(createDepthImage({1000, 0, 0, 0, 0, 0, 0, 0}, kWidth), registered);
+
+  // THEN the re-registered image has the resolution of the RGB camera
+  ASSERT_THAT(result.has_value(), IsTrue()) << result.error();
+  EXPECT_THAT(registered.width, Eq(2 * kWidth));
+  EXPECT_THAT(registered.height, Eq(2 * kHeight));
+  EXPECT_THAT(registered.data.size(), Eq(4U * kWidth * kHeight * sizeof(std::uint16_t)));
+}
+
+TEST(DepthReregistration, RejectInvalidCalibration) {
+  // GIVEN a calibration without image dimensions, and one without camera matrices
+  auto without_dimensions = createCalibration();
+  without_dimensions.rgb_image_dim = {0, 0};
+  auto without_camera_matrix = createCalibration();
+  without_camera_matrix.camera_matrix_rgb = {};
+
+  // WHEN we create their re-registrations
+  // THEN errors are returned
+  EXPECT_THAT(DepthReregistration::create(without_dimensions).has_value(), IsFalse());
+  EXPECT_THAT(DepthReregistration::create(without_camera_matrix).has_value(), IsFalse());
+}
+
+TEST(DepthReregistration, RejectImageOfOtherSize) {
+  // GIVEN the re-registration of a 4x2 depth camera
+  const auto reregistration = DepthReregistration::create(createCalibration());
+  ASSERT_THAT(reregistration.has_value(), IsTrue()) << reregistration.error();
+
+  // WHEN we re-register a 2x2 depth image
+  sensor_msgs::msg::Image registered;
+  const auto result = reregistration->reregister(createDepthImage({1000, 1000, 1000, 1000}, 2), registered);
+
+  // THEN an error is returned
+  EXPECT_THAT(result.has_value(), IsFalse());
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,99 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <bosdyn/api/geometry.pb.h>
+#include <bosdyn/math/proto_math.h>
+#include <spot_driver/conversions/frame_tree_resolver.hpp>
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace {
+void addEdge(::bosdyn::api::FrameTreeSnapshot& snapshot, const std::string& child, const std::string& parent,
+             const double x, const double y) {
+  auto& edge = (*snapshot.mutable_child_to_parent_edge_map())[child];
+  edge.set_parent_frame_name(parent);
+  *edge.mutable_parent_tform_child() =
+      ::bosdyn::api::CreateSE3Pose(::bosdyn::api::CreateQuaternion(1, 0, 0, 0), ::bosdyn::api::CreateVec3(x, y, 0));
+}
+
+/** Frame tree with odom as its root, body in odom, and a hand and a camera in body. */
+::bosdyn::api::FrameTreeSnapshot makeSnapshot() {
+  ::bosdyn::api::FrameTreeSnapshot snapshot;
+  (*snapshot.mutable_child_to_parent_edge_map())["odom"];
+  addEdge(snapshot, "body", "odom", 1.0, 2.0);
+  addEdge(snapshot, "hand", "body", 0.5, 0.0);
+  addEdge(snapshot, "camera", "hand", 0.1, 0.0);
+  return snapshot;
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(FrameTreeResolver, ComposesTransformsFromRoot) {
+  // GIVEN a frame tree snapshot
+  const auto snapshot = makeSnapshot();
+
+  // WHEN the snapshot is compiled with body as the root frame
+  FrameTreeResolver resolver;
+  ASSERT_TRUE(resolver.compile(snapshot, "body"));
+
+  // THEN the transforms from body to its ancestors and descendants are composed
+  const auto body_tform_camera = resolver.rootTformFrame("camera");
+  ASSERT_TRUE(body_tform_camera.has_value());
+  EXPECT_DOUBLE_EQ(body_tform_camera->position().x(), 0.6);
+  const auto body_tform_odom = resolver.rootTformFrame("odom");
+  ASSERT_TRUE(body_tform_odom.has_value());
+  EXPECT_DOUBLE_EQ(body_tform_odom->position().x(), -1.0);
+  EXPECT_DOUBLE_EQ(body_tform_odom->position().y(), -2.0);
+  const auto body_tform_body = resolver.rootTformFrame("body");
+  ASSERT_TRUE(body_tform_body.has_value());
+  EXPECT_DOUBLE_EQ(body_tform_body->position().x(), 0.0);
+  EXPECT_THAT(resolver.rootTformFrame("gripper"), testing::Eq(std::nullopt));
+}
+
+TEST(FrameTreeResolver, SortsParentsBeforeChildren) {
+  // GIVEN a compiled frame tree snapshot
+  FrameTreeResolver resolver;
+  ASSERT_TRUE(resolver.compile(makeSnapshot(), "odom"));
+
+  // WHEN the frames are sorted
+  const auto frames = resolver.sortedFrames();
+
+  // THEN every frame comes after its parent
+  EXPECT_THAT(frames, testing::ElementsAre(std::string_view{"odom"}, std::string_view{"body"},
+                                           std::string_view{"hand"}, std::string_view{"camera"}));
+}
+
+TEST(FrameTreeResolver, RejectsMissingRootAndCycles) {
+  // GIVEN a frame tree snapshot, and a snapshot with a cycle
+  const auto snapshot = makeSnapshot();
+  ::bosdyn::api::FrameTreeSnapshot cyclic_snapshot;
+  addEdge(cyclic_snapshot, "a", "b", 1.0, 0.0);
+  addEdge(cyclic_snapshot, "b", "a", 1.0, 0.0);
+
+  // WHEN they are compiled with a missing root frame, or with a cycle
+  // THEN compilation fails and no frame is resolved
+  FrameTreeResolver resolver;
+  EXPECT_FALSE(resolver.compile(snapshot, "vision"));
+  EXPECT_THAT(resolver.rootTformFrame("body"), testing::Eq(std::nullopt));
+  EXPECT_FALSE(resolver.compile(cyclic_snapshot, "a"));
+  EXPECT_THAT(resolver.rootTformFrame("a"), testing::Eq(std::nullopt));
+}
+
+TEST(FrameTreeResolver, DoesNotResolveDisconnectedFrames) {
+  // GIVEN a frame tree snapshot with a second tree
+  auto snapshot = makeSnapshot();
+  (*snapshot.mutable_child_to_parent_edge_map())["vision"];
+  addEdge(snapshot, "fiducial", "vision", 3.0, 0.0);
+
+  // WHEN the snapshot is compiled with body as the root frame
+  FrameTreeResolver resolver;
+  ASSERT_TRUE(resolver.compile(snapshot, "body"));
+
+  // THEN the frames of the other tree are not resolved
+  EXPECT_THAT(resolver.rootTformFrame("fiducial"), testing::Eq(std::nullopt));
+  EXPECT_TRUE(resolver.rootTformFrame("hand").has_value());
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,131 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <sensor_msgs/image_encodings.hpp>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/conversions/image_preview.hpp>
+#include <spot_driver/image_test_tools.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+using ::testing::DoubleEq;
+using ::testing::Each;
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+
+sensor_msgs::msg::Image createImage(const std::uint32_t width, const std::uint32_t height, const std::string& encoding,
+                                    const std::uint32_t bytes_per_pixel, const std::uint8_t value) {
+  sensor_msgs::msg::Image image;
+  image.header.frame_id = "camera";
+  image.width = width;
+  image.height = height;
+  image.encoding = encoding;
+  image.step = width * bytes_per_pixel;
+  image.data.assign(static_cast<std::size_t>(image.step) * height, value);
+  return image;
+}
+
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(ImagePreview, DownscaleColorImage) {
+  // GIVEN a color image and its camera info
+  const auto image = createImage(64, 48, sensor_msgs::image_encodings::BGR8, 3, 200);
+  const auto info = createCameraInfo(64, 48);
+
+  // WHEN we create a preview at a quarter of the resolution
+  ImagePreviewOptions options;
+  options.scale_divisor = 4;
+  sensor_msgs::msg::Image preview;
+  sensor_msgs::msg::CameraInfo preview_info;
+  const auto result = createImagePreview(image, info, options, preview, preview_info);
+
+  // THEN the preview has a quarter of the resolution, and keeps the header, encoding and pixel values
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(preview.width, Eq(16U));
+  EXPECT_THAT(preview.height, Eq(12U));
+  EXPECT_THAT(preview.step, Eq(48U));
+  EXPECT_THAT(preview.encoding, StrEq(sensor_msgs::image_encodings::BGR8));
+  EXPECT_THAT(preview.header.frame_id, StrEq("camera"));
+  EXPECT_THAT(preview.data, SizeIs(16 * 12 * 3));
+  EXPECT_THAT(preview.data, Each(Eq(200)));
+
+  // THEN the intrinsics are scaled to the preview resolution
+  EXPECT_THAT(preview_info.width, Eq(16U));
+  EXPECT_THAT(preview_info.height, Eq(12U));
+  EXPECT_THAT(preview_info.k[0], DoubleEq(25.0));
+  EXPECT_THAT(preview_info.k[2], DoubleEq(7.5));
+  EXPECT_THAT(preview_info.k[4], DoubleEq(25.0));
+  EXPECT_THAT(preview_info.k[5], DoubleEq(5.5));
+  EXPECT_THAT(preview_info.p[0], DoubleEq(25.0));
+  EXPECT_THAT(preview_info.p[2], DoubleEq(7.5));
+}
+
+TEST(ImagePreview, CropDepthImage) {
+  // GIVEN a depth image and its camera info
+  const auto image = createImage(64, 48, sensor_msgs::image_encodings::TYPE_16UC1, 2, 7);
+  const auto info = createCameraInfo(64, 48);
+
+  // WHEN we create a preview of a region of interest without downscaling
+  ImagePreviewOptions options;
+  options.roi_x = 16;
+  options.roi_y = 8;
+  options.roi_width = 32;
+  options.roi_height = 24;
+  sensor_msgs::msg::Image preview;
+  sensor_msgs::msg::CameraInfo preview_info;
+  const auto result = createImagePreview(image, info, options, preview, preview_info);
+
+  // THEN the preview has the size of the region, and the principal point is shifted into it
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(preview.width, Eq(32U));
+  EXPECT_THAT(preview.height, Eq(24U));
+  EXPECT_THAT(preview.step, Eq(64U));
+  EXPECT_THAT(preview.data, Each(Eq(7)));
+  EXPECT_THAT(preview_info.k[0], DoubleEq(100.0));
+  EXPECT_THAT(preview_info.k[2], DoubleEq(15.5));
+  EXPECT_THAT(preview_info.k[5], DoubleEq(15.5));
+}
+
+TEST(ImagePreview, RegionOutsideImage) {
+  // GIVEN a greyscale image
+  const auto image = createImage(64, 48, sensor_msgs::image_encodings::MONO8, 1, 0);
+  const auto info = createCameraInfo(64, 48);
+
+  // WHEN we create a preview of a region which does not fit inside the image
+  ImagePreviewOptions options;
+  options.roi_x = 40;
+  options.roi_width = 32;
+  options.roi_height = 24;
+  sensor_msgs::msg::Image preview;
+  sensor_msgs::msg::CameraInfo preview_info;
+  const auto result = createImagePreview(image, info, options, preview, preview_info);
+
+  // THEN creating the preview fails
+  EXPECT_THAT(result.has_value(), IsFalse());
+}
+
+TEST(ImagePreview, UnsupportedEncoding) {
+  // GIVEN an image with an encoding which previews do not support
+  const auto image = createImage(64, 48, sensor_msgs::image_encodings::TYPE_32FC1, 4, 0);
+  const auto info = createCameraInfo(64, 48);
+
+  // WHEN we create a preview
+  ImagePreviewOptions options;
+  options.scale_divisor = 2;
+  sensor_msgs::msg::Image preview;
+  sensor_msgs::msg::CameraInfo preview_info;
+  const auto result = createImagePreview(image, info, options, preview, preview_info);
+
+  // THEN creating the preview fails
+  EXPECT_THAT(result.has_value(), IsFalse());
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,179 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <sensor_msgs/image_encodings.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/conversions/jpeg_decoder.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+
+std::string encodeJpeg(const cv::Mat& image) {
+  std::vector<unsigned char> buffer;
+  cv::imencode(".jpg", image, buffer);
+  return std::string{buffer.begin(), buffer.end()};
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(JpegDecoder, ToJpegDecoderBackend) {
+  // GIVEN the names of the supported backends and an unsupported backend
+  // WHEN we convert them to a JpegDecoderBackend
+  // THEN the supported backends are converted and the unsupported backend returns an error
+  EXPECT_THAT(toJpegDecoderBackend("opencv").value(), Eq(JpegDecoderBackend::OPENCV));
+  EXPECT_THAT(toJpegDecoderBackend("turbojpeg").value(), Eq(JpegDecoderBackend::TURBOJPEG));
+  EXPECT_THAT(toJpegDecoderBackend("nvjpeg").has_value(), IsFalse());
+}
+
+TEST(JpegDecoder, DecodeGreyscaleWithOpenCv) {
+  // GIVEN a JPEG-compressed greyscale image
+  const cv::Mat image{48, 64, CV_8UC1, cv::Scalar{128}};
+  const auto data = encodeJpeg(image);
+
+  // WHEN we decode it with OpenCV
+  sensor_msgs::msg::Image image_msg;
+  const auto result = decodeJpeg(data, true, JpegDecoderBackend::OPENCV, image_msg);
+
+  // THEN the decoded image has the dimensions and encoding of the original image
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(image_msg.height, Eq(48U));
+  EXPECT_THAT(image_msg.width, Eq(64U));
+  EXPECT_THAT(image_msg.step, Eq(64U));
+  EXPECT_THAT(image_msg.encoding, StrEq(sensor_msgs::image_encodings::MONO8));
+  EXPECT_THAT(image_msg.data, SizeIs(48 * 64));
+}
+
+TEST(JpegDecoder, DecodeColorWithFallbackBackend) {
+  // GIVEN a JPEG-compressed color image
+  const cv::Mat image{48, 64, CV_8UC3, cv::Scalar{10, 20, 30}};
+  const auto data = encodeJpeg(image);
+
+  // WHEN we decode it with the TurboJPEG backend, which falls back to OpenCV if it is not available
+  sensor_msgs::msg::Image image_msg;
+  const auto result = decodeJpeg(data, false, JpegDecoderBackend::TURBOJPEG, image_msg);
+
+  // THEN the decoded image has the dimensions and encoding of the original image
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(image_msg.height, Eq(48U));
+  EXPECT_THAT(image_msg.width, Eq(64U));
+  EXPECT_THAT(image_msg.step, Eq(64U * 3U));
+  EXPECT_THAT(image_msg.encoding, StrEq(sensor_msgs::image_encodings::BGR8));
+  EXPECT_THAT(image_msg.data, SizeIs(48 * 64 * 3));
+}
+
+TEST(JpegDecoder, DecodeScaledImage) {
+  // GIVEN a JPEG-compressed color image whose dimensions are not multiples of the scale
+  const cv::Mat image{50, 66, CV_8UC3, cv::Scalar{10, 20, 30}};
+  const auto data = encodeJpeg(image);
+
+  // WHEN we decode it at a quarter of its resolution
+  sensor_msgs::msg::Image image_msg;
+  const auto result = decodeJpeg(data, false, 4, JpegDecoderBackend::OPENCV, image_msg);
+
+  // THEN the decoded image has the dimensions of the original image divided by four and rounded up
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(image_msg.height, Eq(13U));
+  EXPECT_THAT(image_msg.width, Eq(17U));
+  EXPECT_THAT(image_msg.step, Eq(17U * 3U));
+  EXPECT_THAT(image_msg.data, SizeIs(13 * 17 * 3));
+
+  // WHEN we decode it with a scale that JPEG does not support
+  // THEN decoding fails
+  EXPECT_THAT(decodeJpeg(data, false, 3, JpegDecoderBackend::OPENCV, image_msg).has_value(), IsFalse());
+}
+
+TEST(JpegDecoder, ToJpegOutputEncoding) {
+  // GIVEN the names of the supported output encodings and an unsupported encoding
+  // WHEN we convert them to a JpegOutputEncoding and back
+  // THEN the supported encodings keep their names and the unsupported encoding returns an error
+  for (const auto* name : {"bgr8", "rgb8", "mono8", "nv12"}) {
+    const auto encoding = toJpegOutputEncoding(name);
+    ASSERT_THAT(encoding.has_value(), IsTrue());
+    EXPECT_THAT(toImageEncodingName(encoding.value()), StrEq(name));
+  }
+  EXPECT_THAT(toJpegOutputEncoding("16UC1").has_value(), IsFalse());
+}
+
+TEST(JpegDecoder, DecodeIntoRgb8) {
+  // GIVEN a JPEG-compressed color image whose blue, green and red channels differ
+  const cv::Mat image{48, 64, CV_8UC3, cv::Scalar{200, 100, 20}};
+  const auto data = encodeJpeg(image);
+
+  for (const auto backend : {JpegDecoderBackend::OPENCV, JpegDecoderBackend::TURBOJPEG}) {
+    // WHEN we decode it into rgb8
+    sensor_msgs::msg::Image image_msg;
+    const auto result = decodeJpeg(data, JpegOutputEncoding::RGB8, 1, backend, image_msg);
+
+    // THEN the decoded image has three channels in red, green, blue order
+    ASSERT_THAT(result.has_value(), IsTrue());
+    EXPECT_THAT(image_msg.encoding, StrEq(sensor_msgs::image_encodings::RGB8));
+    EXPECT_THAT(image_msg.step, Eq(64U * 3U));
+    ASSERT_THAT(image_msg.data, SizeIs(48 * 64 * 3));
+    EXPECT_NEAR(image_msg.data[0], 20, 4);
+    EXPECT_NEAR(image_msg.data[2], 200, 4);
+  }
+}
+
+TEST(JpegDecoder, DecodeIntoNv12) {
+  // GIVEN a JPEG-compressed color image
+  const cv::Mat image{48, 64, CV_8UC3, cv::Scalar{10, 20, 30}};
+  const auto data = encodeJpeg(image);
+
+  for (const auto backend : {JpegDecoderBackend::OPENCV, JpegDecoderBackend::TURBOJPEG}) {
+    // WHEN we decode it into NV12
+    sensor_msgs::msg::Image image_msg;
+    const auto result = decodeJpeg(data, JpegOutputEncoding::NV12, 1, backend, image_msg);
+
+    // THEN the decoded image has a full resolution luma plane followed by an interleaved chroma plane of half the
+    // resolution, and the luma matches the color of the original image
+    ASSERT_THAT(result.has_value(), IsTrue());
+    EXPECT_THAT(image_msg.encoding, StrEq("nv12"));
+    EXPECT_THAT(image_msg.height, Eq(48U));
+    EXPECT_THAT(image_msg.width, Eq(64U));
+    EXPECT_THAT(image_msg.step, Eq(64U));
+    ASSERT_THAT(image_msg.data, SizeIs(48 * 64 * 3 / 2));
+    EXPECT_NEAR(image_msg.data[0], 22, 4);
+  }
+
+  // WHEN we decode an image with an odd width into NV12
+  // THEN decoding fails
+  sensor_msgs::msg::Image image_msg;
+  const auto odd_data = encodeJpeg(cv::Mat{48, 63, CV_8UC3, cv::Scalar{10, 20, 30}});
+  EXPECT_THAT(decodeJpeg(odd_data, JpegOutputEncoding::NV12, 1, JpegDecoderBackend::OPENCV, image_msg).has_value(),
+              IsFalse());
+}
+
+TEST(JpegDecoder, IsGreyscaleJpeg) {
+  // GIVEN JPEG-compressed greyscale and color images, and data which is not a valid JPEG image
+  const auto greyscale = encodeJpeg(cv::Mat{48, 64, CV_8UC1, cv::Scalar{128}});
+  const auto color = encodeJpeg(cv::Mat{48, 64, CV_8UC3, cv::Scalar{10, 20, 30}});
+
+  // WHEN we check if they are greyscale
+  // THEN only the greyscale image is, and the invalid data returns an error
+  EXPECT_THAT(isGreyscaleJpeg(greyscale).value(), IsTrue());
+  EXPECT_THAT(isGreyscaleJpeg(color).value(), IsFalse());
+  EXPECT_THAT(isGreyscaleJpeg("not a jpeg").has_value(), IsFalse());
+}
+
+TEST(JpegDecoder, DecodeInvalidDataFails) {
+  // GIVEN data which is not a valid JPEG image
+  const std::string data{"not a jpeg"};
+
+  // WHEN we decode it
+  sensor_msgs::msg::Image image_msg;
+  const auto result = decodeJpeg(data, true, JpegDecoderBackend::OPENCV, image_msg);
+
+  // THEN decoding fails
+  EXPECT_THAT(result.has_value(), IsFalse());
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,121 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <sensor_msgs/image_encodings.hpp>
+#include <sensor_msgs/msg/compressed_image.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/conversions/jpeg_decoder.hpp>
+#include <spot_driver/conversions/jpeg_encoder.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+namespace {
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::Lt;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+
+sensor_msgs::msg::Image createImage(const std::string& encoding, const std::uint32_t channels,
+                                    const std::uint8_t value) {
+  sensor_msgs::msg::Image image;
+  image.header.frame_id = "frontmiddle_virtual";
+  image.header.stamp.sec = 42;
+  image.height = 48;
+  image.width = 64;
+  image.step = image.width * channels;
+  image.encoding = encoding;
+  image.data.assign(image.step * image.height, value);
+  return image;
+}
+
+std::string_view toStringView(const sensor_msgs::msg::CompressedImage& compressed) {
+  return std::string_view{reinterpret_cast<const char*>(compressed.data.data()), compressed.data.size()};
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(JpegEncoder, EncodeGreyscaleWithOpenCv) {
+  // GIVEN a greyscale image
+  const auto image = createImage(sensor_msgs::image_encodings::MONO8, 1, 128);
+
+  // WHEN we encode it with OpenCV
+  sensor_msgs::msg::CompressedImage compressed;
+  const auto result = encodeJpeg(image, 90, JpegDecoderBackend::OPENCV, compressed);
+
+  // THEN the compressed image has the header of the image and decodes back to a greyscale image of the same size
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(compressed.format, StrEq("mono8; jpeg compressed mono8"));
+  EXPECT_THAT(compressed.header.frame_id, StrEq("frontmiddle_virtual"));
+  EXPECT_THAT(compressed.header.stamp.sec, Eq(42));
+  EXPECT_THAT(isGreyscaleJpeg(toStringView(compressed)).value(), IsTrue());
+  sensor_msgs::msg::Image decoded;
+  ASSERT_THAT(decodeJpeg(toStringView(compressed), true, 1, JpegDecoderBackend::OPENCV, decoded).has_value(), IsTrue());
+  EXPECT_THAT(decoded.height, Eq(48U));
+  EXPECT_THAT(decoded.width, Eq(64U));
+}
+
+TEST(JpegEncoder, EncodeColorWithFallbackBackend) {
+  // GIVEN a color image
+  const auto image = createImage(sensor_msgs::image_encodings::BGR8, 3, 100);
+
+  // WHEN we encode it with the TurboJPEG backend, which falls back to OpenCV if it is not available
+  sensor_msgs::msg::CompressedImage compressed;
+  const auto result = encodeJpeg(image, 90, JpegDecoderBackend::TURBOJPEG, compressed);
+
+  // THEN the compressed image is smaller than the image and decodes back to nearly the same color image
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(compressed.format, StrEq("bgr8; jpeg compressed bgr8"));
+  EXPECT_THAT(compressed.data.size(), Lt(image.data.size()));
+  EXPECT_THAT(isGreyscaleJpeg(toStringView(compressed)).value(), IsFalse());
+  sensor_msgs::msg::Image decoded;
+  ASSERT_THAT(decodeJpeg(toStringView(compressed), false, 1, JpegDecoderBackend::OPENCV, decoded).has_value(),
+              IsTrue());
+  ASSERT_THAT(decoded.data, SizeIs(image.data.size()));
+  for (const auto value : decoded.data) {
+    EXPECT_THAT(std::abs(static_cast<int>(value) - 100), Lt(3));
+  }
+}
+
+TEST(JpegEncoder, ReuseCompressedMessage) {
+  // GIVEN a compressed message which already holds a larger image
+  sensor_msgs::msg::CompressedImage compressed;
+  compressed.data.assign(1000000, 0xFF);
+
+  // WHEN we encode an image into it
+  const auto image = createImage(sensor_msgs::image_encodings::MONO8, 1, 0);
+  ASSERT_THAT(encodeJpeg(image, 90, JpegDecoderBackend::OPENCV, compressed).has_value(), IsTrue());
+
+  // THEN only the JPEG data of the new image is left in it
+  EXPECT_THAT(compressed.data.size(), Lt(1000000U));
+  EXPECT_THAT(isGreyscaleJpeg(toStringView(compressed)).value(), IsTrue());
+}
+
+TEST(JpegEncoder, CompressedFormatNamesEncodingAndJpegColorFormat) {
+  EXPECT_THAT(getJpegCompressedFormat(sensor_msgs::image_encodings::MONO8), StrEq("mono8; jpeg compressed mono8"));
+  EXPECT_THAT(getJpegCompressedFormat(sensor_msgs::image_encodings::BGR8), StrEq("bgr8; jpeg compressed bgr8"));
+  EXPECT_THAT(getJpegCompressedFormat(sensor_msgs::image_encodings::RGB8), StrEq("rgb8; jpeg compressed bgr8"));
+  EXPECT_THAT(getJpegCompressedFormat(sensor_msgs::image_encodings::TYPE_16UC1), StrEq("jpeg"));
+}
+
+TEST(JpegEncoder, EncodeInvalidImagesFails) {
+  // GIVEN images with an unsupported encoding, with missing pixels, and a valid image
+  const auto depth = createImage(sensor_msgs::image_encodings::TYPE_16UC1, 2, 0);
+  auto truncated = createImage(sensor_msgs::image_encodings::MONO8, 1, 0);
+  truncated.data.resize(10);
+  const auto image = createImage(sensor_msgs::image_encodings::MONO8, 1, 0);
+
+  // WHEN we encode them, the valid image with out of range qualities
+  // THEN encoding fails
+  sensor_msgs::msg::CompressedImage compressed;
+  EXPECT_THAT(encodeJpeg(depth, 90, JpegDecoderBackend::OPENCV, compressed).has_value(), IsFalse());
+  EXPECT_THAT(encodeJpeg(truncated, 90, JpegDecoderBackend::OPENCV, compressed).has_value(), IsFalse());
+  EXPECT_THAT(encodeJpeg(image, 0, JpegDecoderBackend::OPENCV, compressed).has_value(), IsFalse());
+  EXPECT_THAT(encodeJpeg(image, 101, JpegDecoderBackend::OPENCV, compressed).has_value(), IsFalse());
+}
+}  // namespace spot_ros2::test
@@ -5,6 +5,10 @@
 
 #include <rclcpp/rclcpp.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 namespace spot_ros2::test {
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -275,4 +279,58 @@ TEST(TestKinematicConversions, convertProtoToBosdynMsgsKinematicState) {
   ASSERT_EQ(protoMsg.velocity_of_body_in_odom().linear().y(), rosMsg.velocity_of_body_in_odom.linear.y);
 }
 
+TEST(TestKinematicConversions, convertProtoToBosdynMsgsKinematicStateReusesMessage) {
+  // GIVEN a kinematic state message which was converted from a state with more joints and edges
+  bosdyn::api::KinematicState previousProtoMsg;
+  previousProtoMsg.add_joint_states()->set_name("shoulder");
+  previousProtoMsg.add_joint_states()->set_name("elbow");
+  (*previousProtoMsg.mutable_transforms_snapshot()->mutable_child_to_parent_edge_map())["arm"].set_parent_frame_name(
+      "torso");
+  (*previousProtoMsg.mutable_transforms_snapshot()->mutable_child_to_parent_edge_map())["hand"].set_parent_frame_name(
+      "arm");
+  bosdyn_api_msgs::msg::KinematicState rosMsg;
+  convertToRos(previousProtoMsg, rosMsg);
+
+  // WHEN a state with fewer joints and edges is converted into the same message
+  bosdyn::api::KinematicState protoMsg;
+  protoMsg.add_joint_states()->set_name("wrist");
+  (*protoMsg.mutable_transforms_snapshot()->mutable_child_to_parent_edge_map())["body"].set_parent_frame_name("odom");
+  convertToRos(protoMsg, rosMsg);
+
+  // THEN the message only contains the joints and edges of the new state
+  ASSERT_EQ(rosMsg.joint_states.size(), 1u);
+  ASSERT_EQ(rosMsg.joint_states[0].name, "wrist");
+  ASSERT_EQ(rosMsg.transforms_snapshot.child_to_parent_edge_map.size(), 1u);
+  ASSERT_EQ(rosMsg.transforms_snapshot.child_to_parent_edge_map[0].key, "body");
+  ASSERT_EQ(rosMsg.transforms_snapshot.child_to_parent_edge_map[0].value.parent_frame_name, "odom");
+}
+
+TEST(TestKinematicConversions, convertProtoToBosdynMsgsFrameTreeSnapshotWithParentIndices) {
+  // GIVEN a frame tree snapshot with a root frame, a chain of two edges, and an edge to a missing frame
+  bosdyn::api::FrameTreeSnapshot protoMsg;
+  auto& edges = *protoMsg.mutable_child_to_parent_edge_map();
+  edges["odom"].set_parent_frame_name("");
+  edges["body"].set_parent_frame_name("odom");
+  edges["hand"].set_parent_frame_name("body");
+  edges["gripper"].set_parent_frame_name("missing");
+
+  // WHEN the snapshot is converted with parent indices
+  bosdyn_api_msgs::msg::FrameTreeSnapshot rosMsg;
+  std::vector<std::int32_t> parentIndices;
+  convertToRos(protoMsg, rosMsg, parentIndices);
+
+  // THEN every edge points to the edge of its parent frame, or to -1 if there is none
+  ASSERT_EQ(parentIndices.size(), rosMsg.child_to_parent_edge_map.size());
+  for (std::size_t i = 0; i < parentIndices.size(); ++i) {
+    const auto& entry = rosMsg.child_to_parent_edge_map[i];
+    if (entry.key == "odom" || entry.key == "gripper") {
+      EXPECT_EQ(parentIndices[i], -1);
+    } else {
+      ASSERT_GE(parentIndices[i], 0);
+      EXPECT_EQ(rosMsg.child_to_parent_edge_map[static_cast<std::size_t>(parentIndices[i])].key,
+                entry.value.parent_frame_name);
+    }
+  }
+}
+
 }  // namespace spot_ros2::test
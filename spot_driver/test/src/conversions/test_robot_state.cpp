@@ -17,6 +17,7 @@
 #include <geometry_msgs/msg/twist.hpp>
 #include <geometry_msgs/msg/vector3.hpp>
 #include <iterator>
+#include <sensor_msgs/msg/joint_state.hpp>
 #include <spot_driver/conversions/robot_state.hpp>
 #include <spot_driver/matchers.hpp>
 #include <spot_driver/robot_state_test_tools.hpp>
@@ -31,6 +32,7 @@ namespace {
 using ::testing::AllOf;
 using ::testing::Contains;
 using ::testing::DoubleEq;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::Field;
 using ::testing::IsEmpty;
@@ -247,6 +249,39 @@ TEST(RobotStateConversions, TestGetJointStatesNoJointStates) {
   EXPECT_THAT(out->effort, IsEmpty());
 }
 
+TEST(RobotStateConversions, TestJointStateConverterReusesMessage) {
+  // GIVEN a RobotState containing two joint states
+  ::bosdyn::api::RobotState robot_state;
+  robot_state.mutable_kinematic_state()->mutable_acquisition_timestamp()->set_seconds(15);
+  setJointState(robot_state.mutable_kinematic_state()->add_joint_states(), "fl.hx", 0.1, 0.2, 0.3, 0.4);
+  setJointState(robot_state.mutable_kinematic_state()->add_joint_states(), "arm0.wr0", 0.5, 0.6, 0.7, 0.8);
+  google::protobuf::Duration clock_skew;
+
+  // GIVEN a JointStateConverter which converted the RobotState into a message
+  JointStateConverter converter{"my_prefix/"};
+  sensor_msgs::msg::JointState joint_states;
+  ASSERT_THAT(converter.convert(robot_state, clock_skew, joint_states), IsTrue());
+
+  // WHEN the joints move and the RobotState is converted into the same message again
+  setJointState(robot_state.mutable_kinematic_state()->mutable_joint_states(0), "fl.hx", 1.1, 1.2, 1.3, 1.4);
+  ASSERT_THAT(converter.convert(robot_state, clock_skew, joint_states), IsTrue());
+
+  // THEN the message contains the same joints with the new values
+  EXPECT_THAT(joint_states.name, ElementsAre("my_prefix/front_left_hip_x", "my_prefix/arm_wr0"));
+  EXPECT_THAT(joint_states.position, ElementsAre(DoubleEq(1.1), DoubleEq(0.5)));
+  EXPECT_THAT(joint_states.velocity, ElementsAre(DoubleEq(1.2), DoubleEq(0.6)));
+  EXPECT_THAT(joint_states.effort, ElementsAre(DoubleEq(1.4), DoubleEq(0.8)));
+
+  // WHEN a RobotState with other joints is converted into the same message
+  robot_state.mutable_kinematic_state()->clear_joint_states();
+  setJointState(robot_state.mutable_kinematic_state()->add_joint_states(), "hr.kn", 2.1, 2.2, 2.3, 2.4);
+  ASSERT_THAT(converter.convert(robot_state, clock_skew, joint_states), IsTrue());
+
+  // THEN the names are rebuilt for the new joints
+  EXPECT_THAT(joint_states.name, ElementsAre("my_prefix/rear_right_knee"));
+  EXPECT_THAT(joint_states.position, ElementsAre(DoubleEq(2.1)));
+}
+
 TEST(RobotStateConversions, TestGetJointStatesNoKinematicState) {
   // GIVEN a RobotState that does not contain any kinematic state data whatsoever
   ::bosdyn::api::RobotState robot_state;
@@ -335,6 +370,42 @@ TEST(RobotStateConversions, TestGetTfInverted) {
   EXPECT_THAT(transform.transform, GeometryMsgsTransformEq(-1.0, -2.0, -3.0, 1.0, 0.0, 0.0, 0.0));
 }
 
+TEST(RobotStateConversions, TestFrameTreeConverterReusesMessage) {
+  // GIVEN a frame tree snapshot where the body and hand frames are children of the odom frame
+  ::bosdyn::api::FrameTreeSnapshot snapshot;
+  addRootFrame(&snapshot, "odom");
+  addTransform(&snapshot, "body", "odom", 1.0, 2.0, 3.0, 1.0, 0.0, 0.0, 0.0);
+  addTransform(&snapshot, "hand", "odom", 4.0, 5.0, 6.0, 1.0, 0.0, 0.0, 0.0);
+  google::protobuf::Timestamp timestamp;
+  timestamp.set_seconds(99);
+  google::protobuf::Duration clock_skew;
+  clock_skew.set_seconds(1);
+
+  // GIVEN a FrameTreeConverter which converted the snapshot
+  FrameTreeConverter converter{"prefix/", "odom"};
+  ASSERT_THAT(converter.convert(snapshot, timestamp, clock_skew), IsTrue());
+  ASSERT_THAT(converter.message().transforms, SizeIs(2));
+
+  // WHEN the body frame moved, the hand frame is no longer in the snapshot and the snapshot is converted again
+  ::bosdyn::api::FrameTreeSnapshot moved_snapshot;
+  addRootFrame(&moved_snapshot, "odom");
+  addTransform(&moved_snapshot, "body", "odom", 7.0, 8.0, 9.0, 1.0, 0.0, 0.0, 0.0);
+  timestamp.set_seconds(100);
+  ASSERT_THAT(converter.convert(moved_snapshot, timestamp, clock_skew), IsTrue());
+
+  // THEN the message only contains the moved body frame, with the new timestamp
+  ASSERT_THAT(converter.message().transforms, SizeIs(1));
+  const auto& transform = converter.message().transforms.at(0);
+  EXPECT_THAT(transform.header, ClockSkewIsAppliedToHeader(timestamp, clock_skew));
+  EXPECT_THAT(transform.header.frame_id, StrEq("prefix/odom"));
+  EXPECT_THAT(transform.child_frame_id, StrEq("prefix/body"));
+  EXPECT_THAT(transform.transform, GeometryMsgsTransformEq(7.0, 8.0, 9.0, 1.0, 0.0, 0.0, 0.0));
+
+  // WHEN an empty snapshot is converted
+  // THEN this fails
+  EXPECT_THAT(converter.convert(::bosdyn::api::FrameTreeSnapshot{}, timestamp, clock_skew), IsFalse());
+}
+
 TEST(RobotStateConversions, TestGetOdomTwist) {
   // GIVEN a RobotState that contains info about the velocity of the body in the odom frame
   ::bosdyn::api::RobotState robot_state;
@@ -0,0 +1,120 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <sensor_msgs/image_encodings.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/conversions/video_encoder.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+using ::testing::Eq;
+using ::testing::IsEmpty;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::Not;
+using ::testing::StrEq;
+
+sensor_msgs::msg::Image makeImage(const int width, const int height, const int sec) {
+  sensor_msgs::msg::Image image;
+  image.header.stamp.sec = sec;
+  image.header.frame_id = "frontleft_fisheye";
+  image.width = width;
+  image.height = height;
+  image.encoding = sensor_msgs::image_encodings::BGR8;
+  image.step = width * 3;
+  image.data.assign(image.step * height, static_cast<unsigned char>(sec * 16));
+  return image;
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(VideoEncoder, ToVideoCodec) {
+  // GIVEN the names of the supported codecs and an unsupported codec
+  // WHEN we convert them to a VideoCodec
+  // THEN the supported codecs are converted and the unsupported codec returns an error
+  EXPECT_THAT(toVideoCodec("h264").value(), Eq(VideoCodec::H264));
+  EXPECT_THAT(toVideoCodec("h265").value(), Eq(VideoCodec::H265));
+  EXPECT_THAT(toVideoCodec("vp9").has_value(), IsFalse());
+}
+
+TEST(VideoEncoder, ToVideoEncoderBackend) {
+  // GIVEN the names of the supported backends and an unsupported backend
+  // WHEN we convert them to a VideoEncoderBackend
+  // THEN the supported backends are converted and the unsupported backend returns an error
+  EXPECT_THAT(toVideoEncoderBackend("auto").value(), Eq(VideoEncoderBackend::AUTO));
+  EXPECT_THAT(toVideoEncoderBackend("nvenc").value(), Eq(VideoEncoderBackend::NVENC));
+  EXPECT_THAT(toVideoEncoderBackend("vaapi").value(), Eq(VideoEncoderBackend::VAAPI));
+  EXPECT_THAT(toVideoEncoderBackend("software").value(), Eq(VideoEncoderBackend::SOFTWARE));
+  EXPECT_THAT(toVideoEncoderBackend("quicksync").has_value(), IsFalse());
+}
+
+TEST(VideoEncoder, EncodeStartsWithKeyframe) {
+  // GIVEN a software H.264 encoder, if the driver was built with FFmpeg and x264
+  VideoEncoderOptions options;
+  options.backend = VideoEncoderBackend::SOFTWARE;
+  auto encoder = VideoEncoder::create(options, 64, 48);
+  if (!encoder.has_value()) {
+    GTEST_SKIP() << encoder.error();
+  }
+
+  // WHEN we encode a few images
+  std::vector<spot_msgs::msg::CompressedVideo> frames;
+  for (int i = 0; i < 3; ++i) {
+    auto result = encoder.value()->encode(makeImage(64, 48, i));
+    ASSERT_THAT(result.has_value(), IsTrue()) << result.error();
+    frames.insert(frames.end(), result->begin(), result->end());
+  }
+
+  // THEN every image yields a frame right away, the first of which is a keyframe stamped like its image
+  ASSERT_THAT(frames.size(), Eq(3U));
+  EXPECT_THAT(frames[0].keyframe, IsTrue());
+  EXPECT_THAT(frames[0].format, StrEq("h264"));
+  EXPECT_THAT(frames[0].header.frame_id, StrEq("frontleft_fisheye"));
+  EXPECT_THAT(frames[1].header.stamp.sec, Eq(1));
+  EXPECT_THAT(frames[0].data, Not(IsEmpty()));
+}
+
+TEST(VideoEncoder, RequestKeyframe) {
+  // GIVEN a software H.264 encoder which already encoded its first keyframe
+  VideoEncoderOptions options;
+  options.backend = VideoEncoderBackend::SOFTWARE;
+  options.keyframe_interval = 100;
+  auto encoder = VideoEncoder::create(options, 64, 48);
+  if (!encoder.has_value()) {
+    GTEST_SKIP() << encoder.error();
+  }
+  ASSERT_THAT(encoder.value()->encode(makeImage(64, 48, 0)).has_value(), IsTrue());
+  const auto delta_frame = encoder.value()->encode(makeImage(64, 48, 1));
+  ASSERT_THAT(delta_frame.has_value(), IsTrue());
+  ASSERT_THAT(delta_frame->size(), Eq(1U));
+  EXPECT_THAT(delta_frame->front().keyframe, IsFalse());
+
+  // WHEN we request a keyframe before the next image
+  encoder.value()->requestKeyframe();
+  const auto result = encoder.value()->encode(makeImage(64, 48, 2));
+
+  // THEN the next frame is a keyframe
+  ASSERT_THAT(result.has_value(), IsTrue());
+  ASSERT_THAT(result->size(), Eq(1U));
+  EXPECT_THAT(result->front().keyframe, IsTrue());
+}
+
+TEST(VideoEncoder, EncodeRejectsImageOfOtherSize) {
+  // GIVEN a software H.264 encoder for 64x48 images
+  VideoEncoderOptions options;
+  options.backend = VideoEncoderBackend::SOFTWARE;
+  auto encoder = VideoEncoder::create(options, 64, 48);
+  if (!encoder.has_value()) {
+    GTEST_SKIP() << encoder.error();
+  }
+
+  // WHEN we encode an image of a different size
+  const auto result = encoder.value()->encode(makeImage(32, 24, 0));
+
+  // THEN an error is returned
+  EXPECT_THAT(result.has_value(), IsFalse());
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,96 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <spot_driver/images/bandwidth_budget.hpp>
+#include <spot_driver/types.hpp>
+
+namespace {
+using ::testing::DoubleEq;
+using ::testing::Gt;
+using ::testing::Lt;
+}  // namespace
+
+namespace spot_ros2::images::test {
+TEST(BandwidthBudget, AdmitsSourcesWhichWereNotObservedYet) {
+  // GIVEN a budget which is far too small for any image
+  BandwidthBudget budget{1.0, 30.0, 80.0};
+  const ImageSource source{SpotCamera::BACK, SpotImageType::RGB};
+  budget.addSource(source, 10.0, 0);
+
+  // WHEN the sources are allocated before any response arrived
+  budget.allocate();
+
+  // THEN the source is requested at the maximum quality, so that its size can be learned
+  EXPECT_TRUE(budget.isAdmitted(source));
+  EXPECT_THAT(budget.quality(source), DoubleEq(80.0));
+}
+
+TEST(BandwidthBudget, NeverAdmitsSourcesWhichWereNotAdded) {
+  BandwidthBudget budget{1e9, 30.0, 80.0};
+  budget.allocate();
+  EXPECT_FALSE(budget.isAdmitted(ImageSource{SpotCamera::BACK, SpotImageType::RGB}));
+}
+
+TEST(BandwidthBudget, LowersQualityOfSourceWhichDoesNotFit) {
+  // GIVEN a budget of 1 MB/s, a high priority depth source of 0.4 MB/s and a low priority RGB source of 1 MB/s
+  BandwidthBudget budget{1e6, 30.0, 80.0};
+  const ImageSource depth{SpotCamera::FRONTLEFT, SpotImageType::DEPTH};
+  const ImageSource rgb{SpotCamera::BACK, SpotImageType::RGB};
+  budget.addSource(depth, 10.0, 1);
+  budget.addSource(rgb, 10.0, 0);
+  budget.update(depth, 40000, 80.0);
+  budget.update(rgb, 100000, 80.0);
+
+  // WHEN the sources are allocated
+  budget.allocate();
+
+  // THEN the depth source is requested as is, and the RGB source at the quality which fits into the rest of the budget
+  EXPECT_TRUE(budget.isAdmitted(depth));
+  EXPECT_TRUE(budget.isAdmitted(rgb));
+  EXPECT_THAT(budget.quality(rgb), DoubleEq(80.0 * 0.6));
+}
+
+TEST(BandwidthBudget, DropsLowPrioritySourcesWhichDoNotFitAtMinimumQuality) {
+  // GIVEN two RGB sources of 1 MB/s at maximum quality, and a budget for only one of them
+  BandwidthBudget budget{1.1e6, 30.0, 80.0};
+  const ImageSource important{SpotCamera::HAND, SpotImageType::RGB};
+  const ImageSource unimportant{SpotCamera::BACK, SpotImageType::RGB};
+  budget.addSource(important, 10.0, 5);
+  budget.addSource(unimportant, 10.0, 0);
+  budget.update(important, 100000, 80.0);
+  budget.update(unimportant, 100000, 80.0);
+
+  // WHEN the sources are allocated
+  budget.allocate();
+
+  // THEN only the source with the higher priority is requested
+  EXPECT_TRUE(budget.isAdmitted(important));
+  EXPECT_THAT(budget.quality(important), DoubleEq(80.0));
+  EXPECT_FALSE(budget.isAdmitted(unimportant));
+
+  // WHEN the source with the higher priority is no longer wanted
+  budget.setWanted(important, false);
+  budget.allocate();
+
+  // THEN the budget goes to the other source
+  EXPECT_FALSE(budget.isAdmitted(important));
+  EXPECT_TRUE(budget.isAdmitted(unimportant));
+}
+
+TEST(BandwidthBudget, NormalizesObservedSizesByQuality) {
+  // GIVEN an RGB source which was observed at half of the maximum quality
+  BandwidthBudget budget{1.5e6, 30.0, 80.0};
+  const ImageSource source{SpotCamera::LEFT, SpotImageType::RGB};
+  budget.addSource(source, 10.0, 0);
+  budget.update(source, 100000, 40.0);
+
+  // WHEN the sources are allocated
+  budget.allocate();
+
+  // THEN the source is estimated at 2 MB/s at maximum quality, and lowered to fit into the budget
+  EXPECT_TRUE(budget.isAdmitted(source));
+  EXPECT_THAT(budget.quality(source), Lt(80.0));
+  EXPECT_THAT(budget.quality(source), Gt(40.0));
+}
+}  // namespace spot_ros2::images::test
@@ -0,0 +1,90 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <builtin_interfaces/msg/time.hpp>
+#include <spot_driver/images/image_latency_probe.hpp>
+
+#include <sstream>
+
+namespace {
+using ::testing::AllOf;
+using ::testing::DoubleEq;
+using ::testing::DoubleNear;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::StrEq;
+
+builtin_interfaces::msg::Time makeTime(const int32_t sec, const uint32_t nanosec) {
+  return builtin_interfaces::build<builtin_interfaces::msg::Time>().sec(sec).nanosec(nanosec);
+}
+}  // namespace
+
+namespace spot_ros2::images::test {
+TEST(FrameAge, IsTheTimeBetweenStampAndReceiveTime) {
+  // GIVEN a frame stamped 50 ms before a second boundary, and received 20 ms after it
+  const auto stamp = makeTime(99, 950000000);
+  const auto receive_time = makeTime(100, 20000000);
+
+  // THEN its age is 70 ms
+  EXPECT_THAT(frameAge(stamp, receive_time), DoubleNear(0.07, 1e-12));
+  // THEN a stamp after the receive time has a negative age
+  EXPECT_THAT(frameAge(receive_time, stamp), DoubleNear(-0.07, 1e-12));
+}
+
+TEST(FrameAgeStatistics, ReportsExactPercentilesPerTopic) {
+  // GIVEN the ages 1 ms to 100 ms on one topic and a single age on another
+  FrameAgeStatistics statistics;
+  for (int i = 100; i >= 1; --i) {
+    statistics.add("camera/frontleft/image", i * 1e-3);
+  }
+  statistics.add("camera/back/camera_info", 0.004);
+
+  // WHEN the statistics are summarized
+  const auto summaries = statistics.summarize();
+
+  // THEN each topic is summarized with nearest-rank percentiles, ordered by topic
+  ASSERT_THAT(summaries, ElementsAre(Field(&FrameAgeStatistics::Summary::topic, StrEq("camera/back/camera_info")),
+                                     Field(&FrameAgeStatistics::Summary::topic, StrEq("camera/frontleft/image"))));
+  EXPECT_THAT(summaries[0].count, Eq(1U));
+  EXPECT_THAT(summaries[0].p99, DoubleEq(0.004));
+  EXPECT_THAT(summaries[1].count, Eq(100U));
+  EXPECT_THAT(summaries[1].mean, DoubleNear(0.0505, 1e-12));
+  EXPECT_THAT(summaries[1].p50, DoubleEq(0.05));
+  EXPECT_THAT(summaries[1].p90, DoubleEq(0.09));
+  EXPECT_THAT(summaries[1].p99, DoubleEq(0.099));
+  EXPECT_THAT(summaries[1].max, DoubleEq(0.1));
+}
+
+TEST(FrameAgeStatistics, ForgetsAgesWhenCleared) {
+  // GIVEN statistics with an age
+  FrameAgeStatistics statistics;
+  statistics.add("depth/hand/image", 0.01);
+
+  // WHEN they are cleared
+  statistics.clear();
+
+  // THEN nothing is summarized
+  EXPECT_THAT(statistics.summarize(), IsEmpty());
+}
+
+TEST(FrameAgeStatistics, WritesSummariesAsCsvInMilliseconds) {
+  // GIVEN statistics with two ages on one topic
+  FrameAgeStatistics statistics;
+  statistics.add("camera/hand/image", 0.01);
+  statistics.add("camera/hand/image", 0.03);
+
+  // WHEN the summaries are written as CSV
+  std::ostringstream csv;
+  writeSummaryCsv(statistics.summarize(), csv);
+
+  // THEN there is a header and one row with the durations in milliseconds
+  EXPECT_THAT(csv.str(), StrEq("topic,count,mean_ms,p50_ms,p90_ms,p99_ms,max_ms\n"
+                               "camera/hand/image,2,20.000,10.000,30.000,30.000,30.000\n"));
+  // THEN the table for the log contains the topic
+  EXPECT_THAT(formatSummaryTable(statistics.summarize()), AllOf(HasSubstr("p99 ms"), HasSubstr("camera/hand/image")));
+}
+}  // namespace spot_ros2::images::test
@@ -0,0 +1,86 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <spot_driver/api/spot_image_sources.hpp>
+#include <spot_driver/images/image_latency_statistics.hpp>
+#include <spot_driver/types.hpp>
+
+#include <chrono>
+
+namespace {
+using ::testing::AllOf;
+using ::testing::Contains;
+using ::testing::DoubleEq;
+using ::testing::DoubleNear;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::IsEmpty;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+}  // namespace
+
+namespace spot_ros2::images::test {
+TEST(LatencyHistogram, ReportsBucketEdgesAsPercentiles) {
+  // GIVEN a histogram with 90 latencies of 3 ms and 10 latencies of 30 ms
+  LatencyHistogram histogram;
+  for (int i = 0; i < 90; ++i) {
+    histogram.add(0.003);
+  }
+  for (int i = 0; i < 10; ++i) {
+    histogram.add(0.03);
+  }
+
+  // THEN the percentiles are the upper edges of the buckets which contain them
+  EXPECT_THAT(histogram.count(), Eq(100U));
+  EXPECT_THAT(histogram.percentile(0.5), DoubleEq(0.005));
+  EXPECT_THAT(histogram.percentile(0.95), DoubleEq(0.03));
+  EXPECT_THAT(histogram.mean(), DoubleNear(0.0057, 1e-9));
+  EXPECT_THAT(histogram.max(), DoubleEq(0.03));
+}
+
+TEST(LatencyHistogram, ReportsMaximumForOverflow) {
+  // GIVEN a histogram with a latency above the last bucket edge
+  LatencyHistogram histogram;
+  histogram.add(2.5);
+
+  // THEN the percentiles are bounded by the maximum latency
+  EXPECT_THAT(histogram.percentile(0.5), DoubleEq(2.5));
+  EXPECT_THAT(histogram.percentile(1.0), DoubleEq(2.5));
+}
+
+TEST(LatencyHistogram, EmptyHistogramReportsZero) {
+  const LatencyHistogram histogram;
+  EXPECT_THAT(histogram.percentile(0.95), DoubleEq(0.0));
+  EXPECT_THAT(histogram.mean(), DoubleEq(0.0));
+}
+
+TEST(ImageLatencyStatistics, CreatesStatusPerSource) {
+  // GIVEN latencies of two images from one source
+  ImageLatencyStatistics statistics;
+  const ImageSource source{SpotCamera::BACK, SpotImageType::RGB};
+  ImageLatency latency;
+  latency.robot_to_host = 0.04;
+  latency.decode = 0.004;
+  latency.publish = 0.001;
+  latency.response_time = std::chrono::steady_clock::now();
+  statistics.add(source, latency);
+  statistics.add(source, latency);
+
+  // WHEN the statistics are converted to diagnostics
+  const auto statuses = statistics.toDiagnosticStatus("prefix: ");
+
+  // THEN there is one status for the source, which reports the decode latency in milliseconds
+  ASSERT_THAT(statuses, SizeIs(1));
+  EXPECT_THAT(statuses[0].name, StrEq("prefix: " + toRosTopic(source)));
+  EXPECT_THAT(statuses[0].values,
+              Contains(AllOf(Field(&diagnostic_msgs::msg::KeyValue::key, StrEq("decode p50 (ms)")),
+                             Field(&diagnostic_msgs::msg::KeyValue::value, StrEq("4.000")))));
+
+  // WHEN the statistics are cleared
+  statistics.clear();
+
+  // THEN there are no more statuses
+  EXPECT_THAT(statistics.toDiagnosticStatus("prefix: "), IsEmpty());
+}
+}  // namespace spot_ros2::images::test
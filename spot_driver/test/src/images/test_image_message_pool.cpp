@@ -0,0 +1,65 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <sensor_msgs/msg/compressed_image.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/api/image_message_pool.hpp>
+#include <spot_driver/types.hpp>
+
+#include <utility>
+
+namespace {
+using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::IsEmpty;
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(ImageMessagePool, ReuseReleasedImageBuffer) {
+  // GIVEN a pool, and a published image message of the front left camera
+  ImageMessagePool pool;
+  const ImageSource source{SpotCamera::FRONTLEFT, SpotImageType::RGB};
+  sensor_msgs::msg::Image image;
+  image.data.resize(1024);
+  const auto* buffer = image.data.data();
+
+  // WHEN the message is released and an image for the same source is acquired
+  pool.releaseImage(source, std::move(image));
+  const auto recycled = pool.acquireImage(source);
+
+  // THEN the acquired message has the data buffer of the released one
+  EXPECT_THAT(recycled.data.data(), Eq(buffer));
+  EXPECT_THAT(recycled.data.capacity(), Ge(1024U));
+}
+
+TEST(ImageMessagePool, KeepSourcesSeparate) {
+  // GIVEN a pool which holds a compressed image message of the front left camera
+  ImageMessagePool pool;
+  sensor_msgs::msg::CompressedImage compressed_image;
+  compressed_image.data.resize(1024);
+  pool.releaseCompressedImage(ImageSource{SpotCamera::FRONTLEFT, SpotImageType::RGB}, std::move(compressed_image));
+
+  // WHEN a compressed image is acquired for another camera
+  const auto other = pool.acquireCompressedImage(ImageSource{SpotCamera::BACK, SpotImageType::RGB});
+
+  // THEN it is a new message
+  EXPECT_THAT(other.data, IsEmpty());
+}
+
+TEST(ImageMessagePool, DropMovedFromMessages) {
+  // GIVEN a pool, and an image message whose data was moved into the middleware
+  ImageMessagePool pool;
+  const ImageSource source{SpotCamera::HAND, SpotImageType::DEPTH};
+  sensor_msgs::msg::Image image;
+  image.data.resize(1024);
+  const auto moved = std::move(image);
+
+  // WHEN the moved-from message is released and an image for the same source is acquired
+  pool.releaseImage(source, std::move(image));  // NOLINT(bugprone-use-after-move)
+  const auto acquired = pool.acquireImage(source);
+
+  // THEN the moved-from message was not kept, and a new message is returned
+  EXPECT_THAT(acquired.data.capacity(), Eq(0U));
+}
+}  // namespace spot_ros2::test
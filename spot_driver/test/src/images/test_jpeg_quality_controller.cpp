@@ -0,0 +1,80 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <spot_driver/images/jpeg_quality_controller.hpp>
+#include <spot_driver/types.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace {
+using ::testing::DoubleEq;
+using ::testing::Gt;
+using ::testing::Lt;
+
+constexpr std::chrono::duration<double> kTargetPeriod{0.1};
+}  // namespace
+
+namespace spot_ros2::images::test {
+TEST(JpegQualityController, StartsAtMaximumQuality) {
+  const JpegQualityController controller{30.0, 80.0, kTargetPeriod};
+  EXPECT_THAT(controller.quality(ImageSource{SpotCamera::BACK, SpotImageType::RGB}), DoubleEq(80.0));
+}
+
+TEST(JpegQualityController, LowersLargestSourceFirstWhenRequestsFallBehind) {
+  // GIVEN a controller, and a response in which the hand camera accounts for most of the bytes
+  JpegQualityController controller{30.0, 80.0, kTargetPeriod};
+  const ImageSource hand{SpotCamera::HAND, SpotImageType::RGB};
+  const ImageSource back{SpotCamera::BACK, SpotImageType::RGB};
+  const std::vector<std::pair<ImageSource, std::size_t>> sizes{{hand, 900000}, {back, 100000}};
+
+  // WHEN the request took longer than its period
+  controller.update(sizes, std::chrono::duration<double>{0.2});
+
+  // THEN the quality of both sources is lowered, and the hand camera is lowered more
+  EXPECT_THAT(controller.quality(hand), Lt(80.0));
+  EXPECT_THAT(controller.quality(back), Lt(80.0));
+  EXPECT_THAT(controller.quality(hand), Lt(controller.quality(back)));
+}
+
+TEST(JpegQualityController, StaysWithinBounds) {
+  // GIVEN a controller and a source
+  JpegQualityController controller{30.0, 80.0, kTargetPeriod};
+  const ImageSource source{SpotCamera::FRONTLEFT, SpotImageType::RGB};
+  const std::vector<std::pair<ImageSource, std::size_t>> sizes{{source, 100000}};
+
+  // WHEN many requests fall far behind
+  for (int i = 0; i < 100; ++i) {
+    controller.update(sizes, std::chrono::duration<double>{1.0});
+  }
+  // THEN the quality stops at the minimum
+  EXPECT_THAT(controller.quality(source), DoubleEq(30.0));
+
+  // WHEN many requests finish well within their period
+  for (int i = 0; i < 100; ++i) {
+    controller.update(sizes, std::chrono::duration<double>{0.01});
+  }
+  // THEN the quality recovers up to the maximum
+  EXPECT_THAT(controller.quality(source), DoubleEq(80.0));
+}
+
+TEST(JpegQualityController, HoldsQualityWhileRequestsKeepUp) {
+  // GIVEN a controller whose source was lowered once
+  JpegQualityController controller{30.0, 80.0, kTargetPeriod};
+  const ImageSource source{SpotCamera::LEFT, SpotImageType::RGB};
+  const std::vector<std::pair<ImageSource, std::size_t>> sizes{{source, 100000}};
+  controller.update(sizes, std::chrono::duration<double>{0.2});
+  const auto lowered = controller.quality(source);
+  ASSERT_THAT(lowered, Lt(80.0));
+
+  // WHEN a request takes most, but not too much, of its period
+  controller.update(sizes, std::chrono::duration<double>{0.07});
+
+  // THEN the quality does not change
+  EXPECT_THAT(controller.quality(source), DoubleEq(lowered));
+  EXPECT_THAT(controller.quality(source), Gt(30.0));
+}
+}  // namespace spot_ros2::images::test
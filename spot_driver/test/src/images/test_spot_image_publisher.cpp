@@ -4,35 +4,75 @@
 
 #include <spot_driver/api/spot_image_sources.hpp>
 #include <spot_driver/images/spot_image_publisher.hpp>
+#include <spot_driver/interfaces/rclcpp_parameter_interface.hpp>
 #include <spot_driver/types.hpp>
 
 #include <spot_driver/fake/fake_parameter_interface.hpp>
+#include <spot_driver/fake/fake_thread_pool.hpp>
 #include <spot_driver/mock/mock_image_client.hpp>
 #include <spot_driver/mock/mock_logger_interface.hpp>
 #include <spot_driver/mock/mock_node_interface.hpp>
 #include <spot_driver/mock/mock_spot_api.hpp>
 #include <spot_driver/mock/mock_tf_broadcaster_interface.hpp>
 #include <spot_driver/mock/mock_timer_interface.hpp>
+#include <spot_driver/rclcpp_test.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <memory>
+#include <thread>
 #include <tl_expected/expected.hpp>
 
 using ::testing::_;
 using ::testing::AllOf;
+using ::testing::AnyNumber;
+using ::testing::DoubleEq;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::HasSubstr;
 using ::testing::InSequence;
 using ::testing::Invoke;
+using ::testing::IsEmpty;
+using ::testing::NotNull;
+using ::testing::Optional;
+using ::testing::Pair;
 using ::testing::Property;
 using ::testing::Return;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+using ::testing::Truly;
 using ::testing::Unused;
 
 namespace spot_ros2::test {
 class MockMiddlewareHandle : public images::SpotImagePublisher::MiddlewareHandle {
  public:
-  MOCK_METHOD(void, createPublishers, (const std::set<ImageSource>& image_sources, bool, bool), (override));
+  MOCK_METHOD(void, createPublishers,
+              (const std::set<ImageSource>& image_sources, const images::PublisherOptions& options), (override));
   MOCK_METHOD((tl::expected<void, std::string>), publishImages,
-              ((const std::map<ImageSource, ImageWithCameraInfo>&),
-               (const std::map<ImageSource, CompressedImageWithCameraInfo>&)),
+              ((std::vector<std::pair<ImageSource, ImageWithCameraInfo>>&),
+               (std::vector<std::pair<ImageSource, CompressedImageWithCameraInfo>>&)),
               (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishPreviewImages,
+              ((std::vector<std::pair<ImageSource, ImageWithCameraInfo>>)), (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishPointClouds,
+              ((std::vector<std::pair<ImageSource, sensor_msgs::msg::PointCloud2>>)), (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishCompressedDepthImages,
+              ((std::vector<std::pair<ImageSource, sensor_msgs::msg::CompressedImage>>)), (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishFilteredDepthImages,
+              ((std::vector<std::pair<ImageSource, ImageWithCameraInfo>>)), (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishLaserScan, (sensor_msgs::msg::LaserScan), (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishStitchedImage,
+              (const sensor_msgs::msg::Image&, const sensor_msgs::msg::CameraInfo&), (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishImageBundle, (spot_msgs::msg::ImageBundle), (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishRawImageResponse, (std::vector<std::uint8_t>), (override));
+  MOCK_METHOD(bool, hasSubscribers, (const ImageSource& image_source), (const, override));
+  MOCK_METHOD(bool, hasImageBundleSubscribers, (), (const, override));
+  MOCK_METHOD(bool, hasLaserScanSubscribers, (), (const, override));
+  MOCK_METHOD(bool, hasStitchedImageSubscribers, (), (const, override));
+  MOCK_METHOD(bool, hasRawImageResponseSubscribers, (), (const, override));
+  MOCK_METHOD(void, publishLatencyDiagnostics, (const diagnostic_msgs::msg::DiagnosticArray& diagnostics), (override));
 };
 
 class TestInitSpotImagePublisher : public ::testing::Test {
@@ -44,6 +84,7 @@ class TestInitSpotImagePublisher : public ::testing::Test {
     mock_logger_interface = std::make_unique<spot_ros2::test::MockLoggerInterface>();
     mock_tf_broadcaster_interface = std::make_unique<MockTfBroadcasterInterface>();
     mock_timer_interface = std::make_unique<MockTimerInterface>();
+    thread_pool = std::make_shared<FakeThreadPool>();
 
     middleware_handle_ptr = middleware_handle.get();
     fake_parameter_interface_ptr = fake_parameter_interface.get();
@@ -52,11 +93,17 @@ class TestInitSpotImagePublisher : public ::testing::Test {
     mock_timer_interface_ptr = mock_timer_interface.get();
   }
 
+  void TearDown() override {
+    // Destroying the image publisher waits for its background requests, so run those which a test left pending.
+    thread_pool->runPendingTasks();
+    image_publisher.reset();
+  }
+
   void createImagePublisher(bool has_arm) {
     image_publisher = std::make_unique<images::SpotImagePublisher>(
         image_client_interface, std::move(middleware_handle), std::move(fake_parameter_interface),
         std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface), std::move(mock_timer_interface),
-        has_arm);
+        has_arm, nullptr, metrics::MetricsRegistry::getDefault(), thread_pool);
   }
 
   std::unique_ptr<images::SpotImagePublisher> image_publisher;
@@ -67,6 +114,7 @@ class TestInitSpotImagePublisher : public ::testing::Test {
   std::unique_ptr<MockLoggerInterface> mock_logger_interface;
   std::unique_ptr<spot_ros2::test::MockTfBroadcasterInterface> mock_tf_broadcaster_interface;
   std::unique_ptr<spot_ros2::test::MockTimerInterface> mock_timer_interface;
+  std::shared_ptr<FakeThreadPool> thread_pool;
 
   MockMiddlewareHandle* middleware_handle_ptr = nullptr;
   FakeParameterInterface* fake_parameter_interface_ptr = nullptr;
@@ -114,7 +162,7 @@ TEST_F(TestRunSpotImagePublisher, PublishCallbackTriggersWithArm) {
     // THEN the static transforms to the image frames are updated
     InSequence seq;
     EXPECT_CALL(*image_client_interface,
-                getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 18), true, false));
+                getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 18), true, false, _));
     EXPECT_CALL(*middleware_handle, publishImages);
     EXPECT_CALL(*mock_tf_broadcaster_interface_ptr, updateStaticTransforms);
   }
@@ -151,7 +199,7 @@ TEST_F(TestRunSpotImagePublisher, PublishCallbackTriggersWithNoArm) {
     // THEN the static transforms to the image frames are updated
     InSequence seq;
     EXPECT_CALL(*image_client_interface,
-                getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 15), true, false));
+                getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 15), true, false, _));
     EXPECT_CALL(*middleware_handle, publishImages);
     EXPECT_CALL(*mock_tf_broadcaster_interface_ptr, updateStaticTransforms);
   }
@@ -166,4 +214,1022 @@ TEST_F(TestRunSpotImagePublisher, PublishCallbackTriggersWithNoArm) {
   // WHEN the timer callback is triggered
   mock_timer_interface_ptr->trigger();
 }
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackUsesPerCameraRates) {
+  // GIVEN we request RGB images from the body cameras and the hand camera
+  fake_parameter_interface_ptr->publish_rgb_images = true;
+  fake_parameter_interface_ptr->publish_depth_images = false;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  // GIVEN the hand camera is polled at 30 Hz, and the body cameras are polled at the default rate of 15 Hz
+  fake_parameter_interface_ptr->camera_publish_rates[SpotCamera::HAND] = 30.0;
+
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(1);
+
+  // THEN the timer runs at the fastest rate
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer(std::chrono::duration<double>{1.0 / 30.0}, _))
+      .Times(1)
+      .WillOnce([&](Unused, const std::function<void()>& cb) { mock_timer_interface_ptr->onSetTimer(cb); });
+
+  // THEN the hand camera is requested on its own on every tick, and the 5 body cameras are requested together on
+  // every other tick, on the thread pool
+  EXPECT_CALL(*image_client_interface,
+              getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 1), true, false, _))
+      .Times(2);
+  EXPECT_CALL(*image_client_interface,
+              getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 5), true, false, _))
+      .Times(1);
+
+  // GIVEN an image publisher for a robot with an arm
+  constexpr auto kHasArm{true};
+  createImagePublisher(kHasArm);
+
+  // GIVEN the SpotImagePublisher was successfully initialized
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered twice, and the thread pool runs the request of the body cameras
+  mock_timer_interface_ptr->trigger();
+  mock_timer_interface_ptr->trigger();
+  thread_pool->runPendingTasks();
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackKeepsRatesWhichAreNotIntegerFractions) {
+  // GIVEN we request RGB images from the body cameras at 20 Hz and from the hand camera at 30 Hz
+  fake_parameter_interface_ptr->publish_rgb_images = true;
+  fake_parameter_interface_ptr->publish_depth_images = false;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->camera_publish_rates[SpotCamera::HAND] = 30.0;
+  for (const auto camera :
+       {SpotCamera::FRONTLEFT, SpotCamera::FRONTRIGHT, SpotCamera::LEFT, SpotCamera::RIGHT, SpotCamera::BACK}) {
+    fake_parameter_interface_ptr->camera_publish_rates[camera] = 20.0;
+  }
+
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer(std::chrono::duration<double>{1.0 / 30.0}, _))
+      .Times(1)
+      .WillOnce([&](Unused, const std::function<void()>& cb) { mock_timer_interface_ptr->onSetTimer(cb); });
+
+  // THEN over 6 ticks of the 30 Hz timer, the hand camera is requested 6 times and the body cameras 4 times, which
+  // keeps their rate at 20 Hz instead of rounding it down to 15 Hz
+  EXPECT_CALL(*image_client_interface,
+              getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 1), true, false, _))
+      .Times(6);
+  EXPECT_CALL(*image_client_interface,
+              getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 5), true, false, _))
+      .Times(4);
+
+  // GIVEN an initialized image publisher for a robot with an arm
+  constexpr auto kHasArm{true};
+  createImagePublisher(kHasArm);
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered 6 times, and the thread pool runs the requests of the body cameras after each
+  for (int tick = 0; tick < 6; ++tick) {
+    mock_timer_interface_ptr->trigger();
+    thread_pool->runPendingTasks();
+  }
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackIsNotDelayedBySlowerGroup) {
+  // GIVEN we request RGB images from the body cameras at 15 Hz and from the hand camera at 30 Hz
+  fake_parameter_interface_ptr->publish_rgb_images = true;
+  fake_parameter_interface_ptr->publish_depth_images = false;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->camera_publish_rates[SpotCamera::HAND] = 30.0;
+
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // THEN the hand camera is requested on every tick while the body cameras are in flight, and the body cameras are not
+  // requested again before their request returns
+  EXPECT_CALL(*image_client_interface,
+              getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 1), true, false, _))
+      .Times(3);
+  EXPECT_CALL(*image_client_interface,
+              getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 5), true, false, _))
+      .Times(1);
+
+  // GIVEN an initialized image publisher for a robot with an arm
+  constexpr auto kHasArm{true};
+  createImagePublisher(kHasArm);
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered three times while the thread pool has not run the body camera request yet
+  mock_timer_interface_ptr->trigger();
+  mock_timer_interface_ptr->trigger();
+  mock_timer_interface_ptr->trigger();
+
+  // WHEN the thread pool runs the body camera request
+  thread_pool->runPendingTasks();
+}
+
+TEST_F(TestRunSpotImagePublisher, DestructorStopsTickInFlight) {
+  // GIVEN we request RGB images from the body cameras at 15 Hz, except for the back camera at 5 Hz
+  fake_parameter_interface_ptr->publish_rgb_images = true;
+  fake_parameter_interface_ptr->publish_depth_images = false;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->camera_publish_rates[SpotCamera::BACK] = 5.0;
+
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // GIVEN the request of the faster group does not return until it is released
+  std::promise<void> entered;
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  EXPECT_CALL(*image_client_interface,
+              getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 4), true, false, _))
+      .WillOnce([&entered, released](Unused, Unused, Unused, Unused) {
+        entered.set_value();
+        released.wait();
+        return GetImagesResult{};
+      });
+  // THEN the timer is cleared as soon as the destruction starts, which releases the request of the faster group
+  EXPECT_CALL(*mock_timer_interface_ptr, clearTimer).WillOnce([&release]() {
+    release.set_value();
+  });
+  // THEN the slower group, which would be requested after the faster one on the same tick, is not requested once the
+  // image publisher is being destroyed
+  EXPECT_CALL(*image_client_interface,
+              getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 1), true, false, _))
+      .Times(0);
+
+  // GIVEN an initialized image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback runs on another thread, like on a multi-threaded executor. The callback is copied, since
+  // the timer is destroyed with the image publisher.
+  const auto callback = mock_timer_interface_ptr->m_callback;
+  std::thread tick{callback};
+  entered.get_future().wait();
+
+  // WHEN the image publisher is destroyed while the tick is running
+  image_publisher.reset();
+  tick.join();
+}
+
+TEST_F(TestRunSpotImagePublisher, PauseSkipsTicksUntilResumed) {
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // THEN images are only requested by the tick after the image publisher was resumed
+  EXPECT_CALL(*image_client_interface, getImages).Times(1);
+
+  // GIVEN an initialized image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the image publisher is paused, and the timer callback is triggered
+  image_publisher->pause();
+  mock_timer_interface_ptr->trigger();
+
+  // WHEN the image publisher is resumed, and the timer callback is triggered again
+  image_publisher->resume();
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackPassesRequestOptions) {
+  // GIVEN up to 3 image requests may be in flight at once, static transforms are refreshed every 10 seconds, and images
+  // older than 250 ms are dropped
+  fake_parameter_interface_ptr->image_requests_in_flight = 3;
+  fake_parameter_interface_ptr->static_transforms_refresh_period = 10.0;
+  fake_parameter_interface_ptr->max_image_age = 0.25;
+
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // THEN the image client is asked to keep 3 requests in flight, to refresh the static transforms every 10 seconds, to
+  // drop images older than 250 ms, and to take its image messages from a pool
+  EXPECT_CALL(*image_client_interface,
+              getImages(_, true, false,
+                        AllOf(Field(&GetImagesOptions::max_requests_in_flight, 3),
+                              Field(&GetImagesOptions::static_transforms_refresh_period,
+                                    std::chrono::duration<double>{10.0}),
+                              Field(&GetImagesOptions::max_image_age, std::chrono::duration<double>{0.25}),
+                              Field(&GetImagesOptions::message_pool, NotNull()))))
+      .Times(1);
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // GIVEN the SpotImagePublisher was successfully initialized
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, WarmUpRequestsEverySourceBeforeTimerStarts) {
+  // GIVEN we request RGB images from the body cameras only when they have subscribers, and nothing is subscribed
+  fake_parameter_interface_ptr->publish_rgb_images = true;
+  fake_parameter_interface_ptr->publish_depth_images = false;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->on_demand_images = true;
+  EXPECT_CALL(*middleware_handle, hasSubscribers).WillRepeatedly(Return(false));
+
+  // GIVEN the image pipeline is warmed up during startup
+  fake_parameter_interface_ptr->warm_up_images = true;
+
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(1);
+  {
+    // THEN every body camera is requested and published once before the timer is set
+    InSequence seq;
+    EXPECT_CALL(*image_client_interface,
+                getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 5), true, false, _))
+        .Times(1);
+    EXPECT_CALL(*middleware_handle, publishImages).Times(1);
+    EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1);
+  }
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // WHEN the SpotImagePublisher is initialized
+  // THEN initialization succeeds
+  EXPECT_THAT(image_publisher->initialize(), testing::IsTrue());
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackOnlyRequestsSubscribedSources) {
+  // GIVEN we request RGB images from the body cameras only when they have subscribers
+  fake_parameter_interface_ptr->publish_rgb_images = true;
+  fake_parameter_interface_ptr->publish_depth_images = false;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->on_demand_images = true;
+
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // GIVEN only the front left camera has a subscriber during the first tick, and nothing is subscribed afterwards
+  auto frontleft_subscribed = true;
+  EXPECT_CALL(*middleware_handle, hasSubscribers).WillRepeatedly(Invoke([&](const ImageSource& source) {
+    return frontleft_subscribed && source.camera == SpotCamera::FRONTLEFT;
+  }));
+
+  // THEN only the front left camera is requested, and nothing is requested once its subscriber has left
+  EXPECT_CALL(*image_client_interface,
+              getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 1), true, false, _))
+      .Times(1);
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // GIVEN the SpotImagePublisher was successfully initialized
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered before and after the subscriber leaves
+  mock_timer_interface_ptr->trigger();
+  frontleft_subscribed = false;
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackSharesBandwidthBudgetByPriority) {
+  // GIVEN we request RGB images from the body cameras at 15 Hz within a budget of 2.25 MB/s, and the back camera has
+  // the highest priority
+  fake_parameter_interface_ptr->publish_rgb_images = true;
+  fake_parameter_interface_ptr->publish_depth_images = false;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->image_bandwidth_budget = 2.25e6;
+  fake_parameter_interface_ptr->camera_priorities[SpotCamera::BACK] = 1;
+
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // GIVEN every image in the response takes 100 kB, i.e. 1.5 MB/s at 15 Hz
+  GetImagesResult images;
+  for (const auto camera :
+       {SpotCamera::BACK, SpotCamera::FRONTLEFT, SpotCamera::FRONTRIGHT, SpotCamera::LEFT, SpotCamera::RIGHT}) {
+    images.response_sizes_.emplace_back(ImageSource{camera, SpotImageType::RGB}, 100000);
+  }
+
+  {
+    // THEN every camera is requested until its size is known, and then only the back camera at full quality and the
+    // front left camera at the quality which fits into the rest of the budget
+    InSequence seq;
+    EXPECT_CALL(*image_client_interface,
+                getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 5), true, false, _))
+        .WillOnce(Return(images));
+    const auto back_name = toSpotImageSourceName(ImageSource{SpotCamera::BACK, SpotImageType::RGB});
+    const auto frontleft_name = toSpotImageSourceName(ImageSource{SpotCamera::FRONTLEFT, SpotImageType::RGB});
+    EXPECT_CALL(*image_client_interface,
+                getImages(Truly([back_name, frontleft_name](const ::bosdyn::api::GetImageRequest& request) {
+                            return request.image_requests_size() == 2 &&
+                                   request.image_requests(0).image_source_name() == back_name &&
+                                   request.image_requests(0).quality_percent() == 70.0 &&
+                                   request.image_requests(1).image_source_name() == frontleft_name &&
+                                   request.image_requests(1).quality_percent() == 35.0;
+                          }),
+                          true, false, _))
+        .WillOnce(Return(images));
+  }
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // GIVEN the SpotImagePublisher was successfully initialized
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered twice
+  mock_timer_interface_ptr->trigger();
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackPublishesPreviews) {
+  // GIVEN we request depth images from the body cameras, with previews at half of the resolution
+  fake_parameter_interface_ptr->publish_rgb_images = false;
+  fake_parameter_interface_ptr->publish_depth_images = true;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->image_preview_scale = 2;
+
+  // THEN the publishers for the previews are created
+  images::PublisherOptions expected_options;
+  expected_options.uncompress_images = true;
+  expected_options.publish_preview_images = true;
+  EXPECT_CALL(*middleware_handle, createPublishers(_, expected_options)).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // GIVEN the image client returns a depth image
+  const ImageSource source{SpotCamera::FRONTLEFT, SpotImageType::DEPTH};
+  GetImagesResult images;
+  auto& image = images.images_.emplace_back(source, ImageWithCameraInfo{}).second;
+  image.image.width = 4;
+  image.image.height = 2;
+  image.image.encoding = "16UC1";
+  image.image.step = 8;
+  image.image.data.assign(16, 0);
+  image.info.width = 4;
+  image.info.height = 2;
+  EXPECT_CALL(*image_client_interface, getImages).WillOnce(Return(images));
+
+  // THEN a preview at half of the resolution is published for the image
+  EXPECT_CALL(*middleware_handle_ptr,
+              publishPreviewImages(ElementsAre(
+                  Pair(source, Field(&ImageWithCameraInfo::image, Field(&sensor_msgs::msg::Image::width, 2))))))
+      .Times(1);
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // GIVEN the SpotImagePublisher was successfully initialized
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackPublishesPointClouds) {
+  // GIVEN we request depth images from the body cameras, and point clouds decimated into 10 cm voxels
+  fake_parameter_interface_ptr->publish_rgb_images = false;
+  fake_parameter_interface_ptr->publish_depth_images = true;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->publish_depth_point_clouds = true;
+  fake_parameter_interface_ptr->point_cloud_voxel_size = 0.1;
+
+  // THEN the publishers for the point clouds are created
+  images::PublisherOptions expected_options;
+  expected_options.uncompress_images = true;
+  expected_options.publish_point_clouds = true;
+  EXPECT_CALL(*middleware_handle, createPublishers(_, expected_options)).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // THEN the image client is asked to create point clouds with the configured voxel size, and returns one
+  const ImageSource source{SpotCamera::FRONTLEFT, SpotImageType::DEPTH};
+  GetImagesResult images;
+  images.point_clouds_.emplace_back(source, sensor_msgs::msg::PointCloud2{}).second.width = 42;
+  EXPECT_CALL(*image_client_interface,
+              getImages(_, true, false,
+                        Field(&GetImagesOptions::point_clouds, Optional(Field(&PointCloudOptions::voxel_size, 0.1)))))
+      .WillOnce(Return(images));
+
+  // THEN the point cloud is published
+  EXPECT_CALL(*middleware_handle_ptr,
+              publishPointClouds(ElementsAre(Pair(source, Field(&sensor_msgs::msg::PointCloud2::width, 42)))))
+      .Times(1);
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // GIVEN the SpotImagePublisher was successfully initialized
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackPublishesCompressedDepthImages) {
+  // GIVEN we request depth images from the body cameras, and compressed depth images in the RVL format
+  fake_parameter_interface_ptr->publish_rgb_images = false;
+  fake_parameter_interface_ptr->publish_depth_images = true;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->publish_compressed_depth_images = true;
+  fake_parameter_interface_ptr->compressed_depth_format = "rvl";
+
+  // THEN the publishers for the compressed depth images are created
+  images::PublisherOptions expected_options;
+  expected_options.uncompress_images = true;
+  expected_options.publish_compressed_depth_images = true;
+  EXPECT_CALL(*middleware_handle, createPublishers(_, expected_options)).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // THEN the image client is asked to compress the depth images with RVL, and returns one
+  const ImageSource source{SpotCamera::FRONTLEFT, SpotImageType::DEPTH};
+  GetImagesResult images;
+  images.compressed_depth_images_.emplace_back(source, sensor_msgs::msg::CompressedImage{}).second.format =
+      "16UC1; compressedDepth rvl";
+  EXPECT_CALL(*image_client_interface,
+              getImages(_, true, false,
+                        Field(&GetImagesOptions::compressed_depth, Optional(CompressedDepthFormat::RVL))))
+      .WillOnce(Return(images));
+
+  // THEN the compressed depth image is published
+  EXPECT_CALL(*middleware_handle_ptr,
+              publishCompressedDepthImages(ElementsAre(
+                  Pair(source, Field(&sensor_msgs::msg::CompressedImage::format, "16UC1; compressedDepth rvl")))))
+      .Times(1);
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // GIVEN the SpotImagePublisher was successfully initialized
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackPublishesFilteredDepthImages) {
+  // GIVEN we request depth images from the body cameras, and filtered depth images decimated by 4
+  fake_parameter_interface_ptr->publish_rgb_images = false;
+  fake_parameter_interface_ptr->publish_depth_images = true;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->publish_filtered_depth_images = true;
+  fake_parameter_interface_ptr->filtered_depth_decimation = 4;
+
+  // THEN the publishers for the filtered depth images are created
+  images::PublisherOptions expected_options;
+  expected_options.uncompress_images = true;
+  expected_options.publish_filtered_depth_images = true;
+  EXPECT_CALL(*middleware_handle, createPublishers(_, expected_options)).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // THEN the image client is asked to filter the depth images with a decimation of 4, and returns one
+  const ImageSource source{SpotCamera::FRONTLEFT, SpotImageType::DEPTH};
+  GetImagesResult images;
+  images.filtered_depth_images_.emplace_back(source, ImageWithCameraInfo{});
+  EXPECT_CALL(*image_client_interface,
+              getImages(_, true, false,
+                        Field(&GetImagesOptions::depth_filter, Optional(Field(&DepthFilterOptions::decimation, 4U)))))
+      .WillOnce(Return(images));
+
+  // THEN the filtered depth image is published
+  EXPECT_CALL(*middleware_handle_ptr, publishFilteredDepthImages(ElementsAre(Pair(source, _)))).Times(1);
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // GIVEN the SpotImagePublisher was successfully initialized
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackPublishesLaserScan) {
+  // GIVEN we request depth images from the body cameras, and a laser scan with a narrower height band
+  fake_parameter_interface_ptr->publish_rgb_images = false;
+  fake_parameter_interface_ptr->publish_depth_images = true;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->publish_laser_scan = true;
+  fake_parameter_interface_ptr->laser_scan_min_height = -0.1;
+  fake_parameter_interface_ptr->laser_scan_max_height = 0.1;
+
+  // THEN the publisher for the laser scan is created
+  images::PublisherOptions expected_options;
+  expected_options.uncompress_images = true;
+  expected_options.publish_laser_scan = true;
+  EXPECT_CALL(*middleware_handle, createPublishers(_, expected_options)).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // THEN the image client is asked to build the laser scan in the height band, and returns one
+  GetImagesResult images;
+  images.laser_scan_.emplace().header.frame_id = "body";
+  images.laser_scan_->header.stamp.sec = 1;
+  EXPECT_CALL(*image_client_interface,
+              getImages(_, true, false,
+                        Field(&GetImagesOptions::laser_scan,
+                              Optional(AllOf(Field(&LaserScanOptions::min_height, DoubleEq(-0.1)),
+                                             Field(&LaserScanOptions::max_height, DoubleEq(0.1)))))))
+      .WillOnce(Return(images));
+
+  // THEN the laser scan is published
+  EXPECT_CALL(*middleware_handle_ptr,
+              publishLaserScan(Field(&sensor_msgs::msg::LaserScan::header,
+                                     Field(&std_msgs::msg::Header::frame_id, StrEq("body")))))
+      .Times(1);
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // GIVEN the SpotImagePublisher was successfully initialized
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackRequestsFrontCameraTransformsForStitchedImage) {
+  // GIVEN we request RGB images from the body cameras, and a stitched image of the front cameras
+  fake_parameter_interface_ptr->publish_rgb_images = true;
+  fake_parameter_interface_ptr->publish_depth_images = false;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->publish_stitched_front_image = true;
+
+  // THEN the publishers for the stitched image are created under the name of the virtual camera
+  images::PublisherOptions expected_options;
+  expected_options.uncompress_images = true;
+  expected_options.stitched_camera = "frontmiddle_virtual";
+  EXPECT_CALL(*middleware_handle, createPublishers(_, expected_options)).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // THEN the image client is asked for the transforms of the front RGB cameras, which the stitcher is built from
+  EXPECT_CALL(*image_client_interface,
+              getImages(_, true, false,
+                        Field(&GetImagesOptions::body_transform_sources,
+                              ElementsAre(ImageSource{SpotCamera::FRONTLEFT, SpotImageType::RGB},
+                                          ImageSource{SpotCamera::FRONTRIGHT, SpotImageType::RGB}))))
+      .WillOnce(Return(GetImagesResult{}));
+
+  // THEN nothing is stitched while the stitched image has no subscribers
+  EXPECT_CALL(*middleware_handle_ptr, hasStitchedImageSubscribers).WillRepeatedly(Return(false));
+  EXPECT_CALL(*middleware_handle_ptr, publishStitchedImage).Times(0);
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // GIVEN the SpotImagePublisher was successfully initialized
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, StitchedImageNeedsUncompressedImages) {
+  // GIVEN a stitched image of the front cameras, but the RGB images are not decoded
+  fake_parameter_interface_ptr->uncompress_images = false;
+  fake_parameter_interface_ptr->publish_compressed_images = true;
+  fake_parameter_interface_ptr->publish_stitched_front_image = true;
+
+  // THEN no publishers are created for the stitched image
+  images::PublisherOptions expected_options;
+  expected_options.publish_compressed_images = true;
+  EXPECT_CALL(*middleware_handle, createPublishers(_, expected_options)).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1);
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // WHEN the SpotImagePublisher is initialized
+  // THEN it still succeeds
+  ASSERT_TRUE(image_publisher->initialize());
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackPublishesImageBundle) {
+  // GIVEN we request depth images from the body cameras, and an image bundle which has a subscriber
+  fake_parameter_interface_ptr->publish_rgb_images = false;
+  fake_parameter_interface_ptr->publish_depth_images = true;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->publish_image_bundle = true;
+  EXPECT_CALL(*middleware_handle, hasImageBundleSubscribers).WillRepeatedly(Return(true));
+
+  // THEN the publisher for the image bundle is created
+  images::PublisherOptions expected_options;
+  expected_options.uncompress_images = true;
+  expected_options.publish_image_bundle = true;
+  EXPECT_CALL(*middleware_handle, createPublishers(_, expected_options)).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // GIVEN the first response carries the camera transforms, and the second one does not
+  const ImageSource source{SpotCamera::FRONTLEFT, SpotImageType::DEPTH};
+  GetImagesResult images;
+  images.images_.emplace_back(source, ImageWithCameraInfo{});
+  GetImagesResult images_with_transforms = images;
+  images_with_transforms.transforms_.emplace_back().child_frame_id = "frontleft";
+  EXPECT_CALL(*image_client_interface, getImages)
+      .WillOnce(Return(images_with_transforms))
+      .WillOnce(Return(images));
+  EXPECT_CALL(*middleware_handle_ptr, publishImages).Times(2);
+
+  // THEN both bundles contain the image and the camera transform
+  const auto is_bundle = AllOf(Field(&spot_msgs::msg::ImageBundle::image_sources, ElementsAre(toRosTopic(source))),
+                               Field(&spot_msgs::msg::ImageBundle::images, SizeIs(1)),
+                               Field(&spot_msgs::msg::ImageBundle::transforms,
+                                     ElementsAre(Field(&geometry_msgs::msg::TransformStamped::child_frame_id,
+                                                       "frontleft"))));
+  EXPECT_CALL(*middleware_handle_ptr, publishImageBundle(is_bundle)).Times(2);
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // GIVEN the SpotImagePublisher was successfully initialized
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered twice
+  mock_timer_interface_ptr->trigger();
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackPublishesOnlyRawImageResponse) {
+  // GIVEN we request depth images from the body cameras, and only publish the raw image responses
+  fake_parameter_interface_ptr->publish_rgb_images = false;
+  fake_parameter_interface_ptr->publish_depth_images = true;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->publish_raw_protobuf = true;
+  fake_parameter_interface_ptr->raw_protobuf_only = true;
+
+  // THEN the publisher for the raw image responses is created
+  images::PublisherOptions expected_options;
+  expected_options.uncompress_images = true;
+  expected_options.publish_raw_responses = true;
+  EXPECT_CALL(*middleware_handle, createPublishers(_, expected_options)).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // THEN the images are requested without converting them, and the serialized response is published
+  GetImagesResult images;
+  images.raw_response_ = {0x0a, 0x02, 0x08, 0x01};
+  EXPECT_CALL(*image_client_interface,
+              getImages(_, _, _,
+                        AllOf(Field(&GetImagesOptions::keep_raw_response, true),
+                              Field(&GetImagesOptions::convert_images, false))))
+      .WillOnce(Return(images));
+  EXPECT_CALL(*middleware_handle_ptr, publishRawImageResponse(ElementsAre(0x0a, 0x02, 0x08, 0x01)))
+      .WillOnce(Return(tl::expected<void, std::string>{}));
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // GIVEN the SpotImagePublisher was successfully initialized
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackPublishesLatencyDiagnostics) {
+  // GIVEN we request depth images from the body cameras, and latency diagnostics
+  fake_parameter_interface_ptr->publish_rgb_images = false;
+  fake_parameter_interface_ptr->publish_depth_images = true;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->publish_image_latency_diagnostics = true;
+
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // THEN the image client is asked to measure latencies, and returns the latency of one image
+  const ImageSource source{SpotCamera::FRONTLEFT, SpotImageType::DEPTH};
+  GetImagesResult images;
+  auto& latency = images.latencies_.emplace_back(source, ImageLatency{}).second;
+  latency.robot_to_host = 0.05;
+  latency.decode = 0.01;
+  latency.response_time = std::chrono::steady_clock::now();
+  EXPECT_CALL(*image_client_interface, getImages(_, true, false, Field(&GetImagesOptions::measure_latency, true)))
+      .WillOnce(Return(images));
+  EXPECT_CALL(*middleware_handle_ptr, publishImages).Times(1);
+
+  // THEN the first report contains a single diagnostic status for the image source
+  EXPECT_CALL(*middleware_handle_ptr,
+              publishLatencyDiagnostics(Field(&diagnostic_msgs::msg::DiagnosticArray::status,
+                                              ElementsAre(Field(&diagnostic_msgs::msg::DiagnosticStatus::name,
+                                                                HasSubstr(toRosTopic(source)))))))
+      .Times(1);
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // GIVEN the SpotImagePublisher was successfully initialized
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, HandCameraStreamUsesItsOwnTimer) {
+  // GIVEN we request RGB images, and a dedicated hand camera stream at 5 Hz with its own quality and resolution
+  fake_parameter_interface_ptr->publish_rgb_images = true;
+  fake_parameter_interface_ptr->publish_depth_images = false;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->hand_camera_stream_rate = 5.0;
+  fake_parameter_interface_ptr->hand_camera_stream_quality = 90.0;
+  fake_parameter_interface_ptr->hand_camera_stream_resize_ratio = 0.5;
+
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer(std::chrono::duration<double>{1.0 / 15.0}, _))
+      .WillOnce([&](Unused, const std::function<void()>& cb) { mock_timer_interface_ptr->onSetTimer(cb); });
+
+  // THEN the hand camera stream sets its own timer with its own rate
+  auto hand_camera_timer = std::make_unique<MockTimerInterface>();
+  auto* hand_camera_timer_ptr = hand_camera_timer.get();
+  EXPECT_CALL(*hand_camera_timer_ptr, setTimer(std::chrono::duration<double>{1.0 / 5.0}, _))
+      .WillOnce([&](Unused, const std::function<void()>& cb) { hand_camera_timer_ptr->onSetTimer(cb); });
+
+  // THEN the body camera request does not contain the hand camera
+  EXPECT_CALL(*image_client_interface,
+              getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 5), true, false, _))
+      .Times(1);
+  // THEN the hand camera request only contains the hand camera, with the stream quality and resolution
+  EXPECT_CALL(*image_client_interface, getImages(Truly([](const ::bosdyn::api::GetImageRequest& request) {
+                                                   return request.image_requests_size() == 1 &&
+                                                          request.image_requests(0).quality_percent() == 90.0 &&
+                                                          request.image_requests(0).resize_ratio() == 0.5;
+                                                 }),
+                                                 true, false, _))
+      .Times(1);
+  EXPECT_CALL(*middleware_handle_ptr, publishImages).Times(2);
+
+  // GIVEN an image publisher with an arm and a hand camera timer
+  image_publisher = std::make_unique<images::SpotImagePublisher>(
+      image_client_interface, std::move(middleware_handle), std::move(fake_parameter_interface),
+      std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface), std::move(mock_timer_interface),
+      true, std::move(hand_camera_timer), metrics::MetricsRegistry::getDefault(), thread_pool);
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN both timer callbacks are triggered, and the thread pool runs the hand camera request
+  mock_timer_interface_ptr->trigger();
+  hand_camera_timer_ptr->trigger();
+  thread_pool->runPendingTasks();
+}
+
+TEST_F(TestRunSpotImagePublisher, UpdateImageSourcesKeepsTimer) {
+  // GIVEN we request only RGB images
+  fake_parameter_interface_ptr->publish_rgb_images = true;
+  fake_parameter_interface_ptr->publish_depth_images = false;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+
+  // THEN the publishers are created for the 5 RGB sources, and then again for the added depth sources
+  {
+    InSequence seq;
+    EXPECT_CALL(*middleware_handle, createPublishers(SizeIs(5), _));
+    EXPECT_CALL(*middleware_handle, createPublishers(SizeIs(10), _));
+  }
+  // THEN the timer is only set once, since the rate of the cameras did not change
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  {
+    // THEN the first request contains the 5 RGB sources, and the next one also contains the depth sources, with the
+    // new RGB image quality
+    InSequence seq;
+    EXPECT_CALL(*image_client_interface,
+                getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 5), true, false, _));
+    EXPECT_CALL(*image_client_interface, getImages(Truly([](const ::bosdyn::api::GetImageRequest& request) {
+                                                     return request.image_requests_size() == 10 &&
+                                                            request.image_requests(0).quality_percent() == 50.0;
+                                                   }),
+                                                   true, false, _));
+  }
+
+  // GIVEN an initialized image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+  ASSERT_TRUE(image_publisher->initialize());
+  mock_timer_interface_ptr->trigger();
+
+  // WHEN depth images are enabled and the RGB image quality is changed at runtime
+  auto parameters = std::make_unique<FakeParameterInterface>();
+  parameters->publish_rgb_images = true;
+  parameters->publish_depth_images = true;
+  parameters->publish_depth_registered_images = false;
+  parameters->rgb_image_quality = 50.0;
+  // THEN the change is applied to the running publisher
+  EXPECT_THAT(image_publisher->updateImageSources(std::move(parameters)), testing::IsTrue());
+
+  // WHEN the timer callback is triggered again
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, UpdateImageSourcesResetsTimerWhenRateChanges) {
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(2);
+  // THEN the timer is set again with the new fastest rate
+  {
+    InSequence seq;
+    EXPECT_CALL(*mock_timer_interface_ptr, setTimer(std::chrono::duration<double>{1.0 / 15.0}, _));
+    EXPECT_CALL(*mock_timer_interface_ptr, setTimer(std::chrono::duration<double>{1.0 / 30.0}, _));
+  }
+
+  // GIVEN an initialized image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the rate of a camera is raised at runtime
+  auto parameters = std::make_unique<FakeParameterInterface>();
+  parameters->camera_publish_rates[SpotCamera::FRONTLEFT] = 30.0;
+  // THEN the change is applied to the running publisher
+  EXPECT_THAT(image_publisher->updateImageSources(std::move(parameters)), testing::IsTrue());
+}
+
+class TestUpdateSpotImagePublisherParameters : public RclcppTest {};
+
+TEST_F(TestUpdateSpotImagePublisherParameters, UpdateImageSourcesReadsChangedRclcppParameters) {
+  // GIVEN an image publisher which reads the parameters of a node, which RclcppParameterInterface caches
+  auto node = std::make_shared<rclcpp::Node>("test_update_image_sources");
+  auto middleware_handle = std::make_unique<MockMiddlewareHandle>();
+  auto timer = std::make_unique<MockTimerInterface>();
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(2);
+  // THEN the timer is set with the default rate, and again with the rate which was set after the first read
+  {
+    InSequence seq;
+    EXPECT_CALL(*timer, setTimer(std::chrono::duration<double>{1.0 / 15.0}, _));
+    EXPECT_CALL(*timer, setTimer(std::chrono::duration<double>{1.0 / 30.0}, _));
+  }
+  images::SpotImagePublisher image_publisher{std::make_shared<MockImageClient>(),
+                                             std::move(middleware_handle),
+                                             std::make_unique<RclcppParameterInterface>(node),
+                                             std::make_unique<MockLoggerInterface>(),
+                                             std::make_unique<MockTfBroadcasterInterface>(),
+                                             std::move(timer)};
+  ASSERT_TRUE(image_publisher.initialize());
+
+  // WHEN the rate of a camera is raised on the node, and the image sources are updated from a new interface
+  node->set_parameter(rclcpp::Parameter{"image_rate.frontleft", 30.0});
+  EXPECT_THAT(image_publisher.updateImageSources(std::make_unique<RclcppParameterInterface>(node)),
+              testing::IsTrue());
+}
+
+TEST_F(TestRunSpotImagePublisher, PublishCallbackSkipsTickAfterSlowRequest) {
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(1);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    mock_timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // GIVEN the first image request takes longer than the timer period of 1/15 s, and the next one is fast
+  // THEN the tick which became due during the slow request is skipped, so only two requests are made for three ticks
+  EXPECT_CALL(*image_client_interface, getImages)
+      .WillOnce([](Unused, Unused, Unused, Unused) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        return GetImagesResult{};
+      })
+      .WillOnce(Return(GetImagesResult{}));
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // GIVEN the SpotImagePublisher was successfully initialized
+  ASSERT_TRUE(image_publisher->initialize());
+
+  // WHEN the timer callback is triggered three times
+  mock_timer_interface_ptr->trigger();
+  mock_timer_interface_ptr->trigger();
+  mock_timer_interface_ptr->trigger();
+}
+
+TEST_F(TestRunSpotImagePublisher, StreamImagesDropsRepeatedFrames) {
+  // GIVEN we stream depth images from the body cameras instead of requesting them on a timer
+  fake_parameter_interface_ptr->publish_rgb_images = false;
+  fake_parameter_interface_ptr->publish_depth_images = true;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->stream_images = true;
+
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(1);
+  // THEN the timer is not used
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(0);
+
+  // GIVEN Spot returns the same frame twice, then a new frame, and then no images
+  const ImageSource source{SpotCamera::FRONTLEFT, SpotImageType::DEPTH};
+  GetImagesResult first_frame;
+  first_frame.images_.emplace_back(source, ImageWithCameraInfo{}).second.image.header.stamp.sec = 1;
+  GetImagesResult second_frame = first_frame;
+  second_frame.images_.front().second.image.header.stamp.sec = 2;
+  std::promise<void> streamed;
+  std::atomic<bool> streamed_set{false};
+  EXPECT_CALL(*image_client_interface, getImages)
+      .WillOnce(Return(first_frame))
+      .WillOnce(Return(first_frame))
+      .WillOnce(Return(second_frame))
+      .WillRepeatedly([&](Unused, Unused, Unused, Unused) {
+        if (!streamed_set.exchange(true)) {
+          streamed.set_value();
+        }
+        return GetImagesResult{};
+      });
+
+  // THEN the requests are made back to back, and the repeated frame is not published again
+  const auto has_frame = [](const int sec) {
+    return Truly([sec](const std::vector<std::pair<ImageSource, ImageWithCameraInfo>>& images) {
+      return images.size() == 1 && images.front().second.image.header.stamp.sec == sec;
+    });
+  };
+  {
+    InSequence seq;
+    EXPECT_CALL(*middleware_handle_ptr, publishImages(has_frame(1), _)).Times(1);
+    EXPECT_CALL(*middleware_handle_ptr, publishImages(IsEmpty(), _)).Times(1);
+    EXPECT_CALL(*middleware_handle_ptr, publishImages(has_frame(2), _)).Times(1);
+    EXPECT_CALL(*middleware_handle_ptr, publishImages(IsEmpty(), _)).Times(AnyNumber());
+  }
+
+  // GIVEN an image publisher for a robot without an arm
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+
+  // WHEN the SpotImagePublisher is initialized, and runs until it has streamed all frames
+  ASSERT_TRUE(image_publisher->initialize());
+  ASSERT_THAT(streamed.get_future().wait_for(std::chrono::seconds{5}), Eq(std::future_status::ready));
+  image_publisher.reset();
+}
+
+TEST_F(TestRunSpotImagePublisher, StreamImagesResumeAfterUpdateImageSources) {
+  // GIVEN we stream the RGB images of the body cameras instead of requesting them on a timer
+  fake_parameter_interface_ptr->publish_rgb_images = true;
+  fake_parameter_interface_ptr->publish_depth_images = false;
+  fake_parameter_interface_ptr->publish_depth_registered_images = false;
+  fake_parameter_interface_ptr->stream_images = true;
+
+  EXPECT_CALL(*middleware_handle, createPublishers).Times(2);
+  EXPECT_CALL(*mock_timer_interface_ptr, setTimer).Times(0);
+
+  // GIVEN Spot returns no images
+  const auto signal_once = [](std::promise<void>& promise, std::atomic<bool>& signaled) {
+    return [&promise, &signaled](Unused, Unused, Unused, Unused) {
+      if (!signaled.exchange(true)) {
+        promise.set_value();
+      }
+      return GetImagesResult{};
+    };
+  };
+  std::promise<void> streamed_rgb;
+  std::atomic<bool> streamed_rgb_set{false};
+  std::promise<void> streamed_depth;
+  std::atomic<bool> streamed_depth_set{false};
+  EXPECT_CALL(*image_client_interface,
+              getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 5), true, false, _))
+      .WillRepeatedly(signal_once(streamed_rgb, streamed_rgb_set));
+  // THEN the stream requests the depth images as well once the update was applied
+  EXPECT_CALL(*image_client_interface,
+              getImages(Property(&::bosdyn::api::GetImageRequest::image_requests_size, 10), true, false, _))
+      .WillRepeatedly(signal_once(streamed_depth, streamed_depth_set));
+
+  // GIVEN an initialized image publisher for a robot without an arm, which streams the RGB images
+  constexpr auto kHasArm{false};
+  createImagePublisher(kHasArm);
+  ASSERT_TRUE(image_publisher->initialize());
+  ASSERT_THAT(streamed_rgb.get_future().wait_for(std::chrono::seconds{5}), Eq(std::future_status::ready));
+
+  // WHEN depth images are enabled at runtime
+  auto parameters = std::make_unique<FakeParameterInterface>();
+  parameters->publish_rgb_images = true;
+  parameters->publish_depth_images = true;
+  parameters->publish_depth_registered_images = false;
+  parameters->stream_images = true;
+  EXPECT_THAT(image_publisher->updateImageSources(std::move(parameters)), testing::IsTrue());
+
+  // THEN the stream resumes with the new image sources
+  ASSERT_THAT(streamed_depth.get_future().wait_for(std::chrono::seconds{5}), Eq(std::future_status::ready));
+  image_publisher.reset();
+}
 }  // namespace spot_ros2::test
@@ -28,11 +28,31 @@ using ::testing::Return;
 namespace spot_ros2::test {
 class MockMiddlewareHandle : public images::SpotImagePublisher::MiddlewareHandle {
  public:
-  MOCK_METHOD(void, createPublishers, (const std::set<ImageSource>& image_sources, bool, bool), (override));
+  MOCK_METHOD(void, createPublishers,
+              (const std::set<ImageSource>& image_sources, const images::PublisherOptions& options), (override));
   MOCK_METHOD((tl::expected<void, std::string>), publishImages,
-              ((const std::map<ImageSource, ImageWithCameraInfo>&),
-               (const std::map<ImageSource, CompressedImageWithCameraInfo>&)),
+              ((std::vector<std::pair<ImageSource, ImageWithCameraInfo>>&),
+               (std::vector<std::pair<ImageSource, CompressedImageWithCameraInfo>>&)),
               (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishPreviewImages,
+              ((std::vector<std::pair<ImageSource, ImageWithCameraInfo>>)), (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishPointClouds,
+              ((std::vector<std::pair<ImageSource, sensor_msgs::msg::PointCloud2>>)), (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishCompressedDepthImages,
+              ((std::vector<std::pair<ImageSource, sensor_msgs::msg::CompressedImage>>)), (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishFilteredDepthImages,
+              ((std::vector<std::pair<ImageSource, ImageWithCameraInfo>>)), (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishLaserScan, (sensor_msgs::msg::LaserScan), (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishStitchedImage,
+              (const sensor_msgs::msg::Image&, const sensor_msgs::msg::CameraInfo&), (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishImageBundle, (spot_msgs::msg::ImageBundle), (override));
+  MOCK_METHOD((tl::expected<void, std::string>), publishRawImageResponse, (std::vector<std::uint8_t>), (override));
+  MOCK_METHOD(bool, hasSubscribers, (const ImageSource& image_source), (const, override));
+  MOCK_METHOD(bool, hasImageBundleSubscribers, (), (const, override));
+  MOCK_METHOD(bool, hasLaserScanSubscribers, (), (const, override));
+  MOCK_METHOD(bool, hasStitchedImageSubscribers, (), (const, override));
+  MOCK_METHOD(bool, hasRawImageResponseSubscribers, (), (const, override));
+  MOCK_METHOD(void, publishLatencyDiagnostics, (const diagnostic_msgs::msg::DiagnosticArray& diagnostics), (override));
 };
 
 class SpotImagePubNodeTestFixture : public ::testing::Test {
@@ -66,7 +86,7 @@ TEST_F(SpotImagePubNodeTestFixture, ConstructionSuccess) {
     EXPECT_CALL(*mock_spot_api, createRobot).Times(1);
     EXPECT_CALL(*mock_spot_api, authenticate).Times(1);
     EXPECT_CALL(*mock_spot_api, hasArm).Times(1);
-    EXPECT_CALL(*mock_spot_api, image_client_interface).Times(1);
+    EXPECT_CALL(*mock_spot_api, image_client_interface).Times(1).WillOnce(Return(std::make_shared<MockImageClient>()));
   }
 
   // THEN the underlying node base interface is accessed
@@ -141,4 +161,22 @@ TEST_F(SpotImagePubNodeTestFixture, ConstructionHasArmFailure) {
                std::runtime_error);
 }
 
+TEST_F(SpotImagePubNodeTestFixture, ConstructionImageClientFailure) {
+  {  // GIVEN a rclcpp::Node, MiddlewareInterface, and a SpotApi which cannot create an image client
+    // THEN expect the following calls in sequence
+    InSequence seq;
+    EXPECT_CALL(*mock_spot_api, createRobot).Times(1);
+    EXPECT_CALL(*mock_spot_api, authenticate).Times(1);
+    EXPECT_CALL(*mock_spot_api, hasArm).Times(1);
+    EXPECT_CALL(*mock_spot_api, image_client_interface).Times(1).WillOnce(Return(nullptr));
+  }
+  // WHEN constructing a SpotImagePublisherNode
+  // THEN the constructor throws
+  EXPECT_THROW(images::SpotImagePublisherNode(std::move(mock_spot_api), std::move(mock_middleware_handle),
+                                              std::move(fake_parameter_interface), std::move(mock_logger_interface),
+                                              std::move(mock_tf_broadcaster_interface), std::move(mock_timer_interface),
+                                              std::move(mock_node_interface)),
+               std::runtime_error);
+}
+
 }  // namespace spot_ros2::test
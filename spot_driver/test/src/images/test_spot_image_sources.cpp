@@ -6,11 +6,16 @@
 #include <spot_driver/types.hpp>
 #include <tl_expected/expected.hpp>
 
+#include <optional>
+#include <set>
+#include <string>
+
 namespace {
 using ::testing::AllOf;
 using ::testing::Eq;
 using ::testing::IsEmpty;
 using ::testing::IsFalse;
+using ::testing::Lt;
 using ::testing::Property;
 using ::testing::StrEq;
 using ::testing::UnorderedElementsAre;
@@ -252,4 +257,38 @@ TEST(SpotImageSources, createImageSources) {
                                    ImageSource{SpotCamera::FRONTLEFT, SpotImageType::DEPTH_REGISTERED},
                                    ImageSource{SpotCamera::FRONTRIGHT, SpotImageType::DEPTH_REGISTERED}));
 }
+
+TEST(SpotImageSources, toImageSourceIndex) {
+  // GIVEN every image source
+  const auto all_sources = createImageSources(
+      true, true, true,
+      {SpotCamera::BACK, SpotCamera::FRONTLEFT, SpotCamera::FRONTRIGHT, SpotCamera::LEFT, SpotCamera::RIGHT,
+       SpotCamera::HAND});
+
+  // WHEN each image source is converted to its dense index
+  // THEN every index is unique and fits in an array of kNumImageSources entries
+  std::set<std::size_t> indices;
+  for (const auto& source : all_sources) {
+    const auto index = toImageSourceIndex(source);
+    EXPECT_THAT(index, Lt(kNumImageSources));
+    indices.insert(index);
+  }
+  EXPECT_THAT(indices.size(), Eq(kNumImageSources));
+}
+
+TEST(SpotImageSources, ImageSourceRegistryRoundTrips) {
+  // GIVEN every entry of the image source registry
+  for (const auto& info : kImageSourceRegistry) {
+    // WHEN the entry is looked up by its image source and by its Spot API name
+    // THEN the lookups agree with the entry
+    EXPECT_THAT(&getImageSourceInfo(info.source), Eq(&info));
+    EXPECT_THAT(toRosTopic(info.source), StrEq(std::string{info.topic}));
+    EXPECT_THAT(toSpotImageSourceName(info.source), StrEq(std::string{info.api_name}));
+    EXPECT_THAT(fromSpotImageSourceName(info.api_name).value(), Eq(info.source));
+  }
+
+  // WHEN an unknown name is looked up
+  // THEN no image source is found
+  EXPECT_THAT(findImageSource("hand_image"), Eq(std::nullopt));
+}
 }  // namespace spot_ros2::images::test
@@ -0,0 +1,205 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <spot_driver/kinematic/forward_kinematic_service.hpp>
+#include <spot_driver/kinematic/forward_kinematics.hpp>
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spot_ros2::kinematic::test {
+namespace {
+using ::testing::DoubleNear;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::Optional;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+
+// A shoulder which turns about z, an elbow which is rotated by 90 degrees about z and extends along its x axis, and a
+// tool fixed to the end of the elbow.
+constexpr auto kUrdf = R"(<?xml version="1.0"?>
+<robot name="arm">
+  <link name="body"/>
+  <link name="shoulder"/>
+  <link name="elbow"/>
+  <link name="tool"/>
+  <joint name="shoulder_z" type="revolute">
+    <parent link="body"/>
+    <child link="shoulder"/>
+    <origin xyz="1 0 0" rpy="0 0 0"/>
+    <axis xyz="0 0 1"/>
+    <limit lower="-3" upper="3" effort="1" velocity="1"/>
+  </joint>
+  <joint name="elbow_x" type="prismatic">
+    <parent link="shoulder"/>
+    <child link="elbow"/>
+    <origin xyz="1 0 0" rpy="0 0 1.5707963267948966"/>
+    <axis xyz="1 0 0"/>
+    <limit lower="0" upper="1" effort="1" velocity="1"/>
+  </joint>
+  <joint name="tool_fixed" type="fixed">
+    <parent link="elbow"/>
+    <child link="tool"/>
+    <origin xyz="0 0 0.5" rpy="0 0 0"/>
+  </joint>
+</robot>)";
+
+constexpr double kTolerance = 1e-9;
+
+class MockMiddlewareHandle : public ForwardKinematicService::MiddlewareHandle {
+ public:
+  MOCK_METHOD((void), createService,
+              (std::string service_name,
+               std::function<void(const std::shared_ptr<GetForwardKinematicSolutions::Request>,
+                                  std::shared_ptr<GetForwardKinematicSolutions::Response>)>
+                   callback),
+              (override));
+};
+
+sensor_msgs::msg::JointState createJointState(double shoulder, double elbow) {
+  sensor_msgs::msg::JointState joint_state;
+  // The joints are listed in another order than in the URDF, with a joint that the URDF does not have
+  joint_state.name = {"elbow_x", "gripper", "shoulder_z"};
+  joint_state.position = {elbow, 0.0, shoulder};
+  return joint_state;
+}
+}  // namespace
+
+TEST(ForwardKinematics, ParseUrdf) {
+  // GIVEN a URDF with a revolute, a prismatic and a fixed joint
+  // WHEN it is parsed
+  const auto kinematics = ForwardKinematics::fromUrdf(kUrdf);
+
+  // THEN all links are found with the root first, and only the movable joints have positions
+  ASSERT_THAT(kinematics.has_value(), IsTrue());
+  EXPECT_THAT(kinematics->getRootLink(), StrEq("body"));
+  EXPECT_THAT(kinematics->getLinkNames(), ElementsAre("body", "shoulder", "elbow", "tool"));
+  EXPECT_THAT(kinematics->getJointNames(), ElementsAre("shoulder_z", "elbow_x"));
+  EXPECT_THAT(kinematics->getLinkIndex("tool"), Optional(Eq(3U)));
+  EXPECT_THAT(kinematics->getLinkIndex("gripper").has_value(), IsFalse());
+}
+
+TEST(ForwardKinematics, ParseInvalidUrdfFails) {
+  // GIVEN a document which is not a URDF
+  // WHEN it is parsed
+  // THEN parsing fails
+  EXPECT_THAT(ForwardKinematics::fromUrdf("<robot>").has_value(), IsFalse());
+}
+
+TEST(ForwardKinematics, ComputeLinkPoses) {
+  // GIVEN the kinematics of the URDF and joint positions
+  const auto kinematics = ForwardKinematics::fromUrdf(kUrdf).value();
+  const auto positions = kinematics.toJointPositions(createJointState(M_PI / 2.0, 0.25));
+  ASSERT_THAT(positions.has_value(), IsTrue());
+
+  // WHEN the link poses are computed
+  std::vector<Eigen::Isometry3d> root_tform_links;
+  kinematics.computeLinkPoses(*positions, root_tform_links);
+
+  // THEN the shoulder turns the elbow from the x axis to the y axis, and the elbow then extends along -x
+  ASSERT_THAT(root_tform_links, SizeIs(4));
+  EXPECT_THAT(root_tform_links[0].isApprox(Eigen::Isometry3d::Identity()), IsTrue());
+  const Eigen::Vector3d elbow = root_tform_links[2].translation();
+  EXPECT_THAT(elbow.x(), DoubleNear(1.0 - 0.25, kTolerance));
+  EXPECT_THAT(elbow.y(), DoubleNear(1.0, kTolerance));
+  EXPECT_THAT(elbow.z(), DoubleNear(0.0, kTolerance));
+  const Eigen::Vector3d tool = root_tform_links[3].translation();
+  EXPECT_THAT(tool.z(), DoubleNear(0.5, kTolerance));
+  EXPECT_THAT(root_tform_links[3].linear().isApprox(Eigen::AngleAxisd{M_PI, Eigen::Vector3d::UnitZ()}.matrix()),
+              IsTrue());
+}
+
+TEST(ForwardKinematics, JacobianMatchesFiniteDifferences) {
+  // GIVEN the kinematics of the URDF and joint positions
+  const auto kinematics = ForwardKinematics::fromUrdf(kUrdf).value();
+  const auto positions = kinematics.toJointPositions(createJointState(0.3, 0.4)).value();
+  std::vector<Eigen::Isometry3d> root_tform_links;
+  kinematics.computeLinkPoses(positions, root_tform_links);
+
+  // WHEN the Jacobian of the tool is computed
+  const auto tool = kinematics.getLinkIndex("tool").value();
+  Jacobian jacobian;
+  kinematics.computeJacobian(root_tform_links, tool, jacobian);
+
+  // THEN the linear velocity of every joint matches the motion of the tool when the joint moves a little
+  ASSERT_THAT(jacobian.cols(), Eq(2));
+  constexpr double kStep = 1e-6;
+  for (Eigen::Index joint = 0; joint < jacobian.cols(); ++joint) {
+    auto moved = positions;
+    moved[joint] += kStep;
+    std::vector<Eigen::Isometry3d> moved_links;
+    kinematics.computeLinkPoses(moved, moved_links);
+    const Eigen::Vector3d velocity = (moved_links[tool].translation() - root_tform_links[tool].translation()) / kStep;
+    EXPECT_THAT(jacobian.col(joint).head<3>().isApprox(velocity, 1e-4), IsTrue()) << "joint " << joint;
+  }
+  // AND THEN only the revolute joint turns the tool
+  EXPECT_THAT(jacobian.col(0).tail<3>().isApprox(Eigen::Vector3d::UnitZ()), IsTrue());
+  EXPECT_THAT(jacobian.col(1).tail<3>().isZero(), IsTrue());
+}
+
+TEST(ForwardKinematics, MissingJointFails) {
+  // GIVEN the kinematics of the URDF and a joint state without the elbow joint
+  const auto kinematics = ForwardKinematics::fromUrdf(kUrdf).value();
+  sensor_msgs::msg::JointState joint_state;
+  joint_state.name = {"shoulder_z"};
+  joint_state.position = {0.0};
+
+  // WHEN the joint positions are gathered
+  // THEN it fails
+  EXPECT_THAT(kinematics.toJointPositions(joint_state).has_value(), IsFalse());
+}
+
+TEST(ForwardKinematicService, SolveBatch) {
+  // GIVEN the service for the URDF
+  auto middleware_handle = std::make_unique<MockMiddlewareHandle>();
+  EXPECT_CALL(*middleware_handle, createService).Times(1);
+  ForwardKinematicService service{ForwardKinematics::fromUrdf(kUrdf).value(), std::move(middleware_handle)};
+  service.initialize();
+
+  // WHEN a request with two joint states and two links is solved with the Jacobians
+  auto request = std::make_shared<GetForwardKinematicSolutions::Request>();
+  request->joint_states = {createJointState(0.0, 0.0), createJointState(M_PI / 2.0, 0.25)};
+  request->link_names = {"tool", "shoulder"};
+  request->compute_jacobians = true;
+  auto response = std::make_shared<GetForwardKinematicSolutions::Response>();
+  service.getSolutions(request, response);
+
+  // THEN there is a pose and a Jacobian of each link for each joint state, in the order of the request
+  ASSERT_THAT(response->success, IsTrue());
+  EXPECT_THAT(response->root_link, StrEq("body"));
+  EXPECT_THAT(response->link_names, ElementsAre("tool", "shoulder"));
+  EXPECT_THAT(response->joint_names, ElementsAre("shoulder_z", "elbow_x"));
+  ASSERT_THAT(response->poses, SizeIs(4));
+  EXPECT_THAT(response->jacobians, SizeIs(4 * 6 * 2));
+  EXPECT_THAT(response->poses[0].position.x, DoubleNear(2.0, kTolerance));
+  EXPECT_THAT(response->poses[1].position.x, DoubleNear(1.0, kTolerance));
+  EXPECT_THAT(response->poses[2].position.x, DoubleNear(0.75, kTolerance));
+  EXPECT_THAT(response->poses[2].position.y, DoubleNear(1.0, kTolerance));
+}
+
+TEST(ForwardKinematicService, UnknownLinkFails) {
+  // GIVEN the service for the URDF
+  ForwardKinematicService service{ForwardKinematics::fromUrdf(kUrdf).value(), std::make_unique<MockMiddlewareHandle>()};
+
+  // WHEN a link which the URDF does not have is requested
+  auto request = std::make_shared<GetForwardKinematicSolutions::Request>();
+  request->joint_states = {createJointState(0.0, 0.0)};
+  request->link_names = {"gripper"};
+  auto response = std::make_shared<GetForwardKinematicSolutions::Response>();
+  service.getSolutions(request, response);
+
+  // THEN the request fails without poses
+  EXPECT_THAT(response->success, IsFalse());
+  EXPECT_THAT(response->message, HasSubstr("gripper"));
+  EXPECT_THAT(response->poses, IsEmpty());
+}
+}  // namespace spot_ros2::kinematic::test
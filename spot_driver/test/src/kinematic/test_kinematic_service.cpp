@@ -2,9 +2,16 @@
 
 #include <gmock/gmock.h>
 
+#include <chrono>
+#include <functional>
+#include <future>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <spot_driver/api/kinematic_api.hpp>
+#include <spot_driver/kinematic/kinematic_cache.hpp>
 #include <spot_driver/kinematic/kinematic_service.hpp>
 #include <spot_driver/mock/mock_kinematic_api.hpp>
 #include <spot_driver/mock/mock_logger_interface.hpp>
@@ -14,14 +21,26 @@
 namespace spot_ros2::kinematic::test {
 
 using ::testing::_;
+using ::testing::Eq;
+using ::testing::Gt;
+using ::testing::Invoke;
+using ::testing::SaveArg;
+using ::testing::SizeIs;
 using ::testing::Return;
 
 class MockMiddlewareHandle : public KinematicService::MiddlewareHandle {
  public:
   MOCK_METHOD((void), createService,
-              (std::string serviceName, std::function<void(const std::shared_ptr<GetInverseKinematicSolutions::Request>,
-                                                           std::shared_ptr<GetInverseKinematicSolutions::Response>)>
-                                            callback),
+              (std::string serviceName,
+               std::function<void(const std::shared_ptr<GetInverseKinematicSolutions::Request>,
+                                  KinematicService::Responder)>
+                   callback),
+              (override));
+  MOCK_METHOD((void), createBatchService,
+              (std::string serviceName,
+               std::function<void(const std::shared_ptr<GetInverseKinematicSolutionsBatch::Request>,
+                                  KinematicService::BatchResponder)>
+                   callback),
               (override));
 };
 
@@ -33,9 +52,51 @@ TEST(TestKinematicService, initialize) {
   auto logger = std::make_shared<spot_ros2::test::MockLoggerInterface>();
   auto middleware = std::make_unique<MockMiddlewareHandle>();
   EXPECT_CALL(*middleware, createService(_, _)).Times(1);
+  EXPECT_CALL(*middleware, createBatchService(_, _)).Times(1);
+
+  auto ik_service = std::make_unique<KinematicService>(std::move(ik_api), logger, std::move(middleware));
+  ik_service->initialize();
+}
+
+/**
+ * Test that the service callback returns before the response is sent, and that the response is sent once solved.
+ */
+TEST(TestKinematicService, serviceCallbackDefersResponse) {
+  auto ik_api = std::make_unique<spot_ros2::test::MockKinematicApi>();
+
+  // GIVEN the IK API takes a while to solve a request.
+  std::promise<void> solve;
+  auto solve_future = solve.get_future().share();
+  InverseKinematicsResponse fake_response;
+  fake_response.set_status(bosdyn::api::spot::InverseKinematicsResponse_Status_STATUS_OK);
+  EXPECT_CALL(*ik_api, getSolutions(_, _))
+      .WillOnce(Invoke([solve_future, fake_response](InverseKinematicsRequest&, std::chrono::duration<double>) {
+        solve_future.wait();
+        return tl::expected<InverseKinematicsResponse, std::string>{fake_response};
+      }));
+
+  auto logger = std::make_shared<spot_ros2::test::MockLoggerInterface>();
+  auto middleware = std::make_unique<MockMiddlewareHandle>();
+  std::function<void(const std::shared_ptr<GetInverseKinematicSolutions::Request>, KinematicService::Responder)>
+      callback;
+  EXPECT_CALL(*middleware, createService(_, _)).WillOnce(SaveArg<1>(&callback));
 
   auto ik_service = std::make_unique<KinematicService>(std::move(ik_api), logger, std::move(middleware));
   ik_service->initialize();
+  ASSERT_TRUE(callback);
+
+  // WHEN a request is received by the service
+  std::promise<std::shared_ptr<GetInverseKinematicSolutions::Response>> response;
+  auto response_future = response.get_future();
+  callback(std::make_shared<GetInverseKinematicSolutions::Request>(),
+           [&response](std::shared_ptr<GetInverseKinematicSolutions::Response> solved) { response.set_value(solved); });
+
+  // THEN the callback returns before the request is solved, and the response is sent once it is.
+  EXPECT_EQ(response_future.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+  solve.set_value();
+  ASSERT_EQ(response_future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+  EXPECT_EQ(response_future.get()->response.status.value,
+            bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_OK);
 }
 
 /**
@@ -54,7 +115,7 @@ TEST(TestKinematicService, getSolutions) {
   fake_response.set_status(bosdyn::api::spot::InverseKinematicsResponse_Status_STATUS_OK);
   tl::expected<InverseKinematicsResponse, std::string> fake_result(fake_response);
 
-  EXPECT_CALL(*ik_api, getSolutions(_)).WillOnce(Return(fake_result));
+  EXPECT_CALL(*ik_api, getSolutions(_, _)).WillOnce(Return(fake_result));
 
   auto logger = std::make_shared<spot_ros2::test::MockLoggerInterface>();
   auto middleware = std::make_unique<MockMiddlewareHandle>();
@@ -73,13 +134,41 @@ TEST(TestKinematicService, getSolutions) {
   ASSERT_EQ(response->response.status.value, bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_OK);
 }
 
+/**
+ * Test that the requests to Spot are sent with the timeout of the service.
+ */
+TEST(TestKinematicService, getSolutionsWithTimeout) {
+  // GIVEN an IK service which cancels the requests to Spot after half a second
+  auto ik_api = std::make_unique<spot_ros2::test::MockKinematicApi>();
+  const std::chrono::duration<double> timeout{0.5};
+
+  // THEN the request is sent to Spot with the timeout, and times out
+  EXPECT_CALL(*ik_api, getSolutions(_, Eq(timeout)))
+      .WillOnce(Return(tl::make_unexpected("The InverseKinematics request timed out after 0.500000 s.")));
+
+  auto logger = std::make_shared<spot_ros2::test::MockLoggerInterface>();
+  auto middleware = std::make_unique<MockMiddlewareHandle>();
+  auto ik_service =
+      std::make_unique<KinematicService>(std::move(ik_api), logger, std::move(middleware), nullptr, nullptr, timeout);
+  ik_service->initialize();
+
+  // WHEN an IK request is made through the IK service
+  auto request = std::make_shared<GetInverseKinematicSolutions::Request>();
+  auto response = std::make_shared<GetInverseKinematicSolutions::Response>();
+  ik_service->getSolutions(request, response);
+
+  // THEN the IK response does not report a solution
+  ASSERT_EQ(response->response.status.value,
+            bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_UNKNOWN);
+}
+
 /**
  * Test the behavior of the service when an exception is thrown during an IK request.
  */
 TEST(TestKinematicService, getSolutionsException) {
   auto ik_api = std::make_unique<spot_ros2::test::MockKinematicApi>();
 
-  EXPECT_CALL(*ik_api, getSolutions(_)).WillOnce(Return(tl::make_unexpected("Some error")));
+  EXPECT_CALL(*ik_api, getSolutions(_, _)).WillOnce(Return(tl::make_unexpected("Some error")));
 
   auto logger = std::make_shared<spot_ros2::test::MockLoggerInterface>();
   auto middleware = std::make_unique<MockMiddlewareHandle>();
@@ -95,4 +184,225 @@ TEST(TestKinematicService, getSolutionsException) {
             bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_UNKNOWN);
 }
 
+/**
+ * Test that a batch of IK requests is sent to the IK API at once, and that every request gets its own response.
+ */
+TEST(TestKinematicService, getBatchSolutions) {
+  auto ik_api = std::make_unique<spot_ros2::test::MockKinematicApi>();
+
+  // GIVEN the IK API will solve the first request of a batch and fail the second one.
+  // THEN the whole batch is sent to the IK API in a single call, allowing concurrent requests.
+  InverseKinematicsResponse fake_response;
+  fake_response.set_status(bosdyn::api::spot::InverseKinematicsResponse_Status_STATUS_OK);
+  std::vector<tl::expected<InverseKinematicsResponse, std::string>> fake_results{
+      fake_response, tl::make_unexpected("Some error")};
+  EXPECT_CALL(*ik_api, getSolutions(_, _)).Times(0);
+  EXPECT_CALL(*ik_api, getBatchSolutions(SizeIs(2), Gt(1u), _)).WillOnce(Return(fake_results));
+
+  auto logger = std::make_shared<spot_ros2::test::MockLoggerInterface>();
+  EXPECT_CALL(*logger, logError(_)).Times(1);
+  auto middleware = std::make_unique<MockMiddlewareHandle>();
+
+  auto ik_service = std::make_unique<KinematicService>(std::move(ik_api), logger, std::move(middleware));
+  ik_service->initialize();
+
+  // WHEN a batch of two IK requests is made through the batch IK service.
+  auto request = std::make_shared<GetInverseKinematicSolutionsBatch::Request>();
+  request->requests.resize(2);
+  auto response = std::make_shared<GetInverseKinematicSolutionsBatch::Response>();
+  ik_service->getBatchSolutions(request, response);
+
+  // THEN the responses are in the order of the requests, and the failed request is reported as such.
+  ASSERT_THAT(response->responses, SizeIs(2));
+  EXPECT_EQ(response->responses[0].status.value,
+            bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_OK);
+  EXPECT_EQ(response->responses[1].status.value,
+            bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_UNKNOWN);
+}
+
+/**
+ * Test that requests which ask for the local solver are solved by it instead of by Spot.
+ */
+TEST(TestKinematicService, getSolutionsFromLocalSolver) {
+  // GIVEN the IK API of Spot and a local solver which succeeds.
+  // THEN only the local solver is queried.
+  auto ik_api = std::make_unique<spot_ros2::test::MockKinematicApi>();
+  EXPECT_CALL(*ik_api, getSolutions(_, _)).Times(0);
+  auto local_api = std::make_unique<spot_ros2::test::MockKinematicApi>();
+  InverseKinematicsResponse fake_response;
+  fake_response.set_status(bosdyn::api::spot::InverseKinematicsResponse_Status_STATUS_OK);
+  EXPECT_CALL(*local_api, getSolutions(_, _)).WillOnce(Return(fake_response));
+
+  auto logger = std::make_shared<spot_ros2::test::MockLoggerInterface>();
+  auto middleware = std::make_unique<MockMiddlewareHandle>();
+  auto ik_service = std::make_unique<KinematicService>(std::move(ik_api), logger, std::move(middleware), nullptr,
+                                                       std::move(local_api));
+
+  // WHEN a request for the local solver is made through the IK service.
+  auto request = std::make_shared<GetInverseKinematicSolutions::Request>();
+  request->solver = GetInverseKinematicSolutions::Request::SOLVER_LOCAL;
+  auto response = std::make_shared<GetInverseKinematicSolutions::Response>();
+  ik_service->getSolutions(request, response);
+
+  // THEN the IK response indicates that the request succeeds.
+  EXPECT_EQ(response->response.status.value, bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_OK);
+}
+
+/**
+ * Test that batches are solved by the local solver if Spot has no IK service, and fail if there is no solver at all.
+ */
+TEST(TestKinematicService, getBatchSolutionsWithoutRobotSolver) {
+  // GIVEN no IK API of Spot and a local solver which succeeds.
+  auto local_api = std::make_unique<spot_ros2::test::MockKinematicApi>();
+  InverseKinematicsResponse fake_response;
+  fake_response.set_status(bosdyn::api::spot::InverseKinematicsResponse_Status_STATUS_OK);
+  std::vector<tl::expected<InverseKinematicsResponse, std::string>> fake_results{fake_response, fake_response};
+  EXPECT_CALL(*local_api, getBatchSolutions(SizeIs(2), _, _)).WillOnce(Return(fake_results));
+
+  auto logger = std::make_shared<spot_ros2::test::MockLoggerInterface>();
+  EXPECT_CALL(*logger, logError(_)).Times(1);
+  auto ik_service = std::make_unique<KinematicService>(nullptr, logger, std::make_unique<MockMiddlewareHandle>(),
+                                                       nullptr, std::move(local_api));
+  auto service_without_solver =
+      std::make_unique<KinematicService>(nullptr, logger, std::make_unique<MockMiddlewareHandle>());
+
+  // WHEN a batch of two IK requests for Spot's solver is made through both services.
+  auto request = std::make_shared<GetInverseKinematicSolutionsBatch::Request>();
+  request->requests.resize(2);
+  request->solver = GetInverseKinematicSolutionsBatch::Request::SOLVER_ROBOT;
+  auto response = std::make_shared<GetInverseKinematicSolutionsBatch::Response>();
+  ik_service->getBatchSolutions(request, response);
+  auto failed_response = std::make_shared<GetInverseKinematicSolutionsBatch::Response>();
+  service_without_solver->getBatchSolutions(request, failed_response);
+
+  // THEN the local solver solves the batch, and the service without a solver fails every request.
+  ASSERT_THAT(response->responses, SizeIs(2));
+  EXPECT_EQ(response->responses[1].status.value,
+            bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_OK);
+  ASSERT_THAT(failed_response->responses, SizeIs(2));
+  EXPECT_EQ(failed_response->responses[1].status.value,
+            bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_UNKNOWN);
+}
+
+/**
+ * Test that repeated IK requests are answered from the cache, without querying the IK API again.
+ */
+TEST(TestKinematicService, getSolutionsFromCache) {
+  auto ik_api = std::make_unique<spot_ros2::test::MockKinematicApi>();
+
+  // GIVEN the IK API succeeds.
+  // THEN it is only queried once for two nearly identical requests.
+  InverseKinematicsResponse fake_response;
+  fake_response.set_status(bosdyn::api::spot::InverseKinematicsResponse_Status_STATUS_OK);
+  tl::expected<InverseKinematicsResponse, std::string> fake_result(fake_response);
+  EXPECT_CALL(*ik_api, getSolutions(_, _)).WillOnce(Return(fake_result));
+
+  auto logger = std::make_shared<spot_ros2::test::MockLoggerInterface>();
+  auto middleware = std::make_unique<MockMiddlewareHandle>();
+  auto cache = std::make_unique<KinematicCache>(10, 0.01, 0.01);
+
+  auto ik_service =
+      std::make_unique<KinematicService>(std::move(ik_api), logger, std::move(middleware), std::move(cache));
+  ik_service->initialize();
+
+  // WHEN two requests whose positions differ by less than the tolerance are made through the IK service.
+  auto request = std::make_shared<GetInverseKinematicSolutions::Request>();
+  request->request.has_field |= bosdyn_spot_api_msgs::msg::InverseKinematicsRequest::ROOT_TFORM_SCENE_FIELD_SET;
+  request->request.root_tform_scene.position.x = 1.0;
+  auto response = std::make_shared<GetInverseKinematicSolutions::Response>();
+  ik_service->getSolutions(request, response);
+  ASSERT_EQ(response->response.status.value, bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_OK);
+
+  request->request.root_tform_scene.position.x = 1.001;
+  response = std::make_shared<GetInverseKinematicSolutions::Response>();
+  ik_service->getSolutions(request, response);
+
+  // THEN the second response is the cached one.
+  ASSERT_EQ(response->response.status.value, bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_OK);
+}
+
+/**
+ * Test that identical requests which arrive while one of them is being sent to Spot share its response.
+ */
+TEST(TestKinematicService, getSolutionsCoalescesIdenticalRequests) {
+  auto ik_api = std::make_unique<spot_ros2::test::MockKinematicApi>();
+
+  // GIVEN the IK API succeeds once it is released.
+  // THEN it is only queried once for two identical requests which are made at the same time.
+  InverseKinematicsResponse fake_response;
+  fake_response.set_status(bosdyn::api::spot::InverseKinematicsResponse_Status_STATUS_OK);
+  std::promise<void> sent;
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  EXPECT_CALL(*ik_api, getSolutions(_, _))
+      .WillOnce(Invoke([&](InverseKinematicsRequest&, std::chrono::duration<double>) {
+        sent.set_value();
+        released.wait();
+        return tl::expected<InverseKinematicsResponse, std::string>{fake_response};
+      }));
+
+  auto logger = std::make_shared<spot_ros2::test::MockLoggerInterface>();
+  auto middleware = std::make_unique<MockMiddlewareHandle>();
+  auto ik_service = std::make_unique<KinematicService>(std::move(ik_api), logger, std::move(middleware));
+  ik_service->initialize();
+
+  // WHEN a second request is made while the first one is still being sent.
+  auto request = std::make_shared<GetInverseKinematicSolutions::Request>();
+  auto first_response = std::make_shared<GetInverseKinematicSolutions::Response>();
+  auto second_response = std::make_shared<GetInverseKinematicSolutions::Response>();
+  auto first = std::async(std::launch::async, [&]() { ik_service->getSolutions(request, first_response); });
+  sent.get_future().wait();
+  auto second = std::async(std::launch::async, [&]() { ik_service->getSolutions(request, second_response); });
+  // Give the second request time to attach to the first one before Spot answers.
+  std::this_thread::sleep_for(std::chrono::milliseconds{100});
+  release.set_value();
+  first.wait();
+  second.wait();
+
+  // THEN both requests get the response of Spot.
+  ASSERT_EQ(first_response->response.status.value,
+            bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_OK);
+  ASSERT_EQ(second_response->response.status.value,
+            bosdyn_spot_api_msgs::msg::InverseKinematicsResponseStatus::STATUS_OK);
+}
+
+/**
+ * Test that the cache tells apart requests beyond the tolerances, and evicts the least recently used response.
+ */
+TEST(TestKinematicCache, findAndEvict) {
+  // GIVEN a cache of two responses.
+  KinematicCache cache{2, 0.01, 0.01};
+  InverseKinematicsResponse ok_response;
+  ok_response.set_status(bosdyn::api::spot::InverseKinematicsResponse_Status_STATUS_OK);
+  InverseKinematicsResponse no_solution_response;
+  no_solution_response.set_status(bosdyn::api::spot::InverseKinematicsResponse_Status_STATUS_NO_SOLUTION_FOUND);
+
+  InverseKinematicsRequest first;
+  first.mutable_root_tform_scene()->mutable_position()->set_x(1.0);
+  InverseKinematicsRequest second;
+  second.mutable_root_tform_scene()->mutable_position()->set_x(2.0);
+  InverseKinematicsRequest third;
+  third.mutable_root_tform_scene()->mutable_rotation()->set_z(0.5);
+
+  // WHEN the responses to two different requests are cached
+  cache.insert(first, ok_response);
+  cache.insert(second, no_solution_response);
+
+  // THEN each request finds its own response, and an unknown request finds none.
+  ASSERT_TRUE(cache.find(second).has_value());
+  EXPECT_EQ(cache.find(second)->status(), no_solution_response.status());
+  ASSERT_TRUE(cache.find(first).has_value());
+  EXPECT_EQ(cache.find(first)->status(), ok_response.status());
+  EXPECT_FALSE(cache.find(third).has_value());
+
+  // WHEN a third response is cached
+  cache.insert(third, ok_response);
+
+  // THEN the least recently used response is evicted.
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_FALSE(cache.find(second).has_value());
+  EXPECT_TRUE(cache.find(first).has_value());
+  EXPECT_TRUE(cache.find(third).has_value());
+}
+
 }  // namespace spot_ros2::kinematic::test
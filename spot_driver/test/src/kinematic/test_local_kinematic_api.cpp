@@ -0,0 +1,214 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <spot_driver/fake/fake_thread_pool.hpp>
+#include <spot_driver/kinematic/forward_kinematics.hpp>
+#include <spot_driver/kinematic/local_kinematic_api.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spot_ros2::kinematic::test {
+namespace {
+using ::spot_ros2::test::FakeThreadPool;
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+
+// The local solver does not send requests to Spot, so it has no use for a timeout.
+constexpr std::chrono::duration<double> kNoTimeout{0.0};
+
+// The arm of Spot with approximate dimensions, and one leg joint which does not move the arm.
+constexpr auto kUrdf = R"(<?xml version="1.0"?>
+<robot name="spot">
+  <link name="body"/>
+  <link name="front_left_hip"/>
+  <link name="arm_link_sh0"/>
+  <link name="arm_link_sh1"/>
+  <link name="arm_link_el0"/>
+  <link name="arm_link_el1"/>
+  <link name="arm_link_wr0"/>
+  <link name="arm_link_wr1"/>
+  <joint name="front_left_hip_x" type="revolute">
+    <parent link="body"/>
+    <child link="front_left_hip"/>
+    <origin xyz="0.29 0.055 0" rpy="0 0 0"/>
+    <axis xyz="1 0 0"/>
+    <limit lower="-0.78" upper="0.78" effort="1" velocity="1"/>
+  </joint>
+  <joint name="arm_sh0" type="revolute">
+    <parent link="body"/>
+    <child link="arm_link_sh0"/>
+    <origin xyz="0.292 0 0.188" rpy="0 0 0"/>
+    <axis xyz="0 0 1"/>
+    <limit lower="-2.6" upper="3.1" effort="1" velocity="1"/>
+  </joint>
+  <joint name="arm_sh1" type="revolute">
+    <parent link="arm_link_sh0"/>
+    <child link="arm_link_sh1"/>
+    <origin xyz="0 0 0" rpy="0 0 0"/>
+    <axis xyz="0 1 0"/>
+    <limit lower="-3.1" upper="0.5" effort="1" velocity="1"/>
+  </joint>
+  <joint name="arm_el0" type="revolute">
+    <parent link="arm_link_sh1"/>
+    <child link="arm_link_el0"/>
+    <origin xyz="0.3385 0 0" rpy="0 0 0"/>
+    <axis xyz="0 1 0"/>
+    <limit lower="0" upper="3.1" effort="1" velocity="1"/>
+  </joint>
+  <joint name="arm_el1" type="revolute">
+    <parent link="arm_link_el0"/>
+    <child link="arm_link_el1"/>
+    <origin xyz="0.4033 0 0.075" rpy="0 0 0"/>
+    <axis xyz="1 0 0"/>
+    <limit lower="-2.8" upper="2.8" effort="1" velocity="1"/>
+  </joint>
+  <joint name="arm_wr0" type="revolute">
+    <parent link="arm_link_el1"/>
+    <child link="arm_link_wr0"/>
+    <origin xyz="0 0 0" rpy="0 0 0"/>
+    <axis xyz="0 1 0"/>
+    <limit lower="-1.8" upper="1.8" effort="1" velocity="1"/>
+  </joint>
+  <joint name="arm_wr1" type="revolute">
+    <parent link="arm_link_wr0"/>
+    <child link="arm_link_wr1"/>
+    <origin xyz="0 0 0" rpy="0 0 0"/>
+    <axis xyz="1 0 0"/>
+    <limit lower="-2.8" upper="2.8" effort="1" velocity="1"/>
+  </joint>
+</robot>)";
+
+/** Compute the pose of the wrist in the body frame for arm joint positions in the order of the arm joints. */
+Eigen::Isometry3d computeWristPose(const ForwardKinematics& kinematics, const std::vector<double>& arm) {
+  const std::vector<std::string> names{"arm_sh0", "arm_sh1", "arm_el0", "arm_el1", "arm_wr0", "arm_wr1"};
+  JointPositions positions = JointPositions::Zero(static_cast<Eigen::Index>(kinematics.getJointNames().size()));
+  for (std::size_t i = 0; i < names.size(); ++i) {
+    positions[static_cast<Eigen::Index>(kinematics.getJointIndex(names[i]).value())] = arm[i];
+  }
+  std::vector<Eigen::Isometry3d> root_tform_links;
+  kinematics.computeLinkPoses(positions, root_tform_links);
+  return root_tform_links[kinematics.getLinkIndex("arm_link_wr1").value()];
+}
+
+/** Create a request to move the wrist to a pose in the body frame, with the wrist as the tool. */
+InverseKinematicsRequest createRequest(const Eigen::Isometry3d& body_tform_wrist) {
+  InverseKinematicsRequest request;
+  request.set_root_frame_name("odom");
+  request.mutable_root_tform_scene()->mutable_rotation()->set_w(1.0);
+  request.mutable_scene_tform_task()->mutable_rotation()->set_w(1.0);
+  request.mutable_wrist_mounted_tool()->mutable_wrist_tform_tool()->mutable_rotation()->set_w(1.0);
+  auto& pose = *request.mutable_tool_pose_task()->mutable_task_tform_desired_tool();
+  const Eigen::Quaterniond rotation{body_tform_wrist.linear()};
+  pose.mutable_position()->set_x(body_tform_wrist.translation().x());
+  pose.mutable_position()->set_y(body_tform_wrist.translation().y());
+  pose.mutable_position()->set_z(body_tform_wrist.translation().z());
+  pose.mutable_rotation()->set_w(rotation.w());
+  pose.mutable_rotation()->set_x(rotation.x());
+  pose.mutable_rotation()->set_y(rotation.y());
+  pose.mutable_rotation()->set_z(rotation.z());
+  return request;
+}
+
+/** Read the arm joint positions of a response. */
+std::vector<double> getArmPositions(const InverseKinematicsResponse& response) {
+  std::vector<double> arm;
+  for (const auto& joint_state : response.robot_configuration().joint_states()) {
+    arm.push_back(joint_state.position().value());
+  }
+  return arm;
+}
+}  // namespace
+
+TEST(LocalKinematicApi, CreateWithoutArmFails) {
+  // GIVEN the kinematics of a robot whose joints have another prefix than the one of the solver
+  auto kinematics = ForwardKinematics::fromUrdf(kUrdf).value();
+
+  // WHEN the solver is created
+  // THEN it fails since the arm joints are not found
+  EXPECT_THAT(LocalKinematicApi::create(kinematics, "Spot/", std::make_shared<FakeThreadPool>()).has_value(),
+              IsFalse());
+  EXPECT_THAT(LocalKinematicApi::create(kinematics, "", std::make_shared<FakeThreadPool>()).has_value(), IsTrue());
+}
+
+TEST(LocalKinematicApi, SolveReachablePose) {
+  // GIVEN the solver and a wrist pose which the arm reaches
+  const auto kinematics = ForwardKinematics::fromUrdf(kUrdf).value();
+  auto solver = LocalKinematicApi::create(kinematics, "", std::make_shared<FakeThreadPool>()).value();
+  const auto body_tform_wrist = computeWristPose(kinematics, {0.3, -1.2, 1.9, 0.2, -0.4, 0.5});
+  auto request = createRequest(body_tform_wrist);
+
+  // WHEN the request is solved
+  const auto response = solver->getSolutions(request, kNoTimeout);
+
+  // THEN the arm joint positions of the solution move the wrist to the pose
+  ASSERT_THAT(response.has_value(), IsTrue());
+  ASSERT_THAT(response->status(), Eq(bosdyn::api::spot::InverseKinematicsResponse::STATUS_OK));
+  ASSERT_THAT(response->robot_configuration().joint_states(), SizeIs(6));
+  EXPECT_THAT(response->robot_configuration().joint_states(0).name(), StrEq("arm0.sh0"));
+  const auto solved = computeWristPose(kinematics, getArmPositions(*response));
+  EXPECT_THAT(solved.translation().isApprox(body_tform_wrist.translation(), 1e-3), IsTrue());
+  EXPECT_THAT(solved.linear().isApprox(body_tform_wrist.linear(), 1e-2), IsTrue());
+  // AND THEN the root frame of the request is in the transforms of the solution
+  EXPECT_THAT(response->robot_configuration().transforms_snapshot().child_to_parent_edge_map().count("odom"), Eq(1U));
+}
+
+TEST(LocalKinematicApi, SolveUnreachablePoseFails) {
+  // GIVEN the solver and a wrist pose far out of reach of the arm
+  const auto kinematics = ForwardKinematics::fromUrdf(kUrdf).value();
+  auto solver = LocalKinematicApi::create(kinematics, "", std::make_shared<FakeThreadPool>()).value();
+  Eigen::Isometry3d body_tform_wrist = Eigen::Isometry3d::Identity();
+  body_tform_wrist.translation() << 5.0, 0.0, 0.0;
+  auto request = createRequest(body_tform_wrist);
+
+  // WHEN the request is solved
+  const auto response = solver->getSolutions(request, kNoTimeout);
+
+  // THEN no solution is found
+  ASSERT_THAT(response.has_value(), IsTrue());
+  EXPECT_THAT(response->status(), Eq(bosdyn::api::spot::InverseKinematicsResponse::STATUS_NO_SOLUTION_FOUND));
+}
+
+TEST(LocalKinematicApi, UnsupportedTaskFails) {
+  // GIVEN the solver and a gaze request
+  auto solver =
+      LocalKinematicApi::create(ForwardKinematics::fromUrdf(kUrdf).value(), "", std::make_shared<FakeThreadPool>())
+          .value();
+  InverseKinematicsRequest request;
+  request.mutable_tool_gaze_task()->mutable_target_in_task()->set_x(1.0);
+
+  // WHEN the request is solved
+  // THEN it fails, since only tool pose tasks are supported
+  EXPECT_THAT(solver->getSolutions(request, kNoTimeout).has_value(), IsFalse());
+}
+
+TEST(LocalKinematicApi, SolveBatch) {
+  // GIVEN the solver with a thread pool and several reachable wrist poses
+  const auto kinematics = ForwardKinematics::fromUrdf(kUrdf).value();
+  const auto thread_pool = std::make_shared<FakeThreadPool>();
+  auto solver = LocalKinematicApi::create(kinematics, "", thread_pool).value();
+  std::vector<InverseKinematicsRequest> requests;
+  for (const auto sh0 : {-0.5, 0.0, 0.5, 1.0}) {
+    requests.push_back(createRequest(computeWristPose(kinematics, {sh0, -1.0, 1.5, 0.0, -0.5, 0.0})));
+  }
+
+  // WHEN the batch is solved on several threads
+  const auto responses = solver->getBatchSolutions(requests, 2, kNoTimeout);
+
+  // THEN the requests are spread over at most two threads of the pool
+  EXPECT_THAT(thread_pool->last_max_workers, Eq(2U));
+  // THEN every request is solved, in the order of the requests
+  ASSERT_THAT(responses, SizeIs(4));
+  for (const auto& response : responses) {
+    ASSERT_THAT(response.has_value(), IsTrue());
+    EXPECT_THAT(response->status(), Eq(bosdyn::api::spot::InverseKinematicsResponse::STATUS_OK));
+  }
+}
+}  // namespace spot_ros2::kinematic::test
@@ -0,0 +1,213 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <spot_driver/metrics/metrics_publisher.hpp>
+#include <spot_driver/metrics/metrics_registry.hpp>
+#include <spot_driver/mock/mock_logger_interface.hpp>
+#include <spot_driver/mock/mock_metrics_middleware_handle.hpp>
+#include <spot_driver/mock/mock_timer_interface.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+using ::testing::_;
+using ::testing::AllOf;
+using ::testing::Contains;
+using ::testing::DoubleEq;
+using ::testing::DoubleNear;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::HasSubstr;
+using ::testing::Not;
+using ::testing::Ref;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+}  // namespace
+
+namespace spot_ros2::metrics::test {
+TEST(MetricsRegistry, ReturnsTheSameMetricForTheSameName) {
+  // GIVEN a registry
+  MetricsRegistry registry;
+
+  // WHEN a counter and a histogram are looked up twice, with other metrics registered in between
+  auto& counter = registry.counter("images.rpc_failures");
+  auto& histogram = registry.histogram("images.rpc_latency");
+  registry.counter("robot_state.rpc_failures");
+  registry.histogram("robot_state.rpc_latency");
+
+  // THEN the same metrics are returned
+  EXPECT_THAT(registry.counter("images.rpc_failures"), Ref(counter));
+  EXPECT_THAT(registry.histogram("images.rpc_latency"), Ref(histogram));
+}
+
+TEST(MetricsRegistry, KeepsTheMetricsOfRobotsApart) {
+  // GIVEN the registries of two robots, looked up by the nodes of each robot
+  const auto first = MetricsRegistry::getForRobot("spot_a");
+  const auto second = MetricsRegistry::getForRobot("spot_b");
+
+  // WHEN they are looked up again, and for an unnamed robot
+  // THEN every robot keeps its own registry, and an unnamed robot uses the default registry
+  EXPECT_THAT(MetricsRegistry::getForRobot("spot_a"), Eq(first));
+  EXPECT_THAT(second, Not(Eq(first)));
+  EXPECT_THAT(first, Not(Eq(MetricsRegistry::getDefault())));
+  EXPECT_THAT(MetricsRegistry::getForRobot(""), Eq(MetricsRegistry::getDefault()));
+}
+
+TEST(MetricsRegistry, CountsIncrementsOfConcurrentThreads) {
+  // GIVEN a counter
+  MetricsRegistry registry;
+  auto& counter = registry.counter("images.rpc_failures");
+
+  // WHEN four threads increment it 1000 times each
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < 4; ++thread) {
+    threads.emplace_back([&counter] {
+      for (int i = 0; i < 1000; ++i) {
+        counter.increment();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // THEN no increment is lost
+  EXPECT_THAT(counter.value(), Eq(4000U));
+}
+
+TEST(Histogram, ReportsBucketEdgesAsPercentiles) {
+  // GIVEN a histogram with 90 durations of 3 ms and 10 durations of 30 ms
+  Histogram histogram;
+  for (int i = 0; i < 90; ++i) {
+    histogram.record(std::chrono::microseconds{3000});
+  }
+  for (int i = 0; i < 10; ++i) {
+    histogram.record(0.03);
+  }
+
+  // WHEN a snapshot is taken
+  const auto snapshot = histogram.snapshot();
+
+  // THEN the percentiles are the upper edges of the buckets which contain them
+  EXPECT_THAT(snapshot.count, Eq(100U));
+  EXPECT_THAT(snapshot.percentile(0.5), DoubleEq(0.005));
+  EXPECT_THAT(snapshot.percentile(0.95), DoubleEq(0.03));
+  EXPECT_THAT(snapshot.mean(), DoubleNear(0.0057, 1e-9));
+  EXPECT_THAT(snapshot.max, DoubleEq(0.03));
+}
+
+TEST(Histogram, ReportsZerosWithoutDurations) {
+  // GIVEN a histogram without durations
+  const Histogram histogram;
+
+  // WHEN a snapshot is taken
+  const auto snapshot = histogram.snapshot();
+
+  // THEN every statistic is zero
+  EXPECT_THAT(snapshot.count, Eq(0U));
+  EXPECT_THAT(snapshot.percentile(0.5), DoubleEq(0.0));
+  EXPECT_THAT(snapshot.mean(), DoubleEq(0.0));
+  EXPECT_THAT(snapshot.max, DoubleEq(0.0));
+}
+
+TEST(MetricsRegistry, CreatesOneDiagnosticStatusPerSelectedGroup) {
+  // GIVEN a registry with metrics in two groups
+  MetricsRegistry registry;
+  registry.counter("images.rpc_failures").increment(3);
+  registry.histogram("images.rpc_latency").record(0.002);
+  registry.counter("robot_state.rpc_failures").increment();
+
+  // WHEN the images group is reported
+  const auto statuses = registry.toDiagnosticStatus("image_publisher: ", {"images"});
+
+  // THEN only the metrics of that group are reported, in one status
+  ASSERT_THAT(statuses, SizeIs(1));
+  EXPECT_THAT(statuses[0].name, StrEq("image_publisher: images"));
+  EXPECT_THAT(statuses[0].values,
+              AllOf(Contains(AllOf(Field(&diagnostic_msgs::msg::KeyValue::key, StrEq("images.rpc_failures")),
+                                   Field(&diagnostic_msgs::msg::KeyValue::value, StrEq("3")))),
+                    Contains(AllOf(Field(&diagnostic_msgs::msg::KeyValue::key, StrEq("images.rpc_latency p95 (ms)")),
+                                   Field(&diagnostic_msgs::msg::KeyValue::value, StrEq("2.000")))),
+                    Not(Contains(Field(&diagnostic_msgs::msg::KeyValue::key, StrEq("robot_state.rpc_failures"))))));
+}
+
+TEST(MetricsRegistry, FormatsThePrometheusTextFormat) {
+  // GIVEN a registry with a counter and a histogram
+  MetricsRegistry registry;
+  registry.counter("images.stale_images_dropped").increment(2);
+  registry.histogram("images.publish_time").record(0.0015);
+  registry.histogram("images.publish_time").record(2.0);
+
+  // WHEN the metrics are formatted with the name of the robot as a label
+  const auto text = registry.toPrometheusText({{"robot", "spot1"}});
+
+  // THEN the counter is exported with its total, and the histogram with cumulative buckets, sum and count
+  EXPECT_THAT(text, HasSubstr("# TYPE spot_driver_images_stale_images_dropped_total counter\n"
+                              "spot_driver_images_stale_images_dropped_total{robot=\"spot1\"} 2\n"));
+  EXPECT_THAT(text, HasSubstr("# TYPE spot_driver_images_publish_time_seconds histogram\n"));
+  EXPECT_THAT(text, HasSubstr("spot_driver_images_publish_time_seconds_bucket{robot=\"spot1\",le=\"0.001\"} 0\n"));
+  EXPECT_THAT(text, HasSubstr("spot_driver_images_publish_time_seconds_bucket{robot=\"spot1\",le=\"0.002\"} 1\n"));
+  EXPECT_THAT(text, HasSubstr("spot_driver_images_publish_time_seconds_bucket{robot=\"spot1\",le=\"1\"} 1\n"));
+  EXPECT_THAT(text, HasSubstr("spot_driver_images_publish_time_seconds_bucket{robot=\"spot1\",le=\"+Inf\"} 2\n"));
+  EXPECT_THAT(text, HasSubstr("spot_driver_images_publish_time_seconds_count{robot=\"spot1\"} 2\n"));
+}
+
+TEST(MetricsPublisher, PublishesTheDiagnosticsOfItsGroupsOnEveryTick) {
+  // GIVEN a registry with metrics in two groups
+  const auto registry = std::make_shared<MetricsRegistry>();
+  registry->counter("images.rpc_failures").increment();
+  registry->counter("robot_state.rpc_failures").increment();
+
+  // GIVEN a timer and a middleware handle
+  auto timer = std::make_unique<spot_ros2::test::MockTimerInterface>();
+  auto* timer_ptr = timer.get();
+  EXPECT_CALL(*timer, setTimer(_, _)).WillOnce([timer_ptr](const auto&, const auto& callback) {
+    timer_ptr->onSetTimer(callback);
+  });
+  auto middleware_handle = std::make_unique<spot_ros2::test::MockMetricsMiddlewareHandle>();
+  EXPECT_CALL(*middleware_handle,
+              publishDiagnostics(Field(&diagnostic_msgs::msg::DiagnosticArray::status,
+                                       ElementsAre(Field(&diagnostic_msgs::msg::DiagnosticStatus::name,
+                                                         StrEq("state_publisher: robot_state"))))))
+      .Times(2);
+
+  // GIVEN a metrics publisher for the robot state group
+  const MetricsPublisher publisher{registry,
+                                   {"robot_state"},
+                                   "state_publisher: ",
+                                   MetricsPublisher::Options{},
+                                   std::move(middleware_handle),
+                                   std::make_unique<spot_ros2::test::MockLoggerInterface>(),
+                                   std::move(timer)};
+
+  // WHEN the timer fires twice
+  // THEN the robot state group is published each time
+  timer_ptr->trigger();
+  timer_ptr->trigger();
+}
+
+TEST(MetricsPublisher, DoesNotStartTheTimerIfThePeriodIsZero) {
+  // GIVEN a timer
+  auto timer = std::make_unique<spot_ros2::test::MockTimerInterface>();
+
+  // THEN the timer is never started
+  EXPECT_CALL(*timer, setTimer(_, _)).Times(0);
+
+  // WHEN a metrics publisher is created with a period of zero
+  MetricsPublisher::Options options;
+  options.period = std::chrono::duration<double>{0.0};
+  const MetricsPublisher publisher{std::make_shared<MetricsRegistry>(),
+                                   {"images"},
+                                   "image_publisher: ",
+                                   options,
+                                   std::make_unique<spot_ros2::test::MockMetricsMiddlewareHandle>(),
+                                   std::make_unique<spot_ros2::test::MockLoggerInterface>(),
+                                   std::move(timer)};
+}
+}  // namespace spot_ros2::metrics::test
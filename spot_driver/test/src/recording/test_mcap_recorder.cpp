@@ -0,0 +1,91 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <rosbag2_cpp/reader.hpp>
+#include <rosbag2_storage/storage_options.hpp>
+#include <sensor_msgs/msg/compressed_image.hpp>
+#include <spot_driver/metrics/metrics_registry.hpp>
+#include <spot_driver/recording/mcap_recorder.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spot_ros2::recording::test {
+using ::testing::ElementsAre;
+using ::testing::Eq;
+
+class McapRecorderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const auto* test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+    storage_options.uri = (std::filesystem::temp_directory_path() /
+                           ("spot_driver_" + std::string{test_info->name()} + "_" +
+                            std::to_string(std::chrono::steady_clock::now().time_since_epoch().count())))
+                              .string();
+    storage_options.storage_id = "mcap";
+    storage_options.storage_preset_profile = "zstd_fast";
+  }
+
+  void TearDown() override { std::filesystem::remove_all(storage_options.uri); }
+
+  std::unique_ptr<rosbag2_cpp::Writer> openWriter() {
+    auto writer = std::make_unique<rosbag2_cpp::Writer>();
+    writer->open(storage_options);
+    return writer;
+  }
+
+  static RecordedMessage makeImageMessage(const std::string& topic, const std::int32_t stamp) {
+    sensor_msgs::msg::CompressedImage image;
+    image.header.stamp.sec = stamp;
+    image.format = "jpeg";
+    image.data = {0xff, 0xd8, 0xff, 0xd9};
+    return RecordedMessage{topic, "sensor_msgs/msg/CompressedImage", rclcpp::Time{stamp, 0},
+                           [image](rclcpp::SerializedMessage& serialized) {
+                             rclcpp::Serialization<sensor_msgs::msg::CompressedImage> serialization;
+                             serialization.serialize_message(&image, &serialized);
+                           }};
+  }
+
+  rosbag2_storage::StorageOptions storage_options;
+  std::shared_ptr<metrics::MetricsRegistry> metrics = std::make_shared<metrics::MetricsRegistry>();
+};
+
+TEST_F(McapRecorderTest, WritesEveryQueuedMessageToTheBag) {
+  // GIVEN a recorder which writes to an MCAP bag
+  auto recorder = std::make_unique<McapRecorder>(openWriter(), 100, metrics);
+
+  // WHEN two compressed images are recorded, and the recorder is destroyed
+  recorder->write(makeImageMessage("/Opal/camera/frontleft/compressed", 1));
+  recorder->write(makeImageMessage("/Opal/camera/back/compressed", 2));
+  recorder.reset();
+
+  // THEN both images are in the bag, in the order in which they were recorded
+  rosbag2_cpp::Reader reader;
+  reader.open(storage_options);
+  std::vector<std::string> topics;
+  while (reader.has_next()) {
+    topics.push_back(reader.read_next()->topic_name);
+  }
+  EXPECT_THAT(topics, ElementsAre("/Opal/camera/frontleft/compressed", "/Opal/camera/back/compressed"));
+  EXPECT_THAT(metrics->counter("recording.written_messages").value(), Eq(2U));
+  EXPECT_THAT(metrics->counter("recording.dropped_messages").value(), Eq(0U));
+}
+
+TEST_F(McapRecorderTest, DropsMessagesWhenTheQueueIsFull) {
+  // GIVEN a recorder which cannot queue any message
+  auto recorder = std::make_unique<McapRecorder>(openWriter(), 0, metrics);
+
+  // WHEN an image is recorded
+  recorder->write(makeImageMessage("/Opal/camera/hand/compressed", 1));
+  recorder.reset();
+
+  // THEN it is dropped
+  EXPECT_THAT(metrics->counter("recording.written_messages").value(), Eq(0U));
+  EXPECT_THAT(metrics->counter("recording.dropped_messages").value(), Eq(1U));
+}
+}  // namespace spot_ros2::recording::test
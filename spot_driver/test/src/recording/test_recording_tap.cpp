@@ -0,0 +1,77 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <geometry_msgs/msg/vector3_stamped.hpp>
+#include <spot_driver/recording/recording_tap.hpp>
+
+#include <memory>
+
+namespace spot_ros2::recording::test {
+using ::testing::_;
+using ::testing::AllOf;
+using ::testing::Field;
+using ::testing::Gt;
+using ::testing::StrEq;
+
+class MockRecordingSink : public RecordingSink {
+ public:
+  MOCK_METHOD(void, write, (RecordedMessage message), (override));
+};
+
+TEST(RecordingTap, IsInactiveWithoutSink) {
+  // GIVEN a tap without a sink
+  RecordingTap tap;
+
+  // THEN it is inactive, and recording a message does nothing
+  EXPECT_FALSE(tap.isActive());
+  tap.record("/Opal/status/end_effector_force", geometry_msgs::msg::Vector3Stamped{}, rclcpp::Time{1, 0});
+}
+
+TEST(RecordingTap, HandsMessagesToTheAttachedSink) {
+  // GIVEN a tap with a sink
+  RecordingTap tap;
+  auto sink = std::make_shared<MockRecordingSink>();
+  tap.attach(sink);
+  EXPECT_TRUE(tap.isActive());
+
+  // THEN the sink receives the topic, type and log time of a recorded message, and can serialize it
+  EXPECT_CALL(*sink, write(AllOf(Field(&RecordedMessage::topic, StrEq("/Opal/status/end_effector_force")),
+                                 Field(&RecordedMessage::type_name, StrEq("geometry_msgs/msg/Vector3Stamped")),
+                                 Field(&RecordedMessage::log_time, rclcpp::Time{2, 0}))))
+      .WillOnce([](const RecordedMessage& message) {
+        rclcpp::SerializedMessage serialized;
+        message.serialize(serialized);
+        EXPECT_THAT(serialized.size(), Gt(0U));
+      });
+
+  // WHEN a message is recorded
+  geometry_msgs::msg::Vector3Stamped force;
+  force.vector.z = 1.0;
+  tap.record("/Opal/status/end_effector_force", force, rclcpp::Time{2, 0});
+}
+
+TEST(RecordingTap, OnlyDetachesTheAttachedSink) {
+  // GIVEN a tap with a sink, which replaced another sink
+  RecordingTap tap;
+  auto replaced_sink = std::make_shared<MockRecordingSink>();
+  auto sink = std::make_shared<MockRecordingSink>();
+  tap.attach(replaced_sink);
+  tap.attach(sink);
+
+  // WHEN the replaced sink is detached
+  tap.detach(replaced_sink.get());
+
+  // THEN the tap is still active
+  EXPECT_TRUE(tap.isActive());
+
+  // WHEN the attached sink is detached
+  tap.detach(sink.get());
+
+  // THEN the tap is inactive, and neither sink receives messages
+  EXPECT_FALSE(tap.isActive());
+  EXPECT_CALL(*replaced_sink, write(_)).Times(0);
+  EXPECT_CALL(*sink, write(_)).Times(0);
+  tap.record("/Opal/status/end_effector_force", geometry_msgs::msg::Vector3Stamped{}, rclcpp::Time{3, 0});
+}
+}  // namespace spot_ros2::recording::test
@@ -0,0 +1,128 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <bosdyn/api/robot_state.pb.h>
+#include <gmock/gmock.h>
+#include <google/protobuf/duration.pb.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <cmath>
+#include <cstdint>
+#include <spot_driver/conversions/robot_state.hpp>
+#include <spot_driver/robot_state/robot_state_history.hpp>
+#include <spot_driver/robot_state_test_tools.hpp>
+
+namespace {
+using ::testing::DoubleNear;
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::Pointee;
+using ::testing::StrEq;
+
+constexpr double kTolerance = 1e-9;
+
+/** @brief Create a snapshot at a time, with the body at x = position and yawed by yaw, and one joint at position. */
+spot_ros2::RobotStateSnapshot createSnapshot(const std::int64_t stamp_ns, const double position, const double yaw) {
+  spot_ros2::RobotStateSnapshot snapshot;
+  snapshot.stamp_ns = stamp_ns;
+  snapshot.odom_tform_body.position.x = position;
+  snapshot.odom_tform_body.orientation.w = std::cos(yaw / 2.0);
+  snapshot.odom_tform_body.orientation.z = std::sin(yaw / 2.0);
+  snapshot.vision_tform_body = snapshot.odom_tform_body;
+  snapshot.body_velocity_in_odom.linear.x = position;
+  snapshot.joint_count = 1;
+  snapshot.joint_names[0] = &spot_ros2::kFriendlyJointNames.at("fl.hx");
+  snapshot.joint_positions[0] = position;
+  return snapshot;
+}
+}  // namespace
+
+namespace spot_ros2::test {
+
+TEST(RobotStateHistory, EmptyHistoryHasNoState) {
+  // GIVEN a history without snapshots
+  const RobotStateHistory history{4};
+
+  // THEN there is neither a latest snapshot nor a snapshot at any time
+  EXPECT_THAT(history.latest().has_value(), IsFalse());
+  EXPECT_THAT(history.lookup(0).has_value(), IsFalse());
+}
+
+TEST(RobotStateHistory, LookupInterpolatesBetweenSnapshots) {
+  // GIVEN a history with two snapshots one second apart, during which the body moves one meter and turns by 90 degrees
+  RobotStateHistory history{4};
+  history.add(createSnapshot(1000000000, 0.0, 0.0));
+  history.add(createSnapshot(2000000000, 1.0, M_PI_2));
+
+  // WHEN the robot state is looked up a quarter of the way between the snapshots
+  const auto snapshot = history.lookup(1250000000);
+
+  // THEN the positions, velocities and joints are interpolated linearly, and the orientation spherically
+  ASSERT_THAT(snapshot.has_value(), IsTrue());
+  EXPECT_THAT(snapshot->stamp_ns, Eq(1250000000));
+  EXPECT_THAT(snapshot->odom_tform_body.position.x, DoubleNear(0.25, kTolerance));
+  EXPECT_THAT(snapshot->odom_tform_body.orientation.w, DoubleNear(std::cos(M_PI_2 / 8.0), kTolerance));
+  EXPECT_THAT(snapshot->odom_tform_body.orientation.z, DoubleNear(std::sin(M_PI_2 / 8.0), kTolerance));
+  EXPECT_THAT(snapshot->vision_tform_body.position.x, DoubleNear(0.25, kTolerance));
+  EXPECT_THAT(snapshot->body_velocity_in_odom.linear.x, DoubleNear(0.25, kTolerance));
+  EXPECT_THAT(snapshot->joint_count, Eq(1U));
+  EXPECT_THAT(snapshot->joint_names[0], Pointee(StrEq("front_left_hip_x")));
+  EXPECT_THAT(snapshot->joint_positions[0], DoubleNear(0.25, kTolerance));
+
+  // THEN a lookup at the time of a snapshot returns it unchanged
+  EXPECT_THAT(history.lookup(2000000000)->odom_tform_body.position.x, Eq(1.0));
+}
+
+TEST(RobotStateHistory, LookupOutsideHistoryFails) {
+  // GIVEN a history of two snapshots which was filled with three
+  RobotStateHistory history{2};
+  history.add(createSnapshot(1000000000, 0.0, 0.0));
+  history.add(createSnapshot(2000000000, 1.0, 0.0));
+  history.add(createSnapshot(3000000000, 2.0, 0.0));
+
+  // THEN the latest snapshot is the last one that was added
+  EXPECT_THAT(history.latest()->stamp_ns, Eq(3000000000));
+
+  // THEN times between the oldest and the latest remaining snapshot can be looked up
+  EXPECT_THAT(history.lookup(2500000000).has_value(), IsTrue());
+
+  // THEN the robot state is neither extrapolated into the past of the oldest snapshot, which was overwritten, nor
+  // into the future
+  EXPECT_THAT(history.lookup(1500000000).has_value(), IsFalse());
+  EXPECT_THAT(history.lookup(3000000001).has_value(), IsFalse());
+}
+
+TEST(RobotStateHistory, SnapshotIsCreatedFromRobotState) {
+  // GIVEN some nominal clock skew
+  google::protobuf::Duration clock_skew;
+  clock_skew.set_seconds(1);
+
+  // GIVEN a robot state with the body at a nonzero pose relative to the odom and vision frames, a body velocity and a
+  // joint state
+  ::bosdyn::api::RobotState robot_state;
+  google::protobuf::Timestamp timestamp;
+  timestamp.set_seconds(99);
+  addAcquisitionTimestamp(robot_state.mutable_kinematic_state(), timestamp);
+  auto* snapshot = robot_state.mutable_kinematic_state()->mutable_transforms_snapshot();
+  addRootFrame(snapshot, "odom");
+  addTransform(snapshot, "body", "odom", 1.0, 2.0, 3.0, 1.0, 0.0, 0.0, 0.0);
+  addTransform(snapshot, "vision", "odom", 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+  addBodyVelocityOdom(robot_state.mutable_kinematic_state(), 1.0, 2.0, 3.0, 4.0, 5.0, 6.0);
+  setJointState(robot_state.mutable_kinematic_state()->add_joint_states(), "fl.hx", 0.1, 0.2, 0.3, 0.4);
+
+  // WHEN a snapshot is created from the robot state
+  const auto out = makeRobotStateSnapshot(robot_state, clock_skew);
+
+  // THEN it is stamped in the clock of the host, and contains the body poses, body velocity and joint state
+  ASSERT_THAT(out.has_value(), IsTrue());
+  EXPECT_THAT(out->stamp_ns, Eq(98000000000));
+  EXPECT_THAT(out->odom_tform_body.position.y, Eq(2.0));
+  EXPECT_THAT(out->vision_tform_body.position.z, Eq(3.0));
+  EXPECT_THAT(out->body_velocity_in_odom.angular.z, Eq(6.0));
+  ASSERT_THAT(out->joint_count, Eq(1U));
+  EXPECT_THAT(out->joint_names[0], Pointee(StrEq("front_left_hip_x")));
+  EXPECT_THAT(out->joint_positions[0], Eq(0.1));
+  EXPECT_THAT(out->joint_velocities[0], Eq(0.2));
+  EXPECT_THAT(out->joint_efforts[0], Eq(0.4));
+}
+
+}  // namespace spot_ros2::test
@@ -6,6 +6,9 @@
 #include <google/protobuf/duration.pb.h>
 #include <google/protobuf/timestamp.pb.h>
 #include <geometry_msgs/msg/transform_stamped.hpp>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <memory>
 #include <spot_driver/fake/fake_parameter_interface.hpp>
 #include <spot_driver/mock/mock_logger_interface.hpp>
@@ -25,9 +28,13 @@
 namespace {
 using ::testing::_;
 using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Field;
 using ::testing::HasSubstr;
 using ::testing::InSequence;
 using ::testing::Invoke;
+using ::testing::Not;
+using ::testing::Optional;
 using ::testing::Property;
 using ::testing::Return;
 using ::testing::Unused;
@@ -105,10 +112,44 @@ TEST_F(StatePublisherTest, PublishCallbackTriggers) {
     // AND THEN we request the robot state from the Spot interface
     EXPECT_CALL(*mock_state_client_interface, getRobotState)
         .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{makeRobotState(true)}));
+    // AND THEN the robot transforms are published to TF
+    EXPECT_CALL(*mock_tf_broadcaster_interface, sendDynamicTransforms).Times(1);
     // AND THEN we publish the robot state to the appropriate topics
     EXPECT_CALL(*mock_middleware_handle, publishRobotState).Times(1);
-    // AND THEN the robot transforms are published to TF
+  }
+
+  // GIVEN a robot_state_publisher
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface));
+
+  // WHEN the timer callback is triggered
+  timer_interface_ptr->trigger();
+}
+
+TEST_F(StatePublisherTest, TfAndOdometryArePublishedFirst) {
+  auto* timer_interface_ptr = mock_timer_interface.get();
+  EXPECT_CALL(*timer_interface_ptr, setTimer).WillOnce([&](Unused, const std::function<void()>& cb) {
+    timer_interface_ptr->onSetTimer(cb);
+  });
+
+  // GIVEN the robot state contains transforms and the velocity of the body in odom
+  auto robot_state = makeRobotState(true);
+  addBodyVelocityOdom(robot_state.mutable_kinematic_state(), 1.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew).WillRepeatedly(Return(google::protobuf::Duration()));
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{robot_state}));
+
+  {
+    InSequence seq;
+    // THEN the transforms are published to TF first
     EXPECT_CALL(*mock_tf_broadcaster_interface, sendDynamicTransforms).Times(1);
+    // AND THEN the odometry twist is published
+    EXPECT_CALL(*mock_middleware_handle, publishOdometry(Field(&RobotStateMessages::maybe_odom_twist, Optional(_))))
+        .Times(1);
+    // AND THEN the remaining robot state topics are published
+    EXPECT_CALL(*mock_middleware_handle, publishRobotState).Times(1);
   }
 
   // GIVEN a robot_state_publisher
@@ -221,4 +262,233 @@ TEST_F(StatePublisherTest, PublishCallbackTriggersFailGetClockSkew) {
   // WHEN the timer callback is triggered
   timer_interface_ptr->trigger();
 }
+TEST_F(StatePublisherTest, StreamRobotStateDropsRepeatedStates) {
+  // GIVEN the robot state is streamed instead of requested on a timer
+  fake_parameter_interface->stream_robot_state = true;
+
+  // THEN the timer is not used
+  EXPECT_CALL(*mock_timer_interface, setTimer).Times(0);
+
+  // GIVEN Spot returns the same state twice, and then a newer state every time
+  const auto first_state = makeRobotState(true);
+  auto second_state = makeRobotState(true);
+  second_state.mutable_kinematic_state()->mutable_acquisition_timestamp()->set_seconds(101);
+  std::promise<void> streamed;
+  std::atomic<bool> streamed_set{false};
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew).WillRepeatedly(Return(google::protobuf::Duration()));
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{first_state}))
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{first_state}))
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{second_state}))
+      .WillRepeatedly([&]() {
+        if (!streamed_set.exchange(true)) {
+          streamed.set_value();
+        }
+        return tl::expected<bosdyn::api::RobotState, std::string>{second_state};
+      });
+
+  // THEN the requests are made back to back, and each state is published only once
+  EXPECT_CALL(*mock_middleware_handle, publishRobotState).Times(2);
+  EXPECT_CALL(*mock_tf_broadcaster_interface, sendDynamicTransforms).Times(2);
+
+  // WHEN a robot_state_publisher is constructed, and runs until it has streamed all states
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface));
+  ASSERT_THAT(streamed.get_future().wait_for(std::chrono::seconds{5}), Eq(std::future_status::ready));
+  robot_state_publisher.reset();
+}
+TEST_F(StatePublisherTest, SlowTopicsAreDecimated) {
+  // GIVEN the battery states are published at 1 Hz, and all other topics with every robot state
+  fake_parameter_interface->robot_state_publish_rates["battery_states"] = 1.0;
+
+  auto* timer_interface_ptr = mock_timer_interface.get();
+  EXPECT_CALL(*timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    timer_interface_ptr->onSetTimer(cb);
+  });
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew).WillRepeatedly(Return(google::protobuf::Duration()));
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .WillRepeatedly(Return(tl::expected<bosdyn::api::RobotState, std::string>{makeRobotState(true)}));
+  EXPECT_CALL(*mock_tf_broadcaster_interface, sendDynamicTransforms).Times(2);
+
+  // THEN the battery states are only converted and published with the first robot state, while the WiFi state is
+  // published with both
+  {
+    InSequence seq;
+    EXPECT_CALL(*mock_middleware_handle,
+                publishRobotState(AllOf(Field(&RobotStateMessages::maybe_battery_states, Optional(_)),
+                                        Field(&RobotStateMessages::maybe_wifi_state, Optional(_)))))
+        .Times(1);
+    EXPECT_CALL(*mock_middleware_handle,
+                publishRobotState(AllOf(Field(&RobotStateMessages::maybe_battery_states, Not(Optional(_))),
+                                        Field(&RobotStateMessages::maybe_wifi_state, Optional(_)))))
+        .Times(1);
+  }
+
+  // GIVEN a robot_state_publisher
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface));
+
+  // WHEN the timer callback is triggered twice within a second
+  timer_interface_ptr->trigger();
+  timer_interface_ptr->trigger();
+}
+
+TEST_F(StatePublisherTest, UnchangedStatusIsSuppressed) {
+  // GIVEN status topics are published on change, with a heartbeat that does not elapse during the test
+  fake_parameter_interface->publish_status_on_change = true;
+  fake_parameter_interface->status_heartbeat_period = 60.0;
+
+  // GIVEN a battery state, the same battery state with a newer timestamp, and a battery state with a new charge
+  auto first_state = makeRobotState(true);
+  auto* battery_state = first_state.add_battery_states();
+  battery_state->mutable_charge_percentage()->set_value(50.0);
+  battery_state->mutable_timestamp()->set_seconds(100);
+  auto restamped_state = first_state;
+  restamped_state.mutable_battery_states(0)->mutable_timestamp()->set_seconds(101);
+  auto charged_state = restamped_state;
+  charged_state.mutable_battery_states(0)->mutable_charge_percentage()->set_value(51.0);
+
+  auto* timer_interface_ptr = mock_timer_interface.get();
+  EXPECT_CALL(*timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    timer_interface_ptr->onSetTimer(cb);
+  });
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew).WillRepeatedly(Return(google::protobuf::Duration()));
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{first_state}))
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{restamped_state}))
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{charged_state}));
+  EXPECT_CALL(*mock_tf_broadcaster_interface, sendDynamicTransforms).Times(3);
+
+  // THEN the battery states are only published with the first state and once the charge changed, the unchanged WiFi
+  // state only with the first state, and the joint states with every state
+  {
+    InSequence seq;
+    EXPECT_CALL(*mock_middleware_handle,
+                publishRobotState(AllOf(Field(&RobotStateMessages::maybe_battery_states, Optional(_)),
+                                        Field(&RobotStateMessages::maybe_wifi_state, Optional(_)),
+                                        Field(&RobotStateMessages::maybe_joint_states, Optional(_)))))
+        .Times(1);
+    EXPECT_CALL(*mock_middleware_handle,
+                publishRobotState(AllOf(Field(&RobotStateMessages::maybe_battery_states, Not(Optional(_))),
+                                        Field(&RobotStateMessages::maybe_wifi_state, Not(Optional(_))),
+                                        Field(&RobotStateMessages::maybe_joint_states, Optional(_)))))
+        .Times(1);
+    EXPECT_CALL(*mock_middleware_handle,
+                publishRobotState(AllOf(Field(&RobotStateMessages::maybe_battery_states, Optional(_)),
+                                        Field(&RobotStateMessages::maybe_wifi_state, Not(Optional(_))),
+                                        Field(&RobotStateMessages::maybe_joint_states, Optional(_)))))
+        .Times(1);
+  }
+
+  // GIVEN a robot_state_publisher
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface));
+
+  // WHEN the timer callback is triggered for each state
+  timer_interface_ptr->trigger();
+  timer_interface_ptr->trigger();
+  timer_interface_ptr->trigger();
+}
+
+TEST_F(StatePublisherTest, TopicsWithoutSubscribersAreSkipped) {
+  // GIVEN the joint states and the WiFi state have no subscribers, while every other topic has
+  EXPECT_CALL(*mock_middleware_handle, hasSubscribers(_)).WillRepeatedly(Return(true));
+  EXPECT_CALL(*mock_middleware_handle, hasSubscribers(StatePublisher::Topic::kJointStates))
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(*mock_middleware_handle, hasSubscribers(StatePublisher::Topic::kWifi)).WillRepeatedly(Return(false));
+
+  auto* timer_interface_ptr = mock_timer_interface.get();
+  EXPECT_CALL(*timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    timer_interface_ptr->onSetTimer(cb);
+  });
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew).WillOnce(Return(google::protobuf::Duration()));
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{makeRobotState(true)}));
+
+  // THEN the joint states and the WiFi state are not converted, while the feet are, and TF is still broadcast
+  EXPECT_CALL(*mock_middleware_handle,
+              publishRobotState(AllOf(Field(&RobotStateMessages::maybe_joint_states, Not(Optional(_))),
+                                      Field(&RobotStateMessages::maybe_wifi_state, Not(Optional(_))),
+                                      Field(&RobotStateMessages::maybe_foot_state, Optional(_)))))
+      .Times(1);
+  EXPECT_CALL(*mock_tf_broadcaster_interface, sendDynamicTransforms).Times(1);
+
+  // GIVEN a robot_state_publisher
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface));
+
+  // WHEN the timer callback is triggered
+  timer_interface_ptr->trigger();
+}
+
+TEST_F(StatePublisherTest, RawOnlySkipsConversions) {
+  // GIVEN only the serialized robot state is published
+  fake_parameter_interface->publish_raw_protobuf = true;
+  fake_parameter_interface->raw_protobuf_only = true;
+
+  auto* timer_interface_ptr = mock_timer_interface.get();
+  EXPECT_CALL(*timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    timer_interface_ptr->onSetTimer(cb);
+  });
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew).WillOnce(Return(google::protobuf::Duration()));
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{makeRobotState(true)}));
+
+  // THEN the robot state is published on the raw topic, and is neither converted nor broadcast to TF
+  EXPECT_CALL(*mock_middleware_handle, publishRawRobotState).Times(1);
+  EXPECT_CALL(*mock_middleware_handle, publishRobotState).Times(0);
+  EXPECT_CALL(*mock_tf_broadcaster_interface, sendDynamicTransforms).Times(0);
+
+  // GIVEN a robot_state_publisher
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface));
+
+  // WHEN the timer callback is triggered
+  timer_interface_ptr->trigger();
+}
+
+TEST_F(StatePublisherTest, LowLevelJointStatesReplacePolledJointStates) {
+  // GIVEN the low-level joint states are relayed
+  fake_parameter_interface->low_level_joint_states = true;
+  StatePublisher::MiddlewareHandle::JointStatesCallback joint_states_callback;
+  EXPECT_CALL(*mock_middleware_handle, subscribeToLowLevelJointStates).WillOnce([&](const auto& callback) {
+    joint_states_callback = callback;
+  });
+
+  auto* timer_interface_ptr = mock_timer_interface.get();
+  EXPECT_CALL(*timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    timer_interface_ptr->onSetTimer(cb);
+  });
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew).WillOnce(Return(google::protobuf::Duration()));
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{makeRobotState(true)}));
+
+  // THEN the low-level joint states are published as they arrive, and the joint states of the robot state are not
+  // converted, while the other topics are
+  EXPECT_CALL(*mock_middleware_handle, publishJointStates).Times(1);
+  EXPECT_CALL(*mock_middleware_handle,
+              publishRobotState(AllOf(Field(&RobotStateMessages::maybe_joint_states, Not(Optional(_))),
+                                      Field(&RobotStateMessages::maybe_foot_state, Optional(_)))))
+      .Times(1);
+
+  // GIVEN a robot_state_publisher
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface));
+
+  // WHEN low-level joint states arrive, and then the timer callback is triggered
+  joint_states_callback(sensor_msgs::msg::JointState{});
+  timer_interface_ptr->trigger();
+}
 }  // namespace spot_ros2::test
@@ -64,7 +64,7 @@ TEST_F(StatePublisherNodeTest, ConstructionSuccessful) {
   }
 
   // THEN we access the Spot API's client interface
-  EXPECT_CALL(*mock_spot_api, stateClientInterface).Times(1);
+  EXPECT_CALL(*mock_spot_api, stateClientInterface).Times(1).WillOnce(Return(std::make_shared<MockStateClient>()));
   EXPECT_CALL(*mock_spot_api, timeSyncInterface).Times(1);
 
   // THEN no error messages are logged
@@ -3,8 +3,13 @@
 #include <gmock/gmock.h>
 #include <google/protobuf/timestamp.pb.h>
 #include <builtin_interfaces/msg/time.hpp>
+#include <spot_driver/api/clock_skew_filter.hpp>
 #include <spot_driver/conversions/time.hpp>
 
+#include <cstdint>
+#include <optional>
+#include <vector>
+
 namespace {
 using Time = builtin_interfaces::msg::Time;
 }
@@ -261,4 +266,103 @@ TEST(TestClockSkewRobotToLocal, ZeroSkew) {
 //   EXPECT_THAT(out.nanos(), testing::Eq(0u));
 // }
 
+TEST(TestClockSkewNanoseconds, CarryBetweenSecondsAndNanoseconds) {
+  // GIVEN a timestamp and a clock skew whose nanoseconds are larger than those of the timestamp
+  google::protobuf::Timestamp timestamp;
+  timestamp.set_seconds(1000);
+  timestamp.set_nanos(100'000'000);
+  google::protobuf::Duration clock_skew;
+  clock_skew.set_seconds(0);
+  clock_skew.set_nanos(200'000'000);
+
+  // WHEN we apply the clock skew to the timestamp
+  const auto out = robotTimeToLocalTime(timestamp, clock_skew);
+
+  // THEN a second is carried over into the nanoseconds field, like with the nanosecond fast path
+  EXPECT_THAT(out.sec, testing::Eq(999));
+  EXPECT_THAT(out.nanosec, testing::Eq(900'000'000u));
+  EXPECT_THAT(toNanoseconds(out),
+              testing::Eq(robotTimeToLocalTime(toNanoseconds(timestamp), toNanoseconds(clock_skew))));
+}
+
+TEST(TestClockSkewNanoseconds, BatchConversions) {
+  // GIVEN timestamps in nanoseconds, one of which is earlier than the clock skew
+  const std::vector<std::int64_t> timestamps{0, 500, 1'000'000'000'000, 999'999'999'999'999'999};
+  constexpr std::int64_t clock_skew = 1'000;
+
+  // WHEN we convert them from robot to local time and back in batches
+  std::vector<std::int64_t> local(timestamps.size());
+  robotTimesToLocalTimes(timestamps.data(), timestamps.size(), clock_skew, local.data());
+  std::vector<std::int64_t> robot(local.size());
+  localTimesToRobotTimes(local.data(), local.size(), clock_skew, robot.data());
+
+  // THEN every timestamp is converted like a single one, and times before the epoch are clamped to zero
+  EXPECT_THAT(local, testing::ElementsAre(0, 0, 999'999'999'000, 999'999'999'999'998'999));
+  EXPECT_THAT(robot, testing::ElementsAre(1'000, 1'000, 1'000'000'000'000, 999'999'999'999'999'999));
+}
+
+TEST(TestClockSkewFilter, PredictsFirstMeasurement) {
+  // GIVEN a clock skew filter
+  ClockSkewFilter filter;
+
+  // WHEN no clock skew was measured yet
+  // THEN there is no prediction
+  EXPECT_THAT(filter.predict(0), testing::Eq(std::nullopt));
+
+  // WHEN a clock skew is measured
+  filter.update(1'000'000'000, 5'000'000);
+
+  // THEN the measurement is predicted at any time
+  EXPECT_THAT(filter.predict(1'000'000'000), testing::Optional(5'000'000));
+  EXPECT_THAT(filter.predict(9'000'000'000), testing::Optional(5'000'000));
+}
+
+TEST(TestClockSkewFilter, SmoothsSmallSteps) {
+  // GIVEN a clock skew filter with a measurement
+  ClockSkewFilter filter;
+  filter.update(1'000'000'000, 5'000'000);
+
+  // WHEN a slightly different clock skew is measured later
+  filter.update(11'000'000'000, 6'000'000);
+
+  // THEN the prediction moves towards the new measurement without jumping to it
+  const auto predicted = filter.predict(11'000'000'000);
+  ASSERT_TRUE(predicted.has_value());
+  EXPECT_THAT(*predicted, testing::Gt(5'000'000));
+  EXPECT_THAT(*predicted, testing::Lt(6'000'000));
+
+  // WHEN the same clock skew is measured again
+  filter.update(12'000'000'000, 6'000'000);
+
+  // THEN the repeated measurement does not change the model
+  EXPECT_THAT(filter.predict(11'000'000'000), testing::Optional(*predicted));
+}
+
+TEST(TestClockSkewFilter, LearnsDrift) {
+  // GIVEN a clock skew filter
+  ClockSkewFilter filter;
+
+  // WHEN the measured clock skew drifts by 10 microseconds per second for a few minutes
+  constexpr std::int64_t kPeriod = 1'000'000'000;
+  constexpr std::int64_t kDrift = 10'000;
+  for (std::int64_t i = 0; i < 300; ++i) {
+    filter.update(i * kPeriod, i * kDrift);
+  }
+
+  // THEN the clock skew is predicted between measurements
+  EXPECT_THAT(*filter.predict(300 * kPeriod), testing::AllOf(testing::Gt(299 * kDrift), testing::Lt(301 * kDrift)));
+}
+
+TEST(TestClockSkewFilter, ResetsOnLargeSteps) {
+  // GIVEN a clock skew filter with a measurement
+  ClockSkewFilter filter;
+  filter.update(1'000'000'000, 5'000'000);
+
+  // WHEN a clock skew which is much larger is measured
+  filter.update(2'000'000'000, 3'600'000'000'000);
+
+  // THEN the new measurement is predicted
+  EXPECT_THAT(filter.predict(2'000'000'000), testing::Optional(3'600'000'000'000));
+}
+
 }  // namespace spot_ros2::test
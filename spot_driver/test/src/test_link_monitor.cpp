@@ -0,0 +1,119 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <spot_driver/api/link_monitor.hpp>
+#include <spot_driver/fake/fake_parameter_interface.hpp>
+
+#include <chrono>
+#include <cstddef>
+
+using ::testing::DoubleEq;
+using ::testing::Eq;
+
+namespace spot_ros2::test {
+namespace {
+/** @brief Link monitor whose time only moves when the test advances it. */
+class ManualClockLinkMonitor : public LinkMonitor {
+ public:
+  void advance(const std::chrono::steady_clock::duration duration) { time_ += duration; }
+
+ protected:
+  std::chrono::steady_clock::time_point now() const override { return time_; }
+
+ private:
+  std::chrono::steady_clock::time_point time_;
+};
+
+constexpr auto kFastRequest = std::chrono::milliseconds{20};
+constexpr auto kSlowRequest = std::chrono::milliseconds{800};
+
+void recordRequests(LinkMonitor& monitor, const std::size_t count, const std::chrono::steady_clock::duration latency,
+                    const bool success) {
+  for (std::size_t request = 0; request < count; ++request) {
+    monitor.record(latency, success);
+  }
+}
+}  // namespace
+
+TEST(LinkMonitor, GoodLinkStaysGood) {
+  // GIVEN a link monitor
+  ManualClockLinkMonitor monitor;
+
+  // WHEN fast requests succeed
+  recordRequests(monitor, 10, kFastRequest, true);
+
+  // THEN the link is good
+  EXPECT_THAT(monitor.quality(), Eq(LinkQuality::kGood));
+  EXPECT_THAT(monitor.statistics().requests, Eq(10U));
+  EXPECT_THAT(monitor.statistics().failureRate(), DoubleEq(0.0));
+}
+
+TEST(LinkMonitor, DegradeOnFailuresAndSlowRequests) {
+  // GIVEN two link monitors
+  ManualClockLinkMonitor failing;
+  ManualClockLinkMonitor slow;
+
+  // WHEN a third of the requests fail on one of them, and the requests are slow on the other
+  recordRequests(failing, 4, kFastRequest, true);
+  recordRequests(failing, 2, kFastRequest, false);
+  recordRequests(slow, 6, kSlowRequest, true);
+
+  // THEN both links are degraded
+  EXPECT_THAT(failing.quality(), Eq(LinkQuality::kDegraded));
+  EXPECT_THAT(slow.quality(), Eq(LinkQuality::kDegraded));
+}
+
+TEST(LinkMonitor, DoNotJudgeTooFewRequests) {
+  // GIVEN a link monitor
+  ManualClockLinkMonitor monitor;
+
+  // WHEN fewer requests than the minimum all fail
+  recordRequests(monitor, LinkMonitorOptions{}.min_requests - 1, kFastRequest, false);
+
+  // THEN the link is still good
+  EXPECT_THAT(monitor.quality(), Eq(LinkQuality::kGood));
+}
+
+TEST(LinkMonitor, RecoverAfterRecoveryPeriod) {
+  // GIVEN a degraded link
+  ManualClockLinkMonitor monitor;
+  recordRequests(monitor, 10, kFastRequest, false);
+  ASSERT_THAT(monitor.quality(), Eq(LinkQuality::kDegraded));
+
+  // WHEN the failures leave the window and fast requests succeed again
+  const LinkMonitorOptions options;
+  monitor.advance(options.window + std::chrono::seconds{1});
+  recordRequests(monitor, 10, kFastRequest, true);
+
+  // THEN the link stays degraded until it looked good for the recovery period
+  EXPECT_THAT(monitor.quality(), Eq(LinkQuality::kDegraded));
+  monitor.advance(options.recovery_period / 2);
+  recordRequests(monitor, 10, kFastRequest, true);
+  EXPECT_THAT(monitor.quality(), Eq(LinkQuality::kDegraded));
+  monitor.advance(options.recovery_period / 2);
+  recordRequests(monitor, 10, kFastRequest, true);
+  EXPECT_THAT(monitor.quality(), Eq(LinkQuality::kGood));
+}
+
+TEST(LinkMonitor, ConfigureThresholdsFromParameters) {
+  // GIVEN parameters which ignore the latency of the requests
+  FakeParameterInterface parameters;
+  parameters.link_degraded_latency = 0.0;
+  ManualClockLinkMonitor monitor;
+  monitor.configure(makeLinkMonitorOptions(parameters));
+
+  // WHEN slow requests succeed
+  recordRequests(monitor, 10, kSlowRequest, true);
+
+  // THEN the link is good
+  EXPECT_THAT(monitor.quality(), Eq(LinkQuality::kGood));
+}
+
+TEST(LinkMonitor, ShareMonitorPerRobot) {
+  // WHEN we get the monitors of two robots twice
+  // THEN each robot has its own monitor
+  EXPECT_THAT(LinkMonitor::getForRobot("spot1"), Eq(LinkMonitor::getForRobot("spot1")));
+  EXPECT_NE(LinkMonitor::getForRobot("spot1"), LinkMonitor::getForRobot("spot2"));
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,124 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <spot_driver/mock/mock_logger_interface.hpp>
+
+#include <chrono>
+
+using ::testing::_;
+using ::testing::InSequence;
+using ::testing::StrEq;
+
+namespace spot_ros2::test {
+namespace {
+/** @brief Mock logger whose time only moves when the test advances it. */
+class ManualClockLogger : public MockLoggerInterface {
+ public:
+  void advance(const std::chrono::steady_clock::duration duration) { time_ += duration; }
+
+ protected:
+  std::chrono::steady_clock::time_point now() const override { return time_; }
+
+ private:
+  std::chrono::steady_clock::time_point time_;
+};
+
+constexpr auto kPeriod = std::chrono::seconds{1};
+}  // namespace
+
+TEST(LoggerInterface, LogForwardsToTheLevel) {
+  // GIVEN a logger
+  MockLoggerInterface logger;
+
+  // THEN every level is forwarded to its log method
+  EXPECT_CALL(logger, logDebug(StrEq("debug"))).Times(1);
+  EXPECT_CALL(logger, logInfo(StrEq("info"))).Times(1);
+  EXPECT_CALL(logger, logWarn(StrEq("warn"))).Times(1);
+  EXPECT_CALL(logger, logError(StrEq("error"))).Times(1);
+  EXPECT_CALL(logger, logFatal(StrEq("fatal"))).Times(1);
+
+  // WHEN we log a message at every level
+  logger.log(LogLevel::kDebug, "debug");
+  logger.log(LogLevel::kInfo, "info");
+  logger.log(LogLevel::kWarn, "warn");
+  logger.log(LogLevel::kError, "error");
+  logger.log(LogLevel::kFatal, "fatal");
+}
+
+TEST(LoggerInterface, LogThrottledCountsSuppressedMessages) {
+  // GIVEN a logger
+  ManualClockLogger logger;
+
+  // THEN the first message is logged, the messages within the period are dropped, and the next message after the
+  // period states how many were dropped
+  {
+    InSequence seq;
+    EXPECT_CALL(logger, logError(StrEq("failed"))).Times(1);
+    EXPECT_CALL(logger, logError(StrEq("failed (2 similar messages suppressed)"))).Times(1);
+  }
+
+  // WHEN we log the same key four times, with the period passing before the last time
+  logger.logThrottled(LogLevel::kError, "key", kPeriod, "failed");
+  logger.advance(kPeriod / 2);
+  logger.logThrottled(LogLevel::kError, "key", kPeriod, "failed");
+  logger.logThrottled(LogLevel::kError, "key", kPeriod, "failed");
+  logger.advance(kPeriod);
+  logger.logThrottled(LogLevel::kError, "key", kPeriod, "failed");
+}
+
+TEST(LoggerInterface, LogThrottledKeepsKeysApart) {
+  // GIVEN a logger
+  ManualClockLogger logger;
+
+  // THEN messages of different keys do not throttle each other
+  EXPECT_CALL(logger, logWarn(StrEq("first"))).Times(1);
+  EXPECT_CALL(logger, logWarn(StrEq("second"))).Times(1);
+
+  // WHEN we log two keys within the period
+  logger.logThrottled(LogLevel::kWarn, "first", kPeriod, "first");
+  logger.logThrottled(LogLevel::kWarn, "second", kPeriod, "second");
+}
+
+TEST(LoggerInterface, LogOnceUntilReset) {
+  // GIVEN a logger
+  MockLoggerInterface logger;
+
+  // THEN the message is only logged once, and again after the key was reset, which reports the dropped messages
+  {
+    InSequence seq;
+    EXPECT_CALL(logger, logError(StrEq("failed"))).Times(1);
+    EXPECT_CALL(logger, logInfo(StrEq("2 similar messages were suppressed before the condition cleared."))).Times(1);
+    EXPECT_CALL(logger, logError(StrEq("failed"))).Times(1);
+  }
+
+  // WHEN we log the message three times, reset the key, and log it again
+  logger.logOnce(LogLevel::kError, "key", "failed");
+  logger.logOnce(LogLevel::kError, "key", "failed");
+  logger.logOnce(LogLevel::kError, "key", "failed");
+  logger.resetLog("key");
+  logger.logOnce(LogLevel::kError, "key", "failed");
+}
+
+TEST(LoggerInterface, LogDeduplicatedReportsRepeats) {
+  // GIVEN a logger
+  MockLoggerInterface logger;
+
+  // THEN repeats of a message are dropped, and counted when a different message is logged
+  {
+    InSequence seq;
+    EXPECT_CALL(logger, logWarn(StrEq("first"))).Times(1);
+    EXPECT_CALL(logger, logWarn(StrEq("The previous message was repeated 2 more times."))).Times(1);
+    EXPECT_CALL(logger, logWarn(StrEq("second"))).Times(1);
+    EXPECT_CALL(logger, logWarn(StrEq("first"))).Times(1);
+  }
+  EXPECT_CALL(logger, logInfo(_)).Times(0);
+
+  // WHEN we log a message three times, then a different message, and then the first message again
+  logger.logDeduplicated(LogLevel::kWarn, "key", "first");
+  logger.logDeduplicated(LogLevel::kWarn, "key", "first");
+  logger.logDeduplicated(LogLevel::kWarn, "key", "first");
+  logger.logDeduplicated(LogLevel::kWarn, "key", "second");
+  logger.logDeduplicated(LogLevel::kWarn, "key", "first");
+}
+}  // namespace spot_ros2::test
@@ -33,11 +33,13 @@
 #include <tf2_msgs/msg/tf_message.hpp>
 #include <tl_expected/expected.hpp>
 #include <utility>
+#include <vector>
 
 namespace {
 using ::testing::_;
 using ::testing::AllOf;
 using ::testing::Contains;
+using ::testing::DoubleNear;
 using ::testing::Eq;
 using ::testing::ExplainMatchResult;
 using ::testing::Field;
@@ -66,6 +68,14 @@ MATCHER(ListObjectRequestIsForDrawableObjects, "") {
                    ::bosdyn::api::WorldObjectType::WORLD_OBJECT_DRAWABLE) != arg.object_type().end();
 }
 
+MATCHER(ListObjectRequestHasNoTimestampFilter, "") {
+  return !arg.has_timestamp_filter();
+}
+
+MATCHER_P(ListObjectRequestTimestampFilterSecondsIs, seconds, "") {
+  return arg.has_timestamp_filter() && arg.timestamp_filter().seconds() == seconds;
+}
+
 MATCHER(MutationChangesObject, "") {
   return testing::ExplainMatchResult(
       testing::Eq(arg.mutation().action()),
@@ -242,7 +252,7 @@ TEST_F(ObjectSynchronizerTest, AddFrameAsWorldObject) {
   EXPECT_CALL(*mock_world_object_client,
               mutateWorldObject(AllOf(MutationAddsObject(), MutationTargetsObjectWhoseNameIs(kExternalFrameId),
                                       MutationFrameTreeSnapshotIsValid(),
-                                      MutationTransformChildAndParentFramesAre("odom", kExternalFrameId))))
+                                      MutationTransformChildAndParentFramesAre("odom", kExternalFrameId)), _))
       .WillOnce(
           Return(tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>{kMutateObjectResponseSuccess}));
 
@@ -262,6 +272,96 @@ TEST_F(ObjectSynchronizerTest, AddFrameAsWorldObject) {
   EXPECT_THAT(object_synchronizer->getManagedFrames(), AllOf(SizeIs(1), Contains(kExternalFrameId)));
 }
 
+TEST_F(ObjectSynchronizerTest, SyncUsesCachedWorldObjects) {
+  // GIVEN the timer interface's setTimer function registers the internal callback function
+  registerTimerCallbacks();
+
+  // GIVEN the two syncs happen within the lifetime of the cached world objects, but far enough apart that the
+  // unchanged frame is sent again to keep its object alive
+  EXPECT_CALL(*mock_clock_interface_ptr, now)
+      .WillOnce(Return(rclcpp::Time{0, 0, RCL_ROS_TIME}))
+      .WillOnce(Return(rclcpp::Time{4, 0, RCL_ROS_TIME}));
+
+  // GIVEN the TF listener has info about one frame from a non-Spot source, and always returns identity transforms
+  ON_CALL(*mock_tf_listener_interface_ptr, getAllFrameNames)
+      .WillByDefault(Return(std::vector<std::string>{kExternalFrameId}));
+  ON_CALL(*mock_tf_listener_interface_ptr, lookupTransform)
+      .WillByDefault(Return(
+          tl::expected<geometry_msgs::msg::TransformStamped, std::string>{geometry_msgs::msg::TransformStamped{}}));
+
+  // GIVEN Spot's list of world objects includes a dock acquired at 5 seconds
+  ::bosdyn::api::ListWorldObjectResponse list_immutable_objects_response;
+  auto* object_dock = list_immutable_objects_response.add_world_objects();
+  *object_dock->mutable_name() = "dock";
+  object_dock->mutable_acquisition_time()->set_seconds(5);
+
+  // THEN the first sync lists all world objects, and the second sync only lists the non-mutable objects updated after
+  // the dock
+  {
+    InSequence seq;
+    EXPECT_CALL(*mock_world_object_client, listWorldObjects(ListObjectRequestHasNoTimestampFilter(), _))
+        .WillOnce(Return(list_immutable_objects_response))
+        .WillOnce(Return(::bosdyn::api::ListWorldObjectResponse{}));
+    EXPECT_CALL(*mock_world_object_client,
+                listWorldObjects(AllOf(Not(ListObjectRequestIsForDrawableObjects()),
+                                       ListObjectRequestTimestampFilterSecondsIs(5)), _))
+        .WillOnce(Return(::bosdyn::api::ListWorldObjectResponse{}));
+    EXPECT_CALL(*mock_world_object_client, listWorldObjects(ListObjectRequestIsForDrawableObjects(), _))
+        .WillOnce(Return(::bosdyn::api::ListWorldObjectResponse{}));
+  }
+
+  // THEN the first sync adds an object for the external frame, and the second sync modifies the object that was added
+  auto add_object_response = kMutateObjectResponseSuccess;
+  add_object_response.set_mutated_object_id(7);
+  {
+    InSequence seq;
+    EXPECT_CALL(*mock_world_object_client, mutateWorldObject(MutationAddsObject(), _))
+        .WillOnce(Return(tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>{add_object_response}));
+    EXPECT_CALL(*mock_world_object_client,
+                mutateWorldObject(AllOf(MutationChangesObject(), MutationTargetsObjectWhoseIdIs(7)), _))
+        .WillOnce(Return(tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>{add_object_response}));
+  }
+
+  // GIVEN the ObjectSynchronizer has been created
+  // Note: for this test, this must only be called after registering all expected calls with the mocks
+  createObjectSynchronizer();
+
+  // WHEN the timer callback is triggered twice
+  mock_world_object_update_timer_ptr->trigger();
+  mock_world_object_update_timer_ptr->trigger();
+}
+
+TEST_F(ObjectSynchronizerTest, SkipUnchangedFrames) {
+  // GIVEN the timer interface's setTimer function registers the internal callback function
+  registerTimerCallbacks();
+
+  ON_CALL(*mock_clock_interface_ptr, now).WillByDefault(Return(rclcpp::Time{0, 0, RCL_ROS_TIME}));
+
+  // GIVEN the TF listener has info about one frame from a non-Spot source, and always returns identity transforms
+  ON_CALL(*mock_tf_listener_interface_ptr, getAllFrameNames)
+      .WillByDefault(Return(std::vector<std::string>{kExternalFrameId}));
+  ON_CALL(*mock_tf_listener_interface_ptr, lookupTransform)
+      .WillByDefault(Return(
+          tl::expected<geometry_msgs::msg::TransformStamped, std::string>{geometry_msgs::msg::TransformStamped{}}));
+
+  // GIVEN requesting info about world objects always succeeds
+  ON_CALL(*mock_world_object_client, listWorldObjects).WillByDefault(Return(::bosdyn::api::ListWorldObjectResponse{}));
+
+  // THEN the frame is only sent to Spot by the first sync, since its transform does not change
+  auto add_object_response = kMutateObjectResponseSuccess;
+  add_object_response.set_mutated_object_id(7);
+  EXPECT_CALL(*mock_world_object_client, mutateWorldObject(MutationAddsObject(), _))
+      .WillOnce(Return(tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>{add_object_response}));
+
+  // GIVEN the ObjectSynchronizer has been created
+  // Note: for this test, this must only be called after registering all expected calls with the mocks
+  createObjectSynchronizer();
+
+  // WHEN the timer callback is triggered twice
+  mock_world_object_update_timer_ptr->trigger();
+  mock_world_object_update_timer_ptr->trigger();
+}
+
 TEST_F(ObjectSynchronizerTest, ModifyFrameForExistingWorldObject) {
   // GIVEN the timer interface's setTimer function registers the internal callback function to sync the world objects
   registerTimerCallbacks();
@@ -305,7 +405,7 @@ TEST_F(ObjectSynchronizerTest, ModifyFrameForExistingWorldObject) {
   EXPECT_CALL(*mock_world_object_client,
               mutateWorldObject(AllOf(MutationChangesObject(), MutationTargetsObjectWhoseNameIs(kExternalFrameId),
                                       MutationTargetsObjectWhoseIdIs(kObjectId), MutationFrameTreeSnapshotIsValid(),
-                                      MutationTransformChildAndParentFramesAre("odom", kExternalFrameId))))
+                                      MutationTransformChildAndParentFramesAre("odom", kExternalFrameId)), _))
       .WillOnce(
           Return(tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>{kMutateObjectResponseSuccess}));
 
@@ -378,7 +478,7 @@ TEST_F(ObjectSynchronizerTest, ListImmutableObjectsError) {
           tl::expected<geometry_msgs::msg::TransformStamped, std::string>{geometry_msgs::msg::TransformStamped{}}));
 
   // GIVEN requesting info about immutable world objects will fail
-  EXPECT_CALL(*mock_world_object_client, listWorldObjects(Not(ListObjectRequestIsForDrawableObjects())))
+  EXPECT_CALL(*mock_world_object_client, listWorldObjects(Not(ListObjectRequestIsForDrawableObjects()), _))
       .WillOnce(Return(tl::make_unexpected(kErrorMessage)));
 
   // THEN no request is made to mutate objects
@@ -421,9 +521,9 @@ TEST_F(ObjectSynchronizerTest, ListMutableObjectsError) {
   {
     testing::InSequence seq;
     ::bosdyn::api::ListWorldObjectResponse list_objects_response;
-    EXPECT_CALL(*mock_world_object_client, listWorldObjects(Not(ListObjectRequestIsForDrawableObjects())))
+    EXPECT_CALL(*mock_world_object_client, listWorldObjects(Not(ListObjectRequestIsForDrawableObjects()), _))
         .WillOnce(Return(list_objects_response));
-    EXPECT_CALL(*mock_world_object_client, listWorldObjects(ListObjectRequestIsForDrawableObjects()))
+    EXPECT_CALL(*mock_world_object_client, listWorldObjects(ListObjectRequestIsForDrawableObjects(), _))
         .WillOnce(Return(tl::make_unexpected(kErrorMessage)));
   }
 
@@ -529,4 +629,142 @@ TEST_F(ObjectSynchronizerTest, PublishWorldObjectTransforms) {
   // WHEN the timer callback to broadcast TF data is triggered
   mock_tf_broadcaster_timer_ptr->trigger();
 }
+
+TEST_F(ObjectSynchronizerTest, PublishTransformsOfAllWorldObjectsTogether) {
+  // GIVEN the callback to broadcast TF data has been registered with the appropriate timer
+  registerTimerCallbacks();
+
+  // GIVEN Spot's WorldObject API will report two objects which are not managed by the ObjectSynchronizer
+  ::bosdyn::api::ListWorldObjectResponse list_objects_response;
+  auto* object_dock = list_objects_response.add_world_objects();
+  *object_dock->mutable_name() = "dock";
+  object_dock->set_id(99);
+  object_dock->mutable_dock_properties()->set_dock_id(100);
+  addRootFrame(object_dock->mutable_transforms_snapshot(), "odom");
+  addTransform(object_dock->mutable_transforms_snapshot(), "dock", "odom", 1.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+
+  auto* object_fiducial = list_objects_response.add_world_objects();
+  *object_fiducial->mutable_name() = "fiducial_5";
+  object_fiducial->set_id(100);
+  addRootFrame(object_fiducial->mutable_transforms_snapshot(), "odom");
+  addTransform(object_fiducial->mutable_transforms_snapshot(), "fiducial_5", "odom", 2.0, 0.0, 0.0, 1.0, 0.0, 0.0,
+               0.0);
+  EXPECT_CALL(*mock_world_object_client, listWorldObjects).WillOnce(Return(list_objects_response));
+
+  // THEN the transforms of both objects are broadcast in a single message
+  EXPECT_CALL(*mock_tf_broadcaster_interface_ptr,
+              sendDynamicTransforms(AllOf(
+                  SizeIs(2),
+                  Contains(Field("child_frame_id", &geometry_msgs::msg::TransformStamped::child_frame_id,
+                                 StrEq("MyRobot/dock"))),
+                  Contains(Field("child_frame_id", &geometry_msgs::msg::TransformStamped::child_frame_id,
+                                 StrEq("MyRobot/fiducial_5"))))))
+      .Times(1);
+
+  // GIVEN the ObjectSynchronizer has been created
+  createObjectSynchronizer();
+
+  // WHEN the timer callback to broadcast TF data is triggered
+  mock_tf_broadcaster_timer_ptr->trigger();
+}
+
+TEST_F(ObjectSynchronizerTest, ListOnlyUpdatedWorldObjects) {
+  // GIVEN the callback to broadcast TF data has been registered with the appropriate timer
+  registerTimerCallbacks();
+
+  // GIVEN Spot's WorldObject API will report one object which was acquired at 5 seconds
+  ::bosdyn::api::ListWorldObjectResponse list_objects_response;
+  auto* object_dock = list_objects_response.add_world_objects();
+  *object_dock->mutable_name() = "dock";
+  object_dock->set_id(99);
+  object_dock->mutable_dock_properties()->set_dock_id(100);
+  object_dock->mutable_acquisition_time()->set_seconds(5);
+  addRootFrame(object_dock->mutable_transforms_snapshot(), "odom");
+  addTransform(object_dock->mutable_transforms_snapshot(), "dock", "odom", 1.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+
+  // THEN all world objects are requested first, and then only the objects updated after the listed one
+  {
+    InSequence seq;
+    EXPECT_CALL(*mock_world_object_client, listWorldObjects(ListObjectRequestHasNoTimestampFilter(), _))
+        .WillOnce(Return(list_objects_response));
+    EXPECT_CALL(*mock_world_object_client, listWorldObjects(ListObjectRequestTimestampFilterSecondsIs(5), _))
+        .WillOnce(Return(::bosdyn::api::ListWorldObjectResponse{}));
+  }
+
+  // THEN the transform of the object is only broadcast after the first request
+  EXPECT_CALL(*mock_tf_broadcaster_interface_ptr, sendDynamicTransforms).Times(1);
+
+  // GIVEN the ObjectSynchronizer has been created
+  createObjectSynchronizer();
+
+  // WHEN the timer callback to broadcast TF data is triggered twice
+  mock_tf_broadcaster_timer_ptr->trigger();
+  mock_tf_broadcaster_timer_ptr->trigger();
+}
+
+TEST_F(ObjectSynchronizerTest, PublishInterpolatedWorldObjectTransformsAtHigherRate) {
+  // GIVEN the callback to broadcast TF data has been registered with the appropriate timer
+  registerTimerCallbacks();
+
+  // GIVEN world object TF is published at 50 Hz, so the objects are listed on every fifth broadcast
+  fake_parameter_interface->object_sync_world_object_tf_rate = 50.0;
+
+  // GIVEN Spot's WorldObject API will first report the dock at 1 m, and then at 2 m with a later acquisition time
+  const auto make_response = [](const double x, const int64_t seconds) {
+    ::bosdyn::api::ListWorldObjectResponse response;
+    auto* object_dock = response.add_world_objects();
+    *object_dock->mutable_name() = "dock";
+    object_dock->set_id(99);
+    object_dock->mutable_dock_properties()->set_dock_id(100);
+    object_dock->mutable_acquisition_time()->set_seconds(seconds);
+    addRootFrame(object_dock->mutable_transforms_snapshot(), "odom");
+    addTransform(object_dock->mutable_transforms_snapshot(), "dock", "odom", x, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+    return response;
+  };
+  EXPECT_CALL(*mock_world_object_client, listWorldObjects)
+      .WillOnce(Return(make_response(1.0, 5)))
+      .WillOnce(Return(make_response(2.0, 6)));
+
+  // GIVEN the clock is controlled by the test
+  rclcpp::Time now{1, 0, RCL_ROS_TIME};
+  ON_CALL(*mock_clock_interface_ptr, now).WillByDefault([&]() { return now; });
+
+  // THEN the TF broadcaster timer runs at 50 Hz
+  EXPECT_CALL(*mock_tf_broadcaster_timer_ptr, setTimer(std::chrono::duration<double>{0.02}, _));
+
+  // THEN every broadcast publishes the transform of the dock, stamped with the current time
+  std::vector<geometry_msgs::msg::TransformStamped> sent_transforms;
+  EXPECT_CALL(*mock_tf_broadcaster_interface_ptr, sendDynamicTransforms)
+      .Times(7)
+      .WillRepeatedly([&](const std::vector<geometry_msgs::msg::TransformStamped>& transforms) {
+        ASSERT_THAT(transforms, SizeIs(1));
+        sent_transforms.push_back(transforms.front());
+      });
+
+  // GIVEN the ObjectSynchronizer has been created
+  createObjectSynchronizer();
+
+  // WHEN the timer callback to broadcast TF data is triggered five times within one list period, and then twice more
+  // 0.1 s and 0.15 s after the first list
+  for (int i = 0; i < 5; ++i) {
+    now = rclcpp::Time{1, static_cast<uint32_t>(i) * 20000000U, RCL_ROS_TIME};
+    mock_tf_broadcaster_timer_ptr->trigger();
+  }
+  now = rclcpp::Time{1, 100000000U, RCL_ROS_TIME};
+  mock_tf_broadcaster_timer_ptr->trigger();
+  now = rclcpp::Time{1, 150000000U, RCL_ROS_TIME};
+  mock_tf_broadcaster_timer_ptr->trigger();
+
+  // THEN the dock stays at its first pose until the second list, and then blends towards its new pose
+  ASSERT_THAT(sent_transforms, SizeIs(7));
+  for (const auto& transform : sent_transforms) {
+    EXPECT_THAT(transform.child_frame_id, StrEq("MyRobot/dock"));
+    EXPECT_THAT(transform.header.frame_id, StrEq("MyRobot/odom"));
+  }
+  EXPECT_THAT(rclcpp::Time{sent_transforms.at(3).header.stamp, RCL_ROS_TIME}.nanoseconds(), Eq(1060000000));
+  EXPECT_THAT(sent_transforms.at(4).transform.translation.x, DoubleNear(1.0, 1e-6));
+  EXPECT_THAT(sent_transforms.at(5).transform.translation.x, DoubleNear(1.0, 1e-6));
+  EXPECT_THAT(sent_transforms.at(6).transform.translation.x, DoubleNear(1.5, 1e-6));
+  EXPECT_THAT(rclcpp::Time{sent_transforms.at(6).header.stamp, RCL_ROS_TIME}.nanoseconds(), Eq(1150000000));
+}
 }  // namespace spot_ros2::test
@@ -196,8 +196,156 @@ TEST_F(RclcppParameterInterfaceEnvVarTest, GetSpotConfigFromParameters) {
   node_->declare_parameter("publish_depth", publish_depth_images_parameter);
   constexpr auto publish_depth_registered_images_parameter = false;
   node_->declare_parameter("publish_depth_registered", publish_depth_registered_images_parameter);
+  constexpr auto image_decode_threads_parameter = 4;
+  node_->declare_parameter("image_decode_threads", image_decode_threads_parameter);
+  constexpr auto jpeg_decoder_parameter = "turbojpeg";
+  node_->declare_parameter("jpeg_decoder", jpeg_decoder_parameter);
+  constexpr auto rle_depth_images_parameter = true;
+  node_->declare_parameter("rle_depth_images", rle_depth_images_parameter);
+  constexpr auto hand_image_rate_parameter = 30.0;
+  node_->declare_parameter("image_rate.hand", hand_image_rate_parameter);
+  constexpr auto image_requests_in_flight_parameter = 3;
+  node_->declare_parameter("image_requests_in_flight", image_requests_in_flight_parameter);
+  constexpr auto on_demand_images_parameter = true;
+  node_->declare_parameter("on_demand_images", on_demand_images_parameter);
+  constexpr auto static_transforms_refresh_period_parameter = 10.0;
+  node_->declare_parameter("static_transforms_refresh_period", static_transforms_refresh_period_parameter);
+  constexpr auto image_preview_scale_parameter = 4;
+  node_->declare_parameter("image_preview_scale", image_preview_scale_parameter);
+  const std::vector<int64_t> image_preview_roi_parameter = {10, 20, 320, 240};
+  node_->declare_parameter("image_preview_roi", image_preview_roi_parameter);
+  constexpr auto publish_depth_point_clouds_parameter = true;
+  node_->declare_parameter("publish_depth_point_clouds", publish_depth_point_clouds_parameter);
+  constexpr auto point_cloud_voxel_size_parameter = 0.05;
+  node_->declare_parameter("point_cloud_voxel_size", point_cloud_voxel_size_parameter);
+  constexpr auto publish_compressed_depth_parameter = true;
+  node_->declare_parameter("publish_compressed_depth", publish_compressed_depth_parameter);
+  constexpr auto compressed_depth_format_parameter = "rvl";
+  node_->declare_parameter("compressed_depth_format", compressed_depth_format_parameter);
+  constexpr auto publish_filtered_depth_parameter = true;
+  node_->declare_parameter("publish_filtered_depth", publish_filtered_depth_parameter);
+  constexpr auto filtered_depth_decimation_parameter = 4;
+  node_->declare_parameter("filtered_depth_decimation", filtered_depth_decimation_parameter);
+  constexpr auto filtered_depth_fill_holes_parameter = false;
+  node_->declare_parameter("filtered_depth_fill_holes", filtered_depth_fill_holes_parameter);
+  constexpr auto filtered_depth_min_range_parameter = 0.3;
+  node_->declare_parameter("filtered_depth_min_range", filtered_depth_min_range_parameter);
+  constexpr auto filtered_depth_max_range_parameter = 5.0;
+  node_->declare_parameter("filtered_depth_max_range", filtered_depth_max_range_parameter);
+  constexpr auto publish_laser_scan_parameter = true;
+  node_->declare_parameter("publish_laser_scan", publish_laser_scan_parameter);
+  constexpr auto laser_scan_min_height_parameter = -0.4;
+  node_->declare_parameter("laser_scan_min_height", laser_scan_min_height_parameter);
+  constexpr auto laser_scan_max_height_parameter = 0.2;
+  node_->declare_parameter("laser_scan_max_height", laser_scan_max_height_parameter);
+  constexpr auto laser_scan_range_max_parameter = 6.0;
+  node_->declare_parameter("laser_scan_range_max", laser_scan_range_max_parameter);
+  constexpr auto laser_scan_angle_increment_parameter = 0.01;
+  node_->declare_parameter("laser_scan_angle_increment", laser_scan_angle_increment_parameter);
+  constexpr auto publish_stitched_front_image_parameter = true;
+  node_->declare_parameter("publish_stitched_front_image", publish_stitched_front_image_parameter);
+  constexpr auto virtual_camera_frame_parameter = "front_virtual";
+  node_->declare_parameter("virtual_camera_frame", virtual_camera_frame_parameter);
+  const std::vector<double> virtual_camera_intrinsics_parameter{385.0, 0.0, 315.0, 0.0, 385.0, 844.0, 0.0, 0.0, 1.0};
+  node_->declare_parameter("virtual_camera_intrinsics", virtual_camera_intrinsics_parameter);
+  const std::vector<double> virtual_camera_projection_plane_parameter{-0.15916, 0.0, 0.987253};
+  node_->declare_parameter("virtual_camera_projection_plane", virtual_camera_projection_plane_parameter);
+  constexpr auto virtual_camera_plane_distance_parameter = 0.5;
+  node_->declare_parameter("virtual_camera_plane_distance", virtual_camera_plane_distance_parameter);
+  constexpr auto stitched_image_row_padding_parameter = 1182;
+  node_->declare_parameter("stitched_image_row_padding", stitched_image_row_padding_parameter);
+  constexpr auto stitched_image_seam_update_period_parameter = 30;
+  node_->declare_parameter("stitched_image_seam_update_period", stitched_image_seam_update_period_parameter);
+  constexpr auto stitched_image_blend_mode_parameter = "feather";
+  node_->declare_parameter("stitched_image_blend_mode", stitched_image_blend_mode_parameter);
+  constexpr auto stitched_image_blend_width_parameter = 20;
+  node_->declare_parameter("stitched_image_blend_width", stitched_image_blend_width_parameter);
+  constexpr auto stitched_image_use_gpu_parameter = false;
+  node_->declare_parameter("stitched_image_use_gpu", stitched_image_use_gpu_parameter);
+  constexpr auto publish_image_latency_diagnostics_parameter = true;
+  node_->declare_parameter("publish_image_latency_diagnostics", publish_image_latency_diagnostics_parameter);
+  constexpr auto hand_camera_stream_rate_parameter = 5.0;
+  node_->declare_parameter("hand_camera_stream_rate", hand_camera_stream_rate_parameter);
+  constexpr auto hand_camera_stream_quality_parameter = 90.0;
+  node_->declare_parameter("hand_camera_stream_quality", hand_camera_stream_quality_parameter);
+  constexpr auto hand_camera_stream_resize_ratio_parameter = 0.5;
+  node_->declare_parameter("hand_camera_stream_resize_ratio", hand_camera_stream_resize_ratio_parameter);
+  constexpr auto adaptive_rgb_image_quality_parameter = true;
+  node_->declare_parameter("adaptive_rgb_image_quality", adaptive_rgb_image_quality_parameter);
+  constexpr auto min_rgb_image_quality_parameter = 50.0;
+  node_->declare_parameter("min_rgb_image_quality", min_rgb_image_quality_parameter);
+  constexpr auto max_image_age_parameter = 0.25;
+  node_->declare_parameter("max_image_age", max_image_age_parameter);
+  constexpr auto image_request_timeout_parameter = 0.5;
+  node_->declare_parameter("image_request_timeout", image_request_timeout_parameter);
+  constexpr auto robot_state_request_timeout_parameter = 0.2;
+  node_->declare_parameter("robot_state_request_timeout", robot_state_request_timeout_parameter);
+  constexpr auto world_object_request_timeout_parameter = 3.0;
+  node_->declare_parameter("world_object_request_timeout", world_object_request_timeout_parameter);
+  constexpr auto kinematic_request_timeout_parameter = 4.0;
+  node_->declare_parameter("kinematic_request_timeout", kinematic_request_timeout_parameter);
+  constexpr auto degrade_on_poor_link_parameter = false;
+  node_->declare_parameter("degrade_on_poor_link", degrade_on_poor_link_parameter);
+  constexpr auto link_degraded_latency_parameter = 0.5;
+  node_->declare_parameter("link_degraded_latency", link_degraded_latency_parameter);
+  constexpr auto link_degraded_failure_rate_parameter = 0.1;
+  node_->declare_parameter("link_degraded_failure_rate", link_degraded_failure_rate_parameter);
+  constexpr auto degraded_rate_divisor_parameter = 2;
+  node_->declare_parameter("degraded_rate_divisor", degraded_rate_divisor_parameter);
+  constexpr auto degraded_image_quality_parameter = 30.0;
+  node_->declare_parameter("degraded_image_quality", degraded_image_quality_parameter);
+  constexpr auto colorize_registered_point_clouds_parameter = true;
+  node_->declare_parameter("colorize_registered_point_clouds", colorize_registered_point_clouds_parameter);
+  constexpr auto publish_image_bundle_parameter = true;
+  node_->declare_parameter("publish_image_bundle", publish_image_bundle_parameter);
+  constexpr auto stream_images_parameter = true;
+  node_->declare_parameter("stream_images", stream_images_parameter);
+  constexpr auto warm_up_images_parameter = true;
+  node_->declare_parameter("warm_up_images", warm_up_images_parameter);
+  constexpr auto stream_robot_state_parameter = true;
+  node_->declare_parameter("stream_robot_state", stream_robot_state_parameter);
+  constexpr auto low_level_joint_states_parameter = true;
+  node_->declare_parameter("low_level_joint_states", low_level_joint_states_parameter);
+  constexpr auto publish_status_on_change_parameter = true;
+  node_->declare_parameter("publish_status_on_change", publish_status_on_change_parameter);
+  constexpr auto status_heartbeat_period_parameter = 5.0;
+  node_->declare_parameter("status_heartbeat_period", status_heartbeat_period_parameter);
+  constexpr auto metrics_publish_period_parameter = 10.0;
+  node_->declare_parameter("metrics_publish_period", metrics_publish_period_parameter);
+  constexpr auto metrics_textfile_parameter = "/var/lib/node_exporter/spot_driver.prom";
+  node_->declare_parameter("metrics_textfile", metrics_textfile_parameter);
+  constexpr auto publish_raw_protobuf_parameter = true;
+  node_->declare_parameter("publish_raw_protobuf", publish_raw_protobuf_parameter);
+  constexpr auto raw_protobuf_only_parameter = true;
+  node_->declare_parameter("raw_protobuf_only", raw_protobuf_only_parameter);
+  constexpr auto robot_state_history_size_parameter = 1024;
+  node_->declare_parameter("robot_state_history_size", robot_state_history_size_parameter);
+  constexpr auto battery_states_rate_parameter = 1.0;
+  node_->declare_parameter("robot_state_rate.battery_states", battery_states_rate_parameter);
   constexpr auto tf_root_parameter = "body";
   node_->declare_parameter("tf_root", tf_root_parameter);
+  constexpr auto object_sync_translation_threshold_parameter = 0.01;
+  node_->declare_parameter("object_sync_translation_threshold", object_sync_translation_threshold_parameter);
+  constexpr auto object_sync_rotation_threshold_parameter = 0.02;
+  node_->declare_parameter("object_sync_rotation_threshold", object_sync_rotation_threshold_parameter);
+  constexpr auto object_sync_tf_cache_duration_parameter = 2.5;
+  node_->declare_parameter("object_sync_tf_cache_duration", object_sync_tf_cache_duration_parameter);
+  const std::vector<std::string> object_sync_tf_frame_allowlist_parameter = {"MyRobot/", "fiducial_"};
+  node_->declare_parameter("object_sync_tf_frame_allowlist", object_sync_tf_frame_allowlist_parameter);
+  const std::vector<std::string> object_sync_tf_frame_denylist_parameter = {"OtherRobot/"};
+  node_->declare_parameter("object_sync_tf_frame_denylist", object_sync_tf_frame_denylist_parameter);
+  constexpr auto object_sync_world_object_tf_rate_parameter = 50.0;
+  node_->declare_parameter("object_sync_world_object_tf_rate", object_sync_world_object_tf_rate_parameter);
+  constexpr auto image_stream_thread_cpus_parameter = "2-3";
+  node_->declare_parameter("thread_cpus.image_stream", image_stream_thread_cpus_parameter);
+  constexpr auto ik_cache_size_parameter = 100;
+  node_->declare_parameter("ik_cache_size", ik_cache_size_parameter);
+  constexpr auto ik_cache_position_tolerance_parameter = 0.005;
+  node_->declare_parameter("ik_cache_position_tolerance", ik_cache_position_tolerance_parameter);
+  constexpr auto ik_cache_rotation_tolerance_parameter = 0.01;
+  node_->declare_parameter("ik_cache_rotation_tolerance", ik_cache_rotation_tolerance_parameter);
+  constexpr auto robot_description_parameter = "<robot name=\"spot\"><link name=\"body\"/></robot>";
+  node_->declare_parameter("robot_description", robot_description_parameter);
   constexpr auto timesync_timeout_parameter = 42;
   node_->declare_parameter("timesync_timeout", timesync_timeout_parameter);
 
@@ -218,7 +366,81 @@ TEST_F(RclcppParameterInterfaceEnvVarTest, GetSpotConfigFromParameters) {
   EXPECT_THAT(parameter_interface.getPublishRGBImages(), Eq(publish_rgb_images_parameter));
   EXPECT_THAT(parameter_interface.getPublishDepthImages(), Eq(publish_depth_images_parameter));
   EXPECT_THAT(parameter_interface.getPublishDepthRegisteredImages(), Eq(publish_depth_registered_images_parameter));
+  EXPECT_THAT(parameter_interface.getImageDecodeThreads(), Eq(image_decode_threads_parameter));
+  EXPECT_THAT(parameter_interface.getJpegDecoder(), StrEq(jpeg_decoder_parameter));
+  EXPECT_THAT(parameter_interface.getRLEDepthImages(), Eq(rle_depth_images_parameter));
+  EXPECT_THAT(parameter_interface.getCameraPublishRate(SpotCamera::HAND), Eq(hand_image_rate_parameter));
+  EXPECT_THAT(parameter_interface.getImageRequestsInFlight(), Eq(image_requests_in_flight_parameter));
+  EXPECT_THAT(parameter_interface.getOnDemandImages(), Eq(on_demand_images_parameter));
+  EXPECT_THAT(parameter_interface.getStaticTransformsRefreshPeriod(), Eq(static_transforms_refresh_period_parameter));
+  EXPECT_THAT(parameter_interface.getImagePreviewScale(), Eq(image_preview_scale_parameter));
+  EXPECT_THAT(parameter_interface.getImagePreviewRegion(), Eq(image_preview_roi_parameter));
+  EXPECT_THAT(parameter_interface.getPublishDepthPointClouds(), Eq(publish_depth_point_clouds_parameter));
+  EXPECT_THAT(parameter_interface.getPointCloudVoxelSize(), Eq(point_cloud_voxel_size_parameter));
+  EXPECT_THAT(parameter_interface.getPublishCompressedDepthImages(), Eq(publish_compressed_depth_parameter));
+  EXPECT_THAT(parameter_interface.getCompressedDepthFormat(), StrEq(compressed_depth_format_parameter));
+  EXPECT_THAT(parameter_interface.getPublishFilteredDepthImages(), Eq(publish_filtered_depth_parameter));
+  EXPECT_THAT(parameter_interface.getFilteredDepthDecimation(), Eq(filtered_depth_decimation_parameter));
+  EXPECT_THAT(parameter_interface.getFilteredDepthFillHoles(), Eq(filtered_depth_fill_holes_parameter));
+  EXPECT_THAT(parameter_interface.getFilteredDepthMinRange(), Eq(filtered_depth_min_range_parameter));
+  EXPECT_THAT(parameter_interface.getFilteredDepthMaxRange(), Eq(filtered_depth_max_range_parameter));
+  EXPECT_THAT(parameter_interface.getPublishLaserScan(), Eq(publish_laser_scan_parameter));
+  EXPECT_THAT(parameter_interface.getLaserScanMinHeight(), Eq(laser_scan_min_height_parameter));
+  EXPECT_THAT(parameter_interface.getLaserScanMaxHeight(), Eq(laser_scan_max_height_parameter));
+  EXPECT_THAT(parameter_interface.getLaserScanRangeMax(), Eq(laser_scan_range_max_parameter));
+  EXPECT_THAT(parameter_interface.getLaserScanAngleIncrement(), Eq(laser_scan_angle_increment_parameter));
+  EXPECT_THAT(parameter_interface.getPublishStitchedFrontImage(), Eq(publish_stitched_front_image_parameter));
+  EXPECT_THAT(parameter_interface.getVirtualCameraFrame(), StrEq(virtual_camera_frame_parameter));
+  EXPECT_THAT(parameter_interface.getVirtualCameraIntrinsics(), Eq(virtual_camera_intrinsics_parameter));
+  EXPECT_THAT(parameter_interface.getVirtualCameraProjectionPlane(), Eq(virtual_camera_projection_plane_parameter));
+  EXPECT_THAT(parameter_interface.getVirtualCameraPlaneDistance(), Eq(virtual_camera_plane_distance_parameter));
+  EXPECT_THAT(parameter_interface.getStitchedImageRowPadding(), Eq(stitched_image_row_padding_parameter));
+  EXPECT_THAT(parameter_interface.getStitchedImageSeamUpdatePeriod(), Eq(stitched_image_seam_update_period_parameter));
+  EXPECT_THAT(parameter_interface.getStitchedImageBlendMode(), StrEq(stitched_image_blend_mode_parameter));
+  EXPECT_THAT(parameter_interface.getStitchedImageBlendWidth(), Eq(stitched_image_blend_width_parameter));
+  EXPECT_THAT(parameter_interface.getStitchedImageUseGpu(), Eq(stitched_image_use_gpu_parameter));
+  EXPECT_THAT(parameter_interface.getPublishImageLatencyDiagnostics(), Eq(publish_image_latency_diagnostics_parameter));
+  EXPECT_THAT(parameter_interface.getHandCameraStreamRate(), Eq(hand_camera_stream_rate_parameter));
+  EXPECT_THAT(parameter_interface.getHandCameraStreamQuality(), Eq(hand_camera_stream_quality_parameter));
+  EXPECT_THAT(parameter_interface.getHandCameraStreamResizeRatio(), Eq(hand_camera_stream_resize_ratio_parameter));
+  EXPECT_THAT(parameter_interface.getAdaptiveRGBImageQuality(), Eq(adaptive_rgb_image_quality_parameter));
+  EXPECT_THAT(parameter_interface.getMinRGBImageQuality(), Eq(min_rgb_image_quality_parameter));
+  EXPECT_THAT(parameter_interface.getMaxImageAge(), Eq(max_image_age_parameter));
+  EXPECT_THAT(parameter_interface.getImageRequestTimeout(), Eq(image_request_timeout_parameter));
+  EXPECT_THAT(parameter_interface.getRobotStateRequestTimeout(), Eq(robot_state_request_timeout_parameter));
+  EXPECT_THAT(parameter_interface.getWorldObjectRequestTimeout(), Eq(world_object_request_timeout_parameter));
+  EXPECT_THAT(parameter_interface.getKinematicRequestTimeout(), Eq(kinematic_request_timeout_parameter));
+  EXPECT_THAT(parameter_interface.getDegradeOnPoorLink(), Eq(degrade_on_poor_link_parameter));
+  EXPECT_THAT(parameter_interface.getLinkDegradedLatency(), Eq(link_degraded_latency_parameter));
+  EXPECT_THAT(parameter_interface.getLinkDegradedFailureRate(), Eq(link_degraded_failure_rate_parameter));
+  EXPECT_THAT(parameter_interface.getDegradedRateDivisor(), Eq(degraded_rate_divisor_parameter));
+  EXPECT_THAT(parameter_interface.getDegradedRGBImageQuality(), Eq(degraded_image_quality_parameter));
+  EXPECT_THAT(parameter_interface.getColorizeRegisteredPointClouds(), Eq(colorize_registered_point_clouds_parameter));
+  EXPECT_THAT(parameter_interface.getPublishImageBundle(), Eq(publish_image_bundle_parameter));
+  EXPECT_THAT(parameter_interface.getStreamImages(), Eq(stream_images_parameter));
+  EXPECT_THAT(parameter_interface.getWarmUpImages(), Eq(warm_up_images_parameter));
+  EXPECT_THAT(parameter_interface.getStreamRobotState(), Eq(stream_robot_state_parameter));
+  EXPECT_THAT(parameter_interface.getLowLevelJointStates(), Eq(low_level_joint_states_parameter));
+  EXPECT_THAT(parameter_interface.getPublishStatusOnChange(), Eq(publish_status_on_change_parameter));
+  EXPECT_THAT(parameter_interface.getStatusHeartbeatPeriod(), Eq(status_heartbeat_period_parameter));
+  EXPECT_THAT(parameter_interface.getMetricsPublishPeriod(), Eq(metrics_publish_period_parameter));
+  EXPECT_THAT(parameter_interface.getMetricsTextfile(), StrEq(metrics_textfile_parameter));
+  EXPECT_THAT(parameter_interface.getPublishRawProtobuf(), Eq(publish_raw_protobuf_parameter));
+  EXPECT_THAT(parameter_interface.getRawProtobufOnly(), Eq(raw_protobuf_only_parameter));
+  EXPECT_THAT(parameter_interface.getRobotStateHistorySize(), Eq(robot_state_history_size_parameter));
+  EXPECT_THAT(parameter_interface.getRobotStatePublishRate("battery_states"), Eq(battery_states_rate_parameter));
   EXPECT_THAT(parameter_interface.getTFRoot(), Eq(tf_root_parameter));
+  EXPECT_THAT(parameter_interface.getObjectSyncTranslationThreshold(), Eq(object_sync_translation_threshold_parameter));
+  EXPECT_THAT(parameter_interface.getObjectSyncRotationThreshold(), Eq(object_sync_rotation_threshold_parameter));
+  EXPECT_THAT(parameter_interface.getObjectSyncTfCacheDuration(), Eq(object_sync_tf_cache_duration_parameter));
+  EXPECT_THAT(parameter_interface.getObjectSyncTfFrameAllowlist(), Eq(object_sync_tf_frame_allowlist_parameter));
+  EXPECT_THAT(parameter_interface.getObjectSyncTfFrameDenylist(), Eq(object_sync_tf_frame_denylist_parameter));
+  EXPECT_THAT(parameter_interface.getObjectSyncWorldObjectTfRate(), Eq(object_sync_world_object_tf_rate_parameter));
+  EXPECT_THAT(parameter_interface.getThreadCpus("image_stream"), StrEq(image_stream_thread_cpus_parameter));
+  EXPECT_THAT(parameter_interface.getIKCacheSize(), Eq(ik_cache_size_parameter));
+  EXPECT_THAT(parameter_interface.getIKCachePositionTolerance(), Eq(ik_cache_position_tolerance_parameter));
+  EXPECT_THAT(parameter_interface.getIKCacheRotationTolerance(), Eq(ik_cache_rotation_tolerance_parameter));
+  EXPECT_THAT(parameter_interface.getRobotDescription(), StrEq(robot_description_parameter));
   EXPECT_THAT(parameter_interface.getTimeSyncTimeout(), Eq(std::chrono::seconds(timesync_timeout_parameter)));
 }
 
@@ -279,10 +501,99 @@ TEST_F(RclcppParameterInterfaceEnvVarTest, GetConfigDefaults) {
   EXPECT_THAT(parameter_interface.getPublishRGBImages(), IsTrue());
   EXPECT_THAT(parameter_interface.getPublishDepthImages(), IsTrue());
   EXPECT_THAT(parameter_interface.getPublishDepthRegisteredImages(), IsTrue());
+  EXPECT_THAT(parameter_interface.getImageDecodeThreads(), Eq(1));
+  EXPECT_THAT(parameter_interface.getJpegDecoder(), StrEq("opencv"));
+  EXPECT_THAT(parameter_interface.getRLEDepthImages(), IsFalse());
+  EXPECT_THAT(parameter_interface.getCameraPublishRate(SpotCamera::HAND), Eq(15.0));
+  EXPECT_THAT(parameter_interface.getImageRequestsInFlight(), Eq(1));
+  EXPECT_THAT(parameter_interface.getOnDemandImages(), IsFalse());
+  EXPECT_THAT(parameter_interface.getStaticTransformsRefreshPeriod(), Eq(0.0));
+  EXPECT_THAT(parameter_interface.getImagePreviewScale(), Eq(1));
+  EXPECT_THAT(parameter_interface.getImagePreviewRegion(), IsEmpty());
+  EXPECT_THAT(parameter_interface.getPublishDepthPointClouds(), IsFalse());
+  EXPECT_THAT(parameter_interface.getPointCloudVoxelSize(), Eq(0.0));
+  EXPECT_THAT(parameter_interface.getPublishCompressedDepthImages(), IsFalse());
+  EXPECT_THAT(parameter_interface.getCompressedDepthFormat(), StrEq("png"));
+  EXPECT_THAT(parameter_interface.getPublishFilteredDepthImages(), IsFalse());
+  EXPECT_THAT(parameter_interface.getFilteredDepthDecimation(), Eq(2));
+  EXPECT_THAT(parameter_interface.getFilteredDepthFillHoles(), IsTrue());
+  EXPECT_THAT(parameter_interface.getFilteredDepthMinRange(), Eq(0.0));
+  EXPECT_THAT(parameter_interface.getFilteredDepthMaxRange(), Eq(0.0));
+  EXPECT_THAT(parameter_interface.getPublishLaserScan(), IsFalse());
+  EXPECT_THAT(parameter_interface.getLaserScanMinHeight(), Eq(-0.3));
+  EXPECT_THAT(parameter_interface.getLaserScanMaxHeight(), Eq(0.3));
+  EXPECT_THAT(parameter_interface.getLaserScanRangeMax(), Eq(4.0));
+  EXPECT_THAT(parameter_interface.getLaserScanAngleIncrement(), Eq(0.00872665));
+  EXPECT_THAT(parameter_interface.getPublishStitchedFrontImage(), IsFalse());
+  EXPECT_THAT(parameter_interface.getVirtualCameraFrame(), StrEq("frontmiddle_virtual"));
+  EXPECT_THAT(parameter_interface.getVirtualCameraIntrinsics(), IsEmpty());
+  EXPECT_THAT(parameter_interface.getVirtualCameraProjectionPlane(), IsEmpty());
+  EXPECT_THAT(parameter_interface.getVirtualCameraPlaneDistance(), Eq(1.0));
+  EXPECT_THAT(parameter_interface.getStitchedImageRowPadding(), Eq(0));
+  EXPECT_THAT(parameter_interface.getStitchedImageSeamUpdatePeriod(), Eq(1));
+  EXPECT_THAT(parameter_interface.getStitchedImageBlendMode(), StrEq("multiband"));
+  EXPECT_THAT(parameter_interface.getStitchedImageBlendWidth(), Eq(50));
+  EXPECT_THAT(parameter_interface.getStitchedImageUseGpu(), IsTrue());
+  EXPECT_THAT(parameter_interface.getPublishImageLatencyDiagnostics(), IsFalse());
+  EXPECT_THAT(parameter_interface.getHandCameraStreamRate(), Eq(0.0));
+  EXPECT_THAT(parameter_interface.getHandCameraStreamQuality(), Eq(100.0));
+  EXPECT_THAT(parameter_interface.getHandCameraStreamResizeRatio(), Eq(1.0));
+  EXPECT_THAT(parameter_interface.getAdaptiveRGBImageQuality(), IsFalse());
+  EXPECT_THAT(parameter_interface.getMinRGBImageQuality(), Eq(30.0));
+  EXPECT_THAT(parameter_interface.getMaxImageAge(), Eq(0.0));
+  EXPECT_THAT(parameter_interface.getImageRequestTimeout(), Eq(2.0));
+  EXPECT_THAT(parameter_interface.getRobotStateRequestTimeout(), Eq(1.0));
+  EXPECT_THAT(parameter_interface.getWorldObjectRequestTimeout(), Eq(5.0));
+  EXPECT_THAT(parameter_interface.getKinematicRequestTimeout(), Eq(5.0));
+  EXPECT_THAT(parameter_interface.getDegradeOnPoorLink(), IsTrue());
+  EXPECT_THAT(parameter_interface.getLinkDegradedLatency(), Eq(0.3));
+  EXPECT_THAT(parameter_interface.getLinkDegradedFailureRate(), Eq(0.2));
+  EXPECT_THAT(parameter_interface.getDegradedRateDivisor(), Eq(4));
+  EXPECT_THAT(parameter_interface.getDegradedRGBImageQuality(), Eq(50.0));
+  EXPECT_THAT(parameter_interface.getColorizeRegisteredPointClouds(), IsFalse());
+  EXPECT_THAT(parameter_interface.getPublishImageBundle(), IsFalse());
+  EXPECT_THAT(parameter_interface.getStreamImages(), IsFalse());
+  EXPECT_THAT(parameter_interface.getWarmUpImages(), IsFalse());
+  EXPECT_THAT(parameter_interface.getStreamRobotState(), IsFalse());
+  EXPECT_THAT(parameter_interface.getLowLevelJointStates(), IsFalse());
+  EXPECT_THAT(parameter_interface.getPublishStatusOnChange(), IsFalse());
+  EXPECT_THAT(parameter_interface.getStatusHeartbeatPeriod(), Eq(1.0));
+  EXPECT_THAT(parameter_interface.getMetricsPublishPeriod(), Eq(1.0));
+  EXPECT_THAT(parameter_interface.getMetricsTextfile(), IsEmpty());
+  EXPECT_THAT(parameter_interface.getPublishRawProtobuf(), IsFalse());
+  EXPECT_THAT(parameter_interface.getRawProtobufOnly(), IsFalse());
+  EXPECT_THAT(parameter_interface.getRobotStateHistorySize(), Eq(256));
+  EXPECT_THAT(parameter_interface.getRobotStatePublishRate("battery_states"), Eq(0.0));
   EXPECT_THAT(parameter_interface.getTFRoot(), StrEq("odom"));
+  EXPECT_THAT(parameter_interface.getObjectSyncTranslationThreshold(), Eq(0.0));
+  EXPECT_THAT(parameter_interface.getObjectSyncRotationThreshold(), Eq(0.0));
+  EXPECT_THAT(parameter_interface.getObjectSyncTfCacheDuration(), Eq(10.0));
+  EXPECT_THAT(parameter_interface.getObjectSyncTfFrameAllowlist(), IsEmpty());
+  EXPECT_THAT(parameter_interface.getObjectSyncTfFrameDenylist(), IsEmpty());
+  EXPECT_THAT(parameter_interface.getObjectSyncWorldObjectTfRate(), Eq(0.0));
+  EXPECT_THAT(parameter_interface.getThreadCpus("image_stream"), IsEmpty());
+  EXPECT_THAT(parameter_interface.getIKCacheSize(), Eq(0));
+  EXPECT_THAT(parameter_interface.getIKCachePositionTolerance(), Eq(0.001));
+  EXPECT_THAT(parameter_interface.getIKCacheRotationTolerance(), Eq(0.001));
+  EXPECT_THAT(parameter_interface.getRobotDescription(), IsEmpty());
   EXPECT_THAT(parameter_interface.getTimeSyncTimeout(), Eq(std::chrono::seconds(5)));
 }
 
+TEST_F(RclcppParameterInterfaceEnvVarTest, GetParametersAreResolvedOnce) {
+  // GIVEN we create a RclcppParameterInterface using the node, and get a parameter and an environment variable
+  RclcppParameterInterface parameter_interface{node_};
+  EXPECT_THAT(parameter_interface.getRGBImageQuality(), Eq(70.0));
+  EXPECT_THAT(parameter_interface.getHostname(), StrEq("10.0.0.3"));
+
+  // WHEN the parameter and the environment variable are changed afterwards
+  node_->set_parameter(rclcpp::Parameter("image_quality", 30.0));
+  setenv(kEnvVarNameHostname, "10.0.20.5", 1);
+
+  // THEN the interface keeps returning the values it resolved first
+  EXPECT_THAT(parameter_interface.getRGBImageQuality(), Eq(70.0));
+  EXPECT_THAT(parameter_interface.getHostname(), StrEq("10.0.0.3"));
+}
+
 TEST_F(RclcppParameterInterfaceEnvVarTest, GetCamerasUsedDefaultWithArm) {
   // GIVEN we don't set the cameras_used parameter
   // GIVEN we create a RclcppParameterInterface using the node
@@ -442,4 +753,95 @@ TEST_F(RclcppParameterInterfaceEnvVarTest, GetSelectedCamerasUsedGripperless) {
   EXPECT_THAT(cameras_used_arm.error(), StrEq("Cannot add SpotCamera 'hand', the robot is gripperless!"));
 }
 
+TEST_F(RclcppParameterInterfaceEnvVarTest, GetPublisherQoSDefaults) {
+  // GIVEN we create a RclcppParameterInterface using the node
+  RclcppParameterInterface parameter_interface{node_};
+
+  // WHEN we get the QoS settings for a category of topics without setting any QoS parameters
+  const auto qos = parameter_interface.getPublisherQoS("image");
+
+  // THEN the defaults match the reliable and transient local profile used by all publishers
+  ASSERT_THAT(qos.has_value(), IsTrue());
+  EXPECT_THAT(qos->reliable, IsTrue());
+  EXPECT_THAT(qos->transient_local, IsTrue());
+  EXPECT_THAT(qos->depth.has_value(), IsFalse());
+  EXPECT_THAT(qos->deadline.count(), Eq(0.0));
+  EXPECT_THAT(qos->lifespan.count(), Eq(0.0));
+}
+
+TEST_F(RclcppParameterInterfaceEnvVarTest, GetPublisherQoSFromParameters) {
+  // GIVEN we set the QoS parameters for image topics
+  node_->declare_parameter("qos.image.reliability", "best_effort");
+  node_->declare_parameter("qos.image.durability", "volatile");
+  node_->declare_parameter("qos.image.depth", 2);
+  node_->declare_parameter("qos.image.deadline", 0.5);
+  node_->declare_parameter("qos.image.lifespan", 0.25);
+
+  // GIVEN we create a RclcppParameterInterface using the node
+  RclcppParameterInterface parameter_interface{node_};
+
+  // WHEN we get the QoS settings for image topics
+  const auto qos = parameter_interface.getPublisherQoS("image");
+
+  // THEN the settings match the values we used when declaring the parameters
+  ASSERT_THAT(qos.has_value(), IsTrue());
+  EXPECT_THAT(qos->reliable, IsFalse());
+  EXPECT_THAT(qos->transient_local, IsFalse());
+  EXPECT_THAT(qos->depth, Optional(2u));
+  EXPECT_THAT(qos->deadline.count(), Eq(0.5));
+  EXPECT_THAT(qos->lifespan.count(), Eq(0.25));
+
+  // THEN other categories of topics keep the defaults
+  const auto state_qos = parameter_interface.getPublisherQoS("state");
+  ASSERT_THAT(state_qos.has_value(), IsTrue());
+  EXPECT_THAT(state_qos->reliable, IsTrue());
+}
+
+TEST_F(RclcppParameterInterfaceEnvVarTest, GetPublisherQoSWithInvalidReliability) {
+  // GIVEN we set an invalid QoS reliability for image topics
+  node_->declare_parameter("qos.image.reliability", "sometimes");
+
+  // GIVEN we create a RclcppParameterInterface using the node
+  RclcppParameterInterface parameter_interface{node_};
+
+  // WHEN we get the QoS settings for image topics
+  // THEN the result is an error
+  EXPECT_THAT(parameter_interface.getPublisherQoS("image").has_value(), IsFalse());
+}
+
+TEST_F(RclcppParameterInterfaceTest, ValidateParameter) {
+  // GIVEN valid values of constrained parameters
+  // WHEN we validate them
+  // THEN they are accepted
+  EXPECT_THAT(RclcppParameterInterface::validateParameter({"qos.image.reliability", "best_effort"}).has_value(),
+              IsTrue());
+  EXPECT_THAT(RclcppParameterInterface::validateParameter({"image_rate.hand", 2.5}).has_value(), IsTrue());
+  EXPECT_THAT(RclcppParameterInterface::validateParameter(
+                  {"cameras_used", std::vector<std::string>{"frontleft", "hand"}})
+                  .has_value(),
+              IsTrue());
+
+  // GIVEN invalid values of the same parameters
+  // WHEN we validate them
+  // THEN they are rejected
+  EXPECT_THAT(RclcppParameterInterface::validateParameter({"qos.image.reliability", "sometimes"}).has_value(),
+              IsFalse());
+  EXPECT_THAT(RclcppParameterInterface::validateParameter({"qos.state.depth", -1}).has_value(), IsFalse());
+  EXPECT_THAT(RclcppParameterInterface::validateParameter({"image_rate.hand", 0.0}).has_value(), IsFalse());
+  EXPECT_THAT(RclcppParameterInterface::validateParameter({"hand_camera_stream_resize_ratio", 1.5}).has_value(),
+              IsFalse());
+  EXPECT_THAT(RclcppParameterInterface::validateParameter(
+                  {"cameras_used", std::vector<std::string>{"frontleft", "not_a_camera"}})
+                  .has_value(),
+              IsFalse());
+
+  // GIVEN a batch of parameters of which one is invalid
+  // WHEN we validate them as the set parameters callback
+  const auto result = RclcppParameterInterface::validateParameters(
+      {rclcpp::Parameter{"image_rate.hand", 2.5}, rclcpp::Parameter{"image_rate.back", -1.0}});
+
+  // THEN the batch is rejected with the name of the invalid parameter
+  EXPECT_THAT(result.successful, IsFalse());
+  EXPECT_THAT(result.reason.rfind("image_rate.back: ", 0), Eq(0U));
+}
 }  // namespace spot_ros2::test
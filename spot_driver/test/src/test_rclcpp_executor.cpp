@@ -0,0 +1,29 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <spot_driver/interfaces/rclcpp_executor.hpp>
+
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+
+namespace spot_ros2::test {
+TEST(RclcppExecutor, ToExecutorType) {
+  // GIVEN the names of the supported executors and an unsupported executor
+  // WHEN we convert them to an ExecutorType
+  // THEN the supported executors are converted and the unsupported executor returns an error
+  EXPECT_THAT(toExecutorType("single_threaded").value(), Eq(ExecutorType::SINGLE_THREADED));
+  EXPECT_THAT(toExecutorType("multi_threaded").value(), Eq(ExecutorType::MULTI_THREADED));
+  EXPECT_THAT(toExecutorType("events").value(), Eq(ExecutorType::EVENTS));
+  EXPECT_THAT(toExecutorType("static_single_threaded").has_value(), IsFalse());
+}
+
+TEST(RclcppExecutor, ThreadedExecutorsAreAlwaysAvailable) {
+  // GIVEN the executors of every rclcpp version
+  // WHEN we check if they were compiled into the driver
+  // THEN they are available
+  EXPECT_THAT(isExecutorAvailable(ExecutorType::SINGLE_THREADED), IsTrue());
+  EXPECT_THAT(isExecutorAvailable(ExecutorType::MULTI_THREADED), IsTrue());
+}
+}  // namespace spot_ros2::test
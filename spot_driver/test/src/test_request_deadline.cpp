@@ -0,0 +1,57 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <spot_driver/api/request_deadline.hpp>
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+using ::testing::HasSubstr;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+
+namespace spot_ros2::test {
+TEST(RequestDeadline, WaitForFinishedRequest) {
+  // GIVEN a request which has finished
+  std::promise<int> promise;
+  const auto future = promise.get_future().share();
+  promise.set_value(1);
+
+  // WHEN we wait for it with a deadline
+  // THEN its result is ready
+  EXPECT_THAT(waitForRequest(future, std::chrono::duration<double>{0.1}), IsTrue());
+}
+
+TEST(RequestDeadline, GiveUpOnRequestPastItsDeadline) {
+  // GIVEN a request which never finishes
+  std::promise<int> promise;
+  const auto future = promise.get_future().share();
+
+  // WHEN we wait for it with a deadline
+  // THEN the wait gives up after the deadline
+  EXPECT_THAT(waitForRequest(future, std::chrono::duration<double>{0.01}), IsFalse());
+}
+
+TEST(RequestDeadline, WaitWithoutDeadline) {
+  // GIVEN a request which finishes later
+  std::promise<int> promise;
+  const auto future = promise.get_future().share();
+  std::thread worker{[&promise] {
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    promise.set_value(1);
+  }};
+
+  // WHEN we wait for it without a deadline
+  // THEN the wait lasts until the request has finished
+  EXPECT_THAT(waitForRequest(future, std::chrono::duration<double>{0.0}), IsTrue());
+  worker.join();
+}
+
+TEST(RequestDeadline, TimedOutMessageNamesTheService) {
+  // WHEN we create the error message of a request which timed out
+  // THEN it names the service
+  EXPECT_THAT(makeTimedOutMessage("GetImage", std::chrono::duration<double>{2.0}), HasSubstr("GetImage"));
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,140 @@
+// Copyright (c) 2024 The AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <bosdyn/api/image.pb.h>
+#include <bosdyn/api/robot_state.pb.h>
+#include <google/protobuf/duration.pb.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <sensor_msgs/msg/image.hpp>
+#include <sensor_msgs/msg/joint_state.hpp>
+#include <spot_driver/allocation_counter.hpp>
+#include <spot_driver/conversions/decompress_images.hpp>
+#include <spot_driver/conversions/robot_state.hpp>
+#include <spot_driver/robot_state_test_tools.hpp>
+#include <std_msgs/msg/header.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+using ::testing::Eq;
+using ::testing::Gt;
+using ::testing::IsTrue;
+
+constexpr auto kPrefix = "prefix/";
+
+/** @brief Create a raw 16 bit depth image capture. */
+bosdyn::api::ImageCapture createRawDepthCapture(const int cols, const int rows) {
+  bosdyn::api::ImageCapture capture;
+  capture.set_frame_name_image_sensor("frontleft_fisheye");
+  auto* image = capture.mutable_image();
+  image->set_cols(cols);
+  image->set_rows(rows);
+  image->set_pixel_format(bosdyn::api::Image_PixelFormat_PIXEL_FORMAT_DEPTH_U16);
+  image->set_format(bosdyn::api::Image_Format_FORMAT_RAW);
+  image->set_data(std::string(static_cast<std::size_t>(cols * rows) * sizeof(std::uint16_t), '\x01'));
+  return capture;
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(AllocationCounter, CountsAllocationsOfTheCallingThread) {
+  // GIVEN an allocation counter
+  const ScopedAllocationCounter counter;
+
+  // WHEN the thread allocates on the heap
+  const auto allocated = std::make_unique<std::vector<int>>(16);
+  const auto allocations = counter.count();
+
+  // THEN the allocations are counted
+  EXPECT_THAT(allocations, Gt(0u));
+}
+
+TEST(AllocationCounter, DoesNotCountWorkWithoutAllocations) {
+  // GIVEN a vector which already holds its elements
+  std::vector<int> values(16);
+
+  // WHEN the vector is only overwritten
+  const ScopedAllocationCounter counter;
+  values.assign(16, 1);
+  const auto allocations = counter.count();
+
+  // THEN nothing is counted
+  EXPECT_THAT(allocations, Eq(0u));
+}
+
+TEST(SteadyStateAllocations, JointStateConverter) {
+  // GIVEN a robot state with the joints of a robot with an arm
+  ::bosdyn::api::RobotState robot_state;
+  robot_state.mutable_kinematic_state()->mutable_acquisition_timestamp()->set_seconds(15);
+  for (const auto* joint : {"fl.hx", "fl.hy", "fl.kn", "fr.hx", "fr.hy", "fr.kn", "hl.hx", "hl.hy", "hl.kn", "hr.hx",
+                            "hr.hy", "hr.kn", "arm0.sh0", "arm0.sh1", "arm0.el0", "arm0.el1", "arm0.wr0", "arm0.wr1"}) {
+    setJointState(robot_state.mutable_kinematic_state()->add_joint_states(), joint, 0.1, 0.2, 0.3, 0.4);
+  }
+  const google::protobuf::Duration clock_skew;
+
+  // GIVEN a JointStateConverter which already converted a robot state into a message
+  JointStateConverter converter{kPrefix};
+  sensor_msgs::msg::JointState joint_states;
+  ASSERT_THAT(converter.convert(robot_state, clock_skew, joint_states), IsTrue());
+
+  // WHEN the joints move and the robot state is converted into the same message again
+  setJointState(robot_state.mutable_kinematic_state()->mutable_joint_states(0), "fl.hx", 1.1, 1.2, 1.3, 1.4);
+  const ScopedAllocationCounter counter;
+  const auto converted = converter.convert(robot_state, clock_skew, joint_states);
+  const auto allocations = counter.count();
+
+  // THEN the conversion does not allocate
+  EXPECT_THAT(allocations, Eq(0u));
+  EXPECT_THAT(converted, IsTrue());
+}
+
+TEST(SteadyStateAllocations, FrameTreeConverter) {
+  // GIVEN a frame tree snapshot rooted at the preferred base frame
+  ::bosdyn::api::FrameTreeSnapshot snapshot;
+  addRootFrame(&snapshot, "odom");
+  addTransform(&snapshot, "body", "odom", 1.0, 2.0, 3.0, 1.0, 0.0, 0.0, 0.0);
+  addTransform(&snapshot, "vision", "odom", 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+  addTransform(&snapshot, "hand", "body", 4.0, 5.0, 6.0, 1.0, 0.0, 0.0, 0.0);
+  google::protobuf::Timestamp timestamp;
+  timestamp.set_seconds(99);
+  const google::protobuf::Duration clock_skew;
+
+  // GIVEN a FrameTreeConverter which already converted the snapshot
+  FrameTreeConverter converter{kPrefix, "prefix/odom"};
+  ASSERT_THAT(converter.convert(snapshot, timestamp, clock_skew), IsTrue());
+
+  // WHEN a later snapshot of the same frame tree is converted
+  timestamp.set_seconds(100);
+  const ScopedAllocationCounter counter;
+  const auto converted = converter.convert(snapshot, timestamp, clock_skew);
+  const auto allocations = counter.count();
+
+  // THEN the conversion does not allocate
+  EXPECT_THAT(allocations, Eq(0u));
+  EXPECT_THAT(converted, IsTrue());
+}
+
+TEST(SteadyStateAllocations, DecompressRawImageIntoReusedMessage) {
+  // GIVEN a raw depth image and the header of its camera info
+  const auto capture = createRawDepthCapture(64, 48);
+  std_msgs::msg::Header header;
+  header.frame_id = "prefix/frontleft_fisheye";
+
+  // GIVEN a message which already holds a converted image of the same size
+  sensor_msgs::msg::Image image;
+  ASSERT_THAT(getDecompressImageMsg(capture, header, image, JpegDecoderBackend::OPENCV).has_value(), IsTrue());
+
+  // WHEN the next image is converted into the same message
+  const ScopedAllocationCounter counter;
+  const auto result = getDecompressImageMsg(capture, header, image, JpegDecoderBackend::OPENCV);
+  const auto allocations = counter.count();
+
+  // THEN the conversion does not allocate
+  EXPECT_THAT(allocations, Eq(0u));
+  EXPECT_THAT(result.has_value(), IsTrue());
+}
+}  // namespace spot_ros2::test
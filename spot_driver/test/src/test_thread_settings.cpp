@@ -0,0 +1,96 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <spot_driver/fake/fake_parameter_interface.hpp>
+#include <spot_driver/interfaces/thread_settings.hpp>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <array>
+#include <future>
+#include <string>
+#include <thread>
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::StrEq;
+
+namespace spot_ros2::test {
+TEST(ThreadSettings, ParseCpuList) {
+  // GIVEN lists of single CPUs and ranges of CPUs
+  // WHEN they are parsed
+  // THEN every CPU of the list is returned
+  EXPECT_THAT(parseCpuList("").value(), IsEmpty());
+  EXPECT_THAT(parseCpuList("3").value(), ElementsAre(3));
+  EXPECT_THAT(parseCpuList("2,3").value(), ElementsAre(2, 3));
+  EXPECT_THAT(parseCpuList("4-6,10").value(), ElementsAre(4, 5, 6, 10));
+}
+
+TEST(ThreadSettings, ParseMalformedCpuList) {
+  // GIVEN malformed lists of CPUs
+  // WHEN they are parsed
+  // THEN an error names the malformed entry
+  EXPECT_THAT(parseCpuList("two").has_value(), IsFalse());
+  EXPECT_THAT(parseCpuList("2,").has_value(), IsFalse());
+  EXPECT_THAT(parseCpuList("-1").has_value(), IsFalse());
+  EXPECT_THAT(parseCpuList("6-4").error(), HasSubstr("`6-4`"));
+  EXPECT_THAT(parseCpuList("100000").has_value(), IsFalse());
+}
+
+TEST(ThreadSettings, MakeThreadSettingsFromParameters) {
+  // GIVEN the CPUs of a class of threads are set
+  FakeParameterInterface parameters;
+  parameters.thread_cpus["image_stream"] = "1-2";
+  parameters.thread_cpus["workers"] = "a";
+
+  // WHEN the settings of the classes are made
+  const auto image_stream = makeThreadSettings(parameters, "image_stream", "spot_images");
+  const auto state_stream = makeThreadSettings(parameters, "state_stream", "spot_state");
+  const auto workers = makeThreadSettings(parameters, "workers", "spot_worker");
+
+  // THEN the threads are pinned to the set CPUs, unset classes run on any CPU, and malformed CPUs are an error
+  ASSERT_THAT(image_stream.has_value(), IsTrue());
+  EXPECT_THAT(image_stream->name, StrEq("spot_images"));
+  EXPECT_THAT(image_stream->cpus, ElementsAre(1, 2));
+  ASSERT_THAT(state_stream.has_value(), IsTrue());
+  EXPECT_THAT(state_stream->cpus, IsEmpty());
+  ASSERT_THAT(workers.has_value(), IsFalse());
+  EXPECT_THAT(workers.error(), HasSubstr("thread_cpus.workers"));
+}
+
+TEST(ThreadSettings, ApplyThreadSettingsToRunningThread) {
+  // GIVEN a running thread, and a CPU which this process may run on
+  cpu_set_t allowed;
+  ASSERT_THAT(sched_getaffinity(0, sizeof(allowed), &allowed), Eq(0));
+  int cpu = 0;
+  while (!CPU_ISSET(cpu, &allowed)) {
+    ++cpu;
+  }
+  std::promise<void> stop;
+  std::thread thread{[stopped = stop.get_future()]() {
+    stopped.wait();
+  }};
+
+  // WHEN the thread is named and pinned to the CPU
+  const auto result = applyThreadSettings(thread.native_handle(), ThreadSettings{"spot_test_thread_name", {cpu}});
+
+  // THEN the thread has its name, truncated to the limit of Linux, and only runs on the CPU
+  EXPECT_THAT(result.has_value(), IsTrue());
+  std::array<char, 16> name{};
+  ASSERT_THAT(pthread_getname_np(thread.native_handle(), name.data(), name.size()), Eq(0));
+  EXPECT_THAT(std::string{name.data()}, StrEq("spot_test_threa"));
+  cpu_set_t cpus;
+  ASSERT_THAT(pthread_getaffinity_np(thread.native_handle(), sizeof(cpus), &cpus), Eq(0));
+  EXPECT_THAT(CPU_COUNT(&cpus), Eq(1));
+  EXPECT_THAT(CPU_ISSET(cpu, &cpus), IsTrue());
+
+  stop.set_value();
+  thread.join();
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,113 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <spot_driver/interfaces/work_stealing_thread_pool.hpp>
+
+#include <spot_driver/mock/mock_logger_interface.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using ::testing::Each;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+using ::testing::Throws;
+
+namespace spot_ros2::test {
+TEST(WorkStealingThreadPool, RunsPostedTasksBeforeDestruction) {
+  // GIVEN a thread pool
+  std::atomic<int> count{0};
+  {
+    WorkStealingThreadPool pool{2, std::make_unique<MockLoggerInterface>()};
+
+    // WHEN many tasks are posted and the pool is destroyed right away
+    for (int task = 0; task < 100; ++task) {
+      pool.post([&count]() {
+        ++count;
+      });
+    }
+  }
+
+  // THEN every task was run
+  EXPECT_THAT(count.load(), Eq(100));
+}
+
+TEST(WorkStealingThreadPool, ParallelForRunsEveryJobOnce) {
+  // GIVEN a thread pool
+  WorkStealingThreadPool pool{3, std::make_unique<MockLoggerInterface>()};
+  std::vector<int> calls(1000, 0);
+
+  // WHEN a parallelFor is run on more workers than the pool has threads
+  pool.parallelFor(calls.size(), 8, [&calls](const std::size_t job) {
+    ++calls[job];
+  });
+
+  // THEN every job was run exactly once by the time it returns
+  EXPECT_THAT(calls, Each(Eq(1)));
+}
+
+TEST(WorkStealingThreadPool, ParallelForRethrowsAfterAllJobs) {
+  // GIVEN a thread pool
+  WorkStealingThreadPool pool{2, std::make_unique<MockLoggerInterface>()};
+  std::vector<int> calls(10, 0);
+
+  // WHEN one of the jobs of a parallelFor throws
+  // THEN the exception is rethrown, after the other jobs were still run
+  EXPECT_THAT(
+      [&]() {
+        pool.parallelFor(calls.size(), 3, [&calls](const std::size_t job) {
+          ++calls[job];
+          if (job == 4) {
+            throw std::runtime_error{"job failed"};
+          }
+        });
+      },
+      Throws<std::runtime_error>());
+  EXPECT_THAT(calls, Each(Eq(1)));
+}
+
+TEST(WorkStealingThreadPool, NestedParallelForDoesNotDeadlock) {
+  // GIVEN a thread pool with a single thread
+  WorkStealingThreadPool pool{1, std::make_unique<MockLoggerInterface>()};
+  std::atomic<int> count{0};
+  std::promise<void> done;
+
+  // WHEN a task which occupies that thread runs a parallelFor
+  pool.post([&]() {
+    pool.parallelFor(4, 4, [&count](const std::size_t) {
+      ++count;
+    });
+    done.set_value();
+  });
+
+  // THEN the task finishes, since its own thread runs the jobs
+  done.get_future().wait();
+  EXPECT_THAT(count.load(), Eq(4));
+}
+
+TEST(WorkStealingThreadPool, LogsExceptionsOfPostedTasks) {
+  // GIVEN a thread pool with a single thread, which logs the exceptions of its tasks
+  auto logger = std::make_unique<MockLoggerInterface>();
+  // THEN the exception of the throwing task is logged
+  EXPECT_CALL(*logger, logError(HasSubstr("task failed"))).Times(1);
+  WorkStealingThreadPool pool{1, std::move(logger)};
+
+  // WHEN a posted task throws, and another task is posted after it
+  pool.post([]() {
+    throw std::runtime_error{"task failed"};
+  });
+  std::promise<void> done;
+  pool.post([&done]() {
+    done.set_value();
+  });
+
+  // THEN the worker thread survives, and runs the next task
+  EXPECT_THAT(done.get_future().wait_for(std::chrono::seconds{5}), Eq(std::future_status::ready));
+}
+}  // namespace spot_ros2::test
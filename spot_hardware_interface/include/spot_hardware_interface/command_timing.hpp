@@ -0,0 +1,106 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <optional>
+
+#include "spot_hardware_interface/hardware_parameters.hpp"
+
+namespace spot_hardware_interface {
+
+class CommandTiming {
+  // Picks the extrapolation duration and the end time of the joint commands from the measured command latency and
+  // period, the way TCP picks its retransmission timeout: the average and mean deviation of both are tracked with
+  // exponential moving averages, and each duration covers the average plus four deviations, within the configured
+  // bounds. The extrapolation bridges the latency of a command, so that the robot does not hold a stale command while
+  // the next one is in flight, and the end time lets a few commands be lost before the robot stops following the last
+  // one. Only used by the command thread.
+ public:
+  // Number of consecutive commands which may be lost before the last received one expires.
+  static constexpr int kMissedCommands = 2;
+
+  CommandTiming() = default;
+  explicit CommandTiming(const CommandTimingBounds& bounds) : bounds_(bounds) {}
+
+  /**
+   * @brief Record a command which the robot acknowledged.
+   * @param sent Local time when the command was sent.
+   * @param latency Time until the robot acknowledged the command.
+   */
+  void record(std::chrono::steady_clock::time_point sent, std::chrono::steady_clock::duration latency) {
+    latency_.update(std::chrono::duration<double>(latency).count());
+    if (last_sent_) {
+      period_.update(std::chrono::duration<double>(sent - *last_sent_).count());
+    }
+    last_sent_ = sent;
+  }
+
+  // Drop the measurements, e.g. when the command stream is restarted.
+  void reset() {
+    latency_ = {};
+    period_ = {};
+    last_sent_.reset();
+  }
+
+  /**
+   * @brief Get how far the robot extrapolates the next command.
+   * @return The upper estimate of the command latency within the bounds, or the minimum bound before any command was
+   * acknowledged.
+   */
+  std::chrono::nanoseconds extrapolation() const {
+    if (!latency_.valid) {
+      return bounds_.min_extrapolation;
+    }
+    return clamp(latency_.upper(), bounds_.min_extrapolation, bounds_.max_extrapolation);
+  }
+
+  /**
+   * @brief Get how long after it is sent the next command expires.
+   * @return The upper estimate of the time until kMissedCommands further commands were lost, within the bounds, or
+   * the maximum bound before the command period was measured.
+   */
+  std::chrono::nanoseconds end_time_offset() const {
+    if (!latency_.valid || !period_.valid) {
+      return bounds_.max_end_time;
+    }
+    return clamp((kMissedCommands + 1) * period_.upper() + latency_.upper(), bounds_.min_end_time,
+                 bounds_.max_end_time);
+  }
+
+ private:
+  struct Estimate {
+    // Exponential moving average and mean deviation of a duration in seconds, with the gains of RFC 6298.
+    static constexpr double kAverageGain = 1.0 / 8.0;
+    static constexpr double kDeviationGain = 1.0 / 4.0;
+    double average = 0.0;
+    double deviation = 0.0;
+    bool valid = false;
+
+    void update(double sample) {
+      if (!valid) {
+        average = sample;
+        deviation = sample / 2.0;
+        valid = true;
+        return;
+      }
+      deviation += kDeviationGain * (std::abs(sample - average) - deviation);
+      average += kAverageGain * (sample - average);
+    }
+    double upper() const { return average + 4.0 * deviation; }
+  };
+
+  static std::chrono::nanoseconds clamp(double seconds, std::chrono::nanoseconds min, std::chrono::nanoseconds max) {
+    return std::clamp(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(seconds)),
+                      min, max);
+  }
+
+  CommandTimingBounds bounds_;
+  Estimate latency_;
+  Estimate period_;
+  std::optional<std::chrono::steady_clock::time_point> last_sent_;
+};
+
+}  // namespace spot_hardware_interface
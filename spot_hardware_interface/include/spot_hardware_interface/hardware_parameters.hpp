@@ -0,0 +1,121 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace spot_hardware_interface {
+
+struct ThreadSettings {
+  // Scheduling settings of a thread which talks to the robot, read from the hardware parameters.
+  // SCHED_FIFO priority of the thread between 1 and 99, or 0 to keep the default scheduling policy.
+  int priority = 0;
+  // CPUs which the thread is pinned to, or empty to let it run on any CPU.
+  std::vector<int> cpus;
+  // Name of the thread shown by top and perf. Linux truncates it to 15 characters.
+  std::string name;
+};
+
+struct RetryBackoff {
+  // Exponential backoff between the retries of a failed RPC, so that a thread does not spin on a lost connection.
+  std::chrono::milliseconds initial{1};
+  std::chrono::milliseconds max{1000};
+  // Delay before the next retry, which is doubled after every failure and reset after every success.
+  std::chrono::milliseconds current{0};
+
+  /**
+   * @brief Record a failure and get the delay before the next retry.
+   * @return The initial delay after the first failure, and twice the previous delay after every further failure, up
+   * to the maximum delay.
+   */
+  std::chrono::milliseconds next_delay() {
+    current = current.count() == 0 ? initial : std::min(current * 2, max);
+    return current;
+  }
+  // Record a success, so that the next failure is retried after the initial delay again.
+  void reset() { current = std::chrono::milliseconds{0}; }
+};
+
+struct CommandTimingBounds {
+  // Bounds of the extrapolation duration and end time offset of the joint commands, which are picked between them
+  // from the measured command latency. Equal bounds fix the duration.
+  std::chrono::milliseconds min_extrapolation{5};
+  std::chrono::milliseconds max_extrapolation{20};
+  std::chrono::milliseconds min_end_time{20};
+  std::chrono::milliseconds max_end_time{50};
+};
+
+/**
+ * @brief Read the settings of a thread from the hardware parameters <prefix>_priority and <prefix>_cpu, which keep
+ * their defaults if they are not set. <prefix>_cpu is a CPU, a list of CPUs in the format of taskset such as "2,3" or
+ * "4-7", or -1 to let the thread run on any CPU.
+ * @param parameters Hardware parameters of the hardware interface.
+ * @param prefix Prefix of the parameter names, e.g. "state_thread".
+ * @param settings Receives the settings.
+ * @return False if a parameter is set but invalid.
+ */
+bool read_thread_settings(const std::unordered_map<std::string, std::string>& parameters, const std::string& prefix,
+                          ThreadSettings& settings);
+
+/**
+ * @brief Read the backoff of failed RPCs from the hardware parameters retry_initial_delay_ms and retry_max_delay_ms,
+ * which keep their defaults if they are not set.
+ * @param parameters Hardware parameters of the hardware interface.
+ * @param backoff Receives the initial and maximum delays.
+ * @return False if a parameter is set but invalid.
+ */
+bool read_retry_backoff(const std::unordered_map<std::string, std::string>& parameters, RetryBackoff& backoff);
+
+/**
+ * @brief Read the bounds of the command timing from the hardware parameters command_extrapolation_min_ms,
+ * command_extrapolation_max_ms, command_end_time_min_ms and command_end_time_max_ms, which keep their defaults if they
+ * are not set.
+ * @param parameters Hardware parameters of the hardware interface.
+ * @param bounds Receives the bounds.
+ * @return False if a parameter is set but invalid, or a minimum is above its maximum.
+ */
+bool read_command_timing_bounds(const std::unordered_map<std::string, std::string>& parameters,
+                                CommandTimingBounds& bounds);
+
+/**
+ * @brief Read how long read() waits for a new state from the hardware parameter state_wait_timeout_ms, which keeps its
+ * default if it is not set.
+ * @param parameters Hardware parameters of the hardware interface.
+ * @param timeout Receives the timeout, which is zero if read() does not wait.
+ * @return False if the parameter is set but invalid.
+ */
+bool read_state_wait_timeout(const std::unordered_map<std::string, std::string>& parameters,
+                             std::chrono::milliseconds& timeout);
+
+/**
+ * @brief Read whether the loopback backend is used from the hardware parameters loopback and loopback_state_rate_hz,
+ * which keep their defaults if they are not set.
+ * @param parameters Hardware parameters of the hardware interface.
+ * @param enabled Receives true if the loopback parameter is "true".
+ * @param state_rate_hz Receives the rate of the synthetic states.
+ * @return False if a parameter is set but invalid.
+ */
+bool read_loopback(const std::unordered_map<std::string, std::string>& parameters, bool& enabled, int& state_rate_hz);
+
+/**
+ * @brief Apply the name, scheduling policy and CPU affinity to a running thread. Failures are logged, and the thread
+ * keeps running with the default settings, since e.g. SCHED_FIFO needs privileges which are not always granted.
+ * @param thread Thread to configure.
+ * @param name Name of the thread for the log messages.
+ * @param settings Settings to apply.
+ */
+void apply_thread_settings(std::jthread& thread, const std::string& name, const ThreadSettings& settings);
+
+/**
+ * @brief Sleep for a duration, or until a stop is requested.
+ * @return False if the sleep was interrupted by a stop request.
+ */
+bool sleep_unless_stopped(std::stop_token stop_token, std::chrono::milliseconds duration);
+
+}  // namespace spot_hardware_interface
@@ -0,0 +1,81 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace spot_hardware_interface {
+
+class LatencyHistogram {
+  // Histogram of durations with one bucket per power of two microseconds, which is filled by a single thread and can
+  // be read by any thread without locks or allocations. Percentiles are reported as the upper bound of their bucket,
+  // so they are accurate to a factor of two, which is enough to tell a healthy loop from a stalling one.
+ public:
+  static constexpr std::size_t kBuckets = 32;
+
+  // Record one duration. Must only be called from one thread at a time.
+  void record(std::chrono::nanoseconds duration) {
+    const auto us = static_cast<std::uint64_t>(std::max<std::int64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), 0));
+    const auto bucket = std::min<std::size_t>(std::bit_width(us), kBuckets - 1);
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    if (duration.count() > max_ns_.load(std::memory_order_relaxed)) {
+      max_ns_.store(duration.count(), std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Get an upper bound of a percentile of the recorded durations.
+   * @param fraction Fraction of the durations which are at most the returned one, between 0 and 1.
+   * @return The percentile in seconds, or NaN if nothing was recorded.
+   */
+  double percentile(double fraction) const {
+    std::array<std::uint64_t, kBuckets> counts;
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+      counts[i] = buckets_[i].load(std::memory_order_relaxed);
+      total += counts[i];
+    }
+    if (total == 0) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    const auto rank = static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(total)));
+    std::uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+      cumulative += counts[i];
+      if (cumulative >= rank) {
+        // Bucket i holds the durations below 2^i microseconds, and the durations of the last bucket are capped by max.
+        return std::min(static_cast<double>(std::uint64_t{1} << i) * 1e-6, max());
+      }
+    }
+    return max();
+  }
+
+  // Get the longest recorded duration in seconds, or NaN if nothing was recorded.
+  double max() const {
+    const auto max_ns = max_ns_.load(std::memory_order_relaxed);
+    return max_ns < 0 ? std::numeric_limits<double>::quiet_NaN() : static_cast<double>(max_ns) * 1e-9;
+  }
+
+  // Clear the histogram. Must not be called while another thread records durations.
+  void reset() {
+    for (auto& bucket : buckets_) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    max_ns_.store(-1, std::memory_order_relaxed);
+  }
+
+ private:
+  std::array<std::atomic<std::uint64_t>, kBuckets> buckets_{};
+  std::atomic<std::int64_t> max_ns_{-1};
+};
+
+}  // namespace spot_hardware_interface
@@ -0,0 +1,46 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "bosdyn/client/time_sync/time_sync_helpers.h"
+#include "google/protobuf/util/time_util.h"
+
+namespace spot_hardware_interface {
+
+class RobotTimeReference {
+  // Converts between the robot clock and the local monotonic clock without querying the time sync endpoint for every
+  // conversion. The robot time of a local reference time is only refreshed from the endpoint once per refresh period,
+  // when the clock skew may have been updated, and all other times are extrapolated from it.
+ public:
+  static constexpr std::chrono::seconds kRefreshPeriod{1};
+
+  /**
+   * @brief Get the robot time at a local time, refreshing the reference from the endpoint if it is outdated.
+   * @param endpoint Time sync endpoint of the robot.
+   * @param now Current local time.
+   * @return Robot time in nanoseconds.
+   */
+  std::int64_t robot_time_ns(::bosdyn::client::TimeSyncEndpoint& endpoint, std::chrono::steady_clock::time_point now) {
+    if (!valid_ || now - local_ >= kRefreshPeriod) {
+      const auto robot_now = endpoint.GetRobotTimeConverter().RobotTimestampFromLocal(
+          ::bosdyn::common::TimePoint(std::chrono::system_clock::now()));
+      local_ = now;
+      robot_ns_ = google::protobuf::util::TimeUtil::TimestampToNanoseconds(robot_now);
+      valid_ = true;
+    }
+    return robot_ns_ + std::chrono::duration_cast<std::chrono::nanoseconds>(now - local_).count();
+  }
+
+  // Drop the reference, so that it is refreshed on the next conversion.
+  void reset() { valid_ = false; }
+
+ private:
+  std::chrono::steady_clock::time_point local_;
+  std::int64_t robot_ns_ = 0;
+  bool valid_ = false;
+};
+
+}  // namespace spot_hardware_interface
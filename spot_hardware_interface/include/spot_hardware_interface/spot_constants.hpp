@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <array>
+
 namespace spot_hardware_interface {
 
 /// @brief Number of joints we expect if the robot has no arm
@@ -26,4 +28,48 @@ inline constexpr int kNjointsNoArm = 12;
 /// @brief Number of joints we expect if the robot has an arm
 inline constexpr int kNjointsArm = 19;
 
+/// @brief Names of the joints in the order of the joint control API, without a prefix. The arm joints are only
+/// streamed and commanded if the robot has an arm.
+inline constexpr std::array<const char*, kNjointsArm> kJointNames{
+    "front_left_hip_x", "front_left_hip_y",  "front_left_knee", "front_right_hip_x", "front_right_hip_y",
+    "front_right_knee", "rear_left_hip_x",   "rear_left_hip_y", "rear_left_knee",    "rear_right_hip_x",
+    "rear_right_hip_y", "rear_right_knee",   "arm_sh0",         "arm_sh1",           "arm_el0",
+    "arm_el1",          "arm_wr0",           "arm_wr1",         "arm_f1x"};
+
+/// @brief Name of the state interfaces which hold the pose and velocity of the body in the odom frame
+inline constexpr auto kBodyStateName = "body";
+
+/// @brief Names of the body state interfaces, in the order of their values
+inline constexpr std::array<const char*, 13> kBodyStateInterfaces{
+    "position.x",        "position.y",        "position.z",        "orientation.x",    "orientation.y",
+    "orientation.z",     "orientation.w",     "linear_velocity.x", "linear_velocity.y", "linear_velocity.z",
+    "angular_velocity.x", "angular_velocity.y", "angular_velocity.z"};
+
+/// @brief Name of the state interfaces which hold the latest IMU measurement, as expected by imu_sensor_broadcaster
+inline constexpr auto kImuSensorName = "imu_sensor";
+
+/// @brief Names of the IMU state interfaces, in the order of their values
+inline constexpr std::array<const char*, 10> kImuStateInterfaces{
+    "orientation.x",        "orientation.y",        "orientation.z",        "orientation.w",
+    "angular_velocity.x",   "angular_velocity.y",   "angular_velocity.z",   "linear_acceleration.x",
+    "linear_acceleration.y", "linear_acceleration.z"};
+
+/// @brief Name of the state interfaces which hold whether the feet are in contact with the ground
+inline constexpr auto kFootContactName = "foot_contact";
+
+/// @brief Names of the foot contact state interfaces, in the order of the legs in the joint control API. Each is 1 if
+/// the foot is in contact, 0 if it is not, and NaN if the contact is unknown.
+inline constexpr std::array<const char*, 4> kFootContactStateInterfaces{"front_left", "front_right", "rear_left",
+                                                                        "rear_right"};
+
+/// @brief Name of the state interfaces which hold the latency statistics of the control loop
+inline constexpr auto kLatencyName = "latency";
+
+/// @brief Names of the latency state interfaces in seconds, in the order of their values. The state age is the time
+/// from the acquisition of a state on the robot to read(), the loop period is the time between two calls of read(),
+/// and the command latency is the time until the robot acknowledged a joint command.
+inline constexpr std::array<const char*, 9> kLatencyStateInterfaces{
+    "state_age.p50",   "state_age.p99",       "state_age.max",       "loop_period.p50",    "loop_period.p99",
+    "loop_period.max", "command_latency.p50", "command_latency.p99", "command_latency.max"};
+
 }  // namespace spot_hardware_interface
@@ -18,9 +18,19 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
+#include <stop_token>
 #include <string>
 #include <thread>
 #include <vector>
@@ -32,7 +42,12 @@
 #include "rclcpp/macros.hpp"
 #include "rclcpp_lifecycle/node_interfaces/lifecycle_node_interface.hpp"
 #include "rclcpp_lifecycle/state.hpp"
+#include "spot_hardware_interface/command_timing.hpp"
+#include "spot_hardware_interface/hardware_parameters.hpp"
+#include "spot_hardware_interface/latency_histogram.hpp"
+#include "spot_hardware_interface/robot_time_reference.hpp"
 #include "spot_hardware_interface/spot_constants.hpp"
+#include "spot_hardware_interface/triple_buffer.hpp"
 #include "spot_hardware_interface/visibility_control.h"
 
 #include "bosdyn/client/lease/lease_keepalive.h"
@@ -51,50 +66,101 @@ using StateHandler = std::function<void(::bosdyn::api::RobotStateStreamResponse&
 
 namespace spot_hardware_interface {
 
-struct JointStates {
-  // This struct is used to hold a set of joint states of the robot.
-  // The first 12 entries will be the leg joints in the following order:
-  // FL hip x, FL hip y, FL knee, FR hip x, FR hip y, FR knee, RL hip x, RL hip y, RL knee, RR hip x, RR hip y, RR knee
-  // And, if the robot has an arm, the 7 arm joints follow in this order:
-  // sh0, sh1, el0, el1, wr0, wr1, f1x
-  std::vector<float> position;  // in rad
-  std::vector<float> velocity;  // in rad/s
-  std::vector<float> load;      // in Nm
-};
+// Values of every joint of the robot, with room for the arm joints. Only the first njoints entries are used.
+using JointValues = std::array<float, kNjointsArm>;
 
 struct JointCommands {
-  // This struct is used to hold a set of joint commands of the robot.
+  // This struct is used to hold a set of joint commands of the robot, in fixed-size arrays so that the control loop
+  // does not allocate.
   // The first 12 entries will be the leg commands in the following order:
   // FL hip x, FL hip y, FL knee, FR hip x, FR hip y, FR knee, RL hip x, RL hip y, RL knee, RR hip x, RR hip y, RR knee
   // And, if the robot has an arm, the 7 arm commands follow in this order:
   // sh0, sh1, el0, el1, wr0, wr1, f1x
-  std::vector<float> position;  // in rad
-  std::vector<float> velocity;  // in rad/s
-  std::vector<float> load;      // in Nm
-  std::vector<float> k_q_p;
-  std::vector<float> k_qd_p;
+  // Number of joints which are commanded.
+  std::size_t njoints = 0;
+  JointValues position{};  // in rad
+  JointValues velocity{};  // in rad/s
+  JointValues load{};      // in Nm
+  JointValues k_q_p{};
+  JointValues k_qd_p{};
+};
+
+// Pose and velocity of the body in the odom frame, in the order of kBodyStateInterfaces.
+using BodyState = std::array<double, kBodyStateInterfaces.size()>;
+
+// Latest IMU measurement, in the order of kImuStateInterfaces.
+using ImuState = std::array<double, kImuStateInterfaces.size()>;
+
+// Contact of every foot, in the order of kFootContactStateInterfaces.
+using FootContactState = std::array<double, kFootContactStateInterfaces.size()>;
+
+// Latency statistics of the control loop, in the order of kLatencyStateInterfaces.
+using LatencyState = std::array<double, kLatencyStateInterfaces.size()>;
+
+struct StreamedState {
+  // This struct is used to hold one streamed state of the robot, in fixed-size arrays so that it can be passed to the
+  // control loop without allocating.
+  // The first 12 joints will be the leg joints in the following order:
+  // FL hip x, FL hip y, FL knee, FR hip x, FR hip y, FR knee, RL hip x, RL hip y, RL knee, RR hip x, RR hip y, RR knee
+  // And, if the robot has an arm, the 7 arm joints follow in this order:
+  // sh0, sh1, el0, el1, wr0, wr1, f1x
+  // Number of joints in the streamed state, which is zero until the first state was streamed.
+  std::size_t njoints = 0;
+  JointValues position{};  // in rad
+  JointValues velocity{};  // in rad/s
+  JointValues load{};      // in Nm
+  std::optional<BodyState> body_state;
+  std::optional<ImuState> imu_state;
+  std::optional<FootContactState> foot_contact_state;
+  // Time at which the state was acquired on the robot, in the local monotonic clock. Unset without time sync.
+  std::optional<std::chrono::steady_clock::time_point> acquisition_time;
 };
 
 class StateStreamingHandler {
  public:
   /**
-   * @brief Update member variables with the current position, velocity, and load of the robot's joints.
+   * @brief Publish the current position, velocity, and load of the robot's joints, the body state, the IMU
+   * measurement and the foot contacts to the control loop.
    * @param robot_state Robot state protobuf holding the current joint state of the robot.
    */
   void handle_state_streaming(::bosdyn::api::RobotStateStreamResponse& robot_state);
   /**
-   * @brief Get a struct of the current joint states of the robot.
-   * @return JointStates struct containing vectors of position, velocity, and load values.
+   * @brief Get the latest streamed state of the robot. This never blocks or allocates, so it can be called from the
+   * control loop.
+   * @return The latest state, which stays valid until the next call. Its joint count is zero if no state was streamed
+   * yet.
    */
-  void get_joint_states(JointStates& joint_states);
+  const StreamedState& get_latest_state();
+  /**
+   * @brief Set the time sync endpoint which converts the acquisition times of the states into the local clock. Must be
+   * called before the state stream is started.
+   * @param endpoint Time sync endpoint of the robot, or nullptr to leave the acquisition times unset.
+   */
+  void set_time_sync_endpoint(::bosdyn::client::TimeSyncEndpoint* endpoint);
+  /**
+   * @brief Wait until a state was streamed which get_latest_state() did not return yet.
+   * @param timeout Longest time to wait.
+   * @return True if there is a new state, false if the timeout expired.
+   */
+  bool wait_for_new_state(std::chrono::milliseconds timeout);
 
  private:
-  // Stores the current position, velocity, and load of the robot's joints.
-  std::vector<float> current_position_;
-  std::vector<float> current_velocity_;
-  std::vector<float> current_load_;
-  // responsible for ensuring read/writes of joint states do not happen at the same time.
-  std::mutex mutex_;
+  // Passes the streamed states from the state streaming thread to the control loop.
+  TripleBuffer<StreamedState> states_;
+  // Last body state and IMU measurement, which are kept while a response does not contain new ones. Only used by the
+  // state streaming thread.
+  std::optional<BodyState> last_body_state_;
+  std::optional<ImuState> last_imu_state_;
+  std::optional<FootContactState> last_foot_contact_state_;
+  // Converts the acquisition times of the states into the local clock. Only used by the state streaming thread.
+  ::bosdyn::client::TimeSyncEndpoint* time_sync_endpoint_ = nullptr;
+  RobotTimeReference time_reference_;
+  // Number of states which were published and which get_latest_state() consumed. The mutex and condition variable
+  // are only used to wake up wait_for_new_state(), and are never locked by get_latest_state().
+  std::atomic<std::uint64_t> published_states_{0};
+  std::uint64_t consumed_states_ = 0;
+  std::mutex new_state_mutex_;
+  std::condition_variable new_state_;
 };
 
 class SpotHardware : public hardware_interface::SystemInterface {
@@ -140,33 +206,49 @@ class SpotHardware : public hardware_interface::SystemInterface {
   // The 3 state interfaces are position, velocity, and effort.
   static constexpr size_t state_interfaces_per_joint_ = 3;
   size_t njoints_;
+  // Index in the joint control API of every joint, in the order of the joints in the URDF.
+  std::array<std::size_t, kNjointsArm> sdk_joint_index_{};
 
   // Login info
   std::string hostname_;
   std::string username_;
   std::string password_;
-
-  // Stores gains to be used in the joint level command
-  std::vector<float> k_q_p_;
-  std::vector<float> k_qd_p_;
+  // Prepended to the names of the body, IMU, foot contact and latency state interfaces (as "<prefix>/body"), so that
+  // several robots can be controlled by one controller manager. Empty for the unprefixed names.
+  std::string interface_prefix_;
 
   // Power status
   bool powered_on_ = false;
 
-  // Shared BD clients.
+  // If true, synthetic states are streamed and the commands are recorded instead of connecting to a robot.
+  bool loopback_ = false;
+  int loopback_state_rate_hz_ = 333;
+  // Passes the recorded commands from command_thread_ to the synthetic state stream, whose joints follow them.
+  TripleBuffer<JointCommands> loopback_commands_;
+
+  // Shared BD clients. The SDK and its thread pool are shared by all robots of the process, and must outlive robot_.
+  std::shared_ptr<::bosdyn::client::ClientSdk> client_sdk_;
   std::unique_ptr<::bosdyn::client::Robot> robot_;
   ::bosdyn::client::LeaseClient* lease_client_;
   ::bosdyn::client::RobotStateStreamingClient* state_client_;
   ::bosdyn::client::RobotCommandStreamingClient* command_stream_service_;
   ::bosdyn::client::RobotCommandClient* command_client_;
 
-  // Holds joint states of the robot received from the BD SDK
-  JointStates joint_states_;
-  // Holds joint commands for the robot to send to BD SDK
-  JointCommands joint_commands_;
+  // Passes the joint commands from write() to command_thread_, which sends them to the robot through the BD SDK.
+  TripleBuffer<JointCommands> command_mailbox_;
+  // Incremented for every command that write() publishes, and waited on by command_thread_.
+  std::atomic<std::uint64_t> command_sequence_{0};
+  // Thread for sending the joint commands to the robot.
+  std::jthread command_thread_;
 
   // Thread for reading the state of the robot.
   std::jthread state_thread_;
+  // How long read() waits for a new state, or zero to use the latest state without waiting.
+  std::chrono::milliseconds state_wait_timeout_{0};
+  // Names and scheduling of the state and command threads, and the backoff between retries of their failed RPCs.
+  ThreadSettings state_thread_settings_;
+  ThreadSettings command_thread_settings_;
+  RetryBackoff retry_backoff_;
   // Simple class used in the state streaming thread that stores the current joint states of the robot.
   StateStreamingHandler state_streaming_handler_;
   bool state_stream_started_ = false;
@@ -175,9 +257,28 @@ class SpotHardware : public hardware_interface::SystemInterface {
   bool command_stream_started_ = false;
   bool init_state_ = false;
 
+  // Time sync endpoint of the command stream, set by start_command_stream().
   ::bosdyn::client::TimeSyncEndpoint* endpoint_ = nullptr;
 
   ::bosdyn::api::JointControlStreamRequest joint_request_;
+  // Same request as joint_request_, but without gains, which is sent while the gains do not change.
+  ::bosdyn::api::JointControlStreamRequest joint_request_without_gains_;
+  // Gains of the last command that was sent with gains. Only used by command_thread_.
+  JointValues sent_k_q_p_{};
+  JointValues sent_k_qd_p_{};
+  bool gains_sent_ = false;
+  // Robot time from which the end times of the commands are extrapolated, and the extrapolation and end time offset of
+  // the commands picked from their measured latency. Only used by command_thread_.
+  RobotTimeReference time_reference_;
+  CommandTimingBounds command_timing_bounds_;
+  CommandTiming command_timing_;
+
+  // Latency statistics since the last activation. The command latency is recorded by command_thread_, and the others
+  // by read().
+  LatencyHistogram state_age_;
+  LatencyHistogram loop_period_;
+  LatencyHistogram command_latency_;
+  std::optional<std::chrono::steady_clock::time_point> last_read_time_;
 
   // The following are functions that interact with the BD SDK to set up the robot and get the robot states.
 
@@ -190,10 +291,18 @@ class SpotHardware : public hardware_interface::SystemInterface {
    */
   bool authenticate_robot(const std::string& hostname, const std::string& username, const std::string& password);
   /**
-   * @brief Start time sync threads with the ::bosdyn::client::Robot object
+   * @brief Start time sync threads with the ::bosdyn::client::Robot object, and get the time sync endpoint used by the
+   * state and command streams.
+   * @param synced Becomes true once the clocks are synchronized, or false if that times out. Waiting is left to the
+   * caller, so that the robot can be set up further in the meantime.
    * @return True if time sync successfully initialized and started, false otherwise.
    */
-  bool start_time_sync();
+  bool start_time_sync(std::future<bool>& synced);
+  /**
+   * @brief Look up the services of the robot and create the clients for the state stream, the lease and the commands.
+   * @return True if all clients were created, false otherwise.
+   */
+  bool create_service_clients();
   /**
    * @brief Check the estop status of the robot
    * @return True if robot is not e-stopped, false otherwise.
@@ -228,6 +337,32 @@ class SpotHardware : public hardware_interface::SystemInterface {
    * @brief Release the body lease of the robot.
    */
   void release_lease();
+  /**
+   * @brief Map the joints of the URDF to the joints of the joint control API by name, ignoring any prefix. If a joint
+   * is not known, the joints of the URDF are assumed to be in the order of the joint control API.
+   */
+  void map_joints();
+  /**
+   * @brief Stream synthetic states at loopback_state_rate_hz_ instead of the states of a robot.
+   * @return True if the state stream thread was successfully created, false otherwise.
+   */
+  bool start_loopback_state_stream();
+  /**
+   * @brief Publish a synthetic state, whose joints are at the last recorded command, once per period until a stop is
+   * requested. Runs on state_thread_.
+   * @param stop_token Stops the loop.
+   */
+  void loopback_state_loop(std::stop_token stop_token);
+  /**
+   * @brief Record a joint command instead of sending it to a robot, so that the synthetic states follow it.
+   * @param request Joint command request which would have been sent.
+   */
+  void record_loopback_command(const ::bosdyn::api::JointControlStreamRequest& request);
+  /**
+   * @brief Add the time sync endpoint to the command client, and switch the robot to joint control mode.
+   * @return True if the robot accepts joint commands, false otherwise.
+   */
+  bool connect_command_stream();
   /**
    * @brief Start streaming commands to the robot, and attach a callback to it
    * @return True if command stream clients were successfully created, false otherwise.
@@ -240,12 +375,30 @@ class SpotHardware : public hardware_interface::SystemInterface {
   /**
    * @brief Send a joint command to the robot.
    * @param joint_commands contains position, velocity, and load
+   * @return True if the command was sent, false otherwise.
+   */
+  bool send_command(const JointCommands& joint_commands);
+  /**
+   * @brief Send the latest joint command from write() whenever a new one arrives, until a stop is requested. Runs on
+   * command_thread_, so that the RPC latency does not stall the control loop.
+   * @param stop_token Stops the loop.
+   */
+  void command_send_loop(std::stop_token stop_token);
+  /**
+   * @brief Record the age of the state and the loop period in read(), and update the latency state interfaces.
+   * @param state Latest streamed state, which read() is about to use.
    */
-  void send_command(const JointCommands& joint_commands);
+  void update_latency_states(const StreamedState& state);
 
   // Vectors for storing the commands and states for the robot.
   std::vector<double> hw_commands_;
   std::vector<double> hw_states_;
+  // Values of the body, IMU and foot contact state interfaces, which are NaN until they are first streamed.
+  BodyState hw_body_states_;
+  ImuState hw_imu_states_;
+  FootContactState hw_foot_contact_states_;
+  // Values of the latency state interfaces, which are NaN until the first durations are recorded.
+  LatencyState hw_latency_states_;
 };
 
 }  // namespace spot_hardware_interface
@@ -0,0 +1,30 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <cstdint>
+
+namespace spot_hardware_interface::tracing {
+
+// Emit the spot_hardware_interface:stage_begin and stage_end LTTng tracepoints around a stage of the control loop or of
+// its state and command threads, so that they can be shown next to the tracepoints of ros2_tracing in one timeline.
+// If LTTng was not found when the hardware interface was built, or no tracing session enables the events, this costs a
+// function call. The id relates the stages of the same state or command, or is 0.
+void stage_begin(const char* stage, std::uint64_t id = 0);
+void stage_end(const char* stage, std::uint64_t id = 0);
+
+// Traces a stage from its construction to its destruction. The stage name must outlive it.
+class ScopedStage {
+ public:
+  explicit ScopedStage(const char* stage, std::uint64_t id = 0) : stage_{stage}, id_{id} { stage_begin(stage_, id_); }
+  ~ScopedStage() { stage_end(stage_, id_); }
+
+  ScopedStage(const ScopedStage&) = delete;
+  ScopedStage& operator=(const ScopedStage&) = delete;
+
+ private:
+  const char* stage_;
+  std::uint64_t id_;
+};
+
+}  // namespace spot_hardware_interface::tracing
@@ -0,0 +1,54 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace spot_hardware_interface {
+
+/**
+ * @brief Wait-free buffer which passes the latest value from a single producer thread to a single consumer thread.
+ * @details The producer fills the write buffer and publishes it, and the consumer swaps the latest published buffer in
+ * as its read buffer. Neither side ever waits for the other, and no memory is allocated after construction, so it is
+ * safe to use from a real-time loop. Values which are published faster than they are consumed are dropped.
+ */
+template <typename T>
+class TripleBuffer {
+ public:
+  /** @brief Get the buffer which the producer fills before calling publish(). */
+  T& write_buffer() { return buffers_[write_index_]; }
+
+  /** @brief Make the write buffer the latest value, and take the previous latest buffer as the next write buffer. */
+  void publish() { write_index_ = latest_.exchange(write_index_ | kFresh, std::memory_order_acq_rel) & kIndexMask; }
+
+  /**
+   * @brief Swap the latest published value in as the read buffer, if a new one was published since the last call.
+   * @return True if the read buffer was updated.
+   */
+  bool update() {
+    if ((latest_.load(std::memory_order_relaxed) & kFresh) == 0) {
+      return false;
+    }
+    read_index_ = latest_.exchange(read_index_, std::memory_order_acq_rel) & kIndexMask;
+    return true;
+  }
+
+  /** @brief Get the buffer which the consumer reads, which holds the value of the last successful update(). */
+  const T& read_buffer() const { return buffers_[read_index_]; }
+
+ private:
+  // latest_ holds the index of the latest buffer, and the kFresh flag if the consumer did not take it yet.
+  static constexpr std::uint8_t kIndexMask = 0x3;
+  static constexpr std::uint8_t kFresh = 0x4;
+
+  std::array<T, 3> buffers_{};
+  // Only used by the producer
+  std::uint8_t write_index_{0};
+  std::atomic<std::uint8_t> latest_{1};
+  // Only used by the consumer
+  std::uint8_t read_index_{2};
+};
+
+}  // namespace spot_hardware_interface
@@ -0,0 +1,200 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include "spot_hardware_interface/hardware_parameters.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+#include "rclcpp/rclcpp.hpp"
+
+namespace spot_hardware_interface {
+
+namespace {
+// Parse an integer hardware parameter. Returns nullopt if it is not set, and logs and returns false through valid if
+// it is not an integer within [min, max].
+std::optional<int> read_int_parameter(const std::unordered_map<std::string, std::string>& parameters,
+                                      const std::string& name, int min, int max, bool& valid) {
+  const auto it = parameters.find(name);
+  if (it == parameters.end() || it->second.empty()) {
+    return std::nullopt;
+  }
+  try {
+    std::size_t parsed = 0;
+    const int value = std::stoi(it->second, &parsed);
+    if (parsed == it->second.size() && value >= min && value <= max) {
+      return value;
+    }
+  } catch (const std::logic_error&) {
+  }
+  RCLCPP_FATAL(rclcpp::get_logger("SpotHardware"), "Hardware parameter '%s' is '%s', but must be between %d and %d.",
+               name.c_str(), it->second.c_str(), min, max);
+  valid = false;
+  return std::nullopt;
+}
+
+// Parse a CPU number within [0, CPU_SETSIZE).
+std::optional<int> parse_cpu(const std::string_view text) {
+  int cpu = 0;
+  const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), cpu);
+  if (error != std::errc{} || end != text.data() + text.size() || cpu < 0 || cpu >= CPU_SETSIZE) {
+    return std::nullopt;
+  }
+  return cpu;
+}
+
+// Parse a list of CPUs in the format of taskset, e.g. "2,3" or "4-7", where -1 stands for any CPU. Returns nullopt if
+// the parameter is not set, and logs and returns false through valid if it is malformed.
+std::optional<std::vector<int>> read_cpu_list_parameter(const std::unordered_map<std::string, std::string>& parameters,
+                                                        const std::string& name, bool& valid) {
+  const auto it = parameters.find(name);
+  if (it == parameters.end() || it->second.empty()) {
+    return std::nullopt;
+  }
+  std::vector<int> cpus;
+  if (it->second == "-1") {
+    return cpus;
+  }
+  std::string_view list{it->second};
+  for (auto comma = std::string_view::size_type{0}; comma != std::string_view::npos;) {
+    comma = list.find(',');
+    const auto item = list.substr(0, comma);
+    list.remove_prefix(comma == std::string_view::npos ? list.size() : comma + 1);
+    const auto dash = item.find('-');
+    const auto first = parse_cpu(item.substr(0, dash));
+    const auto last = dash == std::string_view::npos ? first : parse_cpu(item.substr(dash + 1));
+    if (!first || !last || *last < *first) {
+      RCLCPP_FATAL(rclcpp::get_logger("SpotHardware"),
+                   "Hardware parameter '%s' is '%s', but must be -1 or a list of CPUs below %d such as '2,3' or '4-7'.",
+                   name.c_str(), it->second.c_str(), CPU_SETSIZE);
+      valid = false;
+      return std::nullopt;
+    }
+    for (int cpu = *first; cpu <= *last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+}  // namespace
+
+bool read_thread_settings(const std::unordered_map<std::string, std::string>& parameters, const std::string& prefix,
+                          ThreadSettings& settings) {
+  bool valid = true;
+  settings.priority =
+      read_int_parameter(parameters, prefix + "_priority", 0, sched_get_priority_max(SCHED_FIFO), valid)
+          .value_or(settings.priority);
+  settings.cpus = read_cpu_list_parameter(parameters, prefix + "_cpu", valid).value_or(settings.cpus);
+  return valid;
+}
+
+bool read_retry_backoff(const std::unordered_map<std::string, std::string>& parameters, RetryBackoff& backoff) {
+  bool valid = true;
+  const auto initial = read_int_parameter(parameters, "retry_initial_delay_ms", 1, 60000, valid);
+  const auto max = read_int_parameter(parameters, "retry_max_delay_ms", 1, 60000, valid);
+  backoff.initial = initial ? std::chrono::milliseconds{*initial} : backoff.initial;
+  backoff.max = max ? std::chrono::milliseconds{*max} : backoff.max;
+  if (backoff.max < backoff.initial) {
+    RCLCPP_FATAL(rclcpp::get_logger("SpotHardware"),
+                 "Hardware parameter 'retry_max_delay_ms' must not be less than 'retry_initial_delay_ms'.");
+    return false;
+  }
+  return valid;
+}
+
+bool read_command_timing_bounds(const std::unordered_map<std::string, std::string>& parameters,
+                                CommandTimingBounds& bounds) {
+  bool valid = true;
+  const auto read_ms = [&](const std::string& name, int min, std::chrono::milliseconds& value) {
+    value = std::chrono::milliseconds{read_int_parameter(parameters, name, min, 1000, valid).value_or(value.count())};
+  };
+  read_ms("command_extrapolation_min_ms", 0, bounds.min_extrapolation);
+  read_ms("command_extrapolation_max_ms", 0, bounds.max_extrapolation);
+  read_ms("command_end_time_min_ms", 1, bounds.min_end_time);
+  read_ms("command_end_time_max_ms", 1, bounds.max_end_time);
+  if (bounds.max_extrapolation < bounds.min_extrapolation) {
+    RCLCPP_FATAL(rclcpp::get_logger("SpotHardware"),
+                 "Hardware parameter 'command_extrapolation_max_ms' must not be less than "
+                 "'command_extrapolation_min_ms'.");
+    return false;
+  }
+  if (bounds.max_end_time < bounds.min_end_time) {
+    RCLCPP_FATAL(rclcpp::get_logger("SpotHardware"),
+                 "Hardware parameter 'command_end_time_max_ms' must not be less than 'command_end_time_min_ms'.");
+    return false;
+  }
+  return valid;
+}
+
+bool read_state_wait_timeout(const std::unordered_map<std::string, std::string>& parameters,
+                             std::chrono::milliseconds& timeout) {
+  bool valid = true;
+  const auto timeout_ms = read_int_parameter(parameters, "state_wait_timeout_ms", 0, 1000, valid);
+  timeout = timeout_ms ? std::chrono::milliseconds{*timeout_ms} : timeout;
+  return valid;
+}
+
+bool read_loopback(const std::unordered_map<std::string, std::string>& parameters, bool& enabled, int& state_rate_hz) {
+  bool valid = true;
+  if (const auto it = parameters.find("loopback"); it != parameters.end() && !it->second.empty()) {
+    if (it->second != "true" && it->second != "false") {
+      RCLCPP_FATAL(rclcpp::get_logger("SpotHardware"),
+                   "Hardware parameter 'loopback' is '%s', but must be true or false.", it->second.c_str());
+      valid = false;
+    }
+    enabled = it->second == "true";
+  }
+  state_rate_hz = read_int_parameter(parameters, "loopback_state_rate_hz", 1, 10000, valid).value_or(state_rate_hz);
+  return valid;
+}
+
+void apply_thread_settings(std::jthread& thread, const std::string& name, const ThreadSettings& settings) {
+  const auto handle = thread.native_handle();
+  if (!settings.name.empty()) {
+    // Linux limits thread names to 15 characters plus the terminating null character.
+    const auto thread_name = settings.name.substr(0, 15);
+    if (const int error = pthread_setname_np(handle, thread_name.c_str()); error != 0) {
+      RCLCPP_WARN(rclcpp::get_logger("SpotHardware"), "Could not name the %s thread '%s': %s", name.c_str(),
+                  thread_name.c_str(), std::strerror(error));
+    }
+  }
+  if (settings.priority > 0) {
+    sched_param param{};
+    param.sched_priority = settings.priority;
+    if (const int error = pthread_setschedparam(handle, SCHED_FIFO, &param); error != 0) {
+      RCLCPP_WARN(rclcpp::get_logger("SpotHardware"), "Could not run the %s thread with SCHED_FIFO priority %d: %s",
+                  name.c_str(), settings.priority, std::strerror(error));
+    }
+  }
+  if (!settings.cpus.empty()) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (const int cpu : settings.cpus) {
+      CPU_SET(cpu, &cpus);
+    }
+    if (const int error = pthread_setaffinity_np(handle, sizeof(cpus), &cpus); error != 0) {
+      RCLCPP_WARN(rclcpp::get_logger("SpotHardware"), "Could not pin the %s thread to its %zu CPUs: %s", name.c_str(),
+                  settings.cpus.size(), std::strerror(error));
+    }
+  }
+}
+
+bool sleep_unless_stopped(std::stop_token stop_token, std::chrono::milliseconds duration) {
+  // Only the stop request wakes the condition variable up, so the mutex is never contended.
+  std::mutex mutex;
+  std::condition_variable_any stopped;
+  std::unique_lock lock{mutex};
+  stopped.wait_for(lock, stop_token, duration, [] {
+    return false;
+  });
+  return !stop_token.stop_requested();
+}
+
+}  // namespace spot_hardware_interface
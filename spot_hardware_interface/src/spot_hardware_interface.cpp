@@ -18,37 +18,142 @@
 
 #include "spot_hardware_interface/spot_hardware_interface.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <future>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include "google/protobuf/util/time_util.h"
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
 #include "rclcpp/rclcpp.hpp"
+#include "spot_hardware_interface/tracing.hpp"
 
 namespace spot_hardware_interface {
 
+namespace {
+// Returns the Client SDK of this process, so that every robot controlled by the controller manager shares one SDK
+// and its thread pool. It lives as long as a robot holds it, and is created again after all released it.
+std::shared_ptr<::bosdyn::client::ClientSdk> shared_client_sdk() {
+  static std::mutex mutex;
+  static std::weak_ptr<::bosdyn::client::ClientSdk> weak_sdk;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto sdk = weak_sdk.lock();
+  if (!sdk) {
+    sdk = ::bosdyn::client::CreateStandardSDK("SpotHardware");
+    weak_sdk = sdk;
+  }
+  return sdk;
+}
+
+// Errors of the control and stream loops repeat every cycle while the robot is unreachable, so they are logged at most
+// once per this period.
+constexpr int kFailureLogPeriodMs = 5000;
+
+// Clock of the throttled logs, which must not depend on the ROS time of the controller manager.
+rclcpp::Clock& throttle_clock() {
+  static rclcpp::Clock clock{RCL_STEADY_TIME};
+  return clock;
+}
+}  // namespace
+
 void StateStreamingHandler::handle_state_streaming(::bosdyn::api::RobotStateStreamResponse& robot_state) {
-  // lock so that read/write doesn't happen at the same time
-  const std::lock_guard<std::mutex> lock(mutex_);
-  // Get joint states from the robot and write them to the joint_states_ struct
+  // The state is written into the buffer which the control loop does not read, and then published to it, so that
+  // read() never waits for this thread.
+  auto& state = states_.write_buffer();
+  // Get joint states from the robot and write them to the streamed state
   const auto& position_msg = robot_state.joint_states().position();
   const auto& velocity_msg = robot_state.joint_states().velocity();
   const auto& load_msg = robot_state.joint_states().load();
-  current_position_.assign(position_msg.begin(), position_msg.end());
-  current_velocity_.assign(velocity_msg.begin(), velocity_msg.end());
-  current_load_.assign(load_msg.begin(), load_msg.end());
+  // Only the joints with a position, velocity and load which fit into the arrays are copied, and the joint count is
+  // that of the copied joints. If a message has mismatched fields, that count differs from the configured joints, and
+  // read() logs RCLCPP_FATAL and returns ERROR instead of reading stale values.
+  state.njoints = std::min({state.position.size(), static_cast<std::size_t>(position_msg.size()),
+                            static_cast<std::size_t>(velocity_msg.size()), static_cast<std::size_t>(load_msg.size())});
+  for (std::size_t i = 0; i < state.njoints; ++i) {
+    state.position[i] = position_msg.Get(static_cast<int>(i));
+    state.velocity[i] = velocity_msg.Get(static_cast<int>(i));
+    state.load[i] = load_msg.Get(static_cast<int>(i));
+  }
+  // Get the odometry of the body, which is streamed at the same rate as the joint states
+  if (robot_state.has_kinematic_state()) {
+    const auto& pose = robot_state.kinematic_state().odom_tform_body();
+    const auto& velocity = robot_state.kinematic_state().body_velocity_in_odom();
+    last_body_state_ = BodyState{pose.position().x(),   pose.position().y(),   pose.position().z(),
+                                 pose.rotation().x(),   pose.rotation().y(),   pose.rotation().z(),
+                                 pose.rotation().w(),   velocity.linear().x(), velocity.linear().y(),
+                                 velocity.linear().z(), velocity.angular().x(), velocity.angular().y(),
+                                 velocity.angular().z()};
+  }
+  // The IMU is sampled faster than the state is streamed, so only the latest of the packets in a response is kept
+  if (robot_state.has_inertial_state() && robot_state.inertial_state().packets_size() > 0) {
+    const auto& packets = robot_state.inertial_state().packets();
+    const auto& packet = packets.Get(packets.size() - 1);
+    const auto& orientation = packet.odom_rot_link();
+    const auto& angular_velocity = packet.angular_velocity_rt_odom_in_link_frame();
+    const auto& acceleration = packet.acceleration_rt_odom_in_link_frame();
+    last_imu_state_ = ImuState{orientation.x(),      orientation.y(),      orientation.z(),      orientation.w(),
+                               angular_velocity.x(), angular_velocity.y(), angular_velocity.z(), acceleration.x(),
+                               acceleration.y(),     acceleration.z()};
+  }
+  // The contacts are streamed for every leg, in the order of the legs in the joint control API
+  if (robot_state.contact_states_size() == static_cast<int>(kFootContactStateInterfaces.size())) {
+    FootContactState contacts;
+    for (std::size_t i = 0; i < contacts.size(); ++i) {
+      const auto contact = robot_state.contact_states(static_cast<int>(i));
+      contacts[i] = contact == ::bosdyn::api::FootState::CONTACT_MADE   ? 1.0
+                    : contact == ::bosdyn::api::FootState::CONTACT_LOST ? 0.0
+                                                                        : std::numeric_limits<double>::quiet_NaN();
+    }
+    last_foot_contact_state_ = contacts;
+  }
+  state.body_state = last_body_state_;
+  state.imu_state = last_imu_state_;
+  state.foot_contact_state = last_foot_contact_state_;
+  // The acquisition time is converted with the robot time of now, so it does not depend on the clock skew of the
+  // acquisition time itself.
+  state.acquisition_time.reset();
+  if (time_sync_endpoint_ != nullptr && robot_state.joint_states().has_acquisition_timestamp()) {
+    const auto now = std::chrono::steady_clock::now();
+    const auto age_ns = time_reference_.robot_time_ns(*time_sync_endpoint_, now) -
+                        google::protobuf::util::TimeUtil::TimestampToNanoseconds(
+                            robot_state.joint_states().acquisition_timestamp());
+    state.acquisition_time = now - std::chrono::nanoseconds{age_ns};
+  }
+  states_.publish();
+  {
+    // The count is increased under the mutex, so that a waiting read() cannot miss the notification.
+    std::lock_guard lock{new_state_mutex_};
+    published_states_.fetch_add(1, std::memory_order_release);
+  }
+  new_state_.notify_one();
+}
+
+const StreamedState& StateStreamingHandler::get_latest_state() {
+  // The count is taken before the update, so a state which is published in between is reported as new by the next
+  // wait_for_new_state() even though it was already consumed here.
+  consumed_states_ = published_states_.load(std::memory_order_acquire);
+  states_.update();
+  return states_.read_buffer();
 }
 
-void StateStreamingHandler::get_joint_states(JointStates& joint_states) {
-  // lock so that read/write doesn't happen at the same time
-  const std::lock_guard<std::mutex> lock(mutex_);
-  // Fill in members of the joint states stuct passed in by reference.
-  joint_states.position.assign(current_position_.begin(), current_position_.end());
-  joint_states.velocity.assign(current_velocity_.begin(), current_velocity_.end());
-  joint_states.load.assign(current_load_.begin(), current_load_.end());
+bool StateStreamingHandler::wait_for_new_state(std::chrono::milliseconds timeout) {
+  if (published_states_.load(std::memory_order_acquire) != consumed_states_) {
+    return true;
+  }
+  std::unique_lock lock{new_state_mutex_};
+  return new_state_.wait_for(lock, timeout, [this] {
+    return published_states_.load(std::memory_order_acquire) != consumed_states_;
+  });
+}
+
+void StateStreamingHandler::set_time_sync_endpoint(::bosdyn::client::TimeSyncEndpoint* endpoint) {
+  time_sync_endpoint_ = endpoint;
+  time_reference_.reset();
 }
 
 hardware_interface::CallbackReturn SpotHardware::on_init(const hardware_interface::HardwareInfo& info) {
@@ -59,11 +164,35 @@ hardware_interface::CallbackReturn SpotHardware::on_init(const hardware_interfac
   hostname_ = info_.hardware_parameters["hostname"];
   username_ = info_.hardware_parameters["username"];
   password_ = info_.hardware_parameters["password"];
+  interface_prefix_ = info_.hardware_parameters["interface_prefix"];
+  // Names and scheduling of the threads which talk to the robot, and the backoff between retries of their failed RPCs
+  state_thread_settings_.name = "spot_hw_state";
+  command_thread_settings_.name = "spot_hw_command";
+  if (!read_thread_settings(info_.hardware_parameters, "state_thread", state_thread_settings_) ||
+      !read_thread_settings(info_.hardware_parameters, "command_thread", command_thread_settings_) ||
+      !read_retry_backoff(info_.hardware_parameters, retry_backoff_) ||
+      !read_command_timing_bounds(info_.hardware_parameters, command_timing_bounds_) ||
+      !read_state_wait_timeout(info_.hardware_parameters, state_wait_timeout_) ||
+      !read_loopback(info_.hardware_parameters, loopback_, loopback_state_rate_hz_)) {
+    return hardware_interface::CallbackReturn::ERROR;
+  }
 
   hw_states_.resize(info_.joints.size() * state_interfaces_per_joint_, std::numeric_limits<double>::quiet_NaN());
   hw_commands_.resize(info_.joints.size() * command_interfaces_per_joint_, std::numeric_limits<double>::quiet_NaN());
 
   njoints_ = hw_states_.size() / state_interfaces_per_joint_;
+  if (njoints_ > static_cast<std::size_t>(kNjointsArm)) {
+    RCLCPP_FATAL(rclcpp::get_logger("SpotHardware"), "%zu joints were configured, but Spot has at most %d.", njoints_,
+                 kNjointsArm);
+    return hardware_interface::CallbackReturn::ERROR;
+  }
+
+  map_joints();
+
+  hw_body_states_.fill(std::numeric_limits<double>::quiet_NaN());
+  hw_imu_states_.fill(std::numeric_limits<double>::quiet_NaN());
+  hw_foot_contact_states_.fill(std::numeric_limits<double>::quiet_NaN());
+  hw_latency_states_.fill(std::numeric_limits<double>::quiet_NaN());
 
   for (const hardware_interface::ComponentInfo& joint : info_.joints) {
     // First check command interfaces
@@ -134,16 +263,23 @@ hardware_interface::CallbackReturn SpotHardware::on_configure(const rclcpp_lifec
   // reset values always when configuring hardware
   hw_states_.assign(hw_states_.size(), 0);
   hw_commands_.assign(hw_commands_.size(), 0);
-  // allocate the sizes of these vectors ahead of time
-  joint_states_.position.assign(njoints_, 0);
-  joint_states_.velocity.assign(njoints_, 0);
-  joint_states_.load.assign(njoints_, 0);
+
+  // The loopback backend streams synthetic states instead of connecting to a robot.
+  if (loopback_) {
+    return start_loopback_state_stream() ? hardware_interface::CallbackReturn::SUCCESS
+                                         : hardware_interface::CallbackReturn::ERROR;
+  }
 
   // Set up the robot using the BD SDK and start command streaming.
   if (!authenticate_robot(hostname_, username_, password_)) {
     return hardware_interface::CallbackReturn::ERROR;
   }
-  if (!start_time_sync()) {
+  // The clocks synchronize in the background while the service clients are created.
+  std::future<bool> time_synced;
+  if (!start_time_sync(time_synced)) {
+    return hardware_interface::CallbackReturn::ERROR;
+  }
+  if (!create_service_clients() || !time_synced.get()) {
     return hardware_interface::CallbackReturn::ERROR;
   }
   if (!start_state_stream(std::bind(&StateStreamingHandler::handle_state_streaming, &state_streaming_handler_,
@@ -155,6 +291,10 @@ hardware_interface::CallbackReturn SpotHardware::on_configure(const rclcpp_lifec
 }
 
 hardware_interface::CallbackReturn SpotHardware::on_activate(const rclcpp_lifecycle::State& /*previous_state*/) {
+  if (loopback_) {
+    return start_command_stream() ? hardware_interface::CallbackReturn::SUCCESS
+                                  : hardware_interface::CallbackReturn::ERROR;
+  }
   if (!check_estop()) {
     return hardware_interface::CallbackReturn::ERROR;
   }
@@ -173,13 +313,6 @@ hardware_interface::CallbackReturn SpotHardware::on_activate(const rclcpp_lifecy
     return hardware_interface::CallbackReturn::ERROR;
   }
 
-  // Set up command_states struct, initialized to zeros
-  joint_commands_.position = std::vector<float>(info_.joints.size(), 0.0);
-  joint_commands_.velocity = std::vector<float>(info_.joints.size(), 0.0);
-  joint_commands_.load = std::vector<float>(info_.joints.size(), 0.0);
-  joint_commands_.k_q_p = std::vector<float>(info_.joints.size(), 0.0);
-  joint_commands_.k_qd_p = std::vector<float>(info_.joints.size(), 0.0);
-
   return hardware_interface::CallbackReturn::SUCCESS;
 }
 
@@ -194,6 +327,27 @@ std::vector<hardware_interface::StateInterface> SpotHardware::export_state_inter
     state_interfaces.emplace_back(hardware_interface::StateInterface(joint.name, hardware_interface::HW_IF_EFFORT,
                                                                      &hw_states_[state_interfaces_per_joint_ * i + 2]));
   }
+  // The body odometry and IMU are not part of the URDF, so they are always exported under fixed names, which are
+  // prefixed to tell several robots apart.
+  const auto prefixed = [this](const char* name) {
+    return interface_prefix_.empty() ? std::string{name} : interface_prefix_ + "/" + name;
+  };
+  for (size_t i = 0; i < kBodyStateInterfaces.size(); i++) {
+    state_interfaces.emplace_back(
+        hardware_interface::StateInterface(prefixed(kBodyStateName), kBodyStateInterfaces[i], &hw_body_states_[i]));
+  }
+  for (size_t i = 0; i < kImuStateInterfaces.size(); i++) {
+    state_interfaces.emplace_back(
+        hardware_interface::StateInterface(prefixed(kImuSensorName), kImuStateInterfaces[i], &hw_imu_states_[i]));
+  }
+  for (size_t i = 0; i < kFootContactStateInterfaces.size(); i++) {
+    state_interfaces.emplace_back(hardware_interface::StateInterface(
+        prefixed(kFootContactName), kFootContactStateInterfaces[i], &hw_foot_contact_states_[i]));
+  }
+  for (size_t i = 0; i < kLatencyStateInterfaces.size(); i++) {
+    state_interfaces.emplace_back(
+        hardware_interface::StateInterface(prefixed(kLatencyName), kLatencyStateInterfaces[i], &hw_latency_states_[i]));
+  }
   return state_interfaces;
 }
 
@@ -217,6 +371,9 @@ std::vector<hardware_interface::CommandInterface> SpotHardware::export_command_i
 
 hardware_interface::CallbackReturn SpotHardware::on_deactivate(const rclcpp_lifecycle::State& /*previous_state*/) {
   stop_command_stream();
+  if (loopback_) {
+    return hardware_interface::CallbackReturn::SUCCESS;
+  }
   release_lease();
   return hardware_interface::CallbackReturn::SUCCESS;
 }
@@ -224,6 +381,9 @@ hardware_interface::CallbackReturn SpotHardware::on_deactivate(const rclcpp_life
 hardware_interface::CallbackReturn SpotHardware::on_shutdown(const rclcpp_lifecycle::State& /*previous_state*/) {
   stop_state_stream();
   stop_command_stream();
+  if (loopback_) {
+    return hardware_interface::CallbackReturn::SUCCESS;
+  }
   release_lease();
   if (!power_off()) {
     return hardware_interface::CallbackReturn::ERROR;
@@ -237,29 +397,44 @@ hardware_interface::CallbackReturn SpotHardware::on_cleanup(const rclcpp_lifecyc
 }
 
 hardware_interface::return_type SpotHardware::read(const rclcpp::Time& /*time*/, const rclcpp::Duration& /*period*/) {
-  state_streaming_handler_.get_joint_states(joint_states_);
-  const auto& joint_pos = joint_states_.position;
-  const auto& joint_vel = joint_states_.velocity;
-  const auto& joint_load = joint_states_.load;
+  // Waiting for a new state aligns the control loop with the state stream, if the controller manager runs at least as
+  // fast as the stream. If no new state arrives in time, the latest one is used again.
+  if (state_wait_timeout_.count() > 0) {
+    tracing::stage_begin("wait_for_state");
+    state_streaming_handler_.wait_for_new_state(state_wait_timeout_);
+    tracing::stage_end("wait_for_state");
+  }
+  const tracing::ScopedStage trace{"read"};
+  const auto& state = state_streaming_handler_.get_latest_state();
+  update_latency_states(state);
+  // The body, IMU and foot contact states keep their last values (or NaN) until they are streamed
+  if (state.body_state) {
+    hw_body_states_ = *state.body_state;
+  }
+  if (state.imu_state) {
+    hw_imu_states_ = *state.imu_state;
+  }
+  if (state.foot_contact_state) {
+    hw_foot_contact_states_ = *state.foot_contact_state;
+  }
   // wait for them to be initialized
-  if (joint_pos.empty() || joint_vel.empty() || joint_load.empty()) {
+  if (state.njoints == 0) {
     return hardware_interface::return_type::OK;
   }
   // Ensure that the states received from the Spot SDK will fit into the hw_states_ vector
-  const auto states_size = hw_states_.size();
-  if (state_interfaces_per_joint_ * joint_pos.size() != states_size ||
-      state_interfaces_per_joint_ * joint_vel.size() != states_size ||
-      state_interfaces_per_joint_ * joint_load.size() != states_size) {
+  if (state_interfaces_per_joint_ * state.njoints != hw_states_.size()) {
     RCLCPP_FATAL(
         rclcpp::get_logger("SpotHardware"),
         "The number of joints and interfaces does not match with the outputted joint states from the Spot SDK!");
     return hardware_interface::return_type::ERROR;
   }
-  // Read values into joint states
-  for (size_t i = 0; i < joint_pos.size(); ++i) {
-    hw_states_.at(i * state_interfaces_per_joint_) = joint_pos.at(i);
-    hw_states_.at(i * state_interfaces_per_joint_ + 1) = joint_vel.at(i);
-    hw_states_.at(i * state_interfaces_per_joint_ + 2) = joint_load.at(i);
+  // Read values into joint states, gathering them from the order of the joint control API into the order of the URDF
+  for (size_t i = 0; i < state.njoints; ++i) {
+    const auto sdk_index = sdk_joint_index_[i];
+    double* joint_states = &hw_states_[i * state_interfaces_per_joint_];
+    joint_states[0] = state.position[sdk_index];
+    joint_states[1] = state.velocity[sdk_index];
+    joint_states[2] = state.load[sdk_index];
   }
 
   // Fill in the initial command values
@@ -283,18 +458,31 @@ hardware_interface::return_type SpotHardware::read(const rclcpp::Time& /*time*/,
 hardware_interface::return_type SpotHardware::write(const rclcpp::Time& /*time*/, const rclcpp::Duration& /*period*/) {
   // This function will be responsible for sending commands to the robot via the BD SDK -- currently unimplemented.
   if (!command_stream_started_) {
-    RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Command streaming was not started");
+    RCLCPP_ERROR_THROTTLE(rclcpp::get_logger("SpotHardware"), throttle_clock(), kFailureLogPeriodMs,
+                          "Command streaming was not started");
     return hardware_interface::return_type::ERROR;
   }
 
-  for (std::size_t i = 0; i < info_.joints.size(); ++i) {
-    joint_commands_.position.at(i) = hw_commands_[command_interfaces_per_joint_ * i];
-    joint_commands_.velocity.at(i) = hw_commands_[command_interfaces_per_joint_ * i + 1];
-    joint_commands_.load.at(i) = hw_commands_[command_interfaces_per_joint_ * i + 2];
-    joint_commands_.k_q_p.at(i) = hw_commands_[command_interfaces_per_joint_ * i + 3];
-    joint_commands_.k_qd_p.at(i) = hw_commands_[command_interfaces_per_joint_ * i + 4];
-  }
-  send_command(joint_commands_);
+  // The command is only handed to command_thread_ here, which sends it to the robot, so that write() never waits for
+  // the RPC. If the previous command was not sent yet, it is replaced by this one. The sequence number of the command
+  // relates write() to the send of the command in a trace.
+  const tracing::ScopedStage trace{"write", command_sequence_.load(std::memory_order_relaxed) + 1};
+  auto& joint_commands = command_mailbox_.write_buffer();
+  // The joint count was checked against the capacity of the arrays in on_init()
+  joint_commands.njoints = njoints_;
+  // The commands are scattered from the order of the URDF into the order of the joint control API.
+  for (std::size_t i = 0; i < njoints_; ++i) {
+    const auto sdk_index = sdk_joint_index_[i];
+    const double* joint_command = &hw_commands_[command_interfaces_per_joint_ * i];
+    joint_commands.position[sdk_index] = joint_command[0];
+    joint_commands.velocity[sdk_index] = joint_command[1];
+    joint_commands.load[sdk_index] = joint_command[2];
+    joint_commands.k_q_p[sdk_index] = joint_command[3];
+    joint_commands.k_qd_p[sdk_index] = joint_command[4];
+  }
+  command_mailbox_.publish();
+  command_sequence_.fetch_add(1, std::memory_order_release);
+  command_sequence_.notify_one();
 
   return hardware_interface::return_type::OK;
 }
@@ -305,9 +493,9 @@ bool SpotHardware::authenticate_robot(const std::string& hostname, const std::st
     RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Robot already authenticated!");
     return true;
   }
-  // Create a Client SDK object.
-  const auto client_sdk = ::bosdyn::client::CreateStandardSDK("SpotHardware");
-  auto robot_result = client_sdk->CreateRobot(hostname);
+  // Create a Client SDK object, or share the one of the other robots in this process.
+  client_sdk_ = shared_client_sdk();
+  auto robot_result = client_sdk_->CreateRobot(hostname);
   if (!robot_result) {
     RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Could not create robot");
     return false;
@@ -325,19 +513,64 @@ bool SpotHardware::authenticate_robot(const std::string& hostname, const std::st
   return true;
 }
 
-bool SpotHardware::start_time_sync() {
-  auto start_response = robot_->StartTimeSync();
+bool SpotHardware::start_time_sync(std::future<bool>& synced) {
+  // The endpoint stamps the end time of every streamed joint command, and the streamed states with their acquisition
+  // times for the state age statistics.
+  auto endpoint_result = robot_->StartTimeSyncAndGetEndpoint();
+  if (!endpoint_result) {
+    RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Could not get timesync endpoint");
+    return false;
+  }
+  endpoint_ = endpoint_result.response;
+  state_streaming_handler_.set_time_sync_endpoint(endpoint_);
   auto time_sync_thread_resp = robot_->GetTimeSyncThread();
   if (!time_sync_thread_resp.status) {
     RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Could not get time sync thread from robot");
     return false;
   }
-  auto time_sync_thread = time_sync_thread_resp.response;
-  if (!time_sync_thread->WaitForSync(std::chrono::seconds(5))) {
-    RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Failed to establish time sync before timing out");
+  synced = std::async(std::launch::async, [time_sync_thread = time_sync_thread_resp.response]() {
+    if (!time_sync_thread->WaitForSync(std::chrono::seconds(5))) {
+      RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Failed to establish time sync before timing out");
+      return false;
+    }
+    RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Time sync complete");
+    return true;
+  });
+  return true;
+}
+
+bool SpotHardware::create_service_clients() {
+  auto robot_state_stream_client_resp = robot_->EnsureServiceClient<::bosdyn::client::RobotStateStreamingClient>();
+  if (!robot_state_stream_client_resp) {
+    RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Could not create robot state client");
     return false;
   }
-  RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Time sync complete");
+  state_client_ = robot_state_stream_client_resp.move();
+  RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Robot State Client created");
+
+  ::bosdyn::client::Result<::bosdyn::client::LeaseClient*> lease_client_resp =
+      robot_->EnsureServiceClient<::bosdyn::client::LeaseClient>();
+  if (!lease_client_resp) {
+    RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Could not create lease client");
+    return false;
+  }
+  lease_client_ = lease_client_resp.response;
+
+  auto robot_command_client_resp = robot_->EnsureServiceClient<::bosdyn::client::RobotCommandClient>();
+  if (!robot_command_client_resp) {
+    RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Could not create robot command client");
+    return false;
+  }
+  command_client_ = robot_command_client_resp.response;
+  RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Robot Command Client successfully created!");
+
+  auto robot_command_stream_resp = robot_->EnsureServiceClient<::bosdyn::client::RobotCommandStreamingClient>();
+  if (!robot_command_stream_resp) {
+    RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Could not create robot command streaming client");
+    return false;
+  }
+  command_stream_service_ = robot_command_stream_resp.response;
+  RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Robot Command Streaming Client successfully created!");
   return true;
 }
 
@@ -359,15 +592,7 @@ bool SpotHardware::check_estop() {
 
 bool SpotHardware::get_lease() {
   RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Getting Lease");
-  // First create a lease client.
-  ::bosdyn::client::Result<::bosdyn::client::LeaseClient*> lease_client_resp =
-      robot_->EnsureServiceClient<::bosdyn::client::LeaseClient>();
-  if (!lease_client_resp) {
-    RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Could not create lease client");
-    return false;
-  }
-  lease_client_ = lease_client_resp.response;
-  // Then acquire the lease for the body.
+  // Acquire the lease for the body with the lease client created during configuration.
   const auto lease_res = lease_client_->TakeLease("body");
   if (!lease_res) {
     RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Could not acquire body lease");
@@ -410,17 +635,24 @@ bool SpotHardware::power_off() {
 }
 
 void state_stream_loop(std::stop_token stop_token, ::bosdyn::client::RobotStateStreamingClient* stateStreamClient,
-                       StateHandler&& state_policy) {
+                       StateHandler&& state_policy, RetryBackoff backoff) {
   ::bosdyn::api::RobotStateStreamResponse latest_state_stream_response;
 
   while (!stop_token.stop_requested()) {
     // Get robot state stream
+    tracing::stage_begin("receive_state");
     auto robot_state_stream = stateStreamClient->GetRobotStateStream();
+    tracing::stage_end("receive_state");
     if (!robot_state_stream) {
-      RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"),
-                   "Failed to get robot state. Does the robot have a valid joint level control license?");
+      const auto delay = backoff.next_delay();
+      RCLCPP_ERROR_THROTTLE(rclcpp::get_logger("SpotHardware"), throttle_clock(), kFailureLogPeriodMs,
+                            "Failed to get robot state. Does the robot have a valid joint level control license? "
+                            "Retrying in %lld ms.",
+                            static_cast<long long>(delay.count()));
+      sleep_unless_stopped(stop_token, delay);
       continue;
     }
+    backoff.reset();
     latest_state_stream_response = std::move(robot_state_stream.response);
     state_policy(latest_state_stream_response);
   }
@@ -431,16 +663,10 @@ bool SpotHardware::start_state_stream(StateHandler&& state_policy) {
     RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "State stream has already been started!");
     return true;
   }
-  // Start state streaming
-  auto robot_state_stream_client_resp = robot_->EnsureServiceClient<::bosdyn::client::RobotStateStreamingClient>();
-  if (!robot_state_stream_client_resp) {
-    RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Could not create robot state client");
-    return false;
-  }
-  state_client_ = robot_state_stream_client_resp.move();
-  RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Robot State Client created");
-
-  state_thread_ = std::jthread(&spot_hardware_interface::state_stream_loop, state_client_, state_policy);
+  // Start state streaming with the client created during configuration
+  state_thread_ =
+      std::jthread(&spot_hardware_interface::state_stream_loop, state_client_, state_policy, retry_backoff_);
+  apply_thread_settings(state_thread_, "state stream", state_thread_settings_);
   state_stream_started_ = true;
   return true;
 }
@@ -456,28 +682,9 @@ void SpotHardware::stop_state_stream() {
   state_stream_started_ = false;
 }
 
-bool SpotHardware::start_command_stream() {
-  if (command_stream_started_) {
-    RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Command stream has already been started!");
-    return true;
-  }
-  // Start command streaming
-  auto robot_command_stream_client_resp = robot_->EnsureServiceClient<::bosdyn::client::RobotCommandClient>();
-  if (!robot_command_stream_client_resp) {
-    RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Could not create robot command client");
-    return false;
-  }
-  command_client_ = robot_command_stream_client_resp.response;
-
-  auto endpoint_result = robot_->StartTimeSyncAndGetEndpoint();
-  if (!endpoint_result) {
-    RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Could not get timesync endpoint");
-    return false;
-  }
-
-  command_client_->AddTimeSyncEndpoint(endpoint_result.response);
-
-  RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Robot Command Client successfully created!");
+bool SpotHardware::connect_command_stream() {
+  // The clients and the time sync endpoint were created during configuration.
+  command_client_->AddTimeSyncEndpoint(endpoint_);
 
   bosdyn::api::RobotCommand joint_command = ::bosdyn::client::JointCommand();
   auto joint_res = command_client_->RobotCommand(joint_command);
@@ -486,31 +693,49 @@ bool SpotHardware::start_command_stream() {
     RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Message: %s", joint_res.status.DebugString().c_str());
     return false;
   }
+  RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Joint control mode activated!");
+  return true;
+}
 
-  auto robot_command_stream_resp = robot_->EnsureServiceClient<::bosdyn::client::RobotCommandStreamingClient>();
-  if (!robot_command_stream_resp) {
-    RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Could not create robot command streaming client");
+bool SpotHardware::start_command_stream() {
+  if (command_stream_started_) {
+    RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Command stream has already been started!");
+    return true;
+  }
+  // The loopback backend has no robot to connect to, but builds and records the same requests.
+  if (!loopback_ && !connect_command_stream()) {
     return false;
   }
-  command_stream_service_ = robot_command_stream_resp.response;
-
-  RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Robot Command Streaming Client successfully created!");
 
   // Fill in the parts of the joint streaming command request that are constant.
   auto* joint_cmd = joint_request_.mutable_joint_command();
 
-  joint_cmd->mutable_gains()->mutable_k_q_p()->Clear();
-  joint_cmd->mutable_gains()->mutable_k_q_p()->Add(k_q_p_.begin(), k_q_p_.end());
-  joint_cmd->mutable_gains()->mutable_k_qd_p()->Clear();
-  joint_cmd->mutable_gains()->mutable_k_qd_p()->Add(k_qd_p_.begin(), k_qd_p_.end());
-
-  // Let it extrapolate the command a little
-  joint_cmd->mutable_extrapolation_duration()->CopyFrom(
-      google::protobuf::util::TimeUtil::NanosecondsToDuration(5 * 1e6));
+  // The repeated fields are sized for every joint once, and then overwritten in place by send_command().
+  const auto njoints = static_cast<int>(njoints_);
+  joint_cmd->mutable_position()->Resize(njoints, 0.0f);
+  joint_cmd->mutable_velocity()->Resize(njoints, 0.0f);
+  joint_cmd->mutable_load()->Resize(njoints, 0.0f);
+  joint_cmd->mutable_gains()->mutable_k_q_p()->Resize(njoints, 0.0f);
+  joint_cmd->mutable_gains()->mutable_k_qd_p()->Resize(njoints, 0.0f);
 
   // WITHOUT THIS NO COMMANDS WILL BE ACCEPTED!!!!
   ::bosdyn::client::SetRequestHeader("SpotHardware", &joint_request_);
 
+  // The robot keeps the last gains it received, so commands with unchanged gains are sent without them.
+  joint_request_without_gains_ = joint_request_;
+  joint_request_without_gains_.mutable_joint_command()->clear_gains();
+  gains_sent_ = false;
+  time_reference_.reset();
+  command_timing_ = CommandTiming{command_timing_bounds_};
+  state_age_.reset();
+  loop_period_.reset();
+  command_latency_.reset();
+  last_read_time_.reset();
+
+  command_thread_ = std::jthread([this](std::stop_token stop_token) {
+    command_send_loop(stop_token);
+  });
+  apply_thread_settings(command_thread_, "command sender", command_thread_settings_);
   command_stream_started_ = true;
   return true;
 }
@@ -521,50 +746,191 @@ void SpotHardware::stop_command_stream() {
     return;
   }
   RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Stopping Command Stream");
+  command_thread_.request_stop();
+  // Wake up the command thread, which may wait for the next command.
+  command_sequence_.fetch_add(1, std::memory_order_release);
+  command_sequence_.notify_one();
+  command_thread_.join();
   command_stream_started_ = false;
 }
 
-void SpotHardware::send_command(const JointCommands& joint_commands) {
-  const std::vector<float>& position = joint_commands.position;
-  const std::vector<float>& velocity = joint_commands.velocity;
-  const std::vector<float>& load = joint_commands.load;
-  const std::vector<float>& k_q_p = joint_commands.k_q_p;
-  const std::vector<float>& k_qd_p = joint_commands.k_qd_p;
+void SpotHardware::command_send_loop(std::stop_token stop_token) {
+  auto backoff = retry_backoff_;
+  auto sequence = command_sequence_.load(std::memory_order_acquire);
+  while (!stop_token.stop_requested()) {
+    command_sequence_.wait(sequence, std::memory_order_acquire);
+    sequence = command_sequence_.load(std::memory_order_acquire);
+    if (stop_token.stop_requested() || !command_mailbox_.update()) {
+      continue;
+    }
+    tracing::stage_begin("send_command", sequence);
+    const bool sent = send_command(command_mailbox_.read_buffer());
+    tracing::stage_end("send_command", sequence);
+    if (sent) {
+      backoff.reset();
+    } else {
+      // Commands which arrive while waiting replace each other in the mailbox, so only the latest one is retried.
+      sleep_unless_stopped(stop_token, backoff.next_delay());
+    }
+  }
+}
 
-  // build protobuf
-  auto* joint_cmd = joint_request_.mutable_joint_command();
+bool SpotHardware::send_command(const JointCommands& joint_commands) {
+  // The fields of the requests were sized for njoints_ in start_command_stream(), which is also the joint count of
+  // every command from write(), so they are overwritten in place without clearing or allocating.
+  const auto njoints = joint_commands.njoints;
+  // The gains are compared with the last sent ones rather than with the last command from write(), since a command
+  // with new gains may have been replaced in the mailbox before it was sent.
+  const bool gains_changed =
+      !gains_sent_ ||
+      !std::equal(joint_commands.k_q_p.begin(), joint_commands.k_q_p.begin() + njoints, sent_k_q_p_.begin()) ||
+      !std::equal(joint_commands.k_qd_p.begin(), joint_commands.k_qd_p.begin() + njoints, sent_k_qd_p_.begin());
+  auto& request = gains_changed ? joint_request_ : joint_request_without_gains_;
+  auto* joint_cmd = request.mutable_joint_command();
+  std::copy_n(joint_commands.position.begin(), njoints, joint_cmd->mutable_position()->mutable_data());
+  std::copy_n(joint_commands.velocity.begin(), njoints, joint_cmd->mutable_velocity()->mutable_data());
+  std::copy_n(joint_commands.load.begin(), njoints, joint_cmd->mutable_load()->mutable_data());
+  if (gains_changed) {
+    std::copy_n(joint_commands.k_q_p.begin(), njoints, joint_cmd->mutable_gains()->mutable_k_q_p()->mutable_data());
+    std::copy_n(joint_commands.k_qd_p.begin(), njoints, joint_cmd->mutable_gains()->mutable_k_qd_p()->mutable_data());
+  }
+
+  // The end time is extrapolated on the monotonic clock from a robot time reference, which is only refreshed from the
+  // time sync endpoint once per RobotTimeReference::kRefreshPeriod, when the clock skew may have been updated.
+  // The loopback backend has no robot clock, so its commands are stamped in the local clock.
+  const auto now = std::chrono::steady_clock::now();
+  const auto robot_now_ns = loopback_ ? std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                            std::chrono::system_clock::now().time_since_epoch())
+                                            .count()
+                                      : time_reference_.robot_time_ns(*endpoint_, now);
+  const auto end_time_ns = robot_now_ns + command_timing_.end_time_offset().count();
+  auto* end_time = joint_cmd->mutable_end_time();
+  end_time->set_seconds(end_time_ns / 1000000000);
+  end_time->set_nanos(static_cast<std::int32_t>(end_time_ns % 1000000000));
+  // The robot extrapolates the command for about as long as the next one takes to arrive, so that it does not hold a
+  // stale command under jitter, and the end time stops it if a few commands in a row are lost.
+  const auto extrapolation_ns = command_timing_.extrapolation().count();
+  auto* extrapolation = joint_cmd->mutable_extrapolation_duration();
+  extrapolation->set_seconds(extrapolation_ns / 1000000000);
+  extrapolation->set_nanos(static_cast<std::int32_t>(extrapolation_ns % 1000000000));
+
+  // Send joint stream command. The streaming client, the request header and the time sync endpoint are set up once in
+  // start_command_stream() and reused for every command of this activation, so only the request itself changes.
+  if (loopback_) {
+    record_loopback_command(request);
+    const auto latency = std::chrono::steady_clock::now() - now;
+    command_latency_.record(latency);
+    command_timing_.record(now, latency);
+    return true;
+  }
+  auto joint_control_stream = command_stream_service_->JointControlStream(request);
+  const auto latency = std::chrono::steady_clock::now() - now;
+  command_latency_.record(latency);
+  if (!joint_control_stream) {
+    RCLCPP_ERROR_THROTTLE(rclcpp::get_logger("SpotHardware"), throttle_clock(), kFailureLogPeriodMs,
+                          "Failed to send command: '%s'", joint_control_stream.status.DebugString().c_str());
+    // The robot may not have received the gains, so they are sent again with the next command.
+    gains_sent_ = false;
+    return false;
+  }
+  command_timing_.record(now, latency);
+  if (gains_changed) {
+    sent_k_q_p_ = joint_commands.k_q_p;
+    sent_k_qd_p_ = joint_commands.k_qd_p;
+    gains_sent_ = true;
+  }
+  return true;
+}
 
-  joint_cmd->mutable_position()->Clear();
-  joint_cmd->mutable_position()->Add(position.begin(), position.end());
-  joint_cmd->mutable_velocity()->Clear();
-  joint_cmd->mutable_velocity()->Add(velocity.begin(), velocity.end());
-  joint_cmd->mutable_load()->Clear();
-  joint_cmd->mutable_load()->Add(load.begin(), load.end());
-  joint_cmd->mutable_gains()->mutable_k_q_p()->Clear();
-  joint_cmd->mutable_gains()->mutable_k_q_p()->Add(k_q_p.begin(), k_q_p.end());
-  joint_cmd->mutable_gains()->mutable_k_qd_p()->Clear();
-  joint_cmd->mutable_gains()->mutable_k_qd_p()->Add(k_qd_p.begin(), k_qd_p.end());
-
-  if (endpoint_ == nullptr) {
-    auto endpoint_result = robot_->StartTimeSyncAndGetEndpoint();
-    if (!endpoint_result) {
-      RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Could not get timesync endpoint");
-      return;
+void SpotHardware::map_joints() {
+  std::array<bool, kNjointsArm> mapped{};
+  bool valid = true;
+  for (std::size_t i = 0; i < njoints_ && valid; ++i) {
+    // Joint names may be prefixed with the name of the robot, e.g. "Spot/front_left_hip_x"
+    const auto& name = info_.joints[i].name;
+    const auto short_name = name.substr(name.rfind('/') + 1);
+    const auto it = std::find(kJointNames.begin(), kJointNames.begin() + njoints_, short_name);
+    valid = it != kJointNames.begin() + njoints_ && !mapped[it - kJointNames.begin()];
+    if (valid) {
+      sdk_joint_index_[i] = static_cast<std::size_t>(it - kJointNames.begin());
+      mapped[sdk_joint_index_[i]] = true;
+    }
+  }
+  if (!valid) {
+    RCLCPP_WARN(rclcpp::get_logger("SpotHardware"),
+                "The joint names do not match the joints of Spot, so they are assumed to be in the order of the joint "
+                "control API.");
+    for (std::size_t i = 0; i < sdk_joint_index_.size(); ++i) {
+      sdk_joint_index_[i] = i;
     }
-    endpoint_ = endpoint_result.response;
   }
+}
+
+bool SpotHardware::start_loopback_state_stream() {
+  if (state_stream_started_) {
+    RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "State stream has already been started!");
+    return true;
+  }
+  RCLCPP_INFO(rclcpp::get_logger("SpotHardware"), "Streaming synthetic states at %d Hz without a robot",
+              loopback_state_rate_hz_);
+  state_thread_ = std::jthread([this](std::stop_token stop_token) {
+    loopback_state_loop(stop_token);
+  });
+  apply_thread_settings(state_thread_, "state stream", state_thread_settings_);
+  state_stream_started_ = true;
+  return true;
+}
 
-  auto time_point_local = ::bosdyn::common::TimePoint(std::chrono::system_clock::now() + std::chrono::milliseconds(50));
+void SpotHardware::loopback_state_loop(std::stop_token stop_token) {
+  // The response is sized for every joint once, and then overwritten in place, like a response from the robot.
+  ::bosdyn::api::RobotStateStreamResponse response;
+  auto* joint_states = response.mutable_joint_states();
+  const auto njoints = static_cast<int>(njoints_);
+  joint_states->mutable_position()->Resize(njoints, 0.0f);
+  joint_states->mutable_velocity()->Resize(njoints, 0.0f);
+  joint_states->mutable_load()->Resize(njoints, 0.0f);
+  response.mutable_kinematic_state()->mutable_odom_tform_body()->mutable_rotation()->set_w(1.0);
+
+  const std::chrono::nanoseconds period{1000000000 / loopback_state_rate_hz_};
+  auto next_state_time = std::chrono::steady_clock::now();
+  while (!stop_token.stop_requested()) {
+    // Every joint follows its last command immediately.
+    if (loopback_commands_.update()) {
+      const auto& commands = loopback_commands_.read_buffer();
+      std::copy_n(commands.position.begin(), njoints_, joint_states->mutable_position()->mutable_data());
+      std::copy_n(commands.velocity.begin(), njoints_, joint_states->mutable_velocity()->mutable_data());
+      std::copy_n(commands.load.begin(), njoints_, joint_states->mutable_load()->mutable_data());
+    }
+    state_streaming_handler_.handle_state_streaming(response);
+    next_state_time += period;
+    std::this_thread::sleep_until(next_state_time);
+  }
+}
 
-  ::bosdyn::common::RobotTimeConverter converter = endpoint_->GetRobotTimeConverter();
-  joint_cmd->mutable_end_time()->CopyFrom(converter.RobotTimestampFromLocal(time_point_local));
+void SpotHardware::record_loopback_command(const ::bosdyn::api::JointControlStreamRequest& request) {
+  const auto& joint_cmd = request.joint_command();
+  auto& commands = loopback_commands_.write_buffer();
+  commands.njoints = njoints_;
+  std::copy_n(joint_cmd.position().begin(), njoints_, commands.position.begin());
+  std::copy_n(joint_cmd.velocity().begin(), njoints_, commands.velocity.begin());
+  std::copy_n(joint_cmd.load().begin(), njoints_, commands.load.begin());
+  loopback_commands_.publish();
+}
 
-  // Send joint stream command
-  auto joint_control_stream = command_stream_service_->JointControlStream(joint_request_);
-  if (!joint_control_stream) {
-    RCLCPP_ERROR(rclcpp::get_logger("SpotHardware"), "Failed to send command: '%s'",
-                 joint_control_stream.status.DebugString().c_str());
-    return;
+void SpotHardware::update_latency_states(const StreamedState& state) {
+  const auto now = std::chrono::steady_clock::now();
+  if (state.acquisition_time) {
+    state_age_.record(now - *state.acquisition_time);
+  }
+  if (last_read_time_) {
+    loop_period_.record(now - *last_read_time_);
+  }
+  last_read_time_ = now;
+  const std::array<const LatencyHistogram*, 3> histograms{&state_age_, &loop_period_, &command_latency_};
+  for (std::size_t i = 0; i < histograms.size(); ++i) {
+    hw_latency_states_[3 * i] = histograms[i]->percentile(0.5);
+    hw_latency_states_[3 * i + 1] = histograms[i]->percentile(0.99);
+    hw_latency_states_[3 * i + 2] = histograms[i]->max();
   }
 }
 
@@ -0,0 +1,7 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+// Defines the tracepoints and the probes of the spot_hardware_interface LTTng provider.
+
+#define TRACEPOINT_CREATE_PROBES
+#define TRACEPOINT_DEFINE
+#include "tracepoints.h"
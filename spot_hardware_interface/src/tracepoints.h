@@ -0,0 +1,27 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+// LTTng tracepoint provider of the hardware interface. It is only compiled if lttng-ust is found, and is only included
+// by tracing.cpp and tracepoints.c.
+
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER spot_hardware_interface
+
+#undef TRACEPOINT_INCLUDE
+#define TRACEPOINT_INCLUDE "tracepoints.h"
+
+#if !defined(SPOT_HARDWARE_INTERFACE_TRACEPOINTS_H_) || defined(TRACEPOINT_HEADER_MULTI_READ)
+#define SPOT_HARDWARE_INTERFACE_TRACEPOINTS_H_
+
+#include <lttng/tracepoint.h>
+#include <stdint.h>
+
+TRACEPOINT_EVENT_CLASS(spot_hardware_interface, stage, TP_ARGS(const char*, stage_arg, uint64_t, id_arg),
+                       TP_FIELDS(ctf_string(stage, stage_arg) ctf_integer(uint64_t, id, id_arg)))
+
+TRACEPOINT_EVENT_INSTANCE(spot_hardware_interface, stage, stage_begin, TP_ARGS(const char*, stage_arg, uint64_t, id_arg))
+
+TRACEPOINT_EVENT_INSTANCE(spot_hardware_interface, stage, stage_end, TP_ARGS(const char*, stage_arg, uint64_t, id_arg))
+
+#endif  // SPOT_HARDWARE_INTERFACE_TRACEPOINTS_H_
+
+#include <lttng/tracepoint-event.h>
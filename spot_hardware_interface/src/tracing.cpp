@@ -0,0 +1,25 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include "spot_hardware_interface/tracing.hpp"
+
+#ifdef SPOT_HARDWARE_INTERFACE_HAS_LTTNG
+#include "tracepoints.h"
+#endif
+
+namespace spot_hardware_interface::tracing {
+
+#ifdef SPOT_HARDWARE_INTERFACE_HAS_LTTNG
+void stage_begin(const char* stage, const std::uint64_t id) {
+  tracepoint(spot_hardware_interface, stage_begin, stage, id);
+}
+
+void stage_end(const char* stage, const std::uint64_t id) {
+  tracepoint(spot_hardware_interface, stage_end, stage, id);
+}
+#else
+void stage_begin(const char* /*stage*/, const std::uint64_t /*id*/) {}
+
+void stage_end(const char* /*stage*/, const std::uint64_t /*id*/) {}
+#endif
+
+}  // namespace spot_hardware_interface::tracing
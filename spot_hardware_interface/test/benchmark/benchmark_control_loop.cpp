@@ -0,0 +1,127 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+// Benchmarks of the read() and write() path of SpotHardware, running against its loopback backend, which streams
+// synthetic states whose joints follow the recorded commands instead of connecting to a robot. Each benchmark reports
+// the time per control cycle and the number of heap allocations per control cycle of the whole process, which
+// includes the state stream and command threads.
+
+#include <benchmark/benchmark.h>
+
+#include <hardware_interface/hardware_info.hpp>
+#include <hardware_interface/types/hardware_interface_type_values.hpp>
+#include <rclcpp/duration.hpp>
+#include <rclcpp/time.hpp>
+#include <rclcpp_lifecycle/state.hpp>
+#include <spot_hardware_interface/spot_constants.hpp>
+#include <spot_hardware_interface/spot_hardware_interface.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+std::atomic<std::size_t> allocation_count{0};
+}  // namespace
+
+// Count every heap allocation of the process, so that the benchmarks can report allocations per control cycle.
+void* operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t /*size*/) noexcept {
+  std::free(pointer);
+}
+
+namespace {
+/**
+ * @brief Create the hardware info of a robot with an arm, with the interfaces that SpotHardware expects of every joint.
+ *
+ * @param state_wait_timeout_ms Value of the state_wait_timeout_ms hardware parameter.
+ */
+hardware_interface::HardwareInfo createHardwareInfo(const int state_wait_timeout_ms) {
+  hardware_interface::HardwareInfo info;
+  info.name = "SpotSystem";
+  info.type = "system";
+  info.hardware_plugin_name = "spot_hardware_interface/SpotHardware";
+  info.hardware_parameters["loopback"] = "true";
+  info.hardware_parameters["state_wait_timeout_ms"] = std::to_string(state_wait_timeout_ms);
+
+  const auto interface = [](const std::string& name, const std::string& initial_value) {
+    hardware_interface::InterfaceInfo interface_info;
+    interface_info.name = name;
+    interface_info.initial_value = initial_value;
+    return interface_info;
+  };
+  for (int i = 0; i < spot_hardware_interface::kNjointsArm; ++i) {
+    hardware_interface::ComponentInfo joint;
+    joint.name = spot_hardware_interface::kJointNames[i];
+    joint.type = "joint";
+    joint.command_interfaces = {interface(hardware_interface::HW_IF_POSITION, "0.0"),
+                                interface(hardware_interface::HW_IF_VELOCITY, "0.0"),
+                                interface(hardware_interface::HW_IF_EFFORT, "0.0"), interface("k_q_p", "100.0"),
+                                interface("k_qd_p", "1.0")};
+    joint.state_interfaces = {interface(hardware_interface::HW_IF_POSITION, ""),
+                              interface(hardware_interface::HW_IF_VELOCITY, ""),
+                              interface(hardware_interface::HW_IF_EFFORT, "")};
+    info.joints.push_back(joint);
+  }
+  return info;
+}
+
+/**
+ * @brief Run read() and write() back to back every iteration, like the control loop of the controller manager.
+ * @details The first argument of the benchmark is the state_wait_timeout_ms hardware parameter. If it is zero, the
+ * loop runs as fast as possible on the latest state, which measures the cost of the path itself. Otherwise, every
+ * iteration waits for a new synthetic state, which is streamed at 333 Hz, and the loop period statistics of the
+ * latency state interfaces are reported in milliseconds.
+ */
+void BM_ControlCycle(benchmark::State& state) {
+  spot_hardware_interface::SpotHardware hardware;
+  const rclcpp_lifecycle::State lifecycle_state;
+  if (hardware.on_init(createHardwareInfo(static_cast<int>(state.range(0)))) !=
+          hardware_interface::CallbackReturn::SUCCESS ||
+      hardware.on_configure(lifecycle_state) != hardware_interface::CallbackReturn::SUCCESS) {
+    state.SkipWithError("Could not configure the loopback hardware interface.");
+    return;
+  }
+  auto state_interfaces = hardware.export_state_interfaces();
+  auto command_interfaces = hardware.export_command_interfaces();
+  if (hardware.on_activate(lifecycle_state) != hardware_interface::CallbackReturn::SUCCESS) {
+    state.SkipWithError("Could not activate the loopback hardware interface.");
+    return;
+  }
+
+  const rclcpp::Time time;
+  const rclcpp::Duration period = rclcpp::Duration::from_nanoseconds(3000000);
+  const auto allocations_at_start = allocation_count.load();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(hardware.read(time, period));
+    benchmark::DoNotOptimize(hardware.write(time, period));
+  }
+  state.counters["allocs/cycle"] = benchmark::Counter(
+      static_cast<double>(allocation_count.load() - allocations_at_start), benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations());
+
+  for (const auto& state_interface : state_interfaces) {
+    if (state_interface.get_prefix_name() == spot_hardware_interface::kLatencyName) {
+      state.counters[state_interface.get_interface_name() + " (ms)"] = state_interface.get_value() * 1000.0;
+    }
+  }
+  hardware.on_deactivate(lifecycle_state);
+  hardware.on_cleanup(lifecycle_state);
+}
+BENCHMARK(BM_ControlCycle)->Arg(0)->Arg(10)->UseRealTime();
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -18,7 +18,9 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -45,14 +47,47 @@ static const std::unordered_map<std::string, size_t> kJointNameToIndexWithoutArm
     {"rear_left_knee", 8},    {"rear_right_hip_x", 9}, {"rear_right_hip_y", 10}, {"rear_right_knee", 11},
 };
 
+/// @brief Find the index of a joint without allocating, by searching the joint names of Spot in their index order.
+/// @param joint_name Name of the joint without a namespace
+/// @param has_arm Whether the arm joints are included in the search
+/// @return joint index, or nullopt if the joint is unknown
+std::optional<size_t> find_joint_index(std::string_view joint_name, bool has_arm = true);
+
 /// @brief Return the joint name to index map depending on the namespace and if the robot has an arm.
 /// @param spot_name Namespace that the ros2 control stack was launched in that prefixes the joint names
 /// @param has_arm Boolean indicating if the arm joint angles should be included in the map
 /// @return Unordered map that takes joint name to joint index.
 std::unordered_map<std::string, size_t> get_namespaced_joint_map(const std::string& spot_name, bool has_arm);
 
+/// @brief Puts the joints of JointStates messages in the order that the Spot Hardware interface expects. The index of
+/// every joint of a message in that order is resolved when the joint names change, which is usually only for the first
+/// message of a topic, so ordering the following messages only copies their values.
+class JointOrderer {
+ public:
+  /// @param spot_name Namespace that the ros2 control stack was launched in that prefixes the joint names
+  explicit JointOrderer(std::string spot_name = "");
+
+  /// @brief Put the joints of a JointStates message in order.
+  /// @param input_joint_states The JointStates message received from the robot
+  /// @param output_joint_states A JointStates message that will be ordered properly. Reusing it between calls avoids
+  /// reallocating its fields.
+  /// @return boolean indicating if the joint angles got ordered successfully.
+  bool order(const sensor_msgs::msg::JointState& input_joint_states, sensor_msgs::msg::JointState& output_joint_states);
+
+ private:
+  /// @brief Resolve the output index of every joint of a message whose joint names differ from the last ones.
+  /// @return boolean indicating if every joint name belongs to Spot.
+  bool resolve(const std::vector<std::string>& names);
+
+  std::string spot_name_;
+  // Joint names that the output indices were resolved for, and whether they were all valid.
+  std::vector<std::string> names_;
+  std::vector<size_t> output_indices_;
+  bool valid_ = false;
+};
+
 /// @brief Given a list of joints from a JointStates message, put them in the correct order that the Spot Hardware
-/// interface expects.
+/// interface expects. Use a JointOrderer to order several messages.
 /// @param spot_name Namespace that the ros2 control stack was launched in that prefixes the joint names
 /// @param input_joint_states The JointStates message received from the robot
 /// @param output_joint_states A JointStates message that will be ordered properly
@@ -64,6 +99,6 @@ bool order_joint_states(const std::string& spot_name, const sensor_msgs::msg::Jo
 /// @param joint_str string name of joint
 /// @param has_arm whether or not the spot has an arm (default true)
 /// @return joint index
-int get_joint_index(const std::string& joint_str, bool has_arm = true);
+int get_joint_index(std::string_view joint_str, bool has_arm = true);
 
 }  // namespace spot_ros2_control
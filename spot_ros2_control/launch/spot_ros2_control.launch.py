@@ -53,7 +53,12 @@ def create_controllers_config(spot_name: str, has_arm: bool) -> str:
             config = yaml.safe_load(template_file)
             config[f"{spot_name}/controller_manager"] = config["controller_manager"]
             del config["controller_manager"]
-            keys_to_namespace = ["forward_position_controller", "forward_state_controller"]
+            keys_to_namespace = [
+                "forward_position_controller",
+                "forward_state_controller",
+                "joint_command_controller",
+                "spline_trajectory_controller",
+            ]
 
             for key in keys_to_namespace:
                 key_joints = config[key]["ros__parameters"]["joints"]
@@ -61,6 +66,18 @@ def create_controllers_config(spot_name: str, has_arm: bool) -> str:
                 config[f"{spot_name}/{key}"] = config[key]
                 del config[key]
 
+            # The broadcasters of the robot state stream publish frames, which are prefixed instead of their joints.
+            frame_keys = {
+                "odometry_broadcaster": ["odom_frame_id", "base_frame_id"],
+                "imu_sensor_broadcaster": ["frame_id"],
+            }
+            for key, frame_params in frame_keys.items():
+                for frame_param in frame_params:
+                    frame = config[key]["ros__parameters"][frame_param]
+                    config[key]["ros__parameters"][frame_param] = f"{spot_name}/{frame}"
+                config[f"{spot_name}/{key}"] = config[key]
+                del config[key]
+
         with NamedTemporaryFile(suffix=".yaml", mode="w", delete=False) as out_file:
             yaml.dump(config, out_file)
             return out_file.name
@@ -204,6 +221,16 @@ def launch_setup(context: LaunchContext, ld: LaunchDescription) -> None:
     )
     # Finally, launch extra nodes for state and image publishing if we are running on a robot.
     if hardware_interface == "robot":
+        # The body odometry and IMU from the state stream are only exported by the robot hardware interface.
+        for broadcaster in ["odometry_broadcaster", "imu_sensor_broadcaster"]:
+            ld.add_action(
+                Node(
+                    package="controller_manager",
+                    executable="spawner",
+                    arguments=[broadcaster, "-c", "controller_manager"],
+                    namespace=spot_name,
+                )
+            )
         # launch image publishers
         ld.add_action(
             IncludeLaunchDescription(
@@ -2,6 +2,7 @@
 
 // Note(llee): I think I would like to move this to `action_stack_spot` because so far it's pretty specific to Spot
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <map>
@@ -11,14 +12,19 @@
 #include <vector>
 
 #include "rclcpp/rclcpp.hpp"
+#include "rclcpp_components/register_node_macro.hpp"
+#include "realtime_tools/realtime_publisher.h"
 #include "sensor_msgs/msg/joint_state.hpp"
 #include "spot_hardware_interface/spot_constants.hpp"
 #include "spot_ros2_control/spot_joint_map.hpp"
 #include "std_msgs/msg/float64_multi_array.hpp"
 
+namespace spot_ros2_control {
+
 class JointCommandPassthrough : public rclcpp::Node {
  public:
-  JointCommandPassthrough() : Node("joint_passthrough") {
+  explicit JointCommandPassthrough(const rclcpp::NodeOptions& options = rclcpp::NodeOptions())
+      : Node("joint_passthrough", options) {
     std::string robot_namespace = declare_parameter("robot_namespace", "Spot");
     robot_namespace = robot_namespace.empty() ? "" : robot_namespace + "/";
     std::string joint_state_topic = robot_namespace + declare_parameter("joint_state_topic", "low_level/joint_states");
@@ -33,63 +39,94 @@ class JointCommandPassthrough : public rclcpp::Node {
         joint_commands_topic, 10,
         std::bind(&JointCommandPassthrough::joint_commands_callback, this, std::placeholders::_1));
 
-    command_pub_ = create_publisher<std_msgs::msg::Float64MultiArray>(controller_commands_topic, 10);
+    command_pub_ = std::make_unique<realtime_tools::RealtimePublisher<std_msgs::msg::Float64MultiArray>>(
+        create_publisher<std_msgs::msg::Float64MultiArray>(controller_commands_topic, 10));
+    command_pub_->msg_.data.resize(spot_hardware_interface::kNjointsArm);
 
-    spot_command_.data.reserve(spot_hardware_interface::kNjointsArm);
+    spot_command_.resize(spot_hardware_interface::kNjointsArm);
   }
 
  private:
+  // Names of the joints in the messages and their joint indices, resolved when the joint names of a topic change
+  // (usually only on its first message) so that forwarding a command does not search or allocate.
+  struct JointIndexCache {
+    std::vector<std::string> names;
+    std::vector<int> indices;
+    bool valid = false;
+  };
+
   rclcpp::Subscription<sensor_msgs::msg::JointState>::SharedPtr joint_states_sub_;
   rclcpp::Subscription<sensor_msgs::msg::JointState>::SharedPtr joint_commands_sub_;
-  rclcpp::Publisher<std_msgs::msg::Float64MultiArray>::SharedPtr command_pub_;
-  std_msgs::msg::Float64MultiArray spot_command_;
+  std::unique_ptr<realtime_tools::RealtimePublisher<std_msgs::msg::Float64MultiArray>> command_pub_;
+  std::vector<double> spot_command_;
+  bool has_joint_states_ = false;
+
+  JointIndexCache state_indices_;
+  JointIndexCache command_indices_;
 
   int count_ = 0;
 
+  bool resolve_joint_indices(const sensor_msgs::msg::JointState& msg, JointIndexCache& cache) {
+    if (msg.name == cache.names) {
+      return cache.valid;
+    }
+    cache.names = msg.name;
+    cache.indices.resize(msg.name.size());
+    cache.valid = msg.position.size() == msg.name.size();
+    for (size_t i = 0; i < msg.name.size() && cache.valid; ++i) {
+      cache.indices[i] = get_joint_index(msg.name[i]);
+      cache.valid = cache.indices[i] >= 0;
+    }
+    if (!cache.valid) {
+      RCLCPP_ERROR(get_logger(), "Joint names or positions are invalid, ignoring messages until they change.");
+    }
+    return cache.valid;
+  }
+
   void joint_states_callback(const sensor_msgs::msg::JointState& msg) {
     // Keep track of the current joint positions
     if (msg.name.size() != static_cast<std::vector<int>::size_type>(spot_hardware_interface::kNjointsArm)) {
-      RCLCPP_ERROR(get_logger(), "Expected %i dofs, but got %li", spot_hardware_interface::kNjointsArm,
-                   msg.name.size());
+      RCLCPP_ERROR_THROTTLE(get_logger(), *get_clock(), 1000, "Expected %i dofs, but got %li",
+                            spot_hardware_interface::kNjointsArm, msg.name.size());
+      return;
+    }
+    if (!resolve_joint_indices(msg, state_indices_)) {
       return;
     }
-
-    spot_command_.data.clear();
-    spot_command_.data.resize(spot_hardware_interface::kNjointsArm);
 
     for (int i = 0; i < spot_hardware_interface::kNjointsArm; ++i) {
-      int joint_idx = spot_ros2_control::get_joint_index(msg.name[i]);
-      if (joint_idx < 0) {
-        return;
-      }
-
-      spot_command_.data[joint_idx] = msg.position[i];
+      spot_command_[state_indices_.indices[i]] = msg.position[i];
     }
+    has_joint_states_ = true;
   }
 
   void joint_commands_callback(const sensor_msgs::msg::JointState& msg) {
-    // Update provided joints with their desired
-
-    int command_dofs = msg.name.size();
+    // Update provided joints with their desired positions, starting from the current positions of the others
+    if (!has_joint_states_) {
+      RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 1000, "No joint states received yet, not forwarding commands");
+      return;
+    }
+    if (!resolve_joint_indices(msg, command_indices_)) {
+      return;
+    }
 
-    for (int i = 0; i < command_dofs; ++i) {
-      int joint_idx = spot_ros2_control::get_joint_index(msg.name[i]);
-      if (joint_idx < 0) {
-        return;
-      }
-      spot_command_.data[joint_idx] = msg.position[i];
+    for (size_t i = 0; i < command_indices_.indices.size(); ++i) {
+      spot_command_[command_indices_.indices[i]] = msg.position[i];
     }
 
     ++count_;
-    RCLCPP_INFO(get_logger(), "Forwarding command %i", count_);
-
-    command_pub_->publish(spot_command_);
+    RCLCPP_DEBUG(get_logger(), "Forwarding command %i", count_);
+    RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 5000, "Forwarded %i commands", count_);
+
+    // The publisher is busy if the previous command has not been sent yet. This command is then dropped instead of
+    // blocking, as the next one replaces it anyway.
+    if (command_pub_->trylock()) {
+      std::copy(spot_command_.begin(), spot_command_.end(), command_pub_->msg_.data.begin());
+      command_pub_->unlockAndPublish();
+    }
   }
 };
 
-int main(int argc, char* argv[]) {
-  rclcpp::init(argc, argv);
-  rclcpp::spin(std::make_shared<JointCommandPassthrough>());
-  rclcpp::shutdown();
-  return 0;
-}
+}  // namespace spot_ros2_control
+
+RCLCPP_COMPONENTS_REGISTER_NODE(spot_ros2_control::JointCommandPassthrough)
@@ -9,15 +9,18 @@
 #include <vector>
 
 #include "rclcpp/rclcpp.hpp"
+#include "rclcpp_components/register_node_macro.hpp"
 #include "sensor_msgs/msg/joint_state.hpp"
 #include "spot_ros2_control/spot_joint_map.hpp"
 #include "std_msgs/msg/float64_multi_array.hpp"
 
+namespace spot_ros2_control {
+
 enum class SquatState { INITIALIZING, SQUATTING, STANDING };
 class NoarmSquat : public rclcpp::Node {
  public:
-  NoarmSquat()
-      : Node("noarm_squat"), squat_state_{SquatState::INITIALIZING}, initialized_{false}, count_{0}, njoints_{12} {
+  explicit NoarmSquat(const rclcpp::NodeOptions& options = rclcpp::NodeOptions())
+      : Node("noarm_squat", options), squat_state_{SquatState::INITIALIZING}, initialized_{false}, count_{0}, njoints_{12} {
     // The following joint angles are in the order of FL_hip_x, FL_hip_y, FL_knee, FR..., RL..., RR...
     stand_joint_angles_ = declare_parameter(
         "stand_joint_angles",
@@ -30,6 +33,7 @@ class NoarmSquat : public rclcpp::Node {
         declare_parameter("seconds_per_motion", 2.0);  // how many seconds the squat and stand motions should take
 
     spot_name = declare_parameter("spot_name", "");
+    joint_orderer_ = JointOrderer{spot_name};
 
     if (stand_joint_angles_.size() != njoints_) {
       throw std::logic_error("Stand joint angles is the wrong size!");
@@ -52,6 +56,8 @@ class NoarmSquat : public rclcpp::Node {
 
  private:
   std::string spot_name;
+  // Orders the joint states until the robot is initialized
+  JointOrderer joint_orderer_;
   // For storing joint angles
   std::vector<double> stand_joint_angles_;
   std::vector<double> squat_joint_angles_;
@@ -75,7 +81,7 @@ class NoarmSquat : public rclcpp::Node {
     if (!initialized_) {
       RCLCPP_INFO_STREAM(get_logger(), "Received starting joint states");
       sensor_msgs::msg::JointState ordered_joint_states;
-      bool successful = spot_ros2_control::order_joint_states(spot_name, msg, ordered_joint_states);
+      bool successful = joint_orderer_.order(msg, ordered_joint_states);
       if (successful) {
         init_joint_angles_ = ordered_joint_states.position;
         RCLCPP_INFO_STREAM(get_logger(), "Initialized! Robot will begin to move.");
@@ -149,9 +155,6 @@ class NoarmSquat : public rclcpp::Node {
   }
 };
 
-int main(int argc, char* argv[]) {
-  rclcpp::init(argc, argv);
-  rclcpp::spin(std::make_shared<NoarmSquat>());
-  rclcpp::shutdown();
-  return 0;
-}
+}  // namespace spot_ros2_control
+
+RCLCPP_COMPONENTS_REGISTER_NODE(spot_ros2_control::NoarmSquat)
@@ -1,5 +1,7 @@
 #include "spot_ros2_control/spot_joint_map.hpp"
 
+#include <utility>
+
 namespace spot_ros2_control {
 
 std::unordered_map<std::string, size_t> get_namespaced_joint_map(const std::string& spot_name, bool has_arm) {
@@ -15,9 +17,22 @@ std::unordered_map<std::string, size_t> get_namespaced_joint_map(const std::stri
   return namespaced_map;
 }
 
-bool order_joint_states(const std::string& spot_name, const sensor_msgs::msg::JointState& input_joint_states,
-                        sensor_msgs::msg::JointState& output_joint_states) {
-  const auto njoints = input_joint_states.position.size();
+std::optional<size_t> find_joint_index(std::string_view joint_name, bool has_arm) {
+  const auto njoints = has_arm ? spot_hardware_interface::kNjointsArm : spot_hardware_interface::kNjointsNoArm;
+  for (int i = 0; i < njoints; ++i) {
+    if (joint_name == spot_hardware_interface::kJointNames[i]) {
+      return static_cast<size_t>(i);
+    }
+  }
+  return std::nullopt;
+}
+
+JointOrderer::JointOrderer(std::string spot_name) : spot_name_{std::move(spot_name)} {}
+
+bool JointOrderer::resolve(const std::vector<std::string>& names) {
+  names_ = names;
+  valid_ = false;
+  const auto njoints = names.size();
   bool has_arm;
   if (njoints == spot_hardware_interface::kNjointsArm) {
     has_arm = true;
@@ -28,40 +43,76 @@ bool order_joint_states(const std::string& spot_name, const sensor_msgs::msg::Jo
     return false;
   }
 
+  // Joint names are matched by stripping the namespace from every name
+  const std::string_view joint_prefix = spot_name_;
+  output_indices_.resize(njoints);
+  for (size_t i = 0; i < njoints; ++i) {
+    std::string_view short_name = names[i];
+    if (!joint_prefix.empty()) {
+      if (!short_name.starts_with(joint_prefix) || short_name.substr(joint_prefix.size(), 1) != "/") {
+        RCLCPP_INFO_STREAM(rclcpp::get_logger("SpotJointMap"), "Invalid joint: " << names[i]);
+        return false;
+      }
+      short_name.remove_prefix(joint_prefix.size() + 1);
+    }
+    const auto joint_index = find_joint_index(short_name, has_arm);
+    if (!joint_index) {
+      RCLCPP_INFO_STREAM(rclcpp::get_logger("SpotJointMap"), "Invalid joint: " << names[i]);
+      return false;
+    }
+    output_indices_[i] = *joint_index;
+  }
+  valid_ = true;
+  return true;
+}
+
+bool JointOrderer::order(const sensor_msgs::msg::JointState& input_joint_states,
+                         sensor_msgs::msg::JointState& output_joint_states) {
+  // Messages with the same joint names as the last one reuse its indices, and invalid names are only reported once.
+  if (input_joint_states.name != names_ && !resolve(input_joint_states.name)) {
+    return false;
+  }
+  if (!valid_) {
+    return false;
+  }
+  const auto njoints = output_indices_.size();
+  if (input_joint_states.position.size() != njoints || input_joint_states.velocity.size() != njoints ||
+      input_joint_states.effort.size() != njoints) {
+    RCLCPP_INFO(rclcpp::get_logger("SpotJointMap"),
+                "Joint states must have a position, velocity and effort for each of the %zu joints.", njoints);
+    return false;
+  }
+
   output_joint_states.name.resize(njoints);
   output_joint_states.position.resize(njoints);
   output_joint_states.velocity.resize(njoints);
   output_joint_states.effort.resize(njoints);
-
-  const auto joint_map = get_namespaced_joint_map(spot_name, has_arm);
-
   for (size_t i = 0; i < njoints; ++i) {
-    // get the joint name
-    const auto& joint_name = input_joint_states.name.at(i);
-    try {
-      const auto joint_index = joint_map.at(joint_name);
-      output_joint_states.name.at(joint_index) = joint_name;
-      output_joint_states.position.at(joint_index) = input_joint_states.position.at(i);
-      output_joint_states.velocity.at(joint_index) = input_joint_states.velocity.at(i);
-      output_joint_states.effort.at(joint_index) = input_joint_states.effort.at(i);
-    } catch (const std::out_of_range& e) {
-      RCLCPP_INFO_STREAM(rclcpp::get_logger("SpotJointMap"), "Invalid joint: " << joint_name);
-      return false;
-    }
+    const auto joint_index = output_indices_[i];
+    output_joint_states.name[joint_index] = input_joint_states.name[i];
+    output_joint_states.position[joint_index] = input_joint_states.position[i];
+    output_joint_states.velocity[joint_index] = input_joint_states.velocity[i];
+    output_joint_states.effort[joint_index] = input_joint_states.effort[i];
   }
   return true;
 }
 
-int get_joint_index(const std::string& joint_str, bool has_arm) {
+bool order_joint_states(const std::string& spot_name, const sensor_msgs::msg::JointState& input_joint_states,
+                        sensor_msgs::msg::JointState& output_joint_states) {
+  return JointOrderer{spot_name}.order(input_joint_states, output_joint_states);
+}
+
+int get_joint_index(std::string_view joint_str, bool has_arm) {
   // Check if the joint_str has a namespace - if so, remove it
-  const size_t namespace_pos = joint_str.find("/");
-  const std::string joint_name = (namespace_pos != std::string::npos) ? joint_str.substr(namespace_pos + 1) : joint_str;
-  const auto joint_map = has_arm ? kJointNameToIndexWithArm : kJointNameToIndexWithoutArm;
-  if (joint_map.find(joint_name) == joint_map.end()) {
-    RCLCPP_ERROR(rclcpp::get_logger("SpotJointMap"), "Cannot find joint %s in joint map.", joint_name.c_str());
+  const size_t namespace_pos = joint_str.find('/');
+  const auto joint_name = namespace_pos != std::string_view::npos ? joint_str.substr(namespace_pos + 1) : joint_str;
+  const auto joint_index = find_joint_index(joint_name, has_arm);
+  if (!joint_index) {
+    RCLCPP_ERROR(rclcpp::get_logger("SpotJointMap"), "Cannot find joint %.*s in joint map.",
+                 static_cast<int>(joint_name.size()), joint_name.data());
     return -1;
   }
-  return joint_map.at(joint_name);
+  return static_cast<int>(*joint_index);
 }
 
 }  // namespace spot_ros2_control
@@ -10,16 +10,21 @@
 #include <vector>
 
 #include "rclcpp/rclcpp.hpp"
+#include "rclcpp_components/register_node_macro.hpp"
 #include "sensor_msgs/msg/joint_state.hpp"
 #include "spot_ros2_control/spot_joint_map.hpp"
 #include "std_msgs/msg/float64_multi_array.hpp"
 
+namespace spot_ros2_control {
+
 enum class WiggleState { WIGGLE_DOWN, WIGGLE_MIDDLE, WIGGLE_UP, RESET };
 
 class WiggleArm : public rclcpp::Node {
  public:
-  WiggleArm() : Node("wiggle_arm"), wiggle_state_{WiggleState::WIGGLE_DOWN}, initialized_{false} {
+  explicit WiggleArm(const rclcpp::NodeOptions& options = rclcpp::NodeOptions())
+      : Node("wiggle_arm", options), wiggle_state_{WiggleState::WIGGLE_DOWN}, initialized_{false} {
     spot_name = declare_parameter("spot_name", "");
+    joint_orderer_ = JointOrderer{spot_name};
     // Indices of the joints to wiggle. This corresponds to WR0 and F1X
     joints_to_wiggle_ = declare_parameter("joints_to_wiggle", std::vector<int>{16, 18});
     // Offset from starting position of each joints_to_wiggle for the first wiggle (up)
@@ -47,6 +52,8 @@ class WiggleArm : public rclcpp::Node {
 
  private:
   std::string spot_name;
+  // Orders the joint states until the robot is initialized
+  JointOrderer joint_orderer_;
   // stores joint angles and desired offsets
   std::vector<double> nominal_joint_angles_;
   std::vector<int64_t> joints_to_wiggle_;
@@ -71,7 +78,7 @@ class WiggleArm : public rclcpp::Node {
     if (!initialized_) {
       RCLCPP_INFO_STREAM(get_logger(), "Received starting joint states");
       sensor_msgs::msg::JointState ordered_joint_states;
-      bool successful = spot_ros2_control::order_joint_states(spot_name, msg, ordered_joint_states);
+      bool successful = joint_orderer_.order(msg, ordered_joint_states);
       if (successful) {
         nominal_joint_angles_ = ordered_joint_states.position;
         command_.data = nominal_joint_angles_;
@@ -153,9 +160,6 @@ class WiggleArm : public rclcpp::Node {
   }
 };
 
-int main(int argc, char* argv[]) {
-  rclcpp::init(argc, argv);
-  rclcpp::spin(std::make_shared<WiggleArm>());
-  rclcpp::shutdown();
-  return 0;
-}
+}  // namespace spot_ros2_control
+
+RCLCPP_COMPONENTS_REGISTER_NODE(spot_ros2_control::WiggleArm)